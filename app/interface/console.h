@@ -1,6 +1,7 @@
 #ifndef CONSOLE_H
 #define CONSOLE_H
 
+#include <stddef.h>
 #include "queue.h"
 
 /**
@@ -29,6 +30,14 @@ int console_getc(char *out_ch);
  */
 int console_puts(const char *s);
 
+/**
+ * @brief Write raw bytes to the console (non-blocking, binary safe).
+ * @param data Bytes to write (may contain zeros).
+ * @param len Number of bytes.
+ * @return Number of bytes written.
+ */
+int console_write(const char *data, size_t len);
+
 /**
  * @brief Attach RX/TX queues to the console UART (no-op if no UART).
  * @param rx Receive queue.
@@ -25,6 +25,7 @@ static int cmd_reboot_handler(int argc, char **argv);
 static int cmd_blink_handler(int argc, char **argv);
 static int cmd_logger_handler(int argc, char **argv);
 static int cmd_top_handler(int argc, char **argv);
+static int cmd_bench_handler(int argc, char **argv);
 
 static int cmd_heap_test_handler(int argc, char **argv);
 /* Pseudo-random number generator for stress testing */
@@ -100,6 +101,12 @@ static const cli_command_t top_cmd = {
     .handler = cmd_top_handler
 };
 
+static const cli_command_t bench_cmd = {
+    .name = "bench",
+    .help = "Cycles per context switch and interrupt entry",
+    .handler = cmd_bench_handler
+};
+
 static const cli_command_t heap_test_cmd = {
     .name = "heaptest",
     .help = "Stress test heap: heaptest <basic|frag|stress> [size]",
@@ -228,6 +235,7 @@ static int cmd_kill_handler(int argc, char **argv) {
 static int cmd_reboot_handler(int argc, char **argv) {
     (void)argc; (void)argv;
     cli_printf("Rebooting system...\r\n");
+    cli_flush();
 
     platform_reset();
 
@@ -320,8 +328,8 @@ static int cmd_top_handler(int argc, char **argv) {
     uint64_t total_uptime = (uint64_t)platform_get_ticks();
     
     cli_printf("Task CPU Usage:\r\n");
-    cli_printf("ID   Usage\r\n");
-    cli_printf("---  -----\r\n");
+    cli_printf("ID   Usage  Ticks\r\n");
+    cli_printf("---  -----  -----\r\n");
 
     for (uint32_t i = 0; i < MAX_TASKS; i++) {
         task_t *t = scheduler_get_task_by_index(i);
@@ -333,10 +341,76 @@ static int cmd_top_handler(int argc, char **argv) {
                 percent = (uint32_t)((task_ticks * 100) / total_uptime);
             }
             
-            cli_printf("%u    %u%%\r\n", task_get_id(t), percent);
+            cli_printf("%-4u %3u%%   %llu\r\n", task_get_id(t), percent,
+                       (unsigned long long)task_get_cpu_ticks(t));
+        }
+    }
+    return 0;
+}
+
+/* --- Latency Benchmark --- */
+
+#ifndef HOST_PLATFORM
+#define BENCH_ROUNDS        1000U
+#define BENCH_IRQ_SAMPLES   64U
+#define BENCH_STOP          0x2U
+
+static volatile uint16_t bench_ping_id;
+
+/* Answer every notification from the CLI task until told to stop */
+static void task_bench_pong(void *arg) {
+    (void)arg;
+    while (1) {
+        uint32_t v = task_notify_wait(1, UINT32_MAX);
+        task_notify(bench_ping_id, 1);
+        if (v & BENCH_STOP) {
+            return;
         }
     }
+}
+#endif
+
+static int cmd_bench_handler(int argc, char **argv) {
+    (void)argc; (void)argv;
+
+#ifdef HOST_PLATFORM
+    cli_printf("bench: needs real context switches and interrupts (target only)\r\n");
+    return -1;
+#else
+    /* Context switch: notify ping-pong, two switches per round trip */
+    bench_ping_id = task_get_id((task_t *)task_get_current());
+    int32_t pong_id = task_create(task_bench_pong, NULL, STACK_SIZE_1KB, TASK_WEIGHT_HIGH);
+    if (pong_id < 0) {
+        cli_printf("bench: cannot create task\r\n");
+        return -1;
+    }
+
+    uint32_t start = platform_get_cycles();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        task_notify((uint16_t)pong_id, 1);
+        task_notify_wait(1, UINT32_MAX);
+    }
+    uint32_t switch_cycles = (platform_get_cycles() - start) / (2U * BENCH_ROUNDS);
+
+    task_notify((uint16_t)pong_id, BENCH_STOP);
+    task_notify_wait(1, UINT32_MAX);
+
+    /* Interrupt entry: software-pended spare IRQ */
+    uint32_t irq_min = UINT32_MAX, irq_max = 0, irq_sum = 0;
+    for (uint32_t i = 0; i < BENCH_IRQ_SAMPLES; i++) {
+        uint32_t c = platform_irq_entry_cycles();
+        irq_min = (c < irq_min) ? c : irq_min;
+        irq_max = (c > irq_max) ? c : irq_max;
+        irq_sum += c;
+    }
+
+    cli_printf("Context switch: %u cycles (notify + block + switch, avg of %u)\r\n",
+               switch_cycles, 2U * BENCH_ROUNDS);
+    cli_printf("IRQ entry:      min %u  avg %u  max %u cycles\r\n",
+               irq_min, irq_sum / BENCH_IRQ_SAMPLES, irq_max);
+    cli_printf("Code in RAM:    %s\r\n", RAMFUNC_ENABLE ? "yes" : "no (RAMFUNC=0)");
     return 0;
+#endif
 }
 
 static int cmd_heap_test_handler(int argc, char **argv) {
@@ -538,6 +612,7 @@ void app_commands_register_all(void)
     cli_register_command(&blink_cmd);
     cli_register_command(&logger_cmd);
     cli_register_command(&top_cmd);
+    cli_register_command(&bench_cmd);
 
     cli_register_command(&heap_test_cmd);
 }
@@ -34,6 +34,16 @@ int console_puts(const char *s) {
     return platform_uart_puts(s);
 }
 
+int console_write(const char *data, size_t len) {
+    if (!data) {
+        return 0;
+    }
+    if (console_uart) {
+        return uart_write_buffer(console_uart, data, len);
+    }
+    return platform_uart_write(data, len);
+}
+
 void console_attach_queues(queue_t *rx, queue_t *tx) {
     if (!console_uart) {
         return;
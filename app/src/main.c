@@ -8,60 +8,141 @@
 #include "arch_ops.h"
 #include "queue.h"
 #include "logger.h"
+#include "logstore.h"
+#include "logbin.h"
+#include "perf.h"
+#include "irqprof.h"
+#include "spinlock.h"
+#include "taskwdt.h"
+#include "timer.h"
+#include "ipc.h"
 #include "console.h"
+#include "boot.h"
+#include "kobj.h"
+#include "dvfs.h"
+
+/* CLI task and UART console queues, reserved at link time */
+TASK_DEFINE(cli_task, cli_task_entry, NULL, STACK_SIZE_2KB, TASK_WEIGHT_NORMAL);
+QUEUE_DEFINE(cli_rx_queue, sizeof(char), 128);
+QUEUE_DEFINE(cli_tx_queue, sizeof(char), 128);
+
+/* Software timers, and the hardware watchdog kicked only while all registered tasks check in */
+static int boot_timers(void) {
+    timer_service_init(0);
+#if TASKWDT_ENABLE
+    return taskwdt_init(TASKWDT_TIMEOUT_MS);
+#else
+    return 0;
+#endif
+}
+BOOT_INIT(boot_timers, BOOT_LEVEL_EARLY);
+
+/* Logger (creates log task); nothing on the way to the first task logs */
+static int boot_logging(void) {
+    logger_init();
+#if LOG_ENABLE && LOG_STORE_ENABLE
+    /* Persist logs to the reserved storage region */
+    logger_attach_store(logstore_create(FLASH_STORAGE_BASE, LOG_STORE_PAGES));
+#endif
+
+    /* Binary log rings; drained on demand with 'logbin dump' */
+    logbin_init();
+    return 0;
+}
+BOOT_INIT(boot_logging, BOOT_LEVEL_DEFERRED);
+
+/* Performance counters ('perf' command) and the boot report ('boot') */
+static int boot_diagnostics(void) {
+    perf_init();
+    irqprof_init();
+    spinlock_stats_init();
+    boot_init();
+    kobj_init();
+    return 0;
+}
+BOOT_INIT(boot_diagnostics, BOOT_LEVEL_DEFERRED);
+
+/* Clock governor ('dvfs' command); the first tasks run at the boot clock */
+static int boot_power(void) {
+    return dvfs_init();
+}
+BOOT_INIT(boot_power, BOOT_LEVEL_DEFERRED);
+
+/* Register application commands */
+static int boot_commands(void) {
+    app_commands_register_all();
+    return 0;
+}
+BOOT_INIT(boot_commands, BOOT_LEVEL_DEFERRED);
 
 int main(void)
 {
     platform_init();
-    
+    boot_mark("platform");
+
     /* Initialize scheduler */
     scheduler_init();
+    ipc_init();
+
+    /* Statically defined objects and tasks (CLI task, console queues) */
+    if (kobj_init_static() != 0) {
+        platform_panic();
+    }
 
     /* Initialize console backend (driver-backed if available) */
     console_init();
     
     /* Initialize CLI */
     cli_init("soRTOS> ", console_getc, console_puts);
+    cli_set_write_fn(console_write);  /* Binary-safe path for RPC frames */
     
     if (console_has_uart()) {
-        /* Create queues for UART-backed CLI I/O */
-        queue_t *cli_rx_queue = queue_create(sizeof(char), 128);
-        queue_t *cli_tx_queue = queue_create(sizeof(char), 128);
-        if (!cli_rx_queue || !cli_tx_queue) {
-            platform_panic();
-        }
-
+        /* Queues for UART-backed CLI I/O */
         console_attach_queues(cli_rx_queue, cli_tx_queue);
         cli_set_rx_queue(cli_rx_queue);
         cli_set_tx_queue(cli_tx_queue);
     }
 
-    /* Initialize Logger (creates log task) */
-    logger_init();
+    boot_mark("kernel");
+
+    /* Early inits: what the first task depends on */
+    if (boot_run_level(BOOT_LEVEL_EARLY) != 0) {
+        platform_panic();
+    }
+
+#if !BOOT_DEFER_ENABLE
+    /* Everything before the first task, as a baseline for the 'boot' report */
+    boot_run_deferred();
+#endif
+
+#if BOOT_DEFER_ENABLE && !defined(HOST_PLATFORM)
+    /* Deferred inits run in a boot task once the CLI task has had the CPU */
+    if (boot_defer() < 0) {
+        platform_panic();
+    }
+#endif
+    boot_mark("tasks");
 
-    /* Register application commands */
-    app_commands_register_all();
-    
-    /* Create CLI task */
-    int32_t cli_task_id = task_create(cli_task_entry, NULL, STACK_SIZE_2KB, TASK_WEIGHT_NORMAL);
-    
     /* Start the scheduler - does not return */
     scheduler_start();
 
 #ifdef HOST_PLATFORM
-    if (cli_task_id > 0) {
-        task_t *cli_task = NULL;
+    if (cli_task.id > 0) {
+        task_t *cli_tcb = NULL;
         for (uint32_t i = 0; i < MAX_TASKS; i++) {
             task_t *t = scheduler_get_task_by_index(i);
-            if (t && task_get_id(t) == (uint16_t)cli_task_id) {
-                cli_task = t;
+            if (t && task_get_id(t) == (uint16_t)cli_task.id) {
+                cli_tcb = t;
                 break;
             }
         }
-        if (cli_task) {
-            task_set_current(cli_task);
+        if (cli_tcb) {
+            task_set_current(cli_tcb);
         }
     }
+#if BOOT_DEFER_ENABLE
+    boot_run_deferred();
+#endif
     /* Native platform has no context switching. run CLI loop on main thread. */
     cli_task_entry(NULL);
 #endif
@@ -1,6 +1,28 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "arch_ops.h"
+#include "platform.h"
+#include "scheduler.h"
+
+#define SCB_SHCSR_MEMFAULTENA   (1UL << 16)
+#define SCB_MMFSR_MSTKERR       (1UL << 4)  /* Fault while stacking on exception entry */
+#define SCB_MMFSR_MMARVALID     (1UL << 7)  /* MMFAR holds the faulting address */
+#define MPU_CTRL_ENABLE         (1UL << 0)
+#define MPU_CTRL_PRIVDEFENA     (1UL << 2)  /* Default map for privileged accesses */
+#define MPU_RASR_ENABLE         (1UL << 0)
+#define MPU_RASR_SIZE_32B       (4UL << 1)  /* Region size = 2^(SIZE + 1) */
+#define MPU_RASR_SRAM           ((1UL << 18) | (1UL << 17)) /* Shareable, cacheable */
+#define MPU_RASR_XN             (1UL << 28) /* AP = 000: no access at any privilege */
+#define FPU_FPCCR_LSPACT        (1UL << 0)  /* Lazy FP state still to be stacked */
+#define EXC_RETURN_THREAD_PSP   0xDUL       /* Low nibble: return to thread mode on PSP */
+
+#define STACK_GUARD_REGION      7U          /* Highest number wins on overlap */
+#define STACK_GUARD_SIZE        32U
+
+static uint8_t guard_armed;
+static uintptr_t guard_addr;                /* Current guard, 0 if none */
+
+void arch_stack_guard_fault(uint32_t exc_return);
 
 
 void *arch_initialize_stack(void *top_of_stack, 
@@ -60,3 +82,83 @@ void arch_reset(void) {
         arch_nop();
     }
 }
+
+
+/* Enable the MPU over the default map and route MPU faults to MemManage */
+void arch_stack_guard_init(void) {
+    MPU->RNR = STACK_GUARD_REGION;
+    MPU->RASR = 0;
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA;
+    MPU->CTRL = MPU_CTRL_PRIVDEFENA | MPU_CTRL_ENABLE;
+    arch_dsb();
+    arch_isb();
+    guard_armed = 1;
+}
+
+/* Reprogram the guard region for the incoming task's stack */
+RAMFUNC void arch_stack_guard_set(const void *stack_base, size_t stack_size) {
+    if (!guard_armed) {
+        return;
+    }
+
+    MPU->RNR = STACK_GUARD_REGION;
+    MPU->RASR = 0;
+    guard_addr = 0;
+
+    if (stack_base != NULL) {
+        uintptr_t base = (uintptr_t)stack_base;
+        uintptr_t addr = (base + STACK_GUARD_SIZE - 1U) & ~(uintptr_t)(STACK_GUARD_SIZE - 1U);
+        if (addr + STACK_GUARD_SIZE <= base + stack_size) {
+            MPU->RBAR = (uint32_t)addr;
+            MPU->RASR = MPU_RASR_XN | MPU_RASR_SRAM | MPU_RASR_SIZE_32B | MPU_RASR_ENABLE;
+            guard_addr = addr;
+        }
+    }
+    arch_dsb();
+    arch_isb();
+}
+
+/*
+ * MemManage fault. A task that ran into its guard is killed and the CPU
+ * switches away: PSP is moved to the top of the dead stack so PendSV,
+ * tail-chained on return, saves its context there. Faults that are not a
+ * guard hit from thread mode, or that happen inside a kernel critical
+ * section, panic.
+ */
+void arch_stack_guard_fault(uint32_t exc_return) {
+    uint32_t mmfsr = SCB->CFSR & 0xFFUL;
+    uintptr_t addr = SCB->MMFAR;
+    uint32_t basepri;
+    __asm volatile ("MRS %0, BASEPRI" : "=r"(basepri));
+
+    SCB->CFSR = mmfsr;      /* Write-one-to-clear */
+
+    int guard_hit = (guard_addr != 0) &&
+                    ((mmfsr & SCB_MMFSR_MSTKERR) ||
+                     ((mmfsr & SCB_MMFSR_MMARVALID) &&
+                      addr >= guard_addr && addr < guard_addr + STACK_GUARD_SIZE));
+
+    if (guard_hit && (exc_return & 0xFUL) == EXC_RETURN_THREAD_PSP &&
+        basepri == 0U && task_stack_guard_fault() == 0) {
+        task_t *dead = (task_t *)task_get_current();
+        uintptr_t top = (uintptr_t)task_get_stack_ptr(dead) + task_get_stack_size(dead);
+
+        arch_stack_guard_set(NULL, 0);
+#if defined(__ARM_FP) && (__ARM_FP != 0)
+        FPU_FPCCR_REG &= ~FPU_FPCCR_LSPACT;  /* Drop the dead task's lazy FP state */
+#endif
+        arch_set_psp((uint32_t)(top & ~(uintptr_t)7U));
+        arch_yield();
+        return;
+    }
+
+    platform_panic();
+}
+
+/* Pass EXC_RETURN to the C handler */
+__attribute__((naked)) void MemManage_Handler(void) {
+    __asm volatile (
+        "MOV r0, lr\n"
+        "B   arch_stack_guard_fault\n"
+    );
+}
\ No newline at end of file
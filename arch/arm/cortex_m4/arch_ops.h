@@ -2,7 +2,25 @@
 #define ARCH_OPS_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include "device_registers.h"
+#include "platform_config.h"
+#include "project_config.h"
+
+/*
+ * Place a function in SRAM2, which the Cortex-M4 reads over the I-Code
+ * bus with no wait states. Reset_Handler copies the .ramfunc section there
+ * from flash. Calls between flash and SRAM2 go through linker veneers, so
+ * annotate whole hot call chains, not single leaves.
+ */
+#if RAMFUNC_ENABLE
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+/* BASEPRI value of the kernel ceiling (priority in the implemented high bits) */
+#define ARCH_KERNEL_BASEPRI  ((uint32_t)MAX_SYSCALL_PRIORITY << (8U - NVIC_PRIO_BITS))
 
 /**
  * @brief Disable Global Interrupts.
@@ -57,6 +75,35 @@ static inline void arch_irq_unlock_soft(uint32_t old) {
     );
 }
 
+/**
+ * @brief Mask interrupts at or below the kernel ceiling.
+ *
+ * Used by spin_lock(). Interrupts above MAX_SYSCALL_PRIORITY keep running.
+ * BASEPRI_MAX only ever raises the mask, so nesting inside a stricter
+ * section (or an ISR that already raised BASEPRI) is safe.
+ * @return Previous BASEPRI, for arch_irq_unlock_kernel().
+ */
+static inline uint32_t arch_irq_lock_kernel(void) {
+    uint32_t old;
+    __asm volatile (
+        "MRS %0, BASEPRI\n"
+        "MSR BASEPRI_MAX, %1\n"
+        "isb\n"
+        : "=&r"(old) : "r"(ARCH_KERNEL_BASEPRI) : "memory"
+    );
+    return old;
+}
+
+/**
+ * @brief Restore the mask saved by arch_irq_lock_kernel().
+ */
+static inline void arch_irq_unlock_kernel(uint32_t old) {
+    __asm volatile (
+        "MSR BASEPRI, %0\n"
+        : : "r"(old) : "memory"
+    );
+}
+
 
 /**
  * @brief Data Synchronization Barrier.
@@ -166,6 +213,56 @@ static inline uint32_t arch_test_and_set(volatile uint32_t *ptr) {
     return old_val;
 }
 
+/**
+ * @brief Atomic Compare-and-Swap.
+ *
+ * Replaces *ptr with desired if it still holds expected (LDREX/STREX).
+ * @return 1 if the swap happened, 0 if *ptr held another value.
+ */
+static inline uint32_t arch_atomic_cas(volatile uint32_t *ptr, uint32_t expected, uint32_t desired) {
+    uint32_t old_val;
+    uint32_t res;
+
+    do {
+        __asm volatile ("ldrex %0, [%1]" : "=r" (old_val) : "r" (ptr) : "memory");
+        if (old_val != expected) {
+            __asm volatile ("clrex" ::: "memory");
+            return 0;
+        }
+        __asm volatile ("strex %0, %2, [%1]" : "=&r" (res) : "r" (ptr), "r" (desired) : "memory");
+    } while (res != 0);
+
+    arch_dmb();
+    return 1;
+}
+
+/**
+ * @brief Atomic Compare-and-Swap on a pointer-sized word (32 bits here).
+ * @return 1 if the swap happened, 0 if *ptr held another value.
+ */
+static inline uint32_t arch_atomic_cas_ptr(volatile uintptr_t *ptr, uintptr_t expected, uintptr_t desired) {
+    return arch_atomic_cas((volatile uint32_t *)ptr, (uint32_t)expected, (uint32_t)desired);
+}
+
+/**
+ * @brief Atomic Fetch-and-Add.
+ *
+ * Safe against interrupts and other cores without masking interrupts.
+ * @return Value of *ptr before the addition.
+ */
+static inline uint32_t arch_atomic_add(volatile uint32_t *ptr, uint32_t val) {
+    uint32_t old_val;
+    uint32_t res;
+
+    do {
+        __asm volatile ("ldrex %0, [%1]" : "=r" (old_val) : "r" (ptr) : "memory");
+        __asm volatile ("strex %0, %2, [%1]" : "=&r" (res) : "r" (ptr), "r" (old_val + val) : "memory");
+    } while (res != 0);
+
+    arch_dmb();
+    return old_val;
+}
+
 /**
  * @brief Get the current CPU ID.
  * 
@@ -180,6 +277,25 @@ static inline uint32_t arch_get_cpu_id(void) {
  */
 void arch_reset(void);
 
+/**
+ * @brief Enable the MPU and the MemManage fault for stack guards.
+ *
+ * The default memory map stays in force for privileged code; only the
+ * guard region is added on top of it.
+ */
+void arch_stack_guard_init(void);
+
+/**
+ * @brief Move the stack guard to the bottom of a task stack.
+ *
+ * Programs a 32-byte no-access region at the first 32-byte boundary inside
+ * the stack. Called on every context switch. No-op before
+ * arch_stack_guard_init().
+ * @param stack_base Lowest address of the stack, or NULL to lift the guard.
+ * @param stack_size Stack size in bytes.
+ */
+void arch_stack_guard_set(const void *stack_base, size_t stack_size);
+
 /**
  * @brief Initialize the stack frame for a task.
  */
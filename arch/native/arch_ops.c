@@ -1,5 +1,19 @@
 #include "arch_ops.h"
+#include "platform.h"
+#include "scheduler.h"
 #include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+volatile uint32_t arch_native_primask;
+volatile uint32_t arch_native_basepri;
+void (*volatile arch_native_irq_pending)(void);
+
+/* Guard page state: guard_page is NULL while no guard is set */
+static int guard_armed;
+static uintptr_t guard_page;
+static size_t page_size;
 
 /* Initialize the stack frame for a task */
 void* arch_initialize_stack(void *top_of_stack, 
@@ -20,4 +34,68 @@ void* arch_initialize_stack(void *top_of_stack,
 /* Reset the processor (Exit the test runner) */
 void arch_reset(void) {
     exit(0);
-}
\ No newline at end of file
+}
+
+/* Make the current guard page accessible again */
+static void _guard_lift(void) {
+    if (guard_page) {
+        mprotect((void *)guard_page, page_size, PROT_READ | PROT_WRITE);
+        guard_page = 0;
+    }
+}
+
+/* SIGSEGV: kill the running task on a guard hit, otherwise crash as usual */
+static void _guard_fault(int sig, siginfo_t *info, void *uctx) {
+    (void)uctx;
+    uintptr_t addr = (uintptr_t)info->si_addr;
+
+    if (guard_page == 0 || addr < guard_page || addr >= guard_page + page_size) {
+        signal(sig, SIG_DFL);   /* Re-executes the access and dumps core */
+        return;
+    }
+
+    _guard_lift();
+    if (arch_native_basepri == 0U && task_stack_guard_fault() == 0) {
+        platform_yield();       /* Switches away for good where a yield can */
+    }
+    platform_panic();
+}
+
+/* Install the guard page fault handler */
+void arch_stack_guard_init(void) {
+    struct sigaction sa;
+
+    page_size = (size_t)sysconf(_SC_PAGESIZE);
+    sa.sa_sigaction = _guard_fault;
+    sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGSEGV, &sa, NULL);
+    guard_armed = 1;
+}
+
+/* Protect the first whole page of a stack, releasing the previous one */
+void arch_stack_guard_set(const void *stack_base, size_t stack_size) {
+    if (!guard_armed) {
+        return;
+    }
+    _guard_lift();
+    if (stack_base == NULL) {
+        return;
+    }
+
+    uintptr_t base = (uintptr_t)stack_base;
+    uintptr_t page = (base + page_size - 1) & ~(uintptr_t)(page_size - 1);
+    if (page + page_size > base + stack_size) {
+        return;                 /* No whole page inside this stack */
+    }
+    if (mprotect((void *)page, page_size, PROT_NONE) == 0) {
+        guard_page = page;
+    }
+}
+
+/* Disarm the guard and give SIGSEGV back to the default action */
+void arch_native_stack_guard_disable(void) {
+    _guard_lift();
+    guard_armed = 0;
+    signal(SIGSEGV, SIG_DFL);
+}
@@ -2,27 +2,94 @@
 #define ARCH_OPS_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include <sched.h>
+#include "platform_config.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Hot code stays where it is on the host (see the Cortex-M4 arch_ops.h) */
+#define RAMFUNC
+
+/* BASEPRI value of the kernel ceiling (priority in the implemented high bits) */
+#define ARCH_KERNEL_BASEPRI  ((uint32_t)MAX_SYSCALL_PRIORITY << (8U - NVIC_PRIO_BITS))
+
+/* Simulated PRIMASK and BASEPRI, so tests can check which interrupts a
+ * critical section would hold off. Nothing is actually masked on the host. */
+extern volatile uint32_t arch_native_primask;
+extern volatile uint32_t arch_native_basepri;
+
+/* Interrupt held off by the kernel mask, taken (once) when it drops to zero.
+ * Tests set it to land a tick or wake-up right at the end of a critical section. */
+extern void (*volatile arch_native_irq_pending)(void);
+
 /**
  * @brief Disable Global Interrupts.
  * 
- * On the native host platform (single-threaded tests), this is a no-op
- * or simply returns a dummy status.
+ * On the native host platform, only the simulated PRIMASK is set.
  * 
- * @return Current interrupt state (always 0 on host).
+ * @return Previous simulated PRIMASK.
  */
-static inline uint32_t arch_irq_lock(void) { return 0; }
+static inline uint32_t arch_irq_lock(void) {
+    uint32_t s = arch_native_primask;
+    arch_native_primask = 1;
+    return s;
+}
 
 /**
  * @brief Restore Global Interrupts.
  * 
  * @param s The interrupt state to restore.
  */
-static inline void arch_irq_unlock(uint32_t s) { (void)s; }
+static inline void arch_irq_unlock(uint32_t s) { arch_native_primask = s; }
+
+/**
+ * @brief Mask interrupts at or below the kernel ceiling.
+ *
+ * Models BASEPRI_MAX: the simulated mask is only ever raised.
+ *
+ * @return Previous simulated BASEPRI.
+ */
+static inline uint32_t arch_irq_lock_kernel(void) {
+    uint32_t old = arch_native_basepri;
+    if (old == 0U || old > ARCH_KERNEL_BASEPRI) {
+        arch_native_basepri = ARCH_KERNEL_BASEPRI;
+    }
+    return old;
+}
+
+/**
+ * @brief Restore the mask saved by arch_irq_lock_kernel().
+ *
+ * Unmasking runs arch_native_irq_pending, if one is set, as the interrupt
+ * that was waiting on the mask.
+ *
+ * @param old The simulated BASEPRI to restore.
+ */
+static inline void arch_irq_unlock_kernel(uint32_t old) {
+    arch_native_basepri = old;
+    if (old == 0U && arch_native_irq_pending) {
+        void (*isr)(void) = arch_native_irq_pending;
+        arch_native_irq_pending = NULL;
+        isr();
+    }
+}
+
+/**
+ * @brief Check whether an interrupt would be taken with the current mask.
+ *
+ * @param priority NVIC priority (0 = highest).
+ * @return 1 if an interrupt at @p priority would preempt now, 0 if masked.
+ */
+static inline uint32_t arch_native_irq_enabled(uint32_t priority) {
+    uint32_t level = priority << (8U - NVIC_PRIO_BITS);
+    if (arch_native_primask) {
+        return 0;
+    }
+    return (arch_native_basepri == 0U || level < arch_native_basepri) ? 1U : 0U;
+}
 
 /**
  * @brief No Operation.
@@ -31,8 +98,9 @@ static inline void arch_nop(void) { }
 
 /**
  * @brief Data Memory Barrier.
+ * A full fence, so threaded host tests see the ordering a DMB gives on target.
  */
-static inline void arch_dmb(void) { }
+static inline void arch_dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
 
 /**
  * @brief Trigger a context switch (Yield).
@@ -45,9 +113,10 @@ static inline void arch_yield(void) { }
 /**
  * @brief Relax the CPU.
  * 
- * Used inside spinloops to reduce power consumption or hint the pipeline.
+ * Used inside spinloops. On the host, spinning threads give the CPU away
+ * so a preempted lock holder (or the next ticket) can run.
  */
-static inline void arch_cpu_relax(void) { }
+static inline void arch_cpu_relax(void) { sched_yield(); }
 
 /**
  * @brief Full memory barrier.
@@ -73,6 +142,45 @@ static inline uint32_t arch_test_and_set(volatile uint32_t *ptr) {
     return old;
 }
 
+/**
+ * @brief Atomic Compare-and-Swap.
+ *
+ * Uses the host compiler's atomics so tests may use real threads.
+ *
+ * @param ptr Pointer to the value.
+ * @param expected Value *ptr must hold for the swap to happen.
+ * @param desired New value.
+ * @return 1 if the swap happened, 0 otherwise.
+ */
+static inline uint32_t arch_atomic_cas(volatile uint32_t *ptr, uint32_t expected, uint32_t desired) {
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 1U : 0U;
+}
+
+/**
+ * @brief Atomic Compare-and-Swap on a pointer-sized word.
+ *
+ * @param ptr Pointer to the value.
+ * @param expected Value *ptr must hold for the swap to happen.
+ * @param desired New value.
+ * @return 1 if the swap happened, 0 otherwise.
+ */
+static inline uint32_t arch_atomic_cas_ptr(volatile uintptr_t *ptr, uintptr_t expected, uintptr_t desired) {
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 1U : 0U;
+}
+
+/**
+ * @brief Atomic Fetch-and-Add.
+ *
+ * @param ptr Pointer to the value.
+ * @param val Amount to add.
+ * @return Value of *ptr before the addition.
+ */
+static inline uint32_t arch_atomic_add(volatile uint32_t *ptr, uint32_t val) {
+    return __atomic_fetch_add(ptr, val, __ATOMIC_SEQ_CST);
+}
+
 /**
  * @brief Get the current CPU ID.
  * 
@@ -89,6 +197,30 @@ static inline uint32_t arch_get_cpu_id(void) {
  */
 void arch_reset(void);
 
+/**
+ * @brief Install the SIGSEGV handler that turns guard page hits into task kills.
+ */
+void arch_stack_guard_init(void);
+
+/**
+ * @brief Move the stack guard to the bottom of a task stack.
+ *
+ * Makes the first whole page inside the stack PROT_NONE and restores the
+ * previous guard page. Stacks without a whole page get no guard. No-op
+ * before arch_stack_guard_init().
+ *
+ * @param stack_base Lowest address of the stack, or NULL to lift the guard.
+ * @param stack_size Stack size in bytes.
+ */
+void arch_stack_guard_set(const void *stack_base, size_t stack_size);
+
+/**
+ * @brief Lift the guard and restore the default SIGSEGV action.
+ *
+ * Host only; lets tests undo arch_stack_guard_init().
+ */
+void arch_native_stack_guard_disable(void);
+
 /**
  * @brief Initialize the stack frame for a task.
  * 
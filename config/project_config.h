@@ -9,6 +9,10 @@
 #define CLI_MAX_LINE_LEN       128    /* Maximum command line length */
 #define CLI_MAX_ARGS           16     /* Maximum number of command arguments */
 #define CLI_MAX_CMDS           32     /* Maximum number of registered commands */
+#define CLI_TX_BUFFER_SIZE     1024   /* Output stream buffer in bytes (power of 2) */
+#define CLI_RPC_ENABLE         1      /* Binary RPC frames multiplexed with the text console */
+#define CLI_RPC_MAX_PAYLOAD    1024   /* Max argument or captured output bytes per frame */
+#define CLI_RPC_TIMEOUT_TICKS  100    /* Idle gap that abandons a partly received frame */
 
 /* ============================================================================
    UART Configuration
@@ -16,6 +20,7 @@
 #define UART_BAUD_DEFAULT      115200 /* Default UART baud rate */
 #define UART_RX_BUFFER_SIZE    256    /* UART receive buffer size */
 #define UART_TX_BUFFER_SIZE    512    /* UART transmit buffer size */
+#define UART_TX_PBUF_DEPTH     4      /* Packet buffer frames queued per UART for TX */
 
 /* ============================================================================
    Button Configuration
@@ -39,6 +44,7 @@
 
 /* Stack overflow detection */
 #define STACK_CANARY           0xDEADBEEF  /* Magic value at stack bottom */
+#define STACK_GUARD_ENABLE     1           /* No-access guard at the running task's stack bottom (MPU / mprotect) */
 
 /* Garbage collection */
 #define GARBAGE_COLLECTION_TICKS 1000U  /* Run GC every 1000 ticks (1 second at 1kHz) */
@@ -74,17 +80,101 @@
    ============================================================================ */
 #define TIMER_DEFAULT_POOL_SIZE 32     /* Default number of timers in the pool */
 
+/* ============================================================================
+   IPC Configuration
+   ============================================================================ */
+#define IPC_MSG_WORDS           4      /* 32-bit words per synchronous IPC message */
+
 /* ============================================================================
    Logger Configuration
    ============================================================================ */
 #define LOG_ENABLE              1      /* 1 to enable, 0 to remove code */
-#define LOG_QUEUE_SIZE          64     /* Number of log entries to buffer */
+#define LOG_QUEUE_SIZE          64     /* Lock-free log ring slots (power of 2) */
 #define LOG_HISTORY_SIZE        128    /* Number of entries to keep in RAM history */
+#define LOG_LEVEL_DEFAULT       3      /* 1=ERROR 2=WARN 3=INFO 4=DEBUG, 0 removes all */
+#define LOG_LEVEL_KERNEL        LOG_LEVEL_DEFAULT  /* Compile-time ceiling per module */
+#define LOG_LEVEL_MEM           LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_STORAGE       LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DRIVER        LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_APP           LOG_LEVEL_DEFAULT
+#define LOG_STORE_ENABLE        1      /* Persist log entries to a flash ring */
+#define LOG_STORE_PAGES         8      /* Flash pages used by the log ring */
+#define LOG_STORE_FRAME_SIZE    128    /* Bytes buffered per flash write (multiple of 8) */
+#define LOG_STORE_MAX_FORMATS   32     /* Format strings cached per page */
+#define LOG_STORE_FMT_MAX_LEN   64     /* Longest format string stored */
+#define LOG_STORE_FLUSH_ON_IDLE 1      /* Commit once the log ring drains (0 = only full frames) */
+#define LOGBIN_ENABLE           1      /* Deferred binary logging (LOGBIN macro) */
+#define LOGBIN_BUFFER_WORDS     256    /* Per-CPU ring size in 32-bit words (power of 2) */
+#define LOGBIN_STR_MAX          32     /* Longest string argument copied at log time */
+#define LOGBIN_DRAIN_PERIOD_TICKS 10   /* Drain task interval */
+
+/* ============================================================================
+   Performance Instrumentation Configuration
+   ============================================================================ */
+#define PERF_ENABLE             1      /* Per-CPU event counters and 'perf' command */
+#define PERF_MAX_COUNTERS       48     /* Counters captured by one perf_snapshot() */
+#ifndef IRQPROF_ENABLE
+#define IRQPROF_ENABLE          0      /* Time IRQ-off sections and ISRs (make IRQPROF=1) */
+#endif
+#define IRQPROF_HIST_BUCKETS    8      /* Log2 duration buckets per call site */
+#define IRQPROF_REPORT_TOP      8      /* Worst sites listed by 'irqprof' */
+#ifndef SPINLOCK_STATS
+#define SPINLOCK_STATS          0      /* Per-lock contention counters (make SPINSTATS=1) */
+#endif
+#define SPINLOCK_STATS_MAX_LOCKS 16    /* Locks listed by 'locks' */
+#ifndef RAMFUNC_ENABLE
+#define RAMFUNC_ENABLE          1      /* Hot paths and vector table in SRAM2 (make RAMFUNC=0 to compare) */
+#endif
+
+/* ============================================================================
+   Boot Configuration
+   ============================================================================ */
+#define BOOT_MAX_STAGES         24     /* Boot marks kept for the 'boot' report */
+#ifndef BOOT_DEFER_ENABLE
+#define BOOT_DEFER_ENABLE       1      /* Deferred inits in a boot task (make BOOT_DEFER=0 to compare) */
+#endif
+
+/* ============================================================================
+   Task Watchdog Configuration
+   ============================================================================ */
+#define TASKWDT_ENABLE          1      /* Per-task check-ins gate the hardware watchdog kick */
+#define TASKWDT_MAX_TASKS       8      /* Tasks that can register */
+#define TASKWDT_TIMEOUT_MS      2000   /* Hardware watchdog timeout */
+#define TASKWDT_CHECK_PERIOD_TICKS 250 /* Monitor timer period (must be well below the timeout) */
+
+/* ============================================================================
+   Key/Value Store Configuration
+   ============================================================================ */
+#define KVSTORE_MAX_KEYS        64     /* Live keys tracked by the RAM index */
+#define KVSTORE_KEY_MAX_LEN     32     /* Max key length in bytes */
+#define KVSTORE_VALUE_MAX_LEN   256    /* Max value length in bytes */
+#define KVSTORE_GC_PERIOD_TICKS 1000   /* Background compaction interval */
+
+/* ============================================================================
+   DVFS Configuration
+   ============================================================================ */
+#ifndef DVFS_ENABLE
+#define DVFS_ENABLE             1      /* Governor picks the clock from idle time (make DVFS=0: fixed 80 MHz) */
+#endif
+#define DVFS_SAMPLE_TICKS       50     /* Load sampling period */
+#define DVFS_UP_PCT             80     /* Busy at or above this: go straight to the top clock */
+#define DVFS_TARGET_PCT         60     /* Pick the lowest clock expected to stay below this */
+#define DVFS_DOWN_SAMPLES       4      /* Consecutive low samples before stepping down */
+#define DVFS_MIN_HZ             4000000 /* Lowest clock the governor may pick */
+#define DVFS_MAX_NOTIFIERS      8      /* Drivers that can register for clock changes */
 
 /* ============================================================================
    Compile-Time Validation
    ============================================================================ */
 
+#if TASKWDT_ENABLE && (TASKWDT_CHECK_PERIOD_TICKS * 1000 / SYSTICK_FREQ_HZ) * 2 > TASKWDT_TIMEOUT_MS
+    #error "TASKWDT_CHECK_PERIOD_TICKS must be at most half of TASKWDT_TIMEOUT_MS"
+#endif
+
+#if DVFS_TARGET_PCT >= DVFS_UP_PCT
+    #error "DVFS_TARGET_PCT must be below DVFS_UP_PCT"
+#endif
+
 /* Verify MAX_TASKS is reasonable */
 #if MAX_TASKS < 2
     #error "MAX_TASKS must be at least 2 (for idle + 1 user task)"
@@ -41,8 +41,9 @@ int flash_program(uint32_t addr, const void *data, size_t len);
 
 /**
  * @brief Read data from Flash memory.
- * Note: Flash is typically memory-mapped; this performs a simple copy.
- *       No bounds checking is performed in the generic driver.
+ * Note: Flash is typically memory-mapped; this performs a simple copy
+ *       through the HAL address mapping (identity on hardware, the
+ *       simulated array on native). No bounds checking is performed.
  *
  * @param addr The address to start reading from.
  * @param out Pointer to the destination buffer.
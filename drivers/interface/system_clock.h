@@ -0,0 +1,138 @@
+#ifndef SYSTEM_CLOCK_H
+#define SYSTEM_CLOCK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SYSTEM_CLOCK_OK                 0
+#define SYSTEM_CLOCK_ERR_UNSUPPORTED    (-1)
+#define SYSTEM_CLOCK_ERR_TIMEOUT        (-2)
+
+/* Default busy-wait loop iteration limit used when waiting for
+ * hardware flags (MSI/HSI/PLL ready, clock switch, etc.)
+ */
+#define SYSTEM_CLOCK_WAIT_MAX_ITER      (1000000U)
+
+/* Supported system clock frequencies (Hz) */
+typedef enum {
+    SYSCLOCK_HZ_4MHZ  = 4000000UL,
+    SYSCLOCK_HZ_16MHZ = 16000000UL,
+    SYSCLOCK_HZ_24MHZ = 24000000UL,
+    SYSCLOCK_HZ_32MHZ = 32000000UL,
+    SYSCLOCK_HZ_48MHZ = 48000000UL,
+    SYSCLOCK_HZ_64MHZ = 64000000UL,
+    SYSCLOCK_HZ_80MHZ = 80000000UL,
+} sysclock_hz_t;
+
+/* Core voltage range (PWR_CR1 VOS). Range 1 is the higher voltage. */
+typedef enum {
+    SYSTEM_VOS1 = 1,    /* Up to 80 MHz */
+    SYSTEM_VOS2 = 2,    /* Up to 26 MHz */
+} system_vos_t;
+
+/* SYSCLK source, encoded as RCC_CFGR SW */
+typedef enum {
+    SYSCLK_SRC_MSI = 0,
+    SYSCLK_SRC_HSI16 = 1,
+    SYSCLK_SRC_HSE = 2,
+    SYSCLK_SRC_PLL = 3,
+} sysclk_source_t;
+
+/**
+ * @brief One operating point: a SYSCLK frequency, how it is generated and
+ * the voltage range it runs in. PLL points are generated from HSI16:
+ * SYSCLK = (16 MHz / pllm) * plln / (2 * (pllr_bits + 1)).
+ */
+typedef struct {
+    uint32_t hz;
+    sysclk_source_t source;
+    system_vos_t vos;
+    uint8_t msi_range;      /* RCC_CR MSIRANGE code (MSI only) */
+    uint8_t pllm;           /* PLL input divider (PLL only) */
+    uint8_t plln;           /* PLL multiplier (PLL only) */
+    uint8_t pllr_bits;      /* PLLR encoding: 0 = /2, 1 = /4 (PLL only) */
+} sysclock_opp_t;
+
+/**
+ * @brief Configure system clock (SYSCLK) to X Hz.
+ *
+ * Supported values: 4, 16, 24, 32, 48, 64, 80 MHz. The clock tree is first
+ * returned to its reset state (MSI 4 MHz, range 1, 0 wait states), so this
+ * is safe whatever state a bootloader left it in.
+ *
+ * @param target_hz  Desired SYSCLK frequency in Hz.
+ * @return `SYSTEM_CLOCK_OK` (0) on success,
+ *         `SYSTEM_CLOCK_ERR_UNSUPPORTED` (-1) if `target_hz` is not supported,
+ *         `SYSTEM_CLOCK_ERR_TIMEOUT` (-2) if a hardware ready/switch wait timed out.
+ */
+int system_clock_config_hz(sysclock_hz_t target_hz);
+
+/**
+ * @brief Switch SYSCLK from the current operating point to another at run time.
+ *
+ * The voltage range is raised and wait states are added before the clock
+ * gets faster; wait states are removed and the voltage lowered only after
+ * it got slower. A PLL-to-PLL switch runs from HSI16 while the PLL relocks.
+ * Oscillators the new point does not use are turned off, except MSI.
+ *
+ * Not reentrant. Peripherals clocked from SYSCLK see the new rate at once;
+ * use dvfs_set_hz() to have drivers reprogram their dividers.
+ *
+ * @param target_hz  Frequency of an entry of the operating point table.
+ * @return Same codes as system_clock_config_hz(). On a timeout the clock
+ *         is left on a valid, consistent operating point.
+ */
+int system_clock_switch(uint32_t target_hz);
+
+/**
+ * @brief Get current System Clock in Hz.
+ *
+ * This returns the frequency of the operating point the last
+ * system_clock_config_hz() or system_clock_switch() left running.
+ */
+uint32_t get_system_clock_hz(void);
+
+/**
+ * @brief Get the current voltage range.
+ */
+system_vos_t system_clock_get_vos(void);
+
+/**
+ * @brief Get the current number of flash wait states.
+ */
+uint32_t system_clock_get_flash_latency(void);
+
+/**
+ * @brief Get the flash wait states a frequency needs in a voltage range.
+ * @param hz   SYSCLK frequency in Hz.
+ * @param vos  Voltage range.
+ * @return Wait states (0..4).
+ */
+uint32_t system_clock_flash_latency(uint32_t hz, system_vos_t vos);
+
+/**
+ * @brief Get the number of operating points.
+ */
+size_t system_clock_opp_count(void);
+
+/**
+ * @brief Get an operating point by index, in ascending frequency order.
+ * @return Pointer to the entry, or NULL if the index is out of range.
+ */
+const sysclock_opp_t *system_clock_get_opp(size_t index);
+
+/**
+ * @brief Find the operating point for a frequency.
+ * @return Pointer to the entry, or NULL if the frequency is not supported.
+ */
+const sysclock_opp_t *system_clock_find_opp(uint32_t hz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYSTEM_CLOCK_H */
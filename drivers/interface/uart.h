@@ -4,6 +4,12 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "queue.h"
+#include "pbuf.h"
+#include "project_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /**
  * @brief Opaque Handle for the UART port.
@@ -94,6 +100,40 @@ int uart_read_buffer(uart_port_t port, char *buf, size_t len);
  */
 int uart_write_buffer(uart_port_t port, const char *buf, size_t len);
 
+/**
+ * @brief Queues a packet buffer chain to be sent out without copying it.
+ *
+ * The TX interrupt reads the bytes straight out of the chunks and frees the
+ * chain once its last byte has gone out. Queued frames go out before any
+ * bytes written with uart_write_buffer().
+ *
+ * @param port Handle to the UART port.
+ * @param p Head of the chain; the caller's reference passes to the driver on success.
+ * @return 0 on success, -1 if UART_TX_PBUF_DEPTH frames are already queued (the caller keeps @p p).
+ */
+int uart_write_pbuf(uart_port_t port, pbuf_t *p);
+
+/**
+ * @brief Deliver received bytes as packet buffers instead of the RX ring.
+ *
+ * The RX interrupt fills one chunk from @p pool at a time and pushes the
+ * pbuf_t pointer to @p q when the chunk is full or uart_rx_pbuf_flush() is
+ * called. The receiver owns each pbuf_t and frees it with pbuf_free().
+ *
+ * @param port Handle to the UART port.
+ * @param pool Pool to take RX chunks from.
+ * @param q Queue of pbuf_t* items (NULL to disable).
+ */
+void uart_set_rx_pbuf(uart_port_t port, pbuf_pool_t *pool, queue_t *q);
+
+/**
+ * @brief Hand over the partly filled RX chunk, e.g. on line idle or a frame delimiter.
+ * Safe from ISRs.
+ * @param port Handle to the UART port.
+ * @return Number of bytes delivered, 0 if the chunk was empty, -1 if the queue was full (bytes dropped).
+ */
+int uart_rx_pbuf_flush(uart_port_t port);
+
 /**
  * @brief Turns the Receive Interrupt on or off.
  * @param port Handle to the UART port.
@@ -157,4 +197,8 @@ void uart_core_rx_error_callback(uart_port_t port);
  */
 size_t uart_get_context_size(void);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* UART_H */
@@ -1,6 +1,8 @@
 #include "exti.h"
 #include "exti_hal.h"
 #include <stddef.h>
+#include "perf.h"
+#include "scheduler.h"
 
 typedef struct {
     exti_callback_t callback;
@@ -34,8 +36,13 @@ void exti_disable(uint8_t pin) {
     }
 }
 
+PERF_COUNTER(perf_irq_exti, "irq.exti");
+
 void exti_core_irq_handler(uint8_t pin) {
+    PERF_INC(perf_irq_exti);
     if (pin < EXTI_HAL_MAX_LINES && g_exti_handlers[pin].callback) {
         g_exti_handlers[pin].callback(g_exti_handlers[pin].arg);
     }
+    /* The callback may have woken a task that should run right away */
+    scheduler_yield_from_isr();
 }
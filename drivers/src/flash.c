@@ -26,6 +26,6 @@ int flash_read(uintptr_t addr, void *out, size_t len) {
     if (!out || len == 0U) {
         return -1;
     }
-    utils_memcpy(out, (const void *)addr, len);
+    utils_memcpy(out, flash_hal_map(addr), len);
     return 0;
 }
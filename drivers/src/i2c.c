@@ -2,6 +2,7 @@
 #include "allocator.h"
 #include "i2c_hal.h"
 #include "utils.h"
+#include "dvfs.h"
 
 typedef enum {
     I2C_STATE_IDLE,
@@ -19,8 +20,23 @@ struct i2c_context {
     volatile size_t transfer_idx;
     volatile i2c_state_t state;
     uint16_t addr;
+    uint32_t speed;     /* Bus speed to keep across core clock changes */
 };
 
+/* Clock change notifier: only between transfers, then recompute the bus timing */
+static int i2c_clock_notify(dvfs_event_t event, uint32_t old_hz, uint32_t new_hz, void *arg) {
+    i2c_port_t port = (i2c_port_t)arg;
+    (void)old_hz;
+
+    if (event == DVFS_PRE_CHANGE) {
+        return (port->state != I2C_STATE_IDLE) ? -1 : 0;
+    }
+    if (event == DVFS_POST_CHANGE) {
+        i2c_hal_set_clock(port->hal_handle, new_hz, port->speed);
+    }
+    return 0;
+}
+
 size_t i2c_get_context_size(void) {
     return sizeof(struct i2c_context);
 }
@@ -39,6 +55,11 @@ i2c_port_t i2c_init(void *memory_block, void *hal_handle, void *config) {
     /* Initialize hardware via HAL */
     i2c_hal_init(port->hal_handle, config);
 
+    port->speed = i2c_hal_config_speed(config);
+    if (port->speed != 0U) {
+        dvfs_notifier_register(i2c_clock_notify, port);
+    }
+
     return port;
 }
 
@@ -52,6 +73,7 @@ i2c_port_t i2c_create(void *hal_handle, void *config) {
 
 void i2c_destroy(i2c_port_t port) {
     if (port) {
+        dvfs_notifier_unregister(i2c_clock_notify, port);
         allocator_free(port);
     }
 }
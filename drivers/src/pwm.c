@@ -2,12 +2,29 @@
 #include "pwm_hal.h"
 #include "allocator.h"
 #include "utils.h"
+#include "dvfs.h"
 
 struct pwm_context {
     void *hal_handle;
     uint8_t channel;
+    uint32_t freq_hz;   /* Output frequency to keep across core clock changes */
 };
 
+/* Clock change notifier: refuse clocks the prescaler cannot divide down to freq_hz */
+static int pwm_clock_notify(dvfs_event_t event, uint32_t old_hz, uint32_t new_hz, void *arg) {
+    pwm_port_t port = (pwm_port_t)arg;
+    int32_t psc = pwm_hal_calc_prescaler(new_hz, port->freq_hz);
+    (void)old_hz;
+
+    if (event == DVFS_PRE_CHANGE) {
+        return (psc < 0) ? -1 : 0;
+    }
+    if (event == DVFS_POST_CHANGE && psc >= 0) {
+        pwm_hal_set_prescaler(port->hal_handle, (uint32_t)psc);
+    }
+    return 0;
+}
+
 size_t pwm_get_context_size(void) {
     return sizeof(struct pwm_context);
 }
@@ -20,11 +37,13 @@ pwm_port_t pwm_create(void *hal_handle, uint8_t channel, uint32_t freq_hz, uint8
 
     port->hal_handle = hal_handle;
     port->channel = channel;
+    port->freq_hz = freq_hz;
 
     if (pwm_hal_init(hal_handle, channel, freq_hz) != 0) {
         allocator_free(port);
         return NULL;
     }
+    dvfs_notifier_register(pwm_clock_notify, port);
 
     pwm_hal_set_duty(hal_handle, channel, duty_percent);
     return port;
@@ -32,6 +51,7 @@ pwm_port_t pwm_create(void *hal_handle, uint8_t channel, uint32_t freq_hz, uint8
 
 void pwm_destroy(pwm_port_t port) {
     if (port) {
+        dvfs_notifier_unregister(pwm_clock_notify, port);
         pwm_hal_stop(port->hal_handle, port->channel);
         allocator_free(port);
     }
@@ -2,6 +2,8 @@
 #include "allocator.h"
 #include "spi_hal.h"
 #include "utils.h"
+#include "platform.h"
+#include "dvfs.h"
 
 struct spi_context {
     void *hal_handle;          /* Hardware handle (passed to HAL) */
@@ -13,8 +15,23 @@ struct spi_context {
     volatile size_t tx_count;  /* Number of bytes transmitted */
     volatile size_t rx_count;  /* Number of bytes received */
     volatile uint8_t busy;     /* Non-zero while an async transfer is active */
+    uint32_t sck_hz;           /* Bus clock to keep across core clock changes */
 };
 
+/* Clock change notifier: wait for the bus to go idle, then re-pick the prescaler */
+static int spi_clock_notify(dvfs_event_t event, uint32_t old_hz, uint32_t new_hz, void *arg) {
+    spi_port_t port = (spi_port_t)arg;
+    (void)old_hz;
+
+    if (event == DVFS_PRE_CHANGE) {
+        return (port->busy || spi_hal_busy(port->hal_handle)) ? -1 : 0;
+    }
+    if (event == DVFS_POST_CHANGE) {
+        spi_hal_set_sck_hz(port->hal_handle, new_hz, port->sck_hz);
+    }
+    return 0;
+}
+
 /* Get the size of the SPI context structure */
 size_t spi_get_context_size(void) {
     return sizeof(struct spi_context);
@@ -35,6 +52,12 @@ spi_port_t spi_init(void *memory_block, void *hal_handle, void *config) {
     /* Initialize hardware via HAL */
     spi_hal_init(port->hal_handle, config);
 
+    /* SCK must not get faster than the device was configured for */
+    port->sck_hz = spi_hal_get_sck_hz(port->hal_handle, (uint32_t)platform_get_cpu_freq());
+    if (port->sck_hz != 0U) {
+        dvfs_notifier_register(spi_clock_notify, port);
+    }
+
     return port;
 }
 
@@ -50,6 +73,7 @@ spi_port_t spi_create(void *hal_handle, void *config) {
 /* Destroy a SPI context created with spi_create */
 void spi_destroy(spi_port_t port) {
     if (port) {
+        dvfs_notifier_unregister(spi_clock_notify, port);
         allocator_free(port);
     }
 }
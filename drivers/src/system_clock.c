@@ -0,0 +1,288 @@
+#include "system_clock.h"
+#include "clock_hal.h"
+
+#define ARRAY_LEN(a)    (sizeof(a) / sizeof((a)[0]))
+
+/*********** Type definitions ***********/
+/* What the sequencer has programmed so far, updated after every step */
+typedef struct {
+    uint32_t hz;
+    sysclk_source_t source;
+    system_vos_t vos;
+    uint32_t latency;
+    uint8_t msi_range;
+    uint8_t hsi_on;
+    uint8_t pll_on;
+} clock_state_t;
+
+/*********** Global variables ***********/
+/*
+ * Operating points, ascending. Up to 26 MHz runs in range 2 from an
+ * oscillator directly; above that the PLL runs from HSI16 in range 1.
+ */
+static const sysclock_opp_t clock_opps[] = {
+    { SYSCLOCK_HZ_4MHZ,  SYSCLK_SRC_MSI,   SYSTEM_VOS2, 0x6U, 0U,  0U, 0x0U },
+    { SYSCLOCK_HZ_16MHZ, SYSCLK_SRC_HSI16, SYSTEM_VOS2, 0U,   0U,  0U, 0x0U },
+    { SYSCLOCK_HZ_24MHZ, SYSCLK_SRC_MSI,   SYSTEM_VOS2, 0x9U, 0U,  0U, 0x0U },
+    { SYSCLOCK_HZ_32MHZ, SYSCLK_SRC_PLL,   SYSTEM_VOS1, 0U,   2U,  8U, 0x0U },
+    { SYSCLOCK_HZ_48MHZ, SYSCLK_SRC_PLL,   SYSTEM_VOS1, 0U,   2U, 12U, 0x0U },
+    { SYSCLOCK_HZ_64MHZ, SYSCLK_SRC_PLL,   SYSTEM_VOS1, 0U,   2U, 16U, 0x0U },
+    { SYSCLOCK_HZ_80MHZ, SYSCLK_SRC_PLL,   SYSTEM_VOS1, 0U,   2U, 20U, 0x0U },
+};
+
+/* Reset state: MSI 4 MHz, range 1, no wait states */
+static clock_state_t clock_state = {
+    4000000UL, SYSCLK_SRC_MSI, SYSTEM_VOS1, 0U, 0x6U, 0U, 0U
+};
+
+/*********** Static function prototypes ***********/
+static int clock_set_vos(system_vos_t vos);
+static int clock_set_latency(uint32_t latency);
+static int clock_enter_default(void);
+static int clock_enter_source(const sysclock_opp_t *opp);
+static int clock_release_unused(void);
+
+/*********** Function definitions ***********/
+/* wait states needed by sysclk in a power range */
+uint32_t system_clock_flash_latency(uint32_t hz, system_vos_t vos) {
+    uint32_t latency;
+
+    switch(vos)
+    {
+        case SYSTEM_VOS1:
+            if(hz <= 16000000UL) {
+                latency = 0;
+            } else if(hz <= 32000000UL) {
+                latency = 1;
+            } else if(hz <= 48000000UL) {
+                latency = 2;
+            } else if(hz <= 64000000UL) {
+                latency = 3;
+            } else { /* max sysclk in VOS1 is 80MHz */
+                latency = 4;
+            }
+            break;
+        case SYSTEM_VOS2:
+            if(hz <= 6000000UL) {
+                latency = 0;
+            } else if(hz <= 12000000UL) {
+                latency = 1;
+            } else if(hz <= 18000000UL) {
+                latency = 2;
+            } else { /* max sysclk in VOS2 is 26MHz */
+                latency = 3;
+            }
+            break;
+        default:
+            /* invalid power range, default to max latency */
+            latency = 4;
+            break;
+    }
+    return latency;
+}
+
+static int clock_set_vos(system_vos_t vos) {
+    if (vos == clock_state.vos) {
+        return SYSTEM_CLOCK_OK;
+    }
+    int rc = clock_hal_set_vos(vos);
+    if (rc == SYSTEM_CLOCK_OK || vos == SYSTEM_VOS2) {
+        /* On a timeout assume the lower voltage, so the next speed-up raises it again */
+        clock_state.vos = vos;
+    }
+    return rc;
+}
+
+static int clock_set_latency(uint32_t latency) {
+    if (latency == clock_state.latency) {
+        return SYSTEM_CLOCK_OK;
+    }
+    int rc = clock_hal_set_flash_latency(latency);
+    if (rc == SYSTEM_CLOCK_OK || latency < clock_state.latency) {
+        /* On a timeout assume the fewer, so the next speed-up writes them again */
+        clock_state.latency = latency;
+    }
+    return rc;
+}
+
+/* set system clock to default state (MSI 4MHz, range 1, 0 WS) */
+static int clock_enter_default(void) {
+    int rc;
+
+    /* MSI 4 MHz is valid in any range with any latency, so go there first */
+    rc = clock_hal_msi_enable(0x6U);
+    if (rc == SYSTEM_CLOCK_OK) rc = clock_hal_select(SYSCLK_SRC_MSI);
+    if (rc != SYSTEM_CLOCK_OK) return rc;
+    clock_state.hz = SYSCLOCK_HZ_4MHZ;
+    clock_state.source = SYSCLK_SRC_MSI;
+    clock_state.msi_range = 0x6U;
+
+    /* Whatever was on before is unknown: turn it off unconditionally */
+    rc = clock_hal_osc_disable(SYSCLK_SRC_PLL);
+    if (rc == SYSTEM_CLOCK_OK) rc = clock_hal_osc_disable(SYSCLK_SRC_HSI16);
+    if (rc == SYSTEM_CLOCK_OK) rc = clock_hal_set_vos(SYSTEM_VOS1);
+    if (rc == SYSTEM_CLOCK_OK) rc = clock_hal_set_flash_latency(0U);
+    if (rc != SYSTEM_CLOCK_OK) return rc;
+    clock_state.pll_on = 0;
+    clock_state.hsi_on = 0;
+    clock_state.vos = SYSTEM_VOS1;
+    clock_state.latency = 0;
+    return SYSTEM_CLOCK_OK;
+}
+
+/* Bring up the target's oscillator and make it SYSCLK */
+static int clock_enter_source(const sysclock_opp_t *opp) {
+    int rc;
+
+    if (opp->source == SYSCLK_SRC_MSI) {
+        /* Retunes in place when MSI is already SYSCLK */
+        rc = clock_hal_msi_enable(opp->msi_range);
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+        clock_state.msi_range = opp->msi_range;
+        if (clock_state.source == SYSCLK_SRC_MSI) {
+            clock_state.hz = opp->hz;
+        }
+        rc = clock_hal_select(SYSCLK_SRC_MSI);
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+        clock_state.source = SYSCLK_SRC_MSI;
+        clock_state.hz = opp->hz;
+        return SYSTEM_CLOCK_OK;
+    }
+
+    /* HSI16 is the target, or the PLL input */
+    if (!clock_state.hsi_on) {
+        rc = clock_hal_hsi16_enable();
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+        clock_state.hsi_on = 1;
+    }
+
+    /* The PLL cannot be reconfigured while it drives SYSCLK: bridge on HSI16 */
+    if (clock_state.source == SYSCLK_SRC_PLL) {
+        rc = clock_hal_select(SYSCLK_SRC_HSI16);
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+        clock_state.source = SYSCLK_SRC_HSI16;
+        clock_state.hz = SYSCLOCK_HZ_16MHZ;
+    }
+
+    if (opp->source == SYSCLK_SRC_PLL) {
+        clock_state.pll_on = 1;   /* Possibly on but unlocked if this fails */
+        rc = clock_hal_pll_enable(opp);
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+    }
+
+    rc = clock_hal_select(opp->source);
+    if (rc != SYSTEM_CLOCK_OK) return rc;
+    clock_state.source = opp->source;
+    clock_state.hz = opp->hz;
+    return SYSTEM_CLOCK_OK;
+}
+
+/* Turn off the PLL and HSI16 when SYSCLK no longer needs them. MSI stays on. */
+static int clock_release_unused(void) {
+    int rc;
+
+    if (clock_state.pll_on && clock_state.source != SYSCLK_SRC_PLL) {
+        rc = clock_hal_osc_disable(SYSCLK_SRC_PLL);
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+        clock_state.pll_on = 0;
+    }
+    if (clock_state.hsi_on && !clock_state.pll_on && clock_state.source != SYSCLK_SRC_HSI16) {
+        rc = clock_hal_osc_disable(SYSCLK_SRC_HSI16);
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+        clock_state.hsi_on = 0;
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+/* move between operating points */
+int system_clock_switch(uint32_t target_hz) {
+    const sysclock_opp_t *opp = system_clock_find_opp(target_hz);
+    int rc;
+
+    if (opp == NULL) {
+        return SYSTEM_CLOCK_ERR_UNSUPPORTED;
+    }
+    if (opp->hz == clock_state.hz && opp->source == clock_state.source &&
+        opp->vos == clock_state.vos) {
+        return SYSTEM_CLOCK_OK;
+    }
+
+    /*
+     * During the switch the larger of the current and the target latency is
+     * in force. Range 1 never needs more wait states than range 2 for the
+     * same clock, so that also covers the HSI16 bridge and raising the voltage.
+     */
+    uint32_t latency = system_clock_flash_latency(opp->hz, opp->vos);
+
+    /* 1. Voltage up, before anything gets faster */
+    if (opp->vos == SYSTEM_VOS1) {
+        rc = clock_set_vos(SYSTEM_VOS1);
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+    }
+
+    /* 2. Wait states up */
+    if (latency > clock_state.latency) {
+        rc = clock_set_latency(latency);
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+    }
+
+    /* 3. New source */
+    rc = clock_enter_source(opp);
+    if (rc != SYSTEM_CLOCK_OK) return rc;
+
+    /* 4. The PLL must be off before range 2, where its VCO limit is lower */
+    rc = clock_release_unused();
+    if (rc != SYSTEM_CLOCK_OK) return rc;
+
+    /* 5. Wait states down, now that the clock is slower */
+    if (latency < clock_state.latency) {
+        rc = clock_set_latency(latency);
+        if (rc != SYSTEM_CLOCK_OK) return rc;
+    }
+
+    /* 6. Voltage down last; latency already covers the target in range 2 */
+    return clock_set_vos(opp->vos);
+}
+
+/* configure the system clock */
+int system_clock_config_hz(sysclock_hz_t target_hz) {
+    if (system_clock_find_opp((uint32_t)target_hz) == NULL) {
+        return SYSTEM_CLOCK_ERR_UNSUPPORTED;
+    }
+    /* first return to default sysclk for safety */
+    if (clock_enter_default() != SYSTEM_CLOCK_OK) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    return system_clock_switch((uint32_t)target_hz);
+}
+
+/* get the system clock */
+uint32_t get_system_clock_hz(void)
+{
+    return clock_state.hz;
+}
+
+system_vos_t system_clock_get_vos(void) {
+    return clock_state.vos;
+}
+
+uint32_t system_clock_get_flash_latency(void) {
+    return clock_state.latency;
+}
+
+size_t system_clock_opp_count(void) {
+    return ARRAY_LEN(clock_opps);
+}
+
+const sysclock_opp_t *system_clock_get_opp(size_t index) {
+    return index < ARRAY_LEN(clock_opps) ? &clock_opps[index] : NULL;
+}
+
+const sysclock_opp_t *system_clock_find_opp(uint32_t hz) {
+    for (size_t i = 0; i < ARRAY_LEN(clock_opps); i++) {
+        if (clock_opps[i].hz == hz) {
+            return &clock_opps[i];
+        }
+    }
+    return NULL;
+}
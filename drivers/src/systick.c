@@ -3,6 +3,7 @@
 #include "scheduler.h"
 #include "arch_ops.h"
 #include "platform.h"
+#include "perf.h"
 #include <stddef.h>
 
 /* Global tick counter */
@@ -24,7 +25,7 @@ int systick_init(uint32_t ticks_hz) {
 }
 
 /* Get the current tick count */
-uint32_t systick_get_ticks(void) {
+RAMFUNC uint32_t systick_get_ticks(void) {
     return g_systick_ticks;
 }
 
@@ -36,9 +37,12 @@ void systick_delay_ticks(uint32_t ticks) {
     }
 }
 
+PERF_COUNTER(perf_irq_systick, "irq.systick");
+
 /* Core interrupt handler for system tick */
-void systick_core_tick(void) {
+RAMFUNC void systick_core_tick(void) {
     g_systick_ticks++;
+    PERF_INC(perf_irq_systick);
     if (scheduler_tick()) {
         arch_yield();
     }
@@ -7,6 +7,9 @@
 #include "arch_ops.h"
 #include "scheduler.h"
 #include "spinlock.h"
+#include "perf.h"
+#include "pbuf.h"
+#include "dvfs.h"
 
 struct uart_context {
     void            *hal_handle;        /* Hardware handle (passed to HAL) */
@@ -24,8 +27,41 @@ struct uart_context {
     volatile uint16_t rx_overflow;      /* Count of RX buffer overflows */
     volatile uint16_t rx_errors;        /* Count of RX hardware errors */
     uint16_t        rx_notify_task_id;  /* Task ID to notify on RX */
+
+    /* Packet buffer paths */
+    pbuf_t          *tx_frames[UART_TX_PBUF_DEPTH]; /* Chains waiting to go out */
+    uint8_t         tx_frame_head;      /* Index of the frame being sent */
+    volatile uint8_t tx_frame_count;    /* Frames queued, including the one being sent */
+    uint16_t        tx_chunk_off;       /* Next byte in tx_chunk (TX ISR only) */
+    pbuf_t          *tx_chunk;          /* Chunk being sent, NULL between frames (TX ISR only) */
+    pbuf_pool_t     *rx_pool;           /* Pool for RX chunks */
+    queue_t         *rx_pbuf_queue;     /* Queue of filled RX chunks */
+    pbuf_t          *rx_chunk;          /* Chunk being filled */
+
+    uint32_t        baud;               /* Line rate, kept across clock changes */
 };
 
+PERF_COUNTER(perf_uart_rx_overflow, "uart.rx_overflow");
+PERF_COUNTER(perf_uart_rx_error, "uart.rx_error");
+
+/* Clock change notifier: hold the clock while bytes are pending, then retime */
+static int uart_clock_notify(dvfs_event_t event, uint32_t old_hz, uint32_t new_hz, void *arg) {
+    uart_port_t port = (uart_port_t)arg;
+    (void)old_hz;
+
+    if (event == DVFS_PRE_CHANGE) {
+        uint8_t b;
+        if (port->tx_head != port->tx_tail || port->tx_frame_count != 0 ||
+            (port->tx_queue && queue_peek(port->tx_queue, &b) == 0) ||
+            uart_hal_tx_busy(port->hal_handle)) {
+            return -1;
+        }
+    } else if (event == DVFS_POST_CHANGE) {
+        uart_hal_set_baud(port->hal_handle, port->baud, new_hz);
+    }
+    return 0;
+}
+
 /* Get the size of the UART context structure */
 size_t uart_get_context_size(void) {
     return sizeof(struct uart_context);
@@ -60,6 +96,12 @@ uart_port_t uart_init(void *memory_block,
     port->tx_buf_size = (uint16_t)tx_size;
 
     uart_hal_init(port->hal_handle, config, clock_freq);
+
+    /* Recompute the baud divider whenever the core clock changes */
+    port->baud = uart_hal_config_baud(config);
+    if (port->baud != 0U) {
+        dvfs_notifier_register(uart_clock_notify, port);
+    }
     return port;
 }
 
@@ -81,6 +123,7 @@ uart_port_t uart_create(void *hal_handle,
 /* Free the memory allocated for the UART context */
 void uart_destroy(uart_port_t port) {
     if (port) {
+        dvfs_notifier_unregister(uart_clock_notify, port);
         allocator_free(port);
     }
 }
@@ -175,6 +218,77 @@ int uart_write_buffer(uart_port_t port, const char *src, size_t len) {
     return (int)sent;
 }
 
+/* Queue a chain; the TX interrupt sends it from the chunks */
+int uart_write_pbuf(uart_port_t port, pbuf_t *p) {
+    if (!port || !p) {
+        return -1;
+    }
+
+    uint32_t stat = spin_lock(&port->lock);
+    if (port->tx_frame_count == UART_TX_PBUF_DEPTH) {
+        spin_unlock(&port->lock, stat);
+        return -1;
+    }
+
+    uint8_t idx = (uint8_t)((port->tx_frame_head + port->tx_frame_count) % UART_TX_PBUF_DEPTH);
+    port->tx_frames[idx] = p;
+    port->tx_frame_count++;
+
+    uart_hal_enable_tx_interrupt(port->hal_handle, 1);
+    spin_unlock(&port->lock, stat);
+    return 0;
+}
+
+/* Route received bytes into pbuf chunks */
+void uart_set_rx_pbuf(uart_port_t port, pbuf_pool_t *pool, queue_t *q) {
+    if (!port) {
+        return;
+    }
+
+    uint32_t stat = spin_lock(&port->lock);
+    pbuf_t *partial = port->rx_chunk;
+    port->rx_chunk = NULL;
+    port->rx_pool = q ? pool : NULL;
+    port->rx_pbuf_queue = (q && pool) ? q : NULL;
+    spin_unlock(&port->lock, stat);
+
+    pbuf_free(partial);
+}
+
+/* Push a filled RX chunk to the receiver */
+static int uart_rx_pbuf_deliver(uart_port_t port, pbuf_t *c) {
+    if (queue_push_from_isr(port->rx_pbuf_queue, &c) < 0) {
+        port->rx_overflow++;
+        PERF_INC(perf_uart_rx_overflow);
+        pbuf_free(c);
+        return -1;
+    }
+    return 0;
+}
+
+/* Hand over the partly filled RX chunk */
+int uart_rx_pbuf_flush(uart_port_t port) {
+    if (!port || !port->rx_pbuf_queue) {
+        return 0;
+    }
+
+    uint32_t stat = spin_lock(&port->lock);
+    pbuf_t *c = port->rx_chunk;
+    if (c && c->len == 0) {
+        c = NULL;
+    }
+    if (c) {
+        port->rx_chunk = NULL;
+    }
+    spin_unlock(&port->lock, stat);
+
+    if (!c) {
+        return 0;
+    }
+    int len = c->len;
+    return (uart_rx_pbuf_deliver(port, c) == 0) ? len : -1;
+}
+
 /* Enable or disable the Receive Interrupt */
 void uart_enable_rx_interrupt(uart_port_t port, uint8_t enable) {
     uart_hal_enable_rx_interrupt(port ? port->hal_handle : NULL, enable);
@@ -221,9 +335,35 @@ void uart_core_rx_callback(uart_port_t port, uint8_t byte) {
         return;
     }
 
-    if (port->rx_queue != NULL) {
+    if (port->rx_pbuf_queue != NULL) {
+        uint32_t stat = spin_lock(&port->lock);
+        pbuf_t *c = port->rx_chunk;
+        if (!c) {
+            c = pbuf_alloc(port->rx_pool, 0, 0);
+            port->rx_chunk = c;
+        }
+        if (!c) {
+            port->rx_overflow++;
+            PERF_INC_LOCKED(perf_uart_rx_overflow);
+            spin_unlock(&port->lock, stat);
+            return;
+        }
+
+        c->payload[c->len++] = byte;
+        c->tot_len = c->len;
+        int full = (c->len == pbuf_pool_chunk_size(port->rx_pool));
+        if (full) {
+            port->rx_chunk = NULL;
+        }
+        spin_unlock(&port->lock, stat);
+
+        if (full) {
+            (void)uart_rx_pbuf_deliver(port, c);
+        }
+    } else if (port->rx_queue != NULL) {
         if (queue_push_from_isr(port->rx_queue, &byte) < 0) {
             port->rx_overflow++;
+            PERF_INC(perf_uart_rx_overflow);
         }
     } else {
         if (port->rx_buf == NULL) {
@@ -250,6 +390,7 @@ void uart_core_rx_callback(uart_port_t port, uint8_t byte) {
             }
         } else {
             port->rx_overflow++;
+            PERF_INC_LOCKED(perf_uart_rx_overflow);
         }
         spin_unlock(&port->lock, stat);
 
@@ -265,6 +406,43 @@ int uart_core_tx_callback(uart_port_t port, uint8_t *byte) {
         return 0;
     }
 
+    /* Frames: only this interrupt moves the cursor, so bytes need no lock */
+    if (port->tx_frame_count != 0) {
+        arch_dmb();     /* See the slot written before the count */
+        while (1) {
+            pbuf_t *c = port->tx_chunk;
+            if (!c) {
+                if (port->tx_frame_count == 0) {
+                    break;
+                }
+                c = port->tx_frames[port->tx_frame_head];
+                port->tx_chunk = c;
+                port->tx_chunk_off = 0;
+            }
+
+            if (port->tx_chunk_off < c->len) {
+                *byte = c->payload[port->tx_chunk_off++];
+                return 1;
+            }
+
+            /* Chunk done: move along the chain, or retire the frame */
+            port->tx_chunk_off = 0;
+            if (c->next) {
+                port->tx_chunk = c->next;
+                continue;
+            }
+
+            uint32_t stat = spin_lock(&port->lock);
+            pbuf_t *done = port->tx_frames[port->tx_frame_head];
+            port->tx_frame_head = (uint8_t)((port->tx_frame_head + 1U) % UART_TX_PBUF_DEPTH);
+            port->tx_frame_count--;
+            spin_unlock(&port->lock, stat);
+
+            port->tx_chunk = NULL;
+            pbuf_free(done);
+        }
+    }
+
     if (port->tx_queue != NULL) {
         uint8_t b;
         if (queue_pop_from_isr(port->tx_queue, &b) == 0) {
@@ -299,5 +477,6 @@ int uart_core_tx_callback(uart_port_t port, uint8_t *byte) {
 void uart_core_rx_error_callback(uart_port_t port) {
     if (port) {
         port->rx_errors++;
+        PERF_INC(perf_uart_rx_error);
     }
 }
@@ -7,7 +7,7 @@ int watchdog_init(uint32_t timeout_ms) {
     int res = watchdog_hal_init(timeout_ms);
 #if LOG_ENABLE
     if (res != 0) {
-        logger_log("watchdog_init failed (timeout_ms=%u)", (uintptr_t)timeout_ms, 0);
+        LOG_ERR(DRIVER, "watchdog_init failed (timeout_ms=%u)", (uintptr_t)timeout_ms, 0);
     }
 #endif
     return res;
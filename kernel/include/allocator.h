@@ -3,6 +3,11 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include "irq_ceiling.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 typedef struct heap_stats {
     size_t total_size;
@@ -83,5 +88,8 @@ int allocator_get_stats(heap_stats_t *stats);
  */
 int allocator_check_integrity(void);
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,122 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+#include "project_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Boot timeline and init levels.
+ *
+ * boot_mark() closes a boot stage and records the cycle counter, so the
+ * 'boot' command can show where the time between reset and a running
+ * system went. On target the counter is started at the top of
+ * Reset_Handler, so the first stage includes crt0.
+ *
+ * Subsystems register init functions with BOOT_INIT(). The entries are
+ * collected by the linker into the "boot_inits" section. BOOT_LEVEL_EARLY
+ * runs from main() before the scheduler starts. BOOT_LEVEL_DEFERRED runs in
+ * a low-weight boot task after the application tasks have had the CPU, so
+ * work that no first task depends on (logging, diagnostics, CLI commands)
+ * is off the path to the first task. Within a level, entries run in link
+ * order; split dependent work across levels or into one function.
+ */
+
+#define BOOT_SECTION        "boot_inits"
+
+typedef enum {
+    BOOT_LEVEL_EARLY = 0,   /* main(), before scheduler_start() */
+    BOOT_LEVEL_DEFERRED,    /* Boot task, after the first application task */
+    BOOT_LEVEL_COUNT
+} boot_level_t;
+
+typedef struct boot_init {
+    const char *name;       /* Function name, shown as the stage name */
+    int (*fn)(void);        /* Returns 0 on success */
+    uint32_t level;         /* boot_level_t */
+} boot_init_t;
+
+typedef struct boot_stage {
+    const char *name;       /* Stage that ended at this mark */
+    uint32_t cycles;        /* Counter value at the mark */
+    uint32_t elapsed;       /* Cycles since the previous mark */
+    uint32_t hz;            /* Core clock during the stage (0 = counter is in ns) */
+    int32_t result;         /* Init return value; 0 for plain marks */
+} boot_stage_t;
+
+/* Register an init function at file scope */
+#define BOOT_INIT(func, lvl)                                                    \
+    static const boot_init_t _boot_init_##func                                  \
+    __attribute__((section(BOOT_SECTION), used, aligned(sizeof(void *)))) =     \
+    { #func, (func), (lvl) }
+
+/**
+ * @brief Clear the timeline and start timing from now.
+ * Target startup code needs no call: the counter and the table both start
+ * at zero. The host calls this from platform_init().
+ */
+void boot_reset(void);
+
+/**
+ * @brief Close the current stage.
+ * @param name Static string naming the stage that just finished.
+ * Marks past BOOT_MAX_STAGES are counted in boot_dropped() and not stored.
+ */
+void boot_mark(const char *name);
+
+/**
+ * @brief Run every init registered at a level, timing each as a stage.
+ * Mark the end of the preceding work first, or it is billed to the first init.
+ * @return Number of inits that returned non-zero.
+ */
+int boot_run_level(boot_level_t level);
+
+/**
+ * @brief Create the boot task that runs BOOT_LEVEL_DEFERRED.
+ * Call after creating the application tasks and before scheduler_start().
+ * The task yields once, then runs boot_run_deferred() and exits.
+ * @return Task ID, or -1 on failure.
+ */
+int32_t boot_defer(void);
+
+/**
+ * @brief Mark "until deferred", then run BOOT_LEVEL_DEFERRED.
+ * Called by the boot task; call it inline on ports without task switching
+ * and with BOOT_DEFER_ENABLE 0.
+ */
+void boot_run_deferred(void);
+
+/**
+ * @brief Get the number of stored stages.
+ */
+uint32_t boot_stage_count(void);
+
+/**
+ * @brief Get a stage by index (0 .. boot_stage_count() - 1).
+ * @return Stage, or NULL if out of range.
+ */
+const boot_stage_t *boot_get_stage(uint32_t index);
+
+/**
+ * @brief Get the number of marks that did not fit the table.
+ */
+uint32_t boot_dropped(void);
+
+/**
+ * @brief Convert a stage's cycles to microseconds at the stage's clock.
+ */
+uint32_t boot_stage_us(const boot_stage_t *stage);
+
+/**
+ * @brief Register the 'boot' CLI command.
+ */
+void boot_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_H */
@@ -2,6 +2,7 @@
 #define CLI_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include "queue.h"
 
 #ifdef __cplusplus
@@ -15,9 +16,28 @@ typedef enum {
     CLI_ERR_NOCMD       = -2,
     CLI_ERR_TOOLONG     = -3,
     CLI_ERR_BAD_ARGS    = -4,
-    CLI_ERR_BUSY        = -5
+    CLI_ERR_BUSY        = -5,
+    CLI_ERR_CRC         = -6
 } cli_status_t;
 
+/*
+ * Binary RPC frames share the console UART with the text CLI:
+ *
+ *   0xA5 (CLI_RPC_SOF) | COBS(body) | 0x00
+ *
+ * All integers are little endian. A body is its length, the payload and a CRC-32:
+ *
+ *   body     = len:u16 | payload[len] | crc32(len, payload):u32
+ *   request  = seq:u8 | cmd_id:u32 | argc:u8 | { arg_len:u8, arg bytes }*
+ *   response = seq:u8 | status:i8 | ret:i32 | output bytes
+ *
+ * cmd_id is cli_command_id(name). The ID 0 (CLI_RPC_LIST_ID) lists the
+ * registered names, one per line. 'status' is a cli_status_t, 'ret' the
+ * handler's return value and the output is what it printed.
+ */
+#define CLI_RPC_SOF         0xA5U
+#define CLI_RPC_LIST_ID     0U
+
 /* Callback for command handlers 
  * argc: argument count (includes command name)
  * argv: array of string pointers (argv[0] is command name)
@@ -31,6 +51,9 @@ typedef int (*cli_cmd_fn_t)(int argc, char **argv);
 typedef int (*cli_getc_fn_t)(char *out_ch); 
 typedef int (*cli_puts_fn_t)(const char *s); 
 
+/* Optional binary-safe output callback: writes len bytes, which may include zeros */
+typedef int (*cli_write_fn_t)(const char *data, size_t len);
+
 /* Command definition structure */
 typedef struct {
     const char     *name;    /* Command name (no spaces allowed) */
@@ -52,11 +75,19 @@ int32_t cli_init(const char *prompt, cli_getc_fn_t getc, cli_puts_fn_t puts);
 /**
  * @brief Register a command with the CLI.
  * @param cmd Pointer to the command structure (must persist in memory)
- * @return CLI_OK on success, CLI_ERR if table full
+ * @return CLI_OK on success, CLI_ERR if the table is full or the name's ID is already registered
  */
 int32_t cli_register_command(const cli_command_t *cmd);
 
 
+/**
+ * @brief Get the RPC command ID of a name (FNV-1a hash).
+ * @param name Command name string
+ * @return Command ID
+ */
+uint32_t cli_command_id(const char *name);
+
+
 /**
  * @brief Unregister a command by name.
  * @param name Command name string
@@ -74,11 +105,28 @@ void cli_task_entry(void *arg);
 
 /**
  * @brief printf-style wrapper for CLI output.
- * Formats string and sends it via the registered 'puts' function.
+ * Formats straight into the CLI TX stream (CLI_TX_BUFFER_SIZE bytes), which is
+ * drained into the TX queue or the 'puts' callback. Blocks only while the
+ * stream is full. Supports %d %u %x with 'l'/'ll' lengths, %s %c %p %%.
+ * @return Number of characters written.
  */
 uint32_t cli_printf(const char *fmt, ...);
 
 
+/**
+ * @brief Push all buffered CLI output to the TX queue or 'puts' callback.
+ * Blocks while the TX queue is full. Call before a reset so output is not lost.
+ */
+void cli_flush(void);
+
+
+/**
+ * @brief Set a binary-safe output callback, used instead of 'puts' when no TX queue is set.
+ * @param write Write callback, or NULL to use 'puts'
+ */
+void cli_set_write_fn(cli_write_fn_t write);
+
+
 /**
  * @brief Set the input queue for the CLI.
  * @param q Pointer to the queue
@@ -0,0 +1,137 @@
+#ifndef DVFS_H
+#define DVFS_H
+
+#include <stdint.h>
+#include "project_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run-time clock scaling: driver notifiers and a load governor.
+ *
+ * dvfs_set_hz() moves the core to another operating point of the
+ * system_clock table. Drivers whose dividers depend on the clock register
+ * a notifier. Each is asked first (DVFS_PRE_CHANGE) and may refuse, for
+ * example while a transfer is in flight. If none refuses, the clock is
+ * switched and each is told the new rate (DVFS_POST_CHANGE) to reprogram
+ * its prescaler. If one refuses, those already asked get DVFS_ABORT_CHANGE.
+ * The whole sequence runs with kernel interrupts masked, so no transfer
+ * can start between the question and the switch. Notifiers must therefore
+ * be short, must not block and must not call back into this module.
+ *
+ * The governor samples the scheduler's idle time every DVFS_SAMPLE_TICKS.
+ * At DVFS_UP_PCT busy or more it goes straight to the top clock. Below
+ * that it picks the lowest clock at which the same work would keep the
+ * CPU at most DVFS_TARGET_PCT busy: it steps up at once, and down only
+ * after DVFS_DOWN_SAMPLES samples in a row asked for less.
+ */
+
+#define DVFS_OK                 0
+#define DVFS_ERR_UNSUPPORTED    -1  /* Not an operating point */
+#define DVFS_ERR_VETO           -2  /* A notifier refused the change */
+#define DVFS_ERR_CLOCK          -3  /* Clock switch failed (see dvfs_get_hz()) */
+#define DVFS_ERR_FULL           -4  /* All DVFS_MAX_NOTIFIERS slots in use */
+#define DVFS_ERR_PARAM          -5  /* NULL callback or not registered */
+
+typedef enum {
+    DVFS_PRE_CHANGE = 0,    /* About to change: return non-zero to refuse */
+    DVFS_POST_CHANGE,       /* Changed: reprogram for new_hz */
+    DVFS_ABORT_CHANGE       /* A PRE_CHANGE that returned 0 will not happen */
+} dvfs_event_t;
+
+/**
+ * @brief Clock change callback.
+ * @param event  What is happening.
+ * @param old_hz Clock before the change.
+ * @param new_hz Clock after the change.
+ * @param arg    Pointer given at registration.
+ * @return For DVFS_PRE_CHANGE, 0 to allow and non-zero to refuse.
+ *         Ignored for the other events.
+ */
+typedef int (*dvfs_notify_fn_t)(dvfs_event_t event, uint32_t old_hz, uint32_t new_hz, void *arg);
+
+typedef struct dvfs_stats {
+    uint32_t transitions;   /* Completed switches */
+    uint32_t vetoes;        /* Switches refused by a notifier */
+    uint32_t failures;      /* Clock sequencer errors */
+    uint32_t samples;       /* Governor samples taken */
+    uint8_t  last_busy_pct; /* Load in the latest sample */
+} dvfs_stats_t;
+
+/**
+ * @brief Register a clock change notifier.
+ * The (fn, arg) pair identifies the registration, so one callback can
+ * serve several driver instances.
+ * @return DVFS_OK (also if already registered), DVFS_ERR_PARAM or DVFS_ERR_FULL.
+ */
+int dvfs_notifier_register(dvfs_notify_fn_t fn, void *arg);
+
+/**
+ * @brief Remove a notifier registered with the same (fn, arg).
+ * @return DVFS_OK or DVFS_ERR_PARAM if it was not registered.
+ */
+int dvfs_notifier_unregister(dvfs_notify_fn_t fn, void *arg);
+
+/**
+ * @brief Switch the core clock, with the notifier handshake.
+ * @param hz Frequency of an operating point.
+ * @return DVFS_OK or DVFS_ERR_*. After DVFS_ERR_CLOCK the core may run at
+ *         a third frequency; notifiers have then been told that one.
+ */
+int dvfs_set_hz(uint32_t hz);
+
+/**
+ * @brief Get the current core clock in Hz.
+ */
+uint32_t dvfs_get_hz(void);
+
+/**
+ * @brief Pick an operating point for a load, without hysteresis.
+ * @param cur_hz    Clock the load was measured at.
+ * @param busy_pct  Non-idle share of the sample period (0..100).
+ * @return Frequency of the chosen operating point.
+ */
+uint32_t dvfs_governor_select(uint32_t cur_hz, uint32_t busy_pct);
+
+/**
+ * @brief Take one load sample and switch if the governor decides to.
+ * Called by the governor timer; exposed for tests.
+ */
+void dvfs_governor_sample(void);
+
+/**
+ * @brief Let the governor change the clock, or hold the current one.
+ * Samples are still taken while disabled.
+ */
+void dvfs_governor_enable(uint8_t enable);
+
+/**
+ * @brief Check whether the governor may change the clock.
+ */
+uint8_t dvfs_governor_enabled(void);
+
+/**
+ * @brief Get switch and governor counters.
+ */
+void dvfs_get_stats(dvfs_stats_t *stats);
+
+/**
+ * @brief Drop all notifiers, zero the counters and restart load sampling.
+ * The governor is left disabled. For tests.
+ */
+void dvfs_reset(void);
+
+/**
+ * @brief Register the 'dvfs' CLI command and, with DVFS_ENABLE, start the
+ * governor. The timer service must be initialized first.
+ * @return 0 on success, -1 if the governor timer could not be started.
+ */
+int dvfs_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DVFS_H */
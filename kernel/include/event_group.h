@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include "scheduler.h"
 #include "spinlock.h"
+#include "kobj.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -13,17 +14,52 @@ extern "C" {
 #define EVENT_WAIT_ALL      0x01  /* Wait for all specified bits */
 #define EVENT_CLEAR_ON_EXIT 0x02  /* Clear bits after waking */
 
-/* Opaque handle to an event group */
+/* Handle to an event group */
 typedef struct event_group event_group_t;
 
+/*
+ * Control block. Public only so it can be allocated statically
+ * (EVENT_GROUP_DEFINE, event_group_init_static); the fields are private to event_group.c.
+ */
+struct event_group {
+    wait_node_t     *wait_head;     /* Tasks waiting for events */
+    wait_node_t     *wait_tail;
+    uint32_t        bits;           /* Current event bits */
+    spinlock_t      lock;
+    uint8_t         is_static;      /* Caller owns the memory; event_group_delete() frees nothing */
+};
+
+/* Descriptor left in the "kobj_events" section by EVENT_GROUP_DEFINE() */
+typedef struct event_group_static {
+    const char *name;
+    event_group_t *group;
+} event_group_static_t;
+
+/**
+ * @brief Define an event group with static storage, initialised by kobj_init_static().
+ * Declares "event_group_t *const name".
+ */
+#define EVENT_GROUP_DEFINE(name)                                                \
+    static event_group_t _event_group_cb_##name KOBJ_STORAGE(sizeof(void *));   \
+    static const event_group_static_t _event_group_def_##name                   \
+        KOBJ_ENTRY("kobj_events") = { #name, &_event_group_cb_##name };         \
+    event_group_t *const name = &_event_group_cb_##name
+
 /**
  * @brief Create a new event group.
  * @return Pointer to the event group handle, or NULL on failure.
  */
 event_group_t* event_group_create(void);
 
+/**
+ * @brief Initialise an event group in caller-provided memory.
+ * @param eg Control block, e.g. a static event_group_t.
+ */
+void event_group_init_static(event_group_t *eg);
+
 /**
  * @brief Delete an event group and free resources.
+ * Waiters are woken; a static group's memory stays with its owner.
  * @param eg Pointer to the event group structure.
  */
 void event_group_delete(event_group_t *eg);
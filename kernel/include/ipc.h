@@ -0,0 +1,72 @@
+#ifndef IPC_H
+#define IPC_H
+
+#include <stdint.h>
+#include "project_config.h"
+#include "scheduler.h"
+#include "irq_ceiling.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Short fixed-size message, copied word by word straight between the two tasks */
+typedef struct {
+    uint32_t w[IPC_MSG_WORDS];
+} ipc_msg_t;
+
+/**
+ * @brief Initialize the IPC subsystem.
+ */
+void ipc_init(void);
+
+/**
+ * @brief Send a request to a server task and wait for its reply.
+ *
+ * If the server is already waiting in ipc_receive(), the message is copied
+ * into its receive buffer and the CPU is handed to it directly, skipping the
+ * ready heap. The server runs on the caller's vruntime and at least the
+ * caller's weight until it replies. Otherwise the caller queues on the
+ * server in FIFO order.
+ *
+ * @param server Task to call.
+ * @param msg Request, read until the server picks it up.
+ * @param reply Receives the reply.
+ * @return 0 on success, -1 if the arguments are invalid or the server does not exist.
+ */
+int ipc_call(task_t *server, const ipc_msg_t *msg, ipc_msg_t *reply);
+
+/**
+ * @brief Wait for the next request.
+ * @param msg Receives the request.
+ * @return The calling task, to be passed to ipc_reply(). NULL on invalid arguments.
+ */
+task_t *ipc_receive(ipc_msg_t *msg);
+
+/**
+ * @brief Reply to a caller and keep running.
+ * Drops any weight the caller lent to this task.
+ * @param caller Task returned by ipc_receive().
+ * @param reply Reply to copy into the caller's buffer.
+ * @return 0 on success, -1 if @p caller is not waiting for a reply from this task.
+ */
+int ipc_reply(task_t *caller, const ipc_msg_t *reply);
+
+/**
+ * @brief Reply to a caller and wait for the next request in one step.
+ *
+ * The usual server loop. If no other caller is queued, the CPU is handed
+ * straight back to @p caller.
+ *
+ * @param caller Task returned by the previous receive, or NULL to only wait.
+ * @param reply Reply to copy into the caller's buffer (ignored if @p caller is NULL).
+ * @param msg Receives the next request.
+ * @return The next calling task. NULL on invalid arguments.
+ */
+task_t *ipc_reply_wait(task_t *caller, const ipc_msg_t *reply, ipc_msg_t *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IPC_H */
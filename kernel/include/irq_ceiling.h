@@ -0,0 +1,15 @@
+/*
+ * Guard against kernel calls from zero-latency interrupts.
+ *
+ * ISRs above MAX_SYSCALL_PRIORITY are never masked by spin_lock(), so a
+ * kernel call from one can corrupt the structure a task is updating. Put
+ * such ISRs in their own source file and define ZERO_LATENCY_ISR_SOURCE
+ * before any include: every kernel header that takes kernel locks includes
+ * this file and then fails the build. Register the handler's priority with
+ * IRQ_PRIORITY_ZERO_LATENCY() from platform_config.h.
+ *
+ * No include guard, so the check runs for every including header.
+ */
+#if defined(ZERO_LATENCY_ISR_SOURCE)
+#error "Kernel API used in a zero-latency ISR source (priority above MAX_SYSCALL_PRIORITY)"
+#endif
@@ -0,0 +1,105 @@
+#ifndef IRQPROF_H
+#define IRQPROF_H
+
+#include <stdint.h>
+#include "project_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if IRQPROF_ENABLE
+
+/**
+ * @brief Interrupt latency profiler (instrumentation builds only).
+ *
+ * With IRQPROF_ENABLE, every spin_lock() call site gets a static record in
+ * the "irqprof_sites" section. The time from the outermost spin_lock() to
+ * the matching spin_unlock() (interrupts masked) is measured with
+ * platform_get_cycles() and charged to the site that took the lock. ISRs
+ * wrapped in IRQPROF_ISR_ENTER/EXIT get their execution time recorded the
+ * same way, and the SysTick handler records how long after the tick it
+ * started running.
+ *
+ * Each record keeps a count, total, maximum and a log2 histogram of
+ * durations in cycles (nanoseconds on the native build).
+ */
+
+#define IRQPROF_SECTION     "irqprof_sites"
+
+typedef enum {
+    IRQPROF_KIND_LOCK = 0,  /* Interrupts masked by spin_lock() */
+    IRQPROF_KIND_ISR,       /* ISR execution time */
+    IRQPROF_KIND_LATENCY    /* Tick to handler entry */
+} irqprof_kind_t;
+
+/* Histogram bucket 0 is below 2^IRQPROF_HIST_SHIFT cycles, each next one doubles */
+#define IRQPROF_HIST_SHIFT  7U
+
+typedef struct irqprof_site {
+    const char *name;       /* Function name, or ISR name */
+    const char *file;
+    uint32_t line;
+    uint32_t kind;          /* irqprof_kind_t */
+    uint32_t count;
+    uint32_t max;
+    uint64_t total;
+    uint32_t hist[IRQPROF_HIST_BUCKETS];
+} irqprof_site_t;
+
+/* Define a static record for the current source location */
+#define IRQPROF_SITE(var, name_str, kind)                                   \
+    static irqprof_site_t var                                               \
+    __attribute__((section(IRQPROF_SECTION), used, aligned(sizeof(void *)))) = \
+    { (name_str), __FILE__, __LINE__, (kind), 0, 0, 0, { 0 } }
+
+/* Time an ISR body. Place ENTER first in the handler and EXIT last */
+#define IRQPROF_ISR_ENTER(name_str)                                         \
+    IRQPROF_SITE(_irqprof_isr, name_str, IRQPROF_KIND_ISR);                 \
+    uint32_t _irqprof_start = irqprof_isr_enter()
+#define IRQPROF_ISR_EXIT()      irqprof_isr_exit(&_irqprof_isr, _irqprof_start)
+
+/* Record the delay between the tick event and its handler, in cycles */
+#define IRQPROF_TICK_LATENCY(cycles)    irqprof_tick_latency(cycles)
+
+/**
+ * @brief Register the 'irqprof' CLI command.
+ */
+void irqprof_init(void);
+
+/**
+ * @brief Clear all records.
+ */
+void irqprof_reset(void);
+
+/**
+ * @brief Get the number of records linked into the image.
+ */
+uint32_t irqprof_count(void);
+
+/**
+ * @brief Get a record by index (0 .. irqprof_count() - 1).
+ * @return Record, or NULL if out of range.
+ */
+const irqprof_site_t *irqprof_get(uint32_t index);
+
+/* Hooks used by spin_lock()/spin_unlock() and the macros above */
+void irqprof_lock_enter(irqprof_site_t *site);
+void irqprof_lock_exit(void);
+uint32_t irqprof_isr_enter(void);
+void irqprof_isr_exit(irqprof_site_t *site, uint32_t start);
+void irqprof_tick_latency(uint32_t cycles);
+
+#else
+/* Compile out profiling if disabled */
+#define IRQPROF_ISR_ENTER(name_str)     do { } while (0)
+#define IRQPROF_ISR_EXIT()              do { } while (0)
+#define IRQPROF_TICK_LATENCY(cycles)    do { } while (0)
+#define irqprof_init()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQPROF_H */
@@ -0,0 +1,57 @@
+#ifndef KOBJ_H
+#define KOBJ_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Statically defined kernel objects.
+ *
+ * TASK_DEFINE(), QUEUE_DEFINE(), MEMPOOL_DEFINE(), EVENT_GROUP_DEFINE() and
+ * TIMER_DEFINE() (in the object's own header) reserve the control block and
+ * its buffer or stack at link time, in ".bss.kobj", and add a descriptor to
+ * a per-type "kobj_*" section. kobj_init_static() walks those sections at
+ * boot: it initialises every object in place and starts every task, with no
+ * allocator calls. The RAM they use is therefore in the link map, and
+ * 'kobj' lists it.
+ *
+ * Each macro declares a global handle of the object's usual pointer type,
+ * so a defined queue is used exactly like one from queue_create(). Other
+ * files reach it with "extern queue_t *const name;".
+ */
+
+/* Storage attribute for control blocks, buffers and stacks */
+#define KOBJ_STORAGE(align) \
+    __attribute__((section(".bss.kobj"), aligned(align)))
+
+/* Descriptor attribute for the per-type registry sections */
+#define KOBJ_ENTRY(section_name) \
+    __attribute__((section(section_name), used, aligned(sizeof(void *))))
+
+/**
+ * @brief Initialise all defined objects and start all defined tasks.
+ * Call once, after scheduler_init() and before scheduler_start(). Pools,
+ * queues, event groups and timers are set up before any task is created.
+ * @return Number of objects that failed to initialise or start.
+ */
+int kobj_init_static(void);
+
+/**
+ * @brief Get the bytes of RAM reserved by the defined objects.
+ */
+size_t kobj_static_bytes(void);
+
+/**
+ * @brief Register the 'kobj' CLI command.
+ */
+void kobj_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KOBJ_H */
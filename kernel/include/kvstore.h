@@ -0,0 +1,132 @@
+#ifndef KVSTORE_H
+#define KVSTORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Log-structured key/value store over a range of flash pages.
+ *
+ * Every update appends a CRC-protected record to the active page; nothing is
+ * overwritten in place. A RAM hash index maps each key to its latest record.
+ * Full pages are compacted oldest-first into fresh pages, which also moves
+ * cold data and keeps erase counts even across the range. An update is
+ * visible after reboot only once its record is completely programmed, so a
+ * power cut at any point leaves either the old or the new value.
+ */
+typedef struct kvstore kvstore_t;
+
+/* Return codes */
+typedef enum kvstore_status {
+    KV_OK               = 0,
+    KV_ERR_INVALID      = -1,   /* Bad argument or store not usable */
+    KV_ERR_NOT_FOUND    = -2,   /* Key does not exist */
+    KV_ERR_NO_SPACE     = -3,   /* Flash range or RAM index is full */
+    KV_ERR_TOO_LARGE    = -4,   /* Key or value exceeds configured limits */
+    KV_ERR_FLASH        = -5,   /* Flash program/erase failed */
+} kvstore_status_t;
+
+typedef struct kvstore_stats {
+    uint32_t keys;              /* Live keys in the index */
+    uint32_t pages_total;       /* Pages managed by the store */
+    uint32_t pages_free;        /* Erased pages ready for use */
+    uint32_t live_bytes;        /* Bytes held by current records */
+    uint32_t used_bytes;        /* Bytes consumed in active pages (incl. headers) */
+    uint32_t erase_min;         /* Lowest page erase count */
+    uint32_t erase_max;         /* Highest page erase count */
+    uint32_t gc_runs;           /* Pages compacted since mount */
+    uint32_t writes_skipped;    /* Sets elided because the value was unchanged */
+} kvstore_stats_t;
+
+/**
+ * @brief Create a store over a page range and mount it.
+ * Existing contents are recovered; interrupted compactions are completed and
+ * torn pages are erased.
+ *
+ * @param base_addr Page-aligned flash address of the first page.
+ * @param page_count Number of consecutive pages (at least 2).
+ * @return Store handle, or NULL on failure.
+ */
+kvstore_t *kvstore_create(uint32_t base_addr, uint32_t page_count);
+
+/**
+ * @brief Release the RAM state of a store. Flash contents are untouched.
+ * @param kv Store handle.
+ */
+void kvstore_destroy(kvstore_t *kv);
+
+/**
+ * @brief Insert or update a key.
+ * Writing the value already stored is a no-op and costs no flash wear.
+ *
+ * @param kv Store handle.
+ * @param key Null-terminated key (1..KVSTORE_KEY_MAX_LEN bytes).
+ * @param value Value bytes (may be NULL if len is 0).
+ * @param len Value length (0..KVSTORE_VALUE_MAX_LEN).
+ * @return KV_OK or a negative kvstore_status_t.
+ */
+int kvstore_set(kvstore_t *kv, const char *key, const void *value, size_t len);
+
+/**
+ * @brief Read a key.
+ * At most buf_len bytes are copied; the full value length is returned so a
+ * short buffer can be detected.
+ *
+ * @param kv Store handle.
+ * @param key Null-terminated key.
+ * @param buf Destination buffer (may be NULL if buf_len is 0).
+ * @param buf_len Size of the destination buffer.
+ * @return Value length on success, or a negative kvstore_status_t.
+ */
+int kvstore_get(kvstore_t *kv, const char *key, void *buf, size_t buf_len);
+
+/**
+ * @brief Delete a key by appending a tombstone.
+ * @param kv Store handle.
+ * @param key Null-terminated key.
+ * @return KV_OK, KV_ERR_NOT_FOUND, or another negative kvstore_status_t.
+ */
+int kvstore_delete(kvstore_t *kv, const char *key);
+
+/**
+ * @brief Erase every page and drop all keys.
+ * @param kv Store handle.
+ * @return KV_OK or KV_ERR_FLASH.
+ */
+int kvstore_format(kvstore_t *kv);
+
+/**
+ * @brief Perform one unit of background compaction.
+ * Compacts the oldest page when the number of free pages is low, so that
+ * foreground writes rarely have to wait for an erase.
+ *
+ * @param kv Store handle.
+ * @return 1 if a page was compacted, 0 if nothing to do, negative on error.
+ */
+int kvstore_gc_step(kvstore_t *kv);
+
+/**
+ * @brief Start a low-weight task that calls kvstore_gc_step() every
+ *        KVSTORE_GC_PERIOD_TICKS.
+ * @param kv Store handle.
+ * @return Task ID on success, -1 on failure.
+ */
+int32_t kvstore_start_gc_task(kvstore_t *kv);
+
+/**
+ * @brief Retrieve usage and wear statistics.
+ * @param kv Store handle.
+ * @param stats Output structure.
+ * @return 0 on success, -1 on error.
+ */
+int kvstore_get_stats(kvstore_t *kv, kvstore_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KVSTORE_H */
@@ -0,0 +1,192 @@
+#ifndef LOGBIN_H
+#define LOGBIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "project_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if LOGBIN_ENABLE
+
+/**
+ * @brief Deferred binary logging.
+ *
+ * LOGBIN("fmt", args...) never formats on target. The format string is
+ * placed in the non-loaded "logbin_fmt" ELF section and the call site only
+ * records its offset (the ID), a timestamp, a compile-time type signature
+ * and the raw argument values into a lock-free per-CPU ring. A low-priority
+ * drain encodes records into COBS frames for a binary sink (usually a UART);
+ * tools/logbin_decode.py rebuilds the text from the ELF.
+ *
+ * Supported arguments (up to LOGBIN_MAX_ARGS): integers up to 64 bits,
+ * float/double, strings (char *, copied up to LOGBIN_STR_MAX bytes at log
+ * time) and void pointers. Cast other pointer types to (void *).
+ */
+
+#define LOGBIN_MAX_ARGS     8
+#define LOGBIN_SECTION      "logbin_fmt"
+
+/* Argument type tags, 3 bits each in the signature */
+typedef enum {
+    LOGBIN_T_U32 = 0,
+    LOGBIN_T_I32,
+    LOGBIN_T_U64,
+    LOGBIN_T_I64,
+    LOGBIN_T_F64,
+    LOGBIN_T_STR
+} logbin_type_t;
+
+typedef struct logbin_stats {
+    uint32_t records;       /* Records written to the rings */
+    uint32_t dropped;       /* Records lost because a ring was full */
+    uint32_t frames;        /* Frames handed to a sink */
+    uint32_t bytes_out;     /* Encoded bytes handed to a sink */
+} logbin_stats_t;
+
+/**
+ * @brief Binary output sink.
+ * @return 0 on success, non-zero to stop the current drain.
+ */
+typedef int (*logbin_sink_fn_t)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Reset the rings and register the logbin CLI command.
+ */
+void logbin_init(void);
+
+/**
+ * @brief Append a record to the current CPU's ring (use LOGBIN instead).
+ * Lock-free and safe from any context, including nested ISRs.
+ * @param id Format string offset in the logbin_fmt section.
+ * @param sig Argument count (bits 0-3) and type tags (3 bits each from bit 4).
+ * @param vals Argument values, widened to 64 bits.
+ */
+void logbin_write(uint32_t id, uint32_t sig, const uint64_t *vals);
+
+/**
+ * @brief Encode all committed records and pass them to a sink.
+ * Each frame is COBS encoded and terminated by a 0x00 byte. Drops since
+ * the last drain are reported in a control frame after the records.
+ * @param sink Output sink.
+ * @param ctx Sink context.
+ * @return Number of bytes emitted, or -1 on error.
+ */
+int32_t logbin_drain(logbin_sink_fn_t sink, void *ctx);
+
+/**
+ * @brief Start a low-priority task that drains every LOGBIN_DRAIN_PERIOD_TICKS.
+ * @param sink Output sink.
+ * @param ctx Sink context.
+ * @return Task ID, or -1 on error.
+ */
+int32_t logbin_start_task(logbin_sink_fn_t sink, void *ctx);
+
+/**
+ * @brief Sink writing to a UART port.
+ * @param ctx uart_port_t handle.
+ */
+int logbin_uart_sink(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Retrieve logging statistics.
+ * @param stats Output structure.
+ */
+void logbin_get_stats(logbin_stats_t *stats);
+
+/* --- Call-site machinery ------------------------------------------------- */
+
+#ifdef HOST_PLATFORM
+/* Host linkers allocate the section and define its start symbol */
+extern const char __start_logbin_fmt[];
+#define LOGBIN_FMT_BASE     ((uintptr_t)__start_logbin_fmt)
+#else
+/* The target linker script places the section at address 0 (INFO) */
+#define LOGBIN_FMT_BASE     ((uintptr_t)0)
+#endif
+
+#define LOGBIN_ID(fmt_sym)  ((uint32_t)((uintptr_t)(fmt_sym) - LOGBIN_FMT_BASE))
+
+static inline uint64_t _logbin_u(uint64_t v) { return v; }
+static inline uint64_t _logbin_s(const char *s) { return (uint64_t)(uintptr_t)s; }
+static inline uint64_t _logbin_p(const void *p) { return (uint64_t)(uintptr_t)p; }
+static inline uint64_t _logbin_f(double d) {
+    union { double d; uint64_t u; } v;
+    v.d = d;
+    return v.u;
+}
+
+#define _LB_TAG(x) _Generic((x),                                            \
+    _Bool: LOGBIN_T_U32, char: LOGBIN_T_I32,                                \
+    signed char: LOGBIN_T_I32, unsigned char: LOGBIN_T_U32,                 \
+    short: LOGBIN_T_I32, unsigned short: LOGBIN_T_U32,                      \
+    int: LOGBIN_T_I32, unsigned int: LOGBIN_T_U32,                          \
+    long: (sizeof(long) > 4 ? LOGBIN_T_I64 : LOGBIN_T_I32),                 \
+    unsigned long: (sizeof(long) > 4 ? LOGBIN_T_U64 : LOGBIN_T_U32),        \
+    long long: LOGBIN_T_I64, unsigned long long: LOGBIN_T_U64,              \
+    float: LOGBIN_T_F64, double: LOGBIN_T_F64,                              \
+    char *: LOGBIN_T_STR, const char *: LOGBIN_T_STR,                       \
+    default: (sizeof(x) > 4 ? LOGBIN_T_U64 : LOGBIN_T_U32))
+
+#define _LB_VAL(x) _Generic((x),                                            \
+    float: _logbin_f, double: _logbin_f,                                    \
+    char *: _logbin_s, const char *: _logbin_s,                             \
+    void *: _logbin_p, const void *: _logbin_p,                             \
+    default: _logbin_u)(x)
+
+#define _LB_T(x, i)         ((uint32_t)_LB_TAG(x) << (4 + 3 * (i)))
+
+#define _LB_NARGS(...)      _LB_NARGS_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _LB_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+#define _LB_SIG0()                      0U
+#define _LB_SIG1(a)                     _LB_T(a, 0)
+#define _LB_SIG2(a, b)                  _LB_SIG1(a) | _LB_T(b, 1)
+#define _LB_SIG3(a, b, c)               _LB_SIG2(a, b) | _LB_T(c, 2)
+#define _LB_SIG4(a, b, c, d)            _LB_SIG3(a, b, c) | _LB_T(d, 3)
+#define _LB_SIG5(a, b, c, d, e)         _LB_SIG4(a, b, c, d) | _LB_T(e, 4)
+#define _LB_SIG6(a, b, c, d, e, f)      _LB_SIG5(a, b, c, d, e) | _LB_T(f, 5)
+#define _LB_SIG7(a, b, c, d, e, f, g)   _LB_SIG6(a, b, c, d, e, f) | _LB_T(g, 6)
+#define _LB_SIG8(a, b, c, d, e, f, g, h) _LB_SIG7(a, b, c, d, e, f, g) | _LB_T(h, 7)
+
+#define _LB_VALS0()                     0U
+#define _LB_VALS1(a)                    _LB_VAL(a)
+#define _LB_VALS2(a, b)                 _LB_VALS1(a), _LB_VAL(b)
+#define _LB_VALS3(a, b, c)              _LB_VALS2(a, b), _LB_VAL(c)
+#define _LB_VALS4(a, b, c, d)           _LB_VALS3(a, b, c), _LB_VAL(d)
+#define _LB_VALS5(a, b, c, d, e)        _LB_VALS4(a, b, c, d), _LB_VAL(e)
+#define _LB_VALS6(a, b, c, d, e, f)     _LB_VALS5(a, b, c, d, e), _LB_VAL(f)
+#define _LB_VALS7(a, b, c, d, e, f, g)  _LB_VALS6(a, b, c, d, e, f), _LB_VAL(g)
+#define _LB_VALS8(a, b, c, d, e, f, g, h) _LB_VALS7(a, b, c, d, e, f, g), _LB_VAL(h)
+
+#define _LB_CAT(a, b)       _LB_CAT_(a, b)
+#define _LB_CAT_(a, b)      a##b
+
+/**
+ * @brief Log a message in deferred binary form.
+ * The format must be a string literal. Arguments are captured by value.
+ */
+#define LOGBIN(fmt, ...) do {                                               \
+    static const char _lb_fmt[]                                             \
+        __attribute__((section(LOGBIN_SECTION), used)) = fmt;               \
+    const uint64_t _lb_vals[] = {                                           \
+        _LB_CAT(_LB_VALS, _LB_NARGS(__VA_ARGS__))(__VA_ARGS__) };           \
+    logbin_write(LOGBIN_ID(_lb_fmt),                                        \
+                 (uint32_t)_LB_NARGS(__VA_ARGS__) |                         \
+                 (_LB_CAT(_LB_SIG, _LB_NARGS(__VA_ARGS__))(__VA_ARGS__)),   \
+                 _lb_vals);                                                 \
+} while (0)
+
+#else
+/* Compile out binary logging if disabled */
+#define logbin_init()
+#define LOGBIN(fmt, ...) do { } while (0)
+#endif /* LOGBIN_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOGBIN_H */
@@ -3,17 +3,39 @@
 
 #include <stdint.h>
 #include "project_config.h"
-#include "queue.h"
+#include "irq_ceiling.h"
+
+/* Log levels (lower is more severe) */
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
 
 #if LOG_ENABLE
 
+/* Log modules; each has a compile-time ceiling LOG_LEVEL_<name> in project_config.h */
+typedef enum {
+    LOG_MOD_KERNEL = 0,
+    LOG_MOD_MEM,
+    LOG_MOD_STORAGE,
+    LOG_MOD_DRIVER,
+    LOG_MOD_APP,
+    LOG_MOD_COUNT
+} log_module_t;
+
 typedef struct {
     uint32_t timestamp;
+    uint8_t module;  /* log_module_t */
+    uint8_t level;   /* LOG_LEVEL_* */
     const char *fmt; /* Format string pointer (not string itself)*/
     uintptr_t arg1; /* argument to be inserted in string */
     uintptr_t arg2; /* argument to be inserted in string */
 } log_entry_t;
 
+/* Runtime level per module, changed with logger_set_level() or 'log level' */
+extern volatile uint8_t log_module_level[LOG_MOD_COUNT];
+
 /**
  * @brief Initialize the logger system and background task.
  */
@@ -22,17 +44,81 @@ void logger_init(void);
 /**
  * @brief Log a message (Deferred).
  * This function is fast, non-blocking, and safe to call from ISRs.
+ * Logged as LOG_MOD_APP at LOG_LEVEL_INFO without level filtering.
  */
 void logger_log(const char *fmt, uintptr_t arg1, uintptr_t arg2);
 
 /**
- * @brief Get the logger queue for debugging.
+ * @brief Log a message with module and level (use the LOG_ERR..LOG_DBG macros).
+ * Lock-free and safe from tasks and ISRs; never disables interrupts.
+ * When the ring is full the entry is dropped and counted.
+ */
+void logger_write(uint8_t module, uint8_t level, const char *fmt, uintptr_t arg1, uintptr_t arg2);
+
+/**
+ * @brief Remove the oldest entry from the log ring (single consumer).
+ * Used by the logger task; exposed for tests and custom consumers.
+ * @param out Output entry.
+ * @return 0 on success, -1 if the ring is empty.
+ */
+int logger_pop(log_entry_t *out);
+
+/**
+ * @brief Get the number of entries dropped because the ring was full.
+ */
+uint32_t logger_get_dropped(void);
+
+/**
+ * @brief Set the runtime level of a module.
+ * Levels above the module's compile-time ceiling stay compiled out.
+ * @return 0 on success, -1 on invalid arguments.
  */
-queue_t* logger_get_queue(void);
+int logger_set_level(uint8_t module, uint8_t level);
+
+/**
+ * @brief Measure the average cost of one logger_write() in CPU cycles.
+ * Fills the ring in batches (drained outside the timed region) so every
+ * timed call takes the successful path.
+ * @param batches Number of ring-sized batches to time.
+ * @param irq_locked 1 to run with interrupts masked, as an ISR would.
+ * @return Average cycles per call.
+ */
+uint32_t logger_bench(uint32_t batches, uint8_t irq_locked);
+
+#if LOG_STORE_ENABLE
+struct logstore;
+
+/**
+ * @brief Mirror processed log entries into a flash log store.
+ * Entries are appended by the logger task; pass NULL to detach.
+ */
+void logger_attach_store(struct logstore *store);
+#endif
+
+/*
+ * Leveled logging. 'mod' is a module name without prefix (KERNEL, MEM,
+ * STORAGE, DRIVER, APP). Calls above LOG_LEVEL_<mod> compile to nothing;
+ * calls above the module's runtime level cost one load and compare.
+ */
+#define LOG_AT(mod, lvl, fmt, a1, a2) do {                                  \
+    if ((lvl) <= LOG_LEVEL_##mod && (lvl) <= log_module_level[LOG_MOD_##mod]) { \
+        logger_write(LOG_MOD_##mod, (lvl), (fmt), (uintptr_t)(a1), (uintptr_t)(a2)); \
+    }                                                                       \
+} while (0)
+
+#define LOG_ERR(mod, fmt, a1, a2)   LOG_AT(mod, LOG_LEVEL_ERROR, fmt, a1, a2)
+#define LOG_WRN(mod, fmt, a1, a2)   LOG_AT(mod, LOG_LEVEL_WARN, fmt, a1, a2)
+#define LOG_INF(mod, fmt, a1, a2)   LOG_AT(mod, LOG_LEVEL_INFO, fmt, a1, a2)
+#define LOG_DBG(mod, fmt, a1, a2)   LOG_AT(mod, LOG_LEVEL_DEBUG, fmt, a1, a2)
 
 #else
 /* Compile out logging if disabled */
 #define logger_init()
+#define LOG_AT(mod, lvl, fmt, a1, a2)   do { } while (0)
+#define LOG_ERR(mod, fmt, a1, a2)       do { } while (0)
+#define LOG_WRN(mod, fmt, a1, a2)       do { } while (0)
+#define LOG_INF(mod, fmt, a1, a2)       do { } while (0)
+#define LOG_DBG(mod, fmt, a1, a2)       do { } while (0)
 #endif
 
-#endif /* LOGGER_H */
\ No newline at end of file
+#endif /* LOGGER_H */
@@ -0,0 +1,120 @@
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "logger.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if LOG_ENABLE
+
+/**
+ * @brief Persistent binary log sink on a ring of flash pages.
+ *
+ * Entries are compressed into CRC-protected frames: timestamps are stored
+ * as zig-zag deltas, arguments as varints and each format string is written
+ * once per page and referenced by a small ID afterwards. Each mount starts
+ * a new page tagged with an incrementing boot number; when the ring is full
+ * the oldest page is erased.
+ */
+typedef struct logstore logstore_t;
+
+typedef struct logstore_stats {
+    uint32_t entries_written;   /* Entries committed to flash */
+    uint32_t entries_dropped;   /* Entries lost to flash errors */
+    uint32_t frames_written;    /* Flash program operations */
+    uint32_t bytes_raw;         /* sizeof(log_entry_t) x entries committed */
+    uint32_t bytes_stored;      /* Flash bytes consumed by committed frames */
+    uint32_t pages_erased;      /* Pages recycled by the ring */
+    uint16_t boot;              /* Boot number of the current session */
+} logstore_stats_t;
+
+/**
+ * @brief Decoded entry callback.
+ * @param boot Boot number the entry was recorded in.
+ * @param entry Decoded entry; fmt points to a temporary copy of the format string.
+ * @param ctx User context.
+ */
+typedef void (*logstore_entry_fn_t)(uint16_t boot, const log_entry_t *entry, void *ctx);
+
+/**
+ * @brief Raw export sink.
+ * @return 0 to continue, non-zero to abort the export.
+ */
+typedef int (*logstore_write_fn_t)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Create a log store over a page range and mount it.
+ * @param base_addr Page-aligned flash address of the first page.
+ * @param page_count Number of consecutive pages (at least 2).
+ * @return Store handle, or NULL on failure.
+ */
+logstore_t *logstore_create(uint32_t base_addr, uint32_t page_count);
+
+/**
+ * @brief Release the RAM state of a store. Unflushed entries are lost.
+ * @param ls Store handle.
+ */
+void logstore_destroy(logstore_t *ls);
+
+/**
+ * @brief Compress an entry into the pending frame.
+ * Programs the previous frame when the new entry does not fit.
+ * @param ls Store handle.
+ * @param entry Entry to append (fmt must stay valid until flushed).
+ * @return 0 on success, -1 if the entry was dropped.
+ */
+int logstore_append(logstore_t *ls, const log_entry_t *entry);
+
+/**
+ * @brief Program the pending frame to flash.
+ * @param ls Store handle.
+ * @return 0 on success (or nothing pending), -1 on flash error.
+ */
+int logstore_flush(logstore_t *ls);
+
+/**
+ * @brief Decode all stored entries, oldest first.
+ * @param ls Store handle.
+ * @param fn Callback invoked per entry.
+ * @param ctx User context.
+ * @return Number of entries decoded, or -1 on error.
+ */
+int logstore_read(logstore_t *ls, logstore_entry_fn_t fn, void *ctx);
+
+/**
+ * @brief Stream the raw compressed log, oldest page first.
+ * Emits each valid page header followed by its valid frames, exactly as
+ * stored, so a host tool can decode it offline.
+ * @param ls Store handle.
+ * @param write Sink receiving the bytes.
+ * @param ctx Sink context.
+ * @return Number of bytes exported, or -1 on error/abort.
+ */
+int32_t logstore_export(logstore_t *ls, logstore_write_fn_t write, void *ctx);
+
+/**
+ * @brief Erase all pages. The current boot number is kept.
+ * @param ls Store handle.
+ * @return 0 on success, -1 on flash error.
+ */
+int logstore_erase(logstore_t *ls);
+
+/**
+ * @brief Retrieve store statistics.
+ * @param ls Store handle.
+ * @param stats Output structure.
+ * @return 0 on success, -1 on error.
+ */
+int logstore_get_stats(logstore_t *ls, logstore_stats_t *stats);
+
+#endif /* LOG_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOGSTORE_H */
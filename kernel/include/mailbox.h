@@ -0,0 +1,81 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "irq_ceiling.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mailbox mailbox_t;
+
+/**
+ * @brief Create a latest-value mailbox.
+ *
+ * A mailbox holds one value. Each write replaces it and starts a new
+ * generation; readers always get the newest complete value.
+ *
+ * @param size Size of the value in bytes.
+ * @return Pointer to the mailbox, or NULL on failure.
+ */
+mailbox_t* mailbox_create(size_t size);
+
+/**
+ * @brief Delete a mailbox.
+ * @warning No task may be blocked in mailbox_wait() on it.
+ * @param mb Pointer to the mailbox.
+ */
+void mailbox_delete(mailbox_t *mb);
+
+/**
+ * @brief Replace the value and wake every waiting reader.
+ *
+ * Never blocks. Safe from ISRs at or below the kernel IRQ ceiling.
+ *
+ * @param mb Pointer to the mailbox.
+ * @param data New value (size given at creation).
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int mailbox_write(mailbox_t *mb, const void *data);
+
+/**
+ * @brief Copy out the current value without locking.
+ *
+ * Retries if a write happened during the copy, so the value is never torn.
+ * Safe from tasks and from ISRs at or below the kernel IRQ ceiling.
+ *
+ * @param mb Pointer to the mailbox.
+ * @param buf Buffer for the value (size given at creation).
+ * @return Generation of the value read, or 0 if nothing was written yet
+ *         (@p buf is then left untouched).
+ */
+uint32_t mailbox_read(mailbox_t *mb, void *buf);
+
+/**
+ * @brief Block until the generation differs from @p last_gen, then read.
+ *
+ * Returns at once if a newer value is already there. Pass 0 to wait for the
+ * first value, or the result of the previous call to wait for the next one.
+ * Values written in between are skipped. Task context only.
+ *
+ * @param mb Pointer to the mailbox.
+ * @param buf Buffer for the value.
+ * @param last_gen Generation the caller has already seen.
+ * @return Generation of the value read, or 0 on invalid arguments.
+ */
+uint32_t mailbox_wait(mailbox_t *mb, void *buf, uint32_t last_gen);
+
+/**
+ * @brief Get the current generation without reading the value.
+ * @param mb Pointer to the mailbox.
+ * @return Number of completed writes, 0 if none.
+ */
+uint32_t mailbox_generation(mailbox_t *mb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAILBOX_H */
@@ -3,6 +3,9 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include "irq_ceiling.h"
+#include "spinlock.h"
+#include "kobj.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -10,6 +13,45 @@ extern "C" {
 
 typedef struct mempool mempool_t;
 
+/* Bytes one item takes in the pool: room for the free-list link, pointer-aligned */
+#define MEMPOOL_ITEM_SIZE(item_size)                                            \
+    ((((item_size) < sizeof(void *) ? sizeof(void *) : (item_size)) + sizeof(void *) - 1) \
+     & ~(sizeof(void *) - 1))
+
+/*
+ * Control block. Public only so it can be allocated statically
+ * (MEMPOOL_DEFINE, mempool_init_static); the fields are private to mempool.c.
+ */
+struct mempool {
+    void        *buffer;        /* Contiguous memory block */
+    size_t      item_size;      /* Size of one item (aligned) */
+    size_t      count;          /* Total capacity */
+    void        *free_list;     /* Head of the free list */
+    spinlock_t  lock;
+    uint8_t     is_static;      /* Caller owns the memory; mempool_delete() frees nothing */
+};
+
+/* Descriptor left in the "kobj_pools" section by MEMPOOL_DEFINE() */
+typedef struct mempool_static {
+    const char *name;
+    mempool_t *pool;
+    void *buffer;
+    size_t item_size;
+    size_t count;
+} mempool_static_t;
+
+/**
+ * @brief Define a pool with static storage, initialised by kobj_init_static().
+ * Declares "mempool_t *const name".
+ */
+#define MEMPOOL_DEFINE(name, item_sz, cnt)                                      \
+    static mempool_t _mempool_cb_##name KOBJ_STORAGE(sizeof(void *));           \
+    static uint8_t _mempool_buf_##name[MEMPOOL_ITEM_SIZE(item_sz) * (cnt)]      \
+        KOBJ_STORAGE(sizeof(void *));                                           \
+    static const mempool_static_t _mempool_def_##name KOBJ_ENTRY("kobj_pools") = \
+        { #name, &_mempool_cb_##name, _mempool_buf_##name, (item_sz), (cnt) };  \
+    mempool_t *const name = &_mempool_cb_##name
+
 /**
  * @brief Create a fixed-size memory pool.
  * 
@@ -19,6 +61,17 @@ typedef struct mempool mempool_t;
  */
 mempool_t* mempool_create(size_t item_size, size_t count);
 
+/**
+ * @brief Initialise a pool in caller-provided memory.
+ *
+ * @param pool Control block, e.g. a static mempool_t.
+ * @param buffer Pointer-aligned storage of MEMPOOL_ITEM_SIZE(item_size) * count bytes.
+ * @param item_size Size of each item in bytes.
+ * @param count Number of items in the pool.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int mempool_init_static(mempool_t *pool, void *buffer, size_t item_size, size_t count);
+
 /**
  * @brief Allocate an item from the pool.
  * 
@@ -37,6 +90,7 @@ void mempool_free(mempool_t *pool, void *ptr);
 
 /**
  * @brief Delete the pool and free all resources.
+ * A static pool is left untouched.
  * @param pool Pointer to the memory pool.
  */
 void mempool_delete(mempool_t *pool);
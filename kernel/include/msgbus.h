@@ -0,0 +1,145 @@
+#ifndef MSGBUS_H
+#define MSGBUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "irq_ceiling.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct msgbus msgbus_t;
+typedef struct msgbus_sub msgbus_sub_t;
+
+/* Topic IDs are 0..31; subscribers filter with a mask of them */
+#define MSGBUS_MAX_TOPICS       32U
+#define MSGBUS_TOPIC(id)        (1UL << (id))
+#define MSGBUS_TOPIC_ALL        0xFFFFFFFFUL
+
+/* What a publisher does when a subscriber's ring is full */
+typedef enum {
+    MSGBUS_DROP_OLDEST = 0,     /* Evict the oldest queued message */
+    MSGBUS_BLOCK                /* Block the publisher until there is room */
+} msgbus_policy_t;
+
+/**
+ * @brief Create a message bus.
+ *
+ * Messages come from a fixed pool. Each one carries a reference count and
+ * goes back to the pool when the last subscriber releases it.
+ *
+ * @param msg_size Payload size of one message in bytes.
+ * @param msg_count Number of messages in the pool.
+ * @return Pointer to the bus, or NULL on failure.
+ */
+msgbus_t* msgbus_create(size_t msg_size, size_t msg_count);
+
+/**
+ * @brief Delete a bus and its message pool.
+ * @warning All subscribers must have unsubscribed and all messages must be released.
+ * @param bus Pointer to the bus.
+ */
+void msgbus_delete(msgbus_t *bus);
+
+/**
+ * @brief Subscribe to a set of topics.
+ *
+ * @param bus Pointer to the bus.
+ * @param topic_mask Topics to receive, built with MSGBUS_TOPIC() or MSGBUS_TOPIC_ALL.
+ * @param depth Number of message references the subscriber's ring can hold.
+ * @param policy Backpressure policy when the ring is full.
+ * @return Pointer to the subscription, or NULL on failure.
+ */
+msgbus_sub_t* msgbus_subscribe(msgbus_t *bus, uint32_t topic_mask, size_t depth, msgbus_policy_t policy);
+
+/**
+ * @brief Remove a subscription and release the messages still queued on it.
+ *
+ * Publishers blocked on the subscription retry without it.
+ * @warning No task may be blocked in msgbus_receive() on the subscription.
+ * @param sub Pointer to the subscription.
+ */
+void msgbus_unsubscribe(msgbus_sub_t *sub);
+
+/**
+ * @brief Allocate a message to fill in and publish.
+ * Safe from ISRs.
+ * @param bus Pointer to the bus.
+ * @return Pointer to the payload, or NULL if the pool is empty.
+ */
+void* msgbus_alloc(msgbus_t *bus);
+
+/**
+ * @brief Publish a message to every subscriber of its topic (Blocking).
+ *
+ * Each matching subscriber gets a reference to the same message; the payload
+ * is never copied. The caller's reference from msgbus_alloc() is consumed,
+ * so a message with no subscribers goes straight back to the pool.
+ *
+ * If a MSGBUS_BLOCK subscriber is full, the publisher blocks until it has room.
+ * Delivery is all-or-nothing: no subscriber sees the message until every
+ * blocking subscriber can take it.
+ *
+ * @param bus Pointer to the bus.
+ * @param topic Topic ID (0..31).
+ * @param msg Payload returned by msgbus_alloc().
+ * @return Number of subscribers that received the message, -1 on error.
+ */
+int msgbus_publish(msgbus_t *bus, uint8_t topic, void *msg);
+
+/**
+ * @brief Publish a message from an Interrupt Service Routine (Non-Blocking).
+ *
+ * Like msgbus_publish(), but a full MSGBUS_BLOCK subscriber misses the
+ * message instead of blocking. The miss is counted as a drop.
+ *
+ * @param bus Pointer to the bus.
+ * @param topic Topic ID (0..31).
+ * @param msg Payload returned by msgbus_alloc().
+ * @return Number of subscribers that received the message, -1 on error.
+ */
+int msgbus_publish_from_isr(msgbus_t *bus, uint8_t topic, void *msg);
+
+/**
+ * @brief Take the next message from a subscription (Blocking).
+ * The caller owns one reference and must pass it to msgbus_release().
+ * @param sub Pointer to the subscription.
+ * @return Pointer to the payload, or NULL on error.
+ */
+void* msgbus_receive(msgbus_sub_t *sub);
+
+/**
+ * @brief Take the next message from a subscription (Non-Blocking).
+ * Safe from ISRs.
+ * @param sub Pointer to the subscription.
+ * @return Pointer to the payload, or NULL if the ring is empty.
+ */
+void* msgbus_try_receive(msgbus_sub_t *sub);
+
+/**
+ * @brief Drop a reference to a message.
+ * The message returns to the pool when the last reference is dropped. Safe from ISRs.
+ * @param msg Payload returned by msgbus_alloc() or a receive call.
+ */
+void msgbus_release(void *msg);
+
+/**
+ * @brief Get the topic a message was published on.
+ * @param msg Payload of a received message.
+ * @return Topic ID.
+ */
+uint8_t msgbus_msg_topic(const void *msg);
+
+/**
+ * @brief Get the number of messages this subscriber lost to backpressure.
+ * @param sub Pointer to the subscription.
+ * @return Messages evicted by MSGBUS_DROP_OLDEST or missed by ISR publishes.
+ */
+uint32_t msgbus_get_dropped(const msgbus_sub_t *sub);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MSGBUS_H */
@@ -6,10 +6,20 @@
 #include "spinlock.h"
 #include "scheduler.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Set in the state word while tasks wait; forces unlock onto the slow path */
+#define SO_MUTEX_WAITERS    ((uintptr_t)1U)
+
 typedef struct {
-    spinlock_t lock;
-    void *owner; /* Task holding the lock */
-    
+    /* Owning task | SO_MUTEX_WAITERS, 0 when free. Changed by CAS on the fast
+     * path; the waiters bit is only set or cleared under the spinlock. */
+    volatile uintptr_t state;
+
+    spinlock_t lock;    /* Guards the wait list (contended path only) */
+
     /* Linked list for waiting tasks */
     wait_node_t *wait_head;
     wait_node_t *wait_tail;
@@ -24,17 +34,32 @@ void so_mutex_init(so_mutex_t *m);
 /**
  * @brief Acquire the lock.
  * 
- * Blocks the current task if the mutex is already locked by another task.
+ * An uncontended lock is a single CAS on the state word. Blocks the current
+ * task if the mutex is already locked by another task.
  * @param m Pointer to the mutex structure.
  */
 void so_mutex_lock(so_mutex_t *m);
 
+/**
+ * @brief Get the task holding the lock.
+ * @param m Pointer to the mutex structure.
+ * @return Owning task, or NULL if the mutex is free.
+ */
+static inline void *so_mutex_get_owner(const so_mutex_t *m) {
+    return (void *)(m->state & ~SO_MUTEX_WAITERS);
+}
+
 /**
  * @brief Release the lock.
  * 
- * Wakes up the next waiting task (if any).
+ * Without waiters this is a single CAS back to 0; otherwise ownership is
+ * handed directly to the next waiting task.
  * @param m Pointer to the mutex structure.
  */
 void so_mutex_unlock(so_mutex_t *m);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* MUTEX_H */
\ No newline at end of file
@@ -0,0 +1,142 @@
+#ifndef PBUF_H
+#define PBUF_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "irq_ceiling.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pbuf_pool pbuf_pool_t;
+
+/*
+ * One fixed-size chunk of a packet. A packet is a chain of chunks linked
+ * through 'next'; only the head's tot_len covers the whole packet. The chunk
+ * data area follows this header, and 'payload' may start past its beginning
+ * (headroom) so that headers can be prepended in place.
+ */
+typedef struct pbuf {
+    struct pbuf *next;          /* Next chunk of the packet, NULL on the last */
+    pbuf_pool_t *pool;          /* Pool the chunk returns to */
+    uint8_t *payload;           /* First valid byte in this chunk */
+    uint16_t len;               /* Valid bytes in this chunk */
+    uint16_t tot_len;           /* Valid bytes in this chunk and the rest of the chain */
+    volatile uint32_t ref;      /* References to this chunk */
+} pbuf_t;
+
+/**
+ * @brief Create a pool of packet buffer chunks.
+ *
+ * @param chunk_size Data bytes per chunk (at most 65535).
+ * @param count Number of chunks in the pool.
+ * @return Pointer to the pool, or NULL on failure.
+ */
+pbuf_pool_t* pbuf_pool_create(size_t chunk_size, size_t count);
+
+/**
+ * @brief Delete a pool. All chunks must have been freed.
+ * @param pool Pointer to the pool.
+ */
+void pbuf_pool_delete(pbuf_pool_t *pool);
+
+/**
+ * @brief Get the data bytes per chunk.
+ * @param pool Pointer to the pool.
+ * @return Chunk size in bytes.
+ */
+size_t pbuf_pool_chunk_size(const pbuf_pool_t *pool);
+
+/**
+ * @brief Allocate a packet of @p len bytes.
+ *
+ * The first chunk keeps @p headroom bytes free in front of the payload for
+ * pbuf_push_header(). Packets longer than one chunk are chained. A length
+ * of 0 returns one empty chunk to fill with pbuf_put_tail(). Safe from ISRs.
+ *
+ * @param pool Pool to allocate from.
+ * @param len Payload length in bytes.
+ * @param headroom Bytes reserved in front of the payload (less than the chunk size).
+ * @return Head of the chain, or NULL if the pool ran out (nothing is kept).
+ */
+pbuf_t* pbuf_alloc(pbuf_pool_t *pool, size_t len, size_t headroom);
+
+/**
+ * @brief Take another reference to a packet.
+ * The packet survives until every holder has called pbuf_free().
+ * @param p Head of the chain.
+ */
+void pbuf_ref(pbuf_t *p);
+
+/**
+ * @brief Drop a reference to a packet.
+ *
+ * Walks the chain, freeing each chunk whose last reference this was, and
+ * stops at the first chunk still referenced elsewhere. Safe from ISRs.
+ *
+ * @param p Head of the chain (NULL is ignored).
+ */
+void pbuf_free(pbuf_t *p);
+
+/**
+ * @brief Prepend a header in the headroom of the first chunk.
+ * @param p Head of the chain.
+ * @param n Header length in bytes.
+ * @return Pointer to the header bytes to fill in, or NULL if the headroom is too small.
+ */
+uint8_t* pbuf_push_header(pbuf_t *p, size_t n);
+
+/**
+ * @brief Strip a header from the front of the first chunk.
+ * @param p Head of the chain.
+ * @param n Bytes to strip (at most the first chunk's length).
+ * @return 0 on success, -1 if the first chunk is shorter than @p n.
+ */
+int pbuf_pull_header(pbuf_t *p, size_t n);
+
+/**
+ * @brief Append @p n contiguous bytes at the end of the packet.
+ *
+ * Uses the free space of the last chunk, or chains a new chunk from the
+ * same pool if it is too small.
+ *
+ * @param p Head of the chain.
+ * @param n Trailer length in bytes (at most the chunk size).
+ * @return Pointer to the trailer bytes to fill in, or NULL if no chunk is available.
+ */
+uint8_t* pbuf_put_tail(pbuf_t *p, size_t n);
+
+/**
+ * @brief Append packet @p tail to the end of packet @p head.
+ * The caller's reference to @p tail passes to @p head.
+ * @param head Packet to extend.
+ * @param tail Packet to append.
+ */
+void pbuf_cat(pbuf_t *head, pbuf_t *tail);
+
+/**
+ * @brief Copy bytes out of a packet, across chunk boundaries.
+ * @param p Head of the chain.
+ * @param dst Destination buffer.
+ * @param len Maximum number of bytes to copy.
+ * @param offset Offset into the packet to start from.
+ * @return Number of bytes copied.
+ */
+size_t pbuf_copy_out(const pbuf_t *p, void *dst, size_t len, size_t offset);
+
+/**
+ * @brief Copy bytes into a packet, across chunk boundaries.
+ * @param p Head of the chain.
+ * @param src Source data.
+ * @param len Number of bytes to copy.
+ * @param offset Offset into the packet to start at.
+ * @return Number of bytes copied (less than @p len if the packet is shorter).
+ */
+size_t pbuf_copy_in(pbuf_t *p, const void *src, size_t len, size_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PBUF_H */
@@ -0,0 +1,121 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdint.h>
+#include "project_config.h"
+#include "arch_ops.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if PERF_ENABLE
+
+/**
+ * @brief Runtime performance counters.
+ *
+ * Subsystems define named counters at file scope with PERF_COUNTER() or
+ * PERF_GAUGE(). The definitions are collected by the linker into the
+ * "perf_counters" section, so there is no registration call and no table
+ * to size. Each counter keeps one slot per CPU; an update touches only the
+ * current CPU's slot and readers sum the slots.
+ *
+ * Counters are monotonic and wrap at 32 bits; differences between two
+ * snapshots are wrap-safe. Gauges hold the last value set.
+ */
+
+#define PERF_SECTION        "perf_counters"
+
+typedef enum {
+    PERF_KIND_COUNTER = 0,  /* Monotonic event count */
+    PERF_KIND_GAUGE         /* Current level, set with PERF_SET */
+} perf_kind_t;
+
+typedef struct perf_counter {
+    const char *name;                   /* "module.event" */
+    uint32_t kind;                      /* perf_kind_t */
+    volatile uint32_t value[MAX_CPUS];  /* Per-CPU slots (gauges use slot 0) */
+} perf_counter_t;
+
+typedef struct perf_snapshot {
+    uint32_t ticks;                     /* platform_get_ticks() at capture */
+    uint32_t count;                     /* Valid entries in value[] */
+    uint32_t value[PERF_MAX_COUNTERS];  /* Indexed like perf_get() */
+} perf_snapshot_t;
+
+/* Define a counter or gauge at file scope */
+#define PERF_COUNTER(var, name_str)                                         \
+    static perf_counter_t var                                               \
+    __attribute__((section(PERF_SECTION), used, aligned(sizeof(void *)))) = \
+    { (name_str), PERF_KIND_COUNTER, { 0 } }
+
+#define PERF_GAUGE(var, name_str)                                           \
+    static perf_counter_t var                                               \
+    __attribute__((section(PERF_SECTION), used, aligned(sizeof(void *)))) = \
+    { (name_str), PERF_KIND_GAUGE, { 0 } }
+
+/* Count events; lock-free and safe from any context */
+#define PERF_ADD(var, n)    ((void)arch_atomic_add(&(var).value[arch_get_cpu_id()], (uint32_t)(n)))
+#define PERF_INC(var)       PERF_ADD(var, 1U)
+
+/* Count one event with interrupts already masked: a single plain increment */
+#define PERF_INC_LOCKED(var) ((void)((var).value[arch_get_cpu_id()]++))
+
+/* Set a gauge */
+#define PERF_SET(var, v)    ((void)((var).value[0] = (uint32_t)(v)))
+
+/**
+ * @brief Register the 'perf' CLI command.
+ */
+void perf_init(void);
+
+/**
+ * @brief Get the number of counters linked into the image.
+ */
+uint32_t perf_count(void);
+
+/**
+ * @brief Get a counter by index (0 .. perf_count() - 1).
+ * @return Counter, or NULL if out of range.
+ */
+const perf_counter_t *perf_get(uint32_t index);
+
+/**
+ * @brief Find a counter by name.
+ * @return Counter, or NULL if not found.
+ */
+const perf_counter_t *perf_find(const char *name);
+
+/**
+ * @brief Read a counter: the sum of its per-CPU slots, or a gauge's value.
+ */
+uint32_t perf_read(const perf_counter_t *c);
+
+/**
+ * @brief Capture the first PERF_MAX_COUNTERS counters and the tick count.
+ */
+void perf_snapshot(perf_snapshot_t *snap);
+
+/**
+ * @brief Compute the change between two snapshots.
+ * Counters become the number of events in between; gauges take the value
+ * from 'after'. delta->ticks is the elapsed time. delta may alias either input.
+ */
+void perf_diff(const perf_snapshot_t *before, const perf_snapshot_t *after, perf_snapshot_t *delta);
+
+#else
+/* Compile out counters if disabled */
+#define PERF_COUNTER(var, name_str)     struct perf_unused_##var
+#define PERF_GAUGE(var, name_str)       struct perf_unused_##var
+#define PERF_ADD(var, n)                ((void)0)
+#define PERF_INC(var)                   ((void)0)
+#define PERF_INC_LOCKED(var)            ((void)0)
+#define PERF_SET(var, v)                ((void)0)
+#define perf_init()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_H */
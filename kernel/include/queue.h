@@ -4,12 +4,107 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "project_config.h"
+#include "irq_ceiling.h"
+#include "scheduler.h"
+#include "spinlock.h"
+#include "kobj.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 typedef struct queue queue_t;
 
 /* Callback function type for queue events */
 typedef void (*queue_notify_cb_t)(void *arg);
 
+/* Priority lanes per queue; lane 0 is the lowest */
+#define QUEUE_MAX_LANES     32U
+
+/* What a push does when the queue is full */
+typedef enum {
+    QUEUE_OVERFLOW_BLOCK = 0,       /* Block the task, or fail from an ISR (default) */
+    QUEUE_OVERFLOW_DROP_OLDEST,     /* Overwrite the oldest item */
+    QUEUE_OVERFLOW_DROP_NEWEST      /* Discard the item being pushed */
+} queue_overflow_t;
+
+/* One priority lane: a ring of 'capacity' items and the senders waiting for room in it */
+typedef struct {
+    uint8_t *ring;                  /* This lane's slice of the buffer */
+    size_t count;                   /* Items in this lane */
+    size_t head;                    /* Read index (where to take next) */
+    size_t tail;                    /* Write index (where to put next) */
+
+    wait_node_t *tx_wait_head;      /* Head of TX wait list */
+    wait_node_t *tx_wait_tail;      /* Tail of TX wait list */
+} queue_lane_t;
+
+/*
+ * Control block. Public only so it can be allocated statically
+ * (QUEUE_DEFINE, queue_init_static); the fields are private to queue.c.
+ */
+struct queue {
+    void *buffer;                   /* Pointer to the allocated data storage */
+    size_t item_size;               /* Size of a single item in bytes */
+    size_t capacity;                /* Maximum number of items per lane */
+    size_t count;                   /* Current number of items in all lanes */
+    
+    /* Wait queues */
+    wait_node_t *rx_wait_head;      /* Head of RX wait list */
+    wait_node_t *rx_wait_tail;      /* Tail of RX wait list */
+
+    /* Notification Callback */
+    queue_notify_cb_t callback;      /* Function to call when data is added */
+    void *callback_arg;              /* Argument for the callback */
+
+    queue_overflow_t overflow;       /* Behaviour of a push into a full queue */
+    uint32_t dropped;                /* Items lost to the overflow policy */
+
+    spinlock_t lock;                 /* Queue-specific lock */
+
+    uint8_t is_static;               /* Caller owns the memory; queue_delete() frees nothing */
+    uint32_t lane_mask;              /* Bit n set while lane n holds items */
+    size_t lanes;                    /* Number of lanes */
+    queue_lane_t *lane;              /* Lane array, lane 0 the lowest; &lane0 with one lane */
+    queue_lane_t lane0;              /* Storage of a one-lane queue */
+};
+
+/* Descriptor left in the "kobj_queues" section by QUEUE_DEFINE() */
+typedef struct queue_static {
+    const char *name;
+    queue_t *queue;
+    void *buffer;
+    queue_lane_t *lane;             /* NULL for one lane */
+    size_t item_size;
+    size_t capacity;
+    size_t lanes;
+} queue_static_t;
+
+/**
+ * @brief Define a queue with static storage, initialised by kobj_init_static().
+ * Declares "queue_t *const name".
+ */
+#define QUEUE_DEFINE(name, item_sz, cap)                                        \
+    static queue_t _queue_cb_##name KOBJ_STORAGE(sizeof(void *));               \
+    static uint8_t _queue_buf_##name[(item_sz) * (cap)]                         \
+        KOBJ_STORAGE(sizeof(void *));                                           \
+    static const queue_static_t _queue_def_##name KOBJ_ENTRY("kobj_queues") =   \
+        { #name, &_queue_cb_##name, _queue_buf_##name, NULL, (item_sz), (cap), 1 }; \
+    queue_t *const name = &_queue_cb_##name
+
+/**
+ * @brief Define a queue with priority lanes and static storage.
+ */
+#define QUEUE_DEFINE_PRIO(name, item_sz, cap, nlanes)                           \
+    static queue_t _queue_cb_##name KOBJ_STORAGE(sizeof(void *));               \
+    static queue_lane_t _queue_lanes_##name[nlanes] KOBJ_STORAGE(sizeof(void *)); \
+    static uint8_t _queue_buf_##name[(item_sz) * (cap) * (nlanes)]              \
+        KOBJ_STORAGE(sizeof(void *));                                           \
+    static const queue_static_t _queue_def_##name KOBJ_ENTRY("kobj_queues") =   \
+        { #name, &_queue_cb_##name, _queue_buf_##name, _queue_lanes_##name,     \
+          (item_sz), (cap), (nlanes) };                                         \
+    queue_t *const name = &_queue_cb_##name
+
 /**
  * @brief Create a new message queue.
  * 
@@ -21,10 +116,54 @@ typedef void (*queue_notify_cb_t)(void *arg);
  */
 queue_t* queue_create(size_t item_size, size_t capacity);
 
+/**
+ * @brief Create a queue with several priority lanes.
+ *
+ * Each lane is its own ring of @p capacity items inside the one queue.
+ * Pops always take from the highest non-empty lane, so an urgent item never
+ * waits behind bulk traffic in a lower lane. A full lane blocks only the
+ * senders to that lane. queue_create() is the one-lane case.
+ *
+ * @param item_size Size of each message item in bytes.
+ * @param capacity Maximum number of items per lane.
+ * @param lanes Number of lanes, 1 to QUEUE_MAX_LANES.
+ * @return Pointer to the created queue, or NULL on failure.
+ */
+queue_t* queue_create_prio(size_t item_size, size_t capacity, size_t lanes);
+
+/**
+ * @brief Initialise a queue in caller-provided memory.
+ *
+ * The heap-free form of queue_create(): nothing is allocated.
+ *
+ * @param q Control block, e.g. a static queue_t (it holds the one lane).
+ * @param buffer Item storage of item_size * capacity bytes.
+ * @param item_size Size of each message item in bytes.
+ * @param capacity Maximum number of items the queue can hold.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int queue_init_static(queue_t *q, void *buffer, size_t item_size, size_t capacity);
+
+/**
+ * @brief Initialise a queue with priority lanes in caller-provided memory.
+ *
+ * @param q Control block, e.g. a static queue_t.
+ * @param lane Lane storage, an array of @p lanes entries. May be NULL for
+ *             one lane, which then lives in @p q.
+ * @param buffer Item storage of item_size * capacity * lanes bytes.
+ * @param item_size Size of each message item in bytes.
+ * @param capacity Maximum number of items per lane.
+ * @param lanes Number of lanes, 1 to QUEUE_MAX_LANES.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int queue_init_static_prio(queue_t *q, queue_lane_t *lane, void *buffer,
+                           size_t item_size, size_t capacity, size_t lanes);
+
 /**
  * @brief Delete a queue and free its resources.
  * 
- * Frees the internal buffer and the queue structure itself.
+ * Frees the internal buffer and the queue structure itself. For a static
+ * queue, only wakes the waiters; the memory stays with its owner.
  * @warning Do not use the queue handle after calling this.
  * 
  * @param q Pointer to the queue to delete.
@@ -43,11 +182,23 @@ void queue_delete(queue_t *q);
  */
 int queue_push(queue_t *q, const void *item);
 
+/**
+ * @brief Push an item into a priority lane (Blocking).
+ *
+ * Like queue_push(), which uses lane 0. Blocks only if lane @p prio is full.
+ *
+ * @param q Pointer to the queue.
+ * @param item Pointer to the data to copy into the queue.
+ * @param prio Lane to push into; higher lanes are popped first.
+ * @return 0 on success, -1 on error (including a lane that does not exist).
+ */
+int queue_push_prio(queue_t *q, const void *item, uint32_t prio);
+
 /**
  * @brief Push multiple items to the queue (Blocking).
  * 
- * Writes 'count' items to the queue. If the queue fills up, it blocks
- * until space is available, then continues writing.
+ * Writes 'count' items to the queue (lane 0). If the queue fills up, it
+ * blocks until space is available, then continues writing.
  * 
  * @param q Pointer to the queue.
  * @param data Pointer to the array of items to write.
@@ -60,7 +211,8 @@ int queue_push_arr(queue_t *q, const void *data, size_t count);
  * @brief Pop an item from the queue (Blocking).
  * 
  * Copies an item from the queue into the provided buffer. If the queue is empty,
- * the calling task blocks until data arrives.
+ * the calling task blocks until data arrives. With several lanes, the item
+ * comes from the highest non-empty lane.
  * 
  * @param q Pointer to the queue.
  * @param buffer Pointer to the memory where the received item will be copied.
@@ -80,6 +232,29 @@ int queue_pop(queue_t *q, void *buffer);
  */
 int queue_push_from_isr(queue_t *q, const void *item);
 
+/**
+ * @brief Push an item into a priority lane from an ISR (Non-Blocking).
+ * @param q Pointer to the queue.
+ * @param item Pointer to the data.
+ * @param prio Lane to push into.
+ * @return 0 on success, -1 if the lane is full or does not exist.
+ */
+int queue_push_prio_from_isr(queue_t *q, const void *item, uint32_t prio);
+
+/**
+ * @brief Push multiple items to the queue without blocking.
+ * 
+ * Copies as many of the 'count' items as fit into lane 0, in one critical
+ * section, and returns immediately. Safe from ISRs.
+ * 
+ * @param q Pointer to the queue.
+ * @param data Pointer to the array of items to write.
+ * @param count Number of items to write.
+ * @return Number of items written (0 if full), -1 on error. With a drop policy,
+ *         the number of items in the queue from this call.
+ */
+int queue_push_arr_from_isr(queue_t *q, const void *data, size_t count);
+
 /**
  * @brief Pop an item from the queue from an Interrupt Service Routine (Non-Blocking).
  * 
@@ -95,7 +270,8 @@ int queue_pop_from_isr(queue_t *q, void *buffer);
 /**
  * @brief Peek at the item at the head of the queue without removing it.
  * 
- * Copies the item at the head of the queue into the provided buffer.
+ * Copies the item at the head of the queue (highest non-empty lane) into
+ * the provided buffer.
  * Does not modify the queue state (count remains the same).
  * 
  * @param q Pointer to the queue.
@@ -123,4 +299,28 @@ void queue_reset(queue_t *q);
  */
 void queue_set_push_callback(queue_t *q, queue_notify_cb_t cb, void *arg);
 
+/**
+ * @brief Choose what a push does when the queue is full.
+ *
+ * With a drop policy no push blocks or fails for lack of space: queue_push()
+ * and queue_push_from_isr() return 0, and queue_push_arr() returns at once.
+ * Lost items are counted by queue_get_dropped(). Drop-oldest overwrites
+ * items still unread; drop-newest keeps them and discards the new ones.
+ *
+ * @param q Pointer to the queue.
+ * @param policy QUEUE_OVERFLOW_BLOCK, QUEUE_OVERFLOW_DROP_OLDEST or QUEUE_OVERFLOW_DROP_NEWEST.
+ */
+void queue_set_overflow_policy(queue_t *q, queue_overflow_t policy);
+
+/**
+ * @brief Get the number of items lost to the overflow policy.
+ * @param q Pointer to the queue.
+ * @return Items overwritten (drop-oldest) or discarded (drop-newest).
+ */
+uint32_t queue_get_dropped(queue_t *q);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* QUEUE_H */
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "project_config.h"
+#include "irq_ceiling.h"
+#include "kobj.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,8 +25,44 @@ typedef struct wait_node {
     struct wait_node *next;
 } wait_node_t;
 
+/* Per-task synchronous IPC state, owned by ipc.c */
+typedef struct ipc_state {
+    const void *send_buf;       /* Caller: message waiting to be picked up */
+    void *recv_buf;             /* Server: receive buffer. Caller: reply buffer */
+    void *partner;              /* Server being called, or caller being served */
+    wait_node_t *send_head;     /* Callers queued on this task */
+    wait_node_t *send_tail;
+    uint8_t state;
+    uint8_t saved_weight;       /* Server: weight before callers lent theirs, 0 if none */
+    uint8_t lent_weight;        /* Server: weight the loan left it at */
+} ipc_state_t;
+
 typedef struct task_struct task_t;
 
+/*
+ * Task left in the "kobj_tasks" section by TASK_DEFINE(). The TCB comes
+ * from the scheduler's static table; kobj_init_static() stores the ID.
+ */
+typedef struct task_static {
+    const char *name;
+    void (*entry)(void *);
+    void *arg;
+    void *stack;
+    size_t stack_size;
+    uint8_t weight;
+    int32_t id;                 /* Task ID once started, -1 before or on failure */
+} task_static_t;
+
+/**
+ * @brief Define a task with a static stack, started by kobj_init_static().
+ * Declares "task_static_t name"; name.id holds the task ID.
+ * The stack is aligned to PLATFORM_STACK_ALIGNMENT (8).
+ */
+#define TASK_DEFINE(name, entry_fn, entry_arg, stack_bytes, task_weight)        \
+    static uint8_t _task_stack_##name[stack_bytes] KOBJ_STORAGE(8);             \
+    task_static_t name KOBJ_ENTRY("kobj_tasks") =                               \
+        { #name, (entry_fn), (entry_arg), _task_stack_##name, (stack_bytes), (task_weight), -1 }
+
 /**
  * @brief Initialize the scheduler internal structures.
  */
@@ -48,6 +86,25 @@ void schedule_next_task(void);
  */
 uint32_t scheduler_tick(void);
 
+/**
+ * @brief Check whether a wake-up on this CPU asked for preemption.
+ * Set when an unblocked task should run before the current one (lower
+ * vruntime, or the CPU is idle). Cleared by the next context switch.
+ * @return 1 if a switch is pending, 0 otherwise.
+ */
+int scheduler_yield_pending(void);
+
+/**
+ * @brief Request a context switch at ISR exit if the ISR woke a task that
+ * should preempt the current one.
+ * Call as the last statement of an ISR that may wake tasks (queue and event
+ * group *_from_isr calls, task_notify(), semaphore give). On Cortex-M this
+ * pends PendSV, which tail-chains the switch right after the ISR returns
+ * instead of waiting for the next tick.
+ * @return 1 if a switch was requested, 0 otherwise.
+ */
+int scheduler_yield_from_isr(void);
+
 /**
  * @brief Create a new task.
  * @param task_func Entry function for the task.
@@ -96,9 +153,22 @@ void task_garbage_collection(void);
 
 /**
  * @brief Check all tasks for stack overflow.
+ *
+ * With STACK_GUARD_ENABLE the running task is skipped: its stack bottom is
+ * under the hardware guard, which catches the overflow as it happens.
  */
 void task_check_stack_overflow(void);
 
+/**
+ * @brief Kill the running task after it hit its stack guard.
+ *
+ * Called by the architecture's fault handler (MemManage on Cortex-M,
+ * SIGSEGV on the host). The task becomes a ZOMBIE; the caller must switch
+ * away without returning to it.
+ * @return 0 if the task was killed, -1 if there is none or it is the idle task.
+ */
+int task_stack_guard_fault(void);
+
 /**
  * @brief Block a specific task (prevent it from being scheduled).
  * @param task Pointer to the task to block.
@@ -108,8 +178,22 @@ void task_block(task_t *task);
 /**
  * @brief Unblock a specific task (make it ready to run).
  * @param task Pointer to the task to unblock.
+ * @return 1 if the task should preempt the task running on its CPU (a switch
+ *         is then pending, see scheduler_yield_from_isr()), 0 otherwise.
+ */
+int task_unblock(task_t *task);
+
+/**
+ * @brief Unblock a task and make it the next task to run on this CPU.
+ * Used when the caller is about to block on the woken task (synchronous IPC):
+ * the woken task is picked by the next switch ahead of the ready heap, and
+ * inherits the caller's vruntime if that is lower, so the caller's share of
+ * the CPU pays for the work done on its behalf. Tasks on another CPU are
+ * unblocked normally.
+ * @param task Pointer to the task to unblock.
+ * @return 1 if the handoff was queued, 0 otherwise.
  */
-void task_unblock(task_t *task);
+int task_unblock_handoff(task_t *task);
 
 /**
  * @brief Block the currently running task.
@@ -140,8 +224,9 @@ uint32_t task_notify_wait(uint8_t clear_on_exit, uint32_t wait_ticks);
  * 
  * @param task_id The ID of the task to notify.
  * @param value The value to OR into the task's notification value.
+ * @return 1 if the woken task should preempt the current one, 0 otherwise.
  */
-void task_notify(uint16_t task_id, uint32_t value);
+int task_notify(uint16_t task_id, uint32_t value);
 
 /**
  * @brief Get the handle of the currently running task.
@@ -162,6 +247,22 @@ void task_set_current(void *task);
  */
 void task_set_state(task_t *t, task_state_t state);
 
+/**
+ * @brief Block a task on a kernel object.
+ * Same as task_set_state(t, TASK_BLOCKED), and also records @p obj for
+ * diagnostics. The record is cleared when the task becomes ready again.
+ * @param t Pointer to the task.
+ * @param obj Queue, mutex, semaphore or event group being waited on.
+ */
+void task_block_on(task_t *t, const void *obj);
+
+/**
+ * @brief Get the object a task is blocked on.
+ * @param t Pointer to the task.
+ * @return Object passed to task_block_on(), or NULL.
+ */
+const void *task_get_wait_object(task_t *t);
+
 /**
  * @brief Retrieve the state of a task atomically.
  * @param t Pointer to the task.
@@ -226,6 +327,13 @@ task_t *scheduler_get_task_by_index(uint32_t index);
  */
 wait_node_t* task_get_wait_node(task_t *task);
 
+/**
+ * @brief Get the embedded IPC state for a task.
+ * @param task Pointer to the task.
+ * @return Pointer to the task's IPC state.
+ */
+ipc_state_t *task_get_ipc_state(task_t *task);
+
 /**
  * @brief Set the notification value for a task.
  * @param t Pointer to the task.
@@ -261,6 +369,16 @@ uint8_t task_get_notify_state(task_t *t);
  */
 uint64_t task_get_cpu_ticks(task_t *t);
 
+/**
+ * @brief Get the ticks the calling CPU has spent in its idle task.
+ * Includes the time since the idle task was last switched in, if it is
+ * running now. Like task_get_cpu_ticks(), time is charged at context
+ * switches in whole ticks, so only differences over many ticks are exact
+ * on average.
+ * @return Idle ticks since the idle task was created, 0 if there is none.
+ */
+uint64_t scheduler_get_idle_ticks(void);
+
 /**
  * @brief Get the base weight of a task.
  * @param t Pointer to the task.
@@ -274,6 +392,13 @@ uint8_t task_get_base_weight(task_t *t);
  */
 void task_restore_base_weight(task_t *t);
 
+/**
+ * @brief Set a task's effective weight, never below its base weight.
+ * @param t Pointer to the task.
+ * @param weight Weight to hand back, e.g. one saved before a temporary boost.
+ */
+void task_set_inherited_weight(task_t *t, uint8_t weight);
+
 /**
  * @brief Temporarily boost a task's weight.
  * @param t Pointer to the task.
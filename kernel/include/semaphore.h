@@ -10,8 +10,15 @@
 extern "C" {
 #endif
 
+/* State word layout: (count << SO_SEM_COUNT_SHIFT) | SO_SEM_WAITERS */
+#define SO_SEM_WAITERS      1U
+#define SO_SEM_COUNT_SHIFT  1U
+#define SO_SEM_COUNT_ONE    (1U << SO_SEM_COUNT_SHIFT)
+
 typedef struct {
-    volatile uint32_t count;    /* Current number of available resources */
+    /* Available resources and the waiters flag. Changed by CAS on the fast
+     * path; the waiters flag is only set or cleared under the spinlock. */
+    volatile uint32_t state;
     uint32_t max_count;         /* Maximum number of resources */
     
     /* Linked list for waiting tasks */
@@ -26,14 +33,24 @@ typedef struct {
  * 
  * @param s Pointer to the semaphore structure.
  * @param initial_count Initial number of available resources.
- * @param max_count Maximum limit for the count (use 1 for binary semaphore).
+ * @param max_count Maximum limit for the count (use 1 for binary semaphore),
+ *                  at most UINT32_MAX >> SO_SEM_COUNT_SHIFT.
  */
 void so_sem_init(so_sem_t *s, uint32_t initial_count, uint32_t max_count);
 
+/**
+ * @brief Get the number of available resources.
+ * @param s Pointer to the semaphore.
+ */
+static inline uint32_t so_sem_get_count(const so_sem_t *s) {
+    return s->state >> SO_SEM_COUNT_SHIFT;
+}
+
 /** 
  * @brief Wait (Take) for a semaphore token.
  * 
- * If the count is > 0, it decrements the count and returns immediately.
+ * If the count is > 0, it decrements the count with a single CAS and returns
+ * immediately.
  * If the count is 0, the calling task is blocked and placed in the wait queue
  * until a token is signaled.
  * 
@@ -44,8 +61,8 @@ void so_sem_wait(so_sem_t *s);
 /** 
  * @brief Signal (Give) a semaphore token.
  * 
- * Increments the semaphore count (up to max_count).
- * If there are tasks waiting, the longest-waiting task is woken up.
+ * Increments the semaphore count (up to max_count), with a single CAS when
+ * nobody waits. If there are tasks waiting, the longest-waiting task is woken up.
  * 
  * @param s Pointer to the semaphore.
  */
@@ -0,0 +1,363 @@
+#ifndef SORTOS_HPP
+#define SORTOS_HPP
+
+/*
+ * Header-only C++ layer over the soRTOS kernel.
+ *
+ * Every object keeps its storage inside itself, so a global or a member
+ * costs no heap. Sizes are template parameters: ring indices are masked
+ * with a constexpr N - 1 and items are copied by assignment, which the
+ * compiler turns into word moves instead of a byte-wise utils_memcpy().
+ * Requires C++11; builds without exceptions or RTTI.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+
+#include "scheduler.h"
+#include "spinlock.h"
+#include "mutex.h"
+#include "platform.h"
+
+namespace so {
+
+namespace detail {
+
+/* Append a node to a wait list. Caller holds the owner's lock. */
+inline void wait_push(wait_node_t *&head, wait_node_t *&tail, wait_node_t *node) {
+    node->next = nullptr;
+    if (tail) {
+        tail->next = node;
+    } else {
+        head = node;
+    }
+    tail = node;
+}
+
+/* Remove and return the first task of a wait list. Caller holds the owner's lock. */
+inline task_t *wait_pop(wait_node_t *&head, wait_node_t *&tail) {
+    wait_node_t *node = head;
+    if (!node) {
+        return nullptr;
+    }
+    head = node->next;
+    if (!head) {
+        tail = nullptr;
+    }
+    return static_cast<task_t *>(node->task);
+}
+
+/* Remove a node if it is still linked, e.g. after a wakeup that did not pop it. */
+inline void wait_remove(wait_node_t *&head, wait_node_t *&tail, wait_node_t *node) {
+    wait_node_t *prev = nullptr;
+    for (wait_node_t *curr = head; curr; prev = curr, curr = curr->next) {
+        if (curr == node) {
+            if (prev) {
+                prev->next = curr->next;
+            } else {
+                head = curr->next;
+            }
+            if (tail == curr) {
+                tail = prev;
+            }
+            return;
+        }
+    }
+}
+
+} /* namespace detail */
+
+/**
+ * @brief Typed FIFO of N items with the blocking semantics of queue_t.
+ *
+ * push() blocks while the queue is full and pop() while it is empty, using
+ * the tasks' embedded wait nodes. try_push() and try_pop() never block and
+ * are ISR-safe. For overflow policies, priority lanes or callbacks, use the
+ * C queue_t.
+ *
+ * @tparam T Item type; must be trivially copyable.
+ * @tparam N Capacity; must be a power of two.
+ */
+template <typename T, size_t N>
+class Queue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "so::Queue capacity must be a power of two");
+    static_assert(N <= 0x80000000UL, "so::Queue capacity must fit the 32-bit indices");
+    static_assert(std::is_trivially_copyable<T>::value, "so::Queue items must be trivially copyable");
+
+public:
+    Queue() { spinlock_init(&lock_); }
+    Queue(const Queue &) = delete;
+    Queue &operator=(const Queue &) = delete;
+
+    /** @brief Maximum number of items. */
+    static constexpr size_t capacity() { return N; }
+
+    /**
+     * @brief Copy an item in, blocking while the queue is full.
+     * @return false if not called from a task.
+     */
+    bool push(const T &item) {
+        task_t *current = static_cast<task_t *>(task_get_current());
+        if (!current) {
+            return false;
+        }
+        wait_node_t *node = task_get_wait_node(current);
+        node->task = current;
+
+        while (true) {
+            uint32_t flags = spin_lock(&lock_);
+            if (tail_ - head_ < N) {
+                put_locked(item);
+                spin_unlock(&lock_, flags);
+                return true;
+            }
+            detail::wait_remove(tx_head_, tx_tail_, node);
+            detail::wait_push(tx_head_, tx_tail_, node);
+            task_block_on(current, this);
+            spin_unlock(&lock_, flags);
+            platform_yield();
+        }
+    }
+
+    /**
+     * @brief Copy an item in if there is room. Safe from ISRs.
+     * @return false if the queue is full.
+     */
+    bool try_push(const T &item) {
+        uint32_t flags = spin_lock(&lock_);
+        bool ok = (tail_ - head_ < N);
+        if (ok) {
+            put_locked(item);
+        }
+        spin_unlock(&lock_, flags);
+        return ok;
+    }
+
+    /**
+     * @brief Copy the oldest item out, blocking while the queue is empty.
+     * @return false if not called from a task.
+     */
+    bool pop(T &out) {
+        task_t *current = static_cast<task_t *>(task_get_current());
+        if (!current) {
+            return false;
+        }
+        wait_node_t *node = task_get_wait_node(current);
+        node->task = current;
+
+        while (true) {
+            uint32_t flags = spin_lock(&lock_);
+            if (tail_ != head_) {
+                take_locked(out);
+                spin_unlock(&lock_, flags);
+                return true;
+            }
+            detail::wait_remove(rx_head_, rx_tail_, node);
+            detail::wait_push(rx_head_, rx_tail_, node);
+            task_block_on(current, this);
+            spin_unlock(&lock_, flags);
+            platform_yield();
+        }
+    }
+
+    /**
+     * @brief Copy the oldest item out if there is one. Safe from ISRs.
+     * @return false if the queue is empty.
+     */
+    bool try_pop(T &out) {
+        uint32_t flags = spin_lock(&lock_);
+        bool ok = (tail_ != head_);
+        if (ok) {
+            take_locked(out);
+        }
+        spin_unlock(&lock_, flags);
+        return ok;
+    }
+
+    /** @brief Items currently queued (a snapshot). */
+    size_t size() const { return tail_ - head_; }
+
+private:
+    static constexpr uint32_t kMask = static_cast<uint32_t>(N - 1);
+
+    void put_locked(const T &item) {
+        ring_[tail_ & kMask] = item;
+        tail_++;
+        task_t *task = detail::wait_pop(rx_head_, rx_tail_);
+        if (task) {
+            task_unblock(task);
+        }
+    }
+
+    void take_locked(T &out) {
+        out = ring_[head_ & kMask];
+        head_++;
+        task_t *task = detail::wait_pop(tx_head_, tx_tail_);
+        if (task) {
+            task_unblock(task);
+        }
+    }
+
+    T ring_[N];
+    uint32_t head_ = 0;             /* Free-running read count */
+    uint32_t tail_ = 0;             /* Free-running write count */
+    wait_node_t *rx_head_ = nullptr;
+    wait_node_t *rx_tail_ = nullptr;
+    wait_node_t *tx_head_ = nullptr;
+    wait_node_t *tx_tail_ = nullptr;
+    spinlock_t lock_;
+};
+
+/**
+ * @brief Fixed pool of N objects of type T, with storage inside the pool.
+ *
+ * create() and destroy() construct and destroy in place; alloc() and free()
+ * hand out raw slots. All four are O(1) and safe from ISRs.
+ */
+template <typename T, size_t N>
+class MemPool {
+    static_assert(N > 0, "so::MemPool needs at least one slot");
+
+public:
+    MemPool() {
+        spinlock_init(&lock_);
+        for (size_t i = 0; i + 1 < N; i++) {
+            slots_[i].next = &slots_[i + 1];
+        }
+        slots_[N - 1].next = nullptr;
+        free_ = &slots_[0];
+    }
+    MemPool(const MemPool &) = delete;
+    MemPool &operator=(const MemPool &) = delete;
+
+    /** @brief Number of slots. */
+    static constexpr size_t capacity() { return N; }
+
+    /** @brief Take a raw slot for a T, or nullptr if none is left. */
+    void *alloc() {
+        uint32_t flags = spin_lock(&lock_);
+        Slot *s = free_;
+        if (s) {
+            free_ = s->next;
+        }
+        spin_unlock(&lock_, flags);
+        return s;
+    }
+
+    /** @brief Return a slot taken with alloc(). */
+    void free(void *p) {
+        if (!p) {
+            return;
+        }
+        Slot *s = static_cast<Slot *>(p);
+        uint32_t flags = spin_lock(&lock_);
+        s->next = free_;
+        free_ = s;
+        spin_unlock(&lock_, flags);
+    }
+
+    /** @brief Allocate and construct a T, or return nullptr if the pool is empty. */
+    template <typename... Args>
+    T *create(Args &&...args) {
+        void *p = alloc();
+        return p ? new (p) T(static_cast<Args &&>(args)...) : nullptr;
+    }
+
+    /** @brief Destroy a T made by create() and return its slot. */
+    void destroy(T *obj) {
+        if (obj) {
+            obj->~T();
+            free(obj);
+        }
+    }
+
+private:
+    union Slot {
+        Slot *next;
+        alignas(T) unsigned char obj[sizeof(T)];
+    };
+
+    Slot slots_[N];
+    Slot *free_;
+    spinlock_t lock_;
+};
+
+/**
+ * @brief so_mutex_t with priority inheritance, initialised on construction.
+ * Lock with LockGuard<Mutex> so every path out of a scope unlocks.
+ */
+class Mutex {
+public:
+    Mutex() { so_mutex_init(&m_); }
+    Mutex(const Mutex &) = delete;
+    Mutex &operator=(const Mutex &) = delete;
+
+    void lock() { so_mutex_lock(&m_); }
+    void unlock() { so_mutex_unlock(&m_); }
+
+    /** @brief The underlying C mutex, for C APIs. */
+    so_mutex_t *native_handle() { return &m_; }
+
+private:
+    so_mutex_t m_;
+};
+
+/**
+ * @brief Holds a lock for the lifetime of the guard.
+ * @tparam Lockable Any type with lock() and unlock(), such as Mutex.
+ */
+template <typename Lockable>
+class LockGuard {
+public:
+    explicit LockGuard(Lockable &l) : l_(l) { l_.lock(); }
+    ~LockGuard() { l_.unlock(); }
+    LockGuard(const LockGuard &) = delete;
+    LockGuard &operator=(const LockGuard &) = delete;
+
+private:
+    Lockable &l_;
+};
+
+/**
+ * @brief A task whose stack is part of the object.
+ *
+ * Wraps task_create_static(), so the object must not live on the kernel
+ * heap. A global or static Task is the usual form.
+ *
+ * @tparam StackSize Stack size in bytes; a multiple of PLATFORM_STACK_ALIGNMENT.
+ */
+template <size_t StackSize>
+class Task {
+    static_assert(StackSize % PLATFORM_STACK_ALIGNMENT == 0, "so::Task stack must be a multiple of the stack alignment");
+    static_assert(StackSize >= STACK_MIN_SIZE_BYTES, "so::Task stack is below STACK_MIN_SIZE_BYTES");
+
+public:
+    Task() = default;
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    /**
+     * @brief Create the task on this object's stack.
+     * @return Task ID, or -1 on failure.
+     */
+    int32_t start(void (*fn)(void *), void *arg = nullptr, uint8_t weight = TASK_WEIGHT_NORMAL) {
+        id_ = task_create_static(fn, arg, stack_, StackSize, weight);
+        return id_;
+    }
+
+    /** @brief Task ID from start(), or -1. */
+    int32_t id() const { return id_; }
+
+    /** @brief Stack size in bytes. */
+    static constexpr size_t stack_size() { return StackSize; }
+
+private:
+    alignas(PLATFORM_STACK_ALIGNMENT) uint8_t stack_[StackSize];
+    int32_t id_ = -1;
+};
+
+} /* namespace so */
+
+#endif /* SORTOS_HPP */
@@ -3,44 +3,146 @@
 
 #include "arch_ops.h"
 #include "project_config.h"
+#include "irqprof.h"
+#include "irq_ceiling.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if SPINLOCK_STATS
+/* Contention record kept in every lock (instrumentation builds only) */
 typedef struct {
-    volatile uint32_t flag;
+    uint32_t acquires;          /* Successful spin_lock() calls */
+    uint32_t contended;         /* Acquisitions that had to wait for a ticket */
+    uint64_t spin_cycles;       /* Total cycles spent waiting */
+    uint32_t max_spin;          /* Longest wait (cycles) */
+    uint32_t max_hold;          /* Longest hold (cycles) */
+    uint32_t hold_start;        /* Cycle count at the current acquisition */
+} spinlock_stats_t;
+#endif
+
+/*
+ * Ticket lock: a taker draws 'next' and waits until 'owner' reaches it, so
+ * CPUs are served in arrival order. Only the holder writes 'owner'.
+ */
+typedef struct spinlock {
+    volatile uint32_t next;     /* Next ticket to hand out */
+    volatile uint32_t owner;    /* Ticket being served */
+#if SPINLOCK_STATS
+    spinlock_stats_t stats;
+#endif
 } spinlock_t;
 
+#if SPINLOCK_STATS
+uint32_t spinlock_stats_now(void);
+void spinlock_stats_acquired(spinlock_t *lock, uint32_t waited);
+void spinlock_stats_released(spinlock_t *lock);
+
+/**
+ * @brief List a lock in the 'locks' report.
+ * Meant for long-lived (static) locks; registering again renames it.
+ * @param lock Lock to report.
+ * @param name Label shown by 'locks' (not copied).
+ * @return 0 on success, -1 if SPINLOCK_STATS_MAX_LOCKS are registered.
+ */
+int spinlock_stats_register(spinlock_t *lock, const char *name);
+
+/**
+ * @brief Clear the counters of every registered lock.
+ */
+void spinlock_stats_reset(void);
+
+/**
+ * @brief Register the 'locks' CLI command.
+ */
+void spinlock_stats_init(void);
+#else
+static inline int spinlock_stats_register(spinlock_t *lock, const char *name) {
+    (void)lock;
+    (void)name;
+    return 0;
+}
+#define spinlock_stats_init()
+#endif
+
 /**
  * @brief Initialize a spinlock.
+ * A zero-filled spinlock_t is also a valid unlocked lock.
  * @param lock Pointer to the spinlock structure.
  */
 static inline void spinlock_init(spinlock_t *lock) {
-    lock->flag = 0;
+    lock->next = 0;
+    lock->owner = 0;
+#if SPINLOCK_STATS
+    lock->stats = (spinlock_stats_t){0};
+#endif
+}
+
+/**
+ * @brief Take a ticket and wait for it (lock word only, no interrupt masking).
+ *
+ * Used by spin_lock() on SMP builds. Safe between any threads that share
+ * the lock, so host tests can drive it from pthreads.
+ *
+ * @param lock Pointer to the spinlock structure.
+ * @return Cycles spent waiting with SPINLOCK_STATS (0 if uncontended),
+ *         otherwise 1 if it had to wait and 0 if not.
+ */
+static inline uint32_t spin_ticket_acquire(spinlock_t *lock) {
+    uint32_t ticket = arch_atomic_add(&lock->next, 1U);
+    uint32_t waited = 0;
+
+    if (lock->owner != ticket) {
+#if SPINLOCK_STATS
+        uint32_t start = spinlock_stats_now();
+#endif
+        while (lock->owner != ticket) {
+            arch_cpu_relax();
+        }
+#if SPINLOCK_STATS
+        waited = spinlock_stats_now() - start;
+#endif
+        waited = waited ? waited : 1U;
+    }
+    arch_memory_barrier();  /* Critical section reads stay after the acquire */
+    return waited;
+}
+
+/**
+ * @brief Serve the next ticket (lock word only).
+ * @param lock Pointer to a spinlock held by the caller.
+ */
+static inline void spin_ticket_release(spinlock_t *lock) {
+    arch_memory_barrier();  /* Critical section writes are visible first */
+    lock->owner = lock->owner + 1U;
 }
 
 /**
  * @brief Acquire a spinlock.
  * 
- * Disables interrupts locally. On SMP systems, it also acquires the 
- * hardware lock, spinning if necessary.
+ * Masks local interrupts up to the kernel ceiling (MAX_SYSCALL_PRIORITY).
+ * Higher-priority interrupts stay enabled and must not use the kernel.
+ * On SMP systems, it also takes a ticket and spins until it is served, so
+ * waiting CPUs get the lock in FIFO order.
  * 
  * @param lock Pointer to the spinlock structure.
  * @return uint32_t Previous interrupt state (to be passed to unlock).
  */
 static inline uint32_t spin_lock(spinlock_t *lock) {
-    /* Always disable local interrupts first */
-    uint32_t flags = arch_irq_lock();
+    /* Always mask kernel-level interrupts first */
+    uint32_t flags = arch_irq_lock_kernel();
     
 #if defined(CONFIG_SMP)
-    /* Atomic spin wait */
-    while (arch_test_and_set(&lock->flag)) {
-        arch_cpu_relax();
-    }
+    uint32_t waited = spin_ticket_acquire(lock);
 #else
-    (void)lock;
+    uint32_t waited = 0;
+#endif
+#if SPINLOCK_STATS
+    spinlock_stats_acquired(lock, waited);
 #endif
+    (void)lock;
+    (void)waited;
     
     return flags;
 }
@@ -48,24 +150,43 @@ static inline uint32_t spin_lock(spinlock_t *lock) {
 /**
  * @brief Release a spinlock.
  * 
- * Releases the hardware lock (on SMP) and restores the interrupt state.
+ * Hands the lock to the next ticket (on SMP) and restores the interrupt state.
  * 
  * @param lock Pointer to the spinlock structure.
  * @param flags Previous interrupt state returned by spin_lock().
  */
 static inline void spin_unlock(spinlock_t *lock, uint32_t flags) {
+#if IRQPROF_ENABLE
+    irqprof_lock_exit();    /* Before the stats hook, so its cycle read is not charged */
+#endif
+#if SPINLOCK_STATS
+    spinlock_stats_released(lock);
+#endif
 #if defined(CONFIG_SMP)
-    /* Release lock with memory barrier */
-    arch_memory_barrier(); 
-    lock->flag = 0;
+    spin_ticket_release(lock);
 #else
     (void)lock;
 #endif
     
     /* Restore interrupts */
-    arch_irq_unlock(flags);
+    arch_irq_unlock_kernel(flags);
 }
 
+#if IRQPROF_ENABLE
+/* Acquire a spinlock and start timing the masked section for this call site */
+static inline uint32_t spin_lock_prof(spinlock_t *lock, irqprof_site_t *site) {
+    uint32_t flags = spin_lock(lock);
+    irqprof_lock_enter(site);
+    return flags;
+}
+
+/* Every spin_lock() call site gets its own record */
+#define spin_lock(lock) __extension__ ({                                    \
+    IRQPROF_SITE(_irqprof_site, __func__, IRQPROF_KIND_LOCK);               \
+    spin_lock_prof((lock), &_irqprof_site);                                 \
+})
+#endif
+
 #ifdef __cplusplus
 }
 #endif
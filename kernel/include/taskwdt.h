@@ -0,0 +1,96 @@
+#ifndef TASKWDT_H
+#define TASKWDT_H
+
+#include <stdint.h>
+#include "project_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if TASKWDT_ENABLE
+
+/**
+ * @brief Task watchdog: per-task liveness feeding the hardware watchdog.
+ *
+ * Tasks register with the longest interval they may go without checking
+ * in. A software timer runs taskwdt_check() every TASKWDT_CHECK_PERIOD_TICKS
+ * and kicks the hardware watchdog only if every registered task checked in
+ * on time. When a task is late, kicking stops for good, and the most
+ * overdue task (its ID, state and the object it is blocked on) is written
+ * to retained RAM. After the reset, taskwdt_init() reads the record back
+ * and taskwdt_last_stall() returns it.
+ */
+
+#define TASKWDT_ERR_PARAM   -1  /* Bad period, ID or no current task */
+#define TASKWDT_ERR_FULL    -2  /* All TASKWDT_MAX_TASKS slots in use */
+
+/* Stall report kept across the watchdog reset */
+typedef struct taskwdt_record {
+    uint32_t magic;
+    uint32_t uptime;        /* Tick count when the stall was detected */
+    uint16_t task_id;       /* Most overdue task */
+    uint8_t  state;         /* Its task_state_t */
+    uint8_t  stalled;       /* Number of tasks overdue at that check */
+    uint32_t period;        /* Its check-in period (ticks) */
+    uint32_t silent;        /* Ticks since its last check-in */
+    uintptr_t wait_obj;     /* Object it was blocked on, 0 if none */
+    uint32_t crc;
+} taskwdt_record_t;
+
+/**
+ * @brief Start the hardware watchdog and the monitor timer.
+ * Reads (and then clears) the stall record left by a previous reset.
+ * The timer service must be initialized first.
+ * @param hw_timeout_ms Hardware watchdog timeout.
+ * @return 0 on success, -1 if the watchdog or timer could not be started.
+ */
+int taskwdt_init(uint32_t hw_timeout_ms);
+
+/**
+ * @brief Register the calling task.
+ * @param period_ticks Longest allowed interval between check-ins.
+ * @return Watchdog ID (>= 0) for taskwdt_checkin(), or TASKWDT_ERR_*.
+ */
+int taskwdt_register(uint32_t period_ticks);
+
+/**
+ * @brief Stop monitoring a task.
+ * Call before deleting a registered task.
+ * @param id ID returned by taskwdt_register().
+ * @return 0 on success, TASKWDT_ERR_PARAM for an unknown ID.
+ */
+int taskwdt_unregister(int id);
+
+/**
+ * @brief Report that the task is alive. Lock-free, safe to call often.
+ * @param id ID returned by taskwdt_register().
+ */
+void taskwdt_checkin(int id);
+
+/**
+ * @brief Verify all check-ins and kick the hardware watchdog if healthy.
+ * Called by the monitor timer; exposed for tests and custom monitors.
+ * @return Number of overdue tasks (0 = healthy, watchdog kicked).
+ */
+uint32_t taskwdt_check(void);
+
+/**
+ * @brief Get the stall that caused the previous reset.
+ * @return Record read by taskwdt_init(), or NULL if the last reset was not
+ *         caused by the task watchdog.
+ */
+const taskwdt_record_t *taskwdt_last_stall(void);
+
+#else
+/* Compile out the task watchdog if disabled */
+#define taskwdt_register(period_ticks)  ((void)(period_ticks), 0)
+#define taskwdt_unregister(id)          ((void)(id), 0)
+#define taskwdt_checkin(id)             ((void)(id))
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASKWDT_H */
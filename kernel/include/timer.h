@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "irq_ceiling.h"
+#include "kobj.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,6 +14,40 @@ typedef void (*timer_callback_t)(void *arg);
 
 typedef struct sw_timer sw_timer_t;
 
+/*
+ * Timer record. Public only so it can be allocated statically
+ * (TIMER_DEFINE, timer_init_static); the fields are private to timer.c.
+ */
+struct sw_timer {
+    struct sw_timer *next; /* For internal linked list */
+    uint32_t expiry_tick;
+    uint32_t period_ticks;
+    const char *name;
+    timer_callback_t callback;
+    void *arg;
+    uint8_t flags;
+};
+
+/* Descriptor left in the "kobj_timers" section by TIMER_DEFINE() */
+typedef struct timer_static {
+    sw_timer_t *timer;
+    const char *name;
+    uint32_t period_ticks;
+    uint8_t auto_reload;
+    timer_callback_t callback;
+    void *arg;
+} timer_static_t;
+
+/**
+ * @brief Define a timer with static storage, initialised (not started) by
+ * kobj_init_static(). Declares "sw_timer_t *const name".
+ */
+#define TIMER_DEFINE(name, period, reload, cb, cb_arg)                          \
+    static sw_timer_t _timer_cb_##name KOBJ_STORAGE(sizeof(void *));            \
+    static const timer_static_t _timer_def_##name KOBJ_ENTRY("kobj_timers") =   \
+        { &_timer_cb_##name, #name, (period), (reload), (cb), (cb_arg) };       \
+    sw_timer_t *const name = &_timer_cb_##name
+
 /**
  * @brief Initialize the software timer subsystem.
  * 
@@ -32,6 +68,15 @@ void timer_service_init(uint32_t max_timers);
  */
 sw_timer_t* timer_create(const char *name, uint32_t period_ticks, uint8_t auto_reload, timer_callback_t callback, void *arg);
 
+/**
+ * @brief Initialise a timer in caller-provided memory.
+ * Needs no timer pool, so it works before timer_service_init(); starting
+ * the timer still needs the service.
+ * @param timer Timer record, e.g. a static sw_timer_t.
+ * @return 0 on success, -1 if timer is NULL.
+ */
+int timer_init_static(sw_timer_t *timer, const char *name, uint32_t period_ticks, uint8_t auto_reload, timer_callback_t callback, void *arg);
+
 /**
  * @brief Start a timer.
  * If already active, it resets the expiry time.
@@ -49,6 +94,7 @@ int timer_stop(sw_timer_t *timer);
 
 /**
  * @brief Delete a timer and free memory.
+ * A static timer is only stopped.
  * @param timer Timer handle.
  */
 void timer_delete(sw_timer_t *timer);
@@ -100,6 +100,53 @@ int utils_strcmp(const char *str1, const char *str2);
  */
 size_t utils_strlen(const char *str);
 
+/**
+ * @brief Compute or continue a CRC-32 (IEEE 802.3, reflected 0xEDB88320).
+ * 
+ * Pass 0 as the initial value; pass a previous result to continue a
+ * checksum across several buffers.
+ * 
+ * @param crc Running CRC value (0 to start).
+ * @param data Pointer to the data.
+ * @param len Number of bytes.
+ * @return Updated CRC value.
+ */
+uint32_t utils_crc32(uint32_t crc, const void *data, size_t len);
+
+/**
+ * @brief 32-bit FNV-1a hash.
+ * 
+ * @param data Pointer to the data.
+ * @param len Number of bytes.
+ * @return Hash value.
+ */
+uint32_t utils_fnv1a(const void *data, size_t len);
+
+/**
+ * @brief COBS-encode a buffer and append the 0x00 frame delimiter.
+ * 
+ * The output contains no zero bytes except the final delimiter.
+ * 'out' must hold len + len / 254 + 2 bytes.
+ * 
+ * @param in Input bytes.
+ * @param len Number of input bytes.
+ * @param out Output buffer.
+ * @return Number of bytes written, including the delimiter.
+ */
+size_t utils_cobs_encode(const uint8_t *in, size_t len, uint8_t *out);
+
+/**
+ * @brief Decode one COBS frame (without its 0x00 delimiter).
+ * 
+ * 'out' may equal 'in' to decode in place.
+ * 
+ * @param in Encoded bytes.
+ * @param len Number of encoded bytes.
+ * @param out Output buffer of at least len bytes.
+ * @return Number of decoded bytes, or -1 if the frame is malformed.
+ */
+int32_t utils_cobs_decode(const uint8_t *in, size_t len, uint8_t *out);
+
 #ifdef __cplusplus
 }
 #endif
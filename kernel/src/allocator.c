@@ -6,6 +6,7 @@
 #include <string.h>
 #include "project_config.h"
 #include "logger.h"
+#include "perf.h"
 
 
 /* Calculate the actual number of Second Level indices */
@@ -274,6 +275,7 @@ static block_header_t* block_locate_free(size_t size) {
 /* Initialize the memory pool and TLSF structures */
 void allocator_init(uint8_t* pool, size_t size) {
     spinlock_init(&allocator_lock);
+    spinlock_stats_register(&allocator_lock, "allocator");
     utils_memset(&control, 0, sizeof(control));
     
     uintptr_t raw_addr = (uintptr_t)pool;
@@ -302,10 +304,15 @@ void allocator_init(uint8_t* pool, size_t size) {
     free_blocks = 1;
     allocated_blocks = 0;
 #if LOG_ENABLE
-    logger_log("Heap Init Size:%u", (uint32_t)size, 0);
+    LOG_INF(MEM, "Heap Init Size:%u", (uint32_t)size, 0);
 #endif
 }
 
+PERF_COUNTER(perf_mem_alloc, "mem.alloc");
+PERF_COUNTER(perf_mem_alloc_fail, "mem.alloc_fail");
+PERF_COUNTER(perf_mem_free, "mem.free");
+PERF_GAUGE(perf_mem_used, "mem.used");
+
 /* Allocate a block of memory of at least size bytes */
 void* allocator_malloc(size_t size) {
     if (size == 0) {
@@ -336,14 +343,17 @@ void* allocator_malloc(size_t size) {
         
         allocated_mem += (GET_SIZE(block) - BLOCK_OVERHEAD);
         allocated_blocks++;
+        PERF_INC_LOCKED(perf_mem_alloc);
+        PERF_SET(perf_mem_used, allocated_mem);
         
         spin_unlock(&allocator_lock, flags);
         return (void*)((uint8_t*)block + BLOCK_OVERHEAD);
     }
     
+    PERF_INC_LOCKED(perf_mem_alloc_fail);
     spin_unlock(&allocator_lock, flags);
 #if LOG_ENABLE
-    logger_log("Malloc Fail Size:%u", (uint32_t)size, 0);
+    LOG_WRN(MEM, "Malloc Fail Size:%u", (uint32_t)size, 0);
 #endif
     return NULL;
 }
@@ -362,6 +372,8 @@ void allocator_free(void* ptr) {
     size_t size = GET_SIZE(block);
     allocated_mem -= (size - BLOCK_OVERHEAD);
     allocated_blocks--;
+    PERF_INC_LOCKED(perf_mem_free);
+    PERF_SET(perf_mem_used, allocated_mem);
     
     /* Add to free stats (will be adjusted if merged) */
     free_mem += (size - BLOCK_OVERHEAD);
@@ -523,7 +535,7 @@ int allocator_check_integrity(void) {
         if ((uintptr_t)curr & (ALIGN_SIZE - 1)) {
             spin_unlock(&allocator_lock, flags);
 #if LOG_ENABLE
-            logger_log("Heap Align Err", 0, 0);
+            LOG_ERR(MEM, "Heap Align Err", 0, 0);
 #endif
             return -2; /* Block Alignment Error */
         }
@@ -532,7 +544,7 @@ int allocator_check_integrity(void) {
         if (curr->size & (ALIGN_SIZE - 1) & ~BLOCK_FREE_BIT) {
             spin_unlock(&allocator_lock, flags);
 #if LOG_ENABLE
-            logger_log("Heap Header Err", 0, 0);
+            LOG_ERR(MEM, "Heap Header Err", 0, 0);
 #endif
             return -2; /* Block Alignment Error */
         }
@@ -541,7 +553,7 @@ int allocator_check_integrity(void) {
         if (size < BLOCK_MIN_SIZE) {
             spin_unlock(&allocator_lock, flags);
 #if LOG_ENABLE
-            logger_log("Heap Block Small", 0, 0);
+            LOG_ERR(MEM, "Heap Block Small", 0, 0);
 #endif
             return -3; /* Block too small (header corruption) */
         }
@@ -550,7 +562,7 @@ int allocator_check_integrity(void) {
         if ((void*)((uint8_t*)curr + size) > heap_end_ptr) {
             spin_unlock(&allocator_lock, flags);
 #if LOG_ENABLE
-            logger_log("Heap Overflow", 0, 0);
+            LOG_ERR(MEM, "Heap Overflow", 0, 0);
 #endif
             return -4; /* Size pushes past heap end */
         }
@@ -559,7 +571,7 @@ int allocator_check_integrity(void) {
         if (curr->prev_phys_block != prev) {
             spin_unlock(&allocator_lock, flags);
 #if LOG_ENABLE
-            logger_log("Heap Chain Broken", 0, 0);
+            LOG_ERR(MEM, "Heap Chain Broken", 0, 0);
 #endif
             return -5; /* Broken physical chain */
         }
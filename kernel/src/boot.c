@@ -0,0 +1,152 @@
+#include "boot.h"
+#include "cli.h"
+#include "platform.h"
+#include "scheduler.h"
+#include "spinlock.h"
+#include "utils.h"
+
+/* Bounds of the init section, provided by the linker */
+extern const boot_init_t __start_boot_inits[];
+extern const boot_init_t __stop_boot_inits[];
+
+/*
+ * Zero-filled on purpose: on target the first mark comes from Reset_Handler
+ * right after .bss is cleared, and the cycle counter was zeroed at reset.
+ */
+static struct {
+    boot_stage_t stage[BOOT_MAX_STAGES];
+    uint32_t count;
+    uint32_t dropped;
+    uint32_t last_cycles;       /* Counter at the previous mark */
+    uint32_t last_hz;           /* Clock when the current stage began */
+    uint32_t started;
+    spinlock_t lock;
+} boot;
+
+void boot_reset(void) {
+    utils_memset(&boot, 0, sizeof(boot));
+    boot.last_cycles = platform_get_cycles();
+    boot.last_hz = (uint32_t)platform_get_cpu_freq();
+    boot.started = 1;
+}
+
+/* Append a stage, or count it as dropped if the table is full */
+static void boot_record(const char *name, int32_t result) {
+    uint32_t now = platform_get_cycles();
+    uint32_t hz = (uint32_t)platform_get_cpu_freq();
+
+    uint32_t flags = spin_lock(&boot.lock);
+    if (!boot.started) {
+        /* Counter started at reset on the clock that is still running */
+        boot.last_hz = hz;
+        boot.started = 1;
+    }
+    if (boot.count < BOOT_MAX_STAGES) {
+        boot_stage_t *s = &boot.stage[boot.count++];
+        s->name = name;
+        s->cycles = now;
+        s->elapsed = now - boot.last_cycles;
+        s->hz = boot.last_hz;
+        s->result = result;
+    } else {
+        boot.dropped++;
+    }
+    boot.last_cycles = now;
+    boot.last_hz = hz;
+    spin_unlock(&boot.lock, flags);
+}
+
+void boot_mark(const char *name) {
+    boot_record(name, 0);
+}
+
+int boot_run_level(boot_level_t level) {
+    int failed = 0;
+
+    for (const boot_init_t *e = __start_boot_inits; e < __stop_boot_inits; e++) {
+        if (e->level != (uint32_t)level) {
+            continue;
+        }
+        int rc = e->fn();
+        if (rc != 0) {
+            failed++;
+        }
+        boot_record(e->name, rc);
+    }
+    return failed;
+}
+
+void boot_run_deferred(void) {
+    /* Time the application tasks had before the deferred work started */
+    boot_mark("until deferred");
+    (void)boot_run_level(BOOT_LEVEL_DEFERRED);
+}
+
+static void boot_task_entry(void *arg) {
+    (void)arg;
+    /* Yielding charges this task a slice, so every application task runs first */
+    platform_yield();
+    boot_run_deferred();
+}
+
+int32_t boot_defer(void) {
+    return task_create(boot_task_entry, NULL, STACK_SIZE_2KB, TASK_WEIGHT_LOW);
+}
+
+uint32_t boot_stage_count(void) {
+    return boot.count;
+}
+
+const boot_stage_t *boot_get_stage(uint32_t index) {
+    if (index >= boot.count) {
+        return NULL;
+    }
+    return &boot.stage[index];
+}
+
+uint32_t boot_dropped(void) {
+    return boot.dropped;
+}
+
+uint32_t boot_stage_us(const boot_stage_t *stage) {
+    if (!stage) {
+        return 0;
+    }
+    if (stage->hz == 0) {
+        return stage->elapsed / 1000U;     /* Host: the counter is in ns */
+    }
+    return (uint32_t)(((uint64_t)stage->elapsed * 1000000ULL) / stage->hz);
+}
+
+static int cmd_boot_handler(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    uint32_t total_us = 0;
+
+    cli_printf("%-24s %10s %8s %8s\r\n", "Stage", "Cycles", "us", "At us");
+    for (uint32_t i = 0; i < boot.count; i++) {
+        const boot_stage_t *s = &boot.stage[i];
+        uint32_t us = boot_stage_us(s);
+        total_us += us;
+        cli_printf("%-24s %10u %8u %8u", s->name, s->elapsed, us, total_us);
+        if (s->result != 0) {
+            cli_printf("  (error %d)", (int)s->result);
+        }
+        cli_printf("\r\n");
+    }
+    if (boot.dropped) {
+        cli_printf("%u marks dropped (BOOT_MAX_STAGES %u)\r\n", boot.dropped, BOOT_MAX_STAGES);
+    }
+    return 0;
+}
+
+static const cli_command_t boot_cmd = {
+    .name = "boot",
+    .help = "Boot stage timings",
+    .handler = cmd_boot_handler
+};
+
+/* Register the CLI command */
+void boot_init(void) {
+    cli_register_command(&boot_cmd);
+}
@@ -6,8 +6,32 @@
 #include "arch_ops.h"
 #include "queue.h"
 #include "spinlock.h"
+#include "mutex.h"
 #include "platform.h"
 
+#if (CLI_TX_BUFFER_SIZE & (CLI_TX_BUFFER_SIZE - 1)) != 0
+    #error "CLI_TX_BUFFER_SIZE must be a power of 2"
+#endif
+
+#if CLI_MAX_CMDS > 255
+    #error "CLI_MAX_CMDS must fit the 8-bit command index"
+#endif
+
+#define CLI_TX_MASK         (CLI_TX_BUFFER_SIZE - 1U)
+#define CLI_PUTS_CHUNK      64U     /* Bytes per call to the puts callback */
+#define CLI_CMD_SLOTS       (CLI_MAX_CMDS * 2U)     /* Hash index, at most half full */
+
+/* RPC body: len:u16 | payload | crc32:u32 */
+#define CLI_RPC_BODY_MAX    (2U + 6U + CLI_RPC_MAX_PAYLOAD + 4U)
+#define CLI_RPC_ENC_MAX     (CLI_RPC_BODY_MAX + CLI_RPC_BODY_MAX / 254U + 2U)
+#define CLI_RPC_REQ_HDR     6U      /* seq, cmd_id, argc */
+#define CLI_RPC_RSP_HDR     6U      /* seq, status, ret */
+
+/* RPC receive state */
+#define CLI_RPC_IDLE        0U      /* Text console */
+#define CLI_RPC_RECV        1U      /* Collecting an encoded frame */
+#define CLI_RPC_SKIP        2U      /* Frame too long, discard up to the delimiter */
+
 
 static struct {
     cli_getc_fn_t   getc;
@@ -16,46 +40,156 @@ static struct {
     queue_t         *rx_queue;
     queue_t         *tx_queue;
     cli_command_t   commands[CLI_MAX_CMDS];
+    uint32_t        cmd_hash[CLI_MAX_CMDS];         /* cli_command_id() of each command */
+    uint8_t         cmd_index[CLI_CMD_SLOTS];       /* Command index + 1, 0 = empty slot */
     uint32_t        cmd_count;
     uint32_t        line_pos;
     uint32_t        cursor_pos;     /* Current cursor position */
     spinlock_t      lock;
     uint8_t         esc_state;      /* 0: Normal, 1: ESC, 2: [ */
     char            line_buffer[CLI_MAX_LINE_LEN];
+    so_mutex_t      tx_lock;        /* Serialises writers of the TX stream */
+    volatile uint32_t tx_head;      /* Stream write position (free running) */
+    volatile uint32_t tx_tail;      /* Stream read position (free running) */
+    char            tx_buf[CLI_TX_BUFFER_SIZE];
+    cli_write_fn_t  write;          /* Optional binary-safe output */
+#if CLI_RPC_ENABLE
+    uint8_t         rpc_state;      /* CLI_RPC_IDLE/RECV/SKIP */
+    uint8_t         rpc_capturing;  /* Stream writes go to rpc_body (tx_lock held) */
+    uint8_t         rpc_truncated;  /* Captured output did not fit */
+    uint8_t         rpc_text;       /* Every byte since the start byte was printable */
+    uint32_t        rpc_tick;       /* Tick of the last byte fed to the collector */
+    void            *rpc_owner;     /* Task whose output is captured */
+    uint32_t        rpc_len;        /* Bytes in rpc_frame / captured output */
+    uint8_t         rpc_frame[CLI_RPC_ENC_MAX];
+    uint8_t         rpc_body[CLI_RPC_BODY_MAX];
+#endif
 } cli_ctx;
 
-/* Helper to send string to queue or puts callback */
-static void cli_puts(const char *s) {
-    if (cli_ctx.tx_queue) {
-        /* Use bulk write for efficiency */
-        size_t len = 0;
-        const char *p = s;
-        while (*s) {
-            len++; s++;
+/*
+ * Output stream. cli_printf() and cli_puts() write straight into tx_buf,
+ * which is pumped into the TX queue (or the puts callback) without
+ * blocking. A writer only waits when tx_buf itself is full, and then
+ * only until the UART has taken enough bytes to make room.
+ */
+
+/* Move buffered output to the sink. With 'wait', block until at least one byte moves */
+static void cli_tx_pump(int wait) {
+    while (cli_ctx.tx_head != cli_ctx.tx_tail) {
+        uint32_t idx = cli_ctx.tx_tail & CLI_TX_MASK;
+        uint32_t run = cli_ctx.tx_head - cli_ctx.tx_tail;
+        int n;
+
+        if (run > CLI_TX_BUFFER_SIZE - idx) {
+            run = CLI_TX_BUFFER_SIZE - idx;   /* Up to the wrap */
         }
-        queue_push_arr(cli_ctx.tx_queue, p, len);
-    } else if (cli_ctx.puts) {
-            cli_ctx.puts(s);
+
+        if (cli_ctx.tx_queue) {
+            n = queue_push_arr_from_isr(cli_ctx.tx_queue, &cli_ctx.tx_buf[idx], run);
+            if (n <= 0) {
+                /* Queue full: backpressure only when asked to */
+                if (!wait || queue_push_arr(cli_ctx.tx_queue, &cli_ctx.tx_buf[idx], 1) != 0) {
+                    return;
+                }
+                n = 1;
+                wait = 0;
+            }
+        } else if (cli_ctx.write) {
+            n = (int)run;
+            cli_ctx.write(&cli_ctx.tx_buf[idx], run);
+        } else if (cli_ctx.puts) {
+            char chunk[CLI_PUTS_CHUNK + 1];
+            n = (int)((run < CLI_PUTS_CHUNK) ? run : CLI_PUTS_CHUNK);
+            utils_memcpy(chunk, &cli_ctx.tx_buf[idx], (size_t)n);
+            chunk[n] = '\0';
+            cli_ctx.puts(chunk);
+        } else {
+            n = (int)run;   /* No sink: discard */
+        }
+        cli_ctx.tx_tail += (uint32_t)n;
+    }
+}
+
+/* Append one byte to the stream, making room if it is full */
+static void cli_tx_putc(char c) {
+#if CLI_RPC_ENABLE
+    if (cli_ctx.rpc_capturing) {
+        /* Output of an RPC call goes into the response instead */
+        if (cli_ctx.rpc_len < CLI_RPC_MAX_PAYLOAD) {
+            cli_ctx.rpc_body[2U + CLI_RPC_RSP_HDR + cli_ctx.rpc_len++] = (uint8_t)c;
+        } else {
+            cli_ctx.rpc_truncated = 1;
+        }
+        return;
+    }
+#endif
+    if (cli_ctx.tx_head - cli_ctx.tx_tail == CLI_TX_BUFFER_SIZE) {
+        cli_tx_pump(1);
+        if (cli_ctx.tx_head - cli_ctx.tx_tail == CLI_TX_BUFFER_SIZE) {
+            return;     /* Sink unusable (no task context): drop */
+        }
+    }
+    cli_ctx.tx_buf[cli_ctx.tx_head & CLI_TX_MASK] = c;
+    cli_ctx.tx_head++;
+}
+
+/* Append 'count' copies of a byte */
+static void cli_tx_fill(char c, int count) {
+    while (count-- > 0) {
+        cli_tx_putc(c);
+    }
+}
+
+/* Take the stream for one print; capture it if the caller is running an RPC command */
+static void cli_tx_begin(void) {
+    so_mutex_lock(&cli_ctx.tx_lock);
+#if CLI_RPC_ENABLE
+    cli_ctx.rpc_capturing = (cli_ctx.rpc_owner != NULL && cli_ctx.rpc_owner == task_get_current());
+#endif
+}
+
+static void cli_tx_end(void) {
+#if CLI_RPC_ENABLE
+    cli_ctx.rpc_capturing = 0;
+#endif
+    cli_tx_pump(0);
+    so_mutex_unlock(&cli_ctx.tx_lock);
+}
+
+/* Helper to send string through the output stream */
+static void cli_puts(const char *s) {
+    cli_tx_begin();
+    while (*s) {
+        cli_tx_putc(*s++);
     }
+    cli_tx_end();
 }
 
-/* Helper for integer formatting */
-static void cli_fmt_int(char *buff, 
-                        uint32_t *pos, 
-                        uint32_t max, 
-                        uintptr_t val, 
-                        int width, 
-                        char pad, 
-                        int base, 
-                        int neg,
-                        int left_align) {
+/* Helper for integer formatting, returns characters written */
+static int cli_fmt_int(uint64_t val, 
+                       int width, 
+                       char pad, 
+                       uint32_t base, 
+                       int neg,
+                       int left_align) {
     char digits[24];
     int i = 0;
-    do {
-        int d = val % base;
-        digits[i++] = (d < 10) ? ('0' + d) : ('a' + d - 10);
-        val /= base;
-    } while (val > 0 && i < (int)sizeof(digits));
+
+    if (val <= 0xFFFFFFFFU) {
+        /* 32-bit fast path: no 64-bit division helper on Cortex-M */
+        uint32_t v = (uint32_t)val;
+        do {
+            uint32_t d = v % base;
+            digits[i++] = (char)((d < 10U) ? ('0' + d) : ('a' + d - 10U));
+            v /= base;
+        } while (v > 0U);
+    } else {
+        do {
+            uint32_t d = (uint32_t)(val % base);
+            digits[i++] = (char)((d < 10U) ? ('0' + d) : ('a' + d - 10U));
+            val /= base;
+        } while (val > 0U);
+    }
     
     int actual_len = i + (neg ? 1 : 0);
     int padding = width - actual_len;
@@ -63,30 +197,73 @@ static void cli_fmt_int(char *buff,
     if (!left_align) {
         /* If padding with '0', sign comes first (e.g. -001) */
         if (neg && pad == '0') {
-            if (*pos < max - 1) buff[(*pos)++] = '-';
+            cli_tx_putc('-');
             neg = 0; 
         }
-        
-        while (padding > 0 && *pos < max - 1) {
-            buff[(*pos)++] = pad;
-            padding--;
-        }
+        cli_tx_fill(pad, padding);
     }
     
-    if (neg && *pos < max - 1) {
-        buff[(*pos)++] = '-';
+    if (neg) {
+        cli_tx_putc('-');
     }
     
-    while (i > 0 && *pos < max - 1) {
-        buff[(*pos)++] = digits[--i];
+    while (i > 0) {
+        cli_tx_putc(digits[--i]);
     }
 
     if (left_align) {
-        while (padding > 0 && *pos < max - 1) {
-            buff[(*pos)++] = ' ';
-            padding--;
+        cli_tx_fill(' ', padding);
+    }
+    return (actual_len > width) ? actual_len : width;
+}
+
+/* Fetch an unsigned argument of the given length ('l' count) */
+static uint64_t cli_arg_unsigned(va_list *args, int lng) {
+    if (lng >= 2) {
+        return (uint64_t)va_arg(*args, unsigned long long);
+    }
+    if (lng == 1) {
+        return (uint64_t)va_arg(*args, unsigned long);
+    }
+    return (uint64_t)va_arg(*args, unsigned int);
+}
+
+/* Fetch a signed argument of the given length ('l' count) */
+static int64_t cli_arg_signed(va_list *args, int lng) {
+    if (lng >= 2) {
+        return (int64_t)va_arg(*args, long long);
+    }
+    if (lng == 1) {
+        return (int64_t)va_arg(*args, long);
+    }
+    return (int64_t)va_arg(*args, int);
+}
+
+/* Find a command by ID, and by name unless name is NULL; -1 if absent. Caller holds lock */
+static int32_t cli_find_cmd(uint32_t id, const char *name) {
+    uint32_t i = id % CLI_CMD_SLOTS;
+    for (uint32_t n = 0; n < CLI_CMD_SLOTS; n++) {
+        uint8_t e = cli_ctx.cmd_index[i];
+        if (e == 0U) {
+            return -1;
         }
+        uint32_t idx = e - 1U;
+        if (cli_ctx.cmd_hash[idx] == id &&
+            (!name || utils_strcmp(name, cli_ctx.commands[idx].name) == 0)) {
+            return (int32_t)idx;
+        }
+        i = (i + 1U) % CLI_CMD_SLOTS;
+    }
+    return -1;
+}
+
+/* Add command 'idx' to the hash index. Caller holds lock */
+static void cli_index_add(uint32_t idx) {
+    uint32_t i = cli_ctx.cmd_hash[idx] % CLI_CMD_SLOTS;
+    while (cli_ctx.cmd_index[i] != 0U) {
+        i = (i + 1U) % CLI_CMD_SLOTS;
     }
+    cli_ctx.cmd_index[i] = (uint8_t)(idx + 1U);
 }
 
 /* 
@@ -133,12 +310,10 @@ static void cli_process_cmd(void) {
         return;
     } else {
         uint32_t flags = spin_lock(&cli_ctx.lock);
-        for(uint32_t i = 0; i < cli_ctx.cmd_count; i++) {
-            if(utils_strcmp(argv[0], cli_ctx.commands[i].name) == 0) {
-                handler = cli_ctx.commands[i].handler;
-                found = 1;
-                break;
-            }
+        int32_t idx = cli_find_cmd(cli_command_id(argv[0]), argv[0]);
+        if (idx >= 0) {
+            handler = cli_ctx.commands[idx].handler;
+            found = 1;
         }
         spin_unlock(&cli_ctx.lock, flags);
 
@@ -196,15 +371,17 @@ static const cli_command_t help_cmd = {
 };
 
 /* 
- * Supports: %d (int), %u (unsigned), %x (hex), %s (string), %c (char), %% (literal %)
+ * Supports: %d (int), %u (unsigned), %x (hex), %s (string), %c (char), %p, %% (literal %)
+ * with '-', '0' and width flags, and 'l'/'ll' lengths on %d %u %x.
+ * Output is formatted straight into the TX stream and never truncated.
  */
 uint32_t cli_printf(const char *text, ...) {
-    char buff[CLI_MAX_LINE_LEN];
     uint32_t pos = 0;
     va_list args;
     va_start(args, text); /* initialize args to point to the first arg after text */
 
-    while (*text && pos < CLI_MAX_LINE_LEN-1) {
+    cli_tx_begin();
+    while (*text) {
         if (*text == '%') { /* need to insert an argument */
             text++;
             
@@ -227,90 +404,376 @@ uint32_t cli_printf(const char *text, ...) {
                 width = width * 10 + (*text - '0');
                 text++;
             }
+
+            /* Parse length: l = long, ll = long long */
+            int lng = 0;
+            while (*text == 'l') {
+                lng++;
+                text++;
+            }
             
             if(*text == 'd') { /* decimal */
-                int arg = va_arg(args, int);
-                unsigned int uval;
+                int64_t arg = cli_arg_signed(&args, lng);
+                uint64_t uval;
                 int neg = 0;
                 if(arg < 0) {
                     neg = 1;
-                    uval = (unsigned int)0 - (unsigned int)arg; /* Safe negation for INT_MIN */
+                    uval = (uint64_t)0 - (uint64_t)arg; /* Safe negation for INT64_MIN */
                 } else {
-                    uval = (unsigned int)arg;
+                    uval = (uint64_t)arg;
                 }
-                cli_fmt_int(buff, &pos, CLI_MAX_LINE_LEN, (uintptr_t)uval, width, pad_char, 10, neg, left_align);
+                pos += cli_fmt_int(uval, width, pad_char, 10, neg, left_align);
             }
             else if(*text == 'u') { /* unsigned */
-                unsigned int arg = va_arg(args, unsigned int);
-                cli_fmt_int(buff, &pos, CLI_MAX_LINE_LEN, (uintptr_t)arg, width, pad_char, 10, 0, left_align);
+                pos += cli_fmt_int(cli_arg_unsigned(&args, lng), width, pad_char, 10, 0, left_align);
             }
             else if(*text == 'x') { /* hex */
-                unsigned int arg = va_arg(args, unsigned int);
-                cli_fmt_int(buff, &pos, CLI_MAX_LINE_LEN, (uintptr_t)arg, width, pad_char, 16, 0, left_align);
+                pos += cli_fmt_int(cli_arg_unsigned(&args, lng), width, pad_char, 16, 0, left_align);
             }
             else if(*text == 'p') { /* pointer */
                 void *ptr = va_arg(args, void *);
-                uintptr_t val = (uintptr_t)ptr;
                 
-                if (pos < CLI_MAX_LINE_LEN - 2) {
-                    buff[pos++] = '0';
-                    buff[pos++] = 'x';
-                }
+                cli_tx_putc('0');
+                cli_tx_putc('x');
                 /* Format as hex. Width depends on platform (8 chars for 32-bit, 16 for 64-bit) */
                 int ptr_width = sizeof(void*) * 2;
-                cli_fmt_int(buff, &pos, CLI_MAX_LINE_LEN, val, ptr_width, '0', 16, 0, left_align);
+                pos += 2 + cli_fmt_int((uintptr_t)ptr, ptr_width, '0', 16, 0, left_align);
             }
             else if(*text == 's') { /* string */
                 const char *arg = va_arg(args, const char *);
                 if(arg) {
-                    size_t len = 0;
-                    const char *temp = arg;
-                    while(*temp++) len++;
-                    
+                    int len = (int)utils_strlen(arg);
                     int padding = width - len;
+
                     if (!left_align) {
-                        while (padding > 0 && pos < CLI_MAX_LINE_LEN-1) {
-                            buff[pos++] = ' ';
-                            padding--;
-                        }
+                        cli_tx_fill(' ', padding);
                     }
-                    
-                    while(*arg && pos < CLI_MAX_LINE_LEN-1) {
-                        buff[pos++] = *arg++;
+                    while(*arg) {
+                        cli_tx_putc(*arg++);
                     }
-                    
                     if (left_align) {
-                        while (padding > 0 && pos < CLI_MAX_LINE_LEN-1) {
-                            buff[pos++] = ' ';
-                            padding--;
-                        }
+                        cli_tx_fill(' ', padding);
                     }
+                    pos += (len > width) ? len : width;
                 }
             }
             else if(*text == 'c') { /* char */
-                if(pos < CLI_MAX_LINE_LEN-1) {
-                    buff[pos++] = (char)va_arg(args, int);
-                }
+                cli_tx_putc((char)va_arg(args, int));
+                pos++;
             }
             else if(*text == '%') { /* literal */
-                if(pos < CLI_MAX_LINE_LEN-1) {
-                    buff[pos++] = '%';
-                }
+                cli_tx_putc('%');
+                pos++;
+            }
+            else if(*text == '\0') { /* Stray '%' at the end */
+                break;
             }
             text++;
         }
         else { /* no argument insertion. just append the text */
-            buff[pos++] = *text++;
+            cli_tx_putc(*text++);
+            pos++;
         }
     }
-    buff[pos] = '\0'; /* add null terminate in the end*/
+    cli_tx_end();
     va_end(args);
-    if (pos > 0) {
-        cli_puts(buff); /* write the text to cli */
-    }
     return pos;
 }
 
+/* Push all buffered output to the TX queue or puts callback */
+void cli_flush(void) {
+    so_mutex_lock(&cli_ctx.tx_lock);
+    while (cli_ctx.tx_head != cli_ctx.tx_tail) {
+        uint32_t before = cli_ctx.tx_tail;
+        cli_tx_pump(1);
+        if (cli_ctx.tx_tail == before) {
+            break;  /* Sink cannot accept data */
+        }
+    }
+    so_mutex_unlock(&cli_ctx.tx_lock);
+}
+
+
+/* Feed one typed character to the line editor */
+static void cli_handle_char(char c) {
+    /* Escape Sequence Handling for Arrow Keys */
+    if (cli_ctx.esc_state == 1) {
+        if (c == '[') {
+            cli_ctx.esc_state = 2;
+        } else {
+            cli_ctx.esc_state = 0;
+        }
+        return;
+    } else if (cli_ctx.esc_state == 2) {
+        if (c == 'D') { /* Left Arrow */
+            if (cli_ctx.cursor_pos > 0) {
+                cli_ctx.cursor_pos--;
+                cli_puts("\033[D");
+            }
+        } else if (c == 'C') { /* Right Arrow */
+            if (cli_ctx.cursor_pos < cli_ctx.line_pos) {
+                cli_ctx.cursor_pos++;
+                cli_puts("\033[C");
+            }
+        }
+        cli_ctx.esc_state = 0;
+        return;
+    } else if (c == 0x1B) { /* ESC */
+        cli_ctx.esc_state = 1;
+        return;
+    }
+
+    if (c == '\r' || c == '\n') { /* cmd line ended */
+        cli_puts("\r\n"); /* start new line */
+        cli_ctx.line_buffer[cli_ctx.line_pos] = '\0'; /* terminate string */
+        cli_process_cmd();
+        cli_ctx.line_pos = 0; /* reset buffer */
+        cli_ctx.cursor_pos = 0;
+    }
+    /* Handle Backspace (ASCII 0x08 or DEL 0x7F) */
+    else if (c == '\b' || c == 0x7F) {
+        if (cli_ctx.cursor_pos > 0) {
+            /* Shift buffer left */
+            for (uint32_t i = cli_ctx.cursor_pos; i < cli_ctx.line_pos; i++) {
+                cli_ctx.line_buffer[i-1] = cli_ctx.line_buffer[i];
+            }
+            cli_ctx.line_pos--;
+            cli_ctx.cursor_pos--;
+            cli_ctx.line_buffer[cli_ctx.line_pos] = '\0';
+
+            /* Visual update: Move back, print rest of line, erase last char */
+            cli_puts("\b"); 
+            cli_puts(&cli_ctx.line_buffer[cli_ctx.cursor_pos]); 
+            cli_puts(" "); 
+            
+            /* Move cursor back to correct position */
+            uint32_t diff = cli_ctx.line_pos - cli_ctx.cursor_pos + 1;
+            while(diff--) {
+                cli_puts("\033[D");
+            }
+        }
+    }
+    /* Handle Standard Characters */
+    else if (c >= ' ' && c <= '~') {
+        if (cli_ctx.line_pos < CLI_MAX_LINE_LEN - 1) {
+            /* Insert character */
+            if (cli_ctx.cursor_pos < cli_ctx.line_pos) {
+                /* Shift right */
+                for (uint32_t i = cli_ctx.line_pos; i > cli_ctx.cursor_pos; i--) {
+                    cli_ctx.line_buffer[i] = cli_ctx.line_buffer[i-1];
+                }
+                cli_ctx.line_buffer[cli_ctx.cursor_pos] = c;
+                cli_ctx.line_pos++;
+                cli_ctx.line_buffer[cli_ctx.line_pos] = '\0';
+                
+                /* Visual update: Print rest of line */
+                cli_puts(&cli_ctx.line_buffer[cli_ctx.cursor_pos]);
+                
+                /* Move cursor back to correct position */
+                cli_ctx.cursor_pos++;
+                uint32_t diff = cli_ctx.line_pos - cli_ctx.cursor_pos;
+                while(diff--) {
+                    cli_puts("\033[D");
+                }
+            } else {
+                /* Append at end */
+                cli_ctx.line_buffer[cli_ctx.line_pos++] = c;
+                cli_ctx.cursor_pos++;
+                char echo[2] = {c, '\0'};
+                cli_puts(echo);
+            }
+        } else {
+            cli_puts("ERROR: BUFFER FULL\r\n");
+        }
+    }
+}
+
+/* RPC command ID of a name */
+uint32_t cli_command_id(const char *name) {
+    return utils_fnv1a(name, utils_strlen(name));
+}
+
+#if CLI_RPC_ENABLE
+/* Read a little-endian value from a byte buffer */
+static uint32_t cli_get_le(const uint8_t *p, uint32_t bytes) {
+    uint32_t v = 0;
+    while (bytes--) {
+        v = (v << 8) | p[bytes];
+    }
+    return v;
+}
+
+/* Write a little-endian value to a byte buffer */
+static void cli_put_le(uint8_t *p, uint32_t v, uint32_t bytes) {
+    for (uint32_t i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)(v >> (8U * i));
+    }
+}
+
+/* Frame the response in rpc_body (output already captured) and send it */
+static void cli_rpc_respond(uint8_t seq, int8_t status, int32_t ret) {
+    uint8_t *b = cli_ctx.rpc_body;
+    uint32_t len = CLI_RPC_RSP_HDR + cli_ctx.rpc_len;
+
+    cli_put_le(&b[0], len, 2);
+    b[2] = seq;
+    b[3] = (uint8_t)status;
+    cli_put_le(&b[4], (uint32_t)ret, 4);
+    cli_put_le(&b[2U + len], utils_crc32(0, b, 2U + len), 4);
+
+    /* The request has been consumed, so its buffer holds the encoded response */
+    size_t n = utils_cobs_encode(b, 2U + len + 4U, cli_ctx.rpc_frame);
+
+    so_mutex_lock(&cli_ctx.tx_lock);
+    cli_tx_putc((char)CLI_RPC_SOF);
+    for (size_t i = 0; i < n; i++) {
+        cli_tx_putc((char)cli_ctx.rpc_frame[i]);
+    }
+    cli_tx_pump(0);
+    so_mutex_unlock(&cli_ctx.tx_lock);
+}
+
+/* Decode, check and run the request in rpc_frame */
+static void cli_rpc_dispatch(void) {
+    char *argv[CLI_MAX_ARGS];
+    uint8_t *b = cli_ctx.rpc_frame;
+    int32_t n = utils_cobs_decode(b, cli_ctx.rpc_len, b);
+    uint8_t seq = 0;
+
+    cli_ctx.rpc_len = 0;
+    cli_ctx.rpc_truncated = 0;
+
+    if (n < (int32_t)(2U + CLI_RPC_REQ_HDR + 4U)) {
+        cli_rpc_respond(0, CLI_ERR_CRC, 0);
+        return;
+    }
+    uint32_t len = cli_get_le(b, 2);
+    seq = b[2];
+    if ((uint32_t)n != 2U + len + 4U || len < CLI_RPC_REQ_HDR ||
+        utils_crc32(0, b, 2U + len) != cli_get_le(&b[2U + len], 4)) {
+        cli_rpc_respond(seq, CLI_ERR_CRC, 0);
+        return;
+    }
+
+    uint32_t id = cli_get_le(&b[3], 4);
+    uint32_t argc = b[7];
+    uint8_t *p = &b[8];
+    uint8_t *end = &b[2U + len];
+
+    if (id == CLI_RPC_LIST_ID) {
+        cli_ctx.rpc_owner = task_get_current();
+        for (uint32_t i = 0; ; i++) {
+            const char *name = NULL;
+            uint32_t flags = spin_lock(&cli_ctx.lock);
+            if (i < cli_ctx.cmd_count) {
+                name = cli_ctx.commands[i].name;
+            }
+            spin_unlock(&cli_ctx.lock, flags);
+            if (!name) {
+                break;
+            }
+            cli_printf("%s\n", name);
+        }
+        cli_ctx.rpc_owner = NULL;
+        cli_rpc_respond(seq, cli_ctx.rpc_truncated ? CLI_ERR_TOOLONG : CLI_OK, 0);
+        return;
+    }
+
+    cli_cmd_fn_t handler = NULL;
+    uint32_t flags = spin_lock(&cli_ctx.lock);
+    int32_t idx = cli_find_cmd(id, NULL);
+    if (idx >= 0) {
+        handler = cli_ctx.commands[idx].handler;
+        argv[0] = (char *)cli_ctx.commands[idx].name;
+    }
+    spin_unlock(&cli_ctx.lock, flags);
+
+    if (!handler) {
+        cli_rpc_respond(seq, CLI_ERR_NOCMD, 0);
+        return;
+    }
+    if (argc + 1U > CLI_MAX_ARGS) {
+        cli_rpc_respond(seq, CLI_ERR_BAD_ARGS, 0);
+        return;
+    }
+
+    /* Turn each length-prefixed argument into a C string in place */
+    for (uint32_t i = 1; i <= argc; i++) {
+        uint32_t alen = (p < end) ? p[0] : 0U;
+        if (p >= end || p + 1U + alen > end) {
+            cli_rpc_respond(seq, CLI_ERR_BAD_ARGS, 0);
+            return;
+        }
+        for (uint32_t j = 0; j < alen; j++) {
+            p[j] = p[j + 1U];
+        }
+        p[alen] = '\0';
+        argv[i] = (char *)p;
+        p += alen + 1U;
+    }
+
+    /* Run the handler with its output captured */
+    cli_ctx.rpc_owner = task_get_current();
+    int32_t ret = handler((int)(argc + 1U), argv);
+    cli_ctx.rpc_owner = NULL;
+    cli_rpc_respond(seq, cli_ctx.rpc_truncated ? CLI_ERR_TOOLONG : CLI_OK, ret);
+}
+
+/* Feed one received byte to the frame collector. Returns 0 if it is console text. */
+static int cli_rpc_rx(uint8_t c) {
+    uint32_t now = (uint32_t)platform_get_ticks();
+
+    /* A frame arrives back to back; a pause means it was noise */
+    if (cli_ctx.rpc_state != CLI_RPC_IDLE && now - cli_ctx.rpc_tick > CLI_RPC_TIMEOUT_TICKS) {
+        cli_ctx.rpc_state = CLI_RPC_IDLE;
+    }
+    cli_ctx.rpc_tick = now;
+
+    if (cli_ctx.rpc_state == CLI_RPC_IDLE) {
+        /* Frames start on an empty line, so 0xA5 typed mid-line stays text */
+        if (c != CLI_RPC_SOF || cli_ctx.line_pos != 0U) {
+            return 0;
+        }
+        cli_ctx.rpc_state = CLI_RPC_RECV;
+        cli_ctx.rpc_len = 0;
+        cli_ctx.rpc_text = 1;
+        return 1;
+    }
+    if (c == 0U) {
+        if (cli_ctx.rpc_state == CLI_RPC_RECV) {
+            cli_rpc_dispatch();
+        }
+        cli_ctx.rpc_state = CLI_RPC_IDLE;
+        return 1;
+    }
+
+    /*
+     * A line ending after printable text: the start byte was noise. A request's
+     * length field puts a control byte in its first three encoded bytes, so two
+     * printable bytes already rule out a frame; shorter runs wait for the timeout.
+     */
+    if ((c == '\r' || c == '\n') && cli_ctx.rpc_text && cli_ctx.rpc_len >= 2U) {
+        uint8_t replay = (cli_ctx.rpc_state == CLI_RPC_RECV);
+        cli_ctx.rpc_state = CLI_RPC_IDLE;
+        for (uint32_t i = 0; replay && i < cli_ctx.rpc_len; i++) {
+            cli_handle_char((char)cli_ctx.rpc_frame[i]);
+        }
+        return 0;   /* The line ending itself runs the command */
+    }
+    if (c < (uint8_t)' ' || c > (uint8_t)'~') {
+        cli_ctx.rpc_text = 0;
+    }
+
+    if (cli_ctx.rpc_state == CLI_RPC_RECV) {
+        if (cli_ctx.rpc_len < CLI_RPC_ENC_MAX) {
+            cli_ctx.rpc_frame[cli_ctx.rpc_len++] = c;
+        } else {
+            cli_ctx.rpc_state = CLI_RPC_SKIP;
+        }
+    }
+    return 1;
+}
+#endif
 
 /* Register a new command in the cli */
 int32_t cli_register_command(const cli_command_t *cmd) {
@@ -324,7 +787,17 @@ int32_t cli_register_command(const cli_command_t *cmd) {
         return CLI_ERR;
     }
 
-    cli_ctx.commands[cli_ctx.cmd_count++] = *cmd;
+    /* RPC looks commands up by ID alone, so IDs must be unique (this also rejects duplicate names) */
+    uint32_t id = cli_command_id(cmd->name);
+    if(cli_find_cmd(id, NULL) >= 0) {
+        spin_unlock(&cli_ctx.lock, flags);
+        return CLI_ERR;
+    }
+
+    cli_ctx.commands[cli_ctx.cmd_count] = *cmd;
+    cli_ctx.cmd_hash[cli_ctx.cmd_count] = id;
+    cli_index_add(cli_ctx.cmd_count);
+    cli_ctx.cmd_count++;
     spin_unlock(&cli_ctx.lock, flags);
     return CLI_OK;
 }
@@ -332,17 +805,27 @@ int32_t cli_register_command(const cli_command_t *cmd) {
 
 /* Unregister a command in the cli */
 int32_t cli_unregister_command(const char *name) {
+    if (!name) {
+        return CLI_ERR_NOCMD;
+    }
+
     uint32_t flags = spin_lock(&cli_ctx.lock);
-    for (uint32_t i = 0; i < cli_ctx.cmd_count; i++) {
-        if(utils_strcmp(name, cli_ctx.commands[i].name) == 0) {
-            cli_ctx.commands[i] = cli_ctx.commands[cli_ctx.cmd_count-1];
-            cli_ctx.cmd_count--;
-            spin_unlock(&cli_ctx.lock, flags);
-            return CLI_OK;
-        }
+    int32_t i = cli_find_cmd(cli_command_id(name), name);
+    if (i < 0) {
+        spin_unlock(&cli_ctx.lock, flags);
+        return CLI_ERR_NOCMD;
+    }
+
+    /* Move the last command into the hole and rebuild the index (rare) */
+    cli_ctx.cmd_count--;
+    cli_ctx.commands[i] = cli_ctx.commands[cli_ctx.cmd_count];
+    cli_ctx.cmd_hash[i] = cli_ctx.cmd_hash[cli_ctx.cmd_count];
+    utils_memset(cli_ctx.cmd_index, 0, sizeof(cli_ctx.cmd_index));
+    for (uint32_t j = 0; j < cli_ctx.cmd_count; j++) {
+        cli_index_add(j);
     }
     spin_unlock(&cli_ctx.lock, flags);
-    return CLI_ERR_NOCMD;
+    return CLI_OK;
 }
 
 
@@ -353,12 +836,18 @@ int32_t cli_init(const char *prompt, cli_getc_fn_t getc, cli_puts_fn_t puts) {
     cli_ctx.getc = getc;
     cli_ctx.puts = puts;
     spinlock_init(&cli_ctx.lock);
+    so_mutex_init(&cli_ctx.tx_lock);
 
     cli_register_command(&help_cmd);
 
     return CLI_OK;
 }
 
+/* Set a binary-safe output callback */
+void cli_set_write_fn(cli_write_fn_t write) {
+    cli_ctx.write = write;
+}
+
 /* Set the input queue for the CLI */
 void cli_set_rx_queue(queue_t *q) {
     cli_ctx.rx_queue = q;
@@ -380,8 +869,17 @@ void cli_task_entry(void *arg) {
 
     while(1) {
         if (cli_ctx.rx_queue) {
-            /* Block on queue until a character arrives */
-            if (queue_pop(cli_ctx.rx_queue, &c) != 0) {
+            if (cli_ctx.tx_head != cli_ctx.tx_tail) {
+                /* Output pending: keep feeding the TX queue while polling for input */
+                if (queue_pop_from_isr(cli_ctx.rx_queue, &c) != 0) {
+                    so_mutex_lock(&cli_ctx.tx_lock);
+                    cli_tx_pump(0);
+                    so_mutex_unlock(&cli_ctx.tx_lock);
+                    task_sleep_ticks(1);
+                    continue;
+                }
+            } else if (queue_pop(cli_ctx.rx_queue, &c) != 0) {
+                /* Block on queue until a character arrives */
                 continue;
             }
         } else {
@@ -399,95 +897,13 @@ void cli_task_entry(void *arg) {
             }
         }
 
-        /* Escape Sequence Handling for Arrow Keys */
-        if (cli_ctx.esc_state == 1) {
-            if (c == '[') {
-                cli_ctx.esc_state = 2;
-            } else {
-                cli_ctx.esc_state = 0;
-            }
-            continue;
-        } else if (cli_ctx.esc_state == 2) {
-            if (c == 'D') { /* Left Arrow */
-                if (cli_ctx.cursor_pos > 0) {
-                    cli_ctx.cursor_pos--;
-                    cli_puts("\033[D");
-                }
-            } else if (c == 'C') { /* Right Arrow */
-                if (cli_ctx.cursor_pos < cli_ctx.line_pos) {
-                    cli_ctx.cursor_pos++;
-                    cli_puts("\033[C");
-                }
-            }
-            cli_ctx.esc_state = 0;
-            continue;
-        } else if (c == 0x1B) { /* ESC */
-            cli_ctx.esc_state = 1;
+#if CLI_RPC_ENABLE
+        /* Binary frames start with a byte the text console never uses */
+        if (cli_rpc_rx((uint8_t)c)) {
             continue;
         }
+#endif
 
-        if (c == '\r' || c == '\n') { /* cmd line ended */
-            cli_puts("\r\n"); /* start new line */
-            cli_ctx.line_buffer[cli_ctx.line_pos] = '\0'; /* terminate string */
-            cli_process_cmd();
-            cli_ctx.line_pos = 0; /* reset buffer */
-            cli_ctx.cursor_pos = 0;
-        }
-        /* Handle Backspace (ASCII 0x08 or DEL 0x7F) */
-        else if (c == '\b' || c == 0x7F) {
-            if (cli_ctx.cursor_pos > 0) {
-                /* Shift buffer left */
-                for (uint32_t i = cli_ctx.cursor_pos; i < cli_ctx.line_pos; i++) {
-                    cli_ctx.line_buffer[i-1] = cli_ctx.line_buffer[i];
-                }
-                cli_ctx.line_pos--;
-                cli_ctx.cursor_pos--;
-                cli_ctx.line_buffer[cli_ctx.line_pos] = '\0';
-
-                /* Visual update: Move back, print rest of line, erase last char */
-                cli_puts("\b"); 
-                cli_puts(&cli_ctx.line_buffer[cli_ctx.cursor_pos]); 
-                cli_puts(" "); 
-                
-                /* Move cursor back to correct position */
-                uint32_t diff = cli_ctx.line_pos - cli_ctx.cursor_pos + 1;
-                while(diff--) {
-                    cli_puts("\033[D");
-                }
-            }
-        }
-        /* Handle Standard Characters */
-        else if (c >= ' ' && c <= '~') {
-            if (cli_ctx.line_pos < CLI_MAX_LINE_LEN - 1) {
-                /* Insert character */
-                if (cli_ctx.cursor_pos < cli_ctx.line_pos) {
-                    /* Shift right */
-                    for (uint32_t i = cli_ctx.line_pos; i > cli_ctx.cursor_pos; i--) {
-                        cli_ctx.line_buffer[i] = cli_ctx.line_buffer[i-1];
-                    }
-                    cli_ctx.line_buffer[cli_ctx.cursor_pos] = c;
-                    cli_ctx.line_pos++;
-                    cli_ctx.line_buffer[cli_ctx.line_pos] = '\0';
-                    
-                    /* Visual update: Print rest of line */
-                    cli_puts(&cli_ctx.line_buffer[cli_ctx.cursor_pos]);
-                    
-                    /* Move cursor back to correct position */
-                    cli_ctx.cursor_pos++;
-                    uint32_t diff = cli_ctx.line_pos - cli_ctx.cursor_pos;
-                    while(diff--) {
-                        cli_puts("\033[D");
-                    }
-                } else {
-                    /* Append at end */
-                    cli_ctx.line_buffer[cli_ctx.line_pos++] = c;
-                    cli_ctx.cursor_pos++;
-                    char echo[2] = {c, '\0'};
-                    cli_puts(echo);
-                }
-            } else {
-                cli_puts("ERROR: BUFFER FULL\r\n");
-            }
-        }
+        cli_handle_char(c);
     }
 }
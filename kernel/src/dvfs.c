@@ -0,0 +1,282 @@
+#include "dvfs.h"
+#include "system_clock.h"
+#include "scheduler.h"
+#include "platform.h"
+#include "spinlock.h"
+#include "timer.h"
+#include "cli.h"
+#include "utils.h"
+#include <stddef.h>
+
+typedef struct {
+    dvfs_notify_fn_t fn;            /* NULL if the slot is free */
+    void *arg;
+} dvfs_notifier_t;
+
+static dvfs_notifier_t dvfs_notifiers[DVFS_MAX_NOTIFIERS];
+static spinlock_t dvfs_lock;
+static dvfs_stats_t dvfs_stats;
+
+/* Governor state */
+static uint8_t gov_enabled;
+static uint8_t gov_low_samples;     /* Consecutive samples that asked for less */
+static uint32_t gov_last_tick;
+static uint64_t gov_last_idle;
+
+/* Tell the first count notifiers about an event (Lock must be held) */
+static void dvfs_notify_locked(uint32_t count, dvfs_event_t event, uint32_t old_hz, uint32_t new_hz) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (dvfs_notifiers[i].fn) {
+            dvfs_notifiers[i].fn(event, old_hz, new_hz, dvfs_notifiers[i].arg);
+        }
+    }
+}
+
+int dvfs_notifier_register(dvfs_notify_fn_t fn, void *arg) {
+    if (!fn) {
+        return DVFS_ERR_PARAM;
+    }
+
+    int free_slot = -1;
+    int res = DVFS_ERR_FULL;
+    uint32_t flags = spin_lock(&dvfs_lock);
+    for (int i = 0; i < DVFS_MAX_NOTIFIERS; i++) {
+        if (dvfs_notifiers[i].fn == fn && dvfs_notifiers[i].arg == arg) {
+            free_slot = -1;
+            res = DVFS_OK;
+            break;
+        }
+        if (!dvfs_notifiers[i].fn && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (free_slot >= 0) {
+        dvfs_notifiers[free_slot].fn = fn;
+        dvfs_notifiers[free_slot].arg = arg;
+        res = DVFS_OK;
+    }
+    spin_unlock(&dvfs_lock, flags);
+    return res;
+}
+
+int dvfs_notifier_unregister(dvfs_notify_fn_t fn, void *arg) {
+    int res = DVFS_ERR_PARAM;
+    uint32_t flags = spin_lock(&dvfs_lock);
+    for (int i = 0; i < DVFS_MAX_NOTIFIERS; i++) {
+        if (fn && dvfs_notifiers[i].fn == fn && dvfs_notifiers[i].arg == arg) {
+            dvfs_notifiers[i].fn = NULL;
+            dvfs_notifiers[i].arg = NULL;
+            res = DVFS_OK;
+            break;
+        }
+    }
+    spin_unlock(&dvfs_lock, flags);
+    return res;
+}
+
+/* Switch the clock: ask, switch, then tell (all with interrupts masked) */
+int dvfs_set_hz(uint32_t hz) {
+    if (!system_clock_find_opp(hz)) {
+        return DVFS_ERR_UNSUPPORTED;
+    }
+
+    uint32_t flags = spin_lock(&dvfs_lock);
+    uint32_t old_hz = get_system_clock_hz();
+    if (hz == old_hz) {
+        spin_unlock(&dvfs_lock, flags);
+        return DVFS_OK;
+    }
+
+    /* The first refusal cancels; those already asked are told it is off */
+    for (uint32_t i = 0; i < DVFS_MAX_NOTIFIERS; i++) {
+        if (dvfs_notifiers[i].fn &&
+            dvfs_notifiers[i].fn(DVFS_PRE_CHANGE, old_hz, hz, dvfs_notifiers[i].arg) != 0) {
+            dvfs_notify_locked(i, DVFS_ABORT_CHANGE, old_hz, hz);
+            dvfs_stats.vetoes++;
+            spin_unlock(&dvfs_lock, flags);
+            return DVFS_ERR_VETO;
+        }
+    }
+
+    int rc = platform_set_cpu_freq(hz);
+
+    /* A failed switch can stop on another valid point: report the real one */
+    uint32_t new_hz = get_system_clock_hz();
+    if (new_hz != old_hz) {
+        dvfs_notify_locked(DVFS_MAX_NOTIFIERS, DVFS_POST_CHANGE, old_hz, new_hz);
+    } else {
+        dvfs_notify_locked(DVFS_MAX_NOTIFIERS, DVFS_ABORT_CHANGE, old_hz, hz);
+    }
+    if (rc != 0) {
+        dvfs_stats.failures++;
+    } else {
+        dvfs_stats.transitions++;
+    }
+    spin_unlock(&dvfs_lock, flags);
+    return rc != 0 ? DVFS_ERR_CLOCK : DVFS_OK;
+}
+
+uint32_t dvfs_get_hz(void) {
+    return get_system_clock_hz();
+}
+
+/* Lowest clock that keeps the measured work under the target load */
+uint32_t dvfs_governor_select(uint32_t cur_hz, uint32_t busy_pct) {
+    size_t count = system_clock_opp_count();
+    uint32_t top_hz = system_clock_get_opp(count - 1U)->hz;
+
+    if (busy_pct >= DVFS_UP_PCT) {
+        return top_hz;
+    }
+
+    /* Busy cycles scale with the clock: busy% at f = busy_pct * cur_hz / f */
+    uint64_t work = (uint64_t)busy_pct * cur_hz;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t hz = system_clock_get_opp(i)->hz;
+        if (hz >= DVFS_MIN_HZ && work <= (uint64_t)DVFS_TARGET_PCT * hz) {
+            return hz;
+        }
+    }
+    return top_hz;
+}
+
+/* Load over the ticks since the last sample, then decide */
+void dvfs_governor_sample(void) {
+    uint32_t now = (uint32_t)platform_get_ticks();
+    uint64_t idle = scheduler_get_idle_ticks();
+    uint32_t elapsed = now - gov_last_tick;
+    uint64_t idle_ticks = idle - gov_last_idle;
+
+    gov_last_tick = now;
+    gov_last_idle = idle;
+    if (elapsed == 0U) {
+        return;
+    }
+    if (idle_ticks > elapsed) {
+        idle_ticks = elapsed;       /* Charged at switches, so it can run ahead */
+    }
+    uint32_t busy = 100U - (uint32_t)((idle_ticks * 100U) / elapsed);
+    dvfs_stats.samples++;
+    dvfs_stats.last_busy_pct = (uint8_t)busy;
+
+    if (!gov_enabled) {
+        return;
+    }
+
+    uint32_t cur_hz = dvfs_get_hz();
+    uint32_t target = dvfs_governor_select(cur_hz, busy);
+    if (target > cur_hz) {
+        gov_low_samples = 0;
+        dvfs_set_hz(target);
+    } else if (target < cur_hz) {
+        if (++gov_low_samples >= DVFS_DOWN_SAMPLES) {
+            gov_low_samples = 0;
+            dvfs_set_hz(target);
+        }
+    } else {
+        gov_low_samples = 0;
+    }
+}
+
+void dvfs_governor_enable(uint8_t enable) {
+    gov_enabled = enable ? 1 : 0;
+    gov_low_samples = 0;
+}
+
+uint8_t dvfs_governor_enabled(void) {
+    return gov_enabled;
+}
+
+void dvfs_get_stats(dvfs_stats_t *stats) {
+    if (stats) {
+        *stats = dvfs_stats;
+    }
+}
+
+void dvfs_reset(void) {
+    spinlock_init(&dvfs_lock);
+    utils_memset(dvfs_notifiers, 0, sizeof(dvfs_notifiers));
+    utils_memset(&dvfs_stats, 0, sizeof(dvfs_stats));
+    gov_enabled = 0;
+    gov_low_samples = 0;
+    gov_last_tick = (uint32_t)platform_get_ticks();
+    gov_last_idle = scheduler_get_idle_ticks();
+}
+
+#if DVFS_ENABLE
+/* Governor timer callback */
+static void dvfs_timer_cb(void *arg) {
+    (void)arg;
+    dvfs_governor_sample();
+}
+#endif
+
+static const char *dvfs_source_str(sysclk_source_t src) {
+    switch (src) {
+        case SYSCLK_SRC_MSI:   return "MSI";
+        case SYSCLK_SRC_HSI16: return "HSI16";
+        case SYSCLK_SRC_HSE:   return "HSE";
+        case SYSCLK_SRC_PLL:   return "PLL";
+        default:               return "?";
+    }
+}
+
+/* CLI Command Handler: dvfs [auto | <MHz>] */
+static int cmd_dvfs_handler(int argc, char **argv) {
+    if (argc > 1) {
+        if (utils_strcmp(argv[1], "auto") == 0) {
+            dvfs_governor_enable(1);
+        } else {
+            int mhz = utils_atoi(argv[1]);
+            int rc = (mhz > 0) ? dvfs_set_hz((uint32_t)mhz * 1000000U) : DVFS_ERR_UNSUPPORTED;
+            if (rc == DVFS_OK) {
+                dvfs_governor_enable(0);    /* Hold the chosen clock */
+            } else if (rc == DVFS_ERR_UNSUPPORTED) {
+                cli_printf("Usage: dvfs [auto | <MHz>] (MHz from the table below)\r\n");
+            } else {
+                cli_printf("Switch failed: %s\r\n", rc == DVFS_ERR_VETO ? "refused by a driver" : "clock error");
+            }
+        }
+    }
+
+    uint32_t cur_hz = dvfs_get_hz();
+    cli_printf("Clock: %u MHz, range %u, %u WS, governor %s\r\n",
+               cur_hz / 1000000U, (unsigned)system_clock_get_vos(),
+               system_clock_get_flash_latency(), gov_enabled ? "auto" : "hold");
+    cli_printf("Load: %u%% busy, %u samples, %u switches, %u vetoes, %u failures\r\n",
+               dvfs_stats.last_busy_pct, dvfs_stats.samples, dvfs_stats.transitions,
+               dvfs_stats.vetoes, dvfs_stats.failures);
+    cli_printf("   MHz  Source  Range  WS\r\n");
+    for (size_t i = 0; i < system_clock_opp_count(); i++) {
+        const sysclock_opp_t *opp = system_clock_get_opp(i);
+        cli_printf("%c %4u  %-6s  %5u  %2u\r\n", opp->hz == cur_hz ? '*' : ' ',
+                   opp->hz / 1000000U, dvfs_source_str(opp->source), (unsigned)opp->vos,
+                   system_clock_flash_latency(opp->hz, opp->vos));
+    }
+    return 0;
+}
+
+static const cli_command_t dvfs_cmd = {
+    .name = "dvfs",
+    .help = "Clock scaling: dvfs [auto | <MHz>]",
+    .handler = cmd_dvfs_handler
+};
+
+/* Register the CLI command and start the governor */
+int dvfs_init(void) {
+    spinlock_stats_register(&dvfs_lock, "dvfs");
+    gov_last_tick = (uint32_t)platform_get_ticks();
+    gov_last_idle = scheduler_get_idle_ticks();
+    cli_register_command(&dvfs_cmd);
+
+#if DVFS_ENABLE
+    gov_enabled = 1;
+    sw_timer_t *sampler = timer_create("dvfs", DVFS_SAMPLE_TICKS, 1, dvfs_timer_cb, NULL);
+    if (!sampler) {
+        return -1;
+    }
+    return timer_start(sampler);
+#else
+    return 0;
+#endif
+}
@@ -5,13 +5,6 @@
 #include <stddef.h>
 #include "allocator.h"
 
-struct event_group {
-    wait_node_t     *wait_head;     /* Tasks waiting for events */
-    wait_node_t     *wait_tail;
-    uint32_t        bits;           /* Current event bits */
-    spinlock_t      lock;
-};
-
 #define EVENT_SATISFIED_FLAG 0x80
 
 /* Add to wait list */
@@ -109,11 +102,24 @@ event_group_t* event_group_create(void) {
         eg->bits = 0;
         eg->wait_head = NULL;
         eg->wait_tail = NULL;
+        eg->is_static = 0;
         spinlock_init(&eg->lock);
     }
     return eg;
 }
 
+/* Set up an event group in caller-provided memory */
+void event_group_init_static(event_group_t *eg) {
+    if (!eg) {
+        return;
+    }
+    eg->bits = 0;
+    eg->wait_head = NULL;
+    eg->wait_tail = NULL;
+    eg->is_static = 1;
+    spinlock_init(&eg->lock);
+}
+
 /* Delete an event group */
 void event_group_delete(event_group_t *eg) {
     if (!eg) {
@@ -129,7 +135,9 @@ void event_group_delete(event_group_t *eg) {
     }
     spin_unlock(&eg->lock, flags);
     
-    allocator_free(eg);
+    if (!eg->is_static) {
+        allocator_free(eg);
+    }
 }
 
 /* Set event bits */
@@ -226,7 +234,7 @@ uint32_t event_group_wait_bits(event_group_t *eg,
     
     /* Mark as blocked BEFORE unlocking to ensure we don't miss the wakeup 
      * if an ISR fires immediately after unlock. */
-    task_set_state(current, TASK_BLOCKED);
+    task_block_on(current, eg);
     spin_unlock(&eg->lock, flags);
     
     /* Handle blocking atomically for infinite wait to prevent lost wakeups */
@@ -0,0 +1,262 @@
+#include "ipc.h"
+#include "scheduler.h"
+#include "arch_ops.h"
+#include "platform.h"
+#include "spinlock.h"
+#include "perf.h"
+#include <stddef.h>
+
+/* ipc_state_t.state */
+enum {
+    IPC_IDLE = 0,
+    IPC_SENDING,        /* Caller: queued on the server */
+    IPC_CALLING,        /* Caller: request taken, waiting for the reply */
+    IPC_REPLIED,        /* Caller: reply delivered */
+    IPC_RECEIVING,      /* Server: waiting for a request */
+    IPC_RECEIVED,       /* Server: request delivered by a caller */
+};
+
+static spinlock_t ipc_lock;
+
+PERF_COUNTER(perf_ipc_call, "ipc.call");
+PERF_COUNTER(perf_ipc_direct, "ipc.direct");
+
+/* Add a node to the linked list tail */
+static void _add_to_wait_list(wait_node_t **head, wait_node_t **tail, wait_node_t *node) {
+    node->next = NULL;
+    if (*tail) {
+        (*tail)->next = node;
+    } else {
+        *head = node;
+    }
+    *tail = node;
+}
+
+/* Remove and return the first node from the linked list */
+static void* _pop_from_wait_list(wait_node_t **head, wait_node_t **tail) {
+    if (!*head) {
+        return NULL;
+    }
+
+    wait_node_t *node = *head;
+    void *task = node->task;
+
+    *head = node->next;
+    if (*head == NULL) {
+        *tail = NULL;
+    }
+    return task;
+}
+
+/* Lend a caller's weight to the server, remembering what to hand back. Lock held. */
+static void _lend_weight_locked(task_t *server, uint8_t weight) {
+    ipc_state_t *srv = task_get_ipc_state(server);
+    uint8_t cur = task_get_weight(server);
+
+    /* Save on the first loan, or if something else (mutex PI) moved it since */
+    if (srv->saved_weight == 0 || cur != srv->lent_weight) {
+        srv->saved_weight = cur;
+    }
+    task_boost_weight(server, weight);
+    srv->lent_weight = task_get_weight(server);
+}
+
+/* Finish a receive: a request delivered directly, or the first queued caller. Lock held. */
+static task_t *_take_request_locked(task_t *self, ipc_msg_t *msg) {
+    ipc_state_t *me = task_get_ipc_state(self);
+
+    if (me->state == IPC_RECEIVED) {
+        me->state = IPC_IDLE;
+        return (task_t*)me->partner;
+    }
+
+    task_t *caller = (task_t*)_pop_from_wait_list(&me->send_head, &me->send_tail);
+    if (caller) {
+        ipc_state_t *c = task_get_ipc_state(caller);
+        *msg = *(const ipc_msg_t*)c->send_buf;
+        c->send_buf = NULL;
+        c->state = IPC_CALLING;
+        me->partner = caller;
+        me->state = IPC_IDLE;
+
+        /* An earlier reply dropped the weight this caller lent */
+        _lend_weight_locked(self, task_get_weight(caller));
+    }
+    return caller;
+}
+
+/* Deliver a reply to a caller waiting on self. Lock held. */
+static int _reply_locked(task_t *self, task_t *caller, const ipc_msg_t *reply) {
+    ipc_state_t *c = task_get_ipc_state(caller);
+    if (c->state != IPC_CALLING || c->partner != self) {
+        return -1;
+    }
+
+    *(ipc_msg_t*)c->recv_buf = *reply;
+    c->state = IPC_REPLIED;
+    ipc_state_t *me = task_get_ipc_state(self);
+    me->partner = NULL;
+
+    /* Stop running on the caller's weight. A boost it did not give (mutex PI) stays. */
+    if (me->saved_weight != 0 && task_get_weight(self) == me->lent_weight) {
+        task_set_inherited_weight(self, me->saved_weight);
+    }
+    me->saved_weight = 0;
+    return 0;
+}
+
+/* Initialize the IPC lock */
+void ipc_init(void) {
+    spinlock_init(&ipc_lock);
+    spinlock_stats_register(&ipc_lock, "ipc");
+}
+
+/* Send a request and block until the reply arrives */
+int ipc_call(task_t *server, const ipc_msg_t *msg, ipc_msg_t *reply) {
+    task_t *self = (task_t*)task_get_current();
+    if (!self || !server || server == self || !msg || !reply) {
+        return -1;
+    }
+
+    ipc_state_t *me = task_get_ipc_state(self);
+    ipc_state_t *srv = task_get_ipc_state(server);
+
+    while (1) {
+        uint32_t flags = spin_lock(&ipc_lock);
+        int direct = 0;
+
+        /* Woken by the reply */
+        if (me->state == IPC_REPLIED) {
+            me->state = IPC_IDLE;
+            me->partner = NULL;
+            spin_unlock(&ipc_lock, flags);
+            return 0;
+        }
+
+        if (me->state == IPC_IDLE) {
+            task_state_t st = task_get_state_atomic(server);
+            if (st == TASK_UNUSED || st == TASK_ZOMBIE) {
+                spin_unlock(&ipc_lock, flags);
+                return -1;
+            }
+
+            me->partner = server;
+            me->recv_buf = reply;
+            PERF_INC_LOCKED(perf_ipc_call);
+
+            if (srv->state == IPC_RECEIVING) {
+                /* Server is waiting: copy straight into its buffer */
+                *(ipc_msg_t*)srv->recv_buf = *msg;
+                srv->partner = self;
+                srv->state = IPC_RECEIVED;
+                me->state = IPC_CALLING;
+                direct = 1;
+                PERF_INC_LOCKED(perf_ipc_direct);
+            } else {
+                /* Server is busy: it copies the request when it gets to us */
+                wait_node_t *node = task_get_wait_node(self);
+                node->task = self;
+                me->send_buf = msg;
+                me->state = IPC_SENDING;
+                _add_to_wait_list(&srv->send_head, &srv->send_tail, node);
+            }
+
+            /* The server works for us now, at no less than our weight */
+            _lend_weight_locked(server, task_get_weight(self));
+        }
+
+        /* Wake the server before blocking: a tick after the unlock may switch us out */
+        if (direct) {
+            task_unblock_handoff(server);
+        }
+        task_block_on(self, server);
+        spin_unlock(&ipc_lock, flags);
+
+        /* Yield CPU until the reply arrives */
+        platform_yield();
+    }
+}
+
+/* Wait for the next request */
+task_t *ipc_receive(ipc_msg_t *msg) {
+    task_t *self = (task_t*)task_get_current();
+    if (!self || !msg) {
+        return NULL;
+    }
+
+    ipc_state_t *me = task_get_ipc_state(self);
+
+    while (1) {
+        uint32_t flags = spin_lock(&ipc_lock);
+
+        task_t *caller = _take_request_locked(self, msg);
+        if (caller) {
+            spin_unlock(&ipc_lock, flags);
+            return caller;
+        }
+
+        /* Nothing queued: callers will copy into msg directly */
+        me->recv_buf = msg;
+        me->state = IPC_RECEIVING;
+        task_block_on(self, me);
+
+        spin_unlock(&ipc_lock, flags);
+
+        /* Yield CPU until a caller arrives */
+        platform_yield();
+    }
+}
+
+/* Reply and keep running */
+int ipc_reply(task_t *caller, const ipc_msg_t *reply) {
+    task_t *self = (task_t*)task_get_current();
+    if (!self || !caller || !reply) {
+        return -1;
+    }
+
+    uint32_t flags = spin_lock(&ipc_lock);
+    int ret = _reply_locked(self, caller, reply);
+    spin_unlock(&ipc_lock, flags);
+
+    if (ret == 0) {
+        task_unblock(caller);
+    }
+    return ret;
+}
+
+/* Reply and wait for the next request, switching straight back to the caller */
+task_t *ipc_reply_wait(task_t *caller, const ipc_msg_t *reply, ipc_msg_t *msg) {
+    task_t *self = (task_t*)task_get_current();
+    if (!self || !msg) {
+        return NULL;
+    }
+
+    ipc_state_t *me = task_get_ipc_state(self);
+    uint32_t flags = spin_lock(&ipc_lock);
+
+    int replied = (caller && reply && _reply_locked(self, caller, reply) == 0);
+
+    task_t *next = _take_request_locked(self, msg);
+    if (!next) {
+        /* Hand off to the caller before blocking, as in ipc_call() */
+        if (replied) {
+            task_unblock_handoff(caller);
+        }
+        me->recv_buf = msg;
+        me->state = IPC_RECEIVING;
+        task_block_on(self, me);
+    }
+
+    spin_unlock(&ipc_lock, flags);
+
+    if (next) {
+        /* More work queued: the caller just becomes ready */
+        if (replied) {
+            task_unblock(caller);
+        }
+        return next;
+    }
+
+    platform_yield();
+    return ipc_receive(msg);
+}
@@ -0,0 +1,212 @@
+#include "irqprof.h"
+#include "arch_ops.h"
+#include "platform.h"
+#include "cli.h"
+#include "utils.h"
+
+#if IRQPROF_ENABLE
+
+/* Bounds of the record section, provided by the linker */
+extern irqprof_site_t __start_irqprof_sites[];
+extern irqprof_site_t __stop_irqprof_sites[];
+
+/* Outermost masked section on each CPU (only touched with interrupts masked) */
+static struct {
+    uint32_t depth;
+    uint32_t start;
+    irqprof_site_t *site;
+} irqprof_cpu[MAX_CPUS];
+
+IRQPROF_SITE(irqprof_tick_site, "tick latency", IRQPROF_KIND_LATENCY);
+
+/* Add one duration to a record */
+static void irqprof_record(irqprof_site_t *site, uint32_t cycles) {
+    uint32_t bucket = 0;
+    uint32_t v = cycles >> IRQPROF_HIST_SHIFT;
+
+    while (v != 0U && bucket < IRQPROF_HIST_BUCKETS - 1U) {
+        v >>= 1;
+        bucket++;
+    }
+    site->count++;
+    site->total += cycles;
+    site->hist[bucket]++;
+    if (cycles > site->max) {
+        site->max = cycles;
+    }
+}
+
+/* Called right after spin_lock() masked interrupts */
+void irqprof_lock_enter(irqprof_site_t *site) {
+    uint32_t cpu = arch_get_cpu_id();
+    if (irqprof_cpu[cpu].depth++ == 0U) {
+        irqprof_cpu[cpu].site = site;
+        irqprof_cpu[cpu].start = platform_get_cycles();
+    }
+}
+
+/* Called right before spin_unlock() restores interrupts */
+void irqprof_lock_exit(void) {
+    uint32_t cpu = arch_get_cpu_id();
+    if (irqprof_cpu[cpu].depth == 0U) {
+        return; /* Unbalanced unlock */
+    }
+    if (--irqprof_cpu[cpu].depth == 0U) {
+        irqprof_record(irqprof_cpu[cpu].site, platform_get_cycles() - irqprof_cpu[cpu].start);
+    }
+}
+
+uint32_t irqprof_isr_enter(void) {
+    return platform_get_cycles();
+}
+
+void irqprof_isr_exit(irqprof_site_t *site, uint32_t start) {
+    uint32_t now = platform_get_cycles();
+    uint32_t state = arch_irq_lock();
+    irqprof_record(site, now - start);
+    arch_irq_unlock(state);
+}
+
+void irqprof_tick_latency(uint32_t cycles) {
+    uint32_t state = arch_irq_lock();
+    irqprof_record(&irqprof_tick_site, cycles);
+    arch_irq_unlock(state);
+}
+
+uint32_t irqprof_count(void) {
+    return (uint32_t)(__stop_irqprof_sites - __start_irqprof_sites);
+}
+
+const irqprof_site_t *irqprof_get(uint32_t index) {
+    if (index >= irqprof_count()) {
+        return NULL;
+    }
+    return &__start_irqprof_sites[index];
+}
+
+void irqprof_reset(void) {
+    uint32_t state = arch_irq_lock();
+    for (irqprof_site_t *s = __start_irqprof_sites; s < __stop_irqprof_sites; s++) {
+        s->count = 0;
+        s->max = 0;
+        s->total = 0;
+        utils_memset(s->hist, 0, sizeof(s->hist));
+    }
+    arch_irq_unlock(state);
+}
+
+/* Strip the directory from a source path */
+static const char *irqprof_basename(const char *path) {
+    const char *base = path;
+    for (; *path; path++) {
+        if (*path == '/' || *path == '\\') {
+            base = path + 1;
+        }
+    }
+    return base;
+}
+
+/* Print one record: max, average, count and histogram */
+static void irqprof_print(const irqprof_site_t *s) {
+    uint32_t avg = (uint32_t)(s->total / s->count);
+
+    if (s->kind == IRQPROF_KIND_LOCK) {
+        cli_printf("%8u %8u %8u  %s (%s:%u)\r\n", s->max, avg, s->count,
+                   s->name, irqprof_basename(s->file), s->line);
+    } else {
+        cli_printf("%8u %8u %8u  %s\r\n", s->max, avg, s->count, s->name);
+    }
+    cli_printf("%26s", "");
+    for (uint32_t b = 0; b < IRQPROF_HIST_BUCKETS; b++) {
+        cli_printf(" %u", s->hist[b]);
+    }
+    cli_printf("\r\n");
+}
+
+/* Print the records of one kind, worst maximum first */
+static void irqprof_report(uint32_t kind, uint32_t top) {
+    const irqprof_site_t *shown[IRQPROF_REPORT_TOP];
+    uint32_t n = 0;
+
+    /* Keep the 'top' worst records, sorted by insertion */
+    for (const irqprof_site_t *s = __start_irqprof_sites; s < __stop_irqprof_sites; s++) {
+        if (s->kind != kind || s->count == 0U) {
+            continue;
+        }
+        uint32_t pos = n;
+        while (pos > 0U && shown[pos - 1U]->max < s->max) {
+            pos--;
+        }
+        if (pos >= top) {
+            continue;
+        }
+        if (n < top) {
+            n++;
+        }
+        for (uint32_t i = n - 1U; i > pos; i--) {
+            shown[i] = shown[i - 1U];
+        }
+        shown[pos] = s;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        irqprof_print(shown[i]);
+    }
+    if (n == 0U) {
+        cli_printf("  (none)\r\n");
+    }
+}
+
+/* CLI Command Handler: irqprof [reset | <top>] */
+static int cmd_irqprof_handler(int argc, char **argv) {
+    uint32_t top = IRQPROF_REPORT_TOP;
+
+    if (argc >= 2) {
+        if (utils_strcmp(argv[1], "reset") == 0) {
+            irqprof_reset();
+            cli_printf("IRQ profile cleared.\r\n");
+            return 0;
+        }
+        int val = utils_atoi(argv[1]);
+        if (val <= 0) {
+            cli_printf("Usage: irqprof [reset | top_n]\r\n");
+            return -1;
+        }
+        if ((uint32_t)val < top) {
+            top = (uint32_t)val;
+        }
+    }
+
+    uint32_t hz = (uint32_t)platform_get_cpu_freq();
+    if (hz) {
+        cli_printf("Cycles at %u MHz. Histogram buckets: <%u, then doubling.\r\n",
+                   hz / 1000000U, 1U << IRQPROF_HIST_SHIFT);
+    } else {
+        cli_printf("Nanoseconds (host). Histogram buckets: <%u, then doubling.\r\n",
+                   1U << IRQPROF_HIST_SHIFT);
+    }
+
+    cli_printf("\r\n--- IRQs masked by spin_lock ---\r\n");
+    cli_printf("%8s %8s %8s  %s\r\n", "Max", "Avg", "Count", "Site");
+    irqprof_report(IRQPROF_KIND_LOCK, top);
+
+    cli_printf("\r\n--- ISR execution ---\r\n");
+    irqprof_report(IRQPROF_KIND_ISR, top);
+
+    cli_printf("\r\n--- Tick to handler ---\r\n");
+    irqprof_report(IRQPROF_KIND_LATENCY, 1);
+    return 0;
+}
+
+static const cli_command_t irqprof_cmd = {
+    .name = "irqprof",
+    .help = "IRQ-off/ISR profile [reset | top_n]",
+    .handler = cmd_irqprof_handler
+};
+
+/* Register the CLI command */
+void irqprof_init(void) {
+    cli_register_command(&irqprof_cmd);
+}
+
+#endif /* IRQPROF_ENABLE */
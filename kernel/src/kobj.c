@@ -0,0 +1,120 @@
+#include "kobj.h"
+#include "scheduler.h"
+#include "queue.h"
+#include "mempool.h"
+#include "event_group.h"
+#include "timer.h"
+#include "cli.h"
+
+/*
+ * Bounds of the descriptor sections, provided by the linker. Weak, because
+ * on the host GNU ld defines them only for sections that have entries.
+ */
+extern task_static_t __start_kobj_tasks[] __attribute__((weak));
+extern task_static_t __stop_kobj_tasks[] __attribute__((weak));
+extern const queue_static_t __start_kobj_queues[] __attribute__((weak));
+extern const queue_static_t __stop_kobj_queues[] __attribute__((weak));
+extern const mempool_static_t __start_kobj_pools[] __attribute__((weak));
+extern const mempool_static_t __stop_kobj_pools[] __attribute__((weak));
+extern const event_group_static_t __start_kobj_events[] __attribute__((weak));
+extern const event_group_static_t __stop_kobj_events[] __attribute__((weak));
+extern const timer_static_t __start_kobj_timers[] __attribute__((weak));
+extern const timer_static_t __stop_kobj_timers[] __attribute__((weak));
+
+/* RAM reserved by one defined object */
+static size_t queue_bytes(const queue_static_t *d) {
+    size_t lanes = d->lane ? d->lanes * sizeof(queue_lane_t) : 0;
+    return sizeof(queue_t) + lanes + d->item_size * d->capacity * d->lanes;
+}
+
+static size_t pool_bytes(const mempool_static_t *d) {
+    return sizeof(mempool_t) + MEMPOOL_ITEM_SIZE(d->item_size) * d->count;
+}
+
+/* Objects first, then tasks, so no task can run against an uninitialised object */
+int kobj_init_static(void) {
+    int failed = 0;
+
+    for (const mempool_static_t *d = __start_kobj_pools; d < __stop_kobj_pools; d++) {
+        if (mempool_init_static(d->pool, d->buffer, d->item_size, d->count) != 0) {
+            failed++;
+        }
+    }
+    for (const queue_static_t *d = __start_kobj_queues; d < __stop_kobj_queues; d++) {
+        if (queue_init_static_prio(d->queue, d->lane, d->buffer, d->item_size, d->capacity, d->lanes) != 0) {
+            failed++;
+        }
+    }
+    for (const event_group_static_t *d = __start_kobj_events; d < __stop_kobj_events; d++) {
+        event_group_init_static(d->group);
+    }
+    for (const timer_static_t *d = __start_kobj_timers; d < __stop_kobj_timers; d++) {
+        if (timer_init_static(d->timer, d->name, d->period_ticks, d->auto_reload, d->callback, d->arg) != 0) {
+            failed++;
+        }
+    }
+    for (task_static_t *t = __start_kobj_tasks; t < __stop_kobj_tasks; t++) {
+        t->id = task_create_static(t->entry, t->arg, t->stack, t->stack_size, t->weight);
+        if (t->id < 0) {
+            failed++;
+        }
+    }
+    return failed;
+}
+
+size_t kobj_static_bytes(void) {
+    size_t total = 0;
+
+    for (const task_static_t *t = __start_kobj_tasks; t < __stop_kobj_tasks; t++) {
+        total += t->stack_size;
+    }
+    for (const queue_static_t *d = __start_kobj_queues; d < __stop_kobj_queues; d++) {
+        total += queue_bytes(d);
+    }
+    for (const mempool_static_t *d = __start_kobj_pools; d < __stop_kobj_pools; d++) {
+        total += pool_bytes(d);
+    }
+    total += (size_t)(__stop_kobj_events - __start_kobj_events) * sizeof(event_group_t);
+    total += (size_t)(__stop_kobj_timers - __start_kobj_timers) * sizeof(sw_timer_t);
+    return total;
+}
+
+static int cmd_kobj_handler(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+
+    cli_printf("%-8s %-20s %8s  %s\r\n", "Type", "Name", "Bytes", "Detail");
+    for (const task_static_t *t = __start_kobj_tasks; t < __stop_kobj_tasks; t++) {
+        cli_printf("%-8s %-20s %8u  id %d, weight %u\r\n", "task", t->name,
+                   (unsigned)t->stack_size, (int)t->id, t->weight);
+    }
+    for (const queue_static_t *d = __start_kobj_queues; d < __stop_kobj_queues; d++) {
+        cli_printf("%-8s %-20s %8u  %u x %u B, %u lane(s)\r\n", "queue", d->name,
+                   (unsigned)queue_bytes(d), (unsigned)d->capacity, (unsigned)d->item_size,
+                   (unsigned)d->lanes);
+    }
+    for (const mempool_static_t *d = __start_kobj_pools; d < __stop_kobj_pools; d++) {
+        cli_printf("%-8s %-20s %8u  %u x %u B\r\n", "pool", d->name,
+                   (unsigned)pool_bytes(d), (unsigned)d->count, (unsigned)d->item_size);
+    }
+    for (const event_group_static_t *d = __start_kobj_events; d < __stop_kobj_events; d++) {
+        cli_printf("%-8s %-20s %8u\r\n", "events", d->name, (unsigned)sizeof(event_group_t));
+    }
+    for (const timer_static_t *d = __start_kobj_timers; d < __stop_kobj_timers; d++) {
+        cli_printf("%-8s %-20s %8u  %u ticks%s\r\n", "timer", d->name, (unsigned)sizeof(sw_timer_t),
+                   d->period_ticks, d->auto_reload ? ", periodic" : "");
+    }
+    cli_printf("Total: %u bytes reserved at link time\r\n", (unsigned)kobj_static_bytes());
+    return 0;
+}
+
+static const cli_command_t kobj_cmd = {
+    .name = "kobj",
+    .help = "List statically defined kernel objects",
+    .handler = cmd_kobj_handler
+};
+
+/* Register the CLI command */
+void kobj_init(void) {
+    cli_register_command(&kobj_cmd);
+}
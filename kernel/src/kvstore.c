@@ -0,0 +1,834 @@
+#include "kvstore.h"
+#include "flash.h"
+#include "allocator.h"
+#include "mutex.h"
+#include "scheduler.h"
+#include "platform.h"
+#include "project_config.h"
+#include "logger.h"
+#include "utils.h"
+
+/*
+ * On-flash layout (all fields little-endian, FLASH_PROGRAM_UNIT aligned):
+ *
+ *   Page:   [kv_page_hdr_t 16B][retire mark 8B][record][record]...[0xFF...]
+ *   Record: [kv_rec_hdr_t 8B][key][value][pad to 8B]
+ *
+ * The retire mark stays erased while the page is in use and is programmed
+ * to zero once its live records have been copied out, just before the page
+ * is erased. A mounted page with the mark set is therefore always safe to
+ * erase.
+ */
+#define KV_PAGE_MAGIC       0x3153564BU     /* "KVS1" */
+#define KV_PAGE_MARK_OFF    16U
+#define KV_DATA_OFF         24U
+#define KV_REC_HDR_SIZE     8U
+#define KV_REC_TOMBSTONE    0x01U
+#define KV_ALIGN(n)         (((n) + (FLASH_PROGRAM_UNIT - 1U)) & ~(FLASH_PROGRAM_UNIT - 1U))
+#define KV_REC_MAX_SIZE     KV_ALIGN(KV_REC_HDR_SIZE + KVSTORE_KEY_MAX_LEN + KVSTORE_VALUE_MAX_LEN)
+#define KV_INDEX_SLOTS      (KVSTORE_MAX_KEYS * 2U)
+#define KV_RESERVE_PAGES    1U      /* Kept erased so compaction always has a target */
+#define KV_GC_FREE_TARGET   2U      /* Background GC keeps this many pages erased */
+#define KV_SLOT_EMPTY       0U
+
+#if KVSTORE_KEY_MAX_LEN > 255
+    #error "KVSTORE_KEY_MAX_LEN must fit in a byte"
+#endif
+#if (KV_DATA_OFF + KV_REC_HDR_SIZE + KVSTORE_KEY_MAX_LEN + KVSTORE_VALUE_MAX_LEN + 8) > FLASH_PAGE_SIZE
+    #error "KVSTORE key/value limits do not fit in a flash page"
+#endif
+
+typedef enum kv_page_state {
+    KV_PAGE_FREE = 0,   /* Erased, ready to open */
+    KV_PAGE_ACTIVE,     /* Holds records, part of the log */
+    KV_PAGE_STALE,      /* Retired or torn, must be erased (mount only) */
+} kv_page_state_t;
+
+typedef struct kv_page_hdr {
+    uint32_t magic;
+    uint32_t seq;           /* Age of the page in the log */
+    uint32_t erase_count;   /* Wear counter carried across erases */
+    uint32_t crc;           /* CRC over the fields above */
+} kv_page_hdr_t;
+
+typedef struct kv_rec_hdr {
+    uint32_t crc;           /* CRC over val_len..end of value */
+    uint16_t val_len;
+    uint8_t key_len;
+    uint8_t flags;
+} kv_rec_hdr_t;
+
+typedef struct kv_page {
+    uint32_t seq;
+    uint32_t erase_count;
+    uint16_t used;          /* Next append offset, FLASH_PAGE_SIZE once closed */
+    uint16_t live;          /* Bytes held by records the index points at */
+    uint8_t state;
+} kv_page_t;
+
+typedef struct kv_slot {
+    uint32_t hash;
+    uint32_t addr;          /* Record address, KV_SLOT_EMPTY if unused */
+} kv_slot_t;
+
+struct kvstore {
+    uint32_t base;
+    uint32_t page_count;
+    kv_page_t *pages;
+    int32_t head;           /* Page receiving appends, -1 if none open */
+    uint32_t next_seq;
+    uint32_t free_count;
+    uint32_t key_count;
+    uint32_t gc_runs;
+    uint32_t writes_skipped;
+    kv_slot_t index[KV_INDEX_SLOTS];
+    so_mutex_t lock;
+};
+
+static inline uint32_t _kv_page_addr(kvstore_t *kv, uint32_t page) {
+    return kv->base + page * FLASH_PAGE_SIZE;
+}
+
+static inline uint32_t _kv_page_of(kvstore_t *kv, uint32_t addr) {
+    return (addr - kv->base) / FLASH_PAGE_SIZE;
+}
+
+/* Program with the controller unlocked only for the duration of the write */
+static int _kv_program(uint32_t addr, const void *data, size_t len) {
+    flash_unlock();
+    int res = flash_program(addr, data, len);
+    flash_lock();
+    return res;
+}
+
+/* Erase a page and return it to the free pool */
+static int _kv_erase_page(kvstore_t *kv, uint32_t page) {
+    kv_page_t *pg = &kv->pages[page];
+
+    flash_unlock();
+    int res = flash_erase_page(_kv_page_addr(kv, page));
+    flash_lock();
+    if (res != 0) {
+        return KV_ERR_FLASH;
+    }
+
+    pg->erase_count++;
+    if (pg->state != KV_PAGE_FREE) {
+        pg->state = KV_PAGE_FREE;
+        kv->free_count++;
+    }
+    pg->seq = 0;
+    pg->used = 0;
+    pg->live = 0;
+    if (kv->head == (int32_t)page) {
+        kv->head = -1;
+    }
+    return KV_OK;
+}
+
+/* Check whether every byte in [addr, addr + len) is erased */
+static int _kv_is_blank(uint32_t addr, uint32_t len) {
+    uint8_t chunk[32];
+    while (len > 0U) {
+        uint32_t n = (len < sizeof(chunk)) ? len : (uint32_t)sizeof(chunk);
+        flash_read(addr, chunk, n);
+        for (uint32_t i = 0; i < n; i++) {
+            if (chunk[i] != 0xFFU) {
+                return 0;
+            }
+        }
+        addr += n;
+        len -= n;
+    }
+    return 1;
+}
+
+/*
+ * Read and validate the record at addr into buf.
+ * Returns its aligned size, 0 at the end of the log, or -1 if corrupt.
+ */
+static int _kv_read_record(uint32_t addr, uint32_t end, uint8_t *buf, kv_rec_hdr_t *hdr) {
+    if (addr + KV_REC_HDR_SIZE > end) {
+        return 0;
+    }
+    flash_read(addr, hdr, sizeof(*hdr));
+    if (hdr->crc == 0xFFFFFFFFU && hdr->val_len == 0xFFFFU &&
+        hdr->key_len == 0xFFU && hdr->flags == 0xFFU) {
+        return 0;
+    }
+    if (hdr->key_len == 0U || hdr->key_len > KVSTORE_KEY_MAX_LEN ||
+        hdr->val_len > KVSTORE_VALUE_MAX_LEN) {
+        return -1;
+    }
+
+    uint32_t size = KV_ALIGN(KV_REC_HDR_SIZE + hdr->key_len + hdr->val_len);
+    if (addr + size > end) {
+        return -1;
+    }
+    flash_read(addr, buf, size);
+    uint32_t crc = utils_crc32(0, buf + 4, 4U + hdr->key_len + hdr->val_len);
+    return (crc == hdr->crc) ? (int)size : -1;
+}
+
+/* Aligned size of a record already validated on flash */
+static uint32_t _kv_rec_size(uint32_t addr) {
+    kv_rec_hdr_t hdr;
+    flash_read(addr, &hdr, sizeof(hdr));
+    return KV_ALIGN(KV_REC_HDR_SIZE + hdr.key_len + hdr.val_len);
+}
+
+/* Compare the key stored at addr against key */
+static int _kv_key_matches(uint32_t addr, const char *key, uint32_t key_len) {
+    kv_rec_hdr_t hdr;
+    char stored[KVSTORE_KEY_MAX_LEN];
+
+    flash_read(addr, &hdr, sizeof(hdr));
+    if (hdr.key_len != key_len) {
+        return 0;
+    }
+    flash_read(addr + KV_REC_HDR_SIZE, stored, key_len);
+    for (uint32_t i = 0; i < key_len; i++) {
+        if (stored[i] != key[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Find the index slot for key, or -1 */
+static int32_t _kv_index_find(kvstore_t *kv, const char *key, uint32_t key_len, uint32_t hash) {
+    uint32_t i = hash % KV_INDEX_SLOTS;
+    for (uint32_t n = 0; n < KV_INDEX_SLOTS; n++) {
+        kv_slot_t *s = &kv->index[i];
+        if (s->addr == KV_SLOT_EMPTY) {
+            return -1;
+        }
+        if (s->hash == hash && _kv_key_matches(s->addr, key, key_len)) {
+            return (int32_t)i;
+        }
+        i = (i + 1U) % KV_INDEX_SLOTS;
+    }
+    return -1;
+}
+
+/* First empty slot on the probe path of hash (table is never more than half full) */
+static uint32_t _kv_index_free_slot(kvstore_t *kv, uint32_t hash) {
+    uint32_t i = hash % KV_INDEX_SLOTS;
+    while (kv->index[i].addr != KV_SLOT_EMPTY) {
+        i = (i + 1U) % KV_INDEX_SLOTS;
+    }
+    return i;
+}
+
+/* Remove a slot and shift later probe-chain entries back into the hole */
+static void _kv_index_remove(kvstore_t *kv, uint32_t hole) {
+    uint32_t j = hole;
+    while (1) {
+        j = (j + 1U) % KV_INDEX_SLOTS;
+        if (kv->index[j].addr == KV_SLOT_EMPTY) {
+            break;
+        }
+        uint32_t home = kv->index[j].hash % KV_INDEX_SLOTS;
+        /* Entry j may fill the hole unless its home lies cyclically in (hole, j] */
+        int movable = (j > hole) ? (home <= hole || home > j)
+                                 : (home <= hole && home > j);
+        if (movable) {
+            kv->index[hole] = kv->index[j];
+            hole = j;
+        }
+    }
+    kv->index[hole].addr = KV_SLOT_EMPTY;
+    kv->index[hole].hash = 0;
+}
+
+/* Make the record at addr the current version of its key */
+static int _kv_apply(kvstore_t *kv, uint32_t addr, const kv_rec_hdr_t *hdr, const char *key, uint32_t size) {
+    uint32_t hash = utils_fnv1a(key, hdr->key_len);
+    int32_t slot = _kv_index_find(kv, key, hdr->key_len, hash);
+
+    if (slot >= 0) {
+        uint32_t old = kv->index[slot].addr;
+        kv->pages[_kv_page_of(kv, old)].live -= (uint16_t)_kv_rec_size(old);
+        if (hdr->flags & KV_REC_TOMBSTONE) {
+            _kv_index_remove(kv, (uint32_t)slot);
+            kv->key_count--;
+            return KV_OK;
+        }
+        kv->index[slot].addr = addr;
+    } else {
+        if (hdr->flags & KV_REC_TOMBSTONE) {
+            return KV_OK;
+        }
+        if (kv->key_count >= KVSTORE_MAX_KEYS) {
+            return KV_ERR_NO_SPACE;
+        }
+        uint32_t free_slot = _kv_index_free_slot(kv, hash);
+        kv->index[free_slot].hash = hash;
+        kv->index[free_slot].addr = addr;
+        kv->key_count++;
+    }
+    kv->pages[_kv_page_of(kv, addr)].live += (uint16_t)size;
+    return KV_OK;
+}
+
+/* Oldest page in the log, or -1 */
+static int32_t _kv_oldest_page(kvstore_t *kv) {
+    int32_t oldest = -1;
+    for (uint32_t p = 0; p < kv->page_count; p++) {
+        if (kv->pages[p].state == KV_PAGE_ACTIVE &&
+            (oldest < 0 || kv->pages[p].seq < kv->pages[oldest].seq)) {
+            oldest = (int32_t)p;
+        }
+    }
+    return oldest;
+}
+
+/* Open the least-worn free page as the new head */
+static int _kv_open_page(kvstore_t *kv, uint32_t reserve) {
+    if (kv->free_count <= reserve) {
+        return KV_ERR_NO_SPACE;
+    }
+
+    int32_t best = -1;
+    for (uint32_t p = 0; p < kv->page_count; p++) {
+        if (kv->pages[p].state == KV_PAGE_FREE &&
+            (best < 0 || kv->pages[p].erase_count < kv->pages[best].erase_count)) {
+            best = (int32_t)p;
+        }
+    }
+    if (best < 0) {
+        return KV_ERR_NO_SPACE;
+    }
+
+    kv_page_t *pg = &kv->pages[best];
+    kv_page_hdr_t hdr;
+    hdr.magic = KV_PAGE_MAGIC;
+    hdr.seq = kv->next_seq;
+    hdr.erase_count = pg->erase_count;
+    hdr.crc = utils_crc32(0, &hdr, sizeof(hdr) - sizeof(hdr.crc));
+
+    if (_kv_program(_kv_page_addr(kv, (uint32_t)best), &hdr, sizeof(hdr)) != 0) {
+        return KV_ERR_FLASH;
+    }
+
+    pg->state = KV_PAGE_ACTIVE;
+    pg->seq = kv->next_seq++;
+    pg->used = KV_DATA_OFF;
+    pg->live = 0;
+    kv->free_count--;
+    kv->head = best;
+    return KV_OK;
+}
+
+static int _kv_compact(kvstore_t *kv, uint32_t victim);
+
+/* Ensure the head page has room for size bytes, compacting if needed */
+static int _kv_reserve_space(kvstore_t *kv, uint32_t size, int gc_mode) {
+    uint32_t attempts = 0;
+
+    while (1) {
+        if (kv->head >= 0 && kv->pages[kv->head].used + size <= FLASH_PAGE_SIZE) {
+            return KV_OK;
+        }
+        if (kv->free_count > (gc_mode ? 0U : KV_RESERVE_PAGES)) {
+            int res = _kv_open_page(kv, gc_mode ? 0U : KV_RESERVE_PAGES);
+            if (res != KV_OK) {
+                return res;
+            }
+            continue;
+        }
+        /* Compaction itself may only use the reserve page, never recurse */
+        if (gc_mode || attempts >= kv->page_count) {
+            return KV_ERR_NO_SPACE;
+        }
+        int32_t victim = _kv_oldest_page(kv);
+        if (victim < 0) {
+            return KV_ERR_NO_SPACE;
+        }
+        int res = _kv_compact(kv, (uint32_t)victim);
+        if (res != KV_OK) {
+            return res;
+        }
+        attempts++;
+    }
+}
+
+/* Append a fully built record at the head, returning its address */
+static int _kv_append(kvstore_t *kv, const uint8_t *rec, uint32_t size, int gc_mode, uint32_t *out_addr) {
+    int res = _kv_reserve_space(kv, size, gc_mode);
+    if (res != KV_OK) {
+        return res;
+    }
+
+    kv_page_t *pg = &kv->pages[kv->head];
+    uint32_t addr = _kv_page_addr(kv, (uint32_t)kv->head) + pg->used;
+    if (_kv_program(addr, rec, size) != 0) {
+        /* Whatever landed is garbage; never append behind it */
+        pg->used = FLASH_PAGE_SIZE;
+        return KV_ERR_FLASH;
+    }
+    pg->used = (uint16_t)(pg->used + size);
+    *out_addr = addr;
+    return KV_OK;
+}
+
+/* Copy live records out of victim, retire it and erase it */
+static int _kv_compact(kvstore_t *kv, uint32_t victim) {
+    uint8_t buf[KV_REC_MAX_SIZE];
+    kv_page_t *pg = &kv->pages[victim];
+    uint32_t base = _kv_page_addr(kv, victim);
+    int res;
+
+    if ((int32_t)victim == kv->head) {
+        res = _kv_open_page(kv, 0U);
+        if (res != KV_OK) {
+            return res;
+        }
+    }
+
+    /* Tombstones are dropped: victim is the oldest page, nothing older to shadow */
+    uint32_t off = KV_DATA_OFF;
+    while (pg->live > 0U && off < pg->used) {
+        kv_rec_hdr_t hdr;
+        int size = _kv_read_record(base + off, base + pg->used, buf, &hdr);
+        if (size <= 0) {
+            break;
+        }
+        if (!(hdr.flags & KV_REC_TOMBSTONE)) {
+            const char *key = (const char *)&buf[KV_REC_HDR_SIZE];
+            int32_t slot = _kv_index_find(kv, key, hdr.key_len, utils_fnv1a(key, hdr.key_len));
+            if (slot >= 0 && kv->index[slot].addr == base + off) {
+                uint32_t new_addr;
+                res = _kv_append(kv, buf, (uint32_t)size, 1, &new_addr);
+                if (res != KV_OK) {
+                    return res;
+                }
+                (void)_kv_apply(kv, new_addr, &hdr, key, (uint32_t)size);
+            }
+        }
+        off += (uint32_t)size;
+    }
+
+    static const uint8_t retire_mark[FLASH_PROGRAM_UNIT] = {0};
+    if (_kv_program(base + KV_PAGE_MARK_OFF, retire_mark, sizeof(retire_mark)) != 0) {
+        return KV_ERR_FLASH;
+    }
+    res = _kv_erase_page(kv, victim);
+    if (res != KV_OK) {
+        return res;
+    }
+    kv->gc_runs++;
+#if LOG_ENABLE
+    LOG_INF(STORAGE, "KV GC page %u erases %u", victim, kv->pages[victim].erase_count);
+#endif
+    return KV_OK;
+}
+
+/* Replay the records of an active page into the index */
+static void _kv_replay_page(kvstore_t *kv, uint32_t page) {
+    uint8_t buf[KV_REC_MAX_SIZE];
+    uint32_t base = _kv_page_addr(kv, page);
+    uint32_t off = KV_DATA_OFF;
+
+    while (1) {
+        kv_rec_hdr_t hdr;
+        int size = _kv_read_record(base + off, base + FLASH_PAGE_SIZE, buf, &hdr);
+        if (size == 0) {
+            break;
+        }
+        if (size < 0) {
+            /* Torn append: close the page, its valid prefix stays usable */
+            off = FLASH_PAGE_SIZE;
+            break;
+        }
+        (void)_kv_apply(kv, base + off, &hdr, (const char *)&buf[KV_REC_HDR_SIZE], (uint32_t)size);
+        off += (uint32_t)size;
+    }
+    kv->pages[page].used = (uint16_t)off;
+}
+
+/* Classify pages, finish interrupted compactions and rebuild the index */
+static int _kv_mount(kvstore_t *kv) {
+    uint32_t max_erase = 0;
+    uint32_t max_seq = 0;
+
+    kv->head = -1;
+    kv->free_count = 0;
+    kv->key_count = 0;
+    utils_memset(kv->index, 0, sizeof(kv->index));
+
+    for (uint32_t p = 0; p < kv->page_count; p++) {
+        kv_page_t *pg = &kv->pages[p];
+        uint32_t addr = _kv_page_addr(kv, p);
+        kv_page_hdr_t hdr;
+        uint8_t mark[FLASH_PROGRAM_UNIT];
+
+        flash_read(addr, &hdr, sizeof(hdr));
+        flash_read(addr + KV_PAGE_MARK_OFF, mark, sizeof(mark));
+
+        pg->seq = 0;
+        pg->erase_count = 0;
+        pg->used = FLASH_PAGE_SIZE;
+        pg->live = 0;
+
+        if (hdr.magic == KV_PAGE_MAGIC &&
+            hdr.crc == utils_crc32(0, &hdr, sizeof(hdr) - sizeof(hdr.crc))) {
+            pg->erase_count = hdr.erase_count;
+            if (hdr.erase_count > max_erase) {
+                max_erase = hdr.erase_count;
+            }
+            if (_kv_is_blank(addr + KV_PAGE_MARK_OFF, sizeof(mark))) {
+                pg->state = KV_PAGE_ACTIVE;
+                pg->seq = hdr.seq;
+                if (hdr.seq > max_seq) {
+                    max_seq = hdr.seq;
+                }
+            } else {
+                pg->state = KV_PAGE_STALE;
+            }
+        } else if (_kv_is_blank(addr, FLASH_PAGE_SIZE)) {
+            pg->state = KV_PAGE_FREE;
+            kv->free_count++;
+        } else {
+            /* Torn header program or torn erase */
+            pg->state = KV_PAGE_STALE;
+        }
+    }
+
+    /* Wear of pages without a header is unknown; assume the worst seen */
+    for (uint32_t p = 0; p < kv->page_count; p++) {
+        kv_page_t *pg = &kv->pages[p];
+        if (pg->state != KV_PAGE_ACTIVE && pg->erase_count < max_erase) {
+            pg->erase_count = max_erase;
+        }
+        if (pg->state == KV_PAGE_STALE && _kv_erase_page(kv, p) != KV_OK) {
+            return KV_ERR_FLASH;
+        }
+    }
+
+    /* Replay oldest to newest so later records win */
+    uint32_t prev_seq = 0;
+    while (1) {
+        int32_t next = -1;
+        for (uint32_t p = 0; p < kv->page_count; p++) {
+            kv_page_t *pg = &kv->pages[p];
+            if (pg->state == KV_PAGE_ACTIVE && pg->seq > prev_seq &&
+                (next < 0 || pg->seq < kv->pages[next].seq)) {
+                next = (int32_t)p;
+            }
+        }
+        if (next < 0) {
+            break;
+        }
+        _kv_replay_page(kv, (uint32_t)next);
+        prev_seq = kv->pages[next].seq;
+        kv->head = next;
+    }
+
+    kv->next_seq = max_seq + 1U;
+    return KV_OK;
+}
+
+/* Compare the value stored at addr with a candidate value */
+static int _kv_value_equals(uint32_t addr, const void *value, size_t len) {
+    kv_rec_hdr_t hdr;
+    uint8_t chunk[32];
+    const uint8_t *v = (const uint8_t *)value;
+
+    flash_read(addr, &hdr, sizeof(hdr));
+    if (hdr.val_len != len) {
+        return 0;
+    }
+    uint32_t src = addr + KV_REC_HDR_SIZE + hdr.key_len;
+    size_t off = 0;
+    while (off < len) {
+        size_t n = ((len - off) < sizeof(chunk)) ? (len - off) : sizeof(chunk);
+        flash_read(src + off, chunk, n);
+        for (size_t i = 0; i < n; i++) {
+            if (chunk[i] != v[off + i]) {
+                return 0;
+            }
+        }
+        off += n;
+    }
+    return 1;
+}
+
+/* Build a record in RAM, append it and index it */
+static int _kv_write_record(kvstore_t *kv, const char *key, uint32_t key_len,
+                            const void *value, uint32_t len, uint8_t flags) {
+    uint8_t buf[KV_REC_MAX_SIZE];
+    kv_rec_hdr_t hdr;
+    uint32_t size = KV_ALIGN(KV_REC_HDR_SIZE + key_len + len);
+
+    utils_memset(buf, 0xFF, size);
+    hdr.crc = 0;
+    hdr.val_len = (uint16_t)len;
+    hdr.key_len = (uint8_t)key_len;
+    hdr.flags = flags;
+    utils_memcpy(buf, &hdr, sizeof(hdr));
+    utils_memcpy(&buf[KV_REC_HDR_SIZE], key, key_len);
+    if (len > 0U) {
+        utils_memcpy(&buf[KV_REC_HDR_SIZE + key_len], value, len);
+    }
+    hdr.crc = utils_crc32(0, &buf[4], 4U + key_len + len);
+    utils_memcpy(buf, &hdr.crc, sizeof(hdr.crc));
+
+    uint32_t addr;
+    int res = _kv_append(kv, buf, size, 0, &addr);
+    if (res != KV_OK) {
+        return res;
+    }
+    return _kv_apply(kv, addr, &hdr, key, size);
+}
+
+/* Validate a key and return its length, or a negative status */
+static int _kv_check_key(const char *key) {
+    if (!key) {
+        return KV_ERR_INVALID;
+    }
+    size_t key_len = utils_strlen(key);
+    if (key_len == 0U) {
+        return KV_ERR_INVALID;
+    }
+    if (key_len > KVSTORE_KEY_MAX_LEN) {
+        return KV_ERR_TOO_LARGE;
+    }
+    return (int)key_len;
+}
+
+/* Create a store over a page range and mount it */
+kvstore_t *kvstore_create(uint32_t base_addr, uint32_t page_count) {
+    if (page_count < 2U || (base_addr % FLASH_PAGE_SIZE) != 0U) {
+        return NULL;
+    }
+
+    kvstore_t *kv = (kvstore_t *)allocator_malloc(sizeof(kvstore_t));
+    if (!kv) {
+        return NULL;
+    }
+    utils_memset(kv, 0, sizeof(kvstore_t));
+
+    kv->pages = (kv_page_t *)allocator_malloc(sizeof(kv_page_t) * page_count);
+    if (!kv->pages) {
+        allocator_free(kv);
+        return NULL;
+    }
+    kv->base = base_addr;
+    kv->page_count = page_count;
+    so_mutex_init(&kv->lock);
+
+    if (_kv_mount(kv) != KV_OK) {
+        allocator_free(kv->pages);
+        allocator_free(kv);
+#if LOG_ENABLE
+        LOG_ERR(STORAGE, "KV Mount Fail addr:%x pages:%u", base_addr, page_count);
+#endif
+        return NULL;
+    }
+#if LOG_ENABLE
+    LOG_INF(STORAGE, "KV Mounted %u keys, %u free pages", kv->key_count, kv->free_count);
+#endif
+    return kv;
+}
+
+/* Release RAM state */
+void kvstore_destroy(kvstore_t *kv) {
+    if (!kv) {
+        return;
+    }
+    allocator_free(kv->pages);
+    allocator_free(kv);
+}
+
+/* Insert or update a key */
+int kvstore_set(kvstore_t *kv, const char *key, const void *value, size_t len) {
+    if (!kv || (!value && len > 0U)) {
+        return KV_ERR_INVALID;
+    }
+    int key_len = _kv_check_key(key);
+    if (key_len < 0) {
+        return key_len;
+    }
+    if (len > KVSTORE_VALUE_MAX_LEN) {
+        return KV_ERR_TOO_LARGE;
+    }
+
+    so_mutex_lock(&kv->lock);
+
+    int res;
+    int32_t slot = _kv_index_find(kv, key, (uint32_t)key_len, utils_fnv1a(key, (uint32_t)key_len));
+    if (slot >= 0 && _kv_value_equals(kv->index[slot].addr, value, len)) {
+        kv->writes_skipped++;
+        res = KV_OK;
+    } else if (slot < 0 && kv->key_count >= KVSTORE_MAX_KEYS) {
+        res = KV_ERR_NO_SPACE;
+    } else {
+        /* Refuse early if live data cannot fit even after full compaction */
+        uint32_t size = KV_ALIGN(KV_REC_HDR_SIZE + (uint32_t)key_len + (uint32_t)len);
+        uint32_t capacity = (kv->page_count - KV_RESERVE_PAGES) * (FLASH_PAGE_SIZE - KV_DATA_OFF);
+        uint32_t live = size;
+        for (uint32_t p = 0; p < kv->page_count; p++) {
+            live += kv->pages[p].live;
+        }
+        if (slot >= 0) {
+            live -= _kv_rec_size(kv->index[slot].addr);
+        }
+        if (live > capacity) {
+            res = KV_ERR_NO_SPACE;
+        } else {
+            res = _kv_write_record(kv, key, (uint32_t)key_len, value, (uint32_t)len, 0);
+        }
+    }
+
+    so_mutex_unlock(&kv->lock);
+    return res;
+}
+
+/* Read a key */
+int kvstore_get(kvstore_t *kv, const char *key, void *buf, size_t buf_len) {
+    if (!kv || (!buf && buf_len > 0U)) {
+        return KV_ERR_INVALID;
+    }
+    int key_len = _kv_check_key(key);
+    if (key_len < 0) {
+        return key_len;
+    }
+
+    so_mutex_lock(&kv->lock);
+
+    int res = KV_ERR_NOT_FOUND;
+    int32_t slot = _kv_index_find(kv, key, (uint32_t)key_len, utils_fnv1a(key, (uint32_t)key_len));
+    if (slot >= 0) {
+        kv_rec_hdr_t hdr;
+        uint32_t addr = kv->index[slot].addr;
+        flash_read(addr, &hdr, sizeof(hdr));
+        size_t n = (hdr.val_len < buf_len) ? hdr.val_len : buf_len;
+        if (n > 0U) {
+            flash_read(addr + KV_REC_HDR_SIZE + hdr.key_len, buf, n);
+        }
+        res = (int)hdr.val_len;
+    }
+
+    so_mutex_unlock(&kv->lock);
+    return res;
+}
+
+/* Delete a key by appending a tombstone */
+int kvstore_delete(kvstore_t *kv, const char *key) {
+    if (!kv) {
+        return KV_ERR_INVALID;
+    }
+    int key_len = _kv_check_key(key);
+    if (key_len < 0) {
+        return key_len;
+    }
+
+    so_mutex_lock(&kv->lock);
+
+    int res = KV_ERR_NOT_FOUND;
+    if (_kv_index_find(kv, key, (uint32_t)key_len, utils_fnv1a(key, (uint32_t)key_len)) >= 0) {
+        res = _kv_write_record(kv, key, (uint32_t)key_len, NULL, 0, KV_REC_TOMBSTONE);
+    }
+
+    so_mutex_unlock(&kv->lock);
+    return res;
+}
+
+/* Erase all pages and drop every key */
+int kvstore_format(kvstore_t *kv) {
+    if (!kv) {
+        return KV_ERR_INVALID;
+    }
+
+    so_mutex_lock(&kv->lock);
+
+    int res = KV_OK;
+    for (uint32_t p = 0; p < kv->page_count && res == KV_OK; p++) {
+        res = _kv_erase_page(kv, p);
+    }
+    utils_memset(kv->index, 0, sizeof(kv->index));
+    kv->key_count = 0;
+    kv->head = -1;
+    kv->next_seq = 1;
+
+    so_mutex_unlock(&kv->lock);
+    return res;
+}
+
+/* Compact the oldest page if free pages are running low */
+int kvstore_gc_step(kvstore_t *kv) {
+    if (!kv) {
+        return KV_ERR_INVALID;
+    }
+
+    so_mutex_lock(&kv->lock);
+
+    int res = 0;
+    if (kv->free_count < KV_GC_FREE_TARGET) {
+        int32_t victim = _kv_oldest_page(kv);
+        /* Only worth an erase if the page holds superseded data */
+        if (victim >= 0 && victim != kv->head &&
+            kv->pages[victim].live < kv->pages[victim].used - KV_DATA_OFF) {
+            res = _kv_compact(kv, (uint32_t)victim);
+            if (res == KV_OK) {
+                res = 1;
+            }
+        }
+    }
+
+    so_mutex_unlock(&kv->lock);
+    return res;
+}
+
+/* Background compaction loop */
+static void kvstore_gc_task_entry(void *arg) {
+    kvstore_t *kv = (kvstore_t *)arg;
+
+    while (1) {
+        task_sleep_ticks(KVSTORE_GC_PERIOD_TICKS);
+        (void)kvstore_gc_step(kv);
+    }
+}
+
+/* Start the background compaction task */
+int32_t kvstore_start_gc_task(kvstore_t *kv) {
+    if (!kv) {
+        return -1;
+    }
+    return task_create(kvstore_gc_task_entry, kv, STACK_SIZE_1KB, TASK_WEIGHT_LOW);
+}
+
+/* Gather usage and wear statistics */
+int kvstore_get_stats(kvstore_t *kv, kvstore_stats_t *stats) {
+    if (!kv || !stats) {
+        return -1;
+    }
+
+    so_mutex_lock(&kv->lock);
+
+    utils_memset(stats, 0, sizeof(*stats));
+    stats->keys = kv->key_count;
+    stats->pages_total = kv->page_count;
+    stats->pages_free = kv->free_count;
+    stats->gc_runs = kv->gc_runs;
+    stats->writes_skipped = kv->writes_skipped;
+    stats->erase_min = 0xFFFFFFFFU;
+
+    for (uint32_t p = 0; p < kv->page_count; p++) {
+        kv_page_t *pg = &kv->pages[p];
+        stats->live_bytes += pg->live;
+        if (pg->state == KV_PAGE_ACTIVE) {
+            stats->used_bytes += pg->used;
+        }
+        if (pg->erase_count < stats->erase_min) {
+            stats->erase_min = pg->erase_count;
+        }
+        if (pg->erase_count > stats->erase_max) {
+            stats->erase_max = pg->erase_count;
+        }
+    }
+
+    so_mutex_unlock(&kv->lock);
+    return 0;
+}
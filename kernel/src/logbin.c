@@ -0,0 +1,364 @@
+#include "logbin.h"
+#include "arch_ops.h"
+#include "cli.h"
+#include "mutex.h"
+#include "platform.h"
+#include "scheduler.h"
+#include "uart.h"
+#include "utils.h"
+
+#if LOGBIN_ENABLE
+
+/*
+ * Ring records, in 32-bit words:
+ *
+ *   [hdr][timestamp][sig][args...]
+ *
+ *   hdr = ((id + 1) << 8) | total words. It is written last, so a zero
+ *   header means the record is reserved but not yet committed. A record
+ *   never wraps; the unused end of the ring is covered by LB_HDR_PAD.
+ *
+ * Args: 32-bit values take one word, 64-bit values two (low first),
+ * strings a length word followed by the bytes padded to a word.
+ *
+ * Output frames (before COBS encoding), all integers LEB128 varints:
+ *
+ *   record:  id + 1, timestamp, sig, args
+ *            (i32/i64 zig-zag, u32/u64 plain, f64 8 raw bytes,
+ *             str length + bytes)
+ *   control: 0, LB_CTRL_DROPPED, count
+ */
+#define LB_HDR_PAD          0xFFFFFFFFU
+#define LB_REC_WORDS        3U
+#define LB_RING_MASK        (LOGBIN_BUFFER_WORDS - 1U)
+#define LB_CTRL_DROPPED     1U
+#define LB_FRAME_MAX        (16U + LOGBIN_MAX_ARGS * (LOGBIN_STR_MAX + 2U))
+#define LB_COBS_MAX         (LB_FRAME_MAX + (LB_FRAME_MAX / 254U) + 2U)
+
+#if (LOGBIN_BUFFER_WORDS & (LOGBIN_BUFFER_WORDS - 1)) != 0 || LOGBIN_BUFFER_WORDS < 128
+    #error "LOGBIN_BUFFER_WORDS must be a power of 2, at least 128"
+#endif
+
+typedef struct lb_ring {
+    volatile uint32_t head;     /* Next word to reserve (free running) */
+    volatile uint32_t tail;     /* Next word to consume (free running) */
+    volatile uint32_t records;
+    volatile uint32_t dropped;
+    uint32_t dropped_reported;  /* Drain side only */
+    volatile uint32_t buf[LOGBIN_BUFFER_WORDS];
+} lb_ring_t;
+
+static lb_ring_t lb_rings[MAX_CPUS];
+static uint32_t lb_frames = 0;
+static uint32_t lb_bytes_out = 0;
+static so_mutex_t lb_drain_lock;
+static logbin_sink_fn_t lb_task_sink = NULL;
+static void *lb_task_ctx = NULL;
+
+static inline uint32_t _lb_tag(uint32_t sig, uint32_t i) {
+    return (sig >> (4U + 3U * i)) & 0x7U;
+}
+
+/* Append a record to the current CPU's ring */
+void logbin_write(uint32_t id, uint32_t sig, const uint64_t *vals) {
+    uint32_t nargs = sig & 0xFU;
+    uint32_t slen[LOGBIN_MAX_ARGS];
+    uint32_t words = LB_REC_WORDS;
+
+    if (nargs > LOGBIN_MAX_ARGS) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < nargs; i++) {
+        uint32_t tag = _lb_tag(sig, i);
+        if (tag == LOGBIN_T_STR) {
+            const char *s = (const char *)(uintptr_t)vals[i];
+            uint32_t len = 0;
+            if (s) {
+                while (len < LOGBIN_STR_MAX && s[len] != '\0') {
+                    len++;
+                }
+            }
+            slen[i] = len;
+            words += 1U + ((len + 3U) >> 2);
+        } else {
+            words += (tag == LOGBIN_T_U32 || tag == LOGBIN_T_I32) ? 1U : 2U;
+        }
+    }
+
+    lb_ring_t *r = &lb_rings[arch_get_cpu_id()];
+    uint32_t head, idx, pad;
+
+    /* Reserve contiguous words; nested writers simply retry */
+    do {
+        head = r->head;
+        idx = head & LB_RING_MASK;
+        pad = (idx + words > LOGBIN_BUFFER_WORDS) ? (LOGBIN_BUFFER_WORDS - idx) : 0U;
+        if (head + pad + words - r->tail > LOGBIN_BUFFER_WORDS) {
+            arch_atomic_add(&r->dropped, 1U);
+            return;
+        }
+    } while (!arch_atomic_cas(&r->head, head, head + pad + words));
+
+    if (pad) {
+        r->buf[idx] = LB_HDR_PAD;
+        idx = 0;
+    }
+
+    volatile uint32_t *w = &r->buf[idx];
+    uint32_t k = LB_REC_WORDS;
+    w[1] = (uint32_t)platform_get_ticks();
+    w[2] = sig;
+    for (uint32_t i = 0; i < nargs; i++) {
+        uint32_t tag = _lb_tag(sig, i);
+        if (tag == LOGBIN_T_STR) {
+            const uint8_t *s = (const uint8_t *)(uintptr_t)vals[i];
+            w[k++] = slen[i];
+            for (uint32_t b = 0; b < slen[i]; b += 4U) {
+                uint32_t word = 0;
+                for (uint32_t j = 0; j < 4U && b + j < slen[i]; j++) {
+                    word |= (uint32_t)s[b + j] << (8U * j);
+                }
+                w[k++] = word;
+            }
+        } else if (tag == LOGBIN_T_U32 || tag == LOGBIN_T_I32) {
+            w[k++] = (uint32_t)vals[i];
+        } else {
+            w[k++] = (uint32_t)vals[i];
+            w[k++] = (uint32_t)(vals[i] >> 32);
+        }
+    }
+
+    /* Publish: payload must be visible before the header */
+    arch_memory_barrier();
+    w[0] = ((id + 1U) << 8) | words;
+    arch_atomic_add(&r->records, 1U);
+}
+
+/* Append an unsigned LEB128 varint */
+static uint32_t _lb_put_varint(uint8_t *out, uint64_t v) {
+    uint32_t n = 0;
+    while (v >= 0x80U) {
+        out[n++] = (uint8_t)(v | 0x80U);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+/* Convert a ring record into a frame, returns its length */
+static uint32_t _lb_encode_record(const volatile uint32_t *w, uint8_t *out) {
+    uint32_t sig = w[2];
+    uint32_t nargs = sig & 0xFU;
+    uint32_t k = LB_REC_WORDS;
+    uint32_t n = 0;
+
+    n += _lb_put_varint(&out[n], w[0] >> 8);
+    n += _lb_put_varint(&out[n], w[1]);
+    n += _lb_put_varint(&out[n], sig);
+
+    for (uint32_t i = 0; i < nargs; i++) {
+        uint32_t tag = _lb_tag(sig, i);
+        if (tag == LOGBIN_T_U32) {
+            n += _lb_put_varint(&out[n], w[k++]);
+        } else if (tag == LOGBIN_T_I32) {
+            int32_t v = (int32_t)w[k++];
+            n += _lb_put_varint(&out[n], ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+        } else if (tag == LOGBIN_T_STR) {
+            uint32_t len = w[k++];
+            n += _lb_put_varint(&out[n], len);
+            for (uint32_t b = 0; b < len; b++) {
+                out[n++] = (uint8_t)(w[k + (b >> 2)] >> (8U * (b & 3U)));
+            }
+            k += (len + 3U) >> 2;
+        } else {
+            uint64_t v = (uint64_t)w[k] | ((uint64_t)w[k + 1] << 32);
+            k += 2;
+            if (tag == LOGBIN_T_I64) {
+                v = (v << 1) ^ (uint64_t)((int64_t)v >> 63);
+                n += _lb_put_varint(&out[n], v);
+            } else if (tag == LOGBIN_T_U64) {
+                n += _lb_put_varint(&out[n], v);
+            } else {
+                for (uint32_t b = 0; b < 8U; b++) {
+                    out[n++] = (uint8_t)(v >> (8U * b));
+                }
+            }
+        }
+    }
+    return n;
+}
+
+/* COBS encode a frame, add the 0x00 delimiter and hand it to the sink */
+static int32_t _lb_emit(const uint8_t *in, uint32_t len, logbin_sink_fn_t sink, void *ctx) {
+    static uint8_t cobs[LB_COBS_MAX];
+    uint32_t out = (uint32_t)utils_cobs_encode(in, len, cobs);
+
+    if (sink(ctx, cobs, out) != 0) {
+        return -1;
+    }
+    lb_frames++;
+    lb_bytes_out += out;
+    return (int32_t)out;
+}
+
+/* Encode committed records of every ring */
+int32_t logbin_drain(logbin_sink_fn_t sink, void *ctx) {
+    static uint8_t frame[LB_FRAME_MAX];
+    int32_t total = 0;
+
+    if (!sink) {
+        return -1;
+    }
+
+    so_mutex_lock(&lb_drain_lock);
+
+    for (uint32_t cpu = 0; cpu < MAX_CPUS && total >= 0; cpu++) {
+        lb_ring_t *r = &lb_rings[cpu];
+
+        while (r->tail != r->head) {
+            uint32_t idx = r->tail & LB_RING_MASK;
+            uint32_t hdr = r->buf[idx];
+            uint32_t words;
+
+            if (hdr == 0U) {
+                break;  /* Oldest record still being written */
+            }
+            arch_memory_barrier();
+
+            if (hdr == LB_HDR_PAD) {
+                words = LOGBIN_BUFFER_WORDS - idx;
+            } else {
+                words = hdr & 0xFFU;
+                int32_t n = _lb_emit(frame, _lb_encode_record(&r->buf[idx], frame), sink, ctx);
+                if (n < 0) {
+                    total = -1;
+                    break;
+                }
+                total += n;
+            }
+
+            /* Zero the slot so a later lap sees uncommitted headers */
+            for (uint32_t i = 0; i < words; i++) {
+                r->buf[idx + i] = 0;
+            }
+            arch_memory_barrier();
+            r->tail += words;
+        }
+
+        uint32_t dropped = r->dropped;
+        if (total >= 0 && dropped != r->dropped_reported) {
+            uint32_t n = 0;
+            n += _lb_put_varint(&frame[n], 0);
+            n += _lb_put_varint(&frame[n], LB_CTRL_DROPPED);
+            n += _lb_put_varint(&frame[n], dropped - r->dropped_reported);
+            int32_t res = _lb_emit(frame, n, sink, ctx);
+            if (res < 0) {
+                total = -1;
+            } else {
+                r->dropped_reported = dropped;
+                total += res;
+            }
+        }
+    }
+
+    so_mutex_unlock(&lb_drain_lock);
+    return total;
+}
+
+/* Periodically drain the rings into the configured sink */
+static void logbin_task_entry(void *arg) {
+    (void)arg;
+    while (1) {
+        logbin_drain(lb_task_sink, lb_task_ctx);
+        task_sleep_ticks(LOGBIN_DRAIN_PERIOD_TICKS);
+    }
+}
+
+/* Start the background drain task */
+int32_t logbin_start_task(logbin_sink_fn_t sink, void *ctx) {
+    if (!sink || lb_task_sink) {
+        return -1;
+    }
+    lb_task_sink = sink;
+    lb_task_ctx = ctx;
+    return task_create(logbin_task_entry, NULL, STACK_SIZE_1KB, TASK_WEIGHT_LOW);
+}
+
+/* Write encoded frames to a UART */
+int logbin_uart_sink(void *ctx, const uint8_t *data, size_t len) {
+    return (uart_write_buffer((uart_port_t)ctx, (const char *)data, len) < 0) ? -1 : 0;
+}
+
+void logbin_get_stats(logbin_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+    utils_memset(stats, 0, sizeof(*stats));
+    for (uint32_t cpu = 0; cpu < MAX_CPUS; cpu++) {
+        stats->records += lb_rings[cpu].records;
+        stats->dropped += lb_rings[cpu].dropped;
+    }
+    stats->frames = lb_frames;
+    stats->bytes_out = lb_bytes_out;
+}
+
+/* Print frames as hex, one per line */
+static int logbin_hex_sink(void *ctx, const uint8_t *data, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    char line[2 * 32 + 1];
+    uint32_t pos = 0;
+    (void)ctx;
+
+    for (size_t i = 0; i < len; i++) {
+        line[pos++] = hex[data[i] >> 4];
+        line[pos++] = hex[data[i] & 0x0F];
+        if (pos == sizeof(line) - 1U || i + 1U == len) {
+            line[pos] = '\0';
+            cli_printf("%s", line);
+            pos = 0;
+        }
+    }
+    cli_printf("\r\n");
+    return 0;
+}
+
+/* CLI Command Handler: logbin [dump] */
+static int cmd_logbin_handler(int argc, char **argv) {
+    logbin_stats_t st;
+
+    if (argc >= 2 && utils_strcmp(argv[1], "dump") == 0) {
+        if (lb_task_sink) {
+            cli_printf("Drain task owns the stream.\r\n");
+            return 0;
+        }
+        cli_printf("--- Binary Log (hex COBS frames) ---\r\n");
+        logbin_drain(logbin_hex_sink, NULL);
+        cli_printf("--- End ---\r\n");
+        return 0;
+    }
+
+    logbin_get_stats(&st);
+    cli_printf("Records: %u  Dropped: %u  Frames: %u  Bytes: %u\r\n",
+               st.records, st.dropped, st.frames, st.bytes_out);
+    return 0;
+}
+
+static const cli_command_t logbin_cmd = {
+    .name = "logbin",
+    .help = "Binary log stats [dump]",
+    .handler = cmd_logbin_handler
+};
+
+/* Reset the rings and register the CLI command */
+void logbin_init(void) {
+    utils_memset((void *)lb_rings, 0, sizeof(lb_rings));
+    lb_frames = 0;
+    lb_bytes_out = 0;
+    lb_task_sink = NULL;
+    lb_task_ctx = NULL;
+    so_mutex_init(&lb_drain_lock);
+    cli_register_command(&logbin_cmd);
+}
+
+#endif /* LOGBIN_ENABLE */
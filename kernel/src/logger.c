@@ -1,5 +1,7 @@
 #include "logger.h"
-#include "queue.h"
+#include "logstore.h"
+#include "arch_ops.h"
+#include "mutex.h"
 #include "scheduler.h"
 #include "platform.h"
 #include "cli.h"
@@ -7,45 +9,278 @@
 
 #if LOG_ENABLE
 
-static queue_t *log_queue = NULL;
+#if (LOG_QUEUE_SIZE & (LOG_QUEUE_SIZE - 1)) != 0 || LOG_QUEUE_SIZE < 2
+    #error "LOG_QUEUE_SIZE must be a power of 2"
+#endif
+
+#define LOG_RING_MASK   (LOG_QUEUE_SIZE - 1U)
+
+/*
+ * Bounded MPSC ring. Each slot carries a sequence number:
+ *   seq == pos              slot free for the producer that reserves pos
+ *   seq == pos + 1          entry published, consumer may read it
+ *   seq == pos + SIZE       consumed, free for the next lap
+ * Producers reserve a position with a CAS on head and publish by writing
+ * seq last, so an ISR that preempts a half-written entry takes the next
+ * slot instead of waiting. A preempted producer only delays the consumer.
+ */
+typedef struct {
+    volatile uint32_t seq;
+    log_entry_t entry;
+} log_slot_t;
+
+static log_slot_t log_ring[LOG_QUEUE_SIZE];
+static volatile uint32_t log_ring_head = 0;  /* Next position to reserve */
+static uint32_t log_ring_tail = 0;           /* Next position to consume */
+static volatile uint32_t log_dropped = 0;    /* Entries lost to a full ring */
+static uint32_t log_dropped_reported = 0;    /* Consumer side */
+static uint8_t log_ready = 0;
+static so_mutex_t log_drain_lock;            /* Serialises consumers */
+static uint16_t log_task_id = 0;             /* Logger task, woken on the first entry */
+static volatile uint32_t log_waiting = 0;    /* 1 while the logger task sleeps on an empty ring */
+
+volatile uint8_t log_module_level[LOG_MOD_COUNT];
+
+static const uint8_t log_level_ceiling[LOG_MOD_COUNT] = {
+    LOG_LEVEL_KERNEL, LOG_LEVEL_MEM, LOG_LEVEL_STORAGE, LOG_LEVEL_DRIVER, LOG_LEVEL_APP
+};
+static const char *const log_module_names[LOG_MOD_COUNT] = {
+    "kernel", "mem", "storage", "driver", "app"
+};
+static const char *const log_level_names[] = { "none", "error", "warn", "info", "debug" };
+static const char log_level_chars[] = "-EWID";
 
 /* Circular buffer for log history */
 static log_entry_t log_history[LOG_HISTORY_SIZE];
 static uint32_t log_head = 0;   /* Write index */
 static uint32_t log_count = 0;  /* Total items in buffer */
 static uint8_t log_live = 0;    /* 0 = Saved only, 1 = Print immediately */
+#if LOG_STORE_ENABLE
+static logstore_t *log_store = NULL; /* Optional flash sink */
+#endif
+
+/* Print "[s.ms] L module: " ahead of a message */
+static void logger_print_prefix(const log_entry_t *e) {
+    uint8_t lvl = (e->level <= LOG_LEVEL_DEBUG) ? e->level : LOG_LEVEL_NONE;
+    const char *mod = (e->module < LOG_MOD_COUNT) ? log_module_names[e->module] : "?";
+
+    cli_printf("[%u.%03u] %c %s: ", e->timestamp / 1000, e->timestamp % 1000,
+               log_level_chars[lvl], mod);
+}
+
+/* Save an entry to the history, the flash store and the live console */
+static void logger_process_entry(const log_entry_t *entry) {
+    /* Save to history buffer */
+    log_history[log_head] = *entry;
+    log_head = (log_head + 1) % LOG_HISTORY_SIZE;
+    if (log_count < LOG_HISTORY_SIZE) {
+        log_count++;
+    }
+
+#if LOG_STORE_ENABLE
+    if (log_store) {
+        logstore_append(log_store, entry);
+    }
+#endif
 
+    /* If live mode is enabled, print immediately */
+    if (log_live) {
+        logger_print_prefix(entry);
+        cli_printf(entry->fmt, entry->arg1, entry->arg2);
+        cli_printf("\r\n");
+    }
+}
+
+/* Report entries lost since the last drain as a log entry of its own */
+static void logger_report_drops(void) {
+    uint32_t dropped = log_dropped;
+
+    if (dropped != log_dropped_reported) {
+        log_entry_t entry;
+        entry.timestamp = (uint32_t)platform_get_ticks();
+        entry.module = LOG_MOD_KERNEL;
+        entry.level = LOG_LEVEL_WARN;
+        entry.fmt = "*** %u log entries dropped ***";
+        entry.arg1 = dropped - log_dropped_reported;
+        entry.arg2 = 0;
+        log_dropped_reported = dropped;
+        logger_process_entry(&entry);
+    }
+}
+
+/* Move everything in the ring to the history, store and console */
+static void logger_drain(void) {
+    log_entry_t entry;
+
+    so_mutex_lock(&log_drain_lock);
+    while (logger_pop(&entry) == 0) {
+        logger_process_entry(&entry);
+    }
+    logger_report_drops();
+    so_mutex_unlock(&log_drain_lock);
+}
+
+/* Check whether the oldest ring position holds a published entry */
+static int logger_ring_empty(void) {
+    return log_ring[log_ring_tail & LOG_RING_MASK].seq != log_ring_tail + 1U;
+}
+
+/*
+ * Sleep until a producer publishes into the empty ring. The flag is raised
+ * before the ring is checked and producers check it after publishing, so
+ * either the check sees the entry or the producer sees the flag.
+ */
+static void logger_wait_for_entries(void) {
+    log_waiting = 1U;
+    arch_dmb();
+    if (!logger_ring_empty() && arch_atomic_cas(&log_waiting, 1U, 0U)) {
+        return;
+    }
+    /* Returns at once if a producer cleared the flag and notified already */
+    task_notify_wait(1, UINT32_MAX);
+}
 
-/* Low priority task that waits for log entries and prints them. */
+/* Low priority task that drains the log ring and prints entries. */
 static void logger_task_entry(void *arg) {
     (void)arg;
-    log_entry_t entry;
 
     while (1) {
-        /* Block until a log entry arrives */
-        if (queue_pop(log_queue, &entry) == 0) {
-            
-            /* Save to history buffer */
-            log_history[log_head] = entry;
-            log_head = (log_head + 1) % LOG_HISTORY_SIZE;
-            if (log_count < LOG_HISTORY_SIZE) {
-                log_count++;
-            }
+        logger_drain();
+#if LOG_STORE_ENABLE && LOG_STORE_FLUSH_ON_IDLE
+        /* A burst shares flash frames; commit once the ring is empty */
+        if (log_store) {
+            logstore_flush(log_store);
+        }
+#endif
+        logger_wait_for_entries();
+    }
+}
+
+#if LOG_STORE_ENABLE
+/* Print a stored entry. %s arguments are pointers from an older image, so show them as %p */
+static void logger_print_stored(uint16_t boot, const log_entry_t *e, void *ctx) {
+    uint32_t *last_boot = (uint32_t *)ctx;
+    char fmt[LOG_STORE_FMT_MAX_LEN + 1];
+    uint32_t i = 0;
+    int in_spec = 0;
 
-            /* If live mode is enabled, print immediately */
-            if (log_live) {
-                uint32_t time_sec = entry.timestamp / 1000;
-                uint32_t time_ms = entry.timestamp % 1000;
-                
-                cli_printf("[%u.%03u] ", time_sec, time_ms);
-                cli_printf(entry.fmt, entry.arg1, entry.arg2);
-                cli_printf("\r\n");
+    if (*last_boot != boot) {
+        cli_printf("--- Boot %u ---\r\n", boot);
+        *last_boot = boot;
+    }
+
+    for (; e->fmt[i] != '\0' && i < LOG_STORE_FMT_MAX_LEN; i++) {
+        char c = e->fmt[i];
+        if (in_spec) {
+            if (c == 's') {
+                c = 'p';
             }
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '%') {
+                in_spec = 0;
+            }
+        } else if (c == '%') {
+            in_spec = 1;
+        }
+        fmt[i] = c;
+    }
+    fmt[i] = '\0';
+
+    logger_print_prefix(e);
+    cli_printf(fmt, e->arg1, e->arg2);
+    cli_printf("\r\n");
+}
+
+/* Hex-encode exported bytes, 32 per line */
+static int logger_export_hex(void *ctx, const uint8_t *data, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    char line[2 * 32 + 3];
+    (void)ctx;
+
+    while (len > 0) {
+        size_t n = (len > 32) ? 32 : len;
+        for (size_t i = 0; i < n; i++) {
+            line[2 * i] = hex[data[i] >> 4];
+            line[2 * i + 1] = hex[data[i] & 0x0F];
+        }
+        line[2 * n] = '\r';
+        line[2 * n + 1] = '\n';
+        line[2 * n + 2] = '\0';
+        cli_printf("%s", line);
+        data += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/* log flash|export|erase */
+static int logger_store_command(const char *sub) {
+    if (!log_store) {
+        cli_printf("No flash log store attached.\r\n");
+        return 0;
+    }
+
+    if (utils_strcmp(sub, "flash") == 0) {
+        uint32_t last_boot = 0;
+        logstore_flush(log_store);
+        cli_printf("--- Flash Log ---\r\n");
+        int n = logstore_read(log_store, logger_print_stored, &last_boot);
+        cli_printf("--- End (%d entries) ---\r\n", n);
+    } else if (utils_strcmp(sub, "export") == 0) {
+        logstore_flush(log_store);
+        cli_printf("--- Log Export ---\r\n");
+        int32_t n = logstore_export(log_store, logger_export_hex, NULL);
+        cli_printf("--- End (%d bytes) ---\r\n", n);
+    } else {
+        logstore_stats_t st;
+        logstore_erase(log_store);
+        logstore_get_stats(log_store, &st);
+        cli_printf("Flash log erased (boot %u).\r\n", st.boot);
+    }
+    return 0;
+}
+#endif
+
+/* Look up a name in a table, -1 if absent */
+static int logger_lookup(const char *const *names, uint32_t count, const char *name) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (utils_strcmp(names[i], name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/* log level [<module> <level>] */
+static int logger_level_command(int argc, char **argv) {
+    if (argc >= 4) {
+        int mod = logger_lookup(log_module_names, LOG_MOD_COUNT, argv[2]);
+        int lvl = logger_lookup(log_level_names, LOG_LEVEL_DEBUG + 1, argv[3]);
+        if (mod < 0 || lvl < 0) {
+            cli_printf("Usage: log level <module> <none|error|warn|info|debug>\r\n");
+            return 0;
         }
+        logger_set_level((uint8_t)mod, (uint8_t)lvl);
+    }
+
+    cli_printf("Module   Level  Max\r\n");
+    for (uint32_t i = 0; i < LOG_MOD_COUNT; i++) {
+        cli_printf("%-8s %-6s %s\r\n", log_module_names[i],
+                   log_level_names[log_module_level[i]], log_level_names[log_level_ceiling[i]]);
     }
+    cli_printf("Dropped: %u\r\n", log_dropped);
+    return 0;
 }
 
-/* CLI Command Handler: log [dump|live|clear] */
+/* log bench: cost of one logger_write() */
+static int logger_bench_command(void) {
+    uint32_t task = logger_bench(16, 0);
+    uint32_t isr = logger_bench(16, 1);
+
+    cli_printf("logger_write: %u cycles (task), %u cycles (IRQs masked)\r\n", task, isr);
+    return 0;
+}
+
+/* CLI Command Handler: log [dump|live|clear|level|bench|flash|export|erase] */
 static int cmd_log_handler(int argc, char **argv) {
     if (argc < 2 || utils_strcmp(argv[1], "dump") == 0) {
         /* Dump the history buffer */
@@ -56,11 +291,8 @@ static int cmd_log_handler(int argc, char **argv) {
         
         for (uint32_t i = 0; i < log_count; i++) {
             log_entry_t *e = &log_history[idx];
-            
-            uint32_t time_sec = e->timestamp / 1000;
-            uint32_t time_ms = e->timestamp % 1000;
-            
-            cli_printf("[%u.%03u] ", time_sec, time_ms);
+
+            logger_print_prefix(e);
             cli_printf(e->fmt, e->arg1, e->arg2);
             cli_printf("\r\n");
             
@@ -86,7 +318,24 @@ static int cmd_log_handler(int argc, char **argv) {
         return 0;
     }
 
-    cli_printf("Usage: log [dump|live <on/off>|clear]\r\n");
+    if (utils_strcmp(argv[1], "level") == 0) {
+        return logger_level_command(argc, argv);
+    }
+
+    if (utils_strcmp(argv[1], "bench") == 0) {
+        return logger_bench_command();
+    }
+
+#if LOG_STORE_ENABLE
+    if (utils_strcmp(argv[1], "flash") == 0 || utils_strcmp(argv[1], "export") == 0 ||
+        utils_strcmp(argv[1], "erase") == 0) {
+        return logger_store_command(argv[1]);
+    }
+
+    cli_printf("Usage: log [dump|live <on/off>|clear|level [<mod> <lvl>]|bench|flash|export|erase]\r\n");
+#else
+    cli_printf("Usage: log [dump|live <on/off>|clear|level [<mod> <lvl>]|bench]\r\n");
+#endif
     return 0;
 }
 
@@ -98,36 +347,150 @@ static const cli_command_t log_cmd = {
 
 /* Initialize the logger */
 void logger_init(void) {
-    /* Create a queue to hold binary log events */
-    log_queue = queue_create(sizeof(log_entry_t), LOG_QUEUE_SIZE);
-    
-    if (log_queue) {
-        /* Create the logger task with LOW priority */
-        task_create(logger_task_entry, NULL, STACK_SIZE_1KB, TASK_WEIGHT_LOW);
-        
-        /* Register the CLI command */
-        cli_register_command(&log_cmd);
+    log_ready = 0;
+    for (uint32_t i = 0; i < LOG_QUEUE_SIZE; i++) {
+        log_ring[i].seq = i;
+    }
+    log_ring_head = 0;
+    log_ring_tail = 0;
+    log_dropped = 0;
+    log_dropped_reported = 0;
+    log_waiting = 0;
+    for (uint32_t i = 0; i < LOG_MOD_COUNT; i++) {
+        log_module_level[i] = log_level_ceiling[i];
+    }
+    so_mutex_init(&log_drain_lock);
+#if LOG_STORE_ENABLE
+    log_store = NULL;
+#endif
+    log_ready = 1;
+
+    /* Create the logger task with LOW priority */
+    int32_t id = task_create(logger_task_entry, NULL, STACK_SIZE_1KB, TASK_WEIGHT_LOW);
+    log_task_id = (id > 0) ? (uint16_t)id : 0U;
+
+    /* Register the CLI command */
+    cli_register_command(&log_cmd);
+}
+
+/* Reserve a ring slot, fill it and publish it; never blocks or spins on a lock */
+void logger_write(uint8_t module, uint8_t level, const char *fmt, uintptr_t arg1, uintptr_t arg2) {
+    if (!log_ready) return;
+
+    uint32_t pos = log_ring_head;
+    log_slot_t *slot;
+
+    while (1) {
+        slot = &log_ring[pos & LOG_RING_MASK];
+        int32_t diff = (int32_t)(slot->seq - pos);
+        if (diff == 0) {
+            if (arch_atomic_cas(&log_ring_head, pos, pos + 1U)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* Slot from the previous lap not consumed yet: ring full */
+            arch_atomic_add(&log_dropped, 1U);
+            return;
+        }
+        pos = log_ring_head;
+    }
+
+    slot->entry.timestamp = (uint32_t)platform_get_ticks();
+    slot->entry.module = module;
+    slot->entry.level = level;
+    slot->entry.fmt = fmt;
+    slot->entry.arg1 = arg1;
+    slot->entry.arg2 = arg2;
+    arch_dmb();
+    slot->seq = pos + 1U;
+
+    /* Only the write that finds the logger asleep wakes it */
+    arch_dmb();
+    if (log_waiting && arch_atomic_cas(&log_waiting, 1U, 0U)) {
+        (void)task_notify(log_task_id, 1U);
     }
 }
 
-/* Push a log entry to the queue */
+/* Legacy entry point: unfiltered, reported as app/info */
 void logger_log(const char *fmt, uintptr_t arg1, uintptr_t arg2) {
-    if (!log_queue) return;
+    logger_write(LOG_MOD_APP, LOG_LEVEL_INFO, fmt, arg1, arg2);
+}
 
-    log_entry_t entry;
-    entry.timestamp = (uint32_t)platform_get_ticks();
-    entry.fmt = fmt;
-    entry.arg1 = arg1;
-    entry.arg2 = arg2;
+/* Take the oldest published entry (single consumer) */
+int logger_pop(log_entry_t *out) {
+    log_slot_t *slot = &log_ring[log_ring_tail & LOG_RING_MASK];
 
-    /* Use ISR version to avoid blocking */
-    queue_push_from_isr(log_queue, &entry);
+    if (slot->seq != log_ring_tail + 1U) {
+        return -1;
+    }
+    arch_dmb();
+    *out = slot->entry;
+    arch_dmb();
+    slot->seq = log_ring_tail + LOG_QUEUE_SIZE;
+    log_ring_tail++;
+    return 0;
+}
+
+uint32_t logger_get_dropped(void) {
+    return log_dropped;
+}
+
+/* Change a module's runtime level */
+int logger_set_level(uint8_t module, uint8_t level) {
+    if (module >= LOG_MOD_COUNT || level > LOG_LEVEL_DEBUG) {
+        return -1;
+    }
+    log_module_level[module] = level;
+    return 0;
 }
 
-/* Get the logger queue for debugging */
-queue_t* logger_get_queue(void) {
-    return log_queue;
+/* Time batches of logger_write() calls; the ring is emptied between batches */
+uint32_t logger_bench(uint32_t batches, uint8_t irq_locked) {
+    static const char bench_fmt[] = "bench %u";
+    const uint32_t batch = LOG_QUEUE_SIZE / 2U;
+    uint64_t total = 0;
+    uint32_t calls = 0;
+    log_entry_t entry;
+
+    if (!log_ready || batches == 0U) {
+        return 0;
+    }
+
+    so_mutex_lock(&log_drain_lock);
+    for (uint32_t b = 0; b < batches; b++) {
+        /* Keep real entries, discard the previous batch */
+        while (logger_pop(&entry) == 0) {
+            if (entry.fmt != bench_fmt) {
+                logger_process_entry(&entry);
+            }
+        }
+
+        uint32_t state = irq_locked ? arch_irq_lock() : 0U;
+        uint32_t start = platform_get_cycles();
+        for (uint32_t i = 0; i < batch; i++) {
+            logger_write(LOG_MOD_APP, LOG_LEVEL_DEBUG, bench_fmt, i, 0);
+        }
+        total += platform_get_cycles() - start;
+        if (irq_locked) {
+            arch_irq_unlock(state);
+        }
+        calls += batch;
+    }
+    while (logger_pop(&entry) == 0) {
+        if (entry.fmt != bench_fmt) {
+            logger_process_entry(&entry);
+        }
+    }
+    so_mutex_unlock(&log_drain_lock);
+
+    return (uint32_t)(total / calls);
 }
 
+#if LOG_STORE_ENABLE
+/* Mirror processed entries into a flash log store */
+void logger_attach_store(logstore_t *store) {
+    log_store = store;
+}
+#endif
 
-#endif /* LOG_ENABLE */
\ No newline at end of file
+#endif /* LOG_ENABLE */
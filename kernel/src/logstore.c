@@ -0,0 +1,644 @@
+#include "logstore.h"
+#include "flash.h"
+#include "allocator.h"
+#include "mutex.h"
+#include "platform.h"
+#include "project_config.h"
+#include "utils.h"
+
+#if LOG_ENABLE
+
+/*
+ * On-flash layout (FLASH_PROGRAM_UNIT aligned):
+ *
+ *   Page:  [ls_page_hdr_t 16B][frame][frame]...[0xFF...]
+ *   Frame: [ls_frame_hdr_t 8B][payload: items][pad to 8B]
+ *
+ * Payload items, all integers as LEB128 varints:
+ *   format definition: tag = (id << 1) | 1, length, string bytes
+ *   log entry:         tag = (id << 1),     meta, zigzag(ts - prev_ts), arg1, arg2
+ *                      (meta = module << 3 | level)
+ *
+ * prev_ts restarts at 0 in every frame so each frame decodes on its own.
+ * Format IDs are scoped to a page; a definition always precedes its first use.
+ */
+#define LS_PAGE_MAGIC       0x32474F4CU     /* "LOG2" */
+#define LS_PAGE_HDR_SIZE    16U
+#define LS_FRAME_HDR_SIZE   8U
+#define LS_FRAME_PAYLOAD    (LOG_STORE_FRAME_SIZE - LS_FRAME_HDR_SIZE)
+#define LS_ALIGN(n)         (((n) + (FLASH_PROGRAM_UNIT - 1U)) & ~(FLASH_PROGRAM_UNIT - 1U))
+#define LS_VARINT_MAX       10U
+#define LS_ITEM_MAX         (5U * LS_VARINT_MAX + 2U * LS_VARINT_MAX + LOG_STORE_FMT_MAX_LEN)
+#define LS_SEQ_FREE         0U              /* Page erased and unused */
+#define LS_SEQ_DIRTY        0xFFFFFFFFU     /* Page must be erased before use */
+
+#if (LOG_STORE_FRAME_SIZE % 8) != 0
+    #error "LOG_STORE_FRAME_SIZE must be a multiple of 8"
+#endif
+#if (LOG_STORE_FRAME_SIZE + 16) > FLASH_PAGE_SIZE
+    #error "LOG_STORE_FRAME_SIZE does not fit in a flash page"
+#endif
+
+typedef struct ls_page_hdr {
+    uint32_t magic;
+    uint32_t seq;           /* Age of the page in the ring */
+    uint32_t boot;          /* Boot number of the session that wrote it */
+    uint32_t crc;           /* CRC over the fields above */
+} ls_page_hdr_t;
+
+typedef struct ls_frame_hdr {
+    uint32_t crc;           /* CRC over len, reserved and payload */
+    uint16_t len;           /* Payload bytes */
+    uint16_t reserved;
+} ls_frame_hdr_t;
+
+typedef struct ls_fmt_slot {
+    const char *ptr;        /* Writer: format pointer seen in this page */
+    uint32_t addr;          /* Reader: flash address of the string */
+    uint32_t id;
+    uint8_t len;
+    uint8_t valid;
+} ls_fmt_slot_t;
+
+/* Decoder state for logstore_read(), used under the store lock */
+typedef struct ls_reader {
+    ls_fmt_slot_t fmts[LOG_STORE_MAX_FORMATS];
+    char fmt_buf[LOG_STORE_FMT_MAX_LEN + 1];
+} ls_reader_t;
+
+struct logstore {
+    uint32_t base;
+    uint32_t page_count;
+    uint32_t *page_seq;     /* Per-page seq, LS_SEQ_FREE or LS_SEQ_DIRTY */
+    int32_t head;           /* Page receiving frames, -1 if none this boot */
+    int32_t newest;         /* Last page written, ring continues after it */
+    uint32_t head_used;
+    uint32_t next_seq;
+    uint16_t boot;
+
+    /* Pending frame: header space followed by payload */
+    uint8_t frame[LOG_STORE_FRAME_SIZE];
+    uint32_t frame_len;
+    uint32_t frame_entries;
+    uint32_t prev_ts;
+
+    /* Format dictionary of the head page */
+    ls_fmt_slot_t fmts[LOG_STORE_MAX_FORMATS];
+    uint32_t next_fmt_id;
+
+    ls_reader_t reader;
+    logstore_stats_t stats;
+    so_mutex_t lock;
+};
+
+static inline uint32_t _ls_page_addr(logstore_t *ls, uint32_t page) {
+    return ls->base + page * FLASH_PAGE_SIZE;
+}
+
+/* Append an unsigned LEB128 varint */
+static uint32_t _ls_put_varint(uint8_t *out, uint64_t v) {
+    uint32_t n = 0;
+    while (v >= 0x80U) {
+        out[n++] = (uint8_t)(v | 0x80U);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+/* Read an unsigned LEB128 varint, returns bytes consumed or 0 if malformed */
+static uint32_t _ls_get_varint(const uint8_t *in, uint32_t avail, uint64_t *v) {
+    uint64_t result = 0;
+    for (uint32_t n = 0; n < avail && n < LS_VARINT_MAX; n++) {
+        result |= (uint64_t)(in[n] & 0x7FU) << (7U * n);
+        if ((in[n] & 0x80U) == 0U) {
+            *v = result;
+            return n + 1U;
+        }
+    }
+    return 0;
+}
+
+static inline uint32_t _ls_zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t _ls_unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1U);
+}
+
+/* Program with the controller unlocked only for the duration of the write */
+static int _ls_program(uint32_t addr, const void *data, size_t len) {
+    flash_unlock();
+    int res = flash_program(addr, data, len);
+    flash_lock();
+    return res;
+}
+
+static int _ls_erase(logstore_t *ls, uint32_t page) {
+    flash_unlock();
+    int res = flash_erase_page(_ls_page_addr(ls, page));
+    flash_lock();
+    if (res == 0) {
+        ls->page_seq[page] = LS_SEQ_FREE;
+    }
+    return res;
+}
+
+/* Read and validate a page header */
+static int _ls_read_page_hdr(logstore_t *ls, uint32_t page, ls_page_hdr_t *hdr) {
+    flash_read(_ls_page_addr(ls, page), hdr, sizeof(*hdr));
+    return (hdr->magic == LS_PAGE_MAGIC &&
+            hdr->crc == utils_crc32(0, hdr, sizeof(*hdr) - sizeof(hdr->crc))) ? 0 : -1;
+}
+
+/*
+ * Read and validate the frame at offset into buf.
+ * Returns its aligned size, 0 at the end of the page, or -1 if corrupt.
+ */
+static int _ls_read_frame(logstore_t *ls, uint32_t page, uint32_t offset, uint8_t *buf) {
+    ls_frame_hdr_t hdr;
+    uint32_t addr = _ls_page_addr(ls, page) + offset;
+
+    if (offset + LS_FRAME_HDR_SIZE > FLASH_PAGE_SIZE) {
+        return 0;
+    }
+    flash_read(addr, &hdr, sizeof(hdr));
+    if (hdr.crc == 0xFFFFFFFFU && hdr.len == 0xFFFFU && hdr.reserved == 0xFFFFU) {
+        return 0;
+    }
+    if (hdr.len == 0U || hdr.len > LS_FRAME_PAYLOAD) {
+        return -1;
+    }
+    uint32_t size = LS_ALIGN(LS_FRAME_HDR_SIZE + hdr.len);
+    if (offset + size > FLASH_PAGE_SIZE) {
+        return -1;
+    }
+    flash_read(addr, buf, size);
+    if (utils_crc32(0, buf + 4, 4U + hdr.len) != hdr.crc) {
+        return -1;
+    }
+    return (int)size;
+}
+
+/* Next page in seq order after prev_seq, or -1 */
+static int32_t _ls_next_page(logstore_t *ls, uint32_t prev_seq) {
+    int32_t next = -1;
+    for (uint32_t p = 0; p < ls->page_count; p++) {
+        uint32_t s = ls->page_seq[p];
+        if (s != LS_SEQ_FREE && s != LS_SEQ_DIRTY && s > prev_seq &&
+            (next < 0 || s < ls->page_seq[next])) {
+            next = (int32_t)p;
+        }
+    }
+    return next;
+}
+
+/* Classify pages, erase torn ones and pick up seq/boot counters */
+static int _ls_mount(logstore_t *ls) {
+    uint32_t max_seq = 0;
+    uint32_t max_boot = 0;
+
+    ls->head = -1;
+    ls->newest = -1;
+
+    for (uint32_t p = 0; p < ls->page_count; p++) {
+        ls_page_hdr_t hdr;
+        if (_ls_read_page_hdr(ls, p, &hdr) == 0) {
+            ls->page_seq[p] = hdr.seq;
+            if (hdr.seq > max_seq) {
+                max_seq = hdr.seq;
+                ls->newest = (int32_t)p;
+            }
+            if (hdr.boot > max_boot) {
+                max_boot = hdr.boot;
+            }
+            continue;
+        }
+
+        /* Blank pages are free; anything else is a torn header or erase */
+        ls->page_seq[p] = LS_SEQ_DIRTY;
+        uint8_t chunk[32];
+        uint32_t addr = _ls_page_addr(ls, p);
+        uint32_t blank = 1;
+        for (uint32_t off = 0; off < FLASH_PAGE_SIZE && blank; off += sizeof(chunk)) {
+            flash_read(addr + off, chunk, sizeof(chunk));
+            for (uint32_t i = 0; i < sizeof(chunk); i++) {
+                if (chunk[i] != 0xFFU) {
+                    blank = 0;
+                    break;
+                }
+            }
+        }
+        if (blank) {
+            ls->page_seq[p] = LS_SEQ_FREE;
+        } else if (_ls_erase(ls, p) != 0) {
+            return -1;
+        }
+    }
+
+    ls->next_seq = max_seq + 1U;
+    ls->boot = (uint16_t)(max_boot + 1U);
+    return 0;
+}
+
+/* Start a new page after the newest one, recycling the oldest if needed */
+static int _ls_open_page(logstore_t *ls) {
+    uint32_t page = (ls->newest < 0) ? 0U : ((uint32_t)ls->newest + 1U) % ls->page_count;
+
+    ls->head = -1;
+    if (ls->page_seq[page] != LS_SEQ_FREE) {
+        if (ls->page_seq[page] != LS_SEQ_DIRTY) {
+            ls->stats.pages_erased++;
+        }
+        if (_ls_erase(ls, page) != 0) {
+            ls->page_seq[page] = LS_SEQ_DIRTY;
+            return -1;
+        }
+    }
+
+    ls_page_hdr_t hdr;
+    hdr.magic = LS_PAGE_MAGIC;
+    hdr.seq = ls->next_seq;
+    hdr.boot = ls->boot;
+    hdr.crc = utils_crc32(0, &hdr, sizeof(hdr) - sizeof(hdr.crc));
+
+    ls->newest = (int32_t)page;
+    if (_ls_program(_ls_page_addr(ls, page), &hdr, sizeof(hdr)) != 0) {
+        ls->page_seq[page] = LS_SEQ_DIRTY;
+        return -1;
+    }
+
+    ls->page_seq[page] = ls->next_seq++;
+    ls->head = (int32_t)page;
+    ls->head_used = LS_PAGE_HDR_SIZE;
+    utils_memset(ls->fmts, 0, sizeof(ls->fmts));
+    ls->next_fmt_id = 0;
+    return 0;
+}
+
+/* Make sure a full-size frame will fit in the head page */
+static int _ls_prepare_frame(logstore_t *ls) {
+    if (ls->head >= 0 && ls->head_used + LOG_STORE_FRAME_SIZE <= FLASH_PAGE_SIZE) {
+        return 0;
+    }
+    return _ls_open_page(ls);
+}
+
+/* Program the pending frame */
+static int _ls_flush_locked(logstore_t *ls) {
+    if (ls->frame_len == 0U) {
+        return 0;
+    }
+
+    ls_frame_hdr_t hdr;
+    uint32_t size = LS_ALIGN(LS_FRAME_HDR_SIZE + ls->frame_len);
+    hdr.crc = 0;
+    hdr.len = (uint16_t)ls->frame_len;
+    hdr.reserved = 0xFFFFU;
+    utils_memcpy(ls->frame, &hdr, sizeof(hdr));
+    utils_memset(&ls->frame[LS_FRAME_HDR_SIZE + ls->frame_len], 0xFF,
+                 size - LS_FRAME_HDR_SIZE - ls->frame_len);
+    hdr.crc = utils_crc32(0, &ls->frame[4], 4U + ls->frame_len);
+    utils_memcpy(ls->frame, &hdr.crc, sizeof(hdr.crc));
+
+    int res = _ls_program(_ls_page_addr(ls, (uint32_t)ls->head) + ls->head_used, ls->frame, size);
+    if (res == 0) {
+        ls->head_used += size;
+        ls->stats.frames_written++;
+        ls->stats.entries_written += ls->frame_entries;
+        ls->stats.bytes_raw += ls->frame_entries * (uint32_t)sizeof(log_entry_t);
+        ls->stats.bytes_stored += size;
+    } else {
+        /* Never append behind a torn frame; the next frame opens a new page */
+        ls->head_used = FLASH_PAGE_SIZE;
+        ls->stats.entries_dropped += ls->frame_entries;
+    }
+
+    ls->frame_len = 0;
+    ls->frame_entries = 0;
+    ls->prev_ts = 0;
+    return (res == 0) ? 0 : -1;
+}
+
+/* Find the dictionary slot of fmt in the head page, or -1 */
+static int32_t _ls_fmt_lookup(logstore_t *ls, const char *fmt) {
+    for (uint32_t i = 0; i < LOG_STORE_MAX_FORMATS; i++) {
+        if (ls->fmts[i].valid && ls->fmts[i].ptr == fmt) {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+/* Encode an entry (plus a format definition if needed) into out */
+static uint32_t _ls_encode(logstore_t *ls, const log_entry_t *e, uint8_t *out, uint32_t *new_id) {
+    uint32_t n = 0;
+    int32_t slot = _ls_fmt_lookup(ls, e->fmt);
+    uint32_t id;
+
+    if (slot >= 0) {
+        id = ls->fmts[slot].id;
+        *new_id = 0xFFFFFFFFU;
+    } else {
+        const char *f = e->fmt ? e->fmt : "";
+        uint32_t len = 0;
+        while (len < LOG_STORE_FMT_MAX_LEN && f[len] != '\0') {
+            len++;
+        }
+        id = ls->next_fmt_id;
+        *new_id = id;
+        n += _ls_put_varint(&out[n], ((uint64_t)id << 1) | 1U);
+        n += _ls_put_varint(&out[n], len);
+        utils_memcpy(&out[n], f, len);
+        n += len;
+    }
+
+    n += _ls_put_varint(&out[n], (uint64_t)id << 1);
+    n += _ls_put_varint(&out[n], ((uint64_t)e->module << 3) | (e->level & 7U));
+    n += _ls_put_varint(&out[n], _ls_zigzag((int32_t)(e->timestamp - ls->prev_ts)));
+    n += _ls_put_varint(&out[n], (uint64_t)e->arg1);
+    n += _ls_put_varint(&out[n], (uint64_t)e->arg2);
+    return n;
+}
+
+/* Create and mount a log store */
+logstore_t *logstore_create(uint32_t base_addr, uint32_t page_count) {
+    if (page_count < 2U || (base_addr % FLASH_PAGE_SIZE) != 0U) {
+        return NULL;
+    }
+
+    logstore_t *ls = (logstore_t *)allocator_malloc(sizeof(logstore_t));
+    if (!ls) {
+        return NULL;
+    }
+    utils_memset(ls, 0, sizeof(logstore_t));
+
+    ls->page_seq = (uint32_t *)allocator_malloc(sizeof(uint32_t) * page_count);
+    if (!ls->page_seq) {
+        allocator_free(ls);
+        return NULL;
+    }
+    ls->base = base_addr;
+    ls->page_count = page_count;
+    so_mutex_init(&ls->lock);
+
+    if (_ls_mount(ls) != 0) {
+        allocator_free(ls->page_seq);
+        allocator_free(ls);
+        return NULL;
+    }
+    ls->stats.boot = ls->boot;
+    return ls;
+}
+
+/* Release RAM state */
+void logstore_destroy(logstore_t *ls) {
+    if (!ls) {
+        return;
+    }
+    allocator_free(ls->page_seq);
+    allocator_free(ls);
+}
+
+/* Compress an entry into the pending frame */
+int logstore_append(logstore_t *ls, const log_entry_t *entry) {
+    uint8_t item[LS_ITEM_MAX];
+
+    if (!ls || !entry) {
+        return -1;
+    }
+
+    so_mutex_lock(&ls->lock);
+
+    int res = -1;
+    for (uint32_t attempt = 0; attempt < 2U; attempt++) {
+        if (ls->frame_len == 0U && _ls_prepare_frame(ls) != 0) {
+            break;
+        }
+
+        /* Encode against the dictionary of the page the frame will land in */
+        uint32_t new_id;
+        uint32_t n = _ls_encode(ls, entry, item, &new_id);
+        if (ls->frame_len + n > LS_FRAME_PAYLOAD) {
+            (void)_ls_flush_locked(ls);
+            continue;
+        }
+
+        utils_memcpy(&ls->frame[LS_FRAME_HDR_SIZE + ls->frame_len], item, n);
+        ls->frame_len += n;
+        ls->frame_entries++;
+        ls->prev_ts = entry->timestamp;
+        if (new_id != 0xFFFFFFFFU) {
+            /* Round-robin eviction keeps live IDs distinct modulo the table size */
+            ls_fmt_slot_t *s = &ls->fmts[new_id % LOG_STORE_MAX_FORMATS];
+            s->ptr = entry->fmt;
+            s->id = new_id;
+            s->valid = 1;
+            ls->next_fmt_id++;
+        }
+        res = 0;
+        break;
+    }
+    if (res != 0) {
+        ls->stats.entries_dropped++;
+    }
+
+    so_mutex_unlock(&ls->lock);
+    return res;
+}
+
+/* Program the pending frame */
+int logstore_flush(logstore_t *ls) {
+    if (!ls) {
+        return -1;
+    }
+    so_mutex_lock(&ls->lock);
+    int res = _ls_flush_locked(ls);
+    so_mutex_unlock(&ls->lock);
+    return res;
+}
+
+/* Decode the items of one frame */
+static int _ls_decode_frame(ls_reader_t *rd, uint32_t frame_addr, const uint8_t *buf,
+                            uint16_t boot, logstore_entry_fn_t fn, void *ctx) {
+    ls_frame_hdr_t hdr;
+    utils_memcpy(&hdr, buf, sizeof(hdr));
+    const uint8_t *p = &buf[LS_FRAME_HDR_SIZE];
+    uint32_t avail = hdr.len;
+    uint32_t pos = 0;
+    uint32_t ts = 0;
+    int count = 0;
+
+    while (pos < avail) {
+        uint64_t tag, meta, v1, v2, v3;
+        uint32_t n = _ls_get_varint(&p[pos], avail - pos, &tag);
+        if (n == 0U) {
+            break;
+        }
+        pos += n;
+        uint32_t id = (uint32_t)(tag >> 1);
+        ls_fmt_slot_t *slot = &rd->fmts[id % LOG_STORE_MAX_FORMATS];
+
+        if (tag & 1U) {
+            n = _ls_get_varint(&p[pos], avail - pos, &v1);
+            if (n == 0U || v1 > LOG_STORE_FMT_MAX_LEN || pos + n + v1 > avail) {
+                break;
+            }
+            pos += n;
+            slot->addr = frame_addr + LS_FRAME_HDR_SIZE + pos;
+            slot->len = (uint8_t)v1;
+            slot->id = id;
+            slot->valid = 1;
+            pos += (uint32_t)v1;
+            continue;
+        }
+
+        n = _ls_get_varint(&p[pos], avail - pos, &meta);
+        if (n == 0U) {
+            break;
+        }
+        pos += n;
+
+        uint32_t n1 = _ls_get_varint(&p[pos], avail - pos, &v1);
+        uint32_t n2 = n1 ? _ls_get_varint(&p[pos + n1], avail - pos - n1, &v2) : 0U;
+        uint32_t n3 = n2 ? _ls_get_varint(&p[pos + n1 + n2], avail - pos - n1 - n2, &v3) : 0U;
+        if (n3 == 0U) {
+            break;
+        }
+        pos += n1 + n2 + n3;
+
+        log_entry_t e;
+        ts += (uint32_t)_ls_unzigzag((uint32_t)v1);
+        e.timestamp = ts;
+        e.module = (uint8_t)(meta >> 3);
+        e.level = (uint8_t)(meta & 7U);
+        e.arg1 = (uintptr_t)v2;
+        e.arg2 = (uintptr_t)v3;
+        if (slot->valid && slot->id == id) {
+            flash_read(slot->addr, rd->fmt_buf, slot->len);
+            rd->fmt_buf[slot->len] = '\0';
+        } else {
+            utils_memcpy(rd->fmt_buf, "<unknown format>", 17);
+        }
+        e.fmt = rd->fmt_buf;
+        if (fn) {
+            fn(boot, &e, ctx);
+        }
+        count++;
+    }
+    return count;
+}
+
+/* Decode all stored entries, oldest first */
+int logstore_read(logstore_t *ls, logstore_entry_fn_t fn, void *ctx) {
+    uint8_t buf[LOG_STORE_FRAME_SIZE];
+
+    if (!ls) {
+        return -1;
+    }
+
+    so_mutex_lock(&ls->lock);
+
+    int total = 0;
+    uint32_t prev_seq = 0;
+    int32_t page;
+    while ((page = _ls_next_page(ls, prev_seq)) >= 0) {
+        ls_page_hdr_t hdr;
+        prev_seq = ls->page_seq[page];
+        if (_ls_read_page_hdr(ls, (uint32_t)page, &hdr) != 0) {
+            continue;
+        }
+        utils_memset(ls->reader.fmts, 0, sizeof(ls->reader.fmts));
+
+        uint32_t off = LS_PAGE_HDR_SIZE;
+        int size;
+        while ((size = _ls_read_frame(ls, (uint32_t)page, off, buf)) > 0) {
+            total += _ls_decode_frame(&ls->reader, _ls_page_addr(ls, (uint32_t)page) + off, buf,
+                                      (uint16_t)hdr.boot, fn, ctx);
+            off += (uint32_t)size;
+        }
+    }
+
+    so_mutex_unlock(&ls->lock);
+    return total;
+}
+
+/* Stream valid page headers and frames, oldest page first */
+int32_t logstore_export(logstore_t *ls, logstore_write_fn_t write, void *ctx) {
+    uint8_t buf[LOG_STORE_FRAME_SIZE];
+
+    if (!ls || !write) {
+        return -1;
+    }
+
+    so_mutex_lock(&ls->lock);
+
+    int32_t total = 0;
+    uint32_t prev_seq = 0;
+    int32_t page;
+    while (total >= 0 && (page = _ls_next_page(ls, prev_seq)) >= 0) {
+        ls_page_hdr_t hdr;
+        prev_seq = ls->page_seq[page];
+        if (_ls_read_page_hdr(ls, (uint32_t)page, &hdr) != 0) {
+            continue;
+        }
+        if (write(ctx, (const uint8_t *)&hdr, sizeof(hdr)) != 0) {
+            total = -1;
+            break;
+        }
+        total += (int32_t)sizeof(hdr);
+
+        uint32_t off = LS_PAGE_HDR_SIZE;
+        int size;
+        while ((size = _ls_read_frame(ls, (uint32_t)page, off, buf)) > 0) {
+            if (write(ctx, buf, (size_t)size) != 0) {
+                total = -1;
+                break;
+            }
+            total += size;
+            off += (uint32_t)size;
+        }
+    }
+
+    so_mutex_unlock(&ls->lock);
+    return total;
+}
+
+/* Erase every page */
+int logstore_erase(logstore_t *ls) {
+    if (!ls) {
+        return -1;
+    }
+
+    so_mutex_lock(&ls->lock);
+
+    int res = 0;
+    for (uint32_t p = 0; p < ls->page_count; p++) {
+        if (ls->page_seq[p] != LS_SEQ_FREE && _ls_erase(ls, p) != 0) {
+            ls->page_seq[p] = LS_SEQ_DIRTY;
+            res = -1;
+        }
+    }
+    ls->head = -1;
+    ls->newest = -1;
+    ls->frame_len = 0;
+    ls->frame_entries = 0;
+    ls->prev_ts = 0;
+
+    so_mutex_unlock(&ls->lock);
+    return res;
+}
+
+/* Retrieve store statistics */
+int logstore_get_stats(logstore_t *ls, logstore_stats_t *stats) {
+    if (!ls || !stats) {
+        return -1;
+    }
+    so_mutex_lock(&ls->lock);
+    *stats = ls->stats;
+    so_mutex_unlock(&ls->lock);
+    return 0;
+}
+
+#endif /* LOG_ENABLE */
@@ -0,0 +1,183 @@
+#include "mailbox.h"
+#include "allocator.h"
+#include "scheduler.h"
+#include "arch_ops.h"
+#include "utils.h"
+#include "platform.h"
+#include "spinlock.h"
+#include "perf.h"
+
+/*
+ * Seqlock: 'seq' is odd while a write is in progress and goes up by 2 per
+ * write, so seq / 2 is the generation. Writers serialise on the lock;
+ * readers copy without it and retry if 'seq' was odd or changed.
+ */
+struct mailbox {
+    void *data;                     /* Current value */
+    size_t size;                    /* Value size in bytes */
+    volatile uint32_t seq;          /* Sequence counter */
+
+    wait_node_t *wait_head;         /* Readers waiting for a new generation */
+    wait_node_t *wait_tail;
+
+    spinlock_t lock;                /* Serialises writers and waiters */
+};
+
+PERF_COUNTER(perf_mailbox_write, "mailbox.write");
+PERF_COUNTER(perf_mailbox_retry, "mailbox.retry");
+
+/* Add task to wait list */
+static void _add_to_wait_list(wait_node_t **head, wait_node_t **tail, wait_node_t *node) {
+    node->next = NULL;
+
+    if (*tail) {
+        (*tail)->next = node;
+    } else {
+        *head = node;
+    }
+    *tail = node;
+}
+
+/* Remove and return first task from wait list */
+static void* _pop_from_wait_list(wait_node_t **head, wait_node_t **tail) {
+    if (!*head) {
+        return NULL;
+    }
+
+    wait_node_t *node = *head;
+    void *task = node->task;
+
+    *head = node->next;
+    if (*head == NULL) {
+        *tail = NULL;
+    }
+
+    return task;
+}
+
+/* Create a mailbox with a zeroed value */
+mailbox_t* mailbox_create(size_t size) {
+    if (size == 0) {
+        return NULL;
+    }
+
+    mailbox_t *mb = (mailbox_t*)allocator_malloc(sizeof(mailbox_t));
+    if (!mb) {
+        return NULL;
+    }
+
+    mb->data = allocator_malloc(size);
+    if (!mb->data) {
+        allocator_free(mb);
+        return NULL;
+    }
+    utils_memset(mb->data, 0, size);
+
+    mb->size = size;
+    mb->seq = 0;
+    mb->wait_head = NULL;
+    mb->wait_tail = NULL;
+
+    spinlock_init(&mb->lock);
+    return mb;
+}
+
+/* Delete a mailbox */
+void mailbox_delete(mailbox_t *mb) {
+    if (!mb) {
+        return;
+    }
+    allocator_free(mb->data);
+    allocator_free(mb);
+}
+
+/* Publish a new value and wake all waiters */
+int mailbox_write(mailbox_t *mb, const void *data) {
+    if (!mb || !data) {
+        return -1;
+    }
+
+    uint32_t flags = spin_lock(&mb->lock);
+
+    mb->seq++;                      /* Odd: readers retry */
+    arch_dmb();
+    utils_memcpy(mb->data, data, mb->size);
+    arch_dmb();
+    mb->seq++;                      /* Even: new generation visible */
+    PERF_INC_LOCKED(perf_mailbox_write);
+
+    while (1) {
+        void *task = _pop_from_wait_list(&mb->wait_head, &mb->wait_tail);
+        if (!task) break;
+        task_unblock((task_t*)task);
+    }
+
+    spin_unlock(&mb->lock, flags);
+    return 0;
+}
+
+/* Lock-free snapshot of the value */
+uint32_t mailbox_read(mailbox_t *mb, void *buf) {
+    if (!mb || !buf) {
+        return 0;
+    }
+
+    while (1) {
+        uint32_t start = mb->seq;
+        if (start == 0) {
+            return 0;
+        }
+        if (start & 1U) {
+            PERF_INC(perf_mailbox_retry);
+            continue;
+        }
+
+        arch_dmb();
+        utils_memcpy(buf, mb->data, mb->size);
+        arch_dmb();
+
+        if (mb->seq == start) {
+            return start >> 1;
+        }
+        PERF_INC(perf_mailbox_retry);
+    }
+}
+
+/* Block until a generation newer than last_gen, then read it */
+uint32_t mailbox_wait(mailbox_t *mb, void *buf, uint32_t last_gen) {
+    if (!mb || !buf) {
+        return 0;
+    }
+
+    task_t *current = (task_t*)task_get_current();
+    if (!current) {
+        return 0;
+    }
+
+    wait_node_t *node = task_get_wait_node(current);
+    node->task = current;
+
+    while (1) {
+        uint32_t flags = spin_lock(&mb->lock);
+
+        /* Writers hold the lock, so the value is stable here */
+        uint32_t gen = mb->seq >> 1;
+        if (gen != last_gen) {
+            utils_memcpy(buf, mb->data, mb->size);
+            spin_unlock(&mb->lock, flags);
+            return gen;
+        }
+
+        _add_to_wait_list(&mb->wait_head, &mb->wait_tail, node);
+        task_block_on(current, mb);
+
+        spin_unlock(&mb->lock, flags);
+        /* Yield CPU until the next write */
+        platform_yield();
+    }
+}
+
+/* Current generation */
+uint32_t mailbox_generation(mailbox_t *mb) {
+    return mb ? (mb->seq >> 1) : 0U;
+}
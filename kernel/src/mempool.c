@@ -4,16 +4,28 @@
 #include "platform.h"
 #include "utils.h"
 
-#define ALIGN_SIZE      sizeof(void*)
-#define ALIGN(size)     (((size) + (ALIGN_SIZE - 1)) & ~(ALIGN_SIZE - 1))
+/* Thread the free list through the buffer */
+static void _mempool_setup(mempool_t *pool, void *buffer, size_t real_size, size_t count) {
+    pool->buffer = buffer;
+    pool->item_size = real_size;
+    pool->count = count;
+    pool->is_static = 0;
+    spinlock_init(&pool->lock);
 
-struct mempool {
-    void        *buffer;        /* Contiguous memory block */
-    size_t      item_size;      /* Size of one item (aligned) */
-    size_t      count;          /* Total capacity */
-    void        *free_list;     /* Head of the free list */
-    spinlock_t  lock;
-};
+    /* Initialize free list by threading pointers through the buffer */
+    uint8_t *ptr = (uint8_t*)buffer;
+    pool->free_list = ptr;
+
+    for (size_t i = 0; i < count - 1; i++) {
+        void **next_link = (void**)ptr;
+        /* Link current block to the next */
+        *next_link = (ptr + real_size);
+        ptr += real_size;
+    }
+    
+    /* Last item points to NULL */
+    *((void**)ptr) = NULL;
+}
 
 /* Create a fixed-size memory pool */
 mempool_t* mempool_create(size_t item_size, size_t count) {
@@ -25,42 +37,32 @@ mempool_t* mempool_create(size_t item_size, size_t count) {
      * Item size must be at least large enough to hold a pointer 
      * for the free list, and aligned to the system pointer size.
      */
-    size_t real_size = item_size;
-    if (real_size < sizeof(void*)) {
-        real_size = sizeof(void*);
-    }
-    real_size = ALIGN(real_size);
+    size_t real_size = MEMPOOL_ITEM_SIZE(item_size);
 
     mempool_t *pool = (mempool_t*)allocator_malloc(sizeof(mempool_t));
     if (!pool) {
         return NULL;
     }
 
-    pool->buffer = allocator_malloc(real_size * count);
-    if (!pool->buffer) {
+    void *buffer = allocator_malloc(real_size * count);
+    if (!buffer) {
         allocator_free(pool);
         return NULL;
     }
 
-    pool->item_size = real_size;
-    pool->count = count;
-    spinlock_init(&pool->lock);
-
-    /* Initialize free list by threading pointers through the buffer */
-    uint8_t *ptr = (uint8_t*)pool->buffer;
-    pool->free_list = ptr;
+    _mempool_setup(pool, buffer, real_size, count);
+    return pool;
+}
 
-    for (size_t i = 0; i < count - 1; i++) {
-        void **next_link = (void**)ptr;
-        /* Link current block to the next */
-        *next_link = (ptr + real_size);
-        ptr += real_size;
+/* Set up a pool in caller-provided memory */
+int mempool_init_static(mempool_t *pool, void *buffer, size_t item_size, size_t count) {
+    if (!pool || !buffer || item_size == 0 || count == 0 ||
+        ((uintptr_t)buffer & (sizeof(void*) - 1)) != 0) {
+        return -1;
     }
-    
-    /* Last item points to NULL */
-    *((void**)ptr) = NULL;
-
-    return pool;
+    _mempool_setup(pool, buffer, MEMPOOL_ITEM_SIZE(item_size), count);
+    pool->is_static = 1;
+    return 0;
 }
 
 /* Allocate an item from the pool */
@@ -107,7 +109,7 @@ void mempool_free(mempool_t *pool, void *ptr) {
 
 /* Delete the pool and free all resources */
 void mempool_delete(mempool_t *pool) {
-    if (!pool) {
+    if (!pool || pool->is_static) {
         return;
     }
 
@@ -0,0 +1,398 @@
+#include "msgbus.h"
+#include "mempool.h"
+#include "allocator.h"
+#include "scheduler.h"
+#include "arch_ops.h"
+#include "platform.h"
+#include "spinlock.h"
+#include "perf.h"
+
+/* Payloads stay 8-byte aligned behind the header */
+#define HDR_ALIGN       8U
+#define HDR_SIZE        ((sizeof(msg_hdr_t) + (HDR_ALIGN - 1U)) & ~(size_t)(HDR_ALIGN - 1U))
+#define MSG_HDR(msg)    ((msg_hdr_t*)((uint8_t*)(msg) - HDR_SIZE))
+
+/* Header in front of every payload */
+typedef struct {
+    msgbus_t *bus;                  /* Owner, so a release needs only the payload */
+    volatile uint32_t refs;         /* Outstanding references */
+    uint8_t topic;
+} msg_hdr_t;
+
+struct msgbus_sub {
+    msgbus_sub_t *next;             /* Next subscriber on the bus */
+    msgbus_t *bus;
+    uint32_t topic_mask;            /* Topics delivered to this subscriber */
+    msgbus_policy_t policy;         /* Behaviour when the ring is full */
+    uint32_t dropped;               /* Messages lost to backpressure */
+
+    /* Waiters */
+    wait_node_t *rx_wait_head;      /* Receivers waiting for a message */
+    wait_node_t *rx_wait_tail;
+    wait_node_t *tx_wait_head;      /* Publishers waiting for room */
+    wait_node_t *tx_wait_tail;
+
+    /* Ring of message references */
+    size_t depth;
+    size_t count;
+    size_t head;                    /* Read index */
+    size_t tail;                    /* Write index */
+    void *ring[];
+};
+
+struct msgbus {
+    mempool_t *pool;                /* Message storage */
+    msgbus_sub_t *subs;             /* Subscriber list */
+    spinlock_t lock;                /* Protects the list and every ring */
+};
+
+PERF_COUNTER(perf_msgbus_publish, "msgbus.publish");
+PERF_COUNTER(perf_msgbus_deliver, "msgbus.deliver");
+PERF_COUNTER(perf_msgbus_drop, "msgbus.drop");
+PERF_COUNTER(perf_msgbus_full, "msgbus.full");
+
+/* Add a node to the linked list tail */
+static void _add_to_wait_list(wait_node_t **head, wait_node_t **tail, wait_node_t *node) {
+    node->next = NULL;
+    if (*tail) {
+        (*tail)->next = node;
+    } else {
+        *head = node;
+    }
+    *tail = node;
+}
+
+/* Remove and return the first node from the linked list */
+static void* _pop_from_wait_list(wait_node_t **head, wait_node_t **tail) {
+    if (!*head) {
+        return NULL;
+    }
+
+    wait_node_t *node = *head;
+    void *task = node->task;
+
+    *head = node->next;
+    if (*head == NULL) {
+        *tail = NULL;
+    }
+    return task;
+}
+
+/* Take the oldest reference off a ring. Lock held. */
+static void* _ring_pop(msgbus_sub_t *sub) {
+    void *msg = sub->ring[sub->head];
+    sub->head = (sub->head + 1U) % sub->depth;
+    sub->count--;
+    return msg;
+}
+
+/* Queue a reference and wake a receiver. Lock held. */
+static void _ring_push(msgbus_sub_t *sub, void *msg) {
+    sub->ring[sub->tail] = msg;
+    sub->tail = (sub->tail + 1U) % sub->depth;
+    sub->count++;
+
+    void *task = _pop_from_wait_list(&sub->rx_wait_head, &sub->rx_wait_tail);
+    if (task) {
+        task_unblock((task_t*)task);
+    }
+}
+
+/* Pop a reference and wake a publisher waiting for room. Lock held, ring not empty. */
+static void* _take_locked(msgbus_sub_t *sub) {
+    void *msg = _ring_pop(sub);
+
+    void *task = _pop_from_wait_list(&sub->tx_wait_head, &sub->tx_wait_tail);
+    if (task) {
+        task_unblock((task_t*)task);
+    }
+    return msg;
+}
+
+/* First blocking subscriber of the topic with a full ring. Lock held. */
+static msgbus_sub_t* _find_full_blocking(msgbus_t *bus, uint32_t bit) {
+    for (msgbus_sub_t *sub = bus->subs; sub; sub = sub->next) {
+        if ((sub->topic_mask & bit) && sub->policy == MSGBUS_BLOCK && sub->count == sub->depth) {
+            return sub;
+        }
+    }
+    return NULL;
+}
+
+/* Hand one reference to every matching subscriber. Lock held. */
+static uint32_t _deliver_locked(msgbus_t *bus, uint32_t bit, void *msg) {
+    uint32_t delivered = 0;
+
+    for (msgbus_sub_t *sub = bus->subs; sub; sub = sub->next) {
+        if (!(sub->topic_mask & bit)) {
+            continue;
+        }
+
+        if (sub->count == sub->depth) {
+            sub->dropped++;
+            PERF_INC_LOCKED(perf_msgbus_drop);
+            if (sub->policy == MSGBUS_BLOCK) {
+                continue;       /* ISR publish: this subscriber misses it */
+            }
+            msgbus_release(_ring_pop(sub));
+        }
+
+        _ring_push(sub, msg);
+        delivered++;
+    }
+
+    /* Nobody can reach the message before the lock drops, so one add covers all */
+    if (delivered) {
+        (void)arch_atomic_add(&MSG_HDR(msg)->refs, delivered);
+    }
+    PERF_INC_LOCKED(perf_msgbus_publish);
+    PERF_ADD(perf_msgbus_deliver, delivered);
+    return delivered;
+}
+
+/* Create a bus and its message pool */
+msgbus_t* msgbus_create(size_t msg_size, size_t msg_count) {
+    if (msg_size == 0 || msg_count == 0) {
+        return NULL;
+    }
+
+    msgbus_t *bus = (msgbus_t*)allocator_malloc(sizeof(msgbus_t));
+    if (!bus) {
+        return NULL;
+    }
+
+    /* Round the payload up too, so every pool item keeps the header alignment */
+    size_t item_size = HDR_SIZE + ((msg_size + (HDR_ALIGN - 1U)) & ~(size_t)(HDR_ALIGN - 1U));
+    bus->pool = mempool_create(item_size, msg_count);
+    if (!bus->pool) {
+        allocator_free(bus);
+        return NULL;
+    }
+
+    bus->subs = NULL;
+    spinlock_init(&bus->lock);
+    return bus;
+}
+
+/* Delete a bus and its message pool */
+void msgbus_delete(msgbus_t *bus) {
+    if (!bus) {
+        return;
+    }
+    mempool_delete(bus->pool);
+    allocator_free(bus);
+}
+
+/* Add a subscriber with its own reference ring */
+msgbus_sub_t* msgbus_subscribe(msgbus_t *bus, uint32_t topic_mask, size_t depth, msgbus_policy_t policy) {
+    if (!bus || depth == 0 || topic_mask == 0) {
+        return NULL;
+    }
+
+    msgbus_sub_t *sub = (msgbus_sub_t*)allocator_malloc(sizeof(msgbus_sub_t) + depth * sizeof(void*));
+    if (!sub) {
+        return NULL;
+    }
+
+    sub->bus = bus;
+    sub->topic_mask = topic_mask;
+    sub->policy = policy;
+    sub->dropped = 0;
+    sub->rx_wait_head = NULL;
+    sub->rx_wait_tail = NULL;
+    sub->tx_wait_head = NULL;
+    sub->tx_wait_tail = NULL;
+    sub->depth = depth;
+    sub->count = 0;
+    sub->head = 0;
+    sub->tail = 0;
+
+    uint32_t flags = spin_lock(&bus->lock);
+    sub->next = bus->subs;
+    bus->subs = sub;
+    spin_unlock(&bus->lock, flags);
+
+    return sub;
+}
+
+/* Unlink a subscriber, drop its queued references and free it */
+void msgbus_unsubscribe(msgbus_sub_t *sub) {
+    if (!sub) {
+        return;
+    }
+
+    msgbus_t *bus = sub->bus;
+    uint32_t flags = spin_lock(&bus->lock);
+
+    msgbus_sub_t **link = &bus->subs;
+    while (*link && *link != sub) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        *link = sub->next;
+    }
+
+    while (sub->count > 0) {
+        msgbus_release(_ring_pop(sub));
+    }
+
+    /* Blocked publishers retry against the remaining subscribers */
+    while (1) {
+        void *task = _pop_from_wait_list(&sub->tx_wait_head, &sub->tx_wait_tail);
+        if (!task) {
+            break;
+        }
+        task_unblock((task_t*)task);
+    }
+
+    spin_unlock(&bus->lock, flags);
+    allocator_free(sub);
+}
+
+/* Allocate a message holding the publisher's reference */
+void* msgbus_alloc(msgbus_t *bus) {
+    if (!bus) {
+        return NULL;
+    }
+
+    msg_hdr_t *hdr = (msg_hdr_t*)mempool_alloc(bus->pool);
+    if (!hdr) {
+        return NULL;
+    }
+
+    hdr->bus = bus;
+    hdr->refs = 1;
+    hdr->topic = 0;
+    return (uint8_t*)hdr + HDR_SIZE;
+}
+
+/* Publish to all subscribers of the topic, blocking on full MSGBUS_BLOCK rings */
+int msgbus_publish(msgbus_t *bus, uint8_t topic, void *msg) {
+    if (!bus || !msg || topic >= MSGBUS_MAX_TOPICS) {
+        return -1;
+    }
+
+    task_t *current = (task_t*)task_get_current();
+    if (!current) {
+        return -1;
+    }
+
+    wait_node_t *node = task_get_wait_node(current);
+    node->task = current;
+    uint32_t bit = MSGBUS_TOPIC(topic);
+    MSG_HDR(msg)->topic = topic;
+
+    while (1) {
+        uint32_t flags = spin_lock(&bus->lock);
+
+        /* All-or-nothing: wait until every blocking subscriber has room */
+        msgbus_sub_t *full = _find_full_blocking(bus, bit);
+        if (!full) {
+            uint32_t delivered = _deliver_locked(bus, bit, msg);
+            spin_unlock(&bus->lock, flags);
+
+            msgbus_release(msg);
+            return (int)delivered;
+        }
+
+        PERF_INC_LOCKED(perf_msgbus_full);
+        _add_to_wait_list(&full->tx_wait_head, &full->tx_wait_tail, node);
+        task_block_on(current, full);
+
+        spin_unlock(&bus->lock, flags);
+        /* Yield CPU until the subscriber takes a message */
+        platform_yield();
+    }
+}
+
+/* Publish without blocking; full MSGBUS_BLOCK subscribers miss the message */
+int msgbus_publish_from_isr(msgbus_t *bus, uint8_t topic, void *msg) {
+    if (!bus || !msg || topic >= MSGBUS_MAX_TOPICS) {
+        return -1;
+    }
+
+    MSG_HDR(msg)->topic = topic;
+
+    uint32_t flags = spin_lock(&bus->lock);
+    uint32_t delivered = _deliver_locked(bus, MSGBUS_TOPIC(topic), msg);
+    spin_unlock(&bus->lock, flags);
+
+    msgbus_release(msg);
+    return (int)delivered;
+}
+
+/* Take the next message, blocking while the ring is empty */
+void* msgbus_receive(msgbus_sub_t *sub) {
+    if (!sub) {
+        return NULL;
+    }
+
+    task_t *current = (task_t*)task_get_current();
+    if (!current) {
+        return NULL;
+    }
+
+    wait_node_t *node = task_get_wait_node(current);
+    node->task = current;
+    msgbus_t *bus = sub->bus;
+
+    while (1) {
+        uint32_t flags = spin_lock(&bus->lock);
+
+        if (sub->count > 0) {
+            void *msg = _take_locked(sub);
+            spin_unlock(&bus->lock, flags);
+            return msg;
+        }
+
+        _add_to_wait_list(&sub->rx_wait_head, &sub->rx_wait_tail, node);
+        task_block_on(current, sub);
+
+        spin_unlock(&bus->lock, flags);
+        /* Yield CPU until a message is published */
+        platform_yield();
+    }
+}
+
+/* Take the next message if there is one */
+void* msgbus_try_receive(msgbus_sub_t *sub) {
+    if (!sub) {
+        return NULL;
+    }
+
+    msgbus_t *bus = sub->bus;
+    void *msg = NULL;
+
+    uint32_t flags = spin_lock(&bus->lock);
+    if (sub->count > 0) {
+        msg = _take_locked(sub);
+    }
+    spin_unlock(&bus->lock, flags);
+
+    return msg;
+}
+
+/* Drop a reference; the last one returns the message to the pool */
+void msgbus_release(void *msg) {
+    if (!msg) {
+        return;
+    }
+
+    msg_hdr_t *hdr = MSG_HDR(msg);
+    if (arch_atomic_add(&hdr->refs, (uint32_t)-1) == 1U) {
+        mempool_free(hdr->bus->pool, hdr);
+    }
+}
+
+/* Topic the message was published on */
+uint8_t msgbus_msg_topic(const void *msg) {
+    if (!msg) {
+        return 0;
+    }
+    return ((const msg_hdr_t*)((const uint8_t*)msg - HDR_SIZE))->topic;
+}
+
+/* Messages lost to backpressure */
+uint32_t msgbus_get_dropped(const msgbus_sub_t *sub) {
+    return sub ? sub->dropped : 0U;
+}
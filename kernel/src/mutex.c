@@ -51,17 +51,28 @@ static uint8_t _get_max_waiter_weight(wait_node_t *head) {
 /* Initialize a mutex structure */
 void so_mutex_init(so_mutex_t *m) {
     spinlock_init(&m->lock);
-    m->owner = NULL;
+    m->state = 0;
     m->wait_head = NULL;
     m->wait_tail = NULL;
 }
 
-/* Acquire the lock. If busy, block current task and yield. */
+/* Acquire the lock. Fast path is one CAS; if busy, block current task and yield. */
 void so_mutex_lock(so_mutex_t *m) {
     task_t *current_task = (task_t*)task_get_current();
     if (!current_task) {
         return;
     }
+    uintptr_t self = (uintptr_t)current_task;
+
+    /* Uncontended: claim the free word */
+    if (arch_atomic_cas_ptr(&m->state, 0, self)) {
+        return;
+    }
+
+    /* Check if we already own it (Recursive/Re-entry) */
+    if ((m->state & ~SO_MUTEX_WAITERS) == self) {
+        return;
+    }
 
     /* Reuse the wait node since we can't be blocked on a queue and mutex simultaneously */
     wait_node_t *node = task_get_wait_node(current_task);
@@ -70,22 +81,33 @@ void so_mutex_lock(so_mutex_t *m) {
 
     while(1) {
         uint32_t flags = spin_lock(&m->lock);
-        
-        /* Check if we already own it (Recursive/Re-entry) */
-        if (m->owner == current_task) {
+        uintptr_t state = m->state;
+
+        /* Handed to us by the unlocker, or already ours */
+        if ((state & ~SO_MUTEX_WAITERS) == self) {
             spin_unlock(&m->lock, flags);
             return;
         }
-        
-        /* If unlocked, take ownership */
-        if (m->owner == NULL) {
-            m->owner = current_task;
+
+        /* Released meanwhile: race the fast path for it */
+        if (state == 0) {
+            uint32_t taken = arch_atomic_cas_ptr(&m->state, 0, self);
             spin_unlock(&m->lock, flags);
-            return;
+            if (taken) {
+                return;
+            }
+            continue;
+        }
+
+        /* Publish the waiter so the owner's CAS unlock fails */
+        if (!(state & SO_MUTEX_WAITERS) &&
+            !arch_atomic_cas_ptr(&m->state, state, state | SO_MUTEX_WAITERS)) {
+            spin_unlock(&m->lock, flags);
+            continue;
         }
 
         /* Boost owner if we have higher priority */
-        task_t *owner = (task_t*)m->owner;
+        task_t *owner = (task_t*)(state & ~SO_MUTEX_WAITERS);
         uint8_t curr_w = task_get_weight(current_task);
         if (curr_w > task_get_weight(owner)) {
             task_boost_weight(owner, curr_w);
@@ -93,7 +115,7 @@ void so_mutex_lock(so_mutex_t *m) {
 
         /* If locked, add to wait queue */
         _add_to_wait_list(&m->wait_head, &m->wait_tail, node);
-        task_set_state(current_task, TASK_BLOCKED); 
+        task_block_on(current_task, m);
 
         spin_unlock(&m->lock, flags);
         
@@ -102,13 +124,21 @@ void so_mutex_lock(so_mutex_t *m) {
     }
 }
 
-/* Release the lock and wake up one waiting task */
+/* Release the lock. Fast path is one CAS; otherwise wake up one waiting task. */
 void so_mutex_unlock(so_mutex_t *m) {
+    task_t *current = (task_t*)task_get_current();
+    uintptr_t self = (uintptr_t)current;
+
+    /* No waiters means nobody boosted us through this mutex */
+    arch_dmb();
+    if (current && arch_atomic_cas_ptr(&m->state, self, 0)) {
+        return;
+    }
+
     uint32_t flags = spin_lock(&m->lock);
 
     /* Only the owner can unlock */
-    task_t *current = (task_t*)task_get_current();
-    if(m->owner != current) {
+    if(!current || (m->state & ~SO_MUTEX_WAITERS) != self) {
         spin_unlock(&m->lock, flags);
         return;
     }
@@ -121,8 +151,9 @@ void so_mutex_unlock(so_mutex_t *m) {
     if (next_task) {
         task_t *next = (task_t*)next_task;
         
-        /* Pass ownership directly */
-        m->owner = next;
+        /* Pass ownership directly; only the holder of m->lock touches a
+         * word with the waiters bit set, so a plain store is enough */
+        m->state = (uintptr_t)next | (m->wait_head ? SO_MUTEX_WAITERS : 0U);
         
         /* Check if new owner needs priority boost from remaining waiters */
         uint8_t max_waiter = _get_max_waiter_weight(m->wait_head);
@@ -133,7 +164,7 @@ void so_mutex_unlock(so_mutex_t *m) {
         task_unblock(next);
     } else {
         /* No one waiting, clear ownership */
-        m->owner = NULL;
+        m->state = 0;
     }
 
     spin_unlock(&m->lock, flags);
@@ -0,0 +1,245 @@
+#include "pbuf.h"
+#include "mempool.h"
+#include "allocator.h"
+#include "arch_ops.h"
+#include "utils.h"
+#include "perf.h"
+
+#define PBUF_DATA(p)    ((uint8_t*)((p) + 1))
+
+struct pbuf_pool {
+    mempool_t *chunks;          /* pbuf_t header + chunk_size data bytes each */
+    uint16_t chunk_size;
+};
+
+PERF_COUNTER(perf_pbuf_alloc, "pbuf.alloc");
+PERF_COUNTER(perf_pbuf_alloc_fail, "pbuf.alloc_fail");
+
+/* Take one chunk with its payload at 'offset' and 'len' valid bytes */
+static pbuf_t* _chunk_alloc(pbuf_pool_t *pool, uint16_t offset, uint16_t len) {
+    pbuf_t *c = (pbuf_t*)mempool_alloc(pool->chunks);
+    if (!c) {
+        PERF_INC(perf_pbuf_alloc_fail);
+        return NULL;
+    }
+
+    PERF_INC(perf_pbuf_alloc);
+    c->next = NULL;
+    c->pool = pool;
+    c->payload = PBUF_DATA(c) + offset;
+    c->len = len;
+    c->tot_len = len;
+    c->ref = 1;
+    return c;
+}
+
+/* Free bytes after the payload of a chunk */
+static size_t _tailroom(const pbuf_t *c) {
+    return (size_t)(PBUF_DATA(c) + c->pool->chunk_size - (c->payload + c->len));
+}
+
+/* Create a chunk pool */
+pbuf_pool_t* pbuf_pool_create(size_t chunk_size, size_t count) {
+    if (chunk_size == 0 || chunk_size > 0xFFFFU || count == 0) {
+        return NULL;
+    }
+
+    pbuf_pool_t *pool = (pbuf_pool_t*)allocator_malloc(sizeof(pbuf_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->chunks = mempool_create(sizeof(pbuf_t) + chunk_size, count);
+    if (!pool->chunks) {
+        allocator_free(pool);
+        return NULL;
+    }
+
+    pool->chunk_size = (uint16_t)chunk_size;
+    return pool;
+}
+
+/* Delete a chunk pool */
+void pbuf_pool_delete(pbuf_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+    mempool_delete(pool->chunks);
+    allocator_free(pool);
+}
+
+/* Data bytes per chunk */
+size_t pbuf_pool_chunk_size(const pbuf_pool_t *pool) {
+    return pool ? pool->chunk_size : 0U;
+}
+
+/* Allocate a chain long enough for len bytes after the headroom */
+pbuf_t* pbuf_alloc(pbuf_pool_t *pool, size_t len, size_t headroom) {
+    if (!pool || headroom >= pool->chunk_size || len > 0xFFFFU) {
+        return NULL;
+    }
+
+    size_t first = pool->chunk_size - headroom;
+    if (first > len) {
+        first = len;
+    }
+
+    pbuf_t *head = _chunk_alloc(pool, (uint16_t)headroom, (uint16_t)first);
+    if (!head) {
+        return NULL;
+    }
+    head->tot_len = (uint16_t)len;
+
+    pbuf_t *last = head;
+    size_t remaining = len - first;
+    while (remaining > 0) {
+        size_t n = (remaining < pool->chunk_size) ? remaining : pool->chunk_size;
+        pbuf_t *c = _chunk_alloc(pool, 0, (uint16_t)n);
+        if (!c) {
+            pbuf_free(head);
+            return NULL;
+        }
+        c->tot_len = (uint16_t)remaining;
+        last->next = c;
+        last = c;
+        remaining -= n;
+    }
+    return head;
+}
+
+/* Take another reference to the packet */
+void pbuf_ref(pbuf_t *p) {
+    if (p) {
+        (void)arch_atomic_add(&p->ref, 1U);
+    }
+}
+
+/* Drop a reference, freeing chunks until one is still shared */
+void pbuf_free(pbuf_t *p) {
+    while (p) {
+        if (arch_atomic_add(&p->ref, (uint32_t)-1) != 1U) {
+            return;
+        }
+        pbuf_t *next = p->next;
+        mempool_free(p->pool->chunks, p);
+        p = next;
+    }
+}
+
+/* Grow the first chunk into its headroom */
+uint8_t* pbuf_push_header(pbuf_t *p, size_t n) {
+    if (!p || (size_t)(p->payload - PBUF_DATA(p)) < n || p->tot_len + n > 0xFFFFU) {
+        return NULL;
+    }
+
+    p->payload -= n;
+    p->len = (uint16_t)(p->len + n);
+    p->tot_len = (uint16_t)(p->tot_len + n);
+    return p->payload;
+}
+
+/* Shrink the first chunk from the front */
+int pbuf_pull_header(pbuf_t *p, size_t n) {
+    if (!p || n > p->len) {
+        return -1;
+    }
+
+    p->payload += n;
+    p->len = (uint16_t)(p->len - n);
+    p->tot_len = (uint16_t)(p->tot_len - n);
+    return 0;
+}
+
+/* Reserve n contiguous bytes at the end of the chain */
+uint8_t* pbuf_put_tail(pbuf_t *p, size_t n) {
+    if (!p || n > p->pool->chunk_size || p->tot_len + n > 0xFFFFU) {
+        return NULL;
+    }
+
+    pbuf_t *last = p;
+    while (last->next) {
+        last = last->next;
+    }
+
+    pbuf_t *c = NULL;
+    if (_tailroom(last) < n) {
+        c = _chunk_alloc(p->pool, 0, (uint16_t)n);
+        if (!c) {
+            return NULL;
+        }
+    }
+
+    /* Every chunk already in the chain now covers the new bytes */
+    for (pbuf_t *it = p; it; it = it->next) {
+        it->tot_len = (uint16_t)(it->tot_len + n);
+    }
+
+    uint8_t *tail;
+    if (c) {
+        last->next = c;
+        tail = c->payload;
+    } else {
+        tail = last->payload + last->len;
+        last->len = (uint16_t)(last->len + n);
+    }
+    return tail;
+}
+
+/* Link tail behind head; head now owns the caller's reference to tail */
+void pbuf_cat(pbuf_t *head, pbuf_t *tail) {
+    if (!head || !tail) {
+        return;
+    }
+
+    pbuf_t *c = head;
+    while (1) {
+        c->tot_len = (uint16_t)(c->tot_len + tail->tot_len);
+        if (!c->next) {
+            break;
+        }
+        c = c->next;
+    }
+    c->next = tail;
+}
+
+/* Copy out of the chain starting at a byte offset */
+size_t pbuf_copy_out(const pbuf_t *p, void *dst, size_t len, size_t offset) {
+    uint8_t *out = (uint8_t*)dst;
+    size_t copied = 0;
+
+    for (; p && copied < len; p = p->next) {
+        if (offset >= p->len) {
+            offset -= p->len;
+            continue;
+        }
+        size_t n = p->len - offset;
+        if (n > len - copied) {
+            n = len - copied;
+        }
+        utils_memcpy(out + copied, p->payload + offset, n);
+        copied += n;
+        offset = 0;
+    }
+    return copied;
+}
+
+/* Copy into the chain starting at a byte offset */
+size_t pbuf_copy_in(pbuf_t *p, const void *src, size_t len, size_t offset) {
+    const uint8_t *in = (const uint8_t*)src;
+    size_t copied = 0;
+
+    for (; p && copied < len; p = p->next) {
+        if (offset >= p->len) {
+            offset -= p->len;
+            continue;
+        }
+        size_t n = p->len - offset;
+        if (n > len - copied) {
+            n = len - copied;
+        }
+        utils_memcpy(p->payload + offset, in + copied, n);
+        copied += n;
+        offset = 0;
+    }
+    return copied;
+}
@@ -0,0 +1,178 @@
+#include "perf.h"
+#include "cli.h"
+#include "platform.h"
+#include "scheduler.h"
+#include "utils.h"
+
+#if PERF_ENABLE
+
+#define PERF_MAX_INTERVAL_MS    60000U
+
+/* Bounds of the counter section, provided by the linker */
+extern perf_counter_t __start_perf_counters[];
+extern perf_counter_t __stop_perf_counters[];
+
+uint32_t perf_count(void) {
+    return (uint32_t)(__stop_perf_counters - __start_perf_counters);
+}
+
+const perf_counter_t *perf_get(uint32_t index) {
+    if (index >= perf_count()) {
+        return NULL;
+    }
+    return &__start_perf_counters[index];
+}
+
+const perf_counter_t *perf_find(const char *name) {
+    if (!name) {
+        return NULL;
+    }
+    for (const perf_counter_t *c = __start_perf_counters; c < __stop_perf_counters; c++) {
+        if (utils_strcmp(c->name, name) == 0) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+uint32_t perf_read(const perf_counter_t *c) {
+    if (!c) {
+        return 0;
+    }
+    if (c->kind == PERF_KIND_GAUGE) {
+        return c->value[0];
+    }
+    uint32_t sum = 0;
+    for (uint32_t cpu = 0; cpu < MAX_CPUS; cpu++) {
+        sum += c->value[cpu];
+    }
+    return sum;
+}
+
+void perf_snapshot(perf_snapshot_t *snap) {
+    if (!snap) {
+        return;
+    }
+    uint32_t n = perf_count();
+    if (n > PERF_MAX_COUNTERS) {
+        n = PERF_MAX_COUNTERS;
+    }
+    snap->ticks = (uint32_t)platform_get_ticks();
+    snap->count = n;
+    for (uint32_t i = 0; i < n; i++) {
+        snap->value[i] = perf_read(&__start_perf_counters[i]);
+    }
+}
+
+void perf_diff(const perf_snapshot_t *before, const perf_snapshot_t *after, perf_snapshot_t *delta) {
+    if (!before || !after || !delta) {
+        return;
+    }
+    uint32_t n = (before->count < after->count) ? before->count : after->count;
+    for (uint32_t i = 0; i < n; i++) {
+        if (__start_perf_counters[i].kind == PERF_KIND_GAUGE) {
+            delta->value[i] = after->value[i];
+        } else {
+            delta->value[i] = after->value[i] - before->value[i];  /* Wrap-safe */
+        }
+    }
+    delta->ticks = after->ticks - before->ticks;
+    delta->count = n;
+}
+
+/* Match a counter name against an optional prefix */
+static int perf_match(const char *name, const char *prefix) {
+    if (!prefix) {
+        return 1;
+    }
+    while (*prefix) {
+        if (*name++ != *prefix++) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* CLI Command Handler: perf [interval_ms] [prefix] */
+static int cmd_perf_handler(int argc, char **argv) {
+    const char *prefix = NULL;
+    uint32_t ms = 0;
+
+    if (argc >= 2) {
+        if (argv[1][0] >= '0' && argv[1][0] <= '9') {
+            int val = utils_atoi(argv[1]);
+            if (val <= 0 || (uint32_t)val > PERF_MAX_INTERVAL_MS) {
+                cli_printf("Usage: perf [interval_ms (1-%u)] [prefix]\r\n", PERF_MAX_INTERVAL_MS);
+                return -1;
+            }
+            ms = (uint32_t)val;
+            if (argc >= 3) {
+                prefix = argv[2];
+            }
+        } else {
+            prefix = argv[1];
+        }
+    }
+
+    if (ms == 0) {
+        /* Totals since boot */
+        cli_printf("%-24s %10s\r\n", "Counter", "Total");
+        for (uint32_t i = 0; i < perf_count(); i++) {
+            const perf_counter_t *c = &__start_perf_counters[i];
+            if (perf_match(c->name, prefix)) {
+                cli_printf("%-24s %10u%s\r\n", c->name, perf_read(c),
+                           (c->kind == PERF_KIND_GAUGE) ? " (gauge)" : "");
+            }
+        }
+        return 0;
+    }
+
+    /* Rates over an interval */
+    perf_snapshot_t before;
+    perf_snapshot_t after;
+    uint32_t ticks = (ms * SYSTICK_FREQ_HZ) / 1000U;
+    if (ticks == 0) {
+        ticks = 1;
+    }
+
+    perf_snapshot(&before);
+    while ((uint32_t)platform_get_ticks() - before.ticks < ticks) {
+        if (task_sleep_ticks(ticks - ((uint32_t)platform_get_ticks() - before.ticks)) != 0) {
+            break;
+        }
+    }
+    perf_snapshot(&after);
+    perf_diff(&before, &after, &after);
+    if (after.ticks == 0) {
+        after.ticks = 1;
+    }
+
+    cli_printf("%-24s %10s %10s   (%u ms)\r\n", "Counter", "Delta", "Rate/s",
+               (after.ticks * 1000U) / SYSTICK_FREQ_HZ);
+    for (uint32_t i = 0; i < after.count; i++) {
+        const perf_counter_t *c = &__start_perf_counters[i];
+        if (!perf_match(c->name, prefix)) {
+            continue;
+        }
+        if (c->kind == PERF_KIND_GAUGE) {
+            cli_printf("%-24s %10u %10s\r\n", c->name, after.value[i], "-");
+        } else {
+            uint32_t rate = (uint32_t)(((uint64_t)after.value[i] * SYSTICK_FREQ_HZ) / after.ticks);
+            cli_printf("%-24s %10u %10u\r\n", c->name, after.value[i], rate);
+        }
+    }
+    return 0;
+}
+
+static const cli_command_t perf_cmd = {
+    .name = "perf",
+    .help = "Perf counters [interval_ms] [prefix]",
+    .handler = cmd_perf_handler
+};
+
+/* Register the CLI command */
+void perf_init(void) {
+    cli_register_command(&perf_cmd);
+}
+
+#endif /* PERF_ENABLE */
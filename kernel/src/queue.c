@@ -6,28 +6,13 @@
 #include "platform.h"
 #include "spinlock.h"
 #include "logger.h"
+#include "perf.h"
 
-struct queue {
-    void *buffer;                   /* Pointer to the allocated data storage */
-    size_t item_size;               /* Size of a single item in bytes */
-    size_t capacity;                /* Maximum number of items the queue can hold */
-    size_t count;                   /* Current number of items in the queue */
-    size_t head;                    /* Read index (where to take next) */
-    size_t tail;                    /* Write index (where to put next) */
-    
-    /* Wait queues */
-    wait_node_t *rx_wait_head;      /* Head of RX wait list */
-    wait_node_t *rx_wait_tail;      /* Tail of RX wait list */
-    
-    wait_node_t *tx_wait_head;      /* Head of TX wait list */
-    wait_node_t *tx_wait_tail;      /* Tail of TX wait list */
-
-    /* Notification Callback */
-    queue_notify_cb_t callback;      /* Function to call when data is added */
-    void *callback_arg;              /* Argument for the callback */
-
-    spinlock_t lock;                 /* Queue-specific lock */
-};
+PERF_COUNTER(perf_queue_push, "queue.push");
+PERF_COUNTER(perf_queue_pop, "queue.pop");
+PERF_COUNTER(perf_queue_full, "queue.full");
+PERF_COUNTER(perf_queue_empty, "queue.empty");
+PERF_COUNTER(perf_queue_drop, "queue.drop");
 
 /* Add task to wait list */
 static void _add_to_wait_list(wait_node_t **head, wait_node_t **tail, wait_node_t *node) {
@@ -42,7 +27,7 @@ static void _add_to_wait_list(wait_node_t **head, wait_node_t **tail, wait_node_
 }
 
 /* Remove and return first task from wait list */
-static void* _pop_from_wait_list(wait_node_t **head, wait_node_t **tail) {
+static RAMFUNC void* _pop_from_wait_list(wait_node_t **head, wait_node_t **tail) {
     if (!*head) {
         return NULL;
     }
@@ -82,48 +67,180 @@ static void _remove_task_from_list(wait_node_t **head, wait_node_t **tail, void
     }
 }
 
-/* Create a queue, allocate struct and buffer */
-queue_t* queue_create(size_t item_size, size_t capacity) {
-    if (item_size == 0 || capacity == 0){
-        return NULL;
+/* Highest lane holding items. Caller holds the lock and q->count > 0. */
+static inline RAMFUNC queue_lane_t* _top_lane(queue_t *q) {
+    return &q->lane[31 - __builtin_clz(q->lane_mask)];
+}
+
+/* Account for n items added to a lane. Caller holds the lock. */
+static inline RAMFUNC void _lane_added(queue_t *q, queue_lane_t *lane, size_t n) {
+    lane->count += n;
+    q->count += n;
+    q->lane_mask |= 1UL << (lane - q->lane);
+}
+
+/* Account for n items removed from a lane. Caller holds the lock. */
+static inline RAMFUNC void _lane_removed(queue_t *q, queue_lane_t *lane, size_t n) {
+    lane->head = (lane->head + n) % q->capacity;
+    lane->count -= n;
+    q->count -= n;
+    if (lane->count == 0) {
+        q->lane_mask &= ~(1UL << (lane - q->lane));
     }
+}
 
-    /* Allocate queue control block */
-    queue_t *q = (queue_t*)allocator_malloc(sizeof(queue_t));
-    if (!q) {
-        return NULL;
+/* Copy one item into a lane and wake a receiver. Caller holds the lock. */
+static RAMFUNC void _put_locked(queue_t *q, queue_lane_t *lane, const void *item) {
+    utils_memcpy(lane->ring + (lane->tail * q->item_size), item, q->item_size);
+    lane->tail = (lane->tail + 1) % q->capacity;
+    _lane_added(q, lane, 1);
+    PERF_INC_LOCKED(perf_queue_push);
+
+    /* If a task is waiting to receive, wake it up */
+    void *task = _pop_from_wait_list(&q->rx_wait_head, &q->rx_wait_tail);
+    if (task) {
+        task_unblock((task_t*)task);
     }
 
-    /* Allocate data buffer */
-    q->buffer = allocator_malloc(item_size * capacity);
-    if (!q->buffer) {
-        allocator_free(q);
-#if LOG_ENABLE
-        logger_log("Queue Create Fail", 0, 0);
-#endif
-        return NULL;
+    /* Notify callback if registered */
+    if (q->callback) {
+        q->callback(q->callback_arg);
+    }
+}
+
+/* Copy 'chunk' items (at most the free space) into a lane and wake receivers. Caller holds the lock. */
+static void _put_arr_locked(queue_t *q, queue_lane_t *lane, const uint8_t *ptr, size_t chunk) {
+    /* Perform write (handling circular wrap) */
+    size_t tail = lane->tail;
+    size_t first_part = q->capacity - tail;
+
+    if (chunk <= first_part) {
+        utils_memcpy(lane->ring + tail * q->item_size, ptr, chunk * q->item_size);
+        lane->tail = (tail + chunk) % q->capacity;
+    } else {
+        utils_memcpy(lane->ring + tail * q->item_size, ptr, first_part * q->item_size);
+        utils_memcpy(lane->ring, ptr + first_part * q->item_size, (chunk - first_part) * q->item_size);
+        lane->tail = chunk - first_part;
+    }
+    _lane_added(q, lane, chunk);
+    PERF_ADD(perf_queue_push, chunk);
+
+    /* Wake up receivers (one for each item written, up to chunk size) */
+    size_t woken = 0;
+    while (woken < chunk && q->rx_wait_head) {
+        void *task = _pop_from_wait_list(&q->rx_wait_head, &q->rx_wait_tail);
+        if (task) task_unblock((task_t*)task);
+        woken++;
     }
 
+    if (q->callback) q->callback(q->callback_arg);
+}
+
+/* Copy the next item out of the highest lane and wake a sender. Caller holds the lock. */
+static RAMFUNC void _take_locked(queue_t *q, void *buffer) {
+    queue_lane_t *lane = _top_lane(q);
+    utils_memcpy(buffer, lane->ring + (lane->head * q->item_size), q->item_size);
+    _lane_removed(q, lane, 1);
+    PERF_INC_LOCKED(perf_queue_pop);
+
+    /* If a task is waiting to send to this lane, wake it up */
+    void *task = _pop_from_wait_list(&lane->tx_wait_head, &lane->tx_wait_tail);
+    if (task) {
+        task_unblock((task_t*)task);
+    }
+}
+
+/* Discard the n oldest items of a lane. Caller holds the lock. */
+static RAMFUNC void _drop_oldest_locked(queue_t *q, queue_lane_t *lane, size_t n) {
+    _lane_removed(q, lane, n);
+    q->dropped += (uint32_t)n;
+    PERF_ADD(perf_queue_drop, n);
+}
+
+/* Create a queue, allocate struct and buffer */
+queue_t* queue_create(size_t item_size, size_t capacity) {
+    return queue_create_prio(item_size, capacity, 1);
+}
+
+/* Set up a control block and its lanes over a buffer; lanes live in 'lane', or in q for one */
+static void _queue_setup(queue_t *q, queue_lane_t *lane_arr, void *buffer,
+                         size_t item_size, size_t capacity, size_t lanes) {
+    q->buffer = buffer;
     q->item_size = item_size;
     q->capacity = capacity;
     q->count = 0;
-    q->head = 0;
-    q->tail = 0;
 
     /* Initialize wait queues for blocking tasks */
     q->rx_wait_head = NULL;
     q->rx_wait_tail = NULL;
-    
-    q->tx_wait_head = NULL;
-    q->tx_wait_tail = NULL;
 
     q->callback = NULL;
     q->callback_arg = NULL;
 
+    q->overflow = QUEUE_OVERFLOW_BLOCK;
+    q->dropped = 0;
+
+    q->is_static = 0;
+    q->lane_mask = 0;
+    q->lanes = lanes;
+    q->lane = lane_arr ? lane_arr : &q->lane0;
+    for (size_t i = 0; i < lanes; i++) {
+        queue_lane_t *lane = &q->lane[i];
+        lane->ring = (uint8_t*)buffer + i * capacity * item_size;
+        lane->count = 0;
+        lane->head = 0;
+        lane->tail = 0;
+        lane->tx_wait_head = NULL;
+        lane->tx_wait_tail = NULL;
+    }
+
     spinlock_init(&q->lock);
+}
+
+/* Create a queue with 'lanes' priority rings of 'capacity' items each */
+queue_t* queue_create_prio(size_t item_size, size_t capacity, size_t lanes) {
+    if (item_size == 0 || capacity == 0 || lanes == 0 || lanes > QUEUE_MAX_LANES){
+        return NULL;
+    }
+
+    /* Allocate queue control block, with the lanes behind it if there is more than one */
+    size_t lane_bytes = (lanes > 1) ? lanes * sizeof(queue_lane_t) : 0;
+    queue_t *q = (queue_t*)allocator_malloc(sizeof(queue_t) + lane_bytes);
+    if (!q) {
+        return NULL;
+    }
+
+    /* Allocate data buffer */
+    void *buffer = allocator_malloc(item_size * capacity * lanes);
+    if (!buffer) {
+        allocator_free(q);
+#if LOG_ENABLE
+        LOG_ERR(KERNEL, "Queue Create Fail", 0, 0);
+#endif
+        return NULL;
+    }
+
+    _queue_setup(q, (lanes > 1) ? (queue_lane_t*)(q + 1) : NULL, buffer, item_size, capacity, lanes);
     return q;
 }
 
+/* Set up a queue in caller-provided memory */
+int queue_init_static_prio(queue_t *q, queue_lane_t *lane, void *buffer,
+                           size_t item_size, size_t capacity, size_t lanes) {
+    if (!q || !buffer || item_size == 0 || capacity == 0 || lanes == 0 || lanes > QUEUE_MAX_LANES ||
+        (lanes > 1 && !lane)) {
+        return -1;
+    }
+    _queue_setup(q, lane, buffer, item_size, capacity, lanes);
+    q->is_static = 1;
+    return 0;
+}
+
+/* Single-lane form of queue_init_static_prio() */
+int queue_init_static(queue_t *q, void *buffer, size_t item_size, size_t capacity) {
+    return queue_init_static_prio(q, NULL, buffer, item_size, capacity, 1);
+}
+
 /* Delete queue, free buffer and struct */
 void queue_delete(queue_t *q) {
     if (!q) {
@@ -134,10 +251,15 @@ void queue_delete(queue_t *q) {
     while (q->rx_wait_head) {
         _pop_from_wait_list(&q->rx_wait_head, &q->rx_wait_tail);
     }
-    while (q->tx_wait_head) {
-        _pop_from_wait_list(&q->tx_wait_head, &q->tx_wait_tail);
+    for (size_t i = 0; i < q->lanes; i++) {
+        while (q->lane[i].tx_wait_head) {
+            _pop_from_wait_list(&q->lane[i].tx_wait_head, &q->lane[i].tx_wait_tail);
+        }
     }
 
+    if (q->is_static) {
+        return;
+    }
     if (q->buffer) {
         allocator_free(q->buffer);
     }
@@ -146,9 +268,19 @@ void queue_delete(queue_t *q) {
 
 /* Push item to queue. block if full. */
 int queue_push(queue_t *q, const void *item) {
-    if (!q || !item) {
+    return queue_push_prio(q, item, 0);
+}
+
+/* Push item into a lane. Block if that lane is full. */
+int queue_push_prio(queue_t *q, const void *item, uint32_t prio) {
+    if (!q || !item || prio >= q->lanes) {
         return -1;
     }
+
+    /* Drop policies never wait for room */
+    if (q->overflow != QUEUE_OVERFLOW_BLOCK) {
+        return queue_push_prio_from_isr(q, item, prio);
+    }
     
     task_t *current = (task_t*)task_get_current();
     if (!current) {
@@ -160,40 +292,27 @@ int queue_push(queue_t *q, const void *item) {
     node->task = current;
     node->next = NULL;
 
+    queue_lane_t *lane = &q->lane[prio];
+
     while (1) {
         uint32_t flags = spin_lock(&q->lock);
 
         /* Check if there is space */
-        if (q->count < q->capacity) {
-            /* Copy data to the circular buffer */
-            uint8_t *target = (uint8_t*)q->buffer + (q->tail * q->item_size);
-            utils_memcpy(target, item, q->item_size);
-            q->tail = (q->tail + 1) % q->capacity;
-            q->count++;
-
-            /* If a task is waiting to receive, wake it up */
-            void *task = _pop_from_wait_list(&q->rx_wait_head, &q->rx_wait_tail);
-            if (task) {
-                task_unblock((task_t*)task);
-            }
-
-            /* Notify callback if registered */
-            if (q->callback) {
-                q->callback(q->callback_arg);
-            }
-
+        if (lane->count < q->capacity) {
+            _put_locked(q, lane, item);
             spin_unlock(&q->lock, flags);
             return 0;
         }
 
-        /* Queue is full, add current task to TX wait queue and block */
+        /* Lane is full, add current task to its TX wait queue and block */
+        PERF_INC_LOCKED(perf_queue_full);
         
         /* Ensure we aren't already in the list */
-        _remove_task_from_list(&q->tx_wait_head, &q->tx_wait_tail, current);
+        _remove_task_from_list(&lane->tx_wait_head, &lane->tx_wait_tail, current);
         
-        _add_to_wait_list(&q->tx_wait_head, &q->tx_wait_tail, node);
+        _add_to_wait_list(&lane->tx_wait_head, &lane->tx_wait_tail, node);
         
-        task_set_state(current, TASK_BLOCKED);
+        task_block_on(current, q);
 
         spin_unlock(&q->lock, flags);
         /* Yield CPU to allow other tasks to run (and hopefully consume data) */
@@ -206,6 +325,10 @@ int queue_push_arr(queue_t *q, const void *data, size_t count) {
     if (!q || !data) {
         return -1;
     }
+
+    if (q->overflow != QUEUE_OVERFLOW_BLOCK) {
+        return (queue_push_arr_from_isr(q, data, count) < 0) ? -1 : 0;
+    }
     
     const uint8_t *ptr = (const uint8_t*)data;
     size_t remaining = count;
@@ -219,14 +342,17 @@ int queue_push_arr(queue_t *q, const void *data, size_t count) {
     node->task = current;
     node->next = NULL;
 
+    queue_lane_t *lane = &q->lane[0];
+
     while (remaining > 0) {
         uint32_t flags = spin_lock(&q->lock);
 
         /* If queue is full, block */
-        if (q->count == q->capacity) {
-            _remove_task_from_list(&q->tx_wait_head, &q->tx_wait_tail, current);
-            _add_to_wait_list(&q->tx_wait_head, &q->tx_wait_tail, node);
-            task_set_state(current, TASK_BLOCKED);
+        if (lane->count == q->capacity) {
+            PERF_INC_LOCKED(perf_queue_full);
+            _remove_task_from_list(&lane->tx_wait_head, &lane->tx_wait_tail, current);
+            _add_to_wait_list(&lane->tx_wait_head, &lane->tx_wait_tail, node);
+            task_block_on(current, q);
             
             spin_unlock(&q->lock, flags);
             platform_yield();
@@ -234,37 +360,13 @@ int queue_push_arr(queue_t *q, const void *data, size_t count) {
         }
 
         /* Calculate how much we can write in this chunk */
-        size_t space = q->capacity - q->count;
+        size_t space = q->capacity - lane->count;
         size_t chunk = (remaining < space) ? remaining : space;
 
-        /* Perform write (handling circular wrap) */
-        size_t tail = q->tail;
-        size_t end = q->capacity;
-        size_t first_part = end - tail;
-
-        if (chunk <= first_part) {
-            utils_memcpy((uint8_t*)q->buffer + tail * q->item_size, ptr, chunk * q->item_size);
-            q->tail = (tail + chunk) % end;
-        } else {
-            utils_memcpy((uint8_t*)q->buffer + tail * q->item_size, ptr, first_part * q->item_size);
-            utils_memcpy((uint8_t*)q->buffer, ptr + first_part * q->item_size, (chunk - first_part) * q->item_size);
-            q->tail = chunk - first_part;
-        }
-
-        q->count += chunk;
+        _put_arr_locked(q, lane, ptr, chunk);
         ptr += chunk * q->item_size;
         remaining -= chunk;
 
-        /* Wake up receivers (one for each item written, up to chunk size) */
-        size_t woken = 0;
-        while (woken < chunk && q->rx_wait_head) {
-             void *task = _pop_from_wait_list(&q->rx_wait_head, &q->rx_wait_tail);
-             if (task) task_unblock((task_t*)task);
-             woken++;
-        }
-
-        if (q->callback) q->callback(q->callback_arg);
-
         spin_unlock(&q->lock, flags);
     }
     return 0;
@@ -290,28 +392,18 @@ int queue_pop(queue_t *q, void *buffer) {
 
         /* Check if there is data */
         if (q->count > 0) {
-            /* Copy data from the circular buffer */
-            uint8_t *source = (uint8_t*)q->buffer + (q->head * q->item_size);
-            utils_memcpy(buffer, source, q->item_size);
-            q->head = (q->head + 1) % q->capacity;
-            q->count--;
-
-            /* If a task is waiting to send, wake it up */
-            void *task = _pop_from_wait_list(&q->tx_wait_head, &q->tx_wait_tail);
-            if (task) {
-                task_unblock((task_t*)task);
-            }
-
+            _take_locked(q, buffer);
             spin_unlock(&q->lock, flags);
             return 0;
         }
 
         /* Queue is empty, add current task to RX wait queue and block */
+        PERF_INC_LOCKED(perf_queue_empty);
         _remove_task_from_list(&q->rx_wait_head, &q->rx_wait_tail, current);
 
         _add_to_wait_list(&q->rx_wait_head, &q->rx_wait_tail, node);
         
-        task_set_state(current, TASK_BLOCKED);
+        task_block_on(current, q);
 
         spin_unlock(&q->lock, flags);
         platform_yield();
@@ -319,42 +411,87 @@ int queue_pop(queue_t *q, void *buffer) {
 }
 
 /* Push item from ISR. Non-blocking. */
-int queue_push_from_isr(queue_t *q, const void *item) {
-    if (!q || !item) {
+RAMFUNC int queue_push_from_isr(queue_t *q, const void *item) {
+    return queue_push_prio_from_isr(q, item, 0);
+}
+
+/* Push item into a lane from ISR. Non-blocking. */
+RAMFUNC int queue_push_prio_from_isr(queue_t *q, const void *item, uint32_t prio) {
+    if (!q || !item || prio >= q->lanes) {
         return -1;
     }
 
+    queue_lane_t *lane = &q->lane[prio];
     uint32_t flags = spin_lock(&q->lock);
 
-    /* Check space immediately */
-    if (q->count < q->capacity) {
-        /* Copy data */
-        uint8_t *target = (uint8_t*)q->buffer + (q->tail * q->item_size);
-        utils_memcpy(target, item, q->item_size);
-        q->tail = (q->tail + 1) % q->capacity;
-        q->count++;
-
-        /* Wake up a waiting receiver if any */
-        void *task = _pop_from_wait_list(&q->rx_wait_head, &q->rx_wait_tail);
-        if (task) {
-            task_unblock((task_t*)task);
+    if (lane->count == q->capacity) {
+        if (q->overflow == QUEUE_OVERFLOW_DROP_NEWEST) {
+            q->dropped++;
+            PERF_INC_LOCKED(perf_queue_drop);
+            spin_unlock(&q->lock, flags);
+            return 0;
         }
-
-        /* Notify callback if registered */
-        if (q->callback) {
-            q->callback(q->callback_arg);
+        if (q->overflow == QUEUE_OVERFLOW_DROP_OLDEST) {
+            _drop_oldest_locked(q, lane, 1);
         }
+    }
 
+    /* Check space immediately */
+    if (lane->count < q->capacity) {
+        _put_locked(q, lane, item);
         spin_unlock(&q->lock, flags);
         return 0;
     }
 
+    PERF_INC_LOCKED(perf_queue_full);
     spin_unlock(&q->lock, flags);
     return -1; /* Queue full */
 }
 
+/* Push as many items as fit. Non-blocking. */
+int queue_push_arr_from_isr(queue_t *q, const void *data, size_t count) {
+    if (!q || !data) {
+        return -1;
+    }
+
+    const uint8_t *ptr = (const uint8_t*)data;
+    queue_lane_t *lane = &q->lane[0];
+    uint32_t flags = spin_lock(&q->lock);
+
+    if (q->overflow == QUEUE_OVERFLOW_DROP_OLDEST) {
+        /* Only the last 'capacity' items can survive; make room for them */
+        if (count > q->capacity) {
+            size_t skip = count - q->capacity;
+            ptr += skip * q->item_size;
+            count = q->capacity;
+            q->dropped += (uint32_t)skip;
+            PERF_ADD(perf_queue_drop, skip);
+        }
+        if (count > q->capacity - lane->count) {
+            _drop_oldest_locked(q, lane, count - (q->capacity - lane->count));
+        }
+    }
+
+    size_t space = q->capacity - lane->count;
+    size_t chunk = (count < space) ? count : space;
+    if (q->overflow == QUEUE_OVERFLOW_DROP_NEWEST && chunk < count) {
+        q->dropped += (uint32_t)(count - chunk);
+        PERF_ADD(perf_queue_drop, count - chunk);
+    }
+    if (chunk == 0) {
+        PERF_INC_LOCKED(perf_queue_full);
+        spin_unlock(&q->lock, flags);
+        return 0;
+    }
+
+    _put_arr_locked(q, lane, ptr, chunk);
+
+    spin_unlock(&q->lock, flags);
+    return (int)chunk;
+}
+
 /* Pop item from ISR. Non-blocking. */
-int queue_pop_from_isr(queue_t *q, void *buffer) {
+RAMFUNC int queue_pop_from_isr(queue_t *q, void *buffer) {
     if (!q || !buffer) {
         return -1;
     }
@@ -362,22 +499,12 @@ int queue_pop_from_isr(queue_t *q, void *buffer) {
     uint32_t flags = spin_lock(&q->lock);
 
     if (q->count > 0) {
-        /* Copy data from the circular buffer */
-        uint8_t *source = (uint8_t*)q->buffer + (q->head * q->item_size);
-        utils_memcpy(buffer, source, q->item_size);
-        q->head = (q->head + 1) % q->capacity;
-        q->count--;
-
-        /* If a task is waiting to send, wake it up */
-        void *task = _pop_from_wait_list(&q->tx_wait_head, &q->tx_wait_tail);
-        if (task) {
-            task_unblock((task_t*)task);
-        }
-
+        _take_locked(q, buffer);
         spin_unlock(&q->lock, flags);
         return 0;
     }
 
+    PERF_INC_LOCKED(perf_queue_empty);
     spin_unlock(&q->lock, flags);
     return -1;
 }
@@ -391,9 +518,9 @@ int queue_peek(queue_t *q, void *buffer) {
     uint32_t flags = spin_lock(&q->lock);
 
     if (q->count > 0) {
-        /* Copy data from the circular buffer */
-        uint8_t *source = (uint8_t*)q->buffer + (q->head * q->item_size);
-        utils_memcpy(buffer, source, q->item_size);
+        /* Copy data from the head of the highest lane */
+        queue_lane_t *lane = _top_lane(q);
+        utils_memcpy(buffer, lane->ring + (lane->head * q->item_size), q->item_size);
         
         spin_unlock(&q->lock, flags);
         return 0;
@@ -411,20 +538,26 @@ void queue_reset(queue_t *q) {
 
     uint32_t flags = spin_lock(&q->lock);
 
-    q->head = 0;
-    q->tail = 0;
     q->count = 0;
-
-    /* Wake up all tasks waiting to send, as the queue is now empty */
-    while (1) {
-        void *task = _pop_from_wait_list(&q->tx_wait_head, &q->tx_wait_tail);
-        if (!task) break;
-        task_unblock((task_t*)task);
+    q->lane_mask = 0;
+
+    for (size_t i = 0; i < q->lanes; i++) {
+        queue_lane_t *lane = &q->lane[i];
+        lane->head = 0;
+        lane->tail = 0;
+        lane->count = 0;
+
+        /* Wake up all tasks waiting to send, as the queue is now empty */
+        while (1) {
+            void *task = _pop_from_wait_list(&lane->tx_wait_head, &lane->tx_wait_tail);
+            if (!task) break;
+            task_unblock((task_t*)task);
+        }
     }
 
     spin_unlock(&q->lock, flags);
 #if LOG_ENABLE
-    logger_log("Queue Reset", 0, 0);
+    LOG_DBG(KERNEL, "Queue Reset", 0, 0);
 #endif
 }
 
@@ -438,3 +571,24 @@ void queue_set_push_callback(queue_t *q, queue_notify_cb_t cb, void *arg) {
     q->callback_arg = arg;
     spin_unlock(&q->lock, flags);
 }
+
+/* Set the overflow policy */
+void queue_set_overflow_policy(queue_t *q, queue_overflow_t policy) {
+    if (!q) {
+        return;
+    }
+    uint32_t flags = spin_lock(&q->lock);
+    q->overflow = policy;
+    spin_unlock(&q->lock, flags);
+}
+
+/* Get the number of items lost to the overflow policy */
+uint32_t queue_get_dropped(queue_t *q) {
+    if (!q) {
+        return 0;
+    }
+    uint32_t flags = spin_lock(&q->lock);
+    uint32_t dropped = q->dropped;
+    spin_unlock(&q->lock, flags);
+    return dropped;
+}
@@ -6,6 +6,7 @@
 #include "arch_ops.h"
 #include "spinlock.h"
 #include "logger.h"
+#include "perf.h"
 
 /* Modular arithmetic comparison for vruntime to handle overflow/wrap-around */
 #define VRUNTIME_LT(a, b)   ((int64_t)((a) - (b)) < 0)
@@ -24,6 +25,8 @@ typedef struct task_struct {
     struct task_struct *next;           /* Link for Sleep/Free/Zombie lists */
     size_t          stack_size;         /* Size of allocated stack in bytes */
     wait_node_t     wait_node;          /* Generic wait node for blocking */
+    const void      *wait_obj;          /* Object blocked on (queue, mutex...), NULL if none */
+    ipc_state_t     ipc;                /* Synchronous IPC endpoint */
     uint64_t        vruntime;           /* Virtual runtime (fairness metric) */
     uint64_t        total_cpu_ticks;
     uint64_t        last_switch_tick;
@@ -61,6 +64,8 @@ typedef struct {
     task_t          *idle_task;
     task_t          *curr;
     uint32_t        heap_size;
+    task_t          *handoff;               /* Runs next, ahead of the heap (IPC) */
+    uint8_t         yield_pending;          /* A wake-up asked to preempt curr */
     spinlock_t      lock;
 } scheduler_cpu_t;
 
@@ -75,7 +80,7 @@ static scheduler_cpu_t    cpu_sched[MAX_CPUS];
  */
 
 /* Swap two tasks in the heap and update their index tracking */
-static inline void _swap_tasks(scheduler_cpu_t *ctx, uint32_t i, uint32_t j) {
+static inline RAMFUNC void _swap_tasks(scheduler_cpu_t *ctx, uint32_t i, uint32_t j) {
     task_t *temp = ctx->ready_heap[i];
     ctx->ready_heap[i] = ctx->ready_heap[j];
     ctx->ready_heap[j] = temp;
@@ -86,7 +91,7 @@ static inline void _swap_tasks(scheduler_cpu_t *ctx, uint32_t i, uint32_t j) {
 }
 
 /* Bubble up an element to maintain min-heap property */
-static void _heap_up(scheduler_cpu_t *ctx, uint32_t index) {
+static RAMFUNC void _heap_up(scheduler_cpu_t *ctx, uint32_t index) {
     while (index > 0) {
         uint32_t parent = (index - 1) / 2;
         if (VRUNTIME_LT(ctx->ready_heap[index]->vruntime, ctx->ready_heap[parent]->vruntime)) {
@@ -99,7 +104,7 @@ static void _heap_up(scheduler_cpu_t *ctx, uint32_t index) {
 }
 
 /* Bubble down an element to maintain min-heap property */
-static void _heap_down(scheduler_cpu_t *ctx, uint32_t index) {
+static RAMFUNC void _heap_down(scheduler_cpu_t *ctx, uint32_t index) {
     while (1) {
         uint32_t left = 2 * index + 1; /* left child */
         uint32_t right = 2 * index + 2; /* right child */
@@ -124,7 +129,7 @@ static void _heap_down(scheduler_cpu_t *ctx, uint32_t index) {
 }
 
 /* Insert a task into the priority queue */
-static void _heap_insert(scheduler_cpu_t *ctx, task_t *t) {
+static RAMFUNC void _heap_insert(scheduler_cpu_t *ctx, task_t *t) {
     if (ctx->heap_size >= MAX_TASKS) {
         return;
     }
@@ -136,7 +141,7 @@ static void _heap_insert(scheduler_cpu_t *ctx, task_t *t) {
 }
 
 /* Extract the task with the lowest vruntime value (highest priority) */
-static task_t* _heap_pop_min(scheduler_cpu_t *ctx) {
+static RAMFUNC task_t* _heap_pop_min(scheduler_cpu_t *ctx) {
     if (ctx->heap_size == 0) {
         return NULL;
     }
@@ -154,7 +159,7 @@ static task_t* _heap_pop_min(scheduler_cpu_t *ctx) {
 }
 
 /* Remove a specific task from the middle of the heap */
-static void _heap_remove(scheduler_cpu_t *ctx, task_t *t) {
+static RAMFUNC void _heap_remove(scheduler_cpu_t *ctx, task_t *t) {
     if (t->heap_index == -1 || t->heap_index >= (int32_t)ctx->heap_size) {
         return;
     }
@@ -175,7 +180,7 @@ static void _heap_remove(scheduler_cpu_t *ctx, task_t *t) {
 }
 
 /* Get the minimum vruntime value currently in the system */
-static inline uint64_t _get_min_vruntime(scheduler_cpu_t *ctx) {
+static inline RAMFUNC uint64_t _get_min_vruntime(scheduler_cpu_t *ctx) {
     if (ctx->heap_size > 0) {
         return ctx->ready_heap[0]->vruntime;
     }
@@ -183,7 +188,7 @@ static inline uint64_t _get_min_vruntime(scheduler_cpu_t *ctx) {
 }
 
 /* Remove task from sleep list */
-static void _remove_from_sleep_list(scheduler_cpu_t *ctx, task_t *task) {
+static RAMFUNC void _remove_from_sleep_list(scheduler_cpu_t *ctx, task_t *task) {
     if (task == NULL) {
         return;
     }
@@ -229,8 +234,9 @@ static void _insert_into_sleep_list(scheduler_cpu_t *ctx, task_t *task) {
     }
 }
 
-static inline void _wake_sleeping_task(scheduler_cpu_t *ctx, task_t *task) {
+static inline RAMFUNC void _wake_sleeping_task(scheduler_cpu_t *ctx, task_t *task) {
      task->state = TASK_READY;
+     task->wait_obj = NULL;
      /* Insert into heap */
      uint64_t min_v = _get_min_vruntime(ctx);
      if (VRUNTIME_LT(task->vruntime, min_v)) {
@@ -239,7 +245,7 @@ static inline void _wake_sleeping_task(scheduler_cpu_t *ctx, task_t *task) {
      _heap_insert(ctx, task);
 }
 
-static void _process_sleep_list(scheduler_cpu_t *ctx, uint32_t current_ticks) {
+static RAMFUNC void _process_sleep_list(scheduler_cpu_t *ctx, uint32_t current_ticks) {
     task_t *curr = ctx->sleep_list;
 
     /* Process tasks at head of the list whose time has come */
@@ -250,8 +256,8 @@ static void _process_sleep_list(scheduler_cpu_t *ctx, uint32_t current_ticks) {
     }
 }
 
-/* Unblock a task (Assumes Lock Held) */
-static void _unblock_task_locked(scheduler_cpu_t *ctx, task_t *task) {
+/* Unblock a task (Assumes Lock Held). Returns 1 if it should preempt curr */
+static RAMFUNC int _unblock_task_locked(scheduler_cpu_t *ctx, task_t *task) {
     if (task->state == TASK_BLOCKED || task->state == TASK_SLEEPING) {
         /* Remove from sleep list if it was waiting with timeout */
         if (task->state == TASK_SLEEPING) {
@@ -260,6 +266,7 @@ static void _unblock_task_locked(scheduler_cpu_t *ctx, task_t *task) {
         }
 
         task->state = TASK_READY;
+        task->wait_obj = NULL;
         
         /* Insert to heap */
         uint64_t min_v = _get_min_vruntime(ctx);
@@ -267,7 +274,15 @@ static void _unblock_task_locked(scheduler_cpu_t *ctx, task_t *task) {
             task->vruntime = min_v;
         }
         _heap_insert(ctx, task);
+
+        /* Same rule as scheduler_tick(): idle always yields, otherwise lower vruntime wins */
+        if (ctx->curr && ctx->curr->state == TASK_RUNNING &&
+            (ctx->curr->is_idle || VRUNTIME_LT(task->vruntime, ctx->curr->vruntime))) {
+            ctx->yield_pending = 1;
+            return 1;
+        }
     }
+    return 0;
 }
 
 /* Idle task function */
@@ -326,6 +341,13 @@ static void _task_garbage_collection_locked(void) {
     while (g_sched.zombie_list != NULL) {
         task_t *t = g_sched.zombie_list;
         g_sched.zombie_list = t->next;
+
+#if STACK_GUARD_ENABLE
+        /* A task that exited is current until the switch; unguard before reuse */
+        if (t == cpu_sched[arch_get_cpu_id()].curr) {
+            arch_stack_guard_set(NULL, 0);
+        }
+#endif
         
         /* Free the stack memory */
         if (t->stack_ptr != NULL && allocator_is_heap_pointer(t->stack_ptr)) {
@@ -406,13 +428,19 @@ void scheduler_init(void) {
     g_sched.pool[MAX_TASKS - 1].next = NULL;
     g_sched.free_list = &g_sched.pool[0];
     spinlock_init(&g_sched.lock);
+    spinlock_stats_register(&g_sched.lock, "sched");
     
     for (int i = 0; i < MAX_CPUS; i++) {
         spinlock_init(&cpu_sched[i].lock);
+        spinlock_stats_register(&cpu_sched[i].lock, "sched.rq");
     }
+
+#if STACK_GUARD_ENABLE
+    arch_stack_guard_set(NULL, 0);
+#endif
     
 #if LOG_ENABLE
-    logger_log("Scheduler Init", 0, 0);
+    LOG_INF(KERNEL, "Scheduler Init", 0, 0);
 #endif
 }
 
@@ -433,6 +461,10 @@ void scheduler_start(void) {
         if (ctx->idle_task != NULL) {
             ctx->curr = ctx->idle_task;
             ctx->curr->state = TASK_RUNNING;
+            ctx->curr->last_switch_tick = (uint64_t)platform_get_ticks();
+#if STACK_GUARD_ENABLE
+            arch_stack_guard_set(ctx->curr->stack_ptr, ctx->curr->stack_size);
+#endif
             platform_start_scheduler((size_t)ctx->curr->psp);
             return; /* Should not be reached on real hardware, but needed for tests */
         }
@@ -443,11 +475,14 @@ void scheduler_start(void) {
     ctx->curr = min_vrt_task;
     
 #if LOG_ENABLE
-    logger_log("Scheduler Start", 0, 0);
+    LOG_INF(KERNEL, "Scheduler Start", 0, 0);
 #endif
     /* Mark first task as running */
     ctx->curr->state = TASK_RUNNING;
     ctx->curr->last_switch_tick = (uint64_t)platform_get_ticks();
+#if STACK_GUARD_ENABLE
+    arch_stack_guard_set(ctx->curr->stack_ptr, ctx->curr->stack_size);
+#endif
     
     /* Hand over control to the platform scheduler start */
     platform_start_scheduler((size_t)ctx->curr->psp);
@@ -541,7 +576,7 @@ int32_t task_create(void (*task_func)(void *), void *arg, size_t stack_size_byte
         g_sched.free_list = new_task;
         spin_unlock(&g_sched.lock, stat);
 #if LOG_ENABLE
-        logger_log("Task Create Fail", 0, 0);
+        LOG_ERR(KERNEL, "Task Create Fail", 0, 0);
 #endif
         return -1;
     }
@@ -551,6 +586,8 @@ int32_t task_create(void (*task_func)(void *), void *arg, size_t stack_size_byte
     new_task->notify_state = 0;
     new_task->event_mask = 0;
     new_task->event_flags = 0;
+    new_task->wait_obj = NULL;
+    utils_memset(&new_task->ipc, 0, sizeof(new_task->ipc));
     
     /* Assign CPU affinity (Round Robin) */
     new_task->cpu_id = g_sched.next_cpu;
@@ -587,7 +624,7 @@ int32_t task_create(void (*task_func)(void *), void *arg, size_t stack_size_byte
     spin_unlock(&g_sched.lock, stat);
 
 #if LOG_ENABLE
-    logger_log("Task Create ID:%u", new_task->task_id, 0);
+    LOG_INF(KERNEL, "Task Create ID:%u", new_task->task_id, 0);
 #endif
     return new_task->task_id;
 }
@@ -672,6 +709,8 @@ int32_t task_create_static(void (*task_func)(void *),
     new_task->notify_state = 0;
     new_task->event_mask = 0;
     new_task->event_flags = 0;
+    new_task->wait_obj = NULL;
+    utils_memset(&new_task->ipc, 0, sizeof(new_task->ipc));
     new_task->cpu_id = g_sched.next_cpu;
     g_sched.next_cpu = (g_sched.next_cpu + 1) % MAX_CPUS;
     
@@ -724,7 +763,7 @@ int32_t task_delete(uint16_t task_id) {
     spin_unlock(&g_sched.lock, stat);
 
 #if LOG_ENABLE
-    if (res == 0) logger_log("Task Delete ID:%u", task_id, 0);
+    if (res == 0) LOG_INF(KERNEL, "Task Delete ID:%u", task_id, 0);
 #endif
     return res;
 }
@@ -757,14 +796,30 @@ void task_exit(void) {
     }
 }
 
+PERF_COUNTER(perf_sched_switch, "sched.switch");
+PERF_COUNTER(perf_sched_isr_yield, "sched.isr_yield");
+PERF_COUNTER(perf_sched_handoff, "sched.handoff");
+PERF_COUNTER(perf_sched_stack_guard, "sched.stack_guard");
+
+/* Guard the bottom of the incoming task's stack so an overflow faults at once */
+static inline RAMFUNC void _stack_guard_switch(task_t *next) {
+#if STACK_GUARD_ENABLE
+    arch_stack_guard_set(next->stack_ptr, next->stack_size);
+#else
+    (void)next;
+#endif
+}
+
 /* Called by Platform Context Switcher to pick next task */ 
-void schedule_next_task(void) {
+RAMFUNC void schedule_next_task(void) {
     uint32_t cpu = arch_get_cpu_id();
     scheduler_cpu_t *ctx = &cpu_sched[cpu];
     
     uint32_t stat = spin_lock(&ctx->lock);
 
     uint64_t now = (uint64_t)platform_get_ticks();
+    task_t *prev = ctx->curr;
+    ctx->yield_pending = 0;     /* This switch serves any pending request */
 
     /* Account for the task that just ran */
     if (ctx->curr) {
@@ -785,6 +840,9 @@ void schedule_next_task(void) {
             /* Calculate actual ticks consumed */
             uint32_t max_slice = ctx->curr->weight * BASE_SLICE_TICKS;
             uint32_t ticks_ran = max_slice - ctx->curr->time_slice;
+            if (ctx->curr->time_slice > max_slice) {
+                ticks_ran = 0;  /* Weight dropped (inheritance ended) mid-slice */
+            }
             if (ticks_ran == 0) {
                 ticks_ran = 1; /* Minimum charge to prevent free yields */
             }
@@ -803,14 +861,25 @@ void schedule_next_task(void) {
         }
     }
 
-    /* Pick Next Task from Heap */
-    task_t *best = _heap_pop_min(ctx);
+    /* Pick Next Task: a pending handoff first, then the heap */
+    task_t *best = ctx->handoff;
+    ctx->handoff = NULL;
+    if (best != NULL && best->state == TASK_READY && best->heap_index >= 0) {
+        _heap_remove(ctx, best);
+        PERF_INC_LOCKED(perf_sched_handoff);
+    } else {
+        best = _heap_pop_min(ctx);
+    }
     
     if (best != NULL) {
         /* Found a user task */
         ctx->curr = best;
         ctx->curr->state = TASK_RUNNING;
         ctx->curr->last_switch_tick = now;
+        if (best != prev) {
+            PERF_INC_LOCKED(perf_sched_switch);
+            _stack_guard_switch(best);
+        }
         spin_unlock(&ctx->lock, stat);
         return;
     }
@@ -820,6 +889,10 @@ void schedule_next_task(void) {
         ctx->curr = ctx->idle_task;
         ctx->curr->state = TASK_RUNNING;
         ctx->curr->last_switch_tick = now;
+        if (ctx->curr != prev) {
+            PERF_INC_LOCKED(perf_sched_switch);
+            _stack_guard_switch(ctx->curr);
+        }
 
         spin_unlock(&ctx->lock, stat);
         return;
@@ -860,10 +933,16 @@ void task_check_stack_overflow(void) {
             /* Use stack_ptr and cast to check canary */
             uint32_t *stack_base = (uint32_t*)t->stack_ptr;
 
+#if STACK_GUARD_ENABLE
+            /* The running task's canary may sit under its guard; the guard covers it */
+            if (t == curr) {
+                continue;
+            }
+#endif
             if (stack_base != NULL && stack_base[0] != STACK_CANARY) {
                 if (t == curr) {
 #if LOG_ENABLE
-                    logger_log("Stack Overflow! ID:%u", t->task_id, 0);
+                    LOG_ERR(KERNEL, "Stack Overflow! ID:%u", t->task_id, 0);
 #endif
                     current_task_overflow = 1;
                 } else {
@@ -885,6 +964,27 @@ void task_check_stack_overflow(void) {
     }
 }
 
+/* Kill the running task after it hit its stack guard */
+int task_stack_guard_fault(void) {
+    task_t *curr = (task_t*)task_get_current();
+    if (curr == NULL || curr->is_idle || curr->task_id == 0) {
+        return -1;
+    }
+
+    uint16_t id = curr->task_id;
+    uint32_t stat = spin_lock(&g_sched.lock);
+    int32_t res = _task_delete_locked(id);
+    if (res == 0) {
+        PERF_INC_LOCKED(perf_sched_stack_guard);
+    }
+    spin_unlock(&g_sched.lock, stat);
+
+#if LOG_ENABLE
+    if (res == 0) LOG_ERR(KERNEL, "Stack Guard Hit! ID:%u", id, 0);
+#endif
+    return res;
+}
+
 /* Block a task */
 void task_block(task_t *task) {
     if (task == NULL) {
@@ -909,19 +1009,54 @@ void task_block(task_t *task) {
 }
 
 /* Unblock a task */
-void task_unblock(task_t *task) {
+RAMFUNC int task_unblock(task_t *task) {
     if (task == NULL) {
-        return;
+        return 0;
     }
 
     uint32_t cpu = task->cpu_id;
     if (cpu >= MAX_CPUS) {
-        return;
+        return 0;
     }
 
     uint32_t stat = spin_lock(&cpu_sched[cpu].lock);
-    _unblock_task_locked(&cpu_sched[cpu], task);
+    int preempt = _unblock_task_locked(&cpu_sched[cpu], task);
     spin_unlock(&cpu_sched[cpu].lock, stat);
+    return preempt;
+}
+
+/* Unblock a task and switch to it directly at the next yield */
+int task_unblock_handoff(task_t *task) {
+    if (task == NULL) {
+        return 0;
+    }
+
+    uint32_t cpu = arch_get_cpu_id();
+    if (task->cpu_id != cpu) {
+        task_unblock(task);
+        return 0;
+    }
+
+    scheduler_cpu_t *ctx = &cpu_sched[cpu];
+    uint32_t stat = spin_lock(&ctx->lock);
+    int queued = 0;
+
+    if (task->state == TASK_BLOCKED || task->state == TASK_SLEEPING) {
+        _unblock_task_locked(ctx, task);
+
+        /* Donate the caller's place in the timeline */
+        task_t *curr = ctx->curr;
+        if (curr && !curr->is_idle && VRUNTIME_LT(curr->vruntime, task->vruntime)) {
+            _heap_remove(ctx, task);
+            task->vruntime = curr->vruntime;
+            _heap_insert(ctx, task);
+        }
+        ctx->handoff = task;
+        queued = 1;
+    }
+
+    spin_unlock(&ctx->lock, stat);
+    return queued;
 }
 
 /* Block current task */
@@ -1024,9 +1159,10 @@ uint32_t task_notify_wait(uint8_t clear_on_exit, uint32_t wait_ticks) {
     return val;
 }
 
-void task_notify(uint16_t task_id, uint32_t value) {
+int task_notify(uint16_t task_id, uint32_t value) {
+    int preempt = 0;
     if (task_id == 0) {
-        return;
+        return 0;
     }
     
     task_t *t = g_sched.pool;
@@ -1042,7 +1178,7 @@ void task_notify(uint16_t task_id, uint32_t value) {
     if (target) {
         uint32_t cpu = target->cpu_id;
         if (cpu >= MAX_CPUS) {
-            return;
+            return 0;
         }
         
         uint32_t stat = spin_lock(&cpu_sched[cpu].lock);
@@ -1050,14 +1186,15 @@ void task_notify(uint16_t task_id, uint32_t value) {
         if (target->task_id == task_id && target->state != TASK_UNUSED) {
             target->notify_val |= value;
             target->notify_state = 1;
-            _unblock_task_locked(&cpu_sched[cpu], target);
+            preempt = _unblock_task_locked(&cpu_sched[cpu], target);
         }
         spin_unlock(&cpu_sched[cpu].lock, stat);
     }
+    return preempt;
 }
 
 /* Process System Tick (Called by ISR) */
-uint32_t scheduler_tick(void)
+RAMFUNC uint32_t scheduler_tick(void)
 {
     uint32_t cpu = arch_get_cpu_id();
     scheduler_cpu_t *ctx = &cpu_sched[cpu];
@@ -1094,12 +1231,35 @@ uint32_t scheduler_tick(void)
         }
     }
 
+    /* A wake-up since the last switch already asked for one */
+    if (ctx->yield_pending) {
+        ctx->yield_pending = 0;
+        need_reschedule = 1;
+    }
+
     spin_unlock(&ctx->lock, stat);
     return need_reschedule;
 }
 
+/* Check for a preempting wake-up on this CPU */
+int scheduler_yield_pending(void) {
+    return cpu_sched[arch_get_cpu_id()].yield_pending;
+}
+
+/* Pend a switch at ISR exit if a wake-up asked for one */
+RAMFUNC int scheduler_yield_from_isr(void) {
+    scheduler_cpu_t *ctx = &cpu_sched[arch_get_cpu_id()];
+    if (!ctx->yield_pending) {
+        return 0;
+    }
+    ctx->yield_pending = 0;
+    PERF_INC(perf_sched_isr_yield);
+    platform_yield();   /* PendSV: runs once the ISR returns */
+    return 1;
+}
+
 /* Get the handle of the currently running task */
-void *task_get_current(void) {
+RAMFUNC void *task_get_current(void) {
     uint32_t cpu = arch_get_cpu_id();
     return (void *)cpu_sched[cpu].curr;
 }
@@ -1155,6 +1315,7 @@ void task_set_state(task_t *t, task_state_t state) {
     t->state = state;
     
     if (state == TASK_READY) {
+        t->wait_obj = NULL;
         uint64_t min_v = _get_min_vruntime(&cpu_sched[cpu]);
         if (VRUNTIME_LT(t->vruntime, min_v)) {
             t->vruntime = min_v;
@@ -1182,6 +1343,17 @@ void task_set_state(task_t *t, task_state_t state) {
     spin_unlock(&cpu_sched[cpu].lock, stat);
 }
 
+/* Record what a task waits on, then block it */
+void task_block_on(task_t *t, const void *obj) {
+    t->wait_obj = obj;
+    task_set_state(t, TASK_BLOCKED);
+}
+
+/* Get the object a blocked task waits on */
+const void *task_get_wait_object(task_t *t) {
+    return t ? t->wait_obj : NULL;
+}
+
 /* Atomically get the task state */
 task_state_t task_get_state_atomic(task_t *t) {
     return (task_state_t)t->state;
@@ -1236,6 +1408,11 @@ wait_node_t* task_get_wait_node(task_t *task) {
     return &task->wait_node;
 }
 
+/* Get the embedded IPC state */
+ipc_state_t *task_get_ipc_state(task_t *task) {
+    return &task->ipc;
+}
+
 /* Set notification value */
 void task_set_notify_val(task_t *t, uint32_t val) {
     if (t) t->notify_val = val;
@@ -1263,6 +1440,22 @@ uint64_t task_get_cpu_ticks(task_t *t) {
     return t ? t->total_cpu_ticks : 0;
 }
 
+/* Get ticks this CPU has spent in its idle task, including the current stay */
+uint64_t scheduler_get_idle_ticks(void) {
+    scheduler_cpu_t *ctx = &cpu_sched[arch_get_cpu_id()];
+    uint64_t ticks = 0;
+
+    uint32_t stat = spin_lock(&ctx->lock);
+    if (ctx->idle_task != NULL) {
+        ticks = ctx->idle_task->total_cpu_ticks;
+        if (ctx->curr == ctx->idle_task) {
+            ticks += (uint64_t)platform_get_ticks() - ctx->idle_task->last_switch_tick;
+        }
+    }
+    spin_unlock(&ctx->lock, stat);
+    return ticks;
+}
+
 /* Get the base weight of a task */
 uint8_t task_get_base_weight(task_t *t) {
     return t ? t->base_weight : 0;
@@ -1275,6 +1468,13 @@ void task_restore_base_weight(task_t *t) {
     }
 }
 
+/* Set the effective weight, keeping at least the base weight */
+void task_set_inherited_weight(task_t *t, uint8_t weight) {
+    if (t) {
+        t->weight = (weight > t->base_weight) ? weight : t->base_weight;
+    }
+}
+
 /* Temporarily boost task weight (for Priority Inheritance) */
 void task_boost_weight(task_t *t, uint8_t weight) {
     if (t) {
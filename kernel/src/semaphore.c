@@ -32,17 +32,40 @@ static void* _pop_from_wait_list(wait_node_t **head, wait_node_t **tail) {
     return task;
 }
 
+/* Bump the count (capped) and make the waiters flag match the wait list. Called with s->lock held. */
+static void _post_locked(so_sem_t *s, uint32_t increment) {
+    uint32_t waiters = s->wait_head ? SO_SEM_WAITERS : 0U;
+    uint32_t state;
+    uint32_t count;
+
+    /* Fast-path waiters may still take tokens concurrently */
+    do {
+        state = s->state;
+        count = state >> SO_SEM_COUNT_SHIFT;
+        count = (s->max_count - count > increment) ? count + increment : s->max_count;
+    } while (!arch_atomic_cas(&s->state, state, (count << SO_SEM_COUNT_SHIFT) | waiters));
+}
+
 /* Initialize a semaphore */
 void so_sem_init(so_sem_t *s, uint32_t initial_count, uint32_t max_count) {
     spinlock_init(&s->lock);
-    s->count = initial_count;
+    s->state = initial_count << SO_SEM_COUNT_SHIFT;
     s->max_count = max_count;
     s->wait_head = NULL;
     s->wait_tail = NULL;
 }
 
-/* Wait for the semaphore. Block if count is 0. */
+/* Wait for the semaphore. Fast path is one CAS; block if count is 0. */
 void so_sem_wait(so_sem_t *s) {
+    /* Uncontended: take a token straight from the state word */
+    uint32_t state = s->state;
+    while (state >= SO_SEM_COUNT_ONE) {
+        if (arch_atomic_cas(&s->state, state, state - SO_SEM_COUNT_ONE)) {
+            return;
+        }
+        state = s->state;
+    }
+
     task_t *current_task = (task_t*)task_get_current();
     if (!current_task) {
         return;
@@ -55,17 +78,28 @@ void so_sem_wait(so_sem_t *s) {
 
     while(1) {
         uint32_t flags = spin_lock(&s->lock);
+        state = s->state;
 
         /* If resource available, take it */
-        if (s->count > 0) {
-            s->count--;
+        if (state >= SO_SEM_COUNT_ONE) {
+            uint32_t taken = arch_atomic_cas(&s->state, state, state - SO_SEM_COUNT_ONE);
             spin_unlock(&s->lock, flags);
-            return;
+            if (taken) {
+                return;
+            }
+            continue;
+        }
+
+        /* Publish the waiter so signal takes the slow path */
+        if (!(state & SO_SEM_WAITERS) &&
+            !arch_atomic_cas(&s->state, state, state | SO_SEM_WAITERS)) {
+            spin_unlock(&s->lock, flags);
+            continue;
         }
 
         /* No resource available. Add to wait queue and block */
         _add_to_wait_list(&s->wait_head, &s->wait_tail, node);
-        task_set_state(current_task, TASK_BLOCKED);
+        task_block_on(current_task, s);
 
         spin_unlock(&s->lock, flags);
         
@@ -74,8 +108,21 @@ void so_sem_wait(so_sem_t *s) {
     }
 }
 
-/* Give a token. Wake up one waiter if any. */
+/* Give a token. Fast path is one CAS; wake up one waiter if any. */
 void so_sem_signal(so_sem_t *s) {
+    /* Uncontended: nobody to wake, just bump the count */
+    arch_dmb();
+    uint32_t state = s->state;
+    while (!(state & SO_SEM_WAITERS)) {
+        if ((state >> SO_SEM_COUNT_SHIFT) >= s->max_count) {
+            return;
+        }
+        if (arch_atomic_cas(&s->state, state, state + SO_SEM_COUNT_ONE)) {
+            return;
+        }
+        state = s->state;
+    }
+
     uint32_t flags = spin_lock(&s->lock);
 
     /* If tasks are waiting, wake the first one */
@@ -85,9 +132,7 @@ void so_sem_signal(so_sem_t *s) {
     }
     
     /* Increment count, but cap at max */
-    if (s->count < s->max_count) {
-        s->count++;
-    }
+    _post_locked(s, 1);
 
     spin_unlock(&s->lock, flags);
 }
@@ -95,6 +140,7 @@ void so_sem_signal(so_sem_t *s) {
 /* Wake up ALL waiting tasks */
 void so_sem_broadcast(so_sem_t *s) {
     uint32_t flags = spin_lock(&s->lock);
+    uint32_t woken = 0;
 
     /* Wake everyone in the queue */
     while (1) {
@@ -104,12 +150,11 @@ void so_sem_broadcast(so_sem_t *s) {
         }
         
         task_unblock((task_t*)task);
-        
-        /* Increment count for each woken task, capped at max */
-        if (s->count < s->max_count) {
-            s->count++;
-        }
+        woken++;
     }
 
+    /* Increment count for each woken task, capped at max */
+    _post_locked(s, woken);
+
     spin_unlock(&s->lock, flags);
-}
\ No newline at end of file
+}
@@ -0,0 +1,132 @@
+#include "spinlock.h"
+#include "platform.h"
+#include "cli.h"
+#include "utils.h"
+
+#if SPINLOCK_STATS
+
+/* Locks listed by 'locks' */
+static struct {
+    spinlock_t *lock;
+    const char *name;
+} spinlock_registry[SPINLOCK_STATS_MAX_LOCKS];
+
+uint32_t spinlock_stats_now(void) {
+    return platform_get_cycles();
+}
+
+/* Called with the lock held, right after it was taken */
+void spinlock_stats_acquired(spinlock_t *lock, uint32_t waited) {
+    spinlock_stats_t *st = &lock->stats;
+    st->acquires++;
+    if (waited) {
+        st->contended++;
+        st->spin_cycles += waited;
+        if (waited > st->max_spin) {
+            st->max_spin = waited;
+        }
+    }
+    st->hold_start = platform_get_cycles();
+}
+
+/* Called with the lock still held, right before it is handed on */
+void spinlock_stats_released(spinlock_t *lock) {
+    spinlock_stats_t *st = &lock->stats;
+    uint32_t held = platform_get_cycles() - st->hold_start;
+    if (held > st->max_hold) {
+        st->max_hold = held;
+    }
+}
+
+int spinlock_stats_register(spinlock_t *lock, const char *name) {
+    int free_slot = -1;
+    for (int i = 0; i < SPINLOCK_STATS_MAX_LOCKS; i++) {
+        if (spinlock_registry[i].lock == lock) {
+            spinlock_registry[i].name = name;
+            return 0;
+        }
+        if (!spinlock_registry[i].lock && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0) {
+        return -1;
+    }
+    spinlock_registry[free_slot].name = name;
+    spinlock_registry[free_slot].lock = lock;
+    return 0;
+}
+
+/* spin_lock() without the statistics, so reading them does not count */
+static uint32_t spinlock_stats_lock(spinlock_t *lock) {
+    uint32_t flags = arch_irq_lock_kernel();
+#if defined(CONFIG_SMP)
+    (void)spin_ticket_acquire(lock);
+#else
+    (void)lock;
+#endif
+    return flags;
+}
+
+static void spinlock_stats_unlock(spinlock_t *lock, uint32_t flags) {
+#if defined(CONFIG_SMP)
+    spin_ticket_release(lock);
+#else
+    (void)lock;
+#endif
+    arch_irq_unlock_kernel(flags);
+}
+
+/* Counters are cleared under each lock so a holder never sees them torn */
+void spinlock_stats_reset(void) {
+    for (int i = 0; i < SPINLOCK_STATS_MAX_LOCKS; i++) {
+        spinlock_t *lock = spinlock_registry[i].lock;
+        if (!lock) {
+            continue;
+        }
+        uint32_t flags = spinlock_stats_lock(lock);
+        lock->stats = (spinlock_stats_t){0};
+        spinlock_stats_unlock(lock, flags);
+    }
+}
+
+/* CLI Command Handler: locks [reset] */
+static int cmd_locks_handler(int argc, char **argv) {
+    if (argc >= 2 && utils_strcmp(argv[1], "reset") == 0) {
+        spinlock_stats_reset();
+        cli_printf("Lock statistics cleared.\r\n");
+        return 0;
+    }
+
+    cli_printf("%s\r\n", platform_get_cpu_freq() ? "Cycles" : "Nanoseconds (host)");
+    cli_printf("%-12s %10s %10s %9s %9s %9s\r\n",
+               "Lock", "Acquires", "Contended", "SpinAvg", "SpinMax", "HoldMax");
+    for (int i = 0; i < SPINLOCK_STATS_MAX_LOCKS; i++) {
+        spinlock_t *lock = spinlock_registry[i].lock;
+        if (!lock) {
+            continue;
+        }
+        /* Snapshot, so the row is consistent */
+        uint32_t flags = spinlock_stats_lock(lock);
+        spinlock_stats_t st = lock->stats;
+        spinlock_stats_unlock(lock, flags);
+
+        uint32_t avg = st.contended ? (uint32_t)(st.spin_cycles / st.contended) : 0U;
+        cli_printf("%-12s %10u %10u %9u %9u %9u\r\n", spinlock_registry[i].name,
+                   st.acquires, st.contended, avg, st.max_spin, st.max_hold);
+    }
+    return 0;
+}
+
+static const cli_command_t locks_cmd = {
+    .name = "locks",
+    .help = "Spinlock contention [reset]",
+    .handler = cmd_locks_handler
+};
+
+/* Register the CLI command */
+void spinlock_stats_init(void) {
+    cli_register_command(&locks_cmd);
+}
+
+#endif /* SPINLOCK_STATS */
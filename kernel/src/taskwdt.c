@@ -0,0 +1,215 @@
+#include "taskwdt.h"
+#include "scheduler.h"
+#include "timer.h"
+#include "watchdog.h"
+#include "spinlock.h"
+#include "platform.h"
+#include "logger.h"
+#include "cli.h"
+#include "utils.h"
+#include <stddef.h>
+
+#if TASKWDT_ENABLE
+
+#define TASKWDT_MAGIC   0x54575744U   /* "DWWT" */
+
+typedef struct {
+    task_t *task;                       /* NULL if the slot is free */
+    uint32_t period;                    /* Allowed ticks between check-ins */
+    volatile uint32_t last_checkin;     /* Tick of the last check-in */
+} taskwdt_slot_t;
+
+static taskwdt_slot_t taskwdt_slots[TASKWDT_MAX_TASKS];
+static spinlock_t taskwdt_lock;
+static uint8_t taskwdt_tripped;         /* Kicking stopped, reset pending */
+
+/* Stall report from before the last reset, copied out at init */
+static taskwdt_record_t taskwdt_prev;
+static uint8_t taskwdt_prev_valid;
+
+/* Not zeroed by the startup code, so it survives the watchdog reset */
+static taskwdt_record_t taskwdt_retained __attribute__((section(".noinit")));
+
+/* CRC over everything but the crc field */
+static uint32_t taskwdt_record_crc(const taskwdt_record_t *rec) {
+    return utils_crc32(0, rec, offsetof(taskwdt_record_t, crc));
+}
+
+/* Monitor timer callback */
+static void taskwdt_timer_cb(void *arg) {
+    (void)arg;
+    taskwdt_check();
+}
+
+/* Register the calling task (or update its period if already registered) */
+int taskwdt_register(uint32_t period_ticks) {
+    task_t *current = (task_t*)task_get_current();
+    if (!current || period_ticks == 0U || period_ticks > INT32_MAX) {
+        return TASKWDT_ERR_PARAM;
+    }
+
+    int id = TASKWDT_ERR_FULL;
+    uint32_t flags = spin_lock(&taskwdt_lock);
+    for (int i = 0; i < TASKWDT_MAX_TASKS; i++) {
+        if (taskwdt_slots[i].task == current) {
+            id = i;
+            break;
+        }
+        if (!taskwdt_slots[i].task && id < 0) {
+            id = i;
+        }
+    }
+    if (id >= 0) {
+        taskwdt_slots[id].period = period_ticks;
+        taskwdt_slots[id].last_checkin = (uint32_t)platform_get_ticks();
+        taskwdt_slots[id].task = current;
+    }
+    spin_unlock(&taskwdt_lock, flags);
+    return id;
+}
+
+int taskwdt_unregister(int id) {
+    if (id < 0 || id >= TASKWDT_MAX_TASKS) {
+        return TASKWDT_ERR_PARAM;
+    }
+    uint32_t flags = spin_lock(&taskwdt_lock);
+    int res = taskwdt_slots[id].task ? 0 : TASKWDT_ERR_PARAM;
+    taskwdt_slots[id].task = NULL;
+    spin_unlock(&taskwdt_lock, flags);
+    return res;
+}
+
+/* One store, no lock: the monitor only compares it with the current tick */
+void taskwdt_checkin(int id) {
+    if (id >= 0 && id < TASKWDT_MAX_TASKS) {
+        taskwdt_slots[id].last_checkin = (uint32_t)platform_get_ticks();
+    }
+}
+
+/* Kick the hardware watchdog only if every registered task is on time */
+uint32_t taskwdt_check(void) {
+    taskwdt_slot_t *worst = NULL;
+    uint32_t worst_late = 0;
+    uint32_t stalled = 0;
+    uint8_t report = 0;
+
+    uint32_t flags = spin_lock(&taskwdt_lock);
+    uint32_t now = (uint32_t)platform_get_ticks();
+
+    for (uint32_t i = 0; i < TASKWDT_MAX_TASKS; i++) {
+        taskwdt_slot_t *s = &taskwdt_slots[i];
+        /* Signed: a check-in that lands after 'now' was read is not a stall */
+        int32_t silent = (int32_t)(now - s->last_checkin);
+        if (!s->task || silent <= (int32_t)s->period) {
+            continue;
+        }
+        stalled++;
+        if (!worst || (uint32_t)silent - s->period > worst_late) {
+            worst = s;
+            worst_late = (uint32_t)silent - s->period;
+        }
+    }
+
+    if (stalled == 0U) {
+        if (!taskwdt_tripped) {
+            watchdog_kick();
+        }
+    } else if (!taskwdt_tripped) {
+        /* Stop kicking for good and leave a report for the next boot */
+        taskwdt_tripped = 1;
+        report = 1;
+        taskwdt_retained.magic = TASKWDT_MAGIC;
+        taskwdt_retained.uptime = now;
+        taskwdt_retained.task_id = task_get_id(worst->task);
+        taskwdt_retained.state = (uint8_t)task_get_state_atomic(worst->task);
+        taskwdt_retained.stalled = (uint8_t)stalled;
+        taskwdt_retained.period = worst->period;
+        taskwdt_retained.silent = worst->period + worst_late;
+        taskwdt_retained.wait_obj = (uintptr_t)task_get_wait_object(worst->task);
+        taskwdt_retained.crc = taskwdt_record_crc(&taskwdt_retained);
+    }
+    spin_unlock(&taskwdt_lock, flags);
+
+    if (report) {
+        LOG_ERR(KERNEL, "Task %u stalled, wait %p: watchdog kick stopped",
+                taskwdt_retained.task_id, taskwdt_retained.wait_obj);
+    }
+    return stalled;
+}
+
+const taskwdt_record_t *taskwdt_last_stall(void) {
+    return taskwdt_prev_valid ? &taskwdt_prev : NULL;
+}
+
+/* Printable task state */
+static const char *taskwdt_state_str(uint32_t state) {
+    switch (state) {
+        case TASK_READY:    return "READY";
+        case TASK_RUNNING:  return "RUNNING";
+        case TASK_BLOCKED:  return "BLOCKED";
+        case TASK_SLEEPING: return "SLEEPING";
+        case TASK_ZOMBIE:   return "ZOMBIE";
+        default:            return "UNUSED";
+    }
+}
+
+/* CLI Command Handler: wdt */
+static int cmd_wdt_handler(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    uint32_t now = (uint32_t)platform_get_ticks();
+
+    cli_printf("Task watchdog: %s\r\n", taskwdt_tripped ? "TRIPPED, reset pending" : "healthy");
+    cli_printf("WDT  Task  Period  Silent  State     Wait\r\n");
+    for (uint32_t i = 0; i < TASKWDT_MAX_TASKS; i++) {
+        task_t *t = taskwdt_slots[i].task;
+        if (!t) {
+            continue;
+        }
+        cli_printf("%3u  %4u  %6u  %6u  %-8s  %p\r\n", i, task_get_id(t),
+                   taskwdt_slots[i].period, now - taskwdt_slots[i].last_checkin,
+                   taskwdt_state_str(task_get_state_atomic(t)), task_get_wait_object(t));
+    }
+
+    const taskwdt_record_t *r = taskwdt_last_stall();
+    if (r) {
+        cli_printf("Last reset: task %u silent %u/%u ticks, %s on %p, uptime %u\r\n",
+                   r->task_id, r->silent, r->period, taskwdt_state_str(r->state),
+                   (void *)r->wait_obj, r->uptime);
+    }
+    return 0;
+}
+
+static const cli_command_t wdt_cmd = {
+    .name = "wdt",
+    .help = "Task watchdog status",
+    .handler = cmd_wdt_handler
+};
+
+/* Start the hardware watchdog and the monitor timer */
+int taskwdt_init(uint32_t hw_timeout_ms) {
+    spinlock_init(&taskwdt_lock);
+    utils_memset(taskwdt_slots, 0, sizeof(taskwdt_slots));
+    taskwdt_tripped = 0;
+
+    /* Pick up the report of a stall that reset the system */
+    taskwdt_prev_valid = (taskwdt_retained.magic == TASKWDT_MAGIC &&
+                          taskwdt_retained.crc == taskwdt_record_crc(&taskwdt_retained));
+    if (taskwdt_prev_valid) {
+        taskwdt_prev = taskwdt_retained;
+        LOG_ERR(KERNEL, "Reset by task watchdog: task %u, wait %p",
+                taskwdt_prev.task_id, taskwdt_prev.wait_obj);
+    }
+    taskwdt_retained.magic = 0;
+
+    cli_register_command(&wdt_cmd);
+
+    sw_timer_t *monitor = timer_create("taskwdt", TASKWDT_CHECK_PERIOD_TICKS, 1,
+                                       taskwdt_timer_cb, NULL);
+    if (!monitor || watchdog_init(hw_timeout_ms) != 0) {
+        return -1;
+    }
+    return timer_start(monitor);
+}
+
+#endif /* TASKWDT_ENABLE */
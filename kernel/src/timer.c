@@ -6,25 +6,18 @@
 #include "utils.h"
 #include "spinlock.h"
 #include "mempool.h"
+#include "perf.h"
 
 #define TIMER_FLAG_AUTORELOAD   (1 << 0)
 #define TIMER_FLAG_ACTIVE       (1 << 1)
 
-struct sw_timer {
-    struct sw_timer *next; /* For internal linked list */
-    uint32_t expiry_tick;
-    uint32_t period_ticks;
-    const char *name;
-    timer_callback_t callback;
-    void *arg;
-    uint8_t flags;
-};
-
 static sw_timer_t *timer_list_head = NULL;
 static uint16_t timer_task_id = 0;
 static spinlock_t timer_lock;
 static mempool_t *timer_pool = NULL;
 
+PERF_COUNTER(perf_timer_fire, "timer.fire");
+
 /* Insert timer into sorted linked list (sorted by expiry_tick) */
 static void timer_insert(sw_timer_t *tmr) {
     sw_timer_t **curr = &timer_list_head;
@@ -83,6 +76,7 @@ uint32_t timer_check_expiries(void) {
                 spin_unlock(&timer_lock, flags);
                 
                 /* Execute callback (outside critical section) */
+                PERF_INC(perf_timer_fire);
                 if (tmr->callback) {
                     tmr->callback(tmr->arg);
                 }
@@ -114,6 +108,8 @@ static void timer_task_entry(void *arg) {
 /* Initialize the software timer subsystem */
 void timer_service_init(uint32_t max_timers) {
     spinlock_init(&timer_lock);
+    spinlock_stats_register(&timer_lock, "timer");
+    timer_list_head = NULL;
     
     if (max_timers == 0) {
         max_timers = TIMER_DEFAULT_POOL_SIZE;
@@ -144,16 +140,31 @@ sw_timer_t* timer_create(const char *name,
         return NULL;
     }
     
-    tmr->name = name;
-    tmr->period_ticks = period_ticks;
-    tmr->flags = auto_reload ? TIMER_FLAG_AUTORELOAD : 0;
-    tmr->callback = callback;
-    tmr->arg = arg;
-    tmr->next = NULL;
-    
+    timer_init_static(tmr, name, period_ticks, auto_reload, callback, arg);
     return tmr;
 }
 
+/* Fill in a timer record; used for pool and static timers alike */
+int timer_init_static(sw_timer_t *timer,
+                      const char *name,
+                      uint32_t period_ticks,
+                      uint8_t auto_reload,
+                      timer_callback_t callback,
+                      void *arg) {
+    if (!timer) {
+        return -1;
+    }
+
+    timer->name = name;
+    timer->period_ticks = period_ticks;
+    timer->flags = auto_reload ? TIMER_FLAG_AUTORELOAD : 0;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->next = NULL;
+    timer->expiry_tick = 0;
+    return 0;
+}
+
 /* Start a timer */
 int timer_start(sw_timer_t *timer) {
     if (!timer) {
@@ -211,7 +222,7 @@ void timer_delete(sw_timer_t *timer) {
     }
     
     timer_stop(timer);
-    mempool_free(timer_pool, timer);
+    mempool_free(timer_pool, timer);    /* Ignores static timers: not in the pool */
 }
 
 /* Get timer name */
@@ -97,3 +97,80 @@ size_t utils_strlen(const char *str) {
     }
     return len;
 }
+
+
+/* CRC-32 (IEEE), nibble table: small footprint, no 1KB table in flash */
+uint32_t utils_crc32(uint32_t crc, const void *data, size_t len) {
+    static const uint32_t crc_nibble[16] = {
+        0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+        0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+        0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+        0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+    };
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0FU];
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0FU];
+    }
+    return ~crc;
+}
+
+/* FNV-1a, 32-bit */
+uint32_t utils_fnv1a(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t h = 2166136261U;
+
+    while (len--) {
+        h ^= *p++;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/* Consistent Overhead Byte Stuffing: each block starts with the offset to the next zero */
+size_t utils_cobs_encode(const uint8_t *in, size_t len, uint8_t *out) {
+    size_t pos = 1;
+    size_t code_pos = 0;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0U) {
+            out[code_pos] = code;
+            code_pos = pos++;
+            code = 1;
+        } else {
+            out[pos++] = in[i];
+            if (++code == 0xFFU) {
+                out[code_pos] = code;
+                code_pos = pos++;
+                code = 1;
+            }
+        }
+    }
+    out[code_pos] = code;
+    out[pos++] = 0x00;
+    return pos;
+}
+
+/* Reverse utils_cobs_encode(); the write position never passes the read position */
+int32_t utils_cobs_decode(const uint8_t *in, size_t len, uint8_t *out) {
+    size_t rd = 0;
+    size_t wr = 0;
+
+    while (rd < len) {
+        uint8_t code = in[rd++];
+        if (code == 0U || rd + code - 1U > len) {
+            return -1;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            out[wr++] = in[rd++];
+        }
+        if (code != 0xFFU && rd < len) {
+            out[wr++] = 0;
+        }
+    }
+    return (int32_t)wr;
+}
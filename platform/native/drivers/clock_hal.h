@@ -0,0 +1,15 @@
+#ifndef CLOCK_HAL_NATIVE_H
+#define CLOCK_HAL_NATIVE_H
+
+#include <stdint.h>
+#include "system_clock.h"
+
+int clock_hal_set_vos(system_vos_t vos);
+int clock_hal_set_flash_latency(uint32_t ws);
+int clock_hal_msi_enable(uint8_t range);
+int clock_hal_hsi16_enable(void);
+int clock_hal_pll_enable(const sysclock_opp_t *opp);
+int clock_hal_osc_disable(sysclk_source_t src);
+int clock_hal_select(sysclk_source_t src);
+
+#endif /* CLOCK_HAL_NATIVE_H */
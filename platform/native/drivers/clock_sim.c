@@ -0,0 +1,258 @@
+#include "clock_sim.h"
+#include "utils.h"
+
+#define CLOCK_SIM_HSI16_HZ      16000000UL
+#define CLOCK_SIM_VOS1_MAX_HZ   80000000UL
+#define CLOCK_SIM_VOS2_MAX_HZ   26000000UL
+#define CLOCK_SIM_VOS2_MSI_MAX  0x9U            /* 24 MHz */
+#define CLOCK_SIM_VOS2_VCO_MAX  128000000UL
+#define CLOCK_SIM_MAX_WS        4U
+
+typedef struct {
+    uint8_t on;
+    uint8_t ready;
+} clock_sim_osc_t;
+
+typedef struct {
+    clock_sim_osc_t msi;
+    clock_sim_osc_t hsi;
+    clock_sim_osc_t pll;
+    uint8_t msi_range;
+    uint8_t pllm;
+    uint8_t plln;
+    uint8_t pllr_bits;
+    sysclk_source_t source;
+    system_vos_t vos;
+    uint32_t latency;
+} clock_sim_regs_t;
+
+/* RCC_CR MSIRANGE codes 0..11 */
+static const uint32_t msi_range_hz[] = {
+    100000UL, 200000UL, 400000UL, 800000UL, 1000000UL, 2000000UL,
+    4000000UL, 8000000UL, 16000000UL, 24000000UL, 32000000UL, 48000000UL
+};
+
+/* Highest SYSCLK for 0, 1, 2... wait states (RM0351, flash read access latency) */
+static const uint32_t ws_max_vos1[] = { 16000000UL, 32000000UL, 48000000UL, 64000000UL, 80000000UL };
+static const uint32_t ws_max_vos2[] = { 6000000UL, 12000000UL, 18000000UL, 26000000UL };
+
+/* Reset values: MSI on at 4 MHz and selected, range 1, 0 wait states */
+#define CLOCK_SIM_RESET_REGS { .msi = { 1, 1 }, .msi_range = 0x6U, \
+                               .source = SYSCLK_SRC_MSI, .vos = SYSTEM_VOS1 }
+
+static const clock_sim_regs_t clock_reset_regs = CLOCK_SIM_RESET_REGS;
+static clock_sim_regs_t clk = CLOCK_SIM_RESET_REGS;
+static clock_sim_fault_t clock_fault = CLOCK_SIM_FAULT_NONE;
+static clock_sim_stats_t clock_stats;
+static const char *clock_violation = "";
+
+static void _clock_sim_violation(const char *what) {
+    clock_stats.violations++;
+    clock_violation = what;
+}
+
+static uint32_t _clock_sim_pll_vco_hz(void) {
+    return clk.pllm ? (CLOCK_SIM_HSI16_HZ / clk.pllm) * clk.plln : 0U;
+}
+
+static uint32_t _clock_sim_ws_needed(uint32_t hz, system_vos_t vos) {
+    const uint32_t *max = (vos == SYSTEM_VOS2) ? ws_max_vos2 : ws_max_vos1;
+    uint32_t n = (vos == SYSTEM_VOS2) ? sizeof(ws_max_vos2) / sizeof(ws_max_vos2[0])
+                                      : sizeof(ws_max_vos1) / sizeof(ws_max_vos1[0]);
+    for (uint32_t ws = 0; ws < n; ws++) {
+        if (hz <= max[ws]) {
+            return ws;
+        }
+    }
+    return CLOCK_SIM_MAX_WS + 1U;   /* No latency is enough */
+}
+
+/* Check the state reached by the last operation against the datasheet limits */
+static void _clock_sim_check(void) {
+    uint32_t hz = clock_sim_get_sysclk_hz();
+
+    if (clk.vos == SYSTEM_VOS2 && hz > CLOCK_SIM_VOS2_MAX_HZ) {
+        _clock_sim_violation("SYSCLK above 26 MHz in range 2");
+    } else if (hz > CLOCK_SIM_VOS1_MAX_HZ) {
+        _clock_sim_violation("SYSCLK above 80 MHz");
+    }
+    if (clk.latency < _clock_sim_ws_needed(hz, clk.vos)) {
+        _clock_sim_violation("too few flash wait states for SYSCLK");
+    }
+    if (clk.vos == SYSTEM_VOS2 && clk.msi.on && clk.msi_range > CLOCK_SIM_VOS2_MSI_MAX) {
+        _clock_sim_violation("MSI above 24 MHz in range 2");
+    }
+    if (clk.vos == SYSTEM_VOS2 && clk.pll.on && _clock_sim_pll_vco_hz() > CLOCK_SIM_VOS2_VCO_MAX) {
+        _clock_sim_violation("PLL VCO above 128 MHz in range 2");
+    }
+}
+
+static clock_sim_osc_t *_clock_sim_osc(sysclk_source_t src) {
+    switch (src) {
+        case SYSCLK_SRC_MSI:   return &clk.msi;
+        case SYSCLK_SRC_HSI16: return &clk.hsi;
+        case SYSCLK_SRC_PLL:   return &clk.pll;
+        default:               return NULL;     /* HSE is not fitted */
+    }
+}
+
+void clock_sim_reset(void) {
+    clk = clock_reset_regs;
+    clock_fault = CLOCK_SIM_FAULT_NONE;
+    utils_memset(&clock_stats, 0, sizeof(clock_stats));
+    clock_violation = "";
+}
+
+int clock_sim_set_vos(system_vos_t vos) {
+    if (vos != SYSTEM_VOS1 && vos != SYSTEM_VOS2) {
+        return SYSTEM_CLOCK_ERR_UNSUPPORTED;
+    }
+    if (clock_fault == CLOCK_SIM_FAULT_VOS_READY) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    if (vos != clk.vos) {
+        clk.vos = vos;
+        clock_stats.vos_changes++;
+        _clock_sim_check();
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+int clock_sim_set_flash_latency(uint32_t ws) {
+    if (ws > CLOCK_SIM_MAX_WS) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;    /* Reserved value, does not read back */
+    }
+    if (ws != clk.latency) {
+        clk.latency = ws;
+        clock_stats.latency_changes++;
+        _clock_sim_check();
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+int clock_sim_msi_enable(uint8_t range) {
+    if (range >= sizeof(msi_range_hz) / sizeof(msi_range_hz[0])) {
+        return SYSTEM_CLOCK_ERR_UNSUPPORTED;
+    }
+    if (clk.msi.on && !clk.msi.ready) {
+        _clock_sim_violation("MSI range changed while MSI not ready");
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    clk.msi_range = range;
+    clk.msi.on = 1;
+    clk.msi.ready = (clock_fault != CLOCK_SIM_FAULT_MSI_READY);
+    _clock_sim_check();
+    return clk.msi.ready ? SYSTEM_CLOCK_OK : SYSTEM_CLOCK_ERR_TIMEOUT;
+}
+
+int clock_sim_hsi16_enable(void) {
+    clk.hsi.on = 1;
+    clk.hsi.ready = (clock_fault != CLOCK_SIM_FAULT_HSI16_READY);
+    return clk.hsi.ready ? SYSTEM_CLOCK_OK : SYSTEM_CLOCK_ERR_TIMEOUT;
+}
+
+int clock_sim_pll_enable(const sysclock_opp_t *opp) {
+    if (opp == NULL || opp->pllm == 0U) {
+        return SYSTEM_CLOCK_ERR_UNSUPPORTED;
+    }
+    if (clk.source == SYSCLK_SRC_PLL) {
+        _clock_sim_violation("PLL reconfigured while it is SYSCLK");
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    clk.pll.on = 0;
+    clk.pll.ready = 0;
+    if (!clk.hsi.ready) {
+        _clock_sim_violation("PLL enabled without HSI16 ready");
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+
+    clk.pllm = opp->pllm;
+    clk.plln = opp->plln;
+    clk.pllr_bits = opp->pllr_bits;
+    clk.pll.on = 1;
+    clk.pll.ready = (clock_fault != CLOCK_SIM_FAULT_PLL_LOCK);
+    clock_stats.pll_locks++;
+    _clock_sim_check();
+    return clk.pll.ready ? SYSTEM_CLOCK_OK : SYSTEM_CLOCK_ERR_TIMEOUT;
+}
+
+int clock_sim_osc_disable(sysclk_source_t src) {
+    clock_sim_osc_t *osc = _clock_sim_osc(src);
+
+    if (osc == NULL) {
+        return SYSTEM_CLOCK_ERR_UNSUPPORTED;
+    }
+    if (src == clk.source) {
+        _clock_sim_violation("SYSCLK oscillator turned off");
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    if (src == SYSCLK_SRC_HSI16 && clk.pll.on) {
+        _clock_sim_violation("HSI16 turned off while it feeds the PLL");
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    osc->on = 0;
+    osc->ready = 0;
+    return SYSTEM_CLOCK_OK;
+}
+
+int clock_sim_select(sysclk_source_t src) {
+    clock_sim_osc_t *osc = _clock_sim_osc(src);
+
+    if (osc == NULL) {
+        return SYSTEM_CLOCK_ERR_UNSUPPORTED;
+    }
+    if (!osc->ready) {
+        _clock_sim_violation("SYSCLK source selected before it was ready");
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    if (src != clk.source) {
+        clk.source = src;
+        clock_stats.switches++;
+        _clock_sim_check();
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+uint32_t clock_sim_get_sysclk_hz(void) {
+    switch (clk.source) {
+        case SYSCLK_SRC_MSI:
+            return msi_range_hz[clk.msi_range];
+        case SYSCLK_SRC_HSI16:
+            return CLOCK_SIM_HSI16_HZ;
+        case SYSCLK_SRC_PLL:
+            return _clock_sim_pll_vco_hz() / (2U * (clk.pllr_bits + 1U));
+        default:
+            return 0;
+    }
+}
+
+sysclk_source_t clock_sim_get_source(void) {
+    return clk.source;
+}
+
+system_vos_t clock_sim_get_vos(void) {
+    return clk.vos;
+}
+
+uint32_t clock_sim_get_flash_latency(void) {
+    return clk.latency;
+}
+
+uint8_t clock_sim_osc_on(sysclk_source_t src) {
+    clock_sim_osc_t *osc = _clock_sim_osc(src);
+    return osc ? osc->on : 0;
+}
+
+void clock_sim_inject_fault(clock_sim_fault_t fault) {
+    clock_fault = fault;
+}
+
+void clock_sim_get_stats(clock_sim_stats_t *stats) {
+    if (stats) {
+        *stats = clock_stats;
+    }
+}
+
+const char *clock_sim_last_violation(void) {
+    return clock_violation;
+}
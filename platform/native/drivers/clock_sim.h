@@ -0,0 +1,101 @@
+#ifndef CLOCK_SIM_NATIVE_H
+#define CLOCK_SIM_NATIVE_H
+
+#include <stdint.h>
+#include "system_clock.h"
+
+/**
+ * @brief Host-side model of the STM32L476 clock tree, regulator and flash
+ * wait states.
+ *
+ * The model holds what RCC, PWR and FLASH_ACR would: which oscillators are
+ * on and ready, the MSI range, the PLL configuration, the SYSCLK source,
+ * the voltage range and the wait states. After every operation it checks
+ * the reference manual's rules and counts each one broken as a violation:
+ *   - SYSCLK above the range's limit (26 MHz in range 2)
+ *   - fewer wait states than SYSCLK needs in the current range
+ *   - MSI above 24 MHz, or a PLL VCO above 128 MHz, in range 2
+ *   - selecting a source that is not ready
+ *   - turning off SYSCLK, or HSI16 while it feeds the PLL
+ *   - reconfiguring the PLL while it is SYSCLK
+ * Operations the hardware would ignore (the last three) also fail with
+ * SYSTEM_CLOCK_ERR_TIMEOUT, like a ready/switch wait that never ends.
+ *
+ * A fault can be armed to make one oscillator or the regulator never
+ * become ready, for testing recovery from a timeout mid-sequence.
+ */
+
+typedef enum {
+    CLOCK_SIM_FAULT_NONE = 0,
+    CLOCK_SIM_FAULT_PLL_LOCK,       /* PLL never locks */
+    CLOCK_SIM_FAULT_HSI16_READY,    /* HSI16 never becomes ready */
+    CLOCK_SIM_FAULT_MSI_READY,      /* MSI never becomes ready */
+    CLOCK_SIM_FAULT_VOS_READY       /* Regulator never settles (VOSF stays set) */
+} clock_sim_fault_t;
+
+typedef struct clock_sim_stats {
+    uint32_t switches;          /* SYSCLK source changes */
+    uint32_t vos_changes;       /* Voltage range changes */
+    uint32_t latency_changes;   /* Wait state changes */
+    uint32_t pll_locks;         /* PLL lock attempts */
+    uint32_t violations;        /* Sequencing rules broken */
+} clock_sim_stats_t;
+
+/**
+ * @brief Return to the reset state: MSI 4 MHz selected, HSI16 and PLL off,
+ * range 1, 0 wait states. Clears statistics and faults.
+ */
+void clock_sim_reset(void);
+
+int clock_sim_set_vos(system_vos_t vos);
+int clock_sim_set_flash_latency(uint32_t ws);
+int clock_sim_msi_enable(uint8_t range);
+int clock_sim_hsi16_enable(void);
+int clock_sim_pll_enable(const sysclock_opp_t *opp);
+int clock_sim_osc_disable(sysclk_source_t src);
+int clock_sim_select(sysclk_source_t src);
+
+/**
+ * @brief Get the SYSCLK frequency the modelled registers produce.
+ */
+uint32_t clock_sim_get_sysclk_hz(void);
+
+/**
+ * @brief Get the selected SYSCLK source (RCC_CFGR SWS).
+ */
+sysclk_source_t clock_sim_get_source(void);
+
+/**
+ * @brief Get the voltage range.
+ */
+system_vos_t clock_sim_get_vos(void);
+
+/**
+ * @brief Get the flash wait states.
+ */
+uint32_t clock_sim_get_flash_latency(void);
+
+/**
+ * @brief Check whether an oscillator is on.
+ * @return 1 if on, 0 if off.
+ */
+uint8_t clock_sim_osc_on(sysclk_source_t src);
+
+/**
+ * @brief Arm a fault. It stays armed until replaced or the model is reset.
+ */
+void clock_sim_inject_fault(clock_sim_fault_t fault);
+
+/**
+ * @brief Get operation counters.
+ * @param stats Output structure.
+ */
+void clock_sim_get_stats(clock_sim_stats_t *stats);
+
+/**
+ * @brief Describe the last violation.
+ * @return Static string, or "" if there was none since the last reset.
+ */
+const char *clock_sim_last_violation(void);
+
+#endif /* CLOCK_SIM_NATIVE_H */
@@ -8,5 +8,6 @@ void flash_hal_unlock(void);
 void flash_hal_lock(void);
 int flash_hal_erase_page(uint32_t page_addr);
 int flash_hal_program(uint32_t addr, const void *data, size_t len);
+const void *flash_hal_map(uintptr_t addr);
 
 #endif /* FLASH_HAL_NATIVE_H */
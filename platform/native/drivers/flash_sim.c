@@ -0,0 +1,259 @@
+#include "flash_sim.h"
+#include "platform_config.h"
+#include "utils.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FLASH_SIM_PAGES         (FLASH_MEM_SIZE / FLASH_PAGE_SIZE)
+/* Image file: the array followed by one erase counter per page */
+#define FLASH_SIM_IMAGE_SIZE    (FLASH_MEM_SIZE + FLASH_SIM_PAGES * sizeof(uint32_t))
+/* Completion of an operation in 1/256 units; less than this means torn */
+#define FLASH_SIM_DONE          256U
+
+typedef enum {
+    FLASH_FAULT_NONE = 0,
+    FLASH_FAULT_OPS,        /* Cut after a number of operations */
+    FLASH_FAULT_TIME        /* Cut at a point on the busy clock */
+} flash_fault_mode_t;
+
+static uint8_t flash_ram[FLASH_MEM_SIZE];
+static uint32_t flash_ram_wear[FLASH_SIM_PAGES];
+static uint8_t *flash_mem = flash_ram;
+static uint32_t *flash_wear = flash_ram_wear;
+static void *flash_image = NULL;
+static int flash_image_fd = -1;
+
+static uint8_t flash_ready = 0;
+static uint8_t flash_locked = 1;
+static uint8_t flash_powered = 1;
+static uint8_t flash_realtime = 0;
+static flash_fault_mode_t flash_fault_mode = FLASH_FAULT_NONE;
+static uint32_t flash_fault_countdown = 0;
+static uint64_t flash_fault_at_us = 0;
+static flash_sim_stats_t flash_stats;
+
+/* Bring the RAM array up in the erased state on first use */
+static void _flash_sim_ensure_ready(void) {
+    if (!flash_ready) {
+        utils_memset(flash_ram, 0xFF, sizeof(flash_ram));
+        utils_memset(flash_ram_wear, 0, sizeof(flash_ram_wear));
+        flash_ready = 1;
+    }
+}
+
+/* Check that [addr, addr + len) lies inside the simulated array */
+static int _flash_sim_in_range(uintptr_t addr, size_t len) {
+    if (addr < FLASH_MEM_BASE) {
+        return 0;
+    }
+    uintptr_t off = addr - FLASH_MEM_BASE;
+    return (off < FLASH_MEM_SIZE) && (len <= FLASH_MEM_SIZE - off);
+}
+
+/*
+ * Charge one operation of op_us to the busy clock and check the armed fault.
+ * Returns how much of the operation completed, in 1/FLASH_SIM_DONE units.
+ */
+static uint32_t _flash_sim_run(uint32_t op_us) {
+    uint32_t done = FLASH_SIM_DONE;
+
+    if (flash_fault_mode == FLASH_FAULT_OPS) {
+        if (flash_fault_countdown > 0U) {
+            flash_fault_countdown--;
+        } else {
+            done = FLASH_SIM_DONE / 2U;
+        }
+    } else if (flash_fault_mode == FLASH_FAULT_TIME &&
+               flash_stats.busy_us + op_us > flash_fault_at_us) {
+        uint64_t elapsed = flash_fault_at_us - flash_stats.busy_us;
+        done = (uint32_t)((elapsed * FLASH_SIM_DONE) / op_us);
+        op_us = (uint32_t)elapsed;
+    }
+
+    if (done < FLASH_SIM_DONE) {
+        flash_fault_mode = FLASH_FAULT_NONE;
+        flash_powered = 0;
+    }
+
+    flash_stats.busy_us += op_us;
+    if (flash_realtime && op_us > 0U) {
+        struct timespec ts = { op_us / 1000000U, (long)(op_us % 1000000U) * 1000L };
+        nanosleep(&ts, NULL);
+    }
+    return done;
+}
+
+/* Map an image file as the array, creating it erased if needed */
+int flash_sim_open(const char *path) {
+    struct stat st;
+
+    if (!path) {
+        return -1;
+    }
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+
+    int fresh = (fstat(fd, &st) != 0 || st.st_size != (off_t)FLASH_SIM_IMAGE_SIZE);
+    if (fresh && ftruncate(fd, (off_t)FLASH_SIM_IMAGE_SIZE) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, FLASH_SIM_IMAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    flash_sim_close();
+    flash_image = map;
+    flash_image_fd = fd;
+    flash_mem = (uint8_t *)map;
+    flash_wear = (uint32_t *)(flash_mem + FLASH_MEM_SIZE);
+    if (fresh) {
+        utils_memset(flash_mem, 0xFF, FLASH_MEM_SIZE);
+        utils_memset(flash_wear, 0, FLASH_SIM_PAGES * sizeof(uint32_t));
+    }
+    return 0;
+}
+
+/* Flush and unmap the image file, fall back to an erased RAM array */
+void flash_sim_close(void) {
+    if (!flash_image) {
+        return;
+    }
+    msync(flash_image, FLASH_SIM_IMAGE_SIZE, MS_SYNC);
+    munmap(flash_image, FLASH_SIM_IMAGE_SIZE);
+    close(flash_image_fd);
+    flash_image = NULL;
+    flash_image_fd = -1;
+    flash_mem = flash_ram;
+    flash_wear = flash_ram_wear;
+    flash_ready = 0;
+}
+
+/* Erase all pages and restore default controller state */
+void flash_sim_reset(void) {
+    _flash_sim_ensure_ready();
+    utils_memset(flash_mem, 0xFF, FLASH_MEM_SIZE);
+    utils_memset(flash_wear, 0, FLASH_SIM_PAGES * sizeof(uint32_t));
+    utils_memset(&flash_stats, 0, sizeof(flash_stats));
+    flash_locked = 1;
+    flash_fault_mode = FLASH_FAULT_NONE;
+    flash_fault_countdown = 0;
+    flash_powered = 1;
+}
+
+void flash_sim_unlock(void) {
+    flash_locked = 0;
+}
+
+void flash_sim_lock(void) {
+    flash_locked = 1;
+}
+
+/* Erase a page. A torn erase only restores a prefix of the page. */
+int flash_sim_erase_page(uint32_t page_addr) {
+    _flash_sim_ensure_ready();
+    if (!flash_powered || flash_locked ||
+        !_flash_sim_in_range(page_addr, FLASH_PAGE_SIZE) ||
+        ((page_addr - FLASH_MEM_BASE) % FLASH_PAGE_SIZE) != 0U) {
+        flash_stats.rejected++;
+        return -1;
+    }
+
+    uint32_t page = (page_addr - FLASH_MEM_BASE) / FLASH_PAGE_SIZE;
+    uint32_t done = _flash_sim_run(FLASH_SIM_ERASE_US);
+
+    flash_stats.erases++;
+    if (done > 0U) {
+        flash_wear[page]++;
+    }
+    utils_memset(&flash_mem[page * FLASH_PAGE_SIZE], 0xFF,
+                 (FLASH_PAGE_SIZE * done) / FLASH_SIM_DONE);
+    return (done == FLASH_SIM_DONE) ? 0 : -1;
+}
+
+/* Program double-words. A torn unit only lands a prefix of its bytes. */
+int flash_sim_program(uint32_t addr, const void *data, size_t len) {
+    _flash_sim_ensure_ready();
+    if (!data || len == 0U || !flash_powered || flash_locked ||
+        (addr % FLASH_PROGRAM_UNIT) != 0U || (len % FLASH_PROGRAM_UNIT) != 0U ||
+        !_flash_sim_in_range(addr, len)) {
+        flash_stats.rejected++;
+        return -1;
+    }
+
+    const uint8_t *src = (const uint8_t *)data;
+    uint8_t *dst = &flash_mem[addr - FLASH_MEM_BASE];
+
+    for (size_t off = 0; off < len; off += FLASH_PROGRAM_UNIT) {
+        /* Like PROGERR on the real part: a double-word must be erased first */
+        for (size_t i = 0; i < FLASH_PROGRAM_UNIT; i++) {
+            if (dst[off + i] != 0xFFU) {
+                flash_stats.rejected++;
+                return -1;
+            }
+        }
+        uint32_t done = _flash_sim_run(FLASH_SIM_PROGRAM_US);
+        utils_memcpy(&dst[off], &src[off], (FLASH_PROGRAM_UNIT * done) / FLASH_SIM_DONE);
+        if (done < FLASH_SIM_DONE) {
+            return -1;
+        }
+        flash_stats.programs++;
+    }
+    return 0;
+}
+
+/* Resolve a flash address to its host backing storage */
+const void *flash_sim_map(uintptr_t addr) {
+    _flash_sim_ensure_ready();
+    if (!_flash_sim_in_range(addr, 1U)) {
+        return (const void *)addr;
+    }
+    return &flash_mem[addr - FLASH_MEM_BASE];
+}
+
+void flash_sim_inject_fault(uint32_t ops_before_fault) {
+    flash_fault_mode = FLASH_FAULT_OPS;
+    flash_fault_countdown = ops_before_fault;
+}
+
+void flash_sim_inject_fault_at(uint64_t busy_us) {
+    flash_fault_mode = FLASH_FAULT_TIME;
+    flash_fault_at_us = flash_stats.busy_us + busy_us;
+}
+
+int flash_sim_power_lost(void) {
+    return flash_powered ? 0 : 1;
+}
+
+void flash_sim_power_cycle(void) {
+    flash_fault_mode = FLASH_FAULT_NONE;
+    flash_fault_countdown = 0;
+    flash_powered = 1;
+    flash_locked = 1;
+}
+
+void flash_sim_set_realtime(uint8_t enable) {
+    flash_realtime = enable ? 1U : 0U;
+}
+
+uint32_t flash_sim_erase_count(uint32_t page_addr) {
+    _flash_sim_ensure_ready();
+    if (!_flash_sim_in_range(page_addr, 1U)) {
+        return 0;
+    }
+    return flash_wear[(page_addr - FLASH_MEM_BASE) / FLASH_PAGE_SIZE];
+}
+
+void flash_sim_get_stats(flash_sim_stats_t *stats) {
+    if (stats) {
+        *stats = flash_stats;
+    }
+}
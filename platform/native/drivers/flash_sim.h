@@ -0,0 +1,131 @@
+#ifndef FLASH_SIM_NATIVE_H
+#define FLASH_SIM_NATIVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Host-side model of the STM32L476 main flash array.
+ *
+ * The array spans FLASH_MEM_BASE .. FLASH_MEM_BASE + FLASH_MEM_SIZE and
+ * follows the same rules as the real part: page erase sets every byte to
+ * 0xFF, programming works on FLASH_PROGRAM_UNIT aligned double-words and
+ * a double-word may only be programmed once between erases.
+ *
+ * Power-loss testing is done by arming a fault: after a given number of
+ * program/erase units the next operation is torn (only partially applied)
+ * and the array stops accepting writes until flash_sim_power_cycle().
+ *
+ * By default the array lives in RAM. flash_sim_open() moves it into a
+ * memory-mapped image file so contents and erase counters persist across
+ * runs. Every operation is charged its STM32L4 latency on a simulated busy
+ * clock, optionally also sleeping for it in real time.
+ */
+
+typedef struct flash_sim_stats {
+    uint32_t erases;            /* Page erases started */
+    uint32_t programs;          /* Double-words programmed */
+    uint32_t rejected;          /* Program/erase requests refused */
+    uint64_t busy_us;           /* Simulated time spent busy */
+} flash_sim_stats_t;
+
+/**
+ * @brief Back the array with a memory-mapped image file.
+ * A missing or wrongly sized file is created in the erased state.
+ * @param path Image file path.
+ * @return 0 on success, -1 on error (the current backing is kept).
+ */
+int flash_sim_open(const char *path);
+
+/**
+ * @brief Sync and unmap the image file and return to an erased RAM array.
+ */
+void flash_sim_close(void);
+
+/**
+ * @brief Erase the whole array, zero erase counters and statistics, clear
+ * faults and lock the controller. Applies to the image file when open.
+ */
+void flash_sim_reset(void);
+
+/**
+ * @brief Unlock the simulated controller for program/erase.
+ */
+void flash_sim_unlock(void);
+
+/**
+ * @brief Lock the simulated controller.
+ */
+void flash_sim_lock(void);
+
+/**
+ * @brief Erase one page.
+ * @param page_addr Page-aligned address inside the simulated array.
+ * @return 0 on success, -1 on error (locked, misaligned, out of range or power lost).
+ */
+int flash_sim_erase_page(uint32_t page_addr);
+
+/**
+ * @brief Program whole double-words.
+ * @param addr FLASH_PROGRAM_UNIT aligned destination address.
+ * @param data Source buffer.
+ * @param len Length in bytes (multiple of FLASH_PROGRAM_UNIT).
+ * @return 0 on success, -1 on error (target not erased, misaligned, locked or power lost).
+ */
+int flash_sim_program(uint32_t addr, const void *data, size_t len);
+
+/**
+ * @brief Translate a flash address into a readable host pointer.
+ * Addresses outside the simulated array are returned unchanged.
+ * @param addr Flash address.
+ * @return Host pointer to the backing storage.
+ */
+const void *flash_sim_map(uintptr_t addr);
+
+/**
+ * @brief Arm a torn-write fault.
+ * @param ops_before_fault Number of program units (double-words) or page
+ *        erases that complete normally before the torn operation.
+ */
+void flash_sim_inject_fault(uint32_t ops_before_fault);
+
+/**
+ * @brief Arm a power cut at a point on the simulated busy clock.
+ * The operation in progress at that moment is applied in proportion to
+ * its elapsed time: a torn erase restores only a prefix of the page to
+ * 0xFF, a torn program lands only a prefix of the double-word.
+ * @param busy_us Busy time from now until the cut.
+ */
+void flash_sim_inject_fault_at(uint64_t busy_us);
+
+/**
+ * @brief Check whether an armed fault has fired.
+ * @return 1 if power was lost, 0 otherwise.
+ */
+int flash_sim_power_lost(void);
+
+/**
+ * @brief Restore power after a fault. Array contents are preserved.
+ */
+void flash_sim_power_cycle(void);
+
+/**
+ * @brief Sleep for the modelled latency of each operation.
+ * @param enable 1 to block like the hardware, 0 to only account busy time.
+ */
+void flash_sim_set_realtime(uint8_t enable);
+
+/**
+ * @brief Get the number of times a page has been erased.
+ * @param page_addr Any address inside the page.
+ * @return Erase count, 0 for addresses outside the array.
+ */
+uint32_t flash_sim_erase_count(uint32_t page_addr);
+
+/**
+ * @brief Get operation counters and accumulated busy time.
+ * @param stats Output structure.
+ */
+void flash_sim_get_stats(flash_sim_stats_t *stats);
+
+#endif /* FLASH_SIM_NATIVE_H */
@@ -65,4 +65,6 @@ void i2c_hal_clear_stop(void *hal_handle);
 uint8_t i2c_hal_nack_detected(void *hal_handle);
 void i2c_hal_clear_nack(void *hal_handle);
 void i2c_hal_clear_config(void *hal_handle);
+uint32_t i2c_hal_config_speed(const void *config_ptr);
+void i2c_hal_set_clock(void *hal_handle, uint32_t pclk_hz, uint32_t speed);
 #endif /* I2C_HAL_NATIVE_H */
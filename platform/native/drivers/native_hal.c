@@ -1,9 +1,12 @@
 #include "adc_hal.h"
 #include "button_hal.h"
+#include "clock_hal.h"
+#include "clock_sim.h"
 #include "dac_hal.h"
 #include "dma_hal.h"
 #include "exti_hal.h"
 #include "flash_hal.h"
+#include "flash_sim.h"
 #include "gpio_hal.h"
 #include "i2c_hal.h"
 #include "led_hal.h"
@@ -13,6 +16,7 @@
 #include "systick_hal.h"
 #include "uart_hal.h"
 #include "watchdog_hal.h"
+#include "platform.h"
 
 #include "systick.h"
 
@@ -113,6 +117,21 @@ void uart_hal_write_byte(void *hal_handle, uint8_t byte) {
     fflush(stdout);
 }
 
+uint32_t uart_hal_config_baud(const void *config_ptr) {
+    return config_ptr ? ((const UART_Config_t *)config_ptr)->BaudRate : 0U;
+}
+
+uint8_t uart_hal_tx_busy(void *hal_handle) {
+    (void)hal_handle;
+    return 0; /* Bytes reach stdout synchronously */
+}
+
+void uart_hal_set_baud(void *hal_handle, uint32_t baud, uint32_t clock_freq) {
+    (void)hal_handle;
+    (void)baud;
+    (void)clock_freq;
+}
+
 /* --- Systick --- */
 static uint32_t systick_reload;
 
@@ -237,6 +256,17 @@ void i2c_hal_clear_config(void *hal_handle) {
     }
 }
 
+uint32_t i2c_hal_config_speed(const void *config_ptr) {
+    (void)config_ptr;
+    return 0; /* No bus timing to keep */
+}
+
+void i2c_hal_set_clock(void *hal_handle, uint32_t pclk_hz, uint32_t speed) {
+    (void)hal_handle;
+    (void)pclk_hz;
+    (void)speed;
+}
+
 /* --- SPI --- */
 void spi_hal_init(void *hal_handle, void *config_ptr) {
     SPI_Handle_t *SPIx = (SPI_Handle_t *)hal_handle;
@@ -267,6 +297,23 @@ void spi_hal_enable_tx_irq(void *hal_handle, uint8_t enable) {
     (void)enable;
 }
 
+uint8_t spi_hal_busy(void *hal_handle) {
+    (void)hal_handle;
+    return 0;
+}
+
+uint32_t spi_hal_get_sck_hz(void *hal_handle, uint32_t pclk) {
+    (void)hal_handle;
+    (void)pclk;
+    return 0; /* No bus clock to keep */
+}
+
+void spi_hal_set_sck_hz(void *hal_handle, uint32_t pclk, uint32_t sck_hz) {
+    (void)hal_handle;
+    (void)pclk;
+    (void)sck_hz;
+}
+
 /* --- ADC --- */
 static uint16_t adc_last_value;
 
@@ -336,6 +383,17 @@ void pwm_hal_stop(void *hal_handle, uint8_t channel) {
     (void)channel;
 }
 
+int32_t pwm_hal_calc_prescaler(uint32_t pclk, uint32_t freq_hz) {
+    (void)pclk;
+    (void)freq_hz;
+    return 0; /* Any frequency is reachable */
+}
+
+void pwm_hal_set_prescaler(void *hal_handle, uint32_t psc) {
+    (void)hal_handle;
+    (void)psc;
+}
+
 /* --- RTC --- */
 static rtc_time_t rtc_time_state;
 static rtc_date_t rtc_date_state;
@@ -372,35 +430,75 @@ void rtc_hal_set_date(const rtc_date_t *date) {
 
 /* --- Flash --- */
 void flash_hal_unlock(void) {
+    flash_sim_unlock();
 }
 
 void flash_hal_lock(void) {
+    flash_sim_lock();
 }
 
 int flash_hal_erase_page(uint32_t page_addr) {
-    (void)page_addr;
-    return 0;
+    return flash_sim_erase_page(page_addr);
 }
 
 int flash_hal_program(uint32_t addr, const void *data, size_t len) {
-    (void)addr;
-    (void)data;
-    (void)len;
-    return 0;
+    return flash_sim_program(addr, data, len);
+}
+
+const void *flash_hal_map(uintptr_t addr) {
+    return flash_sim_map(addr);
+}
+
+/* --- Clock --- */
+int clock_hal_set_vos(system_vos_t vos) {
+    return clock_sim_set_vos(vos);
+}
+
+int clock_hal_set_flash_latency(uint32_t ws) {
+    return clock_sim_set_flash_latency(ws);
+}
+
+int clock_hal_msi_enable(uint8_t range) {
+    return clock_sim_msi_enable(range);
+}
+
+int clock_hal_hsi16_enable(void) {
+    return clock_sim_hsi16_enable();
+}
+
+int clock_hal_pll_enable(const sysclock_opp_t *opp) {
+    return clock_sim_pll_enable(opp);
+}
+
+int clock_hal_osc_disable(sysclk_source_t src) {
+    return clock_sim_osc_disable(src);
+}
+
+int clock_hal_select(sysclk_source_t src) {
+    return clock_sim_select(src);
 }
 
 /* --- Watchdog --- */
 static uint32_t watchdog_timeout_ms;
 static uint32_t watchdog_kicks;
+static uint32_t watchdog_last_kick;
 
 int watchdog_hal_init(uint32_t timeout_ms) {
     watchdog_timeout_ms = timeout_ms;
     watchdog_kicks = 0;
+    watchdog_last_kick = (uint32_t)platform_get_ticks();
     return (timeout_ms == 0U) ? -1 : 0;
 }
 
 void watchdog_hal_kick(void) {
     watchdog_kicks++;
+    watchdog_last_kick = (uint32_t)platform_get_ticks();
+}
+
+/* Ticks are milliseconds on the host */
+int watchdog_hal_expired(void) {
+    return watchdog_timeout_ms != 0U &&
+           (uint32_t)platform_get_ticks() - watchdog_last_kick >= watchdog_timeout_ms;
 }
 
 /* --- DMA --- */
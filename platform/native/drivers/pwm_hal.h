@@ -7,5 +7,7 @@ int pwm_hal_init(void *hal_handle, uint8_t channel, uint32_t freq_hz);
 void pwm_hal_set_duty(void *hal_handle, uint8_t channel, uint8_t duty);
 void pwm_hal_start(void *hal_handle, uint8_t channel);
 void pwm_hal_stop(void *hal_handle, uint8_t channel);
+int32_t pwm_hal_calc_prescaler(uint32_t pclk, uint32_t freq_hz);
+void pwm_hal_set_prescaler(void *hal_handle, uint32_t psc);
 
 #endif /* PWM_HAL_NATIVE_H */
@@ -20,6 +20,9 @@ void spi_hal_init(void *hal_handle, void *config_ptr);
 uint8_t spi_hal_transfer_byte(void *hal_handle, uint8_t byte);
 void spi_hal_enable_rx_irq(void *hal_handle, uint8_t enable);
 void spi_hal_enable_tx_irq(void *hal_handle, uint8_t enable);
+uint8_t spi_hal_busy(void *hal_handle);
+uint32_t spi_hal_get_sck_hz(void *hal_handle, uint32_t pclk);
+void spi_hal_set_sck_hz(void *hal_handle, uint32_t pclk, uint32_t sck_hz);
 
 /* Status helpers for ISR-driven transfers (native stubs) */
 static inline uint8_t spi_hal_rx_ready(void *hal_handle) {
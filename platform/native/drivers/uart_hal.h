@@ -32,4 +32,7 @@ void uart_hal_init(void *hal_handle, void *config_ptr, uint32_t clock_freq);
 void uart_hal_enable_rx_interrupt(void *hal_handle, uint8_t enable);
 void uart_hal_enable_tx_interrupt(void *hal_handle, uint8_t enable);
 void uart_hal_write_byte(void *hal_handle, uint8_t byte);
+uint32_t uart_hal_config_baud(const void *config_ptr);
+uint8_t uart_hal_tx_busy(void *hal_handle);
+void uart_hal_set_baud(void *hal_handle, uint32_t baud, uint32_t clock_freq);
 #endif /* UART_HAL_NATIVE_H */
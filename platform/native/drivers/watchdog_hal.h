@@ -6,4 +6,10 @@
 int watchdog_hal_init(uint32_t timeout_ms);
 void watchdog_hal_kick(void);
 
+/**
+ * @brief Simulated expiry (native only).
+ * @return 1 once timeout_ms ticks have passed since the last kick, else 0.
+ */
+int watchdog_hal_expired(void);
+
 #endif /* WATCHDOG_HAL_NATIVE_H */
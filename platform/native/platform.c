@@ -1,5 +1,10 @@
 #include "platform.h"
 #include "memory_map.h"
+#include "flash_sim.h"
+#include "system_clock.h"
+#include "arch_ops.h"
+#include "project_config.h"
+#include "boot.h"
 #include <stdio.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -28,8 +33,32 @@ void platform_init(void) {
     /* Initialize the monotonic clock reference */
     clock_gettime(CLOCK_MONOTONIC, &start_time);
 
+    /* Drive the modelled clock tree like the target does */
+    if (system_clock_config_hz(SYSCLOCK_HZ_80MHZ) != SYSTEM_CLOCK_OK) {
+        platform_panic();
+    }
+
+    /* No reset vector on host: the boot timeline starts here */
+    boot_reset();
+
     /* Initialize memory map (Heap) */
     memory_map_init();
+
+#if STACK_GUARD_ENABLE
+    /* Guard page at the bottom of the running task's stack */
+    arch_stack_guard_init();
+#endif
+
+    /* Back simulated flash with an image file so stored data survives restarts */
+    const char *image = getenv(FLASH_SIM_IMAGE_ENV);
+    if (!image) {
+        image = FLASH_SIM_IMAGE_PATH;
+    }
+    if (flash_sim_open(image) == 0) {
+        flash_sim_set_realtime(1);
+    } else {
+        printf("[WARN] Cannot map flash image %s, flash contents will not persist.\n", image);
+    }
 }
 
 uart_port_t platform_uart_init(void) {
@@ -74,6 +103,11 @@ int platform_uart_puts(const char *s) {
     return printf("%s", s);
 }
 
+int platform_uart_write(const char *data, size_t len) {
+    /* Binary safe: printf would stop at the first zero byte */
+    return (int)fwrite(data, 1, len, stdout);
+}
+
 void platform_panic(void) {
     printf("[PANIC] System halted.\n");
     exit(1);
@@ -83,6 +117,23 @@ size_t platform_get_cpu_freq(void) {
     return 0; /* Not relevant on host */
 }
 
+/* Switches the modelled clock tree; the host itself keeps its speed */
+int platform_set_cpu_freq(size_t hz) {
+    return system_clock_switch((uint32_t)hz);
+}
+
+/* No cycle counter on host: count nanoseconds of the monotonic clock */
+uint32_t platform_get_cycles(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+
+/* No interrupts to pend on host */
+uint32_t platform_irq_entry_cycles(void) {
+    return 0;
+}
+
 void platform_systick_init(size_t tick_hz) { (void)tick_hz; }
 
 size_t platform_get_ticks(void) { 
@@ -6,9 +6,40 @@
 /* Simulated Clock Speed */
 #define SYSCLK_HZ          1000000UL
 
-/* Interrupt Priorities (Not applicable on Host, defined for compatibility) */
-#define MAX_SYSCALL_PRIORITY   0
-#define SYSTICK_PRIORITY       0
-#define PENDSV_PRIORITY        0
+/* Interrupt Priorities (same levels as STM32L476, modelled by arch_ops.h) */
+#define NVIC_PRIO_BITS         4
+#ifndef MAX_SYSCALL_PRIORITY
+#define MAX_SYSCALL_PRIORITY   5
+#endif
+#define SYSTICK_PRIORITY       14
+#define PENDSV_PRIORITY        15
+#define USART2_IRQ_PRIORITY    10
+
+#if (MAX_SYSCALL_PRIORITY < 1) || (MAX_SYSCALL_PRIORITY >= (1 << NVIC_PRIO_BITS))
+#error "MAX_SYSCALL_PRIORITY must be 1..15 (BASEPRI 0 would mask nothing)"
+#endif
+
+#define IRQ_PRIORITY_KERNEL(p) __extension__ ({                                \
+    _Static_assert((p) >= MAX_SYSCALL_PRIORITY && (p) < (1 << NVIC_PRIO_BITS), \
+                   "Kernel-aware ISR priority above MAX_SYSCALL_PRIORITY");    \
+    (uint32_t)(p);                                                             \
+})
+#define IRQ_PRIORITY_ZERO_LATENCY(p) __extension__ ({                          \
+    _Static_assert((p) >= 0 && (p) < MAX_SYSCALL_PRIORITY,                     \
+                   "Zero-latency ISR priority must be above MAX_SYSCALL_PRIORITY"); \
+    (uint32_t)(p);                                                             \
+})
+
+/* Simulated Flash (mirrors the STM32L476 main flash layout) */
+#define FLASH_MEM_BASE         0x08000000UL
+#define FLASH_MEM_SIZE         (1024UL * 1024UL)
+#define FLASH_PAGE_SIZE        2048U    /* Erase granularity in bytes */
+#define FLASH_PROGRAM_UNIT     8U       /* Program granularity (double word) */
+#define FLASH_STORAGE_SIZE     (64UL * 1024UL)  /* Reserved for persistent data */
+#define FLASH_STORAGE_BASE     (FLASH_MEM_BASE + FLASH_MEM_SIZE - FLASH_STORAGE_SIZE)
+#define FLASH_SIM_ERASE_US     22000U   /* Page erase latency (STM32L4 typ 22 ms) */
+#define FLASH_SIM_PROGRAM_US   82U      /* Double-word program latency (typ 81.7 us) */
+#define FLASH_SIM_IMAGE_PATH   "build/native/flash.img"  /* Default backing file */
+#define FLASH_SIM_IMAGE_ENV    "SORTOS_FLASH_IMAGE"      /* Overrides the path */
 
 #endif /* PLATFORM_CONFIG_H */
\ No newline at end of file
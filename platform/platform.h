@@ -7,6 +7,10 @@
 #include "uart.h"
 #include "platform_config.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @brief Stack alignment requirement in bytes.
  * * Defines the byte alignment for task stacks.
@@ -35,6 +39,16 @@ void platform_panic(void);
  */
 size_t platform_get_cpu_freq(void);
 
+/**
+ * @brief Switch the CPU Core to another operating point at run time.
+ * * The SysTick reload is recomputed so the tick rate is unchanged.
+ * * Call with interrupts masked; drivers are not told (see dvfs_set_hz()).
+ * @param hz Frequency of a supported operating point.
+ * @return 0 on success, negative on error (the core may then run at
+ *         another valid frequency; platform_get_cpu_freq() tells which).
+ */
+int platform_set_cpu_freq(size_t hz);
+
 /**
  * @brief Initializes the system tick timer.
  * * This is called by the scheduler before starting.
@@ -48,6 +62,22 @@ void platform_systick_init(size_t tick_hz);
  */
 size_t platform_get_ticks(void);
 
+/**
+ * @brief Read a free-running cycle counter for short measurements.
+ * * Wraps at 32 bits; compare readings by unsigned subtraction.
+ * * STM32 uses the DWT cycle counter; native counts nanoseconds.
+ * @return Current counter value.
+ */
+uint32_t platform_get_cycles(void);
+
+/**
+ * @brief Measure one interrupt entry.
+ * * Pends a spare interrupt and counts cycles until its handler runs,
+ * * including exception stacking and the vector fetch.
+ * @return Cycles from pend to handler entry, or 0 if not supported.
+ */
+uint32_t platform_irq_entry_cycles(void);
+
 /**
  * @brief Put the CPU into a low-power idle state.
  * * This function is called by the idle task to save power.
@@ -84,6 +114,13 @@ int platform_uart_getc(char *out_ch);
  */
 int platform_uart_puts(const char *s);
 
+/**
+ * @brief Platform-specific UART write of raw bytes (non-blocking).
+ * * Unlike platform_uart_puts(), the data may contain zero bytes.
+ * @return Number of bytes written.
+ */
+int platform_uart_write(const char *data, size_t len);
+
 /**
  * @brief Resets the system.
  * * This function triggers a software reset of the microcontroller.
@@ -108,4 +145,8 @@ void platform_uart_set_rx_queue(queue_t *q);
  */
 void platform_uart_set_tx_queue(queue_t *q);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* PLATFORM_H */
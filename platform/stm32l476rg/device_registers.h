@@ -64,9 +64,20 @@ extern "C" {
 #define SCB_CPACR               (SCS_BASE + 0x0D88UL) /* 0xE000ED88 */
 #define SCB_CPACR_REG           (*(volatile uint32_t *)SCB_CPACR)
 
+/************* MPU base *****************/
+#define MPU_BASE                (SCS_BASE + 0x0D90UL) /* 0xE000ED90 */
+
 /************* NVIC base *****************/
 #define NVIC_BASE               (SCS_BASE + 0x0100UL) /* 0xE000E100UL */
 
+/************* DWT / Debug registers *****************/
+#define DEM_CR                  (SCS_BASE + 0x0DFCUL) /* 0xE000EDFC */
+#define DEM_CR_REG              (*(volatile uint32_t *)DEM_CR)
+#define DWT_CTRL                (0xE0001000UL)
+#define DWT_CTRL_REG            (*(volatile uint32_t *)DWT_CTRL)
+#define DWT_CYCCNT              (0xE0001004UL)
+#define DWT_CYCCNT_REG          (*(volatile uint32_t *)DWT_CYCCNT)
+
 /************* FPU base *****************/
 #define FPU_FPCCR               (SCS_BASE + 0x0F34UL) /* 0xE000EF34 */
 #define FPU_FPCCR_REG           (*(volatile uint32_t *)FPU_FPCCR)
@@ -369,8 +380,22 @@ typedef struct {
     volatile uint32_t CCR;     /* 0x14 */
     volatile uint8_t  SHPR[12];/* 0x18–0x23: SHPR1–3 (4 bytes each) */
     volatile uint32_t SHCSR;   /* 0x24 */
+    volatile uint32_t CFSR;    /* 0x28: MMFSR[7:0], BFSR[15:8], UFSR[31:16] */
+    volatile uint32_t HFSR;    /* 0x2C */
+    volatile uint32_t DFSR;    /* 0x30 */
+    volatile uint32_t MMFAR;   /* 0x34 */
+    volatile uint32_t BFAR;    /* 0x38 */
 } SCB_t;
 
+/************* MPU Registers *****************/
+typedef struct {
+    volatile uint32_t TYPE;    /* 0x00 */
+    volatile uint32_t CTRL;    /* 0x04 */
+    volatile uint32_t RNR;     /* 0x08 */
+    volatile uint32_t RBAR;    /* 0x0C */
+    volatile uint32_t RASR;    /* 0x10 */
+} MPU_t;
+
 /************* POINTERS TO INSTANCES *****************/
 #define RCC       ((RCC_t   *) RCC_BASE)
 #define FLASH     ((FLASH_t *) FLASH_BASE)
@@ -419,12 +444,16 @@ typedef struct {
 #define SYSTICK   ((SysTick_t *) SYSTICK_BASE)
 
 #define SCB       ((SCB_t *)SCB_BASE)
+#define MPU       ((MPU_t *)MPU_BASE)
 
 /************* NVIC definitions *****************/
 #define NVIC_ISER0              (*((volatile uint32_t *)(NVIC_BASE + 0x000)))
 #define NVIC_ISER1              (*((volatile uint32_t *)(NVIC_BASE + 0x004)))
+#define NVIC_ISPR1              (*((volatile uint32_t *)(NVIC_BASE + 0x104)))
+#define NVIC_ICPR1              (*((volatile uint32_t *)(NVIC_BASE + 0x184)))
 #define NVIC_IPR(irq)           (*((volatile uint8_t *)(NVIC_BASE + 0x300UL + (irq))))
 #define USART2_IRQn             38
+#define TIM7_IRQn               55
 
 
 #ifdef __cplusplus
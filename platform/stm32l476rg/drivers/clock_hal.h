@@ -0,0 +1,320 @@
+#ifndef CLOCK_HAL_STM32_H
+#define CLOCK_HAL_STM32_H
+
+#include "device_registers.h"
+#include "system_clock.h"
+#include "utils.h"
+
+/*********** FLASH_ACR ***********/
+/*
+ * FLASH_ACR — Flash Access Control Register
+ * FLASH_ACR[2:0] - WS selection
+ * VOS1 (High Performance Mode)
+ * 0–16 MHz   -> 0 WS
+ * 16–32 MHz  -> 1 WS
+ * 32–48 MHz  -> 2 WS
+ * 48–64 MHz  -> 3 WS
+ * 64–80 MHz  -> 4 WS
+ *
+ * VOS2 (Low Power Mode)
+ * 0–6 MHz    -> 0 WS
+ * 6–12 MHz   -> 1 WS
+ * 12–18 MHz  -> 2 WS
+ * 18–26 MHz  -> 3 WS   (max SYSCLK in VOS2)
+ *
+ *  MUST be raised before the clock gets faster and
+ *  lowered only after it got slower.
+ */
+#define FLASH_ACR_LATENCY_POS   0U
+#define FLASH_ACR_LATENCY_MASK   (0x7U << FLASH_ACR_LATENCY_POS)
+#define FLASH_ACR_PRFTEN        (1U << 8)   /* Prefetch enable */
+#define FLASH_ACR_ICEN          (1U << 9)   /* Instruction cache enable */
+#define FLASH_ACR_DCEN          (1U << 10)  /* Data cache enable */
+
+/*********** PWR_CR1 ***********/
+/*
+ * PWR_CR1 — Power control register 1
+ * VOS[10:9] Voltage scaling selection:
+ * 01: Range 1 (up to 80 MHz)
+ * 10: Range 2 (up to 26 MHz)
+ */
+#define PWR_CR1_VOS_POS         9U
+#define PWR_CR1_VOS_MASK         (0x3U << PWR_CR1_VOS_POS)
+
+/* PWR_SR2 — VOSF is set while the regulator settles on a new range */
+#define PWR_SR2_VOSF            (1U << 10)
+
+/*********** RCC_CR — Clock control register ***********/
+/* MSI (Multi-Speed Internal Oscillator) */
+#define RCC_CR_MSION        (1U << 0)   /* MSI clock enable */
+#define RCC_CR_MSIRDY       (1U << 1)   /* MSI clock ready flag */
+#define RCC_CR_MSIPLLEN     (1U << 2)   /* MSI PLL mode enable */
+#define RCC_CR_MSIRGSEL     (1U << 3)   /* MSI range selection source */
+/*
+ * MSIRANGE[7:4] — MSI frequency range:
+ * 0000: 100 kHz
+ * 0001: 200 kHz
+ * 0010: 400 kHz
+ * 0011: 800 kHz
+ * 0100:   1 MHz
+ * 0101:   2 MHz
+ * 0110:   4 MHz   (reset)
+ * 0111:   8 MHz
+ * 1000:  16 MHz
+ * 1001:  24 MHz   (max in VOS2)
+ * 1010:  32 MHz
+ * 1011:  48 MHz
+ *
+ * Only takes effect with MSIRGSEL set. May be written while MSI is
+ * off or ready, never while it is on and not ready.
+ */
+#define RCC_CR_MSIRANGE_POS  4U
+#define RCC_CR_MSIRANGE_MASK  (0xFU << RCC_CR_MSIRANGE_POS)
+
+/* HSI16 (High-Speed Internal 16 MHz Oscillator) */
+#define RCC_CR_HSION        (1U << 8)   /* HSI16 enable */
+#define RCC_CR_HSIKERON     (1U << 9)   /* HSI16 for peripherals */
+#define RCC_CR_HSIRDY       (1U << 10)  /* HSI16 ready flag */
+#define RCC_CR_HSIASFS      (1U << 12)  /* Auto-start HSI on clock failure */
+
+/* HSE (High-Speed External Oscillator) */
+#define RCC_CR_HSEON        (1U << 16) /* Trun on HSE */
+#define RCC_CR_HSERDY       (1U << 17) /* Poll to check if HSE ready */
+#define RCC_CR_HSEBYP       (1U << 18) /* use external clock */
+#define RCC_CR_CSSON        (1U << 19) /* clock security */
+
+/* PLL */
+#define RCC_CR_PLLON        (1U << 24) /* Enable PLL */
+#define RCC_CR_PLLRDY       (1U << 25) /* Check if PLL ready*/
+#define RCC_CR_PLLSAI1ON    (1U << 26) /* Turn on peripherals PLL */
+#define RCC_CR_PLLSAI1RDY   (1U << 27) /* Check if peripherals PLL ready */
+#define RCC_CR_PLLSAI2ON    (1U << 28) /* Turn on peripherals PLL */
+#define RCC_CR_PLLSAI2RDY   (1U << 29) /* Check if peripherals PLL ready */
+
+/*********** RCC_CFGR — Clock configuration register ***********/
+/*
+ * SW selects the **requested** SYSCLK source.
+ * SWS shows the **current** SYSCLK source.
+ * You MUST poll SWS before assuming the clock has switched.
+ */
+/*
+ * SW[1:0] — System Clock Switch
+ * 00: MSI selected as system clock
+ * 01: HSI16 selected as system clock
+ * 10: HSE selected as system clock
+ * 11: PLL selected as system clock
+ */
+#define RCC_CFGR_SW_POS     0U
+#define RCC_CFGR_SW_MASK     (0x3U << RCC_CFGR_SW_POS)
+
+/* SWS[3:2] — System clock switch status */
+#define RCC_CFGR_SWS_POS    2U
+#define RCC_CFGR_SWS_MASK    (0x3U << RCC_CFGR_SWS_POS)
+
+/* HPRE[7:4] — AHB prescaler
+ * Divides SYSCLK to create HCLK (core, bus, memory clock).
+ *
+ * 0xxx: SYSCLK not divided
+ * 1000: SYSCLK / 2
+ * 1001: SYSCLK / 4
+ * 1010: SYSCLK / 8
+ * up to SYSCLK / 512
+ */
+#define RCC_CFGR_HPRE_POS   4U
+#define RCC_CFGR_HPRE_MASK   (0xFU << RCC_CFGR_HPRE_POS)
+
+/* PPRE1[12:8] — APB1 prescaler */
+#define RCC_CFGR_PPRE1_POS   8U
+#define RCC_CFGR_PPRE1_MASK   (0x7U << RCC_CFGR_PPRE1_POS)
+/* 0xx: HCLK not divided -> PCLK1 = HCLK */
+#define RCC_CFGR_PPRE1_DIV1  (0x0U << RCC_CFGR_PPRE1_POS)
+
+/* PPRE2[15:11] — APB2 prescaler */
+#define RCC_CFGR_PPRE2_POS   11U
+#define RCC_CFGR_PPRE2_MASK   (0x7U << RCC_CFGR_PPRE2_POS)
+/* 0xx: HCLK not divided -> PCLK2 = HCLK */
+#define RCC_CFGR_PPRE2_DIV1  (0x0U << RCC_CFGR_PPRE2_POS)
+
+/*********** RCC_PLLCFGR — PLL configuration register ***********/
+/* PLLSRC[1:0] — PLL input source
+ * 00: None
+ * 01: MSI
+ * 10: HSI16
+ * 11: HSE
+ */
+#define RCC_PLLCFGR_PLLSRC_POS   0U
+#define RCC_PLLCFGR_PLLSRC_MASK   (0x3U << RCC_PLLCFGR_PLLSRC_POS)
+#define RCC_PLLCFGR_PLLSRC_MSI    (0x1U << RCC_PLLCFGR_PLLSRC_POS)
+#define RCC_PLLCFGR_PLLSRC_HSI16  (0x2U << RCC_PLLCFGR_PLLSRC_POS)
+#define RCC_PLLCFGR_PLLSRC_HSE    (0x3U << RCC_PLLCFGR_PLLSRC_POS)
+
+/* PLLM[7:4] — Division factor M
+ * Encoded as (M - 1)
+ */
+#define RCC_PLLCFGR_PLLM_POS     4U
+#define RCC_PLLCFGR_PLLM_MASK     (0xFU << RCC_PLLCFGR_PLLM_POS)
+
+/* PLLN[14:8] — Multiplication factor N */
+#define RCC_PLLCFGR_PLLN_POS     8U
+#define RCC_PLLCFGR_PLLN_MASK     (0x7FU << RCC_PLLCFGR_PLLN_POS)
+
+/* PLLR[26:25] — Division factor R for SYSCLK
+ * 00: /2
+ * 01: /4
+ * 10: /6
+ * 11: /8
+ */
+#define RCC_PLLCFGR_PLLR_POS     25U
+#define RCC_PLLCFGR_PLLR_MASK     (0x3U << RCC_PLLCFGR_PLLR_POS)
+
+/* PLLREN[24] — enable PLLR output */
+#define RCC_PLLCFGR_PLLREN       (1U << 24)
+
+
+/*********** RCC_APB1ENR1 ***********/
+#define RCC_APB1ENR1_PWREN (1U << 28) /* power enable */
+
+/**
+ * @brief Set the voltage range and wait for the regulator to settle.
+ */
+static inline int clock_hal_set_vos(system_vos_t vos) {
+    /* Enable PWR clock */
+    RCC->APB1ENR1 |= RCC_APB1ENR1_PWREN;
+
+    uint32_t tmp = PWR->CR1;
+    tmp &= ~PWR_CR1_VOS_MASK; /* clear VOS bits */
+    tmp |= ((uint32_t)vos << PWR_CR1_VOS_POS) & PWR_CR1_VOS_MASK;
+    PWR->CR1 = tmp;
+
+    /* VOSF stays set until the new range is reached */
+    if (wait_for_flag_clear(&PWR->SR2, PWR_SR2_VOSF, SYSTEM_CLOCK_WAIT_MAX_ITER) != 0) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+/**
+ * @brief Set the flash wait states and enable prefetch and caches.
+ * The new latency is read back before the clock may change.
+ */
+static inline int clock_hal_set_flash_latency(uint32_t ws) {
+    uint32_t tmp = FLASH->ACR;       /* save the current register state */
+    tmp &= ~FLASH_ACR_LATENCY_MASK;  /* zero the latency section */
+    /* set the new latency */
+    tmp |= ((ws << FLASH_ACR_LATENCY_POS) & FLASH_ACR_LATENCY_MASK);
+    tmp |= FLASH_ACR_PRFTEN;        /* enable prefetch */
+    tmp |= FLASH_ACR_ICEN;          /* enable instruction cache */
+    tmp |= FLASH_ACR_DCEN;          /* enable data cache */
+    FLASH->ACR = tmp;                /* update the register */
+
+    if (wait_for_reg_mask_eq(&FLASH->ACR, FLASH_ACR_LATENCY_MASK,
+                            tmp & FLASH_ACR_LATENCY_MASK,
+                            SYSTEM_CLOCK_WAIT_MAX_ITER) != 0) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+/**
+ * @brief Turn MSI on at a range, or change its range while it runs.
+ */
+static inline int clock_hal_msi_enable(uint8_t range) {
+    /* The range must not change while MSI is on but not yet ready */
+    if ((RCC->CR & RCC_CR_MSION) &&
+        wait_for_flag_set(&RCC->CR, RCC_CR_MSIRDY, SYSTEM_CLOCK_WAIT_MAX_ITER) != 0) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+
+    uint32_t tmp = RCC->CR;
+    tmp &= ~RCC_CR_MSIRANGE_MASK;
+    tmp |= ((uint32_t)range << RCC_CR_MSIRANGE_POS) & RCC_CR_MSIRANGE_MASK;
+    tmp |= RCC_CR_MSIRGSEL; /* range from RCC_CR, not RCC_CSR */
+    tmp |= RCC_CR_MSION;
+    RCC->CR = tmp;
+    if (wait_for_flag_set(&RCC->CR, RCC_CR_MSIRDY, SYSTEM_CLOCK_WAIT_MAX_ITER) != 0) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+/**
+ * @brief Turn HSI16 on.
+ */
+static inline int clock_hal_hsi16_enable(void) {
+    RCC->CR |= RCC_CR_HSION; /* Enable HSI16 */
+    if (wait_for_flag_set(&RCC->CR, RCC_CR_HSIRDY, SYSTEM_CLOCK_WAIT_MAX_ITER) != 0) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+/**
+ * @brief Configure the PLL from HSI16 for an operating point and lock it.
+ * The PLL must not be the SYSCLK source; HSI16 must be ready.
+ * SYSCLK = (HSI16 / PLLM) * PLLN / PLLR
+ */
+static inline int clock_hal_pll_enable(const sysclock_opp_t *opp) {
+    /* Disable PLL */
+    RCC->CR &= ~RCC_CR_PLLON;
+    if (wait_for_flag_clear(&RCC->CR, RCC_CR_PLLRDY, SYSTEM_CLOCK_WAIT_MAX_ITER) != 0) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+
+    /* Configure PLL */
+    uint32_t tmp = RCC->PLLCFGR;
+    tmp &= ~RCC_PLLCFGR_PLLSRC_MASK; /* clear PLLSRC bits */
+    tmp |= RCC_PLLCFGR_PLLSRC_HSI16; /* HSI16 as PLL source */
+    tmp &= ~RCC_PLLCFGR_PLLM_MASK; /* clear PLLM bits */
+    tmp |= (((uint32_t)opp->pllm - 1U) << RCC_PLLCFGR_PLLM_POS) & RCC_PLLCFGR_PLLM_MASK;
+    tmp &= ~RCC_PLLCFGR_PLLN_MASK; /* clear PLLN bits */
+    tmp |= ((uint32_t)opp->plln << RCC_PLLCFGR_PLLN_POS) & RCC_PLLCFGR_PLLN_MASK;
+    tmp &= ~RCC_PLLCFGR_PLLR_MASK; /* clear PLLR bits */
+    tmp |= ((uint32_t)opp->pllr_bits << RCC_PLLCFGR_PLLR_POS) & RCC_PLLCFGR_PLLR_MASK;
+    tmp |= RCC_PLLCFGR_PLLREN; /* enable PLLR output */
+    RCC->PLLCFGR = tmp;
+
+    /* Enable PLL */
+    RCC->CR |= RCC_CR_PLLON;
+    if (wait_for_flag_set(&RCC->CR, RCC_CR_PLLRDY, SYSTEM_CLOCK_WAIT_MAX_ITER) != 0) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+/**
+ * @brief Turn an oscillator off. It must not be the SYSCLK source.
+ */
+static inline int clock_hal_osc_disable(sysclk_source_t src) {
+    uint32_t on;
+    uint32_t rdy;
+
+    switch (src) {
+        case SYSCLK_SRC_MSI:   on = RCC_CR_MSION; rdy = RCC_CR_MSIRDY; break;
+        case SYSCLK_SRC_HSI16: on = RCC_CR_HSION; rdy = RCC_CR_HSIRDY; break;
+        case SYSCLK_SRC_PLL:   on = RCC_CR_PLLON; rdy = RCC_CR_PLLRDY; break;
+        default:               return SYSTEM_CLOCK_ERR_UNSUPPORTED;
+    }
+    RCC->CR &= ~on;
+    if (wait_for_flag_clear(&RCC->CR, rdy, SYSTEM_CLOCK_WAIT_MAX_ITER) != 0) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+/**
+ * @brief Select the SYSCLK source and wait until SWS reports it.
+ */
+static inline int clock_hal_select(sysclk_source_t src) {
+    uint32_t tmp = RCC->CFGR;
+    tmp &= ~(RCC_CFGR_SW_MASK); /* clear SW bits */
+    tmp |= ((uint32_t)src << RCC_CFGR_SW_POS) & RCC_CFGR_SW_MASK;
+    RCC->CFGR = tmp;
+    if (wait_for_reg_mask_eq(&RCC->CFGR, RCC_CFGR_SWS_MASK,
+                            ((uint32_t)src << RCC_CFGR_SWS_POS),
+                            SYSTEM_CLOCK_WAIT_MAX_ITER) != 0) {
+        return SYSTEM_CLOCK_ERR_TIMEOUT;
+    }
+    return SYSTEM_CLOCK_OK;
+}
+
+#endif /* CLOCK_HAL_STM32_H */
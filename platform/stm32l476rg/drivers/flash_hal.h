@@ -3,6 +3,7 @@
 
 #include "device_registers.h"
 #include "arch_ops.h"
+#include "platform_config.h"
 
 /* Flash Keys */
 #define FLASH_KEY1              0x45670123U
@@ -57,8 +58,7 @@ static inline int flash_hal_erase_page(uint32_t page_addr) {
     FLASH->SR = (FLASH_SR_EOP | FLASH_SR_PGSERR);
 
     /* Calculate Page Number (2KB pages on STM32L476) */
-    /* Base is 0x08000000 */
-    uint32_t page = (page_addr - 0x08000000) / 2048;
+    uint32_t page = (page_addr - FLASH_MEM_BASE) / FLASH_PAGE_SIZE;
 
     /* Configure Erase */
     uint32_t cr = FLASH->CR;
@@ -113,4 +113,12 @@ static inline int flash_hal_program(uint32_t addr, const void *data, size_t len)
     return 0;
 }
 
+/**
+ * @brief Translate a flash address into a readable pointer.
+ * Main flash is memory-mapped, so this is the identity.
+ */
+static inline const void *flash_hal_map(uintptr_t addr) {
+    return (const void *)addr;
+}
+
 #endif /* FLASH_HAL_STM32_H */
@@ -354,4 +354,20 @@ static inline void i2c_hal_clear_config(void *hal_handle) {
   }
 }
 
+/* Clock scaling helpers */
+static inline uint32_t i2c_hal_config_speed(const void *config_ptr) {
+  const I2C_Config_t *cfg = (const I2C_Config_t *)config_ptr;
+  return cfg ? (uint32_t)cfg->Speed : 0U;
+}
+
+/* Recompute TIMINGR for a new PCLK1; TIMINGR is only writable with PE clear */
+static inline void i2c_hal_set_clock(void *hal_handle, uint32_t pclk_hz, uint32_t speed) {
+  I2C_TypeDef *I2Cx = (I2C_TypeDef *)hal_handle;
+  if (!I2Cx)
+    return;
+  I2Cx->CR1 &= ~I2C_CR1_PE;
+  I2Cx->TIMINGR = i2c_hal_compute_timing(pclk_hz, (I2C_Speed_t)speed);
+  I2Cx->CR1 |= I2C_CR1_PE;
+}
+
 #endif /* I2C_HAL_STM32_H */
@@ -21,6 +21,19 @@
 /* TIMx_CCER */
 #define TIM_CCER_CC1E           (1U << 0)
 
+/**
+ * @brief Prescaler for a PWM frequency with 100 steps resolution.
+ * Freq = Clock / ((PSC+1) * (ARR+1)), with ARR fixed at 99.
+ * @return PSC, or -1 if the frequency cannot be reached from pclk.
+ */
+static inline int32_t pwm_hal_calc_prescaler(uint32_t pclk, uint32_t freq_hz) {
+    if (freq_hz == 0U || freq_hz > pclk / 100U) {
+        return -1;
+    }
+    uint32_t psc = (pclk / (freq_hz * 100U)) - 1U;
+    return (psc > 0xFFFFU) ? -1 : (int32_t)psc;
+}
+
 /**
  * @brief Initialize PWM on TIM2.
  * Assumes 80MHz PCLK1.
@@ -53,16 +66,14 @@ static inline int pwm_hal_init(void *hal_handle, uint8_t channel, uint32_t freq_
         return -1; /* Only TIM2 supported in this HAL for now */
     }
 
-    /* Calculate Prescaler for desired frequency with 100 steps resolution */
-    /* Freq = Clock / ((PSC+1) * (ARR+1)) */
     /* We fix ARR = 99 (so period is 100 ticks) */
-    /* PSC = (Clock / (Freq * 100)) - 1 */
-    
-    uint32_t pclk = platform_get_cpu_freq();
     uint32_t arr = 99;
-    uint32_t psc = (pclk / (freq_hz * 100)) - 1;
+    int32_t psc = pwm_hal_calc_prescaler((uint32_t)platform_get_cpu_freq(), freq_hz);
+    if (psc < 0) {
+        return -1;
+    }
 
-    TIMx->PSC = psc;
+    TIMx->PSC = (uint32_t)psc;
     TIMx->ARR = arr;
 
     /* Configure Channel for PWM Mode 1 */
@@ -106,6 +117,12 @@ static inline void pwm_hal_start(void *hal_handle, uint8_t channel) {
     TIMx->CR1 |= TIM_CR1_CEN;
 }
 
+/* PSC is preloaded: the new value takes effect at the next update event */
+static inline void pwm_hal_set_prescaler(void *hal_handle, uint32_t psc) {
+    TIM_TypeDef *TIMx = (TIM_TypeDef *)hal_handle;
+    TIMx->PSC = psc;
+}
+
 static inline void pwm_hal_stop(void *hal_handle, uint8_t channel) {
     TIM_TypeDef *TIMx = (TIM_TypeDef *)hal_handle;
     
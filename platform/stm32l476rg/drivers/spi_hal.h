@@ -246,4 +246,36 @@ static inline void spi_hal_write_byte(void *hal_handle, uint8_t byte) {
   *((volatile uint8_t *)&SPIx->DR) = byte;
 }
 
+/* Clock scaling helpers */
+static inline uint8_t spi_hal_busy(void *hal_handle) {
+  SPI_TypeDef *SPIx = (SPI_TypeDef *)hal_handle;
+  return (SPIx != NULL) && (SPIx->SR & SPI_SR_BSY);
+}
+
+/* SCK the programmed prescaler gives at a kernel clock: pclk / 2^(BR+1) */
+static inline uint32_t spi_hal_get_sck_hz(void *hal_handle, uint32_t pclk) {
+  SPI_TypeDef *SPIx = (SPI_TypeDef *)hal_handle;
+  if (SPIx == NULL) {
+    return 0;
+  }
+  uint32_t br = (SPIx->CR1 & SPI_CR1_BR_Mask) >> SPI_CR1_BR_Pos;
+  return pclk >> (br + 1U);
+}
+
+/* Fastest prescaler that keeps SCK at or below sck_hz; BR is written with SPE clear */
+static inline void spi_hal_set_sck_hz(void *hal_handle, uint32_t pclk, uint32_t sck_hz) {
+  SPI_TypeDef *SPIx = (SPI_TypeDef *)hal_handle;
+  if (SPIx == NULL) {
+    return;
+  }
+  uint32_t br = 0;
+  while (br < 7U && (pclk >> (br + 1U)) > sck_hz) {
+    br++;
+  }
+  uint32_t cr1 = SPIx->CR1;
+  SPIx->CR1 = cr1 & ~SPI_CR1_SPE;
+  SPIx->CR1 = (cr1 & ~(SPI_CR1_SPE | SPI_CR1_BR_Mask)) | (br << SPI_CR1_BR_Pos);
+  SPIx->CR1 |= (cr1 & SPI_CR1_SPE);
+}
+
 #endif /* SPI_HAL */
@@ -32,6 +32,7 @@
 #define USART_ISR_NE                (1UL << 2)
 #define USART_ISR_ORE               (1UL << 3)
 #define USART_ISR_RXNE              (1UL << 5)
+#define USART_ISR_TC                (1UL << 6)
 #define USART_ISR_TXE               (1UL << 7)
 
 /* USART interrupt flag clear register (ICR) bits */
@@ -108,6 +109,33 @@ static inline void uart_hal_enable_clocks_and_pins(USART_TypeDef *UARTx)
 
 /* HAL Implementation */
 
+/**
+ * @brief Program the baud rate divider. The UART must be disabled (UE = 0).
+ * @param UARTx Pointer to the UART register block.
+ * @param baud Baud rate in bits per second.
+ * @param clock_freq Frequency of the clock source feeding the UART peripheral.
+ */
+static inline void uart_hal_write_brr(USART_TypeDef *UARTx, uint32_t baud, uint32_t clock_freq)
+{
+    uint32_t usartdiv;
+
+    if (UARTx == LPUART1) {
+        /* LPUART uses a different BRR encoding (256x) */
+        usartdiv = (uint32_t)( ((uint64_t)clock_freq * 256U + (baud / 2U)) / baud );
+        UARTx->BRR = usartdiv;
+    } else {
+        if ((UARTx->CR1 & USART_CR1_OVER8) == 0U) {
+            /* Oversampling by 16 */
+            usartdiv = (clock_freq + (baud / 2U)) / baud;
+            UARTx->BRR = usartdiv;
+        } else {
+            /* Oversampling by 8 */
+            usartdiv = ((clock_freq * 2U) + (baud / 2U)) / baud;
+            UARTx->BRR = (usartdiv & 0xFFF0U) | ((usartdiv & 0x000FU) >> 1U);
+        }
+    }
+}
+
 /**
  * @brief Initialize the UART hardware with the given configuration.
  * 
@@ -161,24 +189,7 @@ static inline void uart_hal_init(void *hal_handle, void *config_ptr, uint32_t cl
     }
 
     /* Baud Rate */
-    uint32_t baud = config->BaudRate;
-    uint32_t usartdiv;
-
-    if (UARTx == LPUART1) {
-        /* LPUART uses a different BRR encoding (256x) */
-        usartdiv = (uint32_t)( ((uint64_t)clock_freq * 256U + (baud / 2U)) / baud );
-        UARTx->BRR = usartdiv;
-    } else {
-        if ((UARTx->CR1 & USART_CR1_OVER8) == 0U) {
-            /* Oversampling by 16 */
-            usartdiv = (clock_freq + (baud / 2U)) / baud;
-            UARTx->BRR = usartdiv;
-        } else {
-            /* Oversampling by 8 */
-            usartdiv = ((clock_freq * 2U) + (baud / 2U)) / baud;
-            UARTx->BRR = (usartdiv & 0xFFF0U) | ((usartdiv & 0x000FU) >> 1U);
-        }
-    }
+    uart_hal_write_brr(UARTx, config->BaudRate, clock_freq);
 
     /* Enable */
     UARTx->CR1 |= (USART_CR1_TE | USART_CR1_RE | USART_CR1_UE);
@@ -232,6 +243,50 @@ static inline void uart_hal_write_byte(void *hal_handle, uint8_t byte) {
     }
 }
 
+/**
+ * @brief Get the baud rate from a UART configuration.
+ * @param config_ptr Pointer to UART_Config_t, may be NULL.
+ * @return Baud rate, 0 if there is no configuration.
+ */
+static inline uint32_t uart_hal_config_baud(const void *config_ptr)
+{
+    return config_ptr ? ((const UART_Config_t *)config_ptr)->BaudRate : 0U;
+}
+
+/**
+ * @brief Check whether a frame is still being shifted out.
+ * @param hal_handle Pointer to the UART hardware register block.
+ * @return 1 while transmission is not complete (TC clear), 0 when idle.
+ */
+static inline uint8_t uart_hal_tx_busy(void *hal_handle)
+{
+    USART_TypeDef *UARTx = (USART_TypeDef *)hal_handle;
+    if (UARTx == NULL || (UARTx->CR1 & USART_CR1_UE) == 0U) {
+        return 0;
+    }
+    return (UARTx->ISR & USART_ISR_TC) ? 0 : 1;
+}
+
+/**
+ * @brief Reprogram the baud rate divider for a new kernel clock.
+ * BRR can only be written with the UART disabled; the rest of CR1,
+ * interrupt enables included, is restored afterwards.
+ * @param hal_handle Pointer to the UART hardware register block.
+ * @param baud Baud rate in bits per second.
+ * @param clock_freq New frequency of the clock feeding the UART.
+ */
+static inline void uart_hal_set_baud(void *hal_handle, uint32_t baud, uint32_t clock_freq)
+{
+    USART_TypeDef *UARTx = (USART_TypeDef *)hal_handle;
+    if (UARTx == NULL || baud == 0U) {
+        return;
+    }
+    uint32_t cr1 = UARTx->CR1;
+    UARTx->CR1 = cr1 & ~USART_CR1_UE;
+    uart_hal_write_brr(UARTx, baud, clock_freq);
+    UARTx->CR1 = cr1;
+}
+
 /**
  * @brief Generic ISR handler to be called from platform-specific ISRs.
  * 
@@ -8,6 +8,10 @@
 #include "arch_ops.h"
 #include "uart.h"
 #include "uart_hal.h"
+#include "perf.h"
+#include "irqprof.h"
+#include "systick_hal.h"
+#include "scheduler.h"
 
 #define PLATFORM_UART_RX_BUF_SIZE 128U
 #define PLATFORM_UART_TX_BUF_SIZE 128U
@@ -16,9 +20,13 @@
 #define SCB_CPACR_CP11_FULL     (3UL << 22) /* CPACR: full access for CP11 */
 #define FPU_FPCCR_ASPEN         (1UL << 31) /* FPCCR: automatic state preservation */
 #define FPU_FPCCR_LSPEN         (1UL << 30) /* FPCCR: lazy state preservation */
+#define DEM_CR_TRCENA           (1UL << 24) /* DEMCR: enable DWT/ITM */
+#define DWT_CTRL_CYCCNTENA      (1UL << 0)  /* DWT_CTRL: enable cycle counter */
+#define SYSTICK_IRQN            (-1)        /* System handler numbers are negative */
 
 /* Default to MSI 4MHz (reset value) */
 static size_t current_cpu_freq = 4000000; 
+static size_t current_tick_hz = 0;
 static uart_port_t uart2_port = NULL;
 static uint8_t uart2_rx_buf[PLATFORM_UART_RX_BUF_SIZE];
 static uint8_t uart2_tx_buf[PLATFORM_UART_TX_BUF_SIZE];
@@ -36,6 +44,16 @@ static void platform_fpu_init(void) {
 #endif
 }
 
+/* Set an interrupt's priority (0 = highest); negative numbers are system handlers */
+static void platform_irq_set_priority(int32_t irqn, uint32_t priority) {
+    uint8_t level = (uint8_t)(priority << (8U - NVIC_PRIO_BITS));
+    if (irqn < 0) {
+        SCB->SHPR[12 + irqn] = level;   /* SHPR[0] is exception 4 */
+    } else {
+        NVIC_IPR(irqn) = level;
+    }
+}
+
 /* Initialize the platform core hardware. */
 void platform_init(void) {
     /*
@@ -52,6 +70,16 @@ void platform_init(void) {
     memory_map_init();
 
     platform_fpu_init();
+
+#if STACK_GUARD_ENABLE
+    /* MPU guard at the bottom of the running task's stack */
+    arch_stack_guard_init();
+#endif
+
+    /* Free-running cycle counter for platform_get_cycles(); Reset_Handler
+     * already started it, and it is not cleared so the boot timeline holds */
+    DEM_CR_REG |= DEM_CR_TRCENA;
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA;
 }
 
 /* Enter a critical error state (Panic). */
@@ -76,13 +104,69 @@ size_t platform_get_cpu_freq(void) {
     return current_cpu_freq;
 }
 
+/* Switch the core clock and retime SysTick for it. */
+int platform_set_cpu_freq(size_t hz) {
+    int rc = system_clock_switch((uint32_t)hz);
+
+    /* Also after a failure: the sequencer may have stopped on another point */
+    current_cpu_freq = get_system_clock_hz();
+    if (current_tick_hz != 0) {
+        systick_init(current_tick_hz);
+    }
+    return rc;
+}
+
+/* Read the DWT cycle counter. */
+uint32_t platform_get_cycles(void) {
+    return DWT_CYCCNT_REG;
+}
+
+/* Spins to wait for the probe handler; entry takes tens of cycles unless IRQs are masked */
+#define PROBE_WAIT_SPINS    10000U
+
+static volatile uint32_t probe_entry_cycles;
+static volatile uint8_t probe_fired;
+
+/* TIM7 is unused: its vector is borrowed to time interrupt entry */
+RAMFUNC void TIM7_IRQHandler(void) {
+    probe_entry_cycles = DWT_CYCCNT_REG;
+    probe_fired = 1;
+}
+
+/* Pend TIM7 by software and count cycles until its handler starts. 0 if it never ran. */
+uint32_t platform_irq_entry_cycles(void) {
+    static uint8_t probe_ready;
+    if (!probe_ready) {
+        platform_irq_set_priority(TIM7_IRQn, IRQ_PRIORITY_ZERO_LATENCY(0));
+        NVIC_ISER1 = (1UL << (TIM7_IRQn & 0x1F));
+        probe_ready = 1;
+    }
+
+    probe_fired = 0;
+    uint32_t start = DWT_CYCCNT_REG;
+    NVIC_ISPR1 = (1UL << (TIM7_IRQn & 0x1F));
+    arch_dsb();
+    arch_isb();
+    for (uint32_t n = 0; !probe_fired; n++) {
+        if (n >= PROBE_WAIT_SPINS) {
+            /* Interrupts masked by the caller: drop the pend so it does not fire later */
+            NVIC_ICPR1 = (1UL << (TIM7_IRQn & 0x1F));
+            return 0;
+        }
+    }
+    return probe_entry_cycles - start;
+}
+
 /* Initializes the system tick timer. */
 void platform_systick_init(size_t tick_hz) {
+    /* Below the kernel ceiling before the first tick, not just at scheduler start */
+    platform_irq_set_priority(SYSTICK_IRQN, IRQ_PRIORITY_KERNEL(SYSTICK_PRIORITY));
+    current_tick_hz = tick_hz;
     systick_init(tick_hz);
 }
 
 /* Retrieves the current system tick count. */
-size_t platform_get_ticks(void) {
+RAMFUNC size_t platform_get_ticks(void) {
     return systick_get_ticks();
 }
 
@@ -139,7 +223,8 @@ uart_port_t platform_uart_init(void) {
         platform_panic();
     }
 
-    /* Enable UART2 interrupts in NVIC */
+    /* Enable UART2 interrupts in NVIC (reset priority 0 would be above the ceiling) */
+    platform_irq_set_priority(USART2_IRQn, IRQ_PRIORITY_KERNEL(USART2_IRQ_PRIORITY));
     NVIC_ISER1 |= (1UL << (USART2_IRQn & 0x1F));
     
     /* Enable RX interrupt for buffered reception */
@@ -168,6 +253,13 @@ int platform_uart_puts(const char *s) {
     return uart2_port ? uart_write_buffer(uart2_port, s, len) : 0;
 }
 
+int platform_uart_write(const char *data, size_t len) {
+    if (data == NULL) {
+        return 0;
+    }
+    return uart2_port ? uart_write_buffer(uart2_port, data, len) : 0;
+}
+
 void platform_uart_set_rx_notify(uint16_t task_id) {
     if (uart2_port) {
         uart_set_rx_notify_task(uart2_port, task_id);
@@ -186,9 +278,25 @@ void platform_uart_set_tx_queue(queue_t *q) {
     }
 }
 
+PERF_COUNTER(perf_irq_usart2, "irq.usart2");
+
 /* USART2 IRQ handler: wire UART HAL to driver core */
 void USART2_IRQHandler(void) {
+    IRQPROF_ISR_ENTER("USART2");
+    PERF_INC(perf_irq_usart2);
     if (uart2_port) {
         uart_hal_irq_handler(USART2, uart2_port);
     }
+    IRQPROF_ISR_EXIT();
+    /* RX may have woken the CLI task: switch to it on exit, not at the next tick */
+    scheduler_yield_from_isr();
+}
+
+/* SysTick handler: drive the kernel tick */
+RAMFUNC void SysTick_Handler(void) {
+    /* The counter reloaded when the tick fired, so RVR - CVR cycles have passed */
+    IRQPROF_TICK_LATENCY(SYSTICK->RVR - SYSTICK->CVR);
+    IRQPROF_ISR_ENTER("SysTick");
+    systick_hal_irq_handler();
+    IRQPROF_ISR_EXIT();
 }
@@ -12,14 +12,51 @@
    Lower numbers = higher priority
    STM32L4 has 4 bits = 16 priority levels (0-15)
    
-   Priority 0:  Highest (critical hard faults)
-   Priority 5:  High-priority peripherals (timers, critical I/O)
-   Priority 10: Normal peripherals (UART, SPI, I2C)
-   Priority 14: SysTick (lower than most peripherals)
-   Priority 15: PendSV (lowest - for context switching)
+   Priority 0-4:  Zero-latency (motor/power fault ISRs). Never masked by the
+                  kernel, so they must not call any kernel API.
+   Priority 5:    Kernel ceiling (MAX_SYSCALL_PRIORITY). spin_lock() raises
+                  BASEPRI to this level instead of setting PRIMASK.
+   Priority 10:   Normal peripherals (UART, SPI, I2C)
+   Priority 14:   SysTick (lower than most peripherals)
+   Priority 15:   PendSV (lowest - for context switching)
 ============================================================================ */
+#define NVIC_PRIO_BITS         4   /* Implemented priority bits */
+#ifndef MAX_SYSCALL_PRIORITY
 #define MAX_SYSCALL_PRIORITY   5   /* Highest priority that can call RTOS functions */
+#endif
 #define SYSTICK_PRIORITY       14  /* SysTick priority (lower than peripherals) */
 #define PENDSV_PRIORITY        15  /* PendSV priority (lowest for context switch) */
+#define USART2_IRQ_PRIORITY    10  /* CLI UART: wakes tasks, so at or below the ceiling */
+
+#if (MAX_SYSCALL_PRIORITY < 1) || (MAX_SYSCALL_PRIORITY >= (1 << NVIC_PRIO_BITS))
+#error "MAX_SYSCALL_PRIORITY must be 1..15 (BASEPRI 0 would mask nothing)"
+#endif
+#if (SYSTICK_PRIORITY < MAX_SYSCALL_PRIORITY) || (USART2_IRQ_PRIORITY < MAX_SYSCALL_PRIORITY)
+#error "Kernel-aware interrupts must not be above MAX_SYSCALL_PRIORITY"
+#endif
+
+/* Checked priority for an ISR that calls kernel APIs */
+#define IRQ_PRIORITY_KERNEL(p) __extension__ ({                                \
+    _Static_assert((p) >= MAX_SYSCALL_PRIORITY && (p) < (1 << NVIC_PRIO_BITS), \
+                   "Kernel-aware ISR priority above MAX_SYSCALL_PRIORITY");    \
+    (uint32_t)(p);                                                             \
+})
+
+/* Checked priority for a zero-latency ISR (never masked, no kernel calls) */
+#define IRQ_PRIORITY_ZERO_LATENCY(p) __extension__ ({                          \
+    _Static_assert((p) >= 0 && (p) < MAX_SYSCALL_PRIORITY,                     \
+                   "Zero-latency ISR priority must be above MAX_SYSCALL_PRIORITY"); \
+    (uint32_t)(p);                                                             \
+})
+
+/* ============================================================================
+   Flash Memory Layout
+   ============================================================================ */
+#define FLASH_MEM_BASE         0x08000000UL     /* Start of main flash */
+#define FLASH_MEM_SIZE         (1024UL * 1024UL) /* 1MB main flash */
+#define FLASH_PAGE_SIZE        2048U            /* Erase granularity in bytes */
+#define FLASH_PROGRAM_UNIT     8U               /* Program granularity (double word) */
+#define FLASH_STORAGE_SIZE     (64UL * 1024UL)   /* Reserved for persistent data */
+#define FLASH_STORAGE_BASE     (FLASH_MEM_BASE + FLASH_MEM_SIZE - FLASH_STORAGE_SIZE)
 
 #endif /* PLATFORM_CONFIG_H */
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include <stdint.h>
 #include "arch_ops.h"
+#include "device_registers.h"
 #include "led.h"
+#include "boot.h"
 
 /* Linker script symbols */
 extern uint32_t _estack;  /* Initial stack pointer */
@@ -9,6 +11,12 @@ extern uint32_t _sdata;   /* Start of .data in SRAM */
 extern uint32_t _edata;   /* End of .data in SRAM */
 extern uint32_t _sbss;    /* Start of .bss in SRAM */
 extern uint32_t _ebss;    /* End of .bss in SRAM */
+extern uint32_t _siramfunc; /* Start of .ramfunc code in FLASH */
+extern uint32_t _sramfunc;  /* Start of .ramfunc in SRAM2 */
+extern uint32_t _eramfunc;  /* End of .ramfunc in SRAM2 */
+
+#define DEM_CR_TRCENA           (1UL << 24) /* DEMCR: enable DWT/ITM */
+#define DWT_CTRL_CYCCNTENA      (1UL << 0)  /* DWT_CTRL: enable cycle counter */
 
 /* Forward declarations */
 void Reset_Handler(void);
@@ -223,20 +231,86 @@ void (* const g_pfnVectors[])(void) = {
     FPU_IRQHandler
 };
 
+#define VECTOR_COUNT    (sizeof(g_pfnVectors) / sizeof(g_pfnVectors[0]))
+
+#if RAMFUNC_ENABLE
+/* VTOR needs the table aligned to its size rounded up to a power of two (98 words -> 512 B) */
+__attribute__((section(".ram_vector"), aligned(512)))
+static void (*g_ram_vectors[VECTOR_COUNT])(void);
+#endif
+
+/*
+ * Copy words until dst reaches end: 16 bytes per LDM/STM pair, then the odd
+ * words. The loop is assembly so it runs at this speed in -O0 builds too.
+ */
+static void startup_copy(uint32_t *dst, const uint32_t *src, const uint32_t *end) {
+    __asm volatile (
+        "1:  SUBS  r3, %[end], %[dst]\n"
+        "    CMP   r3, #16\n"
+        "    BLT   2f\n"
+        "    LDMIA %[src]!, {r3, r4, r5, r12}\n"
+        "    STMIA %[dst]!, {r3, r4, r5, r12}\n"
+        "    B     1b\n"
+        "2:  CMP   %[dst], %[end]\n"
+        "    BHS   3f\n"
+        "    LDR   r3, [%[src]], #4\n"
+        "    STR   r3, [%[dst]], #4\n"
+        "    B     2b\n"
+        "3:\n"
+        : [dst] "+r" (dst), [src] "+r" (src)
+        : [end] "r" (end)
+        : "r3", "r4", "r5", "r12", "cc", "memory"
+    );
+}
+
+/* Zero words until dst reaches end, 16 bytes per STM */
+static void startup_zero(uint32_t *dst, const uint32_t *end) {
+    __asm volatile (
+        "    MOVS  r2, #0\n"
+        "    MOVS  r3, #0\n"
+        "    MOVS  r4, #0\n"
+        "    MOV   r12, #0\n"
+        "1:  SUBS  r5, %[end], %[dst]\n"
+        "    CMP   r5, #16\n"
+        "    BLT   2f\n"
+        "    STMIA %[dst]!, {r2, r3, r4, r12}\n"
+        "    B     1b\n"
+        "2:  CMP   %[dst], %[end]\n"
+        "    BHS   3f\n"
+        "    STR   r2, [%[dst]], #4\n"
+        "    B     2b\n"
+        "3:\n"
+        : [dst] "+r" (dst)
+        : [end] "r" (end)
+        : "r2", "r3", "r4", "r5", "r12", "cc", "memory"
+    );
+}
+
 /* ---------- Reset handler ---------- */
 void Reset_Handler(void)
 {
+    /* 0) Start the cycle counter from zero; boot.c measures the first stage from here */
+    DEM_CR_REG |= DEM_CR_TRCENA;
+    DWT_CYCCNT_REG = 0;
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA;
+
     /* 1) Copy .data from FLASH to SRAM */
-    uint32_t *src = &_sidata;
-    uint32_t *dst = &_sdata;
-    while (dst < &_edata) {
-        *dst++ = *src++;
-    }
+    startup_copy(&_sdata, &_sidata, &_edata);
 
     /* 2) Zero initialize .bss */
-    for (uint32_t *b = &_sbss; b < &_ebss; ++b) {
-        *b = 0;
-    }
+    startup_zero(&_sbss, &_ebss);
+
+#if RAMFUNC_ENABLE
+    /* 3) Copy hot code to SRAM2 and take exceptions through a RAM vector table */
+    startup_copy(&_sramfunc, &_siramfunc, &_eramfunc);
+    startup_copy((uint32_t *)g_ram_vectors, (const uint32_t *)g_pfnVectors,
+                 (const uint32_t *)&g_ram_vectors[VECTOR_COUNT]);
+    SCB->VTOR = (uint32_t)(uintptr_t)g_ram_vectors;
+    arch_dsb();
+    arch_isb();
+#endif
+
+    boot_mark("crt0");
 
     /* 4) Jump to main */
     (void)main();
@@ -31,6 +31,10 @@ extern int mock_uart_init_called;
 extern int mock_uart_enable_rx_irq_arg;
 extern int mock_uart_enable_tx_irq_arg;
 extern uint8_t mock_uart_last_byte_written;
+extern uint32_t mock_uart_config_baud;
+extern uint8_t mock_uart_tx_busy;
+extern uint32_t mock_uart_set_baud_arg;
+extern uint32_t mock_uart_set_baud_clock;
 
 /* I2C Mocks */
 extern int mock_i2c_init_called;
@@ -40,10 +44,17 @@ extern int mock_i2c_start_called;
 extern int mock_i2c_start_return;
 extern int mock_i2c_stop_detected;
 extern int mock_i2c_nack_detected;
+extern uint32_t mock_i2c_config_speed;
+extern uint32_t mock_i2c_set_clock_pclk;
+extern uint32_t mock_i2c_set_clock_speed;
 
 /* SPI Mocks */
 extern int mock_spi_init_called;
 extern uint8_t mock_spi_transfer_return;
+extern uint8_t mock_spi_busy;
+extern uint32_t mock_spi_sck_hz;
+extern uint32_t mock_spi_set_sck_pclk;
+extern uint32_t mock_spi_set_sck_arg;
 
 /* ADC Mocks */
 extern int mock_adc_init_return;
@@ -69,6 +80,9 @@ extern int mock_pwm_init_return;
 extern uint8_t mock_pwm_last_duty;
 extern int mock_pwm_start_called;
 extern int mock_pwm_stop_called;
+extern int32_t mock_pwm_calc_prescaler;
+extern uint32_t mock_pwm_calc_pclk;
+extern int32_t mock_pwm_set_prescaler;
 
 /* RTC Mocks */
 extern int mock_rtc_init_return;
@@ -83,6 +97,7 @@ extern uint32_t mock_flash_erase_addr;
 extern int mock_flash_program_return;
 extern uint32_t mock_flash_program_addr;
 extern size_t mock_flash_program_len;
+extern int mock_flash_use_sim;  /* Forward flash HAL calls to the flash simulator */
 
 /* Helper to reset all mocks */
 void mock_drivers_reset(void);
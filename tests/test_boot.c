@@ -0,0 +1,134 @@
+#include "unity.h"
+#include "boot.h"
+#include "scheduler.h"
+#include "allocator.h"
+#include "test_common.h"
+#include <stdio.h>
+
+static uint8_t heap[8192];
+static int early_runs;
+static int deferred_runs;
+
+/* Defined here to check entries from any translation unit are collected */
+static int test_boot_early_init(void) {
+    early_runs++;
+    return 0;
+}
+BOOT_INIT(test_boot_early_init, BOOT_LEVEL_EARLY);
+
+static int test_boot_deferred_init(void) {
+    deferred_runs++;
+    return -3;
+}
+BOOT_INIT(test_boot_deferred_init, BOOT_LEVEL_DEFERRED);
+
+static void setUp_local(void) {
+    mock_cycles_step = 100;
+    mock_cpu_freq = 1000000;
+    early_runs = 0;
+    deferred_runs = 0;
+    boot_reset();
+}
+
+static void tearDown_local(void) {
+    mock_cycles_step = 0;
+    mock_cpu_freq = 1000000;
+}
+
+/* Verify each mark stores the cycles since the previous one */
+void test_boot_mark_records_elapsed(void) {
+    boot_mark("first");
+    boot_mark("second");
+
+    TEST_ASSERT_EQUAL_UINT32(2, boot_stage_count());
+    const boot_stage_t *a = boot_get_stage(0);
+    const boot_stage_t *b = boot_get_stage(1);
+    TEST_ASSERT_EQUAL_STRING("first", a->name);
+    TEST_ASSERT_EQUAL_STRING("second", b->name);
+    TEST_ASSERT_TRUE(a->elapsed >= 100);
+    TEST_ASSERT_EQUAL_UINT32(b->cycles - a->cycles, b->elapsed);
+    TEST_ASSERT_EQUAL_UINT32(a->elapsed, boot_stage_us(a));    /* 1 MHz: one cycle per us */
+    TEST_ASSERT_NULL(boot_get_stage(2));
+}
+
+/* Verify a stage is converted at the clock it started on, as across a PLL switch */
+void test_boot_stage_uses_starting_clock(void) {
+    mock_cycles_step = 8000;
+    boot_mark("slow");
+    mock_cpu_freq = 80000000;
+    boot_mark("switch");
+    boot_mark("fast");
+    mock_cpu_freq = 0;                          /* Host: counter in ns */
+    boot_mark("host");
+    boot_mark("ns");
+
+    const boot_stage_t *sw = boot_get_stage(1);
+    const boot_stage_t *fast = boot_get_stage(2);
+    const boot_stage_t *ns = boot_get_stage(4);
+    TEST_ASSERT_EQUAL_UINT32(1000000, sw->hz);
+    TEST_ASSERT_EQUAL_UINT32(sw->elapsed, boot_stage_us(sw));
+    TEST_ASSERT_EQUAL_UINT32(80000000, fast->hz);
+    TEST_ASSERT_EQUAL_UINT32(fast->elapsed / 80, boot_stage_us(fast));
+    TEST_ASSERT_EQUAL_UINT32(0, ns->hz);
+    TEST_ASSERT_EQUAL_UINT32(ns->elapsed / 1000, boot_stage_us(ns));
+}
+
+/* Verify a level runs only its own inits, each timed as a stage with its result */
+void test_boot_run_level(void) {
+    TEST_ASSERT_EQUAL(0, boot_run_level(BOOT_LEVEL_EARLY));
+    TEST_ASSERT_EQUAL(1, early_runs);
+    TEST_ASSERT_EQUAL(0, deferred_runs);
+    TEST_ASSERT_EQUAL_UINT32(1, boot_stage_count());
+    TEST_ASSERT_EQUAL_STRING("test_boot_early_init", boot_get_stage(0)->name);
+
+    boot_run_deferred();
+    TEST_ASSERT_EQUAL(1, early_runs);
+    TEST_ASSERT_EQUAL(1, deferred_runs);
+    TEST_ASSERT_EQUAL_UINT32(3, boot_stage_count());
+    TEST_ASSERT_EQUAL_STRING("until deferred", boot_get_stage(1)->name);
+    TEST_ASSERT_EQUAL_STRING("test_boot_deferred_init", boot_get_stage(2)->name);
+    TEST_ASSERT_EQUAL(-3, boot_get_stage(2)->result);
+
+    TEST_ASSERT_EQUAL(1, boot_run_level(BOOT_LEVEL_DEFERRED));
+}
+
+/* Verify marks past the table are counted, not stored */
+void test_boot_drops_past_capacity(void) {
+    for (uint32_t i = 0; i < BOOT_MAX_STAGES + 3; i++) {
+        boot_mark("fill");
+    }
+    TEST_ASSERT_EQUAL_UINT32(BOOT_MAX_STAGES, boot_stage_count());
+    TEST_ASSERT_EQUAL_UINT32(3, boot_dropped());
+
+    boot_reset();
+    TEST_ASSERT_EQUAL_UINT32(0, boot_stage_count());
+    TEST_ASSERT_EQUAL_UINT32(0, boot_dropped());
+}
+
+/* Verify the boot task is a low-weight task, so application tasks get the CPU first */
+void test_boot_defer_creates_low_weight_task(void) {
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+
+    int32_t id = boot_defer();
+    TEST_ASSERT_TRUE(id > 0);
+    task_t *t = scheduler_get_task_by_index(0);
+    TEST_ASSERT_NOT_NULL(t);
+    TEST_ASSERT_EQUAL(TASK_WEIGHT_LOW, task_get_weight(t));
+    TEST_ASSERT_EQUAL(0, deferred_runs);
+}
+
+void run_boot_tests(void) {
+    printf("\n=== Starting Boot Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_boot.c");
+    RUN_TEST(test_boot_mark_records_elapsed);
+    RUN_TEST(test_boot_stage_uses_starting_clock);
+    RUN_TEST(test_boot_run_level);
+    RUN_TEST(test_boot_drops_past_capacity);
+    RUN_TEST(test_boot_defer_creates_low_weight_task);
+
+    printf("=== Boot Tests Complete ===\n");
+}
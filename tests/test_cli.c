@@ -7,6 +7,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "spinlock.h"
+#include "utils.h"
 #include <project_config.h>
 
 static uint8_t heap[8192];
@@ -120,6 +121,21 @@ void test_cli_register_and_execute_command(void) {
     TEST_ASSERT_EQUAL_STRING("arg1", test_cmd_last_arg);
 }
 
+/* Verify a name whose RPC ID is already taken is refused */
+void test_cli_register_rejects_id_collision(void) {
+    cli_command_t cmd = { .name = "glbvs", .help = "A", .handler = my_cmd_handler };
+    cli_command_t clash = { .name = "yacxa", .help = "B", .handler = my_cmd_handler };
+
+    TEST_ASSERT_EQUAL_HEX32(cli_command_id(cmd.name), cli_command_id(clash.name));  /* FNV-1a collision */
+    TEST_ASSERT_EQUAL(CLI_OK, cli_register_command(&cmd));
+    TEST_ASSERT_EQUAL(CLI_ERR, cli_register_command(&clash));
+    TEST_ASSERT_EQUAL(CLI_ERR, cli_register_command(&cmd));                          /* Same name */
+
+    TEST_ASSERT_EQUAL(CLI_OK, cli_unregister_command("glbvs"));
+    TEST_ASSERT_EQUAL(CLI_OK, cli_register_command(&clash));
+    TEST_ASSERT_EQUAL(CLI_OK, cli_unregister_command("yacxa"));
+}
+
 /* Verify unregistering a command */
 void test_cli_unregister_command(void) {
     cli_command_t cmd = { 
@@ -211,6 +227,53 @@ void test_cli_printf_string_padding(void) {
     TEST_ASSERT_EQUAL_STRING("|       foo|bar       |", output);
 }
 
+/* Verify cli_printf formatting - 64-bit lengths */
+void test_cli_printf_long_lengths(void) {
+    cli_printf("%llu %lld %llx %lu %ld %lx|%12llu|", 18446744073709551615ULL, -9000000000LL,
+               0x123456789ABULL, 4000000000UL, -5L, 0xBEEFUL, 42ULL);
+
+    char output[128];
+    get_tx_string(output, sizeof(output));
+    TEST_ASSERT_EQUAL_STRING("18446744073709551615 -9000000000 123456789ab 4000000000 -5 beef|"
+                             "          42|", output);
+}
+
+/* Verify long output is not truncated and waits in the stream while the TX queue is full */
+void test_cli_printf_streams_long_output(void) {
+    char line[301];
+    char output[400];
+
+    memset(line, 'x', 300);
+    line[299] = 'y';
+    line[300] = '\0';
+
+    queue_delete(tx_q);
+    tx_q = queue_create(1, 16);
+    cli_set_tx_queue(tx_q);
+
+    TEST_ASSERT_EQUAL_UINT32(302, cli_printf("%s\r\n", line));
+    TEST_ASSERT_EQUAL(0, mock_yield_count);     /* Never blocked */
+
+    /* Each pump refills the queue; the UART side drains it */
+    size_t n = 0;
+    char c;
+    while (n < sizeof(output) - 1) {
+        if (queue_pop_from_isr(tx_q, &c) == 0) {
+            output[n++] = c;
+        } else {
+            cli_printf("");
+            if (queue_pop_from_isr(tx_q, &c) != 0) {
+                break;
+            }
+            output[n++] = c;
+        }
+    }
+    output[n] = '\0';
+    TEST_ASSERT_EQUAL(302, n);
+    TEST_ASSERT_EQUAL('y', output[299]);
+    TEST_ASSERT_EQUAL_STRING("\r\n", &output[300]);
+}
+
 /* Verify Backspace editing */
 void test_cli_editing_backspace(void) {
     /* Type "he", then backspace, then "elp" -> "help" */
@@ -335,6 +398,233 @@ void test_cli_handler_can_register_command(void) {
     TEST_ASSERT_EQUAL(1, test_cmd_called);
 }
 
+/* Verify lookups still resolve after removal moves commands in the table */
+void test_cli_hash_lookup_after_unregister(void) {
+    static const char *names[] = { "c0", "c1", "c2", "c3", "c4" };
+    for (int i = 0; i < 5; i++) {
+        cli_command_t cmd = { .name = names[i], .help = "", .handler = my_cmd_handler };
+        TEST_ASSERT_EQUAL(CLI_OK, cli_register_command(&cmd));
+    }
+    TEST_ASSERT_EQUAL(CLI_OK, cli_unregister_command("c1"));
+
+    test_cmd_called = 0;
+    push_rx_string("c4\rc0\rc1\r");
+    run_cli_until_block();
+    TEST_ASSERT_EQUAL(2, test_cmd_called);
+
+    char output[512];
+    get_tx_string(output, sizeof(output));
+    TEST_ASSERT_NOT_NULL(strstr(output, "Unknown command: c1"));
+}
+
+#if CLI_RPC_ENABLE
+static int rpc_echo_handler(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        cli_printf("%s;", argv[i]);
+    }
+    return 40 + argc;
+}
+
+/* Encode a request frame and push it to the RX queue */
+static void push_rpc_request(uint8_t seq, uint32_t id, int argc, const char **args, int corrupt) {
+    uint8_t body[128];
+    uint8_t enc[140];
+    uint32_t len = 6;
+
+    body[2] = seq;
+    memcpy(&body[3], &id, 4);
+    body[7] = (uint8_t)argc;
+    for (int i = 0; i < argc; i++) {
+        uint8_t n = (uint8_t)strlen(args[i]);
+        body[2 + len] = n;
+        memcpy(&body[3 + len], args[i], n);
+        len += 1U + n;
+    }
+    body[0] = (uint8_t)len;
+    body[1] = (uint8_t)(len >> 8);
+    uint32_t crc = utils_crc32(0, body, 2 + len) ^ (corrupt ? 1U : 0U);
+    memcpy(&body[2 + len], &crc, 4);
+
+    size_t n = utils_cobs_encode(body, 2 + len + 4, enc);
+    uint8_t sof = CLI_RPC_SOF;
+    queue_push_from_isr(rx_q, &sof);
+    for (size_t i = 0; i < n; i++) {
+        queue_push_from_isr(rx_q, &enc[i]);
+    }
+}
+
+/*
+ * Pull the next response frame from the TX queue, skipping text.
+ * Returns the output length, or -1 if there is no valid frame.
+ */
+static int pop_rpc_response(uint8_t *seq, int8_t *status, int32_t *ret, char *out) {
+    uint8_t frame[512];
+    size_t n = 0;
+    uint8_t c;
+
+    do {
+        if (queue_pop_from_isr(tx_q, &c) != 0) {
+            return -1;
+        }
+    } while (c != CLI_RPC_SOF);
+    while (queue_pop_from_isr(tx_q, &c) == 0 && c != 0U) {
+        frame[n++] = c;
+    }
+
+    int32_t len = utils_cobs_decode(frame, n, frame);
+    if (len < 12) {
+        return -1;
+    }
+    uint32_t plen = (uint32_t)frame[0] | ((uint32_t)frame[1] << 8);
+    uint32_t crc;
+    memcpy(&crc, &frame[2 + plen], 4);
+    if ((uint32_t)len != 2 + plen + 4 || crc != utils_crc32(0, frame, 2 + plen)) {
+        return -1;
+    }
+    *seq = frame[2];
+    *status = (int8_t)frame[3];
+    memcpy(ret, &frame[4], 4);
+    memcpy(out, &frame[8], plen - 6);
+    out[plen - 6] = '\0';
+    return (int)(plen - 6);
+}
+
+/* Verify a command runs by ID with binary arguments and captured output */
+void test_cli_rpc_round_trip(void) {
+    cli_command_t cmd = { .name = "echo", .help = "", .handler = rpc_echo_handler };
+    cli_register_command(&cmd);
+
+    const char *args[] = { "a b", "", "zz" };
+    push_rpc_request(7, cli_command_id("echo"), 3, args, 0);
+    run_cli_until_block();
+
+    uint8_t seq;
+    int8_t status;
+    int32_t ret;
+    char out[300];
+    TEST_ASSERT_EQUAL(8, pop_rpc_response(&seq, &status, &ret, out));
+    TEST_ASSERT_EQUAL(7, seq);
+    TEST_ASSERT_EQUAL(CLI_OK, status);
+    TEST_ASSERT_EQUAL(44, ret);
+    TEST_ASSERT_EQUAL_STRING("a b;;zz;", out);
+}
+
+/* Verify corrupted frames and unknown IDs are rejected */
+void test_cli_rpc_rejects_bad_frames(void) {
+    uint8_t seq;
+    int8_t status;
+    int32_t ret;
+    char out[300];
+
+    push_rpc_request(1, cli_command_id("help"), 0, NULL, 1);
+    run_cli_until_block();
+    TEST_ASSERT_EQUAL(0, pop_rpc_response(&seq, &status, &ret, out));
+    TEST_ASSERT_EQUAL(CLI_ERR_CRC, status);
+
+    push_rpc_request(2, cli_command_id("nope"), 0, NULL, 0);
+    run_cli_until_block();
+    TEST_ASSERT_EQUAL(0, pop_rpc_response(&seq, &status, &ret, out));
+    TEST_ASSERT_EQUAL(2, seq);
+    TEST_ASSERT_EQUAL(CLI_ERR_NOCMD, status);
+}
+
+/* Verify the reserved ID lists command names */
+void test_cli_rpc_list_commands(void) {
+    uint8_t seq;
+    int8_t status;
+    int32_t ret;
+    char out[300];
+
+    push_rpc_request(3, CLI_RPC_LIST_ID, 0, NULL, 0);
+    run_cli_until_block();
+    TEST_ASSERT_TRUE(pop_rpc_response(&seq, &status, &ret, out) > 0);
+    TEST_ASSERT_EQUAL(CLI_OK, status);
+    TEST_ASSERT_EQUAL_STRING("help\n", out);
+}
+
+/* Verify text commands and RPC frames share the console */
+void test_cli_rpc_multiplexed_with_text(void) {
+    cli_command_t cmd = { .name = "echo", .help = "", .handler = rpc_echo_handler };
+    cli_register_command(&cmd);
+
+    const char *args[] = { "x" };
+    push_rx_string("echo y\r");
+    push_rpc_request(9, cli_command_id("echo"), 1, args, 0);
+    push_rx_string("echo z\r");
+    run_cli_until_block();
+
+    /* Text output up to the response frame */
+    char text[256];
+    size_t i = 0;
+    uint8_t c;
+    while (i < sizeof(text) - 1 && queue_pop_from_isr(tx_q, &c) == 0 && c != CLI_RPC_SOF) {
+        text[i++] = (char)c;
+    }
+    text[i] = '\0';
+    TEST_ASSERT_NOT_NULL(strstr(text, "echo y\r\ny;"));
+
+    /* Re-insert the start byte consumed above, then read the response */
+    queue_t *rest = tx_q;
+    uint8_t sof = CLI_RPC_SOF;
+    tx_q = queue_create(1, 1024);
+    queue_push_from_isr(tx_q, &sof);
+    while (queue_pop_from_isr(rest, &c) == 0) {
+        queue_push_from_isr(tx_q, &c);
+    }
+    queue_delete(rest);
+
+    uint8_t seq;
+    int8_t status;
+    int32_t ret;
+    char out[300];
+    TEST_ASSERT_EQUAL(2, pop_rpc_response(&seq, &status, &ret, out));
+    TEST_ASSERT_EQUAL(9, seq);
+    TEST_ASSERT_EQUAL_STRING("x;", out);
+
+    get_tx_string(text, sizeof(text));
+    TEST_ASSERT_NOT_NULL(strstr(text, "echo z\r\nz;"));
+}
+
+/* Verify a stray start byte does not take over the console */
+void test_cli_rpc_resync_after_stray_start_byte(void) {
+    cli_command_t cmd = { .name = "echo", .help = "", .handler = rpc_echo_handler };
+    cli_register_command(&cmd);
+    char out[512];
+
+    /* A line ending after text: the line runs as typed */
+    push_rx_string("\xA5" "echo a\r");
+    run_cli_until_block();
+    get_tx_string(out, sizeof(out));
+    TEST_ASSERT_NOT_NULL(strstr(out, "echo a\r\na;"));
+
+    /* Mid-line, 0xA5 is just an unprintable character */
+    push_rx_string("echo\xA5 b\r");
+    run_cli_until_block();
+    get_tx_string(out, sizeof(out));
+    TEST_ASSERT_NOT_NULL(strstr(out, "echo b\r\nb;"));
+
+    /* Too short to rule out a frame: dropped once the line goes quiet */
+    push_rx_string("\xA5" "e");
+    run_cli_until_block();
+    mock_ticks += CLI_RPC_TIMEOUT_TICKS + 1U;
+    push_rx_string("echo c\r");
+    run_cli_until_block();
+    get_tx_string(out, sizeof(out));
+    TEST_ASSERT_NOT_NULL(strstr(out, "echo c\r\nc;"));
+
+    /* Frames still work afterwards */
+    const char *args[] = { "d" };
+    uint8_t seq;
+    int8_t status;
+    int32_t ret;
+    push_rpc_request(4, cli_command_id("echo"), 1, args, 0);
+    run_cli_until_block();
+    TEST_ASSERT_EQUAL(2, pop_rpc_response(&seq, &status, &ret, out));
+    TEST_ASSERT_EQUAL(4, seq);
+    TEST_ASSERT_EQUAL_STRING("d;", out);
+}
+#endif
+
 void run_cli_tests(void) {
     printf("\n=== Starting CLI Tests ===\n");
     test_setUp_hook = setUp_local;
@@ -343,6 +633,7 @@ void run_cli_tests(void) {
     
     RUN_TEST(test_cli_init_should_register_help);
     RUN_TEST(test_cli_register_and_execute_command);
+    RUN_TEST(test_cli_register_rejects_id_collision);
     RUN_TEST(test_cli_unregister_command);
     RUN_TEST(test_cli_printf_integers);
     RUN_TEST(test_cli_printf_padding);
@@ -351,12 +642,22 @@ void run_cli_tests(void) {
     RUN_TEST(test_cli_printf_unsigned);
     RUN_TEST(test_cli_printf_pointer);
     RUN_TEST(test_cli_printf_string_padding);
+    RUN_TEST(test_cli_printf_long_lengths);
+    RUN_TEST(test_cli_printf_streams_long_output);
     RUN_TEST(test_cli_editing_backspace);
     RUN_TEST(test_cli_editing_arrows_insert);
     RUN_TEST(test_cli_editing_arrows_right);
     RUN_TEST(test_cli_buffer_overflow);
     RUN_TEST(test_cli_empty_line);
     RUN_TEST(test_cli_handler_can_register_command);
+    RUN_TEST(test_cli_hash_lookup_after_unregister);
+#if CLI_RPC_ENABLE
+    RUN_TEST(test_cli_rpc_round_trip);
+    RUN_TEST(test_cli_rpc_rejects_bad_frames);
+    RUN_TEST(test_cli_rpc_list_commands);
+    RUN_TEST(test_cli_rpc_multiplexed_with_text);
+    RUN_TEST(test_cli_rpc_resync_after_stray_start_byte);
+#endif
     
     printf("=== CLI Tests Complete ===\n");
 }
\ No newline at end of file
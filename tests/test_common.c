@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 #include "platform.h"
 #include "spinlock.h"
 #include "arch_ops.h"
+#include "system_clock.h"
 #include <setjmp.h>
 #include "test_common.h"
 
@@ -24,6 +26,28 @@ size_t platform_get_cpu_freq(void) {
     return mock_cpu_freq; 
 }
 
+/* Platform Mock: switch the modelled clock tree and report its frequency */
+int platform_set_cpu_freq(size_t hz) {
+    int rc = system_clock_switch((uint32_t)hz);
+    mock_cpu_freq = get_system_clock_hz();
+    return rc;
+}
+
+/* Mock State: Fixed cycle step per read (0 = use the host clock) */
+uint32_t mock_cycles_step = 0;
+static uint32_t mock_cycles;
+
+/* Platform Mock: cycles are host monotonic nanoseconds, or a fixed step per call */
+uint32_t platform_get_cycles(void) {
+    if (mock_cycles_step) {
+        mock_cycles += mock_cycles_step;
+        return mock_cycles;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+
 /* Platform Mock: Systick init is a no-op on host */
 void platform_systick_init(size_t tick_hz) {
     (void)tick_hz;
@@ -90,6 +114,10 @@ int platform_uart_puts(const char *s) {
     return printf("%s", s);
 }
 
+int platform_uart_write(const char *data, size_t len) {
+    return (int)fwrite(data, 1, len, stdout);
+}
+
 /* Platform Mock: Reset exits the process */
 void platform_reset(void) {
     exit(0);
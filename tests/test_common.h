@@ -2,6 +2,7 @@
 #define TEST_COMMON_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <setjmp.h>
 
 /**
@@ -12,10 +13,16 @@ extern size_t mock_ticks;
 
 /**
  * @brief Mock CPU frequency.
- * Used by platform_get_cpu_freq().
+ * Used by platform_get_cpu_freq(); platform_set_cpu_freq() updates it.
  */
 extern size_t mock_cpu_freq;
 
+/**
+ * @brief Mock cycle counter step.
+ * When non-zero, each platform_get_cycles() call advances by this amount.
+ */
+extern uint32_t mock_cycles_step;
+
 /**
  * @brief Counter for how many times platform_yield() was called.
  */
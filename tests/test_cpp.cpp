@@ -0,0 +1,224 @@
+#include "sortos.hpp"
+#include "queue.h"
+#include "allocator.h"
+#include <stdio.h>
+#include <time.h>
+
+extern "C" {
+#include "unity.h"
+#include "test_common.h"
+}
+
+static uint8_t heap[8192];
+static task_t *t1;
+static task_t *t2;
+
+/* Static stack: task_create_static() refuses heap memory */
+static so::Task<1024> static_task;
+
+static void dummy_task(void *arg) {
+    (void)arg;
+}
+
+/* Two tasks on the heap allocator, T1 current */
+static void setUp_local(void) {
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    scheduler_start();
+
+    t1 = scheduler_get_task_by_index(0);
+    t2 = scheduler_get_task_by_index(1);
+    task_set_current(t1);
+    mock_yield_count = 0;
+}
+
+static void tearDown_local(void) {
+}
+
+struct sample_t {
+    uint32_t seq;
+    int16_t x, y, z;
+    uint16_t status;
+};
+
+static_assert(so::Queue<sample_t, 8>::capacity() == 8, "capacity is constexpr");
+
+/* Verify FIFO order, wrap-around and the non-blocking edges */
+void test_cpp_queue_fifo(void) {
+    so::Queue<sample_t, 4> q;
+    sample_t s = {}, out = {};
+
+    for (uint32_t round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            s.seq = round * 10 + i;
+            s.z = (int16_t)-i;
+            TEST_ASSERT_TRUE(q.try_push(s));
+        }
+        TEST_ASSERT_FALSE(q.try_push(s));
+        TEST_ASSERT_EQUAL(4, q.size());
+
+        for (uint32_t i = 0; i < 4; i++) {
+            TEST_ASSERT_TRUE(q.pop(out));
+            TEST_ASSERT_EQUAL_UINT32(round * 10 + i, out.seq);
+            TEST_ASSERT_EQUAL(-(int)i, out.z);
+        }
+        TEST_ASSERT_FALSE(q.try_pop(out));
+    }
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+}
+
+/* Verify push blocks on a full queue and pop blocks on an empty one */
+void test_cpp_queue_blocking(void) {
+    so::Queue<uint32_t, 2> q;
+    uint32_t v = 0;
+
+    q.try_push(1);
+    q.try_push(2);
+    if (setjmp(yield_jump) == 0) {
+        q.push(3);
+        TEST_FAIL_MESSAGE("push should have blocked");
+    }
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t1));
+
+    task_set_current(t2);
+    TEST_ASSERT_TRUE(q.pop(v));
+    TEST_ASSERT_EQUAL_UINT32(1, v);
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t1));
+
+    task_set_current(t1);
+    TEST_ASSERT_TRUE(q.push(3));                /* T1 resumes its loop */
+
+    task_set_current(t2);
+    TEST_ASSERT_TRUE(q.pop(v));
+    TEST_ASSERT_TRUE(q.pop(v));
+    TEST_ASSERT_EQUAL_UINT32(3, v);
+    if (setjmp(yield_jump) == 0) {
+        q.pop(v);
+        TEST_FAIL_MESSAGE("pop should have blocked");
+    }
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t2));
+    TEST_ASSERT_TRUE(q.try_push(4));
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t2));
+}
+
+struct counted_t {
+    static int live;
+    uint32_t a;
+    explicit counted_t(uint32_t v) : a(v) { live++; }
+    ~counted_t() { live--; }
+};
+int counted_t::live = 0;
+
+/* Verify construction in place, exhaustion and reuse, with no heap */
+void test_cpp_mempool(void) {
+    size_t before = allocator_get_free_size();
+    so::MemPool<counted_t, 3> pool;
+    counted_t *objs[3];
+
+    for (uint32_t i = 0; i < 3; i++) {
+        objs[i] = pool.create(100 + i);
+        TEST_ASSERT_NOT_NULL(objs[i]);
+    }
+    TEST_ASSERT_NULL(pool.create(0));
+    TEST_ASSERT_EQUAL(3, counted_t::live);
+    TEST_ASSERT_EQUAL_UINT32(101, objs[1]->a);
+
+    pool.destroy(objs[1]);
+    TEST_ASSERT_EQUAL(2, counted_t::live);
+    counted_t *again = pool.create(7);
+    TEST_ASSERT_EQUAL_PTR(objs[1], again);
+
+    pool.destroy(objs[0]);
+    pool.destroy(again);
+    pool.destroy(objs[2]);
+    TEST_ASSERT_EQUAL(0, counted_t::live);
+    TEST_ASSERT_EQUAL(before, allocator_get_free_size());
+}
+
+/* Verify the guard holds the mutex for exactly its scope */
+void test_cpp_mutex_guard(void) {
+    so::Mutex m;
+    {
+        so::LockGuard<so::Mutex> guard(m);
+        TEST_ASSERT_EQUAL_PTR(t1, so_mutex_get_owner(m.native_handle()));
+    }
+    TEST_ASSERT_NULL(so_mutex_get_owner(m.native_handle()));
+}
+
+/* Verify a Task runs on its own stack without touching the heap */
+void test_cpp_static_task(void) {
+    size_t before = allocator_get_free_size();
+
+    int32_t id = static_task.start(dummy_task);
+    TEST_ASSERT_TRUE(id > 0);
+    TEST_ASSERT_EQUAL(id, static_task.id());
+    TEST_ASSERT_EQUAL(1024, static_task.stack_size());
+    TEST_ASSERT_EQUAL(before, allocator_get_free_size());
+}
+
+#define BENCH_ROUNDS    200000U
+#define BENCH_DEPTH     8
+
+static uint64_t elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (uint64_t)(b->tv_sec - a->tv_sec) * 1000000000ULL + (uint64_t)(b->tv_nsec - a->tv_nsec);
+}
+
+/* Time BENCH_ROUNDS push/pop pairs through a C queue_t and an so::Queue */
+template <typename T>
+static void bench_queue(const char *name) {
+    struct timespec t0, t1;
+    T in = {}, out = {};
+
+    size_t before = allocator_get_free_size();
+    queue_t *cq = queue_create(sizeof(T), BENCH_DEPTH);
+    size_t c_heap = before - allocator_get_free_size();
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        queue_push_from_isr(cq, &in);
+        queue_pop_from_isr(cq, &out);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    uint64_t c_ns = elapsed_ns(&t0, &t1);
+    queue_delete(cq);
+
+    before = allocator_get_free_size();
+    so::Queue<T, BENCH_DEPTH> q;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        q.try_push(in);
+        q.try_pop(out);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    uint64_t cpp_ns = elapsed_ns(&t0, &t1);
+    TEST_ASSERT_EQUAL(before, allocator_get_free_size());
+
+    printf("%-10s x%d: queue_t %u heap bytes, %llu ns/pair | so::Queue %u bytes in-object, 0 heap, %llu ns/pair\n",
+           name, BENCH_DEPTH, (unsigned)c_heap, (unsigned long long)(c_ns / BENCH_ROUNDS),
+           (unsigned)sizeof(q), (unsigned long long)(cpp_ns / BENCH_ROUNDS));
+}
+
+/* Report memory and push/pop cost of the typed queue against queue_t */
+void test_cpp_queue_benchmark(void) {
+    bench_queue<uint32_t>("uint32_t");
+    bench_queue<sample_t>("sample_t");
+}
+
+extern "C" void run_cpp_tests(void) {
+    printf("\n=== Starting C++ Wrapper Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_cpp.cpp");
+    RUN_TEST(test_cpp_queue_fifo);
+    RUN_TEST(test_cpp_queue_blocking);
+    RUN_TEST(test_cpp_mempool);
+    RUN_TEST(test_cpp_mutex_guard);
+    RUN_TEST(test_cpp_static_task);
+    RUN_TEST(test_cpp_queue_benchmark);
+
+    printf("=== C++ Wrapper Tests Complete ===\n");
+}
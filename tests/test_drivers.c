@@ -1,18 +1,33 @@
 #include "mock_drivers.h"
+#include "clock_hal.h"
+#include "clock_sim.h"
 #include "exti_hal.h"
+#include "flash_hal.h"
+#include "flash_sim.h"
+#include "watchdog_hal.h"
+#include "test_common.h"
 
 /* Watchdog */
 int mock_watchdog_init_return = 0;
 uint32_t mock_watchdog_init_timeout_arg = 0;
 int mock_watchdog_kick_called = 0;
+static size_t mock_watchdog_last_kick = 0;
 
 int watchdog_hal_init(uint32_t timeout_ms) {
     mock_watchdog_init_timeout_arg = timeout_ms;
+    mock_watchdog_last_kick = mock_ticks;
     return mock_watchdog_init_return;
 }
 
 void watchdog_hal_kick(void) {
     mock_watchdog_kick_called++;
+    mock_watchdog_last_kick = mock_ticks;
+}
+
+/* Expires like the IWDG, on mock_ticks (1 ms) */
+int watchdog_hal_expired(void) {
+    return mock_watchdog_init_timeout_arg != 0U &&
+           mock_ticks - mock_watchdog_last_kick >= mock_watchdog_init_timeout_arg;
 }
 
 /* Systick */
@@ -55,6 +70,10 @@ int mock_uart_init_called = 0;
 int mock_uart_enable_rx_irq_arg = -1;
 int mock_uart_enable_tx_irq_arg = -1;
 uint8_t mock_uart_last_byte_written = 0;
+uint32_t mock_uart_config_baud = 0;
+uint8_t mock_uart_tx_busy = 0;
+uint32_t mock_uart_set_baud_arg = 0;
+uint32_t mock_uart_set_baud_clock = 0;
 
 void uart_hal_init(void *hal_handle, void *config_ptr, uint32_t clock_freq) {
     (void)hal_handle; (void)config_ptr; (void)clock_freq;
@@ -76,6 +95,22 @@ void uart_hal_write_byte(void *hal_handle, uint8_t byte) {
     mock_uart_last_byte_written = byte;
 }
 
+uint32_t uart_hal_config_baud(const void *config_ptr) {
+    (void)config_ptr;   /* Tests pass fake config pointers */
+    return mock_uart_config_baud;
+}
+
+uint8_t uart_hal_tx_busy(void *hal_handle) {
+    (void)hal_handle;
+    return mock_uart_tx_busy;
+}
+
+void uart_hal_set_baud(void *hal_handle, uint32_t baud, uint32_t clock_freq) {
+    (void)hal_handle;
+    mock_uart_set_baud_arg = baud;
+    mock_uart_set_baud_clock = clock_freq;
+}
+
 /* I2C */
 int mock_i2c_init_called = 0;
 int mock_i2c_transmit_return = 0;
@@ -84,6 +119,9 @@ int mock_i2c_start_called = 0;
 int mock_i2c_start_return = 0;
 int mock_i2c_stop_detected = 0;
 int mock_i2c_nack_detected = 0;
+uint32_t mock_i2c_config_speed = 0;
+uint32_t mock_i2c_set_clock_pclk = 0;
+uint32_t mock_i2c_set_clock_speed = 0;
 
 void i2c_hal_init(void *hal_handle, void *config_ptr) {
     (void)hal_handle; (void)config_ptr;
@@ -157,9 +195,24 @@ void i2c_hal_clear_config(void *hal_handle) {
     (void)hal_handle;
 }
 
+uint32_t i2c_hal_config_speed(const void *config_ptr) {
+    (void)config_ptr;
+    return mock_i2c_config_speed;
+}
+
+void i2c_hal_set_clock(void *hal_handle, uint32_t pclk_hz, uint32_t speed) {
+    (void)hal_handle;
+    mock_i2c_set_clock_pclk = pclk_hz;
+    mock_i2c_set_clock_speed = speed;
+}
+
 /* SPI */
 int mock_spi_init_called = 0;
 uint8_t mock_spi_transfer_return = 0;
+uint8_t mock_spi_busy = 0;
+uint32_t mock_spi_sck_hz = 0;
+uint32_t mock_spi_set_sck_pclk = 0;
+uint32_t mock_spi_set_sck_arg = 0;
 
 void spi_hal_init(void *hal_handle, void *config_ptr) {
     (void)hal_handle; (void)config_ptr;
@@ -181,6 +234,22 @@ void spi_hal_enable_tx_irq(void *hal_handle, uint8_t enable) {
     (void)enable;
 }
 
+uint8_t spi_hal_busy(void *hal_handle) {
+    (void)hal_handle;
+    return mock_spi_busy;
+}
+
+uint32_t spi_hal_get_sck_hz(void *hal_handle, uint32_t pclk) {
+    (void)hal_handle; (void)pclk;
+    return mock_spi_sck_hz;
+}
+
+void spi_hal_set_sck_hz(void *hal_handle, uint32_t pclk, uint32_t sck_hz) {
+    (void)hal_handle;
+    mock_spi_set_sck_pclk = pclk;
+    mock_spi_set_sck_arg = sck_hz;
+}
+
 /* ADC */
 int mock_adc_init_return = 0;
 int mock_adc_read_return = 0;
@@ -234,6 +303,9 @@ int mock_pwm_init_return = 0;
 uint8_t mock_pwm_last_duty = 0;
 int mock_pwm_start_called = 0;
 int mock_pwm_stop_called = 0;
+int32_t mock_pwm_calc_prescaler = 0;
+uint32_t mock_pwm_calc_pclk = 0;
+int32_t mock_pwm_set_prescaler = -1;
 
 int pwm_hal_init(void *hal_handle, uint8_t channel, uint32_t freq_hz) {
     (void)hal_handle; (void)channel; (void)freq_hz;
@@ -245,6 +317,12 @@ void pwm_hal_set_duty(void *hal_handle, uint8_t channel, uint8_t duty) {
 }
 void pwm_hal_start(void *hal_handle, uint8_t channel) { (void)hal_handle; (void)channel; mock_pwm_start_called++; }
 void pwm_hal_stop(void *hal_handle, uint8_t channel) { (void)hal_handle; (void)channel; mock_pwm_stop_called++; }
+int32_t pwm_hal_calc_prescaler(uint32_t pclk, uint32_t freq_hz) {
+    (void)freq_hz;
+    mock_pwm_calc_pclk = pclk;
+    return mock_pwm_calc_prescaler;
+}
+void pwm_hal_set_prescaler(void *hal_handle, uint32_t psc) { (void)hal_handle; mock_pwm_set_prescaler = (int32_t)psc; }
 
 /* RTC */
 int mock_rtc_init_return = 0;
@@ -265,27 +343,64 @@ uint32_t mock_flash_erase_addr = 0;
 int mock_flash_program_return = 0;
 uint32_t mock_flash_program_addr = 0;
 size_t mock_flash_program_len = 0;
+int mock_flash_use_sim = 0;
 
 void flash_hal_unlock(void) {
     mock_flash_unlock_called++;
+    if (mock_flash_use_sim) flash_sim_unlock();
 }
 
 void flash_hal_lock(void) {
     mock_flash_lock_called++;
+    if (mock_flash_use_sim) flash_sim_lock();
 }
 
 int flash_hal_erase_page(uint32_t page_addr) {
     mock_flash_erase_addr = page_addr;
+    if (mock_flash_use_sim) return flash_sim_erase_page(page_addr);
     return mock_flash_erase_return;
 }
 
 int flash_hal_program(uint32_t addr, const void *data, size_t len) {
-    (void)data;
     mock_flash_program_addr = addr;
     mock_flash_program_len = len;
+    if (mock_flash_use_sim) return flash_sim_program(addr, data, len);
     return mock_flash_program_return;
 }
 
+const void *flash_hal_map(uintptr_t addr) {
+    return flash_sim_map(addr);
+}
+
+/* Clock: always the register model */
+int clock_hal_set_vos(system_vos_t vos) {
+    return clock_sim_set_vos(vos);
+}
+
+int clock_hal_set_flash_latency(uint32_t ws) {
+    return clock_sim_set_flash_latency(ws);
+}
+
+int clock_hal_msi_enable(uint8_t range) {
+    return clock_sim_msi_enable(range);
+}
+
+int clock_hal_hsi16_enable(void) {
+    return clock_sim_hsi16_enable();
+}
+
+int clock_hal_pll_enable(const sysclock_opp_t *opp) {
+    return clock_sim_pll_enable(opp);
+}
+
+int clock_hal_osc_disable(sysclk_source_t src) {
+    return clock_sim_osc_disable(src);
+}
+
+int clock_hal_select(sysclk_source_t src) {
+    return clock_sim_select(src);
+}
+
 void mock_drivers_reset(void) {
     mock_watchdog_init_return = 0; mock_watchdog_init_timeout_arg = 0; mock_watchdog_kick_called = 0;
     mock_systick_init_return = 0; mock_systick_init_reload_arg = 0;
@@ -296,6 +411,10 @@ void mock_drivers_reset(void) {
     mock_uart_enable_rx_irq_arg = -1;
     mock_uart_enable_tx_irq_arg = -1;
     mock_uart_last_byte_written = 0;
+    mock_uart_config_baud = 0;
+    mock_uart_tx_busy = 0;
+    mock_uart_set_baud_arg = 0;
+    mock_uart_set_baud_clock = 0;
 
     mock_i2c_init_called = 0;
     mock_i2c_transmit_return = 0;
@@ -304,9 +423,16 @@ void mock_drivers_reset(void) {
     mock_i2c_start_return = 0;
     mock_i2c_stop_detected = 0;
     mock_i2c_nack_detected = 0;
+    mock_i2c_config_speed = 0;
+    mock_i2c_set_clock_pclk = 0;
+    mock_i2c_set_clock_speed = 0;
 
     mock_spi_init_called = 0;
     mock_spi_transfer_return = 0;
+    mock_spi_busy = 0;
+    mock_spi_sck_hz = 0;
+    mock_spi_set_sck_pclk = 0;
+    mock_spi_set_sck_arg = 0;
 
     mock_adc_init_return = 0;
     mock_adc_read_return = 0;
@@ -327,6 +453,9 @@ void mock_drivers_reset(void) {
     mock_pwm_last_duty = 0;
     mock_pwm_start_called = 0;
     mock_pwm_stop_called = 0;
+    mock_pwm_calc_prescaler = 0;
+    mock_pwm_calc_pclk = 0;
+    mock_pwm_set_prescaler = -1;
 
     mock_rtc_init_return = 0;
     /* Reset time/date structs */
@@ -340,6 +469,7 @@ void mock_drivers_reset(void) {
     mock_flash_program_return = 0;
     mock_flash_program_addr = 0;
     mock_flash_program_len = 0;
+    mock_flash_use_sim = 0;
 
     /* Reset others as needed */
 }
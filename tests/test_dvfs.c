@@ -0,0 +1,322 @@
+#include "unity.h"
+#include "dvfs.h"
+#include "system_clock.h"
+#include "clock_sim.h"
+#include "scheduler.h"
+#include "allocator.h"
+#include "platform.h"
+#include "uart.h"
+#include "spi.h"
+#include "i2c.h"
+#include "pwm.h"
+#include "mock_drivers.h"
+#include "test_common.h"
+#include <stdio.h>
+
+static uint8_t heap[4096];
+static uint64_t port_mem[64];       /* Room for any driver context */
+
+/* What the recording notifier saw */
+#define REC_MAX 16
+typedef struct {
+    dvfs_event_t event;
+    uint32_t old_hz;
+    uint32_t new_hz;
+    int who;
+} rec_entry_t;
+
+static rec_entry_t rec_log[REC_MAX];
+static int rec_count;
+static int rec_veto_who;            /* Notifier that refuses PRE_CHANGE, -1 for none */
+static int rec_ids[3] = { 0, 1, 2 };
+
+static int rec_notify(dvfs_event_t event, uint32_t old_hz, uint32_t new_hz, void *arg) {
+    int who = *(int *)arg;
+    if (rec_count < REC_MAX) {
+        rec_log[rec_count].event = event;
+        rec_log[rec_count].old_hz = old_hz;
+        rec_log[rec_count].new_hz = new_hz;
+        rec_log[rec_count].who = who;
+        rec_count++;
+    }
+    return (event == DVFS_PRE_CHANGE && who == rec_veto_who) ? -1 : 0;
+}
+
+static void assert_rec(int i, dvfs_event_t event, int who, uint32_t old_hz, uint32_t new_hz) {
+    TEST_ASSERT_TRUE(i < rec_count);
+    TEST_ASSERT_EQUAL(event, rec_log[i].event);
+    TEST_ASSERT_EQUAL(who, rec_log[i].who);
+    TEST_ASSERT_EQUAL_UINT32(old_hz, rec_log[i].old_hz);
+    TEST_ASSERT_EQUAL_UINT32(new_hz, rec_log[i].new_hz);
+}
+
+static void dvfs_test_task(void *arg) {
+    (void)arg;
+}
+
+/* Start the scheduler on a busy task or on idle, then take the load baseline */
+static void start_load(uint8_t busy) {
+    if (busy) {
+        task_create(dvfs_test_task, NULL, STACK_SIZE_512B, TASK_WEIGHT_NORMAL);
+    }
+    scheduler_start();
+    dvfs_reset();
+}
+
+/* Run the governor over n sample periods */
+static void run_samples(int n) {
+    for (int i = 0; i < n; i++) {
+        mock_ticks += DVFS_SAMPLE_TICKS;
+        dvfs_governor_sample();
+    }
+}
+
+/* Boot clock of the board: 80 MHz, no notifiers, governor off */
+static void setUp_local(void) {
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+    mock_drivers_reset();
+    mock_ticks = 1000;
+    clock_sim_reset();
+    system_clock_config_hz(SYSCLOCK_HZ_80MHZ);
+    mock_cpu_freq = get_system_clock_hz();
+    dvfs_reset();
+
+    rec_count = 0;
+    rec_veto_who = -1;
+}
+
+static void tearDown_local(void) {
+    dvfs_reset();
+    clock_sim_reset();
+    mock_cpu_freq = 1000000;
+    mock_ticks = 0;
+}
+
+/* Verify registration identifies (fn, arg) pairs and is bounded */
+void test_dvfs_notifier_register_limits(void) {
+    TEST_ASSERT_EQUAL(DVFS_ERR_PARAM, dvfs_notifier_register(NULL, NULL));
+    TEST_ASSERT_EQUAL(DVFS_ERR_PARAM, dvfs_notifier_unregister(rec_notify, &rec_ids[0]));
+
+    for (int i = 0; i < DVFS_MAX_NOTIFIERS; i++) {
+        TEST_ASSERT_EQUAL(DVFS_OK, dvfs_notifier_register(rec_notify, &port_mem[i]));
+    }
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_notifier_register(rec_notify, &port_mem[0]));
+    TEST_ASSERT_EQUAL(DVFS_ERR_FULL, dvfs_notifier_register(rec_notify, &rec_ids[0]));
+
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_notifier_unregister(rec_notify, &port_mem[3]));
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_notifier_register(rec_notify, &rec_ids[0]));
+}
+
+/* Verify every notifier is asked before the switch and told after it */
+void test_dvfs_set_hz_notifies_pre_then_post(void) {
+    dvfs_notifier_register(rec_notify, &rec_ids[0]);
+    dvfs_notifier_register(rec_notify, &rec_ids[1]);
+
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_set_hz(16000000UL));
+
+    TEST_ASSERT_EQUAL(4, rec_count);
+    assert_rec(0, DVFS_PRE_CHANGE, 0, 80000000UL, 16000000UL);
+    assert_rec(1, DVFS_PRE_CHANGE, 1, 80000000UL, 16000000UL);
+    assert_rec(2, DVFS_POST_CHANGE, 0, 80000000UL, 16000000UL);
+    assert_rec(3, DVFS_POST_CHANGE, 1, 80000000UL, 16000000UL);
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, dvfs_get_hz());
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, clock_sim_get_sysclk_hz());
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, platform_get_cpu_freq());
+
+    dvfs_stats_t stats;
+    dvfs_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.transitions);
+}
+
+/* Verify a refusal cancels the switch and releases those already asked */
+void test_dvfs_veto_aborts_change(void) {
+    dvfs_notifier_register(rec_notify, &rec_ids[0]);
+    dvfs_notifier_register(rec_notify, &rec_ids[1]);
+    dvfs_notifier_register(rec_notify, &rec_ids[2]);
+    rec_veto_who = 1;
+
+    TEST_ASSERT_EQUAL(DVFS_ERR_VETO, dvfs_set_hz(4000000UL));
+
+    TEST_ASSERT_EQUAL(3, rec_count);
+    assert_rec(0, DVFS_PRE_CHANGE, 0, 80000000UL, 4000000UL);
+    assert_rec(1, DVFS_PRE_CHANGE, 1, 80000000UL, 4000000UL);
+    assert_rec(2, DVFS_ABORT_CHANGE, 0, 80000000UL, 4000000UL);
+    TEST_ASSERT_EQUAL_UINT32(80000000UL, clock_sim_get_sysclk_hz());
+
+    dvfs_stats_t stats;
+    dvfs_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.vetoes);
+    TEST_ASSERT_EQUAL(0, stats.transitions);
+}
+
+/* Verify a failed switch reports the clock the core actually ended on */
+void test_dvfs_clock_failure_reports_actual_clock(void) {
+    dvfs_notifier_register(rec_notify, &rec_ids[0]);
+    clock_sim_inject_fault(CLOCK_SIM_FAULT_PLL_LOCK);
+
+    TEST_ASSERT_EQUAL(DVFS_ERR_CLOCK, dvfs_set_hz(48000000UL));
+
+    /* The PLL is retuned from HSI16, where the core is left */
+    TEST_ASSERT_EQUAL(2, rec_count);
+    assert_rec(1, DVFS_POST_CHANGE, 0, 80000000UL, 16000000UL);
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, dvfs_get_hz());
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, clock_sim_get_sysclk_hz());
+
+    dvfs_stats_t stats;
+    dvfs_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.failures);
+}
+
+/* Verify unknown or unchanged frequencies do not run the handshake */
+void test_dvfs_set_hz_noop_and_unsupported(void) {
+    dvfs_notifier_register(rec_notify, &rec_ids[0]);
+
+    TEST_ASSERT_EQUAL(DVFS_ERR_UNSUPPORTED, dvfs_set_hz(5000000UL));
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_set_hz(80000000UL));
+    TEST_ASSERT_EQUAL(0, rec_count);
+}
+
+/* Verify the governor picks the lowest clock that keeps the load under target */
+void test_dvfs_governor_select(void) {
+    TEST_ASSERT_EQUAL_UINT32(80000000UL, dvfs_governor_select(4000000UL, DVFS_UP_PCT));
+    TEST_ASSERT_EQUAL_UINT32(4000000UL, dvfs_governor_select(80000000UL, 0));
+    TEST_ASSERT_EQUAL_UINT32(48000000UL, dvfs_governor_select(80000000UL, 30));   /* 40 MHz needed */
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, dvfs_governor_select(4000000UL, 70));    /* 4.7 MHz needed */
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, dvfs_governor_select(16000000UL, DVFS_TARGET_PCT));
+}
+
+/* Verify an idle CPU is slowed down only after DVFS_DOWN_SAMPLES samples */
+void test_dvfs_governor_steps_down_with_hysteresis(void) {
+    start_load(0);
+    dvfs_governor_enable(1);
+
+    run_samples(DVFS_DOWN_SAMPLES - 1);
+    TEST_ASSERT_EQUAL_UINT32(80000000UL, dvfs_get_hz());
+
+    run_samples(1);
+    TEST_ASSERT_EQUAL_UINT32(4000000UL, dvfs_get_hz());
+
+    dvfs_stats_t stats;
+    dvfs_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.last_busy_pct);
+    TEST_ASSERT_EQUAL(DVFS_DOWN_SAMPLES, stats.samples);
+}
+
+/* Verify a busy CPU is sped up on the first sample */
+void test_dvfs_governor_steps_up_at_once(void) {
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_set_hz(4000000UL));
+    start_load(1);
+    dvfs_governor_enable(1);
+
+    run_samples(1);
+    TEST_ASSERT_EQUAL_UINT32(80000000UL, dvfs_get_hz());
+
+    dvfs_stats_t stats;
+    dvfs_get_stats(&stats);
+    TEST_ASSERT_EQUAL(100, stats.last_busy_pct);
+}
+
+/* Verify a disabled governor measures but holds the clock */
+void test_dvfs_governor_disabled_holds_clock(void) {
+    start_load(0);
+
+    run_samples(DVFS_DOWN_SAMPLES * 2);
+    TEST_ASSERT_EQUAL_UINT32(80000000UL, dvfs_get_hz());
+    TEST_ASSERT_FALSE(dvfs_governor_enabled());
+
+    dvfs_stats_t stats;
+    dvfs_get_stats(&stats);
+    TEST_ASSERT_EQUAL(DVFS_DOWN_SAMPLES * 2, stats.samples);
+}
+
+/* Verify the UART keeps its line rate and refuses while bytes are on the wire */
+void test_dvfs_uart_reprograms_baud(void) {
+    uint8_t rx_buf[8];
+    uint8_t tx_buf[8];
+    mock_uart_config_baud = 115200;
+    TEST_ASSERT_TRUE(uart_get_context_size() <= sizeof(port_mem));
+    TEST_ASSERT_NOT_NULL(uart_init(port_mem, (void *)0x1000, rx_buf, sizeof(rx_buf),
+                                   tx_buf, sizeof(tx_buf), (void *)0x2000, 80000000UL));
+
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_set_hz(16000000UL));
+    TEST_ASSERT_EQUAL_UINT32(115200, mock_uart_set_baud_arg);
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, mock_uart_set_baud_clock);
+
+    mock_uart_tx_busy = 1;
+    TEST_ASSERT_EQUAL(DVFS_ERR_VETO, dvfs_set_hz(80000000UL));
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, mock_uart_set_baud_clock);
+}
+
+/* Verify SPI keeps its SCK ceiling and refuses mid-transfer */
+void test_dvfs_spi_keeps_sck(void) {
+    mock_spi_sck_hz = 10000000UL;
+    TEST_ASSERT_TRUE(spi_get_context_size() <= sizeof(port_mem));
+    TEST_ASSERT_NOT_NULL(spi_init(port_mem, (void *)0x3000, (void *)0x4000));
+
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_set_hz(24000000UL));
+    TEST_ASSERT_EQUAL_UINT32(24000000UL, mock_spi_set_sck_pclk);
+    TEST_ASSERT_EQUAL_UINT32(10000000UL, mock_spi_set_sck_arg);
+
+    mock_spi_busy = 1;
+    TEST_ASSERT_EQUAL(DVFS_ERR_VETO, dvfs_set_hz(4000000UL));
+    TEST_ASSERT_EQUAL_UINT32(24000000UL, dvfs_get_hz());
+}
+
+/* Verify I2C retimes its bus and refuses during a transfer */
+void test_dvfs_i2c_retimes_bus(void) {
+    static const uint8_t data[1] = { 0xA5 };
+    mock_i2c_config_speed = 400000;
+    TEST_ASSERT_TRUE(i2c_get_context_size() <= sizeof(port_mem));
+    i2c_port_t port = i2c_init(port_mem, (void *)0x5000, (void *)0x6000);
+    TEST_ASSERT_NOT_NULL(port);
+
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_set_hz(32000000UL));
+    TEST_ASSERT_EQUAL_UINT32(32000000UL, mock_i2c_set_clock_pclk);
+    TEST_ASSERT_EQUAL_UINT32(400000, mock_i2c_set_clock_speed);
+
+    TEST_ASSERT_EQUAL(0, i2c_master_transmit_async(port, 0x50, data, sizeof(data), NULL, NULL));
+    TEST_ASSERT_EQUAL(DVFS_ERR_VETO, dvfs_set_hz(80000000UL));
+}
+
+/* Verify PWM keeps its frequency and refuses clocks its prescaler cannot reach */
+void test_dvfs_pwm_rescales_prescaler(void) {
+    pwm_port_t port = pwm_create((void *)0x7000, 1, 1000, 50);
+    TEST_ASSERT_NOT_NULL(port);
+
+    mock_pwm_calc_prescaler = 159;
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_set_hz(16000000UL));
+    TEST_ASSERT_EQUAL_UINT32(16000000UL, mock_pwm_calc_pclk);
+    TEST_ASSERT_EQUAL(159, mock_pwm_set_prescaler);
+
+    mock_pwm_calc_prescaler = -1;
+    mock_pwm_set_prescaler = -1;
+    TEST_ASSERT_EQUAL(DVFS_ERR_VETO, dvfs_set_hz(4000000UL));
+    TEST_ASSERT_EQUAL(-1, mock_pwm_set_prescaler);
+
+    pwm_destroy(port);
+    TEST_ASSERT_EQUAL(DVFS_OK, dvfs_set_hz(4000000UL));
+}
+
+void run_dvfs_tests(void) {
+    printf("\n=== Starting DVFS Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_dvfs.c");
+    RUN_TEST(test_dvfs_notifier_register_limits);
+    RUN_TEST(test_dvfs_set_hz_notifies_pre_then_post);
+    RUN_TEST(test_dvfs_veto_aborts_change);
+    RUN_TEST(test_dvfs_clock_failure_reports_actual_clock);
+    RUN_TEST(test_dvfs_set_hz_noop_and_unsupported);
+    RUN_TEST(test_dvfs_governor_select);
+    RUN_TEST(test_dvfs_governor_steps_down_with_hysteresis);
+    RUN_TEST(test_dvfs_governor_steps_up_at_once);
+    RUN_TEST(test_dvfs_governor_disabled_holds_clock);
+    RUN_TEST(test_dvfs_uart_reprograms_baud);
+    RUN_TEST(test_dvfs_spi_keeps_sck);
+    RUN_TEST(test_dvfs_i2c_retimes_bus);
+    RUN_TEST(test_dvfs_pwm_rescales_prescaler);
+
+    printf("=== DVFS Tests Complete ===\n");
+}
@@ -1,8 +1,11 @@
 #include "unity.h"
 #include "flash.h"
 #include "mock_drivers.h"
+#include "flash_sim.h"
+#include "platform_config.h"
 #include "test_common.h"
 #include <stdio.h>
+#include <unistd.h>
 
 /* Include driver source directly as it is missing from the build configuration */
 #include "../drivers/src/flash.c"
@@ -12,6 +15,17 @@ static void setUp_local(void) {
 }
 
 static void tearDown_local(void) {
+    flash_sim_close();
+    mock_flash_use_sim = 0;
+}
+
+#define SIM_PAGE    (FLASH_MEM_BASE + 0x10000U)
+
+/* Route the HAL to the simulator with a clean array */
+static void use_sim(void) {
+    mock_flash_use_sim = 1;
+    flash_sim_reset();
+    flash_unlock();
 }
 
 void test_flash_unlock_should_CallHal(void) {
@@ -73,6 +87,103 @@ void test_flash_read_should_Copy_WhenAddressFits(void) {
     TEST_ASSERT_EQUAL_UINT8_ARRAY(src, dst, sizeof(dst));
 }
 
+void test_flash_sim_should_EnforceProgramRules(void) {
+    uint64_t data = 0x1122334455667788ULL;
+    uint64_t out = 0;
+    use_sim();
+
+    TEST_ASSERT_EQUAL(0, flash_program(SIM_PAGE, &data, sizeof(data)));
+    TEST_ASSERT_EQUAL(0, flash_read(SIM_PAGE, &out, sizeof(out)));
+    TEST_ASSERT_TRUE(out == data);
+
+    /* Reprogramming without an erase, misalignment and partial units are refused */
+    TEST_ASSERT_EQUAL(-1, flash_program(SIM_PAGE, &data, sizeof(data)));
+    TEST_ASSERT_EQUAL(-1, flash_program(SIM_PAGE + 12U, &data, sizeof(data)));
+    TEST_ASSERT_EQUAL(-1, flash_program(SIM_PAGE + 8U, &data, 4));
+    TEST_ASSERT_EQUAL(-1, flash_erase_page(SIM_PAGE + 8U));
+
+    flash_lock();
+    TEST_ASSERT_EQUAL(-1, flash_erase_page(SIM_PAGE));
+    flash_unlock();
+    TEST_ASSERT_EQUAL(0, flash_erase_page(SIM_PAGE));
+    TEST_ASSERT_EQUAL(0, flash_read(SIM_PAGE, &out, sizeof(out)));
+    TEST_ASSERT_TRUE(out == 0xFFFFFFFFFFFFFFFFULL);
+}
+
+void test_flash_sim_should_ModelTimingAndWear(void) {
+    uint64_t data[4] = {1, 2, 3, 4};
+    flash_sim_stats_t st;
+    use_sim();
+
+    TEST_ASSERT_EQUAL(0, flash_erase_page(SIM_PAGE));
+    TEST_ASSERT_EQUAL(0, flash_erase_page(SIM_PAGE));
+    TEST_ASSERT_EQUAL(0, flash_program(SIM_PAGE, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(-1, flash_program(SIM_PAGE, data, sizeof(data)));
+
+    flash_sim_get_stats(&st);
+    TEST_ASSERT_EQUAL_UINT32(2, st.erases);
+    TEST_ASSERT_EQUAL_UINT32(4, st.programs);
+    TEST_ASSERT_EQUAL_UINT32(1, st.rejected);
+    TEST_ASSERT_TRUE(st.busy_us == 2ULL * FLASH_SIM_ERASE_US + 4ULL * FLASH_SIM_PROGRAM_US);
+    TEST_ASSERT_EQUAL_UINT32(2, flash_sim_erase_count(SIM_PAGE + 100U));
+    TEST_ASSERT_EQUAL_UINT32(0, flash_sim_erase_count(SIM_PAGE + FLASH_PAGE_SIZE));
+}
+
+void test_flash_sim_should_TearErase_AtTimedPowerCut(void) {
+    uint8_t page[FLASH_PAGE_SIZE];
+    uint64_t zero = 0;
+    use_sim();
+
+    for (uint32_t off = 0; off < FLASH_PAGE_SIZE; off += 8U) {
+        TEST_ASSERT_EQUAL(0, flash_program(SIM_PAGE + off, &zero, sizeof(zero)));
+    }
+
+    /* Cut a quarter of the way through the erase */
+    flash_sim_inject_fault_at(FLASH_SIM_ERASE_US / 4U);
+    TEST_ASSERT_EQUAL(-1, flash_erase_page(SIM_PAGE));
+    TEST_ASSERT_TRUE(flash_sim_power_lost());
+    TEST_ASSERT_EQUAL(-1, flash_program(SIM_PAGE, &zero, sizeof(zero)));
+
+    flash_read(SIM_PAGE, page, sizeof(page));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, page[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, page[FLASH_PAGE_SIZE / 4U - 1U]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, page[FLASH_PAGE_SIZE / 4U]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, page[FLASH_PAGE_SIZE - 1U]);
+
+    flash_sim_power_cycle();
+    flash_unlock();
+    TEST_ASSERT_EQUAL(0, flash_erase_page(SIM_PAGE));
+    TEST_ASSERT_EQUAL_UINT32(2, flash_sim_erase_count(SIM_PAGE));
+}
+
+void test_flash_sim_should_Persist_InImageFile(void) {
+    char path[64];
+    uint64_t data = 0xCAFEF00DDEADBEEFULL;
+    uint64_t out = 0;
+    snprintf(path, sizeof(path), "/tmp/sortos_flash_%d.img", (int)getpid());
+    unlink(path);
+
+    mock_flash_use_sim = 1;
+    TEST_ASSERT_EQUAL(0, flash_sim_open(path));
+    flash_unlock();
+    TEST_ASSERT_EQUAL(0, flash_read(SIM_PAGE, &out, sizeof(out)));
+    TEST_ASSERT_TRUE(out == 0xFFFFFFFFFFFFFFFFULL);
+    TEST_ASSERT_EQUAL(0, flash_erase_page(SIM_PAGE));
+    TEST_ASSERT_EQUAL(0, flash_program(SIM_PAGE, &data, sizeof(data)));
+    flash_sim_close();
+
+    /* Back on the RAM array the data is gone */
+    TEST_ASSERT_EQUAL(0, flash_read(SIM_PAGE, &out, sizeof(out)));
+    TEST_ASSERT_TRUE(out == 0xFFFFFFFFFFFFFFFFULL);
+
+    TEST_ASSERT_EQUAL(0, flash_sim_open(path));
+    TEST_ASSERT_EQUAL(0, flash_read(SIM_PAGE, &out, sizeof(out)));
+    TEST_ASSERT_TRUE(out == data);
+    TEST_ASSERT_EQUAL_UINT32(1, flash_sim_erase_count(SIM_PAGE));
+    flash_sim_close();
+    unlink(path);
+}
+
 void run_flash_tests(void) {
     printf("\n=== Starting Flash Tests ===\n");
 
@@ -86,6 +197,10 @@ void run_flash_tests(void) {
     RUN_TEST(test_flash_program_should_Fail_OnInvalidArgs);
     RUN_TEST(test_flash_read_should_Fail_OnInvalidArgs);
     RUN_TEST(test_flash_read_should_Copy_WhenAddressFits);
+    RUN_TEST(test_flash_sim_should_EnforceProgramRules);
+    RUN_TEST(test_flash_sim_should_ModelTimingAndWear);
+    RUN_TEST(test_flash_sim_should_TearErase_AtTimedPowerCut);
+    RUN_TEST(test_flash_sim_should_Persist_InImageFile);
 
     printf("=== Flash Tests Complete ===\n");
 }
@@ -0,0 +1,336 @@
+#include "unity.h"
+#include "ipc.h"
+#include "queue.h"
+#include "scheduler.h"
+#include "allocator.h"
+#include "test_common.h"
+#include "arch_ops.h"
+#include "platform.h"
+#include <setjmp.h>
+#include <stdio.h>
+#include <time.h>
+
+static uint8_t heap[8192];
+static task_t *t1;
+static task_t *t2;
+static task_t *t3;
+
+static void dummy_task(void *arg) {
+    (void)arg;
+}
+
+/* Three tasks: T1 client, T2 server, T3 bystander */
+static void setUp_local(void) {
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+    ipc_init();
+
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    scheduler_start();
+
+    t1 = scheduler_get_task_by_index(0);
+    t2 = scheduler_get_task_by_index(1);
+    t3 = scheduler_get_task_by_index(2);
+    mock_yield_count = 0;
+}
+
+static void tearDown_local(void) {
+    arch_native_irq_pending = NULL;
+}
+
+/* Tick taken as ipc_lock drops: preempts the running task, whatever its state */
+static void tick_preempts(void) {
+    platform_yield();
+}
+
+/* Run the server until it blocks in ipc_receive() */
+static void server_wait(ipc_msg_t *req) {
+    task_set_current(t2);
+    if (setjmp(yield_jump) == 0) {
+        ipc_receive(req);
+        TEST_FAIL_MESSAGE("ipc_receive should have blocked");
+    }
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t2));
+}
+
+/* Verify a call to a waiting server copies the request and switches straight to it */
+void test_ipc_call_hands_off_to_waiting_server(void) {
+    ipc_msg_t req = {{0}}, srv_req = {{0}}, rep = {{0}};
+
+    /* T2 has run for a while, so T3 would win a plain heap pick */
+    task_set_current(t2);
+    schedule_next_task();
+    server_wait(&srv_req);
+
+    task_set_weight(t1, TASK_WEIGHT_HIGH);
+    task_set_current(t1);
+    req.w[0] = 0x1234;
+    req.w[IPC_MSG_WORDS - 1] = 0xBEEF;
+    if (setjmp(yield_jump) == 0) {
+        ipc_call(t2, &req, &rep);
+        TEST_FAIL_MESSAGE("ipc_call should have blocked");
+    }
+
+    TEST_ASSERT_EQUAL_HEX32(0x1234, srv_req.w[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xBEEF, srv_req.w[IPC_MSG_WORDS - 1]);
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t1));
+    TEST_ASSERT_EQUAL(TASK_WEIGHT_HIGH, task_get_weight(t2));   /* Weight lent */
+
+    schedule_next_task();
+    TEST_ASSERT_EQUAL_PTR(t2, task_get_current());
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t3));
+
+    /* T2 resumes in its receive loop */
+    TEST_ASSERT_EQUAL_PTR(t1, ipc_receive(&srv_req));
+}
+
+/* Verify reply-and-wait delivers the reply and switches straight back */
+void test_ipc_reply_wait_returns_to_caller(void) {
+    ipc_msg_t req = {{0}}, srv_req = {{0}}, srv_rep = {{0}}, rep = {{0}};
+
+    server_wait(&srv_req);
+    task_set_weight(t1, TASK_WEIGHT_HIGH);
+    task_set_current(t1);
+    req.w[0] = 41;
+    if (setjmp(yield_jump) == 0) {
+        ipc_call(t2, &req, &rep);
+    }
+    schedule_next_task();
+    task_t *caller = ipc_receive(&srv_req);
+
+    srv_rep.w[0] = srv_req.w[0] + 1U;
+    if (setjmp(yield_jump) == 0) {
+        ipc_reply_wait(caller, &srv_rep, &srv_req);
+        TEST_FAIL_MESSAGE("ipc_reply_wait should have blocked");
+    }
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t2));
+    TEST_ASSERT_EQUAL(TASK_WEIGHT_NORMAL, task_get_weight(t2));  /* Loan returned */
+    TEST_ASSERT_EQUAL_UINT32(42, rep.w[0]);
+
+    schedule_next_task();
+    TEST_ASSERT_EQUAL_PTR(t1, task_get_current());
+    TEST_ASSERT_EQUAL(0, ipc_call(t2, &req, &rep));     /* T1 resumes and returns */
+    TEST_ASSERT_EQUAL_UINT32(42, rep.w[0]);
+}
+
+/* Verify a tick landing right after ipc_call() unlocks cannot strand the server */
+void test_ipc_call_tick_after_unlock_wakes_server(void) {
+    ipc_msg_t req = {{7}}, srv_req = {{0}}, rep = {{0}};
+
+    server_wait(&srv_req);
+    task_set_current(t1);
+    arch_native_irq_pending = tick_preempts;
+    if (setjmp(yield_jump) == 0) {
+        ipc_call(t2, &req, &rep);
+        TEST_FAIL_MESSAGE("ipc_call should have been preempted");
+    }
+
+    TEST_ASSERT_NULL(arch_native_irq_pending);     /* The tick was taken */
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t1));
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t2));
+    TEST_ASSERT_EQUAL_UINT32(7, srv_req.w[0]);
+
+    schedule_next_task();
+    TEST_ASSERT_EQUAL_PTR(t2, task_get_current());
+    TEST_ASSERT_EQUAL_PTR(t1, ipc_receive(&srv_req));
+}
+
+/* Verify a tick landing right after ipc_reply_wait() unlocks cannot strand the caller */
+void test_ipc_reply_wait_tick_after_unlock_wakes_caller(void) {
+    ipc_msg_t req = {{0}}, srv_req = {{0}}, srv_rep = {{9}}, rep = {{0}};
+
+    server_wait(&srv_req);
+    task_set_current(t1);
+    if (setjmp(yield_jump) == 0) {
+        ipc_call(t2, &req, &rep);
+    }
+    schedule_next_task();
+    task_t *caller = ipc_receive(&srv_req);
+
+    arch_native_irq_pending = tick_preempts;
+    if (setjmp(yield_jump) == 0) {
+        ipc_reply_wait(caller, &srv_rep, &srv_req);
+        TEST_FAIL_MESSAGE("ipc_reply_wait should have been preempted");
+    }
+
+    TEST_ASSERT_NULL(arch_native_irq_pending);
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t2));
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t1));
+    TEST_ASSERT_EQUAL_UINT32(9, rep.w[0]);
+
+    schedule_next_task();
+    TEST_ASSERT_EQUAL_PTR(t1, task_get_current());
+    TEST_ASSERT_EQUAL(0, ipc_call(t2, &req, &rep));
+}
+
+/* Verify a reply hands back the weight the server had before the call, not its base */
+void test_ipc_reply_keeps_mutex_boost(void) {
+    ipc_msg_t req = {{0}}, srv_req = {{0}}, srv_rep = {{0}}, rep = {{0}};
+
+    task_boost_weight(t2, TASK_WEIGHT_HIGH);    /* Server holds a PI mutex */
+    server_wait(&srv_req);
+    task_set_weight(t1, 2 * TASK_WEIGHT_HIGH);
+    task_set_current(t1);
+    if (setjmp(yield_jump) == 0) {
+        ipc_call(t2, &req, &rep);
+    }
+    TEST_ASSERT_EQUAL(2 * TASK_WEIGHT_HIGH, task_get_weight(t2));
+
+    schedule_next_task();
+    TEST_ASSERT_EQUAL_PTR(t1, ipc_receive(&srv_req));
+    TEST_ASSERT_EQUAL(0, ipc_reply(t1, &srv_rep));
+    TEST_ASSERT_EQUAL(TASK_WEIGHT_HIGH, task_get_weight(t2));   /* PI boost kept */
+
+    task_restore_base_weight(t2);               /* Mutex released */
+    TEST_ASSERT_EQUAL(TASK_WEIGHT_NORMAL, task_get_weight(t2));
+}
+
+/* Verify callers queue in FIFO order while the server is busy */
+void test_ipc_callers_queue_when_server_busy(void) {
+    ipc_msg_t req1 = {{1}}, req3 = {{3}}, rep1 = {{0}}, rep3 = {{0}}, srv_req, srv_rep;
+
+    task_set_current(t1);
+    if (setjmp(yield_jump) == 0) {
+        ipc_call(t2, &req1, &rep1);
+    }
+    task_set_current(t3);
+    if (setjmp(yield_jump) == 0) {
+        ipc_call(t2, &req3, &rep3);
+    }
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t1));
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t3));
+
+    /* Server picks requests up without blocking */
+    task_set_current(t2);
+    TEST_ASSERT_EQUAL_PTR(t1, ipc_receive(&srv_req));
+    TEST_ASSERT_EQUAL_UINT32(1, srv_req.w[0]);
+    srv_rep.w[0] = 10;
+    TEST_ASSERT_EQUAL_PTR(t3, ipc_reply_wait(t1, &srv_rep, &srv_req));
+    TEST_ASSERT_EQUAL_UINT32(3, srv_req.w[0]);
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t1));
+    TEST_ASSERT_EQUAL_UINT32(10, rep1.w[0]);
+
+    srv_rep.w[0] = 30;
+    TEST_ASSERT_EQUAL(0, ipc_reply(t3, &srv_rep));
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t3));
+    TEST_ASSERT_EQUAL_UINT32(30, rep3.w[0]);
+    TEST_ASSERT_EQUAL(2, mock_yield_count);     /* Only the two callers blocked */
+}
+
+/* Verify misuse is rejected */
+void test_ipc_invalid_arguments(void) {
+    ipc_msg_t msg = {{0}};
+
+    task_set_current(t1);
+    TEST_ASSERT_EQUAL(-1, ipc_call(t1, &msg, &msg));
+    TEST_ASSERT_EQUAL(-1, ipc_call(NULL, &msg, &msg));
+    TEST_ASSERT_EQUAL(-1, ipc_call(t2, NULL, &msg));
+    TEST_ASSERT_EQUAL(-1, ipc_reply(t3, &msg));     /* T3 is not calling T1 */
+    TEST_ASSERT_NULL(ipc_receive(NULL));
+
+    task_delete(task_get_id(t2));
+    TEST_ASSERT_EQUAL(-1, ipc_call(t2, &msg, &msg));
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+}
+
+/* ##### Round-trip benchmark: IPC vs a request/reply queue pair ##### */
+
+#define BENCH_ROUND_TRIPS   100000
+
+static uint64_t bench_elapsed_ns(const struct timespec *t0) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - t0->tv_sec) * 1000000000ULL +
+           (uint64_t)(now.tv_nsec - t0->tv_nsec);
+}
+
+/* Kernel path of one client -> server -> client round trip; the register
+ * context switch itself is not modelled on the host */
+void test_ipc_round_trip_benchmark(void) {
+    ipc_msg_t req = {{0}}, rep = {{0}}, srv_req, srv_rep = {{0}};
+    struct timespec t0;
+
+    task_block(t3);
+
+    /* IPC: server parked in receive */
+    server_wait(&srv_req);
+    task_set_current(t1);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < BENCH_ROUND_TRIPS; i++) {
+        req.w[0] = i;
+        if (setjmp(yield_jump) == 0) {
+            ipc_call(t2, &req, &rep);
+        }
+        schedule_next_task();
+        task_t *caller = ipc_receive(&srv_req);
+        srv_rep.w[0] = srv_req.w[0] + 1U;
+        if (setjmp(yield_jump) == 0) {
+            ipc_reply_wait(caller, &srv_rep, &srv_req);
+        }
+        schedule_next_task();
+        ipc_call(t2, &req, &rep);
+    }
+    uint64_t ipc_ns = bench_elapsed_ns(&t0);
+    TEST_ASSERT_EQUAL_UINT32(BENCH_ROUND_TRIPS, rep.w[0]);
+    TEST_ASSERT_EQUAL_PTR(t1, task_get_current());
+
+    /* Queues: one for requests, one for replies */
+    queue_t *req_q = queue_create(sizeof(ipc_msg_t), 1);
+    queue_t *rep_q = queue_create(sizeof(ipc_msg_t), 1);
+    TEST_ASSERT_NOT_NULL(req_q);
+    TEST_ASSERT_NOT_NULL(rep_q);
+
+    task_set_current(t2);
+    if (setjmp(yield_jump) == 0) {
+        queue_pop(req_q, &srv_req);
+    }
+    task_set_current(t1);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < BENCH_ROUND_TRIPS; i++) {
+        req.w[0] = i;
+        queue_push(req_q, &req);
+        if (setjmp(yield_jump) == 0) {
+            queue_pop(rep_q, &rep);
+        }
+        schedule_next_task();
+        queue_pop(req_q, &srv_req);
+        srv_rep.w[0] = srv_req.w[0] + 1U;
+        queue_push(rep_q, &srv_rep);
+        if (setjmp(yield_jump) == 0) {
+            queue_pop(req_q, &srv_req);
+        }
+        schedule_next_task();
+        queue_pop(rep_q, &rep);
+    }
+    uint64_t queue_ns = bench_elapsed_ns(&t0);
+    TEST_ASSERT_EQUAL_UINT32(BENCH_ROUND_TRIPS, rep.w[0]);
+    TEST_ASSERT_EQUAL_PTR(t1, task_get_current());
+
+    printf("Round trip, %u-word message: ipc %llu ns, queue pair %llu ns\n",
+           (unsigned)IPC_MSG_WORDS,
+           (unsigned long long)(ipc_ns / BENCH_ROUND_TRIPS),
+           (unsigned long long)(queue_ns / BENCH_ROUND_TRIPS));
+
+    queue_delete(req_q);
+    queue_delete(rep_q);
+}
+
+void run_ipc_tests(void) {
+    printf("\n=== Starting IPC Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_ipc.c");
+    RUN_TEST(test_ipc_call_hands_off_to_waiting_server);
+    RUN_TEST(test_ipc_reply_wait_returns_to_caller);
+    RUN_TEST(test_ipc_call_tick_after_unlock_wakes_server);
+    RUN_TEST(test_ipc_reply_wait_tick_after_unlock_wakes_caller);
+    RUN_TEST(test_ipc_reply_keeps_mutex_boost);
+    RUN_TEST(test_ipc_callers_queue_when_server_busy);
+    RUN_TEST(test_ipc_invalid_arguments);
+    RUN_TEST(test_ipc_round_trip_benchmark);
+
+    printf("=== IPC Tests Complete ===\n");
+}
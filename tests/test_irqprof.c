@@ -0,0 +1,181 @@
+#include "unity.h"
+#include "irqprof.h"
+#include "spinlock.h"
+#include "queue.h"
+#include "allocator.h"
+#include "scheduler.h"
+#include "cli.h"
+#include "test_common.h"
+#include <string.h>
+#include <stdio.h>
+
+#if IRQPROF_ENABLE
+static uint8_t heap[8192];
+static spinlock_t outer_lock;
+static spinlock_t inner_lock;
+
+static void dummy_task(void *arg) {
+    (void)arg;
+}
+
+static void setUp_local(void) {
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+    task_create(dummy_task, NULL, 512, 1);
+    task_set_current(scheduler_get_task_by_index(0));
+    spinlock_init(&outer_lock);
+    spinlock_init(&inner_lock);
+    irqprof_reset();
+}
+
+static void tearDown_local(void) {
+    mock_cycles_step = 0;
+}
+
+/* Find a record by name and kind */
+static const irqprof_site_t *find_site(const char *name, uint32_t kind) {
+    for (uint32_t i = 0; i < irqprof_count(); i++) {
+        const irqprof_site_t *s = irqprof_get(i);
+        if (s->kind == kind && strcmp(s->name, name) == 0) {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static void profiled_section(void) {
+    uint32_t flags = spin_lock(&outer_lock);
+    spin_unlock(&outer_lock, flags);
+}
+
+static void nested_inner(void) {
+    uint32_t flags = spin_lock(&inner_lock);
+    spin_unlock(&inner_lock, flags);
+}
+
+static void nested_outer(void) {
+    uint32_t flags = spin_lock(&outer_lock);
+    nested_inner();
+    spin_unlock(&outer_lock, flags);
+}
+
+static void profiled_isr(void) {
+    IRQPROF_ISR_ENTER("TestISR");
+    mock_cycles_step = 300;
+    IRQPROF_ISR_EXIT();
+}
+
+/* Verify a masked section is charged to its call site */
+void test_irqprof_times_lock_site(void) {
+    mock_cycles_step = 100;
+    profiled_section();
+    mock_cycles_step = 1000;
+    profiled_section();
+
+    const irqprof_site_t *s = find_site("profiled_section", IRQPROF_KIND_LOCK);
+    TEST_ASSERT_NOT_NULL(s);
+    TEST_ASSERT_EQUAL_UINT32(2, s->count);
+    TEST_ASSERT_EQUAL_UINT32(1000, s->max);
+    TEST_ASSERT_TRUE(s->total == 1100U);
+    TEST_ASSERT_EQUAL_UINT32(1, s->hist[0]);    /* 100 < 128 */
+    TEST_ASSERT_EQUAL_UINT32(1, s->hist[3]);    /* 512 <= 1000 < 1024 */
+    TEST_ASSERT_NOT_NULL(strstr(s->file, "test_irqprof.c"));
+}
+
+/* Verify nested locks are charged to the outermost site only */
+void test_irqprof_nested_charges_outer(void) {
+    mock_cycles_step = 10;
+    nested_outer();
+
+    const irqprof_site_t *outer = find_site("nested_outer", IRQPROF_KIND_LOCK);
+    const irqprof_site_t *inner = find_site("nested_inner", IRQPROF_KIND_LOCK);
+    TEST_ASSERT_NOT_NULL(outer);
+    TEST_ASSERT_NOT_NULL(inner);
+    TEST_ASSERT_EQUAL_UINT32(1, outer->count);
+    /* Three steps: the inner lock's two SPINLOCK_STATS reads fall inside the outer window */
+    TEST_ASSERT_EQUAL_UINT32(30, outer->max);
+    TEST_ASSERT_EQUAL_UINT32(0, inner->count);
+}
+
+/* Verify ISR time and tick latency records */
+void test_irqprof_isr_and_latency(void) {
+    mock_cycles_step = 1;
+    profiled_isr();
+    irqprof_tick_latency(100000);
+
+    const irqprof_site_t *isr = find_site("TestISR", IRQPROF_KIND_ISR);
+    TEST_ASSERT_NOT_NULL(isr);
+    TEST_ASSERT_EQUAL_UINT32(1, isr->count);
+    TEST_ASSERT_EQUAL_UINT32(300, isr->max);
+
+    const irqprof_site_t *lat = find_site("tick latency", IRQPROF_KIND_LATENCY);
+    TEST_ASSERT_NOT_NULL(lat);
+    TEST_ASSERT_EQUAL_UINT32(100000, lat->max);
+    TEST_ASSERT_EQUAL_UINT32(1, lat->hist[IRQPROF_HIST_BUCKETS - 1U]);  /* Clamped to last bucket */
+
+    irqprof_reset();
+    TEST_ASSERT_EQUAL_UINT32(0, isr->count);
+    TEST_ASSERT_EQUAL_UINT32(0, lat->max);
+}
+
+/* Verify the report lists the worst site first */
+void test_irqprof_cli_report(void) {
+    queue_t *rx_q = queue_create(1, 64);
+    queue_t *tx_q = queue_create(1, 2048);
+    char out[2048];
+    size_t n = 0;
+    char c;
+
+    cli_init("T> ", NULL, NULL);
+    cli_set_rx_queue(rx_q);
+    cli_set_tx_queue(tx_q);
+    irqprof_init();
+
+    mock_cycles_step = 1;
+    profiled_isr();
+    mock_cycles_step = 100000;
+    profiled_section();
+    mock_cycles_step = 0;
+
+    for (const char *s = "irqprof\r"; *s; s++) {
+        queue_push_from_isr(rx_q, s);
+    }
+    if (setjmp(yield_jump) == 0) {
+        cli_task_entry(NULL);
+    }
+
+    while (n < sizeof(out) - 1 && queue_pop_from_isr(tx_q, &c) == 0) {
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    TEST_ASSERT_NOT_NULL(strstr(out, "TestISR"));
+
+    /* Nothing else comes close to a 100000-cycle section, so it is the first row */
+    char *row = strstr(out, "Site\r\n");
+    TEST_ASSERT_NOT_NULL(row);
+    row += 6;
+    *strstr(row, "\r\n") = '\0';
+    TEST_ASSERT_NOT_NULL(strstr(row, "100000"));
+    TEST_ASSERT_NOT_NULL(strstr(row, "profiled_section (test_irqprof.c:"));
+
+    queue_delete(rx_q);
+    queue_delete(tx_q);
+}
+
+#endif
+
+void run_irqprof_tests(void) {
+    printf("\n=== Starting IRQ Profiler Tests ===\n");
+
+#if IRQPROF_ENABLE
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_irqprof.c");
+    RUN_TEST(test_irqprof_times_lock_site);
+    RUN_TEST(test_irqprof_nested_charges_outer);
+    RUN_TEST(test_irqprof_isr_and_latency);
+    RUN_TEST(test_irqprof_cli_report);
+#endif
+
+    printf("=== IRQ Profiler Tests Complete ===\n");
+}
@@ -0,0 +1,178 @@
+#include "unity.h"
+#include "kobj.h"
+#include "scheduler.h"
+#include "queue.h"
+#include "mempool.h"
+#include "event_group.h"
+#include "timer.h"
+#include "allocator.h"
+#include "test_common.h"
+#include <stdio.h>
+
+static uint8_t heap[8192];
+static int kobj_task_runs;
+
+static void kobj_test_task(void *arg) {
+    (void)arg;
+    kobj_task_runs++;
+}
+
+static void kobj_test_timer_cb(void *arg) {
+    (void)arg;
+}
+
+TASK_DEFINE(kobj_test_worker, kobj_test_task, NULL, STACK_SIZE_1KB, TASK_WEIGHT_HIGH);
+QUEUE_DEFINE(kobj_test_queue, sizeof(uint32_t), 4);
+QUEUE_DEFINE_PRIO(kobj_test_prio_queue, sizeof(uint32_t), 2, 3);
+MEMPOOL_DEFINE(kobj_test_pool, 24, 3);
+EVENT_GROUP_DEFINE(kobj_test_events);
+TIMER_DEFINE(kobj_test_timer, 50, 1, kobj_test_timer_cb, NULL);
+
+static void setUp_local(void) {
+    kobj_task_runs = 0;
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+}
+
+static void tearDown_local(void) {
+}
+
+/* Verify boot-time setup of every defined object takes nothing from the heap */
+void test_kobj_init_allocates_nothing(void) {
+    size_t before = allocator_get_free_size();
+
+    TEST_ASSERT_EQUAL(0, kobj_init_static());
+    TEST_ASSERT_EQUAL_UINT32(before, allocator_get_free_size());
+    TEST_ASSERT_EQUAL(0, kobj_task_runs);
+}
+
+/* Verify a defined task is started with its weight and its ID recorded */
+void test_kobj_task_started(void) {
+    TEST_ASSERT_EQUAL(0, kobj_init_static());
+    TEST_ASSERT_TRUE(kobj_test_worker.id > 0);
+
+    task_t *t = scheduler_get_task_by_index(0);
+    TEST_ASSERT_NOT_NULL(t);
+    TEST_ASSERT_EQUAL(kobj_test_worker.id, task_get_id(t));
+    TEST_ASSERT_EQUAL(TASK_WEIGHT_HIGH, task_get_weight(t));
+}
+
+/* Verify defined queues work like created ones, lanes included */
+void test_kobj_queue_usable(void) {
+    uint32_t in = 0xA5A5A5A5u;
+    uint32_t out = 0;
+
+    TEST_ASSERT_EQUAL(0, kobj_init_static());
+    scheduler_start();                          /* Blocking push needs a current task */
+    TEST_ASSERT_EQUAL(0, queue_push(kobj_test_queue, &in));
+    TEST_ASSERT_EQUAL(0, queue_pop(kobj_test_queue, &out));
+    TEST_ASSERT_EQUAL_HEX32(in, out);
+
+    uint32_t low = 1, high = 2;
+    TEST_ASSERT_EQUAL(0, queue_push_prio(kobj_test_prio_queue, &low, 0));
+    TEST_ASSERT_EQUAL(0, queue_push_prio(kobj_test_prio_queue, &high, 2));
+    TEST_ASSERT_EQUAL(0, queue_pop(kobj_test_prio_queue, &out));
+    TEST_ASSERT_EQUAL_UINT32(high, out);
+}
+
+/* Verify a defined pool holds exactly its count and survives delete */
+void test_kobj_pool_count(void) {
+    void *items[3];
+
+    TEST_ASSERT_EQUAL(0, kobj_init_static());
+    for (int i = 0; i < 3; i++) {
+        items[i] = mempool_alloc(kobj_test_pool);
+        TEST_ASSERT_NOT_NULL(items[i]);
+        TEST_ASSERT_FALSE(allocator_is_heap_pointer(items[i]));
+    }
+    TEST_ASSERT_NULL(mempool_alloc(kobj_test_pool));
+
+    size_t before = allocator_get_free_size();
+    mempool_delete(kobj_test_pool);
+    TEST_ASSERT_EQUAL_UINT32(before, allocator_get_free_size());
+}
+
+/* Verify event groups and timers are initialised in place */
+void test_kobj_events_and_timer(void) {
+    TEST_ASSERT_EQUAL(0, kobj_init_static());
+
+    TEST_ASSERT_EQUAL_HEX32(0, event_group_get_bits(kobj_test_events));
+    event_group_set_bits(kobj_test_events, 0x5);
+    TEST_ASSERT_EQUAL_HEX32(0x5, event_group_get_bits(kobj_test_events));
+    event_group_delete(kobj_test_events);
+
+    TEST_ASSERT_EQUAL_STRING("kobj_test_timer", timer_get_name(kobj_test_timer));
+    TEST_ASSERT_EQUAL_UINT32(50, timer_get_period(kobj_test_timer));
+    TEST_ASSERT_FALSE(timer_is_active(kobj_test_timer));
+}
+
+/* Verify a plain queue_t holds a one-lane queue, and extra lanes use caller storage */
+void test_kobj_queue_init_static_in_place(void) {
+    static struct {
+        queue_t q;
+        uint32_t canary;                        /* Catches a write past the control block */
+    } cb = { .canary = 0xC0FFEEu };
+    static queue_t prio_q;
+    static queue_lane_t prio_lanes[2];
+    static uint32_t buf[4];
+    static uint32_t prio_buf[2 * 2];
+    uint32_t in = 7, out = 0;
+
+    scheduler_start();
+    TEST_ASSERT_EQUAL(0, queue_init_static(&cb.q, buf, sizeof(uint32_t), 4));
+    TEST_ASSERT_EQUAL_HEX32(0xC0FFEEu, cb.canary);
+    TEST_ASSERT_EQUAL(0, queue_push(&cb.q, &in));
+    TEST_ASSERT_EQUAL(0, queue_pop(&cb.q, &out));
+    TEST_ASSERT_EQUAL_UINT32(7, out);
+    TEST_ASSERT_EQUAL_HEX32(0xC0FFEEu, cb.canary);
+
+    /* More than one lane needs a lane array */
+    TEST_ASSERT_NOT_EQUAL(0, queue_init_static_prio(&prio_q, NULL, prio_buf, sizeof(uint32_t), 2, 2));
+    TEST_ASSERT_EQUAL(0, queue_init_static_prio(&prio_q, prio_lanes, prio_buf, sizeof(uint32_t), 2, 2));
+    TEST_ASSERT_EQUAL(0, queue_push_prio(&prio_q, &in, 1));
+    TEST_ASSERT_EQUAL(0, queue_pop(&prio_q, &out));
+    TEST_ASSERT_EQUAL_UINT32(7, out);
+}
+
+/* Verify the init_static APIs reject bad arguments */
+void test_kobj_init_static_rejects_invalid(void) {
+    static queue_t q;
+    static mempool_t pool;
+    static uint32_t buf[16];
+
+    TEST_ASSERT_NOT_EQUAL(0, queue_init_static(NULL, buf, 4, 4));
+    TEST_ASSERT_NOT_EQUAL(0, queue_init_static(&q, NULL, 4, 4));
+    TEST_ASSERT_NOT_EQUAL(0, queue_init_static(&q, buf, 0, 4));
+    TEST_ASSERT_NOT_EQUAL(0, mempool_init_static(&pool, (uint8_t *)buf + 1, 8, 2));
+    TEST_ASSERT_NOT_EQUAL(0, timer_init_static(NULL, "t", 1, 0, kobj_test_timer_cb, NULL));
+}
+
+/* Verify the link-time budget covers every defined object */
+void test_kobj_static_bytes(void) {
+    size_t expected = STACK_SIZE_1KB
+                    + sizeof(queue_t) + 4 * 4
+                    + sizeof(queue_t) + 3 * sizeof(queue_lane_t) + 4 * 2 * 3
+                    + sizeof(mempool_t) + MEMPOOL_ITEM_SIZE(24) * 3
+                    + sizeof(event_group_t)
+                    + sizeof(sw_timer_t);
+
+    TEST_ASSERT_EQUAL_UINT32(expected, kobj_static_bytes());
+}
+
+void run_kobj_tests(void) {
+    printf("\n=== Starting Kobj Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_kobj.c");
+    RUN_TEST(test_kobj_init_allocates_nothing);
+    RUN_TEST(test_kobj_task_started);
+    RUN_TEST(test_kobj_queue_usable);
+    RUN_TEST(test_kobj_pool_count);
+    RUN_TEST(test_kobj_events_and_timer);
+    RUN_TEST(test_kobj_queue_init_static_in_place);
+    RUN_TEST(test_kobj_init_static_rejects_invalid);
+    RUN_TEST(test_kobj_static_bytes);
+
+    printf("=== Kobj Tests Complete ===\n");
+}
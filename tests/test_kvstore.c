@@ -0,0 +1,258 @@
+#include "unity.h"
+#include "kvstore.h"
+#include "allocator.h"
+#include "scheduler.h"
+#include "mock_drivers.h"
+#include "flash_sim.h"
+#include "platform_config.h"
+#include "test_common.h"
+#include <string.h>
+#include <stdio.h>
+
+#define KV_TEST_BASE    (FLASH_MEM_BASE + 0x40000U)
+
+static uint8_t heap[16384];
+static kvstore_t *kv;
+
+static void setUp_local(void) {
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+    mock_drivers_reset();
+    mock_flash_use_sim = 1;
+    flash_sim_reset();
+    kv = kvstore_create(KV_TEST_BASE, 4);
+}
+
+static void tearDown_local(void) {
+    kvstore_destroy(kv);
+    kv = NULL;
+    mock_flash_use_sim = 0;
+}
+
+/* Drop RAM state and mount again from flash, as after a reset */
+static kvstore_t *remount(kvstore_t *old, uint32_t pages) {
+    kvstore_destroy(old);
+    return kvstore_create(KV_TEST_BASE, pages);
+}
+
+/* Verify a value can be stored and read back */
+void test_kvstore_set_get(void) {
+    char out[16] = {0};
+    TEST_ASSERT_NOT_NULL(kv);
+    TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "name", "soRTOS", 7));
+    TEST_ASSERT_EQUAL(7, kvstore_get(kv, "name", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("soRTOS", out);
+    TEST_ASSERT_EQUAL(KV_ERR_NOT_FOUND, kvstore_get(kv, "missing", out, sizeof(out)));
+}
+
+/* Verify the latest write wins and a short buffer still reports the full length */
+void test_kvstore_overwrite_returns_latest(void) {
+    uint32_t val = 0;
+    for (uint32_t i = 1; i <= 20; i++) {
+        TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "count", &i, sizeof(i)));
+    }
+    TEST_ASSERT_EQUAL(4, kvstore_get(kv, "count", &val, sizeof(val)));
+    TEST_ASSERT_EQUAL_UINT32(20, val);
+
+    uint8_t one = 0;
+    TEST_ASSERT_EQUAL(4, kvstore_get(kv, "count", &one, 1));
+    TEST_ASSERT_EQUAL_UINT8(20, one);
+}
+
+/* Verify delete removes a key, also after remount */
+void test_kvstore_delete(void) {
+    uint8_t out[4];
+    TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "a", "1", 1));
+    TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "b", "2", 1));
+    TEST_ASSERT_EQUAL(KV_OK, kvstore_delete(kv, "a"));
+    TEST_ASSERT_EQUAL(KV_ERR_NOT_FOUND, kvstore_get(kv, "a", out, sizeof(out)));
+    TEST_ASSERT_EQUAL(KV_ERR_NOT_FOUND, kvstore_delete(kv, "a"));
+
+    kv = remount(kv, 4);
+    TEST_ASSERT_EQUAL(KV_ERR_NOT_FOUND, kvstore_get(kv, "a", out, sizeof(out)));
+    TEST_ASSERT_EQUAL(1, kvstore_get(kv, "b", out, sizeof(out)));
+}
+
+/* Verify contents survive a remount */
+void test_kvstore_persists_across_remount(void) {
+    char key[8];
+    uint32_t val;
+    for (uint32_t i = 0; i < 10; i++) {
+        snprintf(key, sizeof(key), "k%u", (unsigned)i);
+        val = i * 100U;
+        TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, key, &val, sizeof(val)));
+    }
+
+    kv = remount(kv, 4);
+    TEST_ASSERT_NOT_NULL(kv);
+    for (uint32_t i = 0; i < 10; i++) {
+        snprintf(key, sizeof(key), "k%u", (unsigned)i);
+        TEST_ASSERT_EQUAL(4, kvstore_get(kv, key, &val, sizeof(val)));
+        TEST_ASSERT_EQUAL_UINT32(i * 100U, val);
+    }
+}
+
+/* Verify oversized keys/values and bad arguments are rejected */
+void test_kvstore_rejects_invalid(void) {
+    char long_key[KVSTORE_KEY_MAX_LEN + 2];
+    static uint8_t big[KVSTORE_VALUE_MAX_LEN + 1];
+    memset(long_key, 'x', sizeof(long_key) - 1);
+    long_key[sizeof(long_key) - 1] = '\0';
+
+    TEST_ASSERT_EQUAL(KV_ERR_TOO_LARGE, kvstore_set(kv, long_key, "v", 1));
+    TEST_ASSERT_EQUAL(KV_ERR_TOO_LARGE, kvstore_set(kv, "k", big, sizeof(big)));
+    TEST_ASSERT_EQUAL(KV_ERR_INVALID, kvstore_set(kv, "", "v", 1));
+    TEST_ASSERT_EQUAL(KV_ERR_INVALID, kvstore_set(kv, "k", NULL, 1));
+    TEST_ASSERT_NULL(kvstore_create(KV_TEST_BASE + 8U, 4));
+    TEST_ASSERT_NULL(kvstore_create(KV_TEST_BASE, 1));
+}
+
+/* Verify writing an unchanged value does not touch flash */
+void test_kvstore_identical_write_skipped(void) {
+    kvstore_stats_t stats;
+    TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "mode", "auto", 4));
+    uint32_t last_addr = mock_flash_program_addr;
+
+    TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "mode", "auto", 4));
+    TEST_ASSERT_EQUAL_HEX32(last_addr, mock_flash_program_addr);
+    kvstore_get_stats(kv, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.writes_skipped);
+}
+
+/* Verify compaction reclaims space and spreads erases evenly */
+void test_kvstore_gc_levels_wear(void) {
+    uint8_t val[200];
+    uint8_t out[200];
+    kvstore_stats_t stats;
+
+    memset(val, 0xC5, sizeof(val));
+    TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "cold", val, sizeof(val)));
+
+    for (uint32_t i = 0; i < 400; i++) {
+        memset(val, (int)(i & 0x7F), sizeof(val));
+        TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "hot", val, sizeof(val)));
+        if ((i % 16U) == 0U) {
+            TEST_ASSERT_TRUE(kvstore_gc_step(kv) >= 0);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(200, kvstore_get(kv, "hot", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8(399 & 0x7F, out[0]);
+    TEST_ASSERT_EQUAL(200, kvstore_get(kv, "cold", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8(0xC5, out[199]);
+
+    kvstore_get_stats(kv, &stats);
+    TEST_ASSERT_TRUE(stats.gc_runs > 0);
+    TEST_ASSERT_TRUE(stats.erase_max - stats.erase_min <= 1);
+    TEST_ASSERT_TRUE(stats.pages_free >= 1);
+}
+
+/* Verify a torn record leaves the previous value in place after remount */
+void test_kvstore_torn_set_keeps_old_value(void) {
+    char out[32] = {0};
+    TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "cfg", "old", 4));
+
+    /* First double-word lands, the second is torn */
+    flash_sim_inject_fault(1);
+    TEST_ASSERT_EQUAL(KV_ERR_FLASH, kvstore_set(kv, "cfg", "new-value-123", 14));
+    TEST_ASSERT_TRUE(flash_sim_power_lost());
+    flash_sim_power_cycle();
+
+    kv = remount(kv, 4);
+    TEST_ASSERT_NOT_NULL(kv);
+    TEST_ASSERT_EQUAL(4, kvstore_get(kv, "cfg", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("old", out);
+
+    /* Store stays writable after recovery */
+    TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "cfg", "new", 4));
+    kv = remount(kv, 4);
+    TEST_ASSERT_EQUAL(4, kvstore_get(kv, "cfg", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("new", out);
+}
+
+/* Cut power at every point of a write/compaction sequence and check consistency */
+void test_kvstore_power_cut_sweep(void) {
+    uint8_t val[200];
+    uint8_t out[200];
+
+    kvstore_destroy(kv);
+    kv = kvstore_create(KV_TEST_BASE, 3);
+    TEST_ASSERT_NOT_NULL(kv);
+
+    for (uint32_t cut = 0; cut < 1200; cut += 5) {
+        TEST_ASSERT_EQUAL(KV_OK, kvstore_format(kv));
+        memset(val, 0xB0, sizeof(val));
+        TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "b", val, sizeof(val)));
+        memset(val, 0xC0, sizeof(val));
+        TEST_ASSERT_EQUAL(KV_OK, kvstore_set(kv, "c", val, sizeof(val)));
+
+        flash_sim_inject_fault(cut);
+        uint32_t committed = 0;
+        for (uint32_t i = 1; i <= 40; i++) {
+            memset(val, (int)i, sizeof(val));
+            if (kvstore_set(kv, "a", val, sizeof(val)) != KV_OK) {
+                break;
+            }
+            committed = i;
+        }
+        flash_sim_power_cycle();
+
+        kv = remount(kv, 3);
+        TEST_ASSERT_NOT_NULL(kv);
+        TEST_ASSERT_EQUAL(200, kvstore_get(kv, "b", out, sizeof(out)));
+        TEST_ASSERT_EQUAL_UINT8(0xB0, out[199]);
+        TEST_ASSERT_EQUAL(200, kvstore_get(kv, "c", out, sizeof(out)));
+        TEST_ASSERT_EQUAL_UINT8(0xC0, out[0]);
+        if (committed > 0U) {
+            TEST_ASSERT_EQUAL(200, kvstore_get(kv, "a", out, sizeof(out)));
+            TEST_ASSERT_TRUE(out[0] == committed || out[0] == committed + 1U);
+            TEST_ASSERT_EQUAL_UINT8(out[0], out[199]);
+        }
+    }
+}
+
+/* Verify the store refuses writes once live data fills the range */
+void test_kvstore_reports_no_space(void) {
+    uint8_t val[KVSTORE_VALUE_MAX_LEN];
+    char key[12];                   /* "n" + up to 10 digits + NUL */
+    int res = KV_OK;
+    uint32_t stored = 0;
+
+    memset(val, 0x5A, sizeof(val));
+    for (uint32_t i = 0; i < KVSTORE_MAX_KEYS && res == KV_OK; i++) {
+        snprintf(key, sizeof(key), "n%u", (unsigned)i);
+        res = kvstore_set(kv, key, val, sizeof(val));
+        if (res == KV_OK) {
+            stored++;
+        }
+    }
+    TEST_ASSERT_EQUAL(KV_ERR_NO_SPACE, res);
+    TEST_ASSERT_TRUE(stored > 0);
+
+    /* Everything accepted before the limit is still readable after remount */
+    kv = remount(kv, 4);
+    for (uint32_t i = 0; i < stored; i++) {
+        snprintf(key, sizeof(key), "n%u", (unsigned)i);
+        TEST_ASSERT_EQUAL(KVSTORE_VALUE_MAX_LEN, kvstore_get(kv, key, NULL, 0));
+    }
+}
+
+void run_kvstore_tests(void) {
+    printf("\n=== Starting KV Store Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_kvstore.c");
+    RUN_TEST(test_kvstore_set_get);
+    RUN_TEST(test_kvstore_overwrite_returns_latest);
+    RUN_TEST(test_kvstore_delete);
+    RUN_TEST(test_kvstore_persists_across_remount);
+    RUN_TEST(test_kvstore_rejects_invalid);
+    RUN_TEST(test_kvstore_identical_write_skipped);
+    RUN_TEST(test_kvstore_gc_levels_wear);
+    RUN_TEST(test_kvstore_torn_set_keeps_old_value);
+    RUN_TEST(test_kvstore_power_cut_sweep);
+    RUN_TEST(test_kvstore_reports_no_space);
+
+    printf("=== KV Store Tests Complete ===\n");
+}
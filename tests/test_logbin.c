@@ -0,0 +1,247 @@
+#include "unity.h"
+#include "logbin.h"
+#include "allocator.h"
+#include "scheduler.h"
+#include "platform.h"
+#include "test_common.h"
+#include <string.h>
+#include <stdio.h>
+
+static uint8_t heap[8192];
+
+/* Captured sink output */
+static uint8_t out_buf[16384];
+static uint32_t out_len;
+
+/* Decoded frame */
+typedef struct {
+    uint32_t id_plus1;
+    uint32_t ts;
+    uint32_t sig;
+    uint64_t args[LOGBIN_MAX_ARGS];
+    char str[LOGBIN_MAX_ARGS][LOGBIN_STR_MAX + 1];
+} frame_t;
+
+static int mem_sink(void *ctx, const uint8_t *data, size_t len) {
+    (void)ctx;
+    if (out_len + len > sizeof(out_buf)) {
+        return -1;
+    }
+    memcpy(&out_buf[out_len], data, len);
+    out_len += (uint32_t)len;
+    return 0;
+}
+
+static void setUp_local(void) {
+    mock_ticks = 0;
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+    logbin_init();
+    out_len = 0;
+}
+
+static void tearDown_local(void) {
+}
+
+static uint64_t get_varint(const uint8_t *p, uint32_t *pos) {
+    uint64_t v = 0;
+    uint32_t shift = 0;
+    while (p[*pos] & 0x80U) {
+        v |= (uint64_t)(p[(*pos)++] & 0x7FU) << shift;
+        shift += 7;
+    }
+    v |= (uint64_t)p[(*pos)++] << shift;
+    return v;
+}
+
+/* COBS-decode the frame starting at *pos, returns decoded length */
+static uint32_t next_frame(uint32_t *pos, uint8_t *dec) {
+    uint32_t n = 0;
+    while (*pos < out_len && out_buf[*pos] != 0U) {
+        uint8_t code = out_buf[(*pos)++];
+        for (uint8_t i = 1; i < code; i++) {
+            dec[n++] = out_buf[(*pos)++];
+        }
+        if (code != 0xFFU && out_buf[*pos] != 0U) {
+            dec[n++] = 0;
+        }
+    }
+    (*pos)++;   /* Delimiter */
+    return n;
+}
+
+/* Parse a decoded record frame */
+static void parse(const uint8_t *dec, frame_t *f) {
+    uint32_t pos = 0;
+    memset(f, 0, sizeof(*f));
+    f->id_plus1 = (uint32_t)get_varint(dec, &pos);
+    if (f->id_plus1 == 0U) {
+        f->sig = (uint32_t)get_varint(dec, &pos);       /* Control kind */
+        f->args[0] = get_varint(dec, &pos);
+        return;
+    }
+    f->ts = (uint32_t)get_varint(dec, &pos);
+    f->sig = (uint32_t)get_varint(dec, &pos);
+    for (uint32_t i = 0; i < (f->sig & 0xFU); i++) {
+        uint32_t tag = (f->sig >> (4U + 3U * i)) & 7U;
+        if (tag == LOGBIN_T_STR) {
+            uint32_t len = (uint32_t)get_varint(dec, &pos);
+            memcpy(f->str[i], &dec[pos], len);
+            pos += len;
+        } else if (tag == LOGBIN_T_F64) {
+            memcpy(&f->args[i], &dec[pos], 8);
+            pos += 8;
+        } else {
+            uint64_t v = get_varint(dec, &pos);
+            if (tag == LOGBIN_T_I32 || tag == LOGBIN_T_I64) {
+                v = (v >> 1) ^ (uint64_t)-(int64_t)(v & 1U);
+            }
+            f->args[i] = v;
+        }
+    }
+}
+
+static const char *fmt_of(const frame_t *f) {
+    return &__start_logbin_fmt[f->id_plus1 - 1U];
+}
+
+/* Verify a record carries the format ID, timestamp and typed args */
+void test_logbin_encodes_record(void) {
+    uint8_t dec[512];
+    frame_t f;
+    uint32_t pos = 0;
+
+    mock_ticks = 4321;
+    LOGBIN("val %d %u", -5, 7U);
+    TEST_ASSERT_TRUE(logbin_drain(mem_sink, NULL) > 0);
+
+    next_frame(&pos, dec);
+    parse(dec, &f);
+    TEST_ASSERT_EQUAL_STRING("val %d %u", fmt_of(&f));
+    TEST_ASSERT_EQUAL_UINT32(4321, f.ts);
+    TEST_ASSERT_EQUAL(2, f.sig & 0xFU);
+    TEST_ASSERT_EQUAL(-5, (int32_t)f.args[0]);
+    TEST_ASSERT_EQUAL(7, f.args[1]);
+    TEST_ASSERT_EQUAL(out_len, pos);
+}
+
+/* Verify 64-bit, floating point, string and pointer arguments */
+void test_logbin_typed_args(void) {
+    uint8_t dec[512];
+    frame_t f;
+    uint32_t pos = 0;
+    double d;
+    const char *name = "sensor";
+
+    LOGBIN("%llu %lld %f %s %p", 1ULL << 40, -3LL, 1.5, name, (void *)0x1234);
+    logbin_drain(mem_sink, NULL);
+    next_frame(&pos, dec);
+    parse(dec, &f);
+
+    TEST_ASSERT_EQUAL_STRING("%llu %lld %f %s %p", fmt_of(&f));
+    TEST_ASSERT_TRUE(f.args[0] == (1ULL << 40));
+    TEST_ASSERT_TRUE((int64_t)f.args[1] == -3);
+    memcpy(&d, &f.args[2], sizeof(d));
+    TEST_ASSERT_TRUE(d == 1.5);
+    TEST_ASSERT_EQUAL_STRING("sensor", f.str[3]);
+    TEST_ASSERT_TRUE(f.args[4] == 0x1234U);
+}
+
+/* Verify strings are copied at log time and capped */
+void test_logbin_string_copied_and_capped(void) {
+    uint8_t dec[512];
+    frame_t f;
+    uint32_t pos = 0;
+    char buf[LOGBIN_STR_MAX + 16];
+
+    memset(buf, 'a', sizeof(buf) - 1U);
+    buf[sizeof(buf) - 1U] = '\0';
+    LOGBIN("%s", buf);
+    buf[0] = 'z';           /* Later changes are not seen */
+    LOGBIN("no args");
+
+    logbin_drain(mem_sink, NULL);
+    next_frame(&pos, dec);
+    parse(dec, &f);
+    TEST_ASSERT_EQUAL(LOGBIN_STR_MAX, strlen(f.str[0]));
+    TEST_ASSERT_EQUAL('a', f.str[0][0]);
+
+    next_frame(&pos, dec);
+    parse(dec, &f);
+    TEST_ASSERT_EQUAL_STRING("no args", fmt_of(&f));
+    TEST_ASSERT_EQUAL(0, f.sig & 0xFU);
+}
+
+/* Verify a full ring drops and reports the count inline */
+void test_logbin_drops_reported(void) {
+    uint8_t dec[512];
+    frame_t f;
+    logbin_stats_t st;
+    uint32_t pos = 0;
+    uint32_t frames = 0;
+
+    for (uint32_t i = 0; i < 200; i++) {
+        LOGBIN("fill %u", i);
+    }
+    logbin_get_stats(&st);
+    TEST_ASSERT_TRUE(st.dropped > 0U);
+    TEST_ASSERT_EQUAL_UINT32(200, st.records + st.dropped);
+
+    logbin_drain(mem_sink, NULL);
+    while (pos < out_len) {
+        next_frame(&pos, dec);
+        parse(dec, &f);
+        frames++;
+    }
+    /* The last frame is the drop report */
+    TEST_ASSERT_EQUAL_UINT32(st.records + 1U, frames);
+    TEST_ASSERT_EQUAL(0, f.id_plus1);
+    TEST_ASSERT_EQUAL_UINT32(st.dropped, (uint32_t)f.args[0]);
+
+    /* Reported once only */
+    out_len = 0;
+    TEST_ASSERT_EQUAL(0, logbin_drain(mem_sink, NULL));
+}
+
+/* Verify records of mixed sizes survive many laps of the ring */
+void test_logbin_ring_wraps(void) {
+    uint8_t dec[512];
+    frame_t f;
+    uint32_t expect = 0;
+
+    for (uint32_t round = 0; round < 100; round++) {
+        out_len = 0;
+        LOGBIN("a %u", expect);
+        LOGBIN("b %u %s", expect + 1U, "padding-string");
+        LOGBIN("c %u %llu %llu", expect + 2U, 1ULL, 2ULL);
+        TEST_ASSERT_TRUE(logbin_drain(mem_sink, NULL) > 0);
+
+        uint32_t pos = 0;
+        for (uint32_t i = 0; i < 3U; i++) {
+            next_frame(&pos, dec);
+            parse(dec, &f);
+            TEST_ASSERT_EQUAL_UINT32(expect++, (uint32_t)f.args[0]);
+        }
+        TEST_ASSERT_EQUAL(out_len, pos);
+    }
+
+    logbin_stats_t st;
+    logbin_get_stats(&st);
+    TEST_ASSERT_EQUAL_UINT32(0, st.dropped);
+    TEST_ASSERT_EQUAL_UINT32(300, st.frames);
+}
+
+void run_logbin_tests(void) {
+    printf("\n=== Starting Binary Log Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_logbin.c");
+    RUN_TEST(test_logbin_encodes_record);
+    RUN_TEST(test_logbin_typed_args);
+    RUN_TEST(test_logbin_string_copied_and_capped);
+    RUN_TEST(test_logbin_drops_reported);
+    RUN_TEST(test_logbin_ring_wraps);
+
+    printf("=== Binary Log Tests Complete ===\n");
+}
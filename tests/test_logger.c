@@ -1,6 +1,5 @@
 #include "unity.h"
 #include "logger.h"
-#include "queue.h"
 #include "allocator.h"
 #include "scheduler.h"
 #include "platform.h"
@@ -17,11 +16,8 @@ static void setUp_local(void) {
     logger_init();
     
     /* Drain any logs generated during initialization (e.g. "Scheduler Init", "Task Create") */
-    queue_t *q = logger_get_queue();
-    if (q) {
-        log_entry_t dummy;
-        while(queue_pop_from_isr(q, &dummy) == 0);
-    }
+    log_entry_t dummy;
+    while (logger_pop(&dummy) == 0);
 }
 
 static void tearDown_local(void) {
@@ -31,54 +27,52 @@ static void tearDown_local(void) {
      */
 }
 
-void test_logger_init_creates_queue_and_task(void) {
-    queue_t *q = logger_get_queue();
-    TEST_ASSERT_NOT_NULL(q);
-    
+void test_logger_init_creates_ring_and_task(void) {
+    log_entry_t entry;
+    TEST_ASSERT_EQUAL(-1, logger_pop(&entry));
+    TEST_ASSERT_EQUAL_UINT32(0, logger_get_dropped());
+
     /* logger task should be first task here */
     task_t *t = scheduler_get_task_by_index(0);
     TEST_ASSERT_NOT_NULL(t);
 }
 
-void test_logger_log_pushes_to_queue(void) {
-    queue_t *q = logger_get_queue();
-    
+void test_logger_log_pushes_to_ring(void) {
     mock_ticks = 1234;
     const char *msg = "Test Message";
     
     logger_log(msg, 10, 20);
     
-    /* Verify queue has 1 item */
+    /* Verify ring has 1 item */
     log_entry_t entry;
-    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &entry));
+    TEST_ASSERT_EQUAL(0, logger_pop(&entry));
     
     TEST_ASSERT_EQUAL(1234, entry.timestamp);
     TEST_ASSERT_EQUAL_STRING(msg, entry.fmt);
     TEST_ASSERT_EQUAL(10, entry.arg1);
     TEST_ASSERT_EQUAL(20, entry.arg2);
+    TEST_ASSERT_EQUAL(LOG_MOD_APP, entry.module);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INFO, entry.level);
+    TEST_ASSERT_EQUAL(-1, logger_pop(&entry));
 }
 
 void test_logger_log_fifo_order(void) {
-    queue_t *q = logger_get_queue();
-    
     logger_log("First", 1, 1);
     logger_log("Second", 2, 2);
     
     log_entry_t entry;
     
     /* Pop First */
-    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &entry));
+    TEST_ASSERT_EQUAL(0, logger_pop(&entry));
     TEST_ASSERT_EQUAL_STRING("First", entry.fmt);
     
     /* Pop Second */
-    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &entry));
+    TEST_ASSERT_EQUAL(0, logger_pop(&entry));
     TEST_ASSERT_EQUAL_STRING("Second", entry.fmt);
 }
 
 void test_logger_log_drops_when_full_non_blocking(void) {
-    queue_t *q = logger_get_queue();
-    
-    /* Fill the queue */
+    /* Fill the ring */
     for (int i = 0; i < LOG_QUEUE_SIZE; i++) {
         logger_log("Fill", i, 0);
     }
@@ -88,14 +82,62 @@ void test_logger_log_drops_when_full_non_blocking(void) {
     
     /* 
      * Should not have crashed or blocked. 
-     * The queue should still contain the first LOG_QUEUE_SIZE items. 
-     * The "Overflow" item should be dropped. 
+     * The ring should still contain the first LOG_QUEUE_SIZE items. 
+     * The "Overflow" item should be dropped and counted. 
      */
+    TEST_ASSERT_EQUAL_UINT32(1, logger_get_dropped());
        
     log_entry_t entry;
-    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &entry));
+    TEST_ASSERT_EQUAL(0, logger_pop(&entry));
     TEST_ASSERT_EQUAL_STRING("Fill", entry.fmt);
     TEST_ASSERT_EQUAL(0, entry.arg1);
+
+    /* Freed slots are reused on the next lap */
+    logger_log("Again", 7, 0);
+    for (int i = 1; i < LOG_QUEUE_SIZE; i++) {
+        TEST_ASSERT_EQUAL(0, logger_pop(&entry));
+        TEST_ASSERT_EQUAL(i, entry.arg1);
+    }
+    TEST_ASSERT_EQUAL(0, logger_pop(&entry));
+    TEST_ASSERT_EQUAL_STRING("Again", entry.fmt);
+    TEST_ASSERT_EQUAL(-1, logger_pop(&entry));
+    TEST_ASSERT_EQUAL_UINT32(1, logger_get_dropped());
+}
+
+void test_logger_module_levels_filter(void) {
+    log_entry_t entry;
+
+    LOG_DBG(APP, "Debug", 1, 0);        /* Above the default ceiling: compiled out */
+    LOG_WRN(STORAGE, "Warn", 2, 0);
+    TEST_ASSERT_EQUAL(0, logger_pop(&entry));
+    TEST_ASSERT_EQUAL_STRING("Warn", entry.fmt);
+    TEST_ASSERT_EQUAL(LOG_MOD_STORAGE, entry.module);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARN, entry.level);
+
+    /* Runtime level mutes one module only */
+    TEST_ASSERT_EQUAL(0, logger_set_level(LOG_MOD_STORAGE, LOG_LEVEL_ERROR));
+    LOG_WRN(STORAGE, "Muted", 3, 0);
+    LOG_ERR(STORAGE, "Error", 4, 0);
+    LOG_WRN(DRIVER, "Other", 5, 0);
+    TEST_ASSERT_EQUAL(0, logger_pop(&entry));
+    TEST_ASSERT_EQUAL_STRING("Error", entry.fmt);
+    TEST_ASSERT_EQUAL(0, logger_pop(&entry));
+    TEST_ASSERT_EQUAL_STRING("Other", entry.fmt);
+    TEST_ASSERT_EQUAL(-1, logger_pop(&entry));
+
+    TEST_ASSERT_EQUAL(-1, logger_set_level(LOG_MOD_COUNT, LOG_LEVEL_INFO));
+    TEST_ASSERT_EQUAL(-1, logger_set_level(LOG_MOD_APP, LOG_LEVEL_DEBUG + 1));
+}
+
+void test_logger_bench(void) {
+    log_entry_t entry;
+    uint32_t task_ns = logger_bench(64, 0);
+    uint32_t isr_ns = logger_bench(64, 1);
+
+    printf("logger_write: %u ns/call (task), %u ns/call (IRQs masked)\n", task_ns, isr_ns);
+    TEST_ASSERT_TRUE(task_ns > 0U || isr_ns > 0U);
+    TEST_ASSERT_EQUAL(-1, logger_pop(&entry));
+    TEST_ASSERT_EQUAL_UINT32(0, logger_get_dropped());
 }
 
 void run_logger_tests(void) {
@@ -104,10 +146,12 @@ void run_logger_tests(void) {
     test_tearDown_hook = tearDown_local;
     UnitySetTestFile("tests/test_logger.c");
     
-    RUN_TEST(test_logger_init_creates_queue_and_task);
-    RUN_TEST(test_logger_log_pushes_to_queue);
+    RUN_TEST(test_logger_init_creates_ring_and_task);
+    RUN_TEST(test_logger_log_pushes_to_ring);
     RUN_TEST(test_logger_log_fifo_order);
     RUN_TEST(test_logger_log_drops_when_full_non_blocking);
+    RUN_TEST(test_logger_module_levels_filter);
+    RUN_TEST(test_logger_bench);
     
     printf("=== Logger Tests Complete ===\n");
 }
\ No newline at end of file
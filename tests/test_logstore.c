@@ -0,0 +1,262 @@
+#include "unity.h"
+#include "logstore.h"
+#include "allocator.h"
+#include "scheduler.h"
+#include "mock_drivers.h"
+#include "flash_sim.h"
+#include "platform_config.h"
+#include "test_common.h"
+#include <string.h>
+#include <stdio.h>
+
+#define LS_TEST_BASE    FLASH_STORAGE_BASE
+#define LS_TEST_PAGES   4U
+#define LS_MAX_SEEN     2048U
+
+static uint8_t heap[16384];
+static logstore_t *ls;
+
+/* Entries collected by the read callback */
+typedef struct {
+    uint32_t count;
+    uint32_t timestamp[LS_MAX_SEEN];
+    uintptr_t arg1[LS_MAX_SEEN];
+    uint16_t boot[LS_MAX_SEEN];
+    uint8_t level[LS_MAX_SEEN];
+    uint8_t module[LS_MAX_SEEN];
+    char fmt[8][32];
+} seen_t;
+
+static seen_t seen;
+
+static void collect(uint16_t boot, const log_entry_t *e, void *ctx) {
+    seen_t *s = (seen_t *)ctx;
+    if (s->count < LS_MAX_SEEN) {
+        s->timestamp[s->count] = e->timestamp;
+        s->arg1[s->count] = e->arg1;
+        s->boot[s->count] = boot;
+        s->level[s->count] = e->level;
+        s->module[s->count] = e->module;
+        if (s->count < 8U) {
+            strncpy(s->fmt[s->count], e->fmt, sizeof(s->fmt[0]) - 1U);
+        }
+    }
+    s->count++;
+}
+
+static void setUp_local(void) {
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+    mock_drivers_reset();
+    mock_flash_use_sim = 1;
+    flash_sim_reset();
+    memset(&seen, 0, sizeof(seen));
+    ls = logstore_create(LS_TEST_BASE, LS_TEST_PAGES);
+}
+
+static void tearDown_local(void) {
+    logstore_destroy(ls);
+    ls = NULL;
+    mock_flash_use_sim = 0;
+}
+
+static void append(const char *fmt, uint32_t ts, uintptr_t a1, uintptr_t a2) {
+    log_entry_t e = { .timestamp = ts, .module = LOG_MOD_STORAGE, .level = LOG_LEVEL_WARN,
+                      .fmt = fmt, .arg1 = a1, .arg2 = a2 };
+    TEST_ASSERT_EQUAL(0, logstore_append(ls, &e));
+}
+
+/* Drop RAM state and mount again from flash, as after a reset */
+static void remount(void) {
+    logstore_destroy(ls);
+    ls = logstore_create(LS_TEST_BASE, LS_TEST_PAGES);
+    TEST_ASSERT_NOT_NULL(ls);
+}
+
+static int capture(void *ctx, const uint8_t *data, size_t len) {
+    uint8_t *first = (uint8_t *)ctx;
+    if (first[0] == 0U && len >= 4U) {
+        memcpy(first, data, 4);
+    }
+    return 0;
+}
+
+static int abort_export(void *ctx, const uint8_t *data, size_t len) {
+    (void)ctx; (void)data; (void)len;
+    return 1;
+}
+
+/* Verify entries decode back to the same format, args and timestamps */
+void test_logstore_round_trip(void) {
+    TEST_ASSERT_NOT_NULL(ls);
+    append("Task %u started", 100, 1, 0);
+    append("Temp %d.%u C", 105, (uintptr_t)-3, 5);
+    append("Task %u started", 99, 2, 0);
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+
+    TEST_ASSERT_EQUAL(3, logstore_read(ls, collect, &seen));
+    TEST_ASSERT_EQUAL_STRING("Task %u started", seen.fmt[0]);
+    TEST_ASSERT_EQUAL_STRING("Temp %d.%u C", seen.fmt[1]);
+    TEST_ASSERT_EQUAL_STRING("Task %u started", seen.fmt[2]);
+    TEST_ASSERT_EQUAL_UINT32(100, seen.timestamp[0]);
+    TEST_ASSERT_EQUAL_UINT32(105, seen.timestamp[1]);
+    TEST_ASSERT_EQUAL_UINT32(99, seen.timestamp[2]);
+    TEST_ASSERT_TRUE(seen.arg1[1] == (uintptr_t)-3);
+    TEST_ASSERT_EQUAL(1, seen.boot[0]);
+    TEST_ASSERT_EQUAL(LOG_MOD_STORAGE, seen.module[2]);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARN, seen.level[2]);
+}
+
+/* Verify pending entries stay in RAM until flushed */
+void test_logstore_buffers_until_flush(void) {
+    append("pending", 1, 0, 0);
+    TEST_ASSERT_EQUAL(0, logstore_read(ls, NULL, NULL));
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+    TEST_ASSERT_EQUAL(1, logstore_read(ls, NULL, NULL));
+    /* Nothing pending is a no-op */
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+}
+
+/* Verify repeated formats and small deltas compress well below the RAM entry size */
+void test_logstore_compresses(void) {
+    logstore_stats_t st;
+    for (uint32_t i = 0; i < 200; i++) {
+        append((i & 1U) ? "ADC ch%u = %u" : "Tick %u", 1000U + i * 10U, i & 7U, i);
+    }
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+    TEST_ASSERT_EQUAL(0, logstore_get_stats(ls, &st));
+    TEST_ASSERT_EQUAL_UINT32(200, st.entries_written);
+    TEST_ASSERT_EQUAL_UINT32(0, st.entries_dropped);
+    TEST_ASSERT_TRUE(st.bytes_stored * 2U < st.bytes_raw);
+    TEST_ASSERT_EQUAL(200, logstore_read(ls, NULL, NULL));
+}
+
+/* Verify more distinct formats than the dictionary holds still decode */
+void test_logstore_dictionary_eviction(void) {
+    static char fmts[LOG_STORE_MAX_FORMATS + 8][8];
+    uint32_t n = LOG_STORE_MAX_FORMATS + 8U;
+
+    for (uint32_t round = 0; round < 2; round++) {
+        for (uint32_t i = 0; i < n; i++) {
+            snprintf(fmts[i], sizeof(fmts[i]), "f%02u", (unsigned)i);
+            append(fmts[i], round * 100U + i, i, 0);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+
+    TEST_ASSERT_EQUAL((int)(2U * n), logstore_read(ls, collect, &seen));
+    for (uint32_t i = 0; i < 2U * n; i++) {
+        TEST_ASSERT_EQUAL(i % n, seen.arg1[i]);
+    }
+    TEST_ASSERT_EQUAL_STRING("f00", seen.fmt[0]);
+    TEST_ASSERT_EQUAL_STRING("f07", seen.fmt[7]);
+}
+
+/* Verify entries survive a remount and each mount gets a new boot number */
+void test_logstore_persists_across_boots(void) {
+    logstore_stats_t st;
+    append("first boot", 10, 1, 0);
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+
+    remount();
+    TEST_ASSERT_EQUAL(0, logstore_get_stats(ls, &st));
+    TEST_ASSERT_EQUAL(2, st.boot);
+    append("second boot", 5, 2, 0);
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+
+    TEST_ASSERT_EQUAL(2, logstore_read(ls, collect, &seen));
+    TEST_ASSERT_EQUAL_STRING("first boot", seen.fmt[0]);
+    TEST_ASSERT_EQUAL(1, seen.boot[0]);
+    TEST_ASSERT_EQUAL_STRING("second boot", seen.fmt[1]);
+    TEST_ASSERT_EQUAL(2, seen.boot[1]);
+}
+
+/* Verify the ring recycles the oldest page and keeps the newest entries in order */
+void test_logstore_ring_wraps(void) {
+    logstore_stats_t st;
+    uint32_t total = 1500;
+
+    for (uint32_t i = 0; i < total; i++) {
+        append("seq %u", i, i, 0);
+    }
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+    TEST_ASSERT_EQUAL(0, logstore_get_stats(ls, &st));
+    TEST_ASSERT_TRUE(st.pages_erased > 0U);
+
+    int n = logstore_read(ls, collect, &seen);
+    TEST_ASSERT_TRUE(n > 0 && (uint32_t)n < total);
+    for (int i = 1; i < n; i++) {
+        TEST_ASSERT_EQUAL(seen.arg1[i - 1] + 1U, seen.arg1[i]);
+    }
+    TEST_ASSERT_EQUAL(total - 1U, seen.arg1[n - 1]);
+
+    /* The wrapped ring remounts to the same content */
+    remount();
+    TEST_ASSERT_EQUAL(n, logstore_read(ls, NULL, NULL));
+}
+
+/* Verify a frame torn by power loss is discarded and earlier frames survive */
+void test_logstore_torn_frame(void) {
+    logstore_stats_t st;
+    append("kept", 1, 1, 0);
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+
+    flash_sim_inject_fault(0);
+    append("lost", 2, 2, 0);
+    TEST_ASSERT_EQUAL(-1, logstore_flush(ls));
+    TEST_ASSERT_EQUAL(0, logstore_get_stats(ls, &st));
+    TEST_ASSERT_EQUAL_UINT32(1, st.entries_dropped);
+    flash_sim_power_cycle();
+
+    remount();
+    TEST_ASSERT_EQUAL(1, logstore_read(ls, collect, &seen));
+    TEST_ASSERT_EQUAL_STRING("kept", seen.fmt[0]);
+
+    /* Logging continues normally after the cut */
+    append("after", 3, 3, 0);
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+    TEST_ASSERT_EQUAL(2, logstore_read(ls, NULL, NULL));
+}
+
+/* Verify export streams raw pages starting with a page header */
+void test_logstore_export(void) {
+    uint8_t first[4] = {0};
+    append("export %u", 7, 7, 0);
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+
+    int32_t n = logstore_export(ls, capture, first);
+    TEST_ASSERT_TRUE(n > 16);
+    TEST_ASSERT_EQUAL(0, n % 8);
+    TEST_ASSERT_EQUAL_MEMORY("LOG2", first, 4);
+    TEST_ASSERT_EQUAL(-1, logstore_export(ls, abort_export, NULL));
+}
+
+/* Verify erase empties the ring */
+void test_logstore_erase(void) {
+    append("gone", 1, 0, 0);
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+    TEST_ASSERT_EQUAL(0, logstore_erase(ls));
+    TEST_ASSERT_EQUAL(0, logstore_read(ls, NULL, NULL));
+    append("new", 2, 0, 0);
+    TEST_ASSERT_EQUAL(0, logstore_flush(ls));
+    TEST_ASSERT_EQUAL(1, logstore_read(ls, NULL, NULL));
+}
+
+void run_logstore_tests(void) {
+    printf("\n=== Starting Log Store Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_logstore.c");
+    RUN_TEST(test_logstore_round_trip);
+    RUN_TEST(test_logstore_buffers_until_flush);
+    RUN_TEST(test_logstore_compresses);
+    RUN_TEST(test_logstore_dictionary_eviction);
+    RUN_TEST(test_logstore_persists_across_boots);
+    RUN_TEST(test_logstore_ring_wraps);
+    RUN_TEST(test_logstore_torn_frame);
+    RUN_TEST(test_logstore_export);
+    RUN_TEST(test_logstore_erase);
+
+    printf("=== Log Store Tests Complete ===\n");
+}
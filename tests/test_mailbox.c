@@ -0,0 +1,180 @@
+#include "unity.h"
+#include "mailbox.h"
+#include "scheduler.h"
+#include "allocator.h"
+#include "test_common.h"
+#include <setjmp.h>
+#include <stdio.h>
+#include <pthread.h>
+
+static uint8_t heap[4096];
+static task_t *t1;
+static task_t *t2;
+static mailbox_t *mb;
+
+/* Sample wide enough that a torn copy shows up as mismatched words */
+#define SAMPLE_WORDS    16
+typedef struct {
+    uint32_t w[SAMPLE_WORDS];
+} sample_t;
+
+static void dummy_task(void *arg) {
+    (void)arg;
+}
+
+/* Fill every word with the same value */
+static void sample_fill(sample_t *s, uint32_t v) {
+    for (int i = 0; i < SAMPLE_WORDS; i++) {
+        s->w[i] = v;
+    }
+}
+
+/* Two tasks: T1 writer, T2 reader; one mailbox holding a sample */
+static void setUp_local(void) {
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    scheduler_start();
+
+    t1 = scheduler_get_task_by_index(0);
+    t2 = scheduler_get_task_by_index(1);
+    task_set_current(t1);
+    mock_yield_count = 0;
+
+    mb = mailbox_create(sizeof(sample_t));
+    TEST_ASSERT_NOT_NULL(mb);
+}
+
+static void tearDown_local(void) {
+    mailbox_delete(mb);
+}
+
+/* Verify reads before the first write return 0 and leave the buffer alone */
+void test_mailbox_empty_read(void) {
+    sample_t s;
+    sample_fill(&s, 0xAA);
+
+    TEST_ASSERT_EQUAL_UINT32(0, mailbox_read(mb, &s));
+    TEST_ASSERT_EQUAL_UINT32(0xAA, s.w[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, mailbox_generation(mb));
+    TEST_ASSERT_NULL(mailbox_create(0));
+}
+
+/* Verify each write replaces the value and bumps the generation */
+void test_mailbox_latest_value_wins(void) {
+    sample_t in, out;
+
+    for (uint32_t v = 1; v <= 5; v++) {
+        sample_fill(&in, v * 100U);
+        TEST_ASSERT_EQUAL(0, mailbox_write(mb, &in));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(5, mailbox_generation(mb));
+    TEST_ASSERT_EQUAL_UINT32(5, mailbox_read(mb, &out));
+    TEST_ASSERT_EQUAL_UINT32(500, out.w[0]);
+    TEST_ASSERT_EQUAL_UINT32(500, out.w[SAMPLE_WORDS - 1]);
+
+    /* Reading does not consume */
+    TEST_ASSERT_EQUAL_UINT32(5, mailbox_read(mb, &out));
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+}
+
+/* Verify mailbox_wait() returns at once when a newer value is there */
+void test_mailbox_wait_newer_returns_immediately(void) {
+    sample_t in, out;
+    sample_fill(&in, 7);
+    mailbox_write(mb, &in);
+    mailbox_write(mb, &in);
+
+    task_set_current(t2);
+    TEST_ASSERT_EQUAL_UINT32(2, mailbox_wait(mb, &out, 0));
+    TEST_ASSERT_EQUAL_UINT32(7, out.w[3]);
+    TEST_ASSERT_EQUAL_UINT32(2, mailbox_wait(mb, &out, 1));
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+}
+
+/* Verify a reader blocks on a seen generation and the next write wakes it */
+void test_mailbox_wait_blocks_until_write(void) {
+    sample_t in, out;
+    sample_fill(&in, 1);
+    mailbox_write(mb, &in);
+
+    task_set_current(t2);
+    if (setjmp(yield_jump) == 0) {
+        mailbox_wait(mb, &out, 1);
+        TEST_FAIL_MESSAGE("mailbox_wait should have blocked");
+    }
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t2));
+
+    task_set_current(t1);
+    sample_fill(&in, 2);
+    TEST_ASSERT_EQUAL(0, mailbox_write(mb, &in));
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t2));
+
+    task_set_current(t2);
+    TEST_ASSERT_EQUAL_UINT32(2, mailbox_wait(mb, &out, 1));   /* T2 resumes its loop */
+    TEST_ASSERT_EQUAL_UINT32(2, out.w[0]);
+}
+
+#define STRESS_WRITES   200000U
+
+static volatile int writer_done;
+
+/* Write STRESS_WRITES samples as fast as possible, each word = its generation */
+static void *writer_thread(void *arg) {
+    (void)arg;
+    sample_t s;
+    for (uint32_t v = 1; v <= STRESS_WRITES; v++) {
+        sample_fill(&s, v);
+        mailbox_write(mb, &s);
+    }
+    writer_done = 1;
+    return NULL;
+}
+
+/* Verify lock-free reads racing a real writer thread are never torn */
+void test_mailbox_threaded_reads_never_torn(void) {
+    pthread_t writer;
+    uint32_t reads = 0, last = 0;
+    sample_t s;
+
+    writer_done = 0;
+    TEST_ASSERT_EQUAL(0, pthread_create(&writer, NULL, writer_thread, NULL));
+
+    while (!writer_done || last != STRESS_WRITES) {
+        uint32_t gen = mailbox_read(mb, &s);
+        if (gen == 0) {
+            continue;
+        }
+        for (int i = 0; i < SAMPLE_WORDS; i++) {
+            if (s.w[i] != gen) {
+                pthread_join(writer, NULL);
+                TEST_FAIL_MESSAGE("torn mailbox read");
+            }
+        }
+        TEST_ASSERT_TRUE(gen >= last);
+        last = gen;
+        reads++;
+    }
+    pthread_join(writer, NULL);
+
+    printf("Mailbox: %u reads against %u writes, none torn\n", reads, STRESS_WRITES);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_WRITES, mailbox_generation(mb));
+}
+
+void run_mailbox_tests(void) {
+    printf("\n=== Starting Mailbox Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_mailbox.c");
+    RUN_TEST(test_mailbox_empty_read);
+    RUN_TEST(test_mailbox_latest_value_wins);
+    RUN_TEST(test_mailbox_wait_newer_returns_immediately);
+    RUN_TEST(test_mailbox_wait_blocks_until_write);
+    RUN_TEST(test_mailbox_threaded_reads_never_torn);
+
+    printf("=== Mailbox Tests Complete ===\n");
+}
@@ -26,6 +26,22 @@ extern void run_dac_tests(void);
 extern void run_pwm_tests(void);
 extern void run_rtc_tests(void);
 extern void run_flash_tests(void);
+extern void run_kvstore_tests(void);
+extern void run_logstore_tests(void);
+extern void run_logbin_tests(void);
+extern void run_perf_tests(void);
+extern void run_irqprof_tests(void);
+extern void run_taskwdt_tests(void);
+extern void run_spinlock_tests(void);
+extern void run_ipc_tests(void);
+extern void run_msgbus_tests(void);
+extern void run_pbuf_tests(void);
+extern void run_mailbox_tests(void);
+extern void run_cpp_tests(void);
+extern void run_boot_tests(void);
+extern void run_kobj_tests(void);
+extern void run_system_clock_tests(void);
+extern void run_dvfs_tests(void);
 
 /* Main entry point for the unit test executable */
 int main(void) {
@@ -57,6 +73,22 @@ int main(void) {
     run_pwm_tests();
     run_rtc_tests();
     run_flash_tests();
+    run_kvstore_tests();
+    run_logstore_tests();
+    run_logbin_tests();
+    run_perf_tests();
+    run_irqprof_tests();
+    run_taskwdt_tests();
+    run_spinlock_tests();
+    run_ipc_tests();
+    run_msgbus_tests();
+    run_pbuf_tests();
+    run_mailbox_tests();
+    run_cpp_tests();
+    run_boot_tests();
+    run_kobj_tests();
+    run_system_clock_tests();
+    run_dvfs_tests();
 
     /* Return failure count (0 = success) */
     return UNITY_END();
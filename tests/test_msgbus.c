@@ -0,0 +1,329 @@
+#include "unity.h"
+#include "msgbus.h"
+#include "queue.h"
+#include "scheduler.h"
+#include "allocator.h"
+#include "utils.h"
+#include "test_common.h"
+#include <setjmp.h>
+#include <stdio.h>
+#include <time.h>
+
+static uint8_t heap[32768];
+static task_t *t1;
+static task_t *t2;
+static msgbus_t *bus;
+
+static void dummy_task(void *arg) {
+    (void)arg;
+}
+
+/* Two tasks: T1 publisher, T2 subscriber; a bus of four 16-byte messages */
+static void setUp_local(void) {
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    scheduler_start();
+
+    t1 = scheduler_get_task_by_index(0);
+    t2 = scheduler_get_task_by_index(1);
+    task_set_current(t1);
+    mock_yield_count = 0;
+
+    bus = msgbus_create(16, 4);
+    TEST_ASSERT_NOT_NULL(bus);
+}
+
+static void tearDown_local(void) {
+    msgbus_delete(bus);
+}
+
+/* Allocate and publish a message carrying one word */
+static int publish_word(uint8_t topic, uint32_t value) {
+    uint32_t *msg = (uint32_t*)msgbus_alloc(bus);
+    TEST_ASSERT_NOT_NULL(msg);
+    *msg = value;
+    return msgbus_publish(bus, topic, msg);
+}
+
+/* Verify every subscriber gets the same buffer and the last release frees it */
+void test_msgbus_fan_out_shares_one_message(void) {
+    msgbus_sub_t *a = msgbus_subscribe(bus, MSGBUS_TOPIC_ALL, 2, MSGBUS_DROP_OLDEST);
+    msgbus_sub_t *b = msgbus_subscribe(bus, MSGBUS_TOPIC_ALL, 2, MSGBUS_DROP_OLDEST);
+    msgbus_sub_t *c = msgbus_subscribe(bus, MSGBUS_TOPIC_ALL, 2, MSGBUS_BLOCK);
+
+    /* Drain the pool down to one message */
+    void *held[3];
+    for (int i = 0; i < 3; i++) {
+        held[i] = msgbus_alloc(bus);
+    }
+    uint32_t *msg = (uint32_t*)msgbus_alloc(bus);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_NULL(msgbus_alloc(bus));
+
+    *msg = 0xC0FFEE;
+    TEST_ASSERT_EQUAL(3, msgbus_publish(bus, 5, msg));
+
+    uint32_t *ra = (uint32_t*)msgbus_receive(a);
+    uint32_t *rb = (uint32_t*)msgbus_try_receive(b);
+    uint32_t *rc = (uint32_t*)msgbus_receive(c);
+    TEST_ASSERT_EQUAL_PTR(msg, ra);
+    TEST_ASSERT_EQUAL_PTR(msg, rb);
+    TEST_ASSERT_EQUAL_PTR(msg, rc);
+    TEST_ASSERT_EQUAL_HEX32(0xC0FFEE, *rc);
+    TEST_ASSERT_EQUAL(5, msgbus_msg_topic(rc));
+
+    msgbus_release(ra);
+    msgbus_release(rb);
+    TEST_ASSERT_NULL(msgbus_alloc(bus));        /* C still holds it */
+    msgbus_release(rc);
+    TEST_ASSERT_EQUAL_PTR(msg, msgbus_alloc(bus));
+
+    for (int i = 0; i < 3; i++) {
+        msgbus_release(held[i]);
+    }
+    msgbus_release(msg);
+    msgbus_unsubscribe(a);
+    msgbus_unsubscribe(b);
+    msgbus_unsubscribe(c);
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+}
+
+/* Verify subscribers only see their topics and unmatched messages are freed */
+void test_msgbus_topic_filter(void) {
+    msgbus_sub_t *temp = msgbus_subscribe(bus, MSGBUS_TOPIC(1), 4, MSGBUS_BLOCK);
+    msgbus_sub_t *both = msgbus_subscribe(bus, MSGBUS_TOPIC(1) | MSGBUS_TOPIC(2), 4, MSGBUS_BLOCK);
+
+    TEST_ASSERT_EQUAL(2, publish_word(1, 10));
+    TEST_ASSERT_EQUAL(1, publish_word(2, 20));
+    TEST_ASSERT_EQUAL(0, publish_word(3, 30));
+    void *bad = msgbus_alloc(bus);
+    TEST_ASSERT_EQUAL(-1, msgbus_publish(bus, MSGBUS_MAX_TOPICS, bad));
+    msgbus_release(bad);
+
+    uint32_t *m = (uint32_t*)msgbus_try_receive(temp);
+    TEST_ASSERT_EQUAL_UINT32(10, *m);
+    msgbus_release(m);
+    TEST_ASSERT_NULL(msgbus_try_receive(temp));
+
+    m = (uint32_t*)msgbus_try_receive(both);
+    TEST_ASSERT_EQUAL_UINT32(10, *m);
+    msgbus_release(m);
+    m = (uint32_t*)msgbus_try_receive(both);
+    TEST_ASSERT_EQUAL_UINT32(20, *m);
+    TEST_ASSERT_EQUAL(2, msgbus_msg_topic(m));
+    msgbus_release(m);
+
+    /* Every message is back in the pool */
+    void *msgs[4];
+    for (int i = 0; i < 4; i++) {
+        msgs[i] = msgbus_alloc(bus);
+        TEST_ASSERT_NOT_NULL(msgs[i]);
+    }
+    TEST_ASSERT_NULL(msgbus_alloc(bus));
+
+    msgbus_unsubscribe(temp);
+    msgbus_unsubscribe(both);
+}
+
+/* Verify a drop-oldest subscriber keeps the newest messages and frees the evicted ones */
+void test_msgbus_drop_oldest(void) {
+    msgbus_sub_t *sub = msgbus_subscribe(bus, MSGBUS_TOPIC_ALL, 2, MSGBUS_DROP_OLDEST);
+
+    for (uint32_t i = 1; i <= 6; i++) {
+        TEST_ASSERT_EQUAL(1, publish_word(0, i));    /* Pool of 4 never runs dry */
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, msgbus_get_dropped(sub));
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+
+    uint32_t *m = (uint32_t*)msgbus_try_receive(sub);
+    TEST_ASSERT_EQUAL_UINT32(5, *m);
+    msgbus_release(m);
+    m = (uint32_t*)msgbus_try_receive(sub);
+    TEST_ASSERT_EQUAL_UINT32(6, *m);
+    msgbus_release(m);
+    TEST_ASSERT_NULL(msgbus_try_receive(sub));
+
+    msgbus_unsubscribe(sub);
+}
+
+/* Verify a full blocking subscriber holds the publisher back, with no partial delivery */
+void test_msgbus_block_backpressure(void) {
+    msgbus_sub_t *slow = msgbus_subscribe(bus, MSGBUS_TOPIC_ALL, 1, MSGBUS_BLOCK);
+    msgbus_sub_t *fast = msgbus_subscribe(bus, MSGBUS_TOPIC_ALL, 4, MSGBUS_DROP_OLDEST);
+
+    TEST_ASSERT_EQUAL(2, publish_word(0, 1));
+
+    uint32_t *msg = (uint32_t*)msgbus_alloc(bus);
+    *msg = 2;
+    if (setjmp(yield_jump) == 0) {
+        msgbus_publish(bus, 0, msg);
+        TEST_FAIL_MESSAGE("msgbus_publish should have blocked");
+    }
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t1));
+
+    /* The fast subscriber has not seen message 2 yet */
+    task_set_current(t2);
+    uint32_t *m = (uint32_t*)msgbus_try_receive(fast);
+    TEST_ASSERT_EQUAL_UINT32(1, *m);
+    msgbus_release(m);
+    TEST_ASSERT_NULL(msgbus_try_receive(fast));
+
+    /* Taking from the slow subscriber makes room and wakes the publisher */
+    m = (uint32_t*)msgbus_receive(slow);
+    TEST_ASSERT_EQUAL_UINT32(1, *m);
+    msgbus_release(m);
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t1));
+
+    task_set_current(t1);
+    TEST_ASSERT_EQUAL(2, msgbus_publish(bus, 0, msg));   /* T1 resumes its loop */
+    TEST_ASSERT_EQUAL_UINT32(0, msgbus_get_dropped(slow));
+
+    msgbus_unsubscribe(slow);
+    msgbus_unsubscribe(fast);
+}
+
+/* Verify a receiver blocks on an empty ring and a publish wakes it */
+void test_msgbus_receive_blocks_until_publish(void) {
+    msgbus_sub_t *sub = msgbus_subscribe(bus, MSGBUS_TOPIC(7), 2, MSGBUS_BLOCK);
+
+    task_set_current(t2);
+    if (setjmp(yield_jump) == 0) {
+        msgbus_receive(sub);
+        TEST_FAIL_MESSAGE("msgbus_receive should have blocked");
+    }
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t2));
+
+    task_set_current(t1);
+    TEST_ASSERT_EQUAL(1, publish_word(7, 77));
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t2));
+
+    task_set_current(t2);
+    uint32_t *m = (uint32_t*)msgbus_receive(sub);
+    TEST_ASSERT_EQUAL_UINT32(77, *m);
+    msgbus_release(m);
+
+    msgbus_unsubscribe(sub);
+}
+
+/* Verify an ISR publish skips a full blocking subscriber and counts the miss */
+void test_msgbus_publish_from_isr_never_blocks(void) {
+    msgbus_sub_t *slow = msgbus_subscribe(bus, MSGBUS_TOPIC_ALL, 1, MSGBUS_BLOCK);
+    msgbus_sub_t *fast = msgbus_subscribe(bus, MSGBUS_TOPIC_ALL, 2, MSGBUS_DROP_OLDEST);
+
+    TEST_ASSERT_EQUAL(2, msgbus_publish_from_isr(bus, 0, msgbus_alloc(bus)));
+    TEST_ASSERT_EQUAL(1, msgbus_publish_from_isr(bus, 0, msgbus_alloc(bus)));
+    TEST_ASSERT_EQUAL_UINT32(1, msgbus_get_dropped(slow));
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+
+    /* Unsubscribing releases what is still queued */
+    msgbus_unsubscribe(slow);
+    msgbus_unsubscribe(fast);
+    void *msgs[4];
+    for (int i = 0; i < 4; i++) {
+        msgs[i] = msgbus_alloc(bus);
+        TEST_ASSERT_NOT_NULL(msgs[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+        msgbus_release(msgs[i]);
+    }
+}
+
+/* ##### Throughput benchmark: bus fan-out vs a queue copy per consumer ##### */
+
+#define BENCH_SAMPLES       20000
+#define BENCH_SAMPLE_SIZE   64
+#define BENCH_MAX_SUBS      8
+
+static uint64_t bench_elapsed_ns(const struct timespec *t0) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - t0->tv_sec) * 1000000000ULL +
+           (uint64_t)(now.tv_nsec - t0->tv_nsec);
+}
+
+/* One producer, 1..8 consumers; each sample is written once and read by every consumer */
+void test_msgbus_fan_out_benchmark(void) {
+    static uint8_t sample[BENCH_SAMPLE_SIZE];
+    static uint8_t copy[BENCH_SAMPLE_SIZE];
+    struct timespec t0;
+    uint32_t sum;
+
+    msgbus_t *big = msgbus_create(BENCH_SAMPLE_SIZE, 4);
+    TEST_ASSERT_NOT_NULL(big);
+
+    for (int n = 1; n <= BENCH_MAX_SUBS; n *= 2) {
+        msgbus_sub_t *subs[BENCH_MAX_SUBS];
+        queue_t *queues[BENCH_MAX_SUBS];
+        for (int i = 0; i < n; i++) {
+            subs[i] = msgbus_subscribe(big, MSGBUS_TOPIC(0), 4, MSGBUS_BLOCK);
+            queues[i] = queue_create(BENCH_SAMPLE_SIZE, 4);
+            TEST_ASSERT_NOT_NULL(subs[i]);
+            TEST_ASSERT_NOT_NULL(queues[i]);
+        }
+
+        /* Bus: fill the pool buffer in place, pass references */
+        sum = 0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (uint32_t s = 0; s < BENCH_SAMPLES; s++) {
+            uint8_t *msg = (uint8_t*)msgbus_alloc(big);
+            utils_memset(msg, (int)s, BENCH_SAMPLE_SIZE);
+            msgbus_publish(big, 0, msg);
+            for (int i = 0; i < n; i++) {
+                uint8_t *m = (uint8_t*)msgbus_receive(subs[i]);
+                sum += m[BENCH_SAMPLE_SIZE - 1];
+                msgbus_release(m);
+            }
+        }
+        uint64_t bus_ns = bench_elapsed_ns(&t0);
+        uint32_t bus_sum = sum;
+
+        /* Queues: one copy in and one copy out per consumer */
+        sum = 0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (uint32_t s = 0; s < BENCH_SAMPLES; s++) {
+            utils_memset(sample, (int)s, BENCH_SAMPLE_SIZE);
+            for (int i = 0; i < n; i++) {
+                queue_push(queues[i], sample);
+            }
+            for (int i = 0; i < n; i++) {
+                queue_pop(queues[i], copy);
+                sum += copy[BENCH_SAMPLE_SIZE - 1];
+            }
+        }
+        uint64_t queue_ns = bench_elapsed_ns(&t0);
+        TEST_ASSERT_EQUAL_UINT32(sum, bus_sum);
+        TEST_ASSERT_EQUAL(0, mock_yield_count);
+
+        printf("Fan-out %d x %d-byte sample: msgbus %llu ns, queue copies %llu ns\n",
+               n, BENCH_SAMPLE_SIZE,
+               (unsigned long long)(bus_ns / BENCH_SAMPLES),
+               (unsigned long long)(queue_ns / BENCH_SAMPLES));
+
+        for (int i = 0; i < n; i++) {
+            msgbus_unsubscribe(subs[i]);
+            queue_delete(queues[i]);
+        }
+    }
+
+    msgbus_delete(big);
+}
+
+void run_msgbus_tests(void) {
+    printf("\n=== Starting Message Bus Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_msgbus.c");
+    RUN_TEST(test_msgbus_fan_out_shares_one_message);
+    RUN_TEST(test_msgbus_topic_filter);
+    RUN_TEST(test_msgbus_drop_oldest);
+    RUN_TEST(test_msgbus_block_backpressure);
+    RUN_TEST(test_msgbus_receive_blocks_until_publish);
+    RUN_TEST(test_msgbus_publish_from_isr_never_blocks);
+    RUN_TEST(test_msgbus_fan_out_benchmark);
+
+    printf("=== Message Bus Tests Complete ===\n");
+}
@@ -6,6 +6,7 @@
 #include "allocator.h"
 #include <stdio.h>
 #include "test_common.h"
+#include <time.h>
 
 static uint8_t heap[4096];
 static task_t *t1;
@@ -45,7 +46,7 @@ void test_mutex_init(void) {
     so_mutex_t m;
     so_mutex_init(&m);
     
-    TEST_ASSERT_NULL(m.owner);
+    TEST_ASSERT_NULL(so_mutex_get_owner(&m));
     TEST_ASSERT_NULL(m.wait_head);
     TEST_ASSERT_NULL(m.wait_tail);
 }
@@ -57,7 +58,7 @@ void test_mutex_lock_success(void) {
     
     so_mutex_lock(&m);
     
-    TEST_ASSERT_EQUAL_PTR(t1, m.owner);
+    TEST_ASSERT_EQUAL_PTR(t1, so_mutex_get_owner(&m));
     TEST_ASSERT_EQUAL(0, mock_yield_count); /* Should not yield */
 }
 
@@ -70,7 +71,7 @@ void test_mutex_lock_recursive_handoff(void) {
     /* Lock again (Recursive check) */
     so_mutex_lock(&m);
     
-    TEST_ASSERT_EQUAL_PTR(t1, m.owner);
+    TEST_ASSERT_EQUAL_PTR(t1, so_mutex_get_owner(&m));
     TEST_ASSERT_EQUAL(0, mock_yield_count);
 }
 
@@ -104,7 +105,7 @@ void test_mutex_unlock_handoff(void) {
     so_mutex_init(&m);
     
     /* Setup: Task 0 owns lock, Task 1 is waiting */
-    m.owner = t1;
+    m.state = (uintptr_t)t1 | SO_MUTEX_WAITERS;
     
     wait_node_t *node = task_get_wait_node(t2);
     node->task = t2;
@@ -117,7 +118,7 @@ void test_mutex_unlock_handoff(void) {
     so_mutex_unlock(&m);
     
     /* Verify Handoff */
-    TEST_ASSERT_EQUAL_PTR(t2, m.owner); /* Owner is now T2 */
+    TEST_ASSERT_EQUAL_PTR(t2, so_mutex_get_owner(&m)); /* Owner is now T2 */
     TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t2)); /* T1 woke up */
     TEST_ASSERT_NULL(m.wait_head); /* Queue empty */
 }
@@ -154,7 +155,7 @@ void test_mutex_priority_inheritance(void) {
     TEST_ASSERT_EQUAL(TASK_WEIGHT_LOW, task_get_weight(t1));
     
     /* Verify T2 is now the owner (handoff) */
-    TEST_ASSERT_EQUAL_PTR(t2, m.owner);
+    TEST_ASSERT_EQUAL_PTR(t2, so_mutex_get_owner(&m));
 }
 
 /* Verify Chained Priority Inheritance (New Owner Boost) */
@@ -196,10 +197,84 @@ void test_mutex_chained_priority_inheritance(void) {
     so_mutex_unlock(&m);
     
     TEST_ASSERT_EQUAL(TASK_WEIGHT_LOW, task_get_weight(t1));
-    TEST_ASSERT_EQUAL_PTR(t2, m.owner);
+    TEST_ASSERT_EQUAL_PTR(t2, so_mutex_get_owner(&m));
     TEST_ASSERT_EQUAL(TASK_WEIGHT_HIGH, task_get_weight(t2)); /* T2 inherited T3's weight */
 }
 
+/* Verify the uncontended path never touches the wait-list spinlock */
+void test_mutex_fast_path_skips_spinlock(void) {
+    so_mutex_t m;
+    so_mutex_init(&m);
+
+    so_mutex_lock(&m);
+    TEST_ASSERT_EQUAL_PTR(t1, (void *)m.state);
+    so_mutex_unlock(&m);
+    TEST_ASSERT_NULL((void *)m.state);
+
+    /* Unlock by a non-owner leaves the word alone */
+    so_mutex_lock(&m);
+    task_set_current(t2);
+    so_mutex_unlock(&m);
+    TEST_ASSERT_EQUAL_PTR(t1, so_mutex_get_owner(&m));
+
+#if SPINLOCK_STATS
+    TEST_ASSERT_EQUAL_UINT32(1, m.lock.stats.acquires);   /* Only the refused unlock */
+#endif
+}
+
+/* Verify a waiter sets the waiters bit and the handoff clears it */
+void test_mutex_waiters_bit(void) {
+    so_mutex_t m;
+    so_mutex_init(&m);
+
+    so_mutex_lock(&m);
+    task_set_current(t2);
+    if (setjmp(yield_jump) == 0) {
+        so_mutex_lock(&m);
+        TEST_FAIL_MESSAGE("mutex_lock should have yielded/blocked");
+    }
+    TEST_ASSERT_EQUAL_PTR((void *)((uintptr_t)t1 | SO_MUTEX_WAITERS), (void *)m.state);
+
+    /* Owner's CAS unlock fails on the bit and hands off */
+    task_set_current(t1);
+    so_mutex_unlock(&m);
+    TEST_ASSERT_EQUAL_PTR(t2, (void *)m.state);
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t2));
+
+    /* T2 resumes in the lock loop and finds itself owner */
+    task_set_current(t2);
+    so_mutex_lock(&m);
+    so_mutex_unlock(&m);
+    TEST_ASSERT_NULL((void *)m.state);
+}
+
+#define BENCH_PAIRS 1000000
+
+/* Report the cost of an uncontended lock/unlock pair on the host */
+void test_mutex_uncontended_benchmark(void) {
+    so_mutex_t m;
+    struct timespec t0, t1_;
+
+    so_mutex_init(&m);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < BENCH_PAIRS; i++) {
+        so_mutex_lock(&m);
+        so_mutex_unlock(&m);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1_);
+
+    uint64_t ns = (uint64_t)(t1_.tv_sec - t0.tv_sec) * 1000000000ULL +
+                  (uint64_t)(t1_.tv_nsec - t0.tv_nsec);
+    printf("Mutex lock/unlock pair (uncontended): %llu.%02llu ns\n",
+           (unsigned long long)(ns / BENCH_PAIRS),
+           (unsigned long long)((ns % BENCH_PAIRS) * 100U / BENCH_PAIRS));
+
+    TEST_ASSERT_NULL((void *)m.state);
+#if SPINLOCK_STATS
+    TEST_ASSERT_EQUAL_UINT32(0, m.lock.stats.acquires);
+#endif
+}
+
 /* Run the mutex test suite */
 void run_mutex_tests(void) {
     printf("\n=== Starting Mutex Tests ===\n");
@@ -215,6 +290,9 @@ void run_mutex_tests(void) {
     RUN_TEST(test_mutex_unlock_handoff);
     RUN_TEST(test_mutex_priority_inheritance);
     RUN_TEST(test_mutex_chained_priority_inheritance);
+    RUN_TEST(test_mutex_fast_path_skips_spinlock);
+    RUN_TEST(test_mutex_waiters_bit);
+    RUN_TEST(test_mutex_uncontended_benchmark);
 
     printf("=== Mutex Tests Complete ===\n");
 }
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "unity.h"
+#include "pbuf.h"
+#include "uart.h"
+#include "queue.h"
+#include "allocator.h"
+#include "utils.h"
+#include "mock_drivers.h"
+#include "test_common.h"
+#include <stdio.h>
+#include <time.h>
+
+static uint8_t heap[16384];
+static pbuf_pool_t *pool;
+
+/* Pool of eight 64-byte chunks */
+static void setUp_local(void) {
+    allocator_init(heap, sizeof(heap));
+    mock_drivers_reset();
+    pool = pbuf_pool_create(64, 8);
+    TEST_ASSERT_NOT_NULL(pool);
+}
+
+static void tearDown_local(void) {
+    pbuf_pool_delete(pool);
+}
+
+/* Number of chunks that can still be allocated, all returned afterwards */
+static int chunks_free(void) {
+    pbuf_t *taken[16];
+    int n = 0;
+    while (n < 16 && (taken[n] = pbuf_alloc(pool, 0, 0)) != NULL) {
+        n++;
+    }
+    for (int i = 0; i < n; i++) {
+        pbuf_free(taken[i]);
+    }
+    return n;
+}
+
+/* Verify long packets are chained and the headroom only applies to the first chunk */
+void test_pbuf_alloc_chains_chunks(void) {
+    pbuf_t *p = pbuf_alloc(pool, 150, 16);
+    TEST_ASSERT_NOT_NULL(p);
+    TEST_ASSERT_EQUAL(150, p->tot_len);
+    TEST_ASSERT_EQUAL(48, p->len);
+    TEST_ASSERT_EQUAL(64, p->next->len);
+    TEST_ASSERT_EQUAL(102, p->next->tot_len);
+    TEST_ASSERT_EQUAL(38, p->next->next->len);
+    TEST_ASSERT_NULL(p->next->next->next);
+    TEST_ASSERT_EQUAL(5, chunks_free());
+
+    pbuf_free(p);
+    TEST_ASSERT_EQUAL(8, chunks_free());
+
+    /* Not enough chunks: nothing is kept */
+    TEST_ASSERT_NULL(pbuf_alloc(pool, 9 * 64, 0));
+    TEST_ASSERT_EQUAL(8, chunks_free());
+    TEST_ASSERT_NULL(pbuf_alloc(pool, 10, 64));
+}
+
+/* Verify headers go into the headroom and trailers into the tail space or a new chunk */
+void test_pbuf_header_and_trailer_in_place(void) {
+    pbuf_t *p = pbuf_alloc(pool, 60, 3);
+    uint8_t *payload = p->payload;
+
+    uint8_t *hdr = pbuf_push_header(p, 3);
+    TEST_ASSERT_EQUAL_PTR(payload - 3, hdr);
+    TEST_ASSERT_EQUAL(63, p->tot_len);
+    TEST_ASSERT_NULL(pbuf_push_header(p, 1));       /* Headroom used up */
+
+    uint8_t *crc = pbuf_put_tail(p, 1);
+    TEST_ASSERT_EQUAL_PTR(payload + 60, crc);        /* Fits in the first chunk */
+    TEST_ASSERT_NULL(p->next);
+
+    crc = pbuf_put_tail(p, 4);                       /* Does not: chained */
+    TEST_ASSERT_NOT_NULL(p->next);
+    TEST_ASSERT_EQUAL_PTR(p->next->payload, crc);
+    TEST_ASSERT_EQUAL(68, p->tot_len);
+    TEST_ASSERT_EQUAL(64, p->len);
+
+    TEST_ASSERT_EQUAL(0, pbuf_pull_header(p, 3));
+    TEST_ASSERT_EQUAL_PTR(payload, p->payload);
+    TEST_ASSERT_EQUAL(65, p->tot_len);
+    TEST_ASSERT_EQUAL(-1, pbuf_pull_header(p, 62));
+
+    pbuf_free(p);
+    TEST_ASSERT_EQUAL(8, chunks_free());
+}
+
+/* Verify copies across chunk boundaries and concatenation */
+void test_pbuf_copy_and_cat(void) {
+    uint8_t src[100], dst[100];
+    for (int i = 0; i < 100; i++) {
+        src[i] = (uint8_t)i;
+    }
+
+    pbuf_t *a = pbuf_alloc(pool, 70, 0);
+    pbuf_t *b = pbuf_alloc(pool, 30, 0);
+    pbuf_cat(a, b);
+    TEST_ASSERT_EQUAL(100, a->tot_len);
+    TEST_ASSERT_EQUAL(36, a->next->tot_len);
+
+    TEST_ASSERT_EQUAL(100, pbuf_copy_in(a, src, 100, 0));
+    TEST_ASSERT_EQUAL(8, pbuf_copy_out(a, dst, 8, 60));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&src[60], dst, 8);
+    TEST_ASSERT_EQUAL(100, pbuf_copy_out(a, dst, sizeof(dst), 0));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(src, dst, 100);
+    TEST_ASSERT_EQUAL(10, pbuf_copy_out(a, dst, 50, 90));
+
+    pbuf_free(a);
+    TEST_ASSERT_EQUAL(8, chunks_free());
+}
+
+/* Verify the chain is freed only when the last reference goes */
+void test_pbuf_refcount(void) {
+    pbuf_t *p = pbuf_alloc(pool, 100, 0);
+    pbuf_ref(p);
+
+    pbuf_free(p);
+    TEST_ASSERT_EQUAL(6, chunks_free());
+    pbuf_free(p);
+    TEST_ASSERT_EQUAL(8, chunks_free());
+
+    /* A chunk shared by another chain stops the walk */
+    pbuf_t *shared = pbuf_alloc(pool, 10, 0);
+    pbuf_t *head = pbuf_alloc(pool, 10, 0);
+    pbuf_ref(shared);
+    pbuf_cat(head, shared);
+    pbuf_free(head);
+    TEST_ASSERT_EQUAL(7, chunks_free());
+    pbuf_free(shared);
+    TEST_ASSERT_EQUAL(8, chunks_free());
+}
+
+/* Drain the UART TX path into buf */
+static size_t uart_drain(uart_port_t port, uint8_t *buf, size_t max) {
+    size_t n = 0;
+    uint8_t b;
+    while (uart_core_tx_callback(port, &b)) {
+        if (n < max) {
+            buf[n] = b;
+        }
+        n++;
+    }
+    return n;
+}
+
+/* Verify the UART sends a chain from its chunks, in order, and frees it */
+void test_pbuf_uart_tx_sends_chain(void) {
+    static uint8_t tx_buf[32];
+    uint8_t out[128];
+    uart_port_t port = uart_create((void*)0x1000, NULL, 0, tx_buf, sizeof(tx_buf), NULL, 80000000);
+    TEST_ASSERT_NOT_NULL(port);
+
+    pbuf_t *frames[UART_TX_PBUF_DEPTH];
+    for (int i = 0; i < UART_TX_PBUF_DEPTH; i++) {
+        frames[i] = pbuf_alloc(pool, 1, 1);
+        frames[i]->payload[0] = (uint8_t)('a' + i);
+        *pbuf_push_header(frames[i], 1) = '<';
+        TEST_ASSERT_EQUAL(0, uart_write_pbuf(port, frames[i]));
+    }
+    TEST_ASSERT_EQUAL(1, mock_uart_enable_tx_irq_arg);
+    TEST_ASSERT_EQUAL(-1, uart_write_pbuf(port, frames[0]));   /* Frame queue full */
+    TEST_ASSERT_EQUAL(2 * UART_TX_PBUF_DEPTH, uart_drain(port, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY("<a<b", out, 4);
+    TEST_ASSERT_EQUAL(8, chunks_free());
+
+    /* A multi-chunk frame goes out ahead of the byte ring */
+    uint8_t data[100];
+    for (int i = 0; i < 100; i++) {
+        data[i] = (uint8_t)i;
+    }
+    pbuf_t *p = pbuf_alloc(pool, 100, 0);
+    pbuf_copy_in(p, data, 100, 0);
+    uart_write_buffer(port, "xy", 2);
+    TEST_ASSERT_EQUAL(0, uart_write_pbuf(port, p));
+    TEST_ASSERT_EQUAL(102, uart_drain(port, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, out, 100);
+    TEST_ASSERT_EQUAL_MEMORY("xy", &out[100], 2);
+    TEST_ASSERT_EQUAL(8, chunks_free());
+
+    uart_destroy(port);
+}
+
+/* Verify received bytes arrive as chunks on the queue, full or flushed */
+void test_pbuf_uart_rx_fills_chunks(void) {
+    uart_port_t port = uart_create((void*)0x1000, NULL, 0, NULL, 0, NULL, 80000000);
+    queue_t *q = queue_create(sizeof(pbuf_t*), 2);
+    uart_set_rx_pbuf(port, pool, q);
+
+    for (int i = 0; i < 70; i++) {
+        uart_core_rx_callback(port, (uint8_t)i);
+    }
+
+    pbuf_t *p = NULL;
+    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &p));
+    TEST_ASSERT_EQUAL(64, p->tot_len);
+    TEST_ASSERT_EQUAL(63, p->payload[63]);
+    pbuf_free(p);
+    TEST_ASSERT_EQUAL(-1, queue_pop_from_isr(q, &p));  /* Rest still filling */
+
+    TEST_ASSERT_EQUAL(6, uart_rx_pbuf_flush(port));
+    TEST_ASSERT_EQUAL(0, uart_rx_pbuf_flush(port));
+    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &p));
+    TEST_ASSERT_EQUAL(6, p->len);
+    TEST_ASSERT_EQUAL(64, p->payload[0]);
+    pbuf_free(p);
+
+    /* Disabling returns the partly filled chunk */
+    uart_core_rx_callback(port, 0xEE);
+    uart_set_rx_pbuf(port, NULL, NULL);
+    TEST_ASSERT_EQUAL(8, chunks_free());
+
+    queue_delete(q);
+    uart_destroy(port);
+}
+
+/* ##### UART framing benchmark: copy per layer vs packet buffers ##### */
+
+#define BENCH_FRAMES        20000
+#define BENCH_PAYLOAD       128
+#define FRAME_HDR           3       /* SOF, len:u16 */
+#define FRAME_CRC           4       /* crc32:u32 */
+
+static uint64_t bench_elapsed_ns(const struct timespec *t0) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - t0->tv_sec) * 1000000000ULL +
+           (uint64_t)(now.tv_nsec - t0->tv_nsec);
+}
+
+/* Application fills a payload; framing adds a header and a CRC; the UART interrupt sends it */
+void test_pbuf_uart_framing_benchmark(void) {
+    static uint8_t tx_buf[UART_TX_BUFFER_SIZE];
+    static uint8_t payload[BENCH_PAYLOAD];
+    static uint8_t frame[FRAME_HDR + BENCH_PAYLOAD + FRAME_CRC];
+    static uint8_t out[FRAME_HDR + BENCH_PAYLOAD + FRAME_CRC];
+    struct timespec t0, t1;
+    uint64_t copy_send_ns = 0, pbuf_send_ns = 0;
+    uint32_t sum;
+
+    pbuf_pool_t *big = pbuf_pool_create(256, 4);
+    uart_port_t port = uart_create((void*)0x1000, NULL, 0, tx_buf, sizeof(tx_buf), NULL, 80000000);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_NOT_NULL(port);
+
+    /* Copies: payload -> frame buffer -> UART TX ring */
+    sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t f = 0; f < BENCH_FRAMES; f++) {
+        for (uint32_t i = 0; i < BENCH_PAYLOAD; i++) {
+            payload[i] = (uint8_t)(f + i);
+        }
+        frame[0] = 0x7E;
+        frame[1] = (uint8_t)BENCH_PAYLOAD;
+        frame[2] = (uint8_t)(BENCH_PAYLOAD >> 8);
+        utils_memcpy(&frame[FRAME_HDR], payload, BENCH_PAYLOAD);
+        uint32_t crc = utils_crc32(0, payload, BENCH_PAYLOAD);
+        utils_memcpy(&frame[FRAME_HDR + BENCH_PAYLOAD], &crc, FRAME_CRC);
+        uart_write_buffer(port, (const char*)frame, sizeof(frame));
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        sum += (uint32_t)uart_drain(port, out, sizeof(out));
+        copy_send_ns += bench_elapsed_ns(&t1);
+    }
+    uint64_t copy_ns = bench_elapsed_ns(&t0);
+    TEST_ASSERT_EQUAL_UINT32(BENCH_FRAMES * sizeof(frame), sum);
+    TEST_ASSERT_EQUAL_MEMORY(frame, out, sizeof(frame));
+
+    /* Packet buffers: payload written in place, header and CRC added around it */
+    sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t f = 0; f < BENCH_FRAMES; f++) {
+        pbuf_t *p = pbuf_alloc(big, BENCH_PAYLOAD, FRAME_HDR);
+        for (uint32_t i = 0; i < BENCH_PAYLOAD; i++) {
+            p->payload[i] = (uint8_t)(f + i);
+        }
+        uint32_t crc = utils_crc32(0, p->payload, BENCH_PAYLOAD);
+        uint8_t *hdr = pbuf_push_header(p, FRAME_HDR);
+        hdr[0] = 0x7E;
+        hdr[1] = (uint8_t)BENCH_PAYLOAD;
+        hdr[2] = (uint8_t)(BENCH_PAYLOAD >> 8);
+        utils_memcpy(pbuf_put_tail(p, FRAME_CRC), &crc, FRAME_CRC);
+        uart_write_pbuf(port, p);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        sum += (uint32_t)uart_drain(port, out, sizeof(out));
+        pbuf_send_ns += bench_elapsed_ns(&t1);
+    }
+    uint64_t pbuf_ns = bench_elapsed_ns(&t0);
+    TEST_ASSERT_EQUAL_UINT32(BENCH_FRAMES * sizeof(frame), sum);
+    TEST_ASSERT_EQUAL_MEMORY(frame, out, sizeof(frame));
+
+    printf("UART framing, %d-byte payload, build + send per frame: copies %llu + %llu ns, pbuf %llu + %llu ns\n",
+           BENCH_PAYLOAD,
+           (unsigned long long)((copy_ns - copy_send_ns) / BENCH_FRAMES),
+           (unsigned long long)(copy_send_ns / BENCH_FRAMES),
+           (unsigned long long)((pbuf_ns - pbuf_send_ns) / BENCH_FRAMES),
+           (unsigned long long)(pbuf_send_ns / BENCH_FRAMES));
+
+    uart_destroy(port);
+    pbuf_pool_delete(big);
+}
+
+void run_pbuf_tests(void) {
+    printf("\n=== Starting Packet Buffer Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_pbuf.c");
+    RUN_TEST(test_pbuf_alloc_chains_chunks);
+    RUN_TEST(test_pbuf_header_and_trailer_in_place);
+    RUN_TEST(test_pbuf_copy_and_cat);
+    RUN_TEST(test_pbuf_refcount);
+    RUN_TEST(test_pbuf_uart_tx_sends_chain);
+    RUN_TEST(test_pbuf_uart_rx_fills_chunks);
+    RUN_TEST(test_pbuf_uart_framing_benchmark);
+
+    printf("=== Packet Buffer Tests Complete ===\n");
+}
@@ -0,0 +1,173 @@
+#include "unity.h"
+#include "perf.h"
+#include "queue.h"
+#include "allocator.h"
+#include "scheduler.h"
+#include "cli.h"
+#include "test_common.h"
+#include <string.h>
+#include <stdio.h>
+
+static uint8_t heap[8192];
+
+/* Defined here to check counters from any translation unit are collected */
+PERF_COUNTER(perf_test_events, "test.events");
+PERF_GAUGE(perf_test_level, "test.level");
+
+static void dummy_task(void *arg) {
+    (void)arg;
+}
+
+static void setUp_local(void) {
+    mock_ticks = 0;
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+    task_create(dummy_task, NULL, 512, 1);
+    task_set_current(scheduler_get_task_by_index(0));
+}
+
+static void tearDown_local(void) {
+}
+
+/* Snapshot index of a counter */
+static uint32_t perf_index(const char *name) {
+    const perf_counter_t *c = perf_find(name);
+    TEST_ASSERT_NOT_NULL(c);
+    return (uint32_t)(c - perf_get(0));
+}
+
+/* Verify counters from all modules are linked and can be looked up */
+void test_perf_registry(void) {
+    TEST_ASSERT_TRUE(perf_count() >= 10);
+    TEST_ASSERT_TRUE(perf_count() <= PERF_MAX_COUNTERS);
+    TEST_ASSERT_NULL(perf_get(perf_count()));
+    TEST_ASSERT_NULL(perf_find("no.such.counter"));
+
+    const perf_counter_t *c = perf_find("test.events");
+    TEST_ASSERT_TRUE(c == &perf_test_events);
+    TEST_ASSERT_EQUAL(PERF_KIND_COUNTER, c->kind);
+    TEST_ASSERT_EQUAL(PERF_KIND_GAUGE, perf_find("test.level")->kind);
+    TEST_ASSERT_NOT_NULL(perf_find("queue.push"));
+    TEST_ASSERT_NOT_NULL(perf_find("sched.switch"));
+    TEST_ASSERT_NOT_NULL(perf_find("mem.alloc"));
+}
+
+/* Verify queue operations are counted */
+void test_perf_counts_queue_events(void) {
+    perf_snapshot_t before;
+    perf_snapshot_t after;
+    uint8_t v = 1;
+    queue_t *q = queue_create(1, 2);
+    TEST_ASSERT_NOT_NULL(q);
+
+    perf_snapshot(&before);
+    TEST_ASSERT_EQUAL(0, queue_push_from_isr(q, &v));
+    TEST_ASSERT_EQUAL(0, queue_push(q, &v));
+    TEST_ASSERT_EQUAL(-1, queue_push_from_isr(q, &v));
+    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &v));
+    TEST_ASSERT_EQUAL(0, queue_pop(q, &v));
+    TEST_ASSERT_EQUAL(-1, queue_pop_from_isr(q, &v));
+    TEST_ASSERT_EQUAL(2, queue_push_arr_from_isr(q, "ab", 2));
+    perf_snapshot(&after);
+    perf_diff(&before, &after, &after);
+
+    TEST_ASSERT_EQUAL_UINT32(4, after.value[perf_index("queue.push")]);
+    TEST_ASSERT_EQUAL_UINT32(2, after.value[perf_index("queue.pop")]);
+    TEST_ASSERT_EQUAL_UINT32(1, after.value[perf_index("queue.full")]);
+    TEST_ASSERT_EQUAL_UINT32(1, after.value[perf_index("queue.empty")]);
+    queue_delete(q);
+}
+
+/* Verify diffs survive counter wrap and gauges report the latest value */
+void test_perf_diff_wraps_and_gauges(void) {
+    perf_snapshot_t before;
+    perf_snapshot_t after;
+    perf_snapshot_t delta;
+
+    perf_test_events.value[0] = 0xFFFFFFFEU;
+    PERF_SET(perf_test_level, 10);
+    mock_ticks = 100;
+    perf_snapshot(&before);
+
+    PERF_ADD(perf_test_events, 3);
+    PERF_INC(perf_test_events);
+    PERF_INC_LOCKED(perf_test_events);
+    PERF_SET(perf_test_level, 7);
+    mock_ticks = 350;
+    perf_snapshot(&after);
+    perf_diff(&before, &after, &delta);
+
+    TEST_ASSERT_EQUAL_UINT32(3, perf_read(&perf_test_events));
+    TEST_ASSERT_EQUAL_UINT32(5, delta.value[perf_index("test.events")]);
+    TEST_ASSERT_EQUAL_UINT32(7, delta.value[perf_index("test.level")]);
+    TEST_ASSERT_EQUAL_UINT32(250, delta.ticks);
+    TEST_ASSERT_EQUAL_UINT32(before.count, delta.count);
+}
+
+/* Verify allocator events and the used-bytes gauge */
+void test_perf_counts_allocator(void) {
+    uint32_t allocs = perf_read(perf_find("mem.alloc"));
+    uint32_t fails = perf_read(perf_find("mem.alloc_fail"));
+    uint32_t frees = perf_read(perf_find("mem.free"));
+
+    void *p = allocator_malloc(100);
+    TEST_ASSERT_NOT_NULL(p);
+    uint32_t used = perf_read(perf_find("mem.used"));
+    TEST_ASSERT_TRUE(used >= 100);
+    TEST_ASSERT_NULL(allocator_malloc(sizeof(heap) * 2));
+    allocator_free(p);
+
+    TEST_ASSERT_EQUAL_UINT32(allocs + 1, perf_read(perf_find("mem.alloc")));
+    TEST_ASSERT_EQUAL_UINT32(fails + 1, perf_read(perf_find("mem.alloc_fail")));
+    TEST_ASSERT_EQUAL_UINT32(frees + 1, perf_read(perf_find("mem.free")));
+    TEST_ASSERT_TRUE(perf_read(perf_find("mem.used")) < used);
+}
+
+/* Verify the perf command lists totals filtered by prefix */
+void test_perf_cli_totals(void) {
+    queue_t *rx_q = queue_create(1, 64);
+    queue_t *tx_q = queue_create(1, 1024);
+    char out[1024];
+    size_t n = 0;
+    char c;
+
+    cli_init("T> ", NULL, NULL);
+    cli_set_rx_queue(rx_q);
+    cli_set_tx_queue(tx_q);
+    perf_init();
+
+    perf_test_events.value[0] = 42;
+    for (const char *s = "perf test.\r"; *s; s++) {
+        queue_push_from_isr(rx_q, s);
+    }
+    if (setjmp(yield_jump) == 0) {
+        cli_task_entry(NULL);
+    }
+
+    while (n < sizeof(out) - 1 && queue_pop_from_isr(tx_q, &c) == 0) {
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    TEST_ASSERT_NOT_NULL(strstr(out, "test.events"));
+    TEST_ASSERT_NOT_NULL(strstr(out, "42"));
+    TEST_ASSERT_NOT_NULL(strstr(out, "(gauge)"));
+    TEST_ASSERT_NULL(strstr(out, "queue.push"));
+
+    queue_delete(rx_q);
+    queue_delete(tx_q);
+}
+
+void run_perf_tests(void) {
+    printf("\n=== Starting Perf Counter Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_perf.c");
+    RUN_TEST(test_perf_registry);
+    RUN_TEST(test_perf_counts_queue_events);
+    RUN_TEST(test_perf_diff_wraps_and_gauges);
+    RUN_TEST(test_perf_counts_allocator);
+    RUN_TEST(test_perf_cli_totals);
+
+    printf("=== Perf Counter Tests Complete ===\n");
+}
@@ -24,6 +24,7 @@ void test_pwm_create_should_InitHalAndSetDuty(void) {
     pwm_port_t port = pwm_create(hal_handle, 1, 1000, 50);
     TEST_ASSERT_NOT_NULL(port);
     TEST_ASSERT_EQUAL(50, mock_pwm_last_duty);
+    pwm_destroy(port);
 }
 
 void test_pwm_create_should_FailIfHalInitFails(void) {
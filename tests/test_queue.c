@@ -154,6 +154,127 @@ void test_queue_push_arr(void) {
     TEST_ASSERT_EQUAL(300, rx_val);
 }
 
+void test_queue_push_arr_from_isr_partial(void) {
+    int vals[] = {1, 2, 3, 4, 5, 6, 7};
+    int rx_val;
+
+    /* Wrap the write position first */
+    TEST_ASSERT_EQUAL(0, queue_push_from_isr(q, &vals[0]));
+    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &rx_val));
+
+    /* Capacity is 5: only part of the array fits, nothing blocks */
+    TEST_ASSERT_EQUAL(5, queue_push_arr_from_isr(q, vals, 7));
+    TEST_ASSERT_EQUAL(0, queue_push_arr_from_isr(q, &vals[5], 2));
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &rx_val));
+        TEST_ASSERT_EQUAL(vals[i], rx_val);
+    }
+    TEST_ASSERT_EQUAL(-1, queue_push_arr_from_isr(NULL, vals, 1));
+}
+
+void test_queue_overflow_drop_oldest(void) {
+    int vals[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    int rx_val;
+
+    queue_set_overflow_policy(q, QUEUE_OVERFLOW_DROP_OLDEST);
+    for (int i = 0; i < 7; i++) {
+        TEST_ASSERT_EQUAL(0, queue_push(q, &vals[i]));
+    }
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+    TEST_ASSERT_EQUAL_UINT32(2, queue_get_dropped(q));
+
+    /* Longer than the capacity: only the last five survive */
+    TEST_ASSERT_EQUAL(0, queue_push_from_isr(q, &vals[7]));
+    TEST_ASSERT_EQUAL(5, queue_push_arr_from_isr(q, &vals[5], 7));
+    TEST_ASSERT_EQUAL_UINT32(2 + 1 + 7, queue_get_dropped(q));
+
+    for (int i = 7; i < 12; i++) {
+        TEST_ASSERT_EQUAL(0, queue_pop(q, &rx_val));
+        TEST_ASSERT_EQUAL(vals[i], rx_val);
+    }
+    TEST_ASSERT_EQUAL(-1, queue_pop_from_isr(q, &rx_val));
+}
+
+void test_queue_overflow_drop_newest(void) {
+    int vals[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    int rx_val;
+
+    queue_set_overflow_policy(q, QUEUE_OVERFLOW_DROP_NEWEST);
+    TEST_ASSERT_EQUAL(0, queue_push_arr(q, vals, 4));
+    TEST_ASSERT_EQUAL(1, queue_push_arr_from_isr(q, &vals[4], 3));
+    TEST_ASSERT_EQUAL(0, queue_push(q, &vals[7]));
+    TEST_ASSERT_EQUAL(0, queue_push_from_isr(q, &vals[7]));
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+    TEST_ASSERT_EQUAL_UINT32(2 + 1 + 1, queue_get_dropped(q));
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(0, queue_pop(q, &rx_val));
+        TEST_ASSERT_EQUAL(vals[i], rx_val);
+    }
+}
+
+void test_queue_prio_urgent_jumps_ahead(void) {
+    queue_t *pq = queue_create_prio(sizeof(int), 64, 3);
+    TEST_ASSERT_NOT_NULL(pq);
+    int val, rx_val;
+
+    /* 60 telemetry items in lane 0, then an emergency stop in lane 2 */
+    for (val = 0; val < 60; val++) {
+        TEST_ASSERT_EQUAL(0, queue_push(pq, &val));
+    }
+    val = 1000;
+    TEST_ASSERT_EQUAL(0, queue_push_prio_from_isr(pq, &val, 2));
+    val = 500;
+    TEST_ASSERT_EQUAL(0, queue_push_prio(pq, &val, 1));
+
+    TEST_ASSERT_EQUAL(0, queue_peek(pq, &rx_val));
+    TEST_ASSERT_EQUAL(1000, rx_val);
+    TEST_ASSERT_EQUAL(0, queue_pop(pq, &rx_val));
+    TEST_ASSERT_EQUAL(1000, rx_val);
+    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(pq, &rx_val));
+    TEST_ASSERT_EQUAL(500, rx_val);
+
+    /* Lane 0 drains in FIFO order */
+    for (int i = 0; i < 60; i++) {
+        TEST_ASSERT_EQUAL(0, queue_pop(pq, &rx_val));
+        TEST_ASSERT_EQUAL(i, rx_val);
+    }
+    TEST_ASSERT_EQUAL(-1, queue_pop_from_isr(pq, &rx_val));
+
+    TEST_ASSERT_EQUAL(-1, queue_push_prio(pq, &val, 3));
+    TEST_ASSERT_EQUAL(-1, queue_push_prio_from_isr(pq, &val, 3));
+    TEST_ASSERT_NULL(queue_create_prio(sizeof(int), 4, 0));
+    TEST_ASSERT_NULL(queue_create_prio(sizeof(int), 4, QUEUE_MAX_LANES + 1));
+    queue_delete(pq);
+}
+
+void test_queue_prio_full_lane_blocks_alone(void) {
+    queue_t *pq = queue_create_prio(sizeof(int), 2, 2);
+    int val = 7, rx_val;
+
+    queue_push_prio_from_isr(pq, &val, 0);
+    queue_push_prio_from_isr(pq, &val, 0);
+
+    /* Lane 0 is full; lane 1 still takes items */
+    if (setjmp(yield_jump) == 0) {
+        queue_push(pq, &val);
+        TEST_FAIL_MESSAGE("Should have yielded");
+    }
+    task_t *self = (task_t*)task_get_current();
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(self));
+    TEST_ASSERT_EQUAL(0, queue_push_prio_from_isr(pq, &val, 1));
+
+    /* Room in lane 1 does not wake a lane 0 sender */
+    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(pq, &rx_val));
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(self));
+    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(pq, &rx_val));
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(self));
+
+    queue_delete(pq);
+}
+
 void run_queue_tests(void) {
     UnitySetTestFile("tests/test_queue.c");
     test_setUp_hook = setUp_queue;
@@ -170,5 +291,10 @@ void run_queue_tests(void) {
     RUN_TEST(test_queue_callback);
     RUN_TEST(test_queue_reset);
     RUN_TEST(test_queue_push_arr);
+    RUN_TEST(test_queue_push_arr_from_isr_partial);
+    RUN_TEST(test_queue_overflow_drop_oldest);
+    RUN_TEST(test_queue_overflow_drop_newest);
+    RUN_TEST(test_queue_prio_urgent_jumps_ahead);
+    RUN_TEST(test_queue_prio_full_lane_blocks_alone);
     printf("=== Queue Tests Complete ===\n");
 }
\ No newline at end of file
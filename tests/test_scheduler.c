@@ -8,6 +8,8 @@
 #include "platform.h"
 #include <stdlib.h>
 #include "test_common.h"
+#include "queue.h"
+#include "arch_ops.h"
 
 /* 
 * In this unit test harness, this function is NEVER actually executed.
@@ -226,6 +228,37 @@ void test_stack_overflow_detection_should_kill_other_task(void) {
     TEST_ASSERT_EQUAL(TASK_ZOMBIE, task_get_state_atomic(victim));
 }
 
+/* Page-aligned static stack, two pages up to 16 KB pages, for the guard page test */
+#define GUARD_TEST_STACK_SIZE   32768U
+static uint8_t guard_test_stack[GUARD_TEST_STACK_SIZE] __attribute__((aligned(16384)));
+
+void test_stack_guard_should_kill_overflowing_task(void) {
+    volatile uint8_t *bottom = guard_test_stack;
+
+    arch_stack_guard_init();
+    int32_t id = task_create_static(dummy_task, NULL, guard_test_stack, GUARD_TEST_STACK_SIZE, TASK_WEIGHT_NORMAL);
+    TEST_ASSERT_TRUE(id > 0);
+
+    /* The only user task starts, so its stack bottom is now guarded */
+    scheduler_start();
+    task_t *victim = (task_t*)task_get_current();
+    TEST_ASSERT_EQUAL(id, task_get_id(victim));
+
+    /* An overflow write faults immediately; the handler kills the task and yields */
+    if (setjmp(yield_jump) == 0) {
+        bottom[64] = 0x5A;
+        TEST_FAIL_MESSAGE("write to the guard page should have faulted");
+    }
+    TEST_ASSERT_EQUAL(1, mock_yield_count);
+    TEST_ASSERT_EQUAL(TASK_ZOMBIE, task_get_state_atomic(victim));
+
+    /* The guard was lifted on the way out */
+    bottom[64] = 0x5A;
+    TEST_ASSERT_EQUAL_HEX8(0x5A, bottom[64]);
+
+    arch_native_stack_guard_disable();
+}
+
 void test_preemption_on_time_slice_expiry(void) {
     task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
     scheduler_start();
@@ -374,6 +407,87 @@ void test_task_block_and_unblock_apis(void) {
     TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t2));
 }
 
+void test_task_block_on_records_wait_object(void) {
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    scheduler_start();
+
+    task_t *t2 = scheduler_get_task_by_index(1);
+    int obj;
+
+    task_block_on(t2, &obj);
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(t2));
+    TEST_ASSERT_EQUAL_PTR(&obj, task_get_wait_object(t2));
+
+    /* Cleared once the task is ready again */
+    task_unblock(t2);
+    TEST_ASSERT_NULL(task_get_wait_object(t2));
+    TEST_ASSERT_NULL(task_get_wait_object(NULL));
+}
+
+/* Block 'consumer' in queue_pop() as if it were running */
+static void block_in_queue_pop(task_t *consumer, queue_t *q) {
+    uint8_t item;
+    task_set_current(consumer);
+    if (setjmp(yield_jump) == 0) {
+        queue_pop(q, &item);
+    }
+    TEST_ASSERT_EQUAL(TASK_BLOCKED, task_get_state_atomic(consumer));
+}
+
+/* Verify an ISR wake-up switches to the consumer at ISR exit, not at the next tick */
+void test_isr_wakeup_preempts_at_isr_exit(void) {
+    queue_t *q = queue_create(4, 1);
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    scheduler_start();
+    task_t *consumer = scheduler_get_task_by_index(0);
+
+    /* Consumer waits for data, the CPU falls back to idle */
+    block_in_queue_pop(consumer, q);
+    schedule_next_task();
+    TEST_ASSERT_NOT_EQUAL(consumer, task_get_current());
+    TEST_ASSERT_FALSE(scheduler_yield_pending());
+
+    /* "ISR": push, then the ISR epilogue */
+    uint8_t byte = 0x5A;
+    int yielded = 0;
+    TEST_ASSERT_EQUAL(0, queue_push_from_isr(q, &byte));
+    TEST_ASSERT_TRUE(scheduler_yield_pending());
+    if (setjmp(yield_jump) == 0) {
+        scheduler_yield_from_isr();
+    } else {
+        yielded = 1;
+    }
+    /* PendSV: runs right after the ISR returns */
+    schedule_next_task();
+
+    TEST_ASSERT_EQUAL(1, yielded);
+    TEST_ASSERT_EQUAL_PTR(consumer, task_get_current());
+    TEST_ASSERT_EQUAL(TASK_RUNNING, task_get_state_atomic(consumer));
+    TEST_ASSERT_FALSE(scheduler_yield_pending());
+    TEST_ASSERT_EQUAL(0, mock_ticks);    /* No tick was needed */
+
+    queue_delete(q);
+}
+
+/* Verify a wake-up that should not preempt leaves the ISR exit a no-op */
+void test_isr_wakeup_without_preemption(void) {
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL);
+    scheduler_start();
+    task_t *running = (task_t *)task_get_current();
+    task_t *other = (running == scheduler_get_task_by_index(0)) ?
+                    scheduler_get_task_by_index(1) : scheduler_get_task_by_index(0);
+
+    /* Woken at the running task's vruntime: no reason to switch early */
+    task_block(other);
+    TEST_ASSERT_EQUAL(0, task_unblock(other));
+    TEST_ASSERT_FALSE(scheduler_yield_pending());
+    mock_yield_count = 0;
+    TEST_ASSERT_EQUAL(0, scheduler_yield_from_isr());
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+}
+
 void test_stress_task_churn(void) {
     /* 1. Fill the system with tasks until creation fails */
     int32_t ids[MAX_TASKS];
@@ -698,6 +812,7 @@ void run_scheduler_tests(void) {
     RUN_TEST(test_task_notify_wait_timeout);
     RUN_TEST(test_task_notify_simple);
     RUN_TEST(test_stack_overflow_detection_should_kill_other_task);
+    RUN_TEST(test_stack_guard_should_kill_overflowing_task);
     RUN_TEST(test_preemption_on_time_slice_expiry);
     RUN_TEST(test_sleep_list_ordering);
     RUN_TEST(test_task_notify_should_accumulate_bits_and_pending_state);
@@ -705,6 +820,9 @@ void run_scheduler_tests(void) {
     RUN_TEST(test_task_block_current_should_block_and_yield);
     RUN_TEST(test_task_exit_should_mark_zombie_and_yield);
     RUN_TEST(test_task_block_and_unblock_apis);
+    RUN_TEST(test_task_block_on_records_wait_object);
+    RUN_TEST(test_isr_wakeup_preempts_at_isr_exit);
+    RUN_TEST(test_isr_wakeup_without_preemption);
     RUN_TEST(test_stress_task_churn);
     RUN_TEST(test_stress_interleaved_sleep_wakeups);
     RUN_TEST(test_stress_vruntime_chain);
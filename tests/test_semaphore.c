@@ -6,6 +6,7 @@
 #include "allocator.h"
 #include <stdio.h>
 #include "test_common.h"
+#include <time.h>
 
 static uint8_t heap[4096];
 static task_t *t1;
@@ -36,7 +37,7 @@ static void tearDown_local(void) {
 void test_sem_init(void) {
     so_sem_t s;
     so_sem_init(&s, 5, 10);
-    TEST_ASSERT_EQUAL(5, s.count);
+    TEST_ASSERT_EQUAL(5, so_sem_get_count(&s));
     TEST_ASSERT_EQUAL(10, s.max_count);
     TEST_ASSERT_NULL(s.wait_head);
 }
@@ -47,7 +48,7 @@ void test_sem_wait_decrements_count(void) {
     so_sem_init(&s, 1, 1);
     
     so_sem_wait(&s);
-    TEST_ASSERT_EQUAL(0, s.count);
+    TEST_ASSERT_EQUAL(0, so_sem_get_count(&s));
     TEST_ASSERT_EQUAL(0, mock_yield_count);
 }
 
@@ -73,7 +74,7 @@ void test_sem_signal_increments_count(void) {
     so_sem_init(&s, 0, 5);
     
     so_sem_signal(&s);
-    TEST_ASSERT_EQUAL(1, s.count);
+    TEST_ASSERT_EQUAL(1, so_sem_get_count(&s));
 }
 
 /* Verify signal wakes up a waiting task */
@@ -87,6 +88,7 @@ void test_sem_signal_wakes_task(void) {
     node->next = NULL;
     s.wait_head = node;
     s.wait_tail = node;
+    s.state |= SO_SEM_WAITERS;
     
     task_set_state(t2, TASK_BLOCKED);
     
@@ -94,7 +96,7 @@ void test_sem_signal_wakes_task(void) {
     
     TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t2));
     TEST_ASSERT_NULL(s.wait_head);
-    TEST_ASSERT_EQUAL(1, s.count); /* Count increments */
+    TEST_ASSERT_EQUAL(1, so_sem_get_count(&s)); /* Count increments */
 }
 
 /* Verify broadcast wakes all waiting tasks */
@@ -111,6 +113,7 @@ void test_sem_broadcast_wakes_all(void) {
     
     s.wait_head = n1;
     s.wait_tail = n2;
+    s.state |= SO_SEM_WAITERS;
     
     task_set_state(t1, TASK_BLOCKED);
     task_set_state(t2, TASK_BLOCKED);
@@ -120,7 +123,7 @@ void test_sem_broadcast_wakes_all(void) {
     TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t1));
     TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t2));
     TEST_ASSERT_NULL(s.wait_head);
-    TEST_ASSERT_EQUAL(2, s.count); /* Should increment for each woken task */
+    TEST_ASSERT_EQUAL(2, so_sem_get_count(&s)); /* Should increment for each woken task */
 }
 
 /* Verify that tasks are woken up in FIFO order */
@@ -137,6 +140,7 @@ void test_sem_fifo_wake_order(void) {
     
     s.wait_head = n1;
     s.wait_tail = n2;
+    s.state |= SO_SEM_WAITERS;
     
     task_set_state(t1, TASK_BLOCKED);
     task_set_state(t2, TASK_BLOCKED);
@@ -152,6 +156,69 @@ void test_sem_fifo_wake_order(void) {
     TEST_ASSERT_NULL(s.wait_head);
 }
 
+/* Verify a waiter sets the waiters flag and the wake-up clears it */
+void test_sem_waiters_flag(void) {
+    so_sem_t s;
+    so_sem_init(&s, 0, 1);
+
+    if (setjmp(yield_jump) == 0) {
+        so_sem_wait(&s);
+        TEST_FAIL_MESSAGE("sem_wait should have yielded/blocked");
+    }
+    TEST_ASSERT_EQUAL_UINT32(SO_SEM_WAITERS, s.state);
+
+    /* Signal sees the flag, wakes T1 and leaves the token for it */
+    task_set_current(t2);
+    so_sem_signal(&s);
+    TEST_ASSERT_EQUAL_UINT32(SO_SEM_COUNT_ONE, s.state);
+    TEST_ASSERT_EQUAL(TASK_READY, task_get_state_atomic(t1));
+
+    /* T1 resumes in the wait loop and takes it */
+    task_set_current(t1);
+    so_sem_wait(&s);
+    TEST_ASSERT_EQUAL_UINT32(0, s.state);
+}
+
+/* Verify the fast signal path caps at max_count */
+void test_sem_signal_caps_at_max(void) {
+    so_sem_t s;
+    so_sem_init(&s, 1, 2);
+
+    so_sem_signal(&s);
+    so_sem_signal(&s);
+    TEST_ASSERT_EQUAL(2, so_sem_get_count(&s));
+    so_sem_broadcast(&s);
+    TEST_ASSERT_EQUAL(2, so_sem_get_count(&s));
+}
+
+#define BENCH_PAIRS 1000000
+
+/* Report the cost of an uncontended wait/signal pair on the host */
+void test_sem_uncontended_benchmark(void) {
+    so_sem_t s;
+    struct timespec t0, t1_;
+
+    so_sem_init(&s, 1, 1);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0; i < BENCH_PAIRS; i++) {
+        so_sem_wait(&s);
+        so_sem_signal(&s);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1_);
+
+    uint64_t ns = (uint64_t)(t1_.tv_sec - t0.tv_sec) * 1000000000ULL +
+                  (uint64_t)(t1_.tv_nsec - t0.tv_nsec);
+    printf("Semaphore wait/signal pair (uncontended): %llu.%02llu ns\n",
+           (unsigned long long)(ns / BENCH_PAIRS),
+           (unsigned long long)((ns % BENCH_PAIRS) * 100U / BENCH_PAIRS));
+
+    TEST_ASSERT_EQUAL(1, so_sem_get_count(&s));
+    TEST_ASSERT_EQUAL(0, mock_yield_count);
+#if SPINLOCK_STATS
+    TEST_ASSERT_EQUAL_UINT32(0, s.lock.stats.acquires);
+#endif
+}
+
 void run_semaphore_tests(void) {
     printf("\n=== Starting Semaphore Tests ===\n");
 
@@ -166,6 +233,9 @@ void run_semaphore_tests(void) {
     RUN_TEST(test_sem_signal_wakes_task);
     RUN_TEST(test_sem_broadcast_wakes_all);
     RUN_TEST(test_sem_fifo_wake_order);
+    RUN_TEST(test_sem_waiters_flag);
+    RUN_TEST(test_sem_signal_caps_at_max);
+    RUN_TEST(test_sem_uncontended_benchmark);
     
     printf("=== Semaphore Tests Complete ===\n");
 }
\ No newline at end of file
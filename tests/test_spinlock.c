@@ -0,0 +1,227 @@
+#include "unity.h"
+#include "spinlock.h"
+#include "queue.h"
+#include "allocator.h"
+#include "platform_config.h"
+#include "test_common.h"
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+static uint8_t heap[4096];
+static spinlock_t lock_a;
+static spinlock_t lock_b;
+
+/* Priority of a motor-control fault ISR that must never wait for the kernel */
+#define TEST_FAULT_IRQ_PRIORITY  2
+
+static void setUp_local(void) {
+    arch_native_primask = 0;
+    arch_native_basepri = 0;
+    spinlock_init(&lock_a);
+    spinlock_init(&lock_b);
+    allocator_init(heap, sizeof(heap));
+}
+
+static void tearDown_local(void) {
+    mock_cycles_step = 0;
+}
+
+/* Verify spin_lock() masks only the interrupts at or below the ceiling */
+void test_spin_lock_masks_up_to_ceiling(void) {
+    uint32_t fault = IRQ_PRIORITY_ZERO_LATENCY(TEST_FAULT_IRQ_PRIORITY);
+    uint32_t uart = IRQ_PRIORITY_KERNEL(USART2_IRQ_PRIORITY);
+
+    TEST_ASSERT_TRUE(arch_native_irq_enabled(uart));
+
+    uint32_t flags = spin_lock(&lock_a);
+    TEST_ASSERT_TRUE(arch_native_irq_enabled(fault));
+    TEST_ASSERT_TRUE(arch_native_irq_enabled(MAX_SYSCALL_PRIORITY - 1));
+    TEST_ASSERT_FALSE(arch_native_irq_enabled(MAX_SYSCALL_PRIORITY));
+    TEST_ASSERT_FALSE(arch_native_irq_enabled(uart));
+    TEST_ASSERT_FALSE(arch_native_irq_enabled(SYSTICK_PRIORITY));
+    TEST_ASSERT_FALSE(arch_native_irq_enabled(PENDSV_PRIORITY));
+    spin_unlock(&lock_a, flags);
+
+    TEST_ASSERT_TRUE(arch_native_irq_enabled(uart));
+    TEST_ASSERT_EQUAL_UINT32(0, arch_native_basepri);
+}
+
+/* Verify nesting keeps the mask until the outermost unlock, and never lowers it */
+void test_spin_lock_nesting_restores_mask(void) {
+    uint32_t outer = spin_lock(&lock_a);
+    uint32_t inner = spin_lock(&lock_b);
+    spin_unlock(&lock_b, inner);
+    TEST_ASSERT_FALSE(arch_native_irq_enabled(SYSTICK_PRIORITY));
+    spin_unlock(&lock_a, outer);
+    TEST_ASSERT_TRUE(arch_native_irq_enabled(SYSTICK_PRIORITY));
+
+    /* Inside a stricter section (BASEPRI at priority 2), the kernel lock must not open it up */
+    arch_native_basepri = 2U << (8U - NVIC_PRIO_BITS);
+    outer = spin_lock(&lock_a);
+    TEST_ASSERT_FALSE(arch_native_irq_enabled(TEST_FAULT_IRQ_PRIORITY));
+    spin_unlock(&lock_a, outer);
+    TEST_ASSERT_EQUAL_UINT32(2U << (8U - NVIC_PRIO_BITS), arch_native_basepri);
+
+    /* PRIMASK still masks everything */
+    arch_native_basepri = 0;
+    uint32_t state = arch_irq_lock();
+    TEST_ASSERT_FALSE(arch_native_irq_enabled(0));
+    arch_irq_unlock(state);
+    TEST_ASSERT_TRUE(arch_native_irq_enabled(0));
+}
+
+/* Verify kernel calls leave the mask balanced */
+void test_kernel_calls_leave_mask_balanced(void) {
+    queue_t *q = queue_create(2, 1);
+    uint8_t v = 7;
+
+    TEST_ASSERT_NOT_NULL(q);
+    TEST_ASSERT_EQUAL(0, queue_push_from_isr(q, &v));
+    TEST_ASSERT_EQUAL(0, queue_pop_from_isr(q, &v));
+    queue_delete(q);
+
+    TEST_ASSERT_EQUAL_UINT32(0, arch_native_basepri);
+    TEST_ASSERT_EQUAL_UINT32(0, arch_native_primask);
+}
+
+/* Verify tickets are handed out and served in order */
+void test_ticket_lock_serves_in_order(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, spin_ticket_acquire(&lock_a));
+    TEST_ASSERT_EQUAL_UINT32(1, lock_a.next);
+    TEST_ASSERT_EQUAL_UINT32(0, lock_a.owner);
+
+    /* A second taker would hold ticket 1 and wait for owner == 1 */
+    spin_ticket_release(&lock_a);
+    TEST_ASSERT_EQUAL_UINT32(1, lock_a.owner);
+    TEST_ASSERT_EQUAL_UINT32(0, spin_ticket_acquire(&lock_a));
+    spin_ticket_release(&lock_a);
+    TEST_ASSERT_EQUAL_UINT32(lock_a.next, lock_a.owner);
+
+    /* Counters wrap without breaking the comparison */
+    lock_b.next = lock_b.owner = 0xFFFFFFFFU;
+    TEST_ASSERT_EQUAL_UINT32(0, spin_ticket_acquire(&lock_b));
+    spin_ticket_release(&lock_b);
+    TEST_ASSERT_EQUAL_UINT32(0, lock_b.owner);
+}
+
+#if SPINLOCK_STATS
+/* Verify acquire counts, hold time and the registry */
+void test_spinlock_stats_record_hold_time(void) {
+    mock_cycles_step = 10;
+    uint32_t flags = spin_lock(&lock_a);
+    spin_unlock(&lock_a, flags);
+    flags = spin_lock(&lock_a);
+    mock_cycles_step = 500;
+    spin_unlock(&lock_a, flags);
+
+    TEST_ASSERT_EQUAL_UINT32(2, lock_a.stats.acquires);
+    TEST_ASSERT_EQUAL_UINT32(0, lock_a.stats.contended);
+    TEST_ASSERT_TRUE(lock_a.stats.max_hold >= 500U);   /* IRQPROF reads the counter too */
+
+    /* A wait is charged as contention */
+    spinlock_stats_acquired(&lock_b, 1234);
+    spinlock_stats_released(&lock_b);
+    TEST_ASSERT_EQUAL_UINT32(1, lock_b.stats.contended);
+    TEST_ASSERT_EQUAL_UINT32(1234, lock_b.stats.max_spin);
+    TEST_ASSERT_TRUE(lock_b.stats.spin_cycles == 1234U);
+
+    /* Registered locks are cleared by a reset */
+    TEST_ASSERT_EQUAL(0, spinlock_stats_register(&lock_a, "test.a"));
+    TEST_ASSERT_EQUAL(0, spinlock_stats_register(&lock_a, "test.a2"));
+    spinlock_stats_reset();
+    TEST_ASSERT_EQUAL_UINT32(0, lock_a.stats.acquires);
+    TEST_ASSERT_EQUAL_UINT32(0, lock_a.stats.max_hold);
+}
+#endif
+
+/* ##### Native multithreaded stress benchmark ##### */
+
+#define STRESS_THREADS      4
+#define STRESS_ITERATIONS   20000
+
+static spinlock_t stress_lock;
+static volatile uint32_t stress_counter;
+static pthread_barrier_t stress_start;
+
+/* Hammer the lock word; the read-modify-write only stays exact under the lock */
+static void *stress_worker(void *arg) {
+    uint32_t *acquired = arg;
+    pthread_barrier_wait(&stress_start);
+    for (uint32_t i = 0; i < STRESS_ITERATIONS; i++) {
+        uint32_t waited = spin_ticket_acquire(&stress_lock);
+#if SPINLOCK_STATS
+        spinlock_stats_acquired(&stress_lock, waited);
+#endif
+        (void)waited;
+        uint32_t v = stress_counter;
+        stress_counter = v + 1U;
+        (*acquired)++;
+#if SPINLOCK_STATS
+        spinlock_stats_released(&stress_lock);
+#endif
+        spin_ticket_release(&stress_lock);
+    }
+    return NULL;
+}
+
+/* Verify mutual exclusion under real threads and report contention */
+void test_ticket_lock_threaded_stress(void) {
+    pthread_t threads[STRESS_THREADS];
+    uint32_t acquired[STRESS_THREADS] = {0};
+    struct timespec t0, t1;
+
+    spinlock_init(&stress_lock);
+    stress_counter = 0;
+    pthread_barrier_init(&stress_start, NULL, STRESS_THREADS + 1);
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, stress_worker, &acquired[i]));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    pthread_barrier_wait(&stress_start);
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    pthread_barrier_destroy(&stress_start);
+
+    uint64_t ns = (uint64_t)(t1.tv_sec - t0.tv_sec) * 1000000000ULL +
+                  (uint64_t)(t1.tv_nsec - t0.tv_nsec);
+#if SPINLOCK_STATS
+    const spinlock_stats_t *st = &stress_lock.stats;
+    printf("Ticket lock, %d threads x %d: %llu ns/acquire, %u contended, "
+           "spin max %u ns, hold max %u ns\n",
+           STRESS_THREADS, STRESS_ITERATIONS,
+           (unsigned long long)(ns / ((uint64_t)STRESS_THREADS * STRESS_ITERATIONS)),
+           st->contended, st->max_spin, st->max_hold);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_THREADS * STRESS_ITERATIONS, st->acquires);
+#else
+    printf("Ticket lock, %d threads x %d: %llu ns/acquire\n",
+           STRESS_THREADS, STRESS_ITERATIONS,
+           (unsigned long long)(ns / ((uint64_t)STRESS_THREADS * STRESS_ITERATIONS)));
+#endif
+
+    TEST_ASSERT_EQUAL_UINT32(STRESS_THREADS * STRESS_ITERATIONS, stress_counter);
+    TEST_ASSERT_EQUAL_UINT32(stress_lock.next, stress_lock.owner);
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        TEST_ASSERT_EQUAL_UINT32(STRESS_ITERATIONS, acquired[i]);
+    }
+}
+
+void run_spinlock_tests(void) {
+    printf("\n=== Starting Spinlock Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_spinlock.c");
+    RUN_TEST(test_spin_lock_masks_up_to_ceiling);
+    RUN_TEST(test_spin_lock_nesting_restores_mask);
+    RUN_TEST(test_kernel_calls_leave_mask_balanced);
+    RUN_TEST(test_ticket_lock_serves_in_order);
+#if SPINLOCK_STATS
+    RUN_TEST(test_spinlock_stats_record_hold_time);
+#endif
+    RUN_TEST(test_ticket_lock_threaded_stress);
+
+    printf("=== Spinlock Tests Complete ===\n");
+}
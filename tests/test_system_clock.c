@@ -0,0 +1,156 @@
+#include "unity.h"
+#include "system_clock.h"
+#include "clock_sim.h"
+#include "test_common.h"
+#include <stdio.h>
+
+#define CLOCK_OPP_HZ(i)     (system_clock_get_opp(i)->hz)
+
+/* Start each test from the reset registers, with the sequencer resynchronised */
+static void setUp_local(void) {
+    clock_sim_reset();
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_config_hz(SYSCLOCK_HZ_4MHZ));
+}
+
+static void tearDown_local(void) {
+    clock_sim_reset();
+}
+
+/* The model must agree with what the sequencer thinks it programmed */
+static void assert_clock_at(uint32_t hz) {
+    const sysclock_opp_t *opp = system_clock_find_opp(hz);
+    TEST_ASSERT_NOT_NULL(opp);
+    TEST_ASSERT_EQUAL_UINT32(hz, get_system_clock_hz());
+    TEST_ASSERT_EQUAL_UINT32(hz, clock_sim_get_sysclk_hz());
+    TEST_ASSERT_EQUAL(opp->source, clock_sim_get_source());
+    TEST_ASSERT_EQUAL(opp->vos, clock_sim_get_vos());
+    TEST_ASSERT_EQUAL(opp->vos, system_clock_get_vos());
+    TEST_ASSERT_EQUAL_UINT32(system_clock_flash_latency(hz, opp->vos), clock_sim_get_flash_latency());
+    TEST_ASSERT_EQUAL_UINT32(clock_sim_get_flash_latency(), system_clock_get_flash_latency());
+}
+
+static void assert_no_violations(void) {
+    clock_sim_stats_t stats;
+    clock_sim_get_stats(&stats);
+    TEST_ASSERT_EQUAL_MESSAGE(0, stats.violations, clock_sim_last_violation());
+}
+
+/* Verify the wait state table for both voltage ranges */
+void test_system_clock_flash_latency_table(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, system_clock_flash_latency(16000000UL, SYSTEM_VOS1));
+    TEST_ASSERT_EQUAL_UINT32(1, system_clock_flash_latency(32000000UL, SYSTEM_VOS1));
+    TEST_ASSERT_EQUAL_UINT32(4, system_clock_flash_latency(80000000UL, SYSTEM_VOS1));
+    TEST_ASSERT_EQUAL_UINT32(0, system_clock_flash_latency(4000000UL, SYSTEM_VOS2));
+    TEST_ASSERT_EQUAL_UINT32(2, system_clock_flash_latency(16000000UL, SYSTEM_VOS2));
+    TEST_ASSERT_EQUAL_UINT32(3, system_clock_flash_latency(24000000UL, SYSTEM_VOS2));
+}
+
+/* Verify every transition between operating points follows the sequencing rules */
+void test_system_clock_switch_all_pairs(void) {
+    size_t count = system_clock_opp_count();
+
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < count; j++) {
+            TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(CLOCK_OPP_HZ(i)));
+            assert_clock_at(CLOCK_OPP_HZ(i));
+            TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(CLOCK_OPP_HZ(j)));
+            assert_clock_at(CLOCK_OPP_HZ(j));
+        }
+    }
+    assert_no_violations();
+}
+
+/* Verify retuning the PLL runs from HSI16 while the PLL relocks */
+void test_system_clock_pll_retune_bridges_on_hsi16(void) {
+    clock_sim_stats_t before, after;
+
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(80000000UL));
+    clock_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(48000000UL));
+    clock_sim_get_stats(&after);
+
+    assert_clock_at(48000000UL);
+    TEST_ASSERT_EQUAL(2, after.switches - before.switches);     /* PLL -> HSI16 -> PLL */
+    TEST_ASSERT_EQUAL(1, after.pll_locks - before.pll_locks);
+    TEST_ASSERT_EQUAL(0, after.vos_changes - before.vos_changes);
+    assert_no_violations();
+}
+
+/* Verify oscillators SYSCLK no longer needs are turned off */
+void test_system_clock_releases_unused_oscillators(void) {
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(80000000UL));
+    TEST_ASSERT_TRUE(clock_sim_osc_on(SYSCLK_SRC_PLL));
+    TEST_ASSERT_TRUE(clock_sim_osc_on(SYSCLK_SRC_HSI16));
+
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(16000000UL));
+    TEST_ASSERT_FALSE(clock_sim_osc_on(SYSCLK_SRC_PLL));
+    TEST_ASSERT_TRUE(clock_sim_osc_on(SYSCLK_SRC_HSI16));
+
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(4000000UL));
+    TEST_ASSERT_FALSE(clock_sim_osc_on(SYSCLK_SRC_PLL));
+    TEST_ASSERT_FALSE(clock_sim_osc_on(SYSCLK_SRC_HSI16));
+    TEST_ASSERT_TRUE(clock_sim_osc_on(SYSCLK_SRC_MSI));
+}
+
+/* Verify a frequency outside the table is refused without touching the clock */
+void test_system_clock_rejects_unknown_frequency(void) {
+    clock_sim_stats_t before, after;
+
+    clock_sim_get_stats(&before);
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_ERR_UNSUPPORTED, system_clock_switch(8000000UL));
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_ERR_UNSUPPORTED, system_clock_config_hz((sysclock_hz_t)100000000UL));
+    clock_sim_get_stats(&after);
+
+    assert_clock_at(4000000UL);
+    TEST_ASSERT_EQUAL(before.switches, after.switches);
+    TEST_ASSERT_EQUAL(before.latency_changes, after.latency_changes);
+}
+
+/* Verify a PLL that never locks leaves a safe clock, and the next switch recovers */
+void test_system_clock_pll_lock_timeout_recovers(void) {
+    clock_sim_inject_fault(CLOCK_SIM_FAULT_PLL_LOCK);
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_ERR_TIMEOUT, system_clock_switch(80000000UL));
+    TEST_ASSERT_EQUAL_UINT32(clock_sim_get_sysclk_hz(), get_system_clock_hz());
+    TEST_ASSERT_EQUAL(SYSCLK_SRC_MSI, clock_sim_get_source());
+    assert_no_violations();
+
+    clock_sim_inject_fault(CLOCK_SIM_FAULT_NONE);
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(80000000UL));
+    assert_clock_at(80000000UL);
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(4000000UL));
+    assert_clock_at(4000000UL);
+    assert_no_violations();
+}
+
+/* Verify a regulator that never settles going down is raised again on the way up */
+void test_system_clock_vos_timeout_recovers(void) {
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(80000000UL));
+
+    clock_sim_inject_fault(CLOCK_SIM_FAULT_VOS_READY);
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_ERR_TIMEOUT, system_clock_switch(24000000UL));
+    TEST_ASSERT_EQUAL_UINT32(24000000UL, clock_sim_get_sysclk_hz());
+    TEST_ASSERT_EQUAL(SYSTEM_VOS1, clock_sim_get_vos());
+    assert_no_violations();
+
+    clock_sim_inject_fault(CLOCK_SIM_FAULT_NONE);
+    TEST_ASSERT_EQUAL(SYSTEM_CLOCK_OK, system_clock_switch(64000000UL));
+    assert_clock_at(64000000UL);
+    assert_no_violations();
+}
+
+void run_system_clock_tests(void) {
+    printf("\n=== Starting System Clock Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_system_clock.c");
+    RUN_TEST(test_system_clock_flash_latency_table);
+    RUN_TEST(test_system_clock_switch_all_pairs);
+    RUN_TEST(test_system_clock_pll_retune_bridges_on_hsi16);
+    RUN_TEST(test_system_clock_releases_unused_oscillators);
+    RUN_TEST(test_system_clock_rejects_unknown_frequency);
+    RUN_TEST(test_system_clock_pll_lock_timeout_recovers);
+    RUN_TEST(test_system_clock_vos_timeout_recovers);
+
+    printf("=== System Clock Tests Complete ===\n");
+}
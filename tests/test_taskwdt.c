@@ -0,0 +1,153 @@
+#include "unity.h"
+#include "taskwdt.h"
+#include "scheduler.h"
+#include "allocator.h"
+#include "timer.h"
+#include "queue.h"
+#include "watchdog_hal.h"
+#include "mock_drivers.h"
+#include "test_common.h"
+#include <stdio.h>
+
+static uint8_t heap[16384];
+static task_t *worker_a;
+static task_t *worker_b;
+
+static void dummy_task(void *arg) {
+    (void)arg;
+}
+
+/* Look up a task handle by ID */
+static task_t *find_task(int32_t id) {
+    for (uint32_t i = 0; i < MAX_TASKS; i++) {
+        task_t *t = scheduler_get_task_by_index(i);
+        if (t && task_get_state_atomic(t) != TASK_UNUSED && task_get_id(t) == (uint16_t)id) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+static void setUp_local(void) {
+    mock_drivers_reset();
+    mock_ticks = 0;
+    allocator_init(heap, sizeof(heap));
+    scheduler_init();
+    timer_service_init(4);
+    worker_a = find_task(task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL));
+    worker_b = find_task(task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL));
+    TEST_ASSERT_EQUAL(0, taskwdt_init(1000));
+}
+
+static void tearDown_local(void) {
+    task_set_current(NULL);
+}
+
+/* Register the given task as if it called taskwdt_register() itself */
+static int register_as(task_t *t, uint32_t period) {
+    task_set_current(t);
+    return taskwdt_register(period);
+}
+
+/* Verify the hardware watchdog is kicked while every task checks in */
+void test_taskwdt_kicks_when_healthy(void) {
+    int a = register_as(worker_a, 100);
+    int b = register_as(worker_b, 200);
+    TEST_ASSERT_TRUE(a >= 0 && b >= 0 && a != b);
+    TEST_ASSERT_EQUAL_UINT32(1000, mock_watchdog_init_timeout_arg);
+
+    for (int i = 0; i < 10; i++) {
+        mock_ticks += 90;
+        taskwdt_checkin(a);
+        taskwdt_checkin(b);
+        TEST_ASSERT_EQUAL_UINT32(0, taskwdt_check());
+    }
+    TEST_ASSERT_EQUAL(10, mock_watchdog_kick_called);
+    TEST_ASSERT_FALSE(watchdog_hal_expired());
+}
+
+/* Verify one silent task stops the kick and is reported after the reset */
+void test_taskwdt_stall_records_task(void) {
+    queue_t *q = queue_create(4, 1);
+    int a = register_as(worker_a, 100);
+    int b = register_as(worker_b, 200);
+    task_block_on(worker_b, q);
+
+    mock_ticks = 150;
+    taskwdt_checkin(a);
+    TEST_ASSERT_EQUAL_UINT32(0, taskwdt_check());
+    TEST_ASSERT_EQUAL(1, mock_watchdog_kick_called);
+
+    mock_ticks = 250;
+    taskwdt_checkin(a);
+    TEST_ASSERT_EQUAL_UINT32(1, taskwdt_check());
+
+    /* Kicking stays off, even if the task recovers */
+    taskwdt_checkin(a);
+    taskwdt_checkin(b);
+    mock_ticks = 300;
+    taskwdt_check();
+    TEST_ASSERT_EQUAL(1, mock_watchdog_kick_called);
+
+    /* The simulated IWDG expires one timeout after the last kick */
+    mock_ticks = 1149;
+    TEST_ASSERT_FALSE(watchdog_hal_expired());
+    mock_ticks = 1150;
+    TEST_ASSERT_TRUE(watchdog_hal_expired());
+
+    /* "Reset": the record is read back from retained RAM */
+    TEST_ASSERT_NULL(taskwdt_last_stall());
+    TEST_ASSERT_EQUAL(0, taskwdt_init(1000));
+    const taskwdt_record_t *r = taskwdt_last_stall();
+    TEST_ASSERT_NOT_NULL(r);
+    TEST_ASSERT_EQUAL_UINT16(task_get_id(worker_b), r->task_id);
+    TEST_ASSERT_EQUAL_UINT8(TASK_BLOCKED, r->state);
+    TEST_ASSERT_EQUAL_PTR(q, (void *)r->wait_obj);
+    TEST_ASSERT_EQUAL_UINT32(200, r->period);
+    TEST_ASSERT_EQUAL_UINT32(250, r->silent);
+    TEST_ASSERT_EQUAL_UINT32(250, r->uptime);
+    TEST_ASSERT_EQUAL_UINT8(1, r->stalled);
+
+    /* Consumed: a second reset without a stall reports nothing */
+    TEST_ASSERT_EQUAL(0, taskwdt_init(1000));
+    TEST_ASSERT_NULL(taskwdt_last_stall());
+    queue_delete(q);
+}
+
+/* Verify registration limits and errors */
+void test_taskwdt_register_errors(void) {
+    task_set_current(NULL);
+    TEST_ASSERT_EQUAL(TASKWDT_ERR_PARAM, taskwdt_register(100));
+    TEST_ASSERT_EQUAL(TASKWDT_ERR_PARAM, register_as(worker_a, 0));
+
+    /* Registering again updates the same slot */
+    int a = register_as(worker_a, 100);
+    TEST_ASSERT_EQUAL(a, register_as(worker_a, 500));
+    mock_ticks = 400;
+    TEST_ASSERT_EQUAL_UINT32(0, taskwdt_check());
+
+    TEST_ASSERT_EQUAL(0, taskwdt_unregister(a));
+    TEST_ASSERT_EQUAL(TASKWDT_ERR_PARAM, taskwdt_unregister(a));
+    TEST_ASSERT_EQUAL(TASKWDT_ERR_PARAM, taskwdt_unregister(TASKWDT_MAX_TASKS));
+
+    /* One slot per task */
+    for (int i = 0; i < TASKWDT_MAX_TASKS; i++) {
+        task_t *t = find_task(task_create(dummy_task, NULL, 512, TASK_WEIGHT_NORMAL));
+        TEST_ASSERT_NOT_NULL(t);
+        TEST_ASSERT_TRUE(register_as(t, 100) >= 0);
+    }
+    TEST_ASSERT_EQUAL(TASKWDT_ERR_FULL, register_as(worker_b, 100));
+}
+
+void run_taskwdt_tests(void) {
+    printf("\n=== Starting Task Watchdog Tests ===\n");
+
+    test_setUp_hook = setUp_local;
+    test_tearDown_hook = tearDown_local;
+    UnitySetTestFile("tests/test_taskwdt.c");
+    RUN_TEST(test_taskwdt_kicks_when_healthy);
+    RUN_TEST(test_taskwdt_stall_records_task);
+    RUN_TEST(test_taskwdt_register_errors);
+
+    printf("=== Task Watchdog Tests Complete ===\n");
+}
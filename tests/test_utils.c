@@ -88,6 +88,60 @@ void test_wait_for_reg_mask_eq_success(void) {
     TEST_ASSERT_EQUAL(0, res);
 }
 
+/* Verify utils_crc32 against the standard check value and chaining */
+void test_utils_crc32(void) {
+    const char *check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926U, utils_crc32(0, check, 9));
+
+    /* Continuing across two buffers must match a single pass */
+    uint32_t crc = utils_crc32(0, check, 4);
+    crc = utils_crc32(crc, check + 4, 5);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926U, crc);
+
+    TEST_ASSERT_EQUAL_HEX32(0, utils_crc32(0, check, 0));
+}
+
+void test_utils_fnv1a(void) {
+    TEST_ASSERT_EQUAL_HEX32(0x811C9DC5U, utils_fnv1a("", 0));
+    TEST_ASSERT_EQUAL_HEX32(0xE40C292CU, utils_fnv1a("a", 1));
+    TEST_ASSERT_EQUAL_HEX32(0xBF9CF968U, utils_fnv1a("foobar", 6));
+}
+
+void test_utils_cobs_round_trip(void) {
+    uint8_t in[600];
+    uint8_t enc[600 + 600 / 254 + 2];
+    uint8_t dec[sizeof(enc)];
+
+    /* Zeros, a run longer than 254 and a trailing zero */
+    for (uint32_t i = 0; i < sizeof(in); i++) {
+        in[i] = (i % 100U == 0U) ? 0U : (uint8_t)i;
+    }
+    for (uint32_t i = 300; i < 560; i++) {
+        in[i] = 0x55;
+    }
+    in[sizeof(in) - 1U] = 0;
+
+    size_t n = utils_cobs_encode(in, sizeof(in), enc);
+    TEST_ASSERT_EQUAL(0, enc[n - 1U]);
+    for (size_t i = 0; i + 1U < n; i++) {
+        TEST_ASSERT_TRUE(enc[i] != 0U);
+    }
+    TEST_ASSERT_EQUAL((int32_t)sizeof(in), utils_cobs_decode(enc, n - 1U, dec));
+    TEST_ASSERT_EQUAL_MEMORY(in, dec, sizeof(in));
+
+    /* In place */
+    TEST_ASSERT_EQUAL((int32_t)sizeof(in), utils_cobs_decode(enc, n - 1U, enc));
+    TEST_ASSERT_EQUAL_MEMORY(in, enc, sizeof(in));
+
+    /* Empty input is a single code byte */
+    TEST_ASSERT_EQUAL(2, utils_cobs_encode(in, 0, enc));
+    TEST_ASSERT_EQUAL(0, utils_cobs_decode(enc, 1, dec));
+
+    /* A code that runs past the end is rejected */
+    enc[0] = 5; enc[1] = 1;
+    TEST_ASSERT_EQUAL(-1, utils_cobs_decode(enc, 2, dec));
+}
+
 void run_utils_tests(void) {
     printf("\n=== Starting Utils Tests ===\n");
     test_setUp_hook = setUp_local;
@@ -103,6 +157,9 @@ void run_utils_tests(void) {
     RUN_TEST(test_wait_for_flag_set_timeout);
     RUN_TEST(test_wait_for_flag_clear_success);
     RUN_TEST(test_wait_for_reg_mask_eq_success);
+    RUN_TEST(test_utils_crc32);
+    RUN_TEST(test_utils_fnv1a);
+    RUN_TEST(test_utils_cobs_round_trip);
     
     printf("=== Utils Tests Complete ===\n");
 }
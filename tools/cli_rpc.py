@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Run soRTOS CLI commands over the binary RPC framing.
+
+Frames share the console with normal text: each starts with 0xA5 and is
+COBS encoded up to a 0x00 delimiter, so text output in between is skipped.
+A command is addressed by the FNV-1a hash of its name and returns the
+handler's exit code and captured output.
+
+Usage:
+    cli_rpc.py /dev/ttyACM0 list
+    cli_rpc.py /dev/ttyACM0 kv get boot_count
+    cli_rpc.py --exec build/native/soRTOS.elf top
+"""
+
+import argparse
+import os
+import select
+import struct
+import subprocess
+import sys
+import time
+import zlib
+
+SOF = 0xA5
+LIST_ID = 0
+
+STATUS = {
+    0: "ok", -1: "error", -2: "unknown command", -3: "output truncated",
+    -4: "bad arguments", -5: "busy", -6: "bad CRC",
+}
+
+
+def fnv1a(data):
+    h = 0x811C9DC5
+    for b in data:
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out += bytes([len(block) + 1]) + block
+            block.clear()
+            continue
+        block.append(b)
+        if len(block) == 254:
+            out += b"\xff" + block
+            block.clear()
+    out += bytes([len(block) + 1]) + block + b"\0"
+    return bytes(out)
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0:
+            raise ValueError("zero byte inside COBS frame")
+        out += frame[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def build_request(seq, cmd_id, args):
+    payload = struct.pack("<BIB", seq, cmd_id, len(args))
+    for a in args:
+        if len(a) > 255:
+            raise ValueError("argument longer than 255 bytes")
+        payload += bytes([len(a)]) + a
+    body = struct.pack("<H", len(payload)) + payload
+    body += struct.pack("<I", zlib.crc32(body))
+    return bytes([SOF]) + cobs_encode(body)
+
+
+def parse_response(frame):
+    body = cobs_decode(frame)
+    length, = struct.unpack_from("<H", body, 0)
+    if len(body) != 2 + length + 4 or length < 6:
+        raise ValueError("bad frame length")
+    crc, = struct.unpack_from("<I", body, 2 + length)
+    if zlib.crc32(body[:2 + length]) != crc:
+        raise ValueError("bad CRC")
+    seq, status, ret = struct.unpack_from("<BbI", body, 2)
+    if ret & 0x80000000:
+        ret -= 1 << 32
+    return seq, status, ret, body[8:2 + length]
+
+
+class Link:
+    """Byte link to the target: a serial device or a spawned native build."""
+
+    def __init__(self, device=None, exe=None):
+        self.proc = None
+        if exe:
+            self.proc = subprocess.Popen([exe], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+            self.rfd = self.proc.stdout.fileno()
+            self.wfd = self.proc.stdin.fileno()
+        else:
+            import termios
+            import tty
+            self.rfd = self.wfd = os.open(device, os.O_RDWR | os.O_NOCTTY)
+            tty.setraw(self.rfd)
+            attrs = termios.tcgetattr(self.rfd)
+            attrs[6][termios.VMIN] = 0
+            attrs[6][termios.VTIME] = 1
+            termios.tcsetattr(self.rfd, termios.TCSANOW, attrs)
+
+    def write(self, data):
+        os.write(self.wfd, data)
+
+    def read(self, timeout):
+        ready, _, _ = select.select([self.rfd], [], [], timeout)
+        return os.read(self.rfd, 256) if ready else b""
+
+    def close(self):
+        if self.proc:
+            self.proc.kill()
+            self.proc.wait()
+        else:
+            os.close(self.rfd)
+
+
+class Client:
+    def __init__(self, link, timeout=2.0):
+        self.link = link
+        self.timeout = timeout
+        self.seq = 0
+        self.rx = bytearray()
+
+    def _frame(self):
+        """Return the next response frame, skipping console text."""
+        deadline = time.monotonic() + self.timeout
+        while True:
+            start = self.rx.find(bytes([SOF]))
+            if start >= 0:
+                end = self.rx.find(b"\0", start)
+                if end >= 0:
+                    frame = bytes(self.rx[start + 1:end])
+                    del self.rx[:end + 1]
+                    return frame
+            left = deadline - time.monotonic()
+            if left <= 0:
+                raise TimeoutError("no response")
+            self.rx += self.link.read(left)
+
+    def call(self, cmd_id, args=()):
+        """Run a command by ID; returns (status, ret, output)."""
+        self.seq = (self.seq + 1) & 0xFF
+        self.link.write(build_request(self.seq, cmd_id, [a.encode() for a in args]))
+        while True:
+            seq, status, ret, out = parse_response(self._frame())
+            if seq == self.seq or status == -6:
+                return status, ret, out
+
+    def run(self, name, *args):
+        return self.call(fnv1a(name.encode()), args)
+
+    def commands(self):
+        status, _, out = self.call(LIST_ID)
+        if status != 0:
+            raise RuntimeError(STATUS.get(status, status))
+        return out.decode().split()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--exec", dest="exe", help="spawn a native build instead of opening a device")
+    ap.add_argument("--timeout", type=float, default=2.0, help="seconds to wait for a response")
+    ap.add_argument("device", nargs="?", help="serial device of the target")
+    ap.add_argument("command", nargs=argparse.REMAINDER, help="command and arguments ('list' for all)")
+    opts = ap.parse_args()
+
+    if opts.exe and opts.device:
+        opts.command.insert(0, opts.device)
+        opts.device = None
+    if not opts.command or not (opts.exe or opts.device):
+        ap.error("need a device (or --exec) and a command")
+
+    link = Link(opts.device, opts.exe)
+    try:
+        client = Client(link, opts.timeout)
+        if opts.command == ["list"]:
+            print("\n".join(client.commands()))
+            return 0
+        status, ret, out = client.run(*opts.command)
+        sys.stdout.write(out.decode(errors="replace"))
+        if status != 0:
+            print("*** %s ***" % STATUS.get(status, status), file=sys.stderr)
+            return 2
+        return 0 if ret == 0 else 1
+    finally:
+        link.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
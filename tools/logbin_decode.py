@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+"""Decode soRTOS deferred binary logs (LOGBIN) using the firmware ELF.
+
+The ELF's ``logbin_fmt`` section holds every format string; a record's ID is
+the offset of its string in that section. Input is the raw byte stream of
+COBS frames (from a UART or a capture file) or, with --hex, the output of
+the ``logbin dump`` CLI command.
+
+Usage:
+    logbin_decode.py build/stm32l476rg/soRTOS.elf capture.bin
+    logbin_decode.py build/stm32l476rg/soRTOS.elf /dev/ttyACM1
+    logbin_decode.py --hex build/native/soRTOS.elf dump.txt
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SECTION = "logbin_fmt"
+
+T_U32, T_I32, T_U64, T_I64, T_F64, T_STR = range(6)
+CTRL_DROPPED = 1
+
+# printf conversion: flags, width, precision, length, type
+CONV_RE = re.compile(r"%([-+ #0]*)(\d*|\*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcspfeEgG%])")
+
+
+def read_section(elf_path, name):
+    """Return the raw bytes of a named ELF section (32/64-bit, little endian)."""
+    with open(elf_path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not an ELF file" % elf_path)
+    is64 = data[4] == 2
+    if is64:
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+    else:
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+
+    def header(i):
+        base = shoff + i * shentsize
+        if is64:
+            nm, _t, _fl, _addr, off, size = struct.unpack_from("<IIQQQQ", data, base)
+        else:
+            nm, _t, _fl, _addr, off, size = struct.unpack_from("<IIIIII", data, base)
+        return nm, off, size
+
+    _, str_off, _ = header(shstrndx)
+    for i in range(shnum):
+        nm, off, size = header(i)
+        end = data.index(b"\0", str_off + nm)
+        if data[str_off + nm:end].decode() == name:
+            return data[off:off + size]
+    raise ValueError("section %s not found in %s" % (name, elf_path))
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0:
+            raise ValueError("zero byte inside COBS frame")
+        out += frame[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def varint(buf, pos):
+    value = shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, pos
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def format_c(fmt, args):
+    """Apply a C printf format to decoded arguments."""
+    out = []
+    last = 0
+    it = iter(args)
+    for m in CONV_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, _length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        try:
+            arg = next(it)
+        except StopIteration:
+            out.append("<missing>")
+            continue
+        spec = "%" + flags + width + ("." + prec if prec else "")
+        if conv == "p":
+            out.append("0x%08x" % arg if isinstance(arg, int) else str(arg))
+        elif conv == "s":
+            out.append((spec + "s") % (arg if isinstance(arg, str) else "0x%x" % arg))
+        elif conv == "c":
+            out.append(chr(arg & 0xFF) if isinstance(arg, int) else str(arg))
+        elif conv == "u":
+            out.append((spec + "d") % (arg & 0xFFFFFFFFFFFFFFFF if isinstance(arg, int) else arg))
+        elif conv in "fFeEgG":
+            out.append((spec + conv) % float(arg))
+        elif conv in "xXo":
+            out.append((spec + conv) % (arg & 0xFFFFFFFFFFFFFFFF if arg < 0 else arg))
+        else:
+            out.append((spec + "d") % int(arg))
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def decode_frame(frame, formats):
+    """Return the text for one decoded (un-COBSed) frame."""
+    id1, pos = varint(frame, 0)
+    if id1 == 0:
+        kind, pos = varint(frame, pos)
+        count, pos = varint(frame, pos)
+        if kind == CTRL_DROPPED:
+            return "*** %u log records dropped ***" % count
+        return "*** unknown control frame %u ***" % kind
+
+    ts, pos = varint(frame, pos)
+    sig, pos = varint(frame, pos)
+    args = []
+    for i in range(sig & 0xF):
+        tag = (sig >> (4 + 3 * i)) & 7
+        if tag == T_STR:
+            n, pos = varint(frame, pos)
+            args.append(frame[pos:pos + n].decode("utf-8", "replace"))
+            pos += n
+        elif tag == T_F64:
+            args.append(struct.unpack_from("<d", frame, pos)[0])
+            pos += 8
+        else:
+            v, pos = varint(frame, pos)
+            args.append(unzigzag(v) if tag in (T_I32, T_I64) else v)
+
+    off = id1 - 1
+    end = formats.find(b"\0", off)
+    if off >= len(formats) or end < 0:
+        text = "<unknown format %u> %s" % (off, " ".join(str(a) for a in args))
+    else:
+        text = format_c(formats[off:end].decode("utf-8", "replace"), args)
+    return "[%u.%03u] %s" % (ts // 1000, ts % 1000, text)
+
+
+def frames_from_stream(stream):
+    buf = bytearray()
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            return
+        if chunk[0] == 0:
+            if buf:
+                yield bytes(buf)
+            buf.clear()
+        else:
+            buf += chunk
+
+
+def frames_from_hex(stream):
+    for line in stream:
+        line = line.strip()
+        if re.fullmatch(rb"[0-9a-fA-F]+", line) and len(line) % 2 == 0:
+            raw = bytes.fromhex(line.decode())
+            yield from (f for f in raw.split(b"\0") if f)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("elf", help="firmware ELF with the logbin_fmt section")
+    ap.add_argument("input", nargs="?", help="capture file or serial device (default stdin)")
+    ap.add_argument("--hex", action="store_true", help="input is 'logbin dump' hex text")
+    opts = ap.parse_args()
+
+    formats = read_section(opts.elf, SECTION)
+    stream = open(opts.input, "rb", buffering=0) if opts.input else sys.stdin.buffer
+    frames = frames_from_hex(stream) if opts.hex else frames_from_stream(stream)
+
+    for raw in frames:
+        try:
+            print(decode_frame(cobs_decode(raw), formats), flush=True)
+        except (ValueError, IndexError, struct.error) as e:
+            print("*** corrupt frame (%s) ***" % e, flush=True)
+
+
+if __name__ == "__main__":
+    main()